@@ -0,0 +1,3 @@
+DELETE FROM CHARGING_PROFILES WHERE PROFILE NOT LIKE '{%';
+ALTER TABLE CHARGING_PROFILES DROP COLUMN STACK_LEVEL;
+ALTER TABLE CHARGING_PROFILES DROP COLUMN CHARGING_PROFILE_PURPOSE;
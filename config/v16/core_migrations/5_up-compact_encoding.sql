@@ -0,0 +1,3 @@
+ALTER TABLE CHARGING_PROFILES ADD COLUMN STACK_LEVEL INT;
+ALTER TABLE CHARGING_PROFILES ADD COLUMN CHARGING_PROFILE_PURPOSE TEXT;
+UPDATE CHARGING_PROFILES SET STACK_LEVEL = json_extract(PROFILE, '$.stackLevel'), CHARGING_PROFILE_PURPOSE = json_extract(PROFILE, '$.chargingProfilePurpose');
@@ -0,0 +1,2 @@
+DROP TABLE METER_VALUE_BLOCKS;
+DELETE FROM CHARGING_PROFILES WHERE PROFILE NOT LIKE '{%';
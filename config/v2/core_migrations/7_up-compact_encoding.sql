@@ -0,0 +1,6 @@
+CREATE TABLE METER_VALUE_BLOCKS (
+    ROWID INTEGER PRIMARY KEY,
+    TRANSACTION_ID TEXT NOT NULL,
+    DATA TEXT NOT NULL
+);
+CREATE INDEX METER_VALUE_BLOCKS_TRANSACTION_ID_INDEX ON METER_VALUE_BLOCKS (TRANSACTION_ID);
@@ -0,0 +1 @@
+DROP TABLE DEFAULT_TARIFFS;
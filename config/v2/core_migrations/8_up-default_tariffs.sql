@@ -0,0 +1,6 @@
+CREATE TABLE DEFAULT_TARIFFS (
+    TARIFF_ID TEXT NOT NULL,
+    EVSE_ID INT NOT NULL,
+    TARIFF TEXT NOT NULL,
+    PRIMARY KEY (TARIFF_ID, EVSE_ID)
+);
@@ -0,0 +1 @@
+DROP TABLE DER_CONTROLS;
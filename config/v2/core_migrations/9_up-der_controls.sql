@@ -0,0 +1,8 @@
+CREATE TABLE DER_CONTROLS (
+    CONTROL_ID TEXT NOT NULL,
+    IS_DEFAULT INT NOT NULL,
+    CONTROL_TYPE TEXT NOT NULL,
+    IS_SUPERSEDED INT NOT NULL,
+    CONTROL TEXT NOT NULL,
+    PRIMARY KEY (CONTROL_ID, IS_DEFAULT)
+);
@@ -0,0 +1 @@
+DROP TABLE IF EXISTS COMPONENT_CONFIG_FINGERPRINT;
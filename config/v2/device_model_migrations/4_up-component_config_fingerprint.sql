@@ -0,0 +1,4 @@
+CREATE TABLE IF NOT EXISTS COMPONENT_CONFIG_FINGERPRINT (
+  ID INTEGER PRIMARY KEY CHECK (ID = 1),
+  FINGERPRINT TEXT NOT NULL
+);
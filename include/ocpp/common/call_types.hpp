@@ -11,6 +11,7 @@
 #include <chrono>
 #include <cstddef>
 #include <string>
+#include <utility>
 
 #include <ocpp/common/cistring.hpp>
 
@@ -31,7 +32,12 @@ const auto CALLERROR_ERROR_DETAILS = 4;
 /// \brief Contains a MessageId implementation based on a case insensitive string with a maximum length of 36 printable
 /// ASCII characters
 class MessageId : public CiString<36> {
+public:
     using CiString::CiString;
+
+    /// \brief Creates a MessageId from \p data that is known to be a valid message id, for example one that was
+    /// generated by create_message_id. Skips the length and character validation
+    static MessageId from_trusted(std::string&& data);
 };
 
 /// \brief Comparison operator< between two MessageId \p lhs and \p rhs
@@ -51,7 +57,8 @@ enum class MessageTypeId {
     UNKNOWN = 5,
 };
 
-/// \brief Creates a unique message ID
+/// \brief Creates a unique message ID, a random (version 4) UUID. Thread-safe, every thread uses its own
+/// random number generator
 /// \returns the unique message ID
 MessageId create_message_id();
 
@@ -64,12 +71,12 @@ template <class T> struct Call {
     Call() = default;
 
     /// \brief Creates a new Call message object with the given OCPP message \p msg
-    explicit Call(T msg) : msg(msg) {
+    explicit Call(T msg) : msg(std::move(msg)) {
         this->uniqueId = create_message_id();
     }
 
     /// \brief Creates a new Call message object with the given OCPP message \p msg and \p uniqueId
-    Call(T msg, MessageId uniqueId) : msg(msg), uniqueId(uniqueId) {
+    Call(T msg, MessageId uniqueId) : msg(std::move(msg)), uniqueId(std::move(uniqueId)) {
     }
 
     /// \brief Conversion from a given Call message \p c to a given json object \p j
@@ -105,7 +112,7 @@ template <class T> struct CallResult {
     CallResult() = default;
 
     /// \brief Creates a new CallResult message object with the given OCPP message \p msg and \p uniqueID
-    CallResult(T msg, MessageId uniqueId) : msg(msg), uniqueId(uniqueId) {
+    CallResult(T msg, MessageId uniqueId) : msg(std::move(msg)), uniqueId(std::move(uniqueId)) {
     }
 
     /// \brief Conversion from a given CallResult message \p c to a given json object \p j
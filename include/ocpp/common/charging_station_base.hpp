@@ -5,8 +5,10 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <ocpp/common/contract_certificate_cache.hpp>
 #include <ocpp/common/evse_security.hpp>
 #include <ocpp/common/evse_security_impl.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/message_queue.hpp>
 #include <ocpp/common/ocpp_logging.hpp>
 
@@ -17,11 +19,21 @@ class ChargingStationBase {
 
 protected:
     std::shared_ptr<EvseSecurity> evse_security;
+    /// \brief Caches the verification of contract certificate chains by evse_security for Plug&Charge
+    std::shared_ptr<ContractCertificateCache> contract_certificate_cache;
     std::shared_ptr<MessageLogging> logging;
 
-    boost::shared_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work;
-    boost::asio::io_context io_context;
-    std::thread io_context_thread;
+    /// \brief True if the executor was created by the charging station and is not shared with other components
+    bool owns_executor;
+    /// \brief Runs the timers of the charging station and of its components
+    std::shared_ptr<Executor> executor;
+    boost::asio::io_context& io_context;
+
+    /// \brief Makes sure that no timer handler of the charging station runs while the derived charging station
+    /// destroys its members. An executor that was created by the charging station is stopped and joined. A shared
+    /// executor keeps running, so \p stop_timers is run on it between its other handlers to stop the timers of the
+    /// charging station. Must be called by the destructor of the derived charging station
+    void stop_timers_on_executor(const std::function<void()>& stop_timers);
 
 public:
     /// \brief Constructor for ChargingStationBase
@@ -29,8 +41,10 @@ public:
     /// security_configuration must be set
     /// \param security_configuration specifies the file paths that are required to set up the internal evse_security
     /// implementation
+    /// \param executor that runs the timers of the charging station, if nullptr a new executor is created
     explicit ChargingStationBase(const std::shared_ptr<EvseSecurity> evse_security,
-                                 const std::optional<SecurityConfiguration> security_configuration = std::nullopt);
+                                 const std::optional<SecurityConfiguration> security_configuration = std::nullopt,
+                                 std::shared_ptr<Executor> executor = nullptr);
     virtual ~ChargingStationBase();
 };
 
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <ocpp/common/types.hpp>
+
+namespace ocpp::compact_encoding {
+
+/// \brief Exception thrown when a compactly encoded value can not be decoded
+class DecodeException : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// \brief Characters that separate the fields of a compact encoding
+constexpr std::string_view SEPARATORS = ",;|";
+
+/// \brief Version of the encoding written by encode_charging_profile
+constexpr char CHARGING_PROFILE_ENCODING_V1 = '1';
+
+/// \brief Appends \p value in decimal notation to \p out
+void append_int(std::string& out, std::int64_t value);
+
+/// \brief Appends \p value to \p out. Integral values are written in decimal notation, all other values as 'x'
+/// followed by the hexadecimal representation of their bits, so they are restored exactly and independent of the locale
+void append_float(std::string& out, float value);
+
+/// \brief Reads the fields written by append_int and append_float. Every field ends at one of the SEPARATORS or at the
+/// end of the input, an empty field represents an absent value. Throws a DecodeException on malformed input
+class Reader {
+private:
+    std::string_view encoded;
+    std::size_t pos;
+
+    std::string_view read_field();
+
+public:
+    explicit Reader(std::string_view encoded);
+
+    /// \brief Returns true if the complete input has been read
+    bool at_end() const;
+
+    /// \brief Skips \p separator if it is the next character
+    /// \returns true if \p separator was skipped
+    bool skip(char separator);
+
+    /// \brief Skips \p separator, throws a DecodeException if it is not the next character
+    void expect(char separator);
+
+    std::optional<std::int64_t> read_optional_int();
+    std::int64_t read_int();
+    std::optional<float> read_optional_float();
+    float read_float();
+
+    /// \brief Reads the characters up to the next separator
+    std::string_view read_text();
+};
+
+/// \brief Charging schedule period that only consists of the fields that are stored compactly
+struct SchedulePeriod {
+    std::int32_t start_period;
+    std::optional<float> limit;
+    std::optional<std::int32_t> number_phases;
+    std::optional<std::int32_t> phase_to_use;
+};
+
+/// \brief Charging profile as read by decode_charging_profile
+struct DecodedChargingProfile {
+    /// \brief The profile, in which every compactly stored chargingSchedulePeriod array is empty
+    json profile;
+    /// \brief The compactly stored periods of the n-th charging schedule of the profile. std::nullopt or a missing
+    /// entry means the periods are part of \ref profile
+    std::vector<std::optional<std::vector<SchedulePeriod>>> schedule_periods;
+};
+
+/// \brief Encodes the json of an OCPP 1.6 or OCPP 2.x charging \p profile. Every chargingSchedulePeriod array in which
+/// all periods only consist of startPeriod, limit, numberPhases and phaseToUse is replaced by a compact string, which
+/// is several times smaller and does not need to be parsed as json
+std::string encode_charging_profile(json profile);
+
+/// \brief Decodes a charging profile written by encode_charging_profile or stored as plain json
+DecodedChargingProfile decode_charging_profile(std::string_view stored);
+
+} // namespace ocpp::compact_encoding
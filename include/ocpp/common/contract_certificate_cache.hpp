@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ocpp/common/evse_security.hpp>
+#include <ocpp/common/types.hpp>
+
+namespace ocpp {
+
+/// \brief Default number of contract certificate chains a ContractCertificateCache holds
+constexpr std::size_t DEFAULT_CONTRACT_CERTIFICATE_CACHE_SIZE = 128;
+
+/// \brief Default time a verification result other than CertificateValidationResult::Valid is cached
+constexpr std::chrono::seconds DEFAULT_CONTRACT_CERTIFICATE_CACHE_NEGATIVE_TTL = std::chrono::minutes(5);
+
+/// \brief Caches the local verification result and the OCSP request data of contract certificate chains.
+///
+/// Plug&Charge vehicles present the same contract certificate chain every time they plug in, and verifying it parses
+/// the PEM chain and builds the X509 chain against the certificate store. The results of EvseSecurity are therefore
+/// cached per chain, keyed by the SHA-256 digest of the PEM chain. An entry expires when the first certificate of the
+/// chain expires and the least recently used entry is evicted when the cache is full. A failed verification is only
+/// cached for a short time, since it can also be caused by a revocation status or a system time that changes later.
+/// Chains whose validity can not be read, chains that are not yet valid, results of
+/// CertificateValidationResult::Unknown and empty OCSP request data are never cached.
+///
+/// The cache has to be cleared when CA certificates are installed or deleted, since the trust anchors of the cached
+/// results change.
+class ContractCertificateCache {
+public:
+    /// \param evse_security that verifies the chains that are not cached
+    /// \param max_entries number of chains that are cached at most
+    /// \param negative_result_ttl time a verification result other than CertificateValidationResult::Valid is cached
+    explicit ContractCertificateCache(
+        EvseSecurity& evse_security, const std::size_t max_entries = DEFAULT_CONTRACT_CERTIFICATE_CACHE_SIZE,
+        const std::chrono::seconds negative_result_ttl = DEFAULT_CONTRACT_CERTIFICATE_CACHE_NEGATIVE_TTL);
+
+    /// \brief Same as EvseSecurity::verify_certificate, but returns the cached result if \p certificate_chain was
+    /// already verified for \p certificate_types
+    CertificateValidationResult verify_certificate(const std::string& certificate_chain,
+                                                   const std::vector<LeafCertificateType>& certificate_types);
+
+    /// \brief Same as EvseSecurity::get_mo_ocsp_request_data, but returns the cached OCSP request data if it was
+    /// already generated for \p certificate_chain
+    std::vector<OCSPRequestData> get_mo_ocsp_request_data(const std::string& certificate_chain);
+
+    /// \brief Removes all entries. Has to be called when CA certificates are installed or deleted
+    void clear();
+
+    /// \returns the number of cached chains
+    std::size_t size();
+
+private:
+    struct VerifyResult {
+        CertificateValidationResult result;
+        /// \brief The result has to be verified again afterwards, std::nullopt if it is valid as long as the entry
+        std::optional<DateTime> valid_until;
+    };
+
+    struct Entry {
+        std::string digest;
+        /// \brief notAfter of the certificate of the chain that expires first
+        DateTime valid_until;
+        std::map<std::vector<LeafCertificateType>, VerifyResult> verify_results;
+        std::optional<std::vector<OCSPRequestData>> ocsp_request_data;
+    };
+
+    EvseSecurity& evse_security;
+    std::size_t max_entries;
+    std::chrono::seconds negative_result_ttl;
+
+    std::mutex cache_mutex;
+    /// \brief Most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_by_digest;
+
+    /// \returns the valid entry of \p digest and marks it as most recently used. cache_mutex must be locked
+    Entry* find_entry(const std::string& digest);
+
+    /// \returns the entry of \p digest, creates it if the validity of \p certificate_chain can be read.
+    /// cache_mutex must be locked
+    Entry* find_or_create_entry(const std::string& digest, const std::string& certificate_chain);
+};
+
+} // namespace ocpp
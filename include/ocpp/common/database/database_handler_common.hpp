@@ -30,6 +30,11 @@ protected:
     /// \brief Perform the initialization needed to use the database. Will be called by open_connection()
     virtual void init_sql() = 0;
 
+    /// \brief Release everything that depends on the open connection, e.g. cached statements or buffered writes. Will
+    /// be called by close_connection() before the connection is closed
+    virtual void deinit_sql() {
+    }
+
 public:
     /// \brief Common database handler class
     /// Class handles some common database functionality like inserting and removing transaction messages.
@@ -46,7 +51,8 @@ public:
     /// \brief Opens connection to database file and performs the initialization by calling init_sql()
     void open_connection();
 
-    /// \brief Closes the database connection.
+    /// \brief Closes the database connection after calling deinit_sql(). The connection is also closed if deinit_sql()
+    /// throws
     void close_connection();
 
     /// \brief Get messages from messages queue table specified by \p queue_type
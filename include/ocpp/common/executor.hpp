@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+namespace ocpp {
+
+/// \brief Runs the timers and asynchronous work of the libocpp components on a single io_context.
+///
+/// Components get the executor of their charge point injected and create their timers on get_io_context(). Components
+/// that are constructed without an executor use the process wide default executor, so they do not start a thread per
+/// timer either. The timer handlers of a charge point and its functional blocks share state without further locking and
+/// rely on being run one after another, which is only the case if the executor is served by a single thread
+class Executor {
+public:
+    static constexpr std::size_t DEFAULT_NUMBER_OF_THREADS = 1;
+
+    /// \brief Creates an executor and starts \p number_of_threads threads that run its io_context. With more than one
+    /// thread, handlers of different timers run concurrently, so such an executor must only be used for components that
+    /// synchronize their timer handlers themselves
+    explicit Executor(std::size_t number_of_threads = DEFAULT_NUMBER_OF_THREADS);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /// \brief The io_context on which the timers of the components are created
+    boost::asio::io_context& get_io_context();
+
+    std::size_t get_number_of_threads() const;
+
+    /// \brief Runs \p handler on one of the threads of the executor
+    template <typename Handler> void post(Handler&& handler) {
+        boost::asio::post(this->io_context, std::forward<Handler>(handler));
+    }
+
+    /// \brief Runs \p handler on one of the threads of the executor and waits until it has run, so it does not run
+    /// concurrently with another handler of a single threaded executor. Used to stop timers before the objects their
+    /// handlers access are destroyed. \p handler is run directly if called from a thread of the executor or if the
+    /// executor is stopped. Exceptions of \p handler are rethrown
+    void run_and_wait(const std::function<void()>& handler);
+
+    /// \brief Same as run_and_wait(), for components that only know the \p io_context of their executor
+    static void run_and_wait(boost::asio::io_context& io_context, const std::function<void()>& handler);
+
+    /// \brief Stops the io_context and joins all threads. Pending handlers are not run anymore. Called by the
+    /// destructor
+    void stop();
+
+    /// \brief Executor for components that are constructed without one, created on first use
+    static std::shared_ptr<Executor> get_default();
+
+private:
+    boost::asio::io_context io_context;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work;
+    std::vector<std::thread> threads;
+};
+
+} // namespace ocpp
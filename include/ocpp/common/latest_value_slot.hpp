@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace ocpp {
+
+/// \brief Lock-free slot that hands the latest value from a single producer thread to a single consumer thread. Values
+/// that are published while the consumer is busy overwrite each other, so only the latest one is consumed.
+///
+/// The slot is a triple buffer: the producer and the consumer each own one buffer and exchange their buffer with the
+/// shared middle buffer through a single atomic. Neither side ever waits for the other, and since values are
+/// assigned into buffers that already held a value, publishing does not allocate once the buffers have grown to the
+/// size of the values
+template <typename T> class LatestValueSlot {
+public:
+    /// \brief Publishes \p value. Must only be called by the producer
+    /// \returns true if a previously published value was not consumed and is therefore dropped
+    bool publish(const T& value) {
+        this->buffers[this->back] = value;
+        const auto previous = this->state.exchange(static_cast<std::uint8_t>(this->back | FRESH));
+        this->back = previous & INDEX_MASK;
+        return (previous & FRESH) != 0;
+    }
+
+    /// \brief Swaps the latest published value into \p value if there is a new one. The previous content of \p value
+    /// is reused for a later publish. Must only be called by the consumer
+    /// \returns true if a new value was consumed
+    bool consume(T& value) {
+        if ((this->state.load() & FRESH) == 0) {
+            return false;
+        }
+        const auto previous = this->state.exchange(this->front);
+        this->front = previous & INDEX_MASK;
+
+        using std::swap;
+        swap(value, this->buffers[this->front]);
+        return true;
+    }
+
+    /// \returns true if a value was published that has not been consumed yet
+    bool has_value() const {
+        return (this->state.load() & FRESH) != 0;
+    }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4;
+
+    std::array<T, 3> buffers;
+    /// \brief Buffer owned by the producer
+    std::uint8_t back = 0;
+    /// \brief Index of the shared middle buffer and whether it holds a value that was not consumed yet
+    std::atomic<std::uint8_t> state{1};
+    /// \brief Buffer owned by the consumer
+    std::uint8_t front = 2;
+};
+
+} // namespace ocpp
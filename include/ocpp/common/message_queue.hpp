@@ -7,6 +7,7 @@
 #include <condition_variable>
 #include <deque>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
@@ -16,6 +17,7 @@
 
 #include <ocpp/common/call_types.hpp>
 #include <ocpp/common/database/database_handler_common.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/types.hpp>
 #include <ocpp/v16/messages/StopTransaction.hpp>
 #include <ocpp/v16/types.hpp>
@@ -48,15 +50,27 @@ template <typename M> struct MessageQueueConfig {
     };
 };
 
-/// \brief Contains a OCPP message in json form with additional information
+/// \returns the shared null json that EnhancedMessage::message and EnhancedMessage::call_message default to
+inline const std::shared_ptr<const json>& null_json_message() {
+    static const auto null_message = std::make_shared<const json>();
+    return null_message;
+}
+
+/// \brief Contains a OCPP message in json form with additional information. The json is parsed once when the message
+/// is received and shared immutably between the copies of an EnhancedMessage, so handing it from the message queue to
+/// the handlers does not copy it
 template <typename M> struct EnhancedMessage {
-    json message;                                         ///< The OCPP message as json
+    std::shared_ptr<const json> message;                  ///< The OCPP message as json
     size_t message_size = 0;                              ///< size of the json message in bytes
     MessageId uniqueId;                                   ///< The unique ID of the json message
     M messageType = M::InternalError;                     ///< The OCPP message type
     MessageTypeId messageTypeId = MessageTypeId::UNKNOWN; ///< The OCPP message type ID (CALL/CALLRESULT/CALLERROR)
-    json call_message;    ///< If the message is a CALLRESULT or CALLERROR this can contain the original CALL message
+    std::shared_ptr<const json> call_message; ///< If the message is a CALLRESULT or CALLERROR the original CALL
     bool offline = false; ///< A flag indicating if the connection to the central system is offline
+    std::chrono::steady_clock::time_point received_at; ///< The time at which the message was received
+
+    EnhancedMessage() : message(null_json_message()), call_message(null_json_message()) {
+    }
 };
 
 /// \brief This contains an internal control message
@@ -187,6 +201,8 @@ private:
     std::recursive_mutex next_message_mutex;
     std::optional<MessageId> next_message_to_send;
 
+    // Runs the timers, must be declared before them
+    std::shared_ptr<Executor> executor;
     Everest::SteadyTimer in_flight_timeout_timer;
     Everest::SteadyTimer notify_queue_timer;
 
@@ -389,13 +405,15 @@ private:
     }
 
 public:
-    /// \brief Creates a new MessageQueue object with the provided \p configuration and \p send_callback
+    /// \brief Creates a new MessageQueue object with the provided \p configuration and \p send_callback. The timers of
+    /// the queue run on \p executor, or on the default executor if it is nullptr
     MessageQueue(
         const std::function<bool(json message)>& send_callback, const MessageQueueConfig<M>& config,
         const std::vector<M>& external_notify, std::shared_ptr<common::DatabaseHandlerCommon> database_handler,
         const std::function<void(const std::string& new_message_id, const std::string& old_message_id)>&
             start_transaction_message_retry_callback =
-                [](const std::string& new_message_id, const std::string& old_message_id) {}) :
+                [](const std::string& new_message_id, const std::string& old_message_id) {},
+        std::shared_ptr<Executor> executor = nullptr) :
         database_handler(std::move(database_handler)),
         config(config),
         external_notify(external_notify),
@@ -404,14 +422,34 @@ public:
         running(true),
         new_message(false),
         is_registration_status_accepted(false),
+        executor(executor != nullptr ? std::move(executor) : Executor::get_default()),
+        in_flight_timeout_timer(&this->executor->get_io_context()),
+        notify_queue_timer(&this->executor->get_io_context()),
+        resume_timer(&this->executor->get_io_context()),
         start_transaction_message_retry_callback(start_transaction_message_retry_callback),
         send_callback(send_callback),
         in_flight(nullptr) {
     }
 
     MessageQueue(const std::function<bool(json message)>& send_callback, const MessageQueueConfig<M>& config,
-                 std::shared_ptr<common::DatabaseHandlerCommon> databaseHandler) :
-        MessageQueue(send_callback, config, {}, databaseHandler) {
+                 std::shared_ptr<common::DatabaseHandlerCommon> databaseHandler,
+                 std::shared_ptr<Executor> executor = nullptr) :
+        MessageQueue(
+            send_callback, config, {}, databaseHandler,
+            [](const std::string& new_message_id, const std::string& old_message_id) {}, std::move(executor)) {
+    }
+
+    ~MessageQueue() {
+        try {
+            // Stopped on the executor, so the timer handlers can not run while the queue is destroyed
+            this->executor->run_and_wait([this]() {
+                this->in_flight_timeout_timer.stop();
+                this->notify_queue_timer.stop();
+                this->resume_timer.stop();
+            });
+        } catch (...) {
+            EVLOG_error << "Exception during dtor call of message queue timer stop";
+        }
     }
 
     void start() {
@@ -727,14 +765,16 @@ public:
     /// \returns the enhanced message
     EnhancedMessage<M> receive(std::string_view message) {
         EnhancedMessage<M> enhanced_message;
+        enhanced_message.received_at = std::chrono::steady_clock::now();
 
-        enhanced_message.message = json::parse(message);
-        enhanced_message.uniqueId = this->getMessageId(enhanced_message.message);
-        enhanced_message.messageTypeId = this->getMessageTypeId(enhanced_message.message);
+        enhanced_message.message = std::make_shared<const json>(json::parse(message));
+        // the message is only accessed by reference, an implicit conversion to json::array_t would copy it
+        const auto& json_message = enhanced_message.message->template get_ref<const json::array_t&>();
+        enhanced_message.uniqueId = this->getMessageId(json_message);
+        enhanced_message.messageTypeId = this->getMessageTypeId(json_message);
 
         if (enhanced_message.messageTypeId == MessageTypeId::CALL) {
-            enhanced_message.messageType = this->string_to_messagetype(enhanced_message.message.at(CALL_ACTION));
-            enhanced_message.call_message = enhanced_message.message;
+            enhanced_message.messageType = this->string_to_messagetype(json_message.at(CALL_ACTION));
 
             {
                 const std::lock_guard<std::recursive_mutex> lk(this->next_message_mutex);
@@ -766,8 +806,9 @@ public:
             }
             if (enhanced_message.messageTypeId == MessageTypeId::CALLERROR) {
                 EVLOG_error << "Received a CALLERROR for message with UID: " << enhanced_message.uniqueId;
-                // make sure the original call message is attached to the callerror
-                enhanced_message.call_message = this->in_flight->message;
+                // make sure the original call message is attached to the callerror. It is copied since the call
+                // might be sent again
+                enhanced_message.call_message = std::make_shared<const json>(this->in_flight->message);
                 lk.unlock();
                 this->handle_timeout_or_callerror(enhanced_message);
             } else {
@@ -785,9 +826,10 @@ public:
 
     void handle_call_result(EnhancedMessage<M>& enhanced_message) {
         if (this->in_flight->uniqueId() == enhanced_message.uniqueId) {
-            enhanced_message.call_message = this->in_flight->message;
             enhanced_message.messageType = this->string_to_messagetype(
                 this->in_flight->message.at(CALL_ACTION).template get<std::string>() + std::string("Response"));
+            // the call is answered and not needed in flight anymore, so it is moved instead of copied
+            enhanced_message.call_message = std::make_shared<const json>(std::move(this->in_flight->message));
             this->in_flight->promise.set_value(enhanced_message);
 
             const auto queue_type =
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <date/tz.h>
+
+namespace ocpp::rfc3339 {
+
+using utc_time_point = std::chrono::time_point<date::utc_clock>;
+
+/// \brief Size of a string created by format_fast: YYYY-MM-DDTHH:MM:SS.mmmZ
+constexpr std::size_t FORMATTED_SIZE = 24;
+
+/// \brief Parses the canonical RFC 3339 forms YYYY-MM-DDTHH:MM:SS[.fraction][Z|+HH:MM|-HH:MM] without any
+/// allocation. The fraction may have up to nine digits, a missing offset is interpreted as UTC
+/// \returns the parsed time point or std::nullopt if \p timepoint_str is not in one of the canonical forms, in which
+/// case parse_reference must be used to get the exact result
+std::optional<utc_time_point> parse_fast(std::string_view timepoint_str);
+
+/// \brief Parses \p timepoint_str with date::parse, trying the formats "%FT%T%Ez", "%FT%TZ" and "%FT%T" in order
+/// \returns the parsed time point or std::nullopt if none of the formats match
+std::optional<utc_time_point> parse_reference(const std::string& timepoint_str);
+
+/// \brief Formats \p timepoint as YYYY-MM-DDTHH:MM:SS.mmmZ into \p out, which must have room for FORMATTED_SIZE
+/// characters
+/// \returns false if \p timepoint can not be formatted by the fast path (leap second, years outside of
+/// 0000-9999) in which case format_reference must be used
+bool format_fast(const utc_time_point& timepoint, char* out);
+
+/// \brief Formats \p timepoint with date::format using "%FT%TZ" in millisecond precision
+std::string format_reference(const utc_time_point& timepoint);
+
+} // namespace ocpp::rfc3339
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace ocpp {
 
@@ -26,6 +27,13 @@ private:
     std::string data;
     static constexpr size_t length = L;
 
+protected:
+    /// \brief Sets the content of the string to the given \p data without any length or format check. Must only
+    /// be used for data that is known to be valid
+    void set_unchecked(std::string&& data) {
+        this->data = std::move(data);
+    }
+
 public:
     /// \brief Creates a string from the given \p data
     explicit String(const std::string& data, StringTooLarge to_large = StringTooLarge::Throw) {
@@ -23,9 +23,11 @@ private:
     std::shared_ptr<MessageLogging> logging;
 
 public:
-    /// \brief Creates a new Websocket object with the provided \p connection_options
+    /// \brief Creates a new Websocket object with the provided \p connection_options. The timers of the websocket run
+    /// on \p executor, or on the default executor if it is nullptr
     explicit Websocket(const WebsocketConnectionOptions& connection_options,
-                       std::shared_ptr<EvseSecurity> evse_security, std::shared_ptr<MessageLogging> logging);
+                       std::shared_ptr<EvseSecurity> evse_security, std::shared_ptr<MessageLogging> logging,
+                       std::shared_ptr<Executor> executor = nullptr);
     ~Websocket() = default;
 
     /// \brief Starts the connection attempts. It will init the websocket processing thread
@@ -41,6 +43,12 @@ public:
     // \brief reconnects the websocket after the delay
     void reconnect(long delay);
 
+    /// \brief Drops the cached TLS context and sessions, must be called after the client certificate changed
+    void invalidate_tls_context();
+
+    /// \brief Returns the payload byte counters, including the bytes saved by permessage-deflate
+    WebsocketTrafficCounters get_traffic_counters();
+
     /// \brief indicates if the websocket is connected
     bool is_connected();
 
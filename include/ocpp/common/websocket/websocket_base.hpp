@@ -3,6 +3,7 @@
 #ifndef OCPP_WEBSOCKET_BASE_HPP
 #define OCPP_WEBSOCKET_BASE_HPP
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -10,6 +11,7 @@
 
 #include <everest/timer.hpp>
 
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/types.hpp>
 #include <ocpp/common/websocket/websocket_uri.hpp>
 
@@ -38,6 +40,25 @@ struct WebsocketConnectionOptions {
     std::optional<std::string> iface; // Optional interface where the socket is created. Only usable for libwebsocket
     bool enable_tls_keylog = false;   ///< If set to true enables logging of TLS secrets to the keylog_file
     std::optional<std::filesystem::path> keylog_file; ///< Optional path to a keylog file
+    bool enable_tls_session_resumption = true; ///< If set to true TLS sessions are resumed on reconnects
+    bool enable_permessage_deflate = false; ///< If set to true permessage-deflate (RFC 7692) is offered to the CSMS
+    int permessage_deflate_client_max_window_bits = 15; ///< LZ77 window bits used to compress sent messages (9-15)
+    int permessage_deflate_server_max_window_bits = 15; ///< LZ77 window bits requested from the CSMS (9-15)
+    std::size_t permessage_deflate_threshold_bytes = 256; ///< Messages smaller than this are sent uncompressed
+};
+
+/// \brief Payload byte counters of a websocket connection, used to judge the effect of permessage-deflate. Bytes
+/// saved by compression are (deflate_input_bytes_sent - deflate_output_bytes_sent) +
+/// (inflate_output_bytes_received - inflate_input_bytes_received)
+struct WebsocketTrafficCounters {
+    std::uint64_t messages_sent = 0;
+    std::uint64_t payload_bytes_sent = 0;        ///< Uncompressed payload of all sent messages
+    std::uint64_t deflate_input_bytes_sent = 0;  ///< Uncompressed payload of the sent messages that were compressed
+    std::uint64_t deflate_output_bytes_sent = 0; ///< Compressed payload of the sent messages that were compressed
+    std::uint64_t messages_received = 0;
+    std::uint64_t payload_bytes_received = 0;        ///< Uncompressed payload of all received messages
+    std::uint64_t inflate_input_bytes_received = 0;  ///< Compressed payload of the received compressed messages
+    std::uint64_t inflate_output_bytes_received = 0; ///< Uncompressed payload of the received compressed messages
 };
 
 ///
@@ -53,6 +74,8 @@ protected:
     std::function<void(const std::string& message)> message_callback;
     std::function<void(ConnectionFailedReason)> connection_failed_callback;
     std::shared_ptr<boost::asio::steady_timer> reconnect_timer;
+    /// \brief Runs the timers of the websocket
+    std::shared_ptr<Executor> executor;
     std::unique_ptr<Everest::SteadyTimer> ping_timer;
     std::atomic_bool ping_cleared;
     std::int32_t ping_elapsed_s;
@@ -89,8 +112,8 @@ protected:
 
 public:
     /// \brief Creates a new WebsocketBase object. The `connection_options` must be initialised with
-    /// `set_connection_options()`
-    explicit WebsocketBase();
+    /// `set_connection_options()`. The timers run on \p executor, or on the default executor if it is nullptr
+    explicit WebsocketBase(std::shared_ptr<Executor> executor = nullptr);
     virtual ~WebsocketBase();
 
     /// \brief Starts the connection attempts. It will init the websocket processing thread
@@ -105,6 +128,13 @@ public:
     /// \brief reconnect the websocket after the delay
     virtual void reconnect(long delay) = 0;
 
+    /// \brief Drops any cached TLS state (security context and sessions), so that it is rebuilt on the next
+    /// connection attempt. Must be called after the client certificate changed
+    virtual void invalidate_tls_context() = 0;
+
+    /// \brief Returns the payload byte counters since the websocket was created
+    virtual WebsocketTrafficCounters get_traffic_counters() = 0;
+
     /// \brief disconnect the websocket
     void disconnect(const WebsocketCloseReason code);
 
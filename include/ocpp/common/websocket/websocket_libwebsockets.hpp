@@ -7,11 +7,16 @@
 #include <ocpp/common/safe_queue.hpp>
 #include <ocpp/common/websocket/websocket_base.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
 struct ssl_ctx_st;
+struct ssl_st;
+struct ssl_session_st;
 
 namespace ocpp {
 
@@ -23,7 +28,8 @@ class WebsocketLibwebsockets final : public WebsocketBase {
 public:
     /// \brief Creates a new Websocket object with the providede \p connection_options
     explicit WebsocketLibwebsockets(const WebsocketConnectionOptions& connection_options,
-                                    std::shared_ptr<EvseSecurity> evse_security);
+                                    std::shared_ptr<EvseSecurity> evse_security,
+                                    std::shared_ptr<Executor> executor = nullptr);
 
     ~WebsocketLibwebsockets() override;
 
@@ -46,6 +52,23 @@ public:
 
     int process_callback(void* wsi_ptr, int callback_reason, void* user, void* in, size_t len);
 
+    void invalidate_tls_context() override;
+
+    /// \brief Called by OpenSSL when a new resumable session (TLS 1.2 session id or TLS 1.3 ticket) was received
+    /// \return True if the session was kept, in which case we own the reference to it
+    bool on_tls_session_created(struct ssl_session_st* session);
+
+    /// \brief Called by OpenSSL before the ClientHello of a new connection is sent, sets the session to resume
+    void on_tls_handshake_start(struct ssl_st* ssl);
+
+    WebsocketTrafficCounters get_traffic_counters() override;
+
+    /// \brief Called when a message was compressed with permessage-deflate, with the compressed size of a fragment
+    void on_message_deflated(std::size_t output_bytes);
+
+    /// \brief Called when a compressed message was received, with the consumed and the inflated bytes of a fragment
+    void on_message_inflated(std::size_t input_bytes, std::size_t output_bytes);
+
 private:
     bool is_trying_to_connect_internal();
     void close_internal(const WebsocketCloseReason code, const std::string& reason);
@@ -57,6 +80,14 @@ private:
     bool tls_init(struct ssl_ctx_st* ctx, const std::string& path_chain, const std::string& path_key,
                   std::optional<std::string>& password);
 
+    /// \brief Returns the cached TLS context, creating it if there is none. The context is only rebuilt after
+    /// invalidate_tls_context, a change of the connection options or a failed connection attempt
+    /// \return The TLS context or nullptr if it could not be created
+    std::shared_ptr<struct ssl_ctx_st> get_tls_context();
+
+    /// \brief Creates a new TLS context, loading the ciphers, client certificate and verify locations
+    std::shared_ptr<struct ssl_ctx_st> create_tls_context();
+
     /// \brief Websocket processing thread loop
     void thread_websocket_client_loop(std::shared_ptr<ConnectionData> local_data);
 
@@ -115,6 +146,22 @@ private:
     std::atomic_bool stop_deferred_handler;
 
     OcppProtocolVersion connected_ocpp_version;
+
+    /// \brief Protects the cached TLS context and session, which are used from the websocket client thread
+    std::mutex tls_context_mutex;
+    std::shared_ptr<struct ssl_ctx_st> tls_context;
+    /// \brief Last session received from the CSMS, used to resume the session on a reconnect
+    std::shared_ptr<struct ssl_session_st> tls_session;
+
+    // Traffic counters, only written from the websocket client thread
+    std::atomic<std::uint64_t> messages_sent;
+    std::atomic<std::uint64_t> payload_bytes_sent;
+    std::atomic<std::uint64_t> deflate_input_bytes_sent;
+    std::atomic<std::uint64_t> deflate_output_bytes_sent;
+    std::atomic<std::uint64_t> messages_received;
+    std::atomic<std::uint64_t> payload_bytes_received;
+    std::atomic<std::uint64_t> inflate_input_bytes_received;
+    std::atomic<std::uint64_t> inflate_output_bytes_received;
 };
 
 } // namespace ocpp
@@ -6,6 +6,7 @@
 #include <ocpp/common/cistring.hpp>
 #include <ocpp/common/evse_security.hpp>
 #include <ocpp/common/evse_security_impl.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/support_older_cpp_versions.hpp>
 #include <ocpp/v16/charge_point_state_machine.hpp>
 #include <ocpp/v16/ocpp_types.hpp>
@@ -73,10 +74,13 @@ public:
     /// security_configuration must be set
     /// \param security_configuration specifies the file paths that are required to set up the internal evse_security
     /// implementation
+    /// \param executor Executor that runs the timers of the ChargePoint; can be shared between multiple ChargePoint
+    /// instances. If nullptr, the ChargePoint creates its own executor
     explicit ChargePoint(const std::string& config, const fs::path& share_path, const fs::path& user_config_path,
                          const fs::path& database_path, const fs::path& sql_init_path, const fs::path& message_log_path,
                          const std::shared_ptr<EvseSecurity> evse_security,
-                         const std::optional<SecurityConfiguration> security_configuration = std::nullopt);
+                         const std::optional<SecurityConfiguration> security_configuration = std::nullopt,
+                         std::shared_ptr<Executor> executor = nullptr);
 
     ~ChargePoint();
 
@@ -223,6 +227,20 @@ public:
     get_all_enhanced_composite_charging_schedules(const std::int32_t duration_s,
                                                   const ChargingRateUnit unit = ChargingRateUnit::A);
 
+    /// \brief Subscribes to changes of the effective limits, so they do not have to be polled using
+    /// get_all_enhanced_composite_charging_schedules. The \p callback is called with the EnhancedChargingSchedule(s) of
+    /// the connectors (including 0) whose limit of the current period changed, either because a ChargingProfile was
+    /// set or cleared or because the next period of the installed profiles started. It is called once with all
+    /// connectors directly after subscribing.
+    /// \param duration_s of the composite schedules passed to the \p callback
+    /// \param unit of the period entries of the composite schedules
+    /// \param callback called on changes of the effective limits, replaces the callback of a previous subscription
+    void subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                  const LimitsChangedCallback& callback);
+
+    /// \brief Removes the subscription created with subscribe_limits_changed
+    void unsubscribe_limits_changed();
+
     /// \addtogroup ocpp16_handlers OCPP 1.6 handlers
     /// Handlers that can be called from the implementing class.
     /// @{
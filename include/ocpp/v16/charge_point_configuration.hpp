@@ -167,6 +167,9 @@ public:
     std::optional<std::string> getIFace();
     std::optional<KeyValue> getIFaceKeyValue();
 
+    std::optional<bool> getCompactDatabaseEncoding();
+    std::optional<KeyValue> getCompactDatabaseEncodingKeyValue();
+
     std::optional<bool> getQueueAllMessages();
     std::optional<KeyValue> getQueueAllMessagesKeyValue();
 
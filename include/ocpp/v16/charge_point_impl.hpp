@@ -257,6 +257,8 @@ private:
     void try_resume_transactions(const std::set<std::string>& resuming_session_ids);
     void stop_all_transactions();
     void stop_all_transactions(Reason reason);
+    /// \brief Stops the timers of the charge point and of its connectors
+    void stop_timers();
     bool validate_against_cache_entries(CiString<20> id_tag);
 
     // new transaction handling:
@@ -417,12 +419,14 @@ public:
     /// also available) configuration keys in the "Internal" section of the config file. Please note that this is
     /// intended for debugging purposes only as it logs all communication, including authentication messages.
     /// \param evse_security Pointer to evse_security that manages security related operations
+    /// \param executor Executor that runs the timers of the ChargePoint, a new executor is created if nullptr
     explicit ChargePointImpl(const std::string& config, const fs::path& share_path, const fs::path& user_config_path,
                              const fs::path& database_path, const fs::path& sql_init_path,
                              const fs::path& message_log_path, const std::shared_ptr<EvseSecurity> evse_security,
-                             const std::optional<SecurityConfiguration> security_configuration);
+                             const std::optional<SecurityConfiguration> security_configuration,
+                             std::shared_ptr<Executor> executor = nullptr);
 
-    ~ChargePointImpl() override = default;
+    ~ChargePointImpl() override;
 
     /// \brief Allow to update the ChargePoint core information which will be sent in BootNotification.req
     void update_chargepoint_information(const std::string& vendor, const std::string& model,
@@ -555,6 +559,20 @@ public:
     get_all_enhanced_composite_charging_schedules(const std::int32_t duration_s,
                                                   const ChargingRateUnit unit = ChargingRateUnit::A);
 
+    /// \brief Subscribes to changes of the effective limits, so they do not have to be polled using
+    /// get_all_enhanced_composite_charging_schedules. The \p callback is called with the EnhancedChargingSchedule(s) of
+    /// the connectors (including 0) whose limit of the current period changed, either because a ChargingProfile was
+    /// set or cleared or because the next period of the installed profiles started. It is called once with all
+    /// connectors directly after subscribing.
+    /// \param duration_s of the composite schedules passed to the \p callback
+    /// \param unit of the period entries of the composite schedules
+    /// \param callback called on changes of the effective limits, replaces the callback of a previous subscription
+    void subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                  const LimitsChangedCallback& callback);
+
+    /// \brief Removes the subscription created with subscribe_limits_changed
+    void unsubscribe_limits_changed();
+
     /// \brief Stores the given \p powermeter values for the given \p connector . This function can be called when a new
     /// meter value is present.
     /// \param connector
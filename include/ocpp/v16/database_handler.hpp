@@ -4,6 +4,7 @@
 #define OCPP_V16_DATABASE_HANDLER_HPP
 
 #include "sqlite3.h"
+#include <atomic>
 #include <fstream>
 #include <iostream>
 
@@ -43,6 +44,7 @@ struct TransactionEntry {
 class DatabaseHandler : public ocpp::common::DatabaseHandlerCommon {
 private:
     const std::int32_t number_of_connectors;
+    std::atomic_bool use_compact_encoding;
 
     // Runs initialization script and initializes the CONNECTORS and AUTH_LIST_VERSION table.
     void init_sql() override;
@@ -52,6 +54,10 @@ public:
     DatabaseHandler(std::unique_ptr<everest::db::sqlite::ConnectionInterface> database,
                     const fs::path& sql_migration_files_path, std::int32_t number_of_connectors);
 
+    /// \brief Enables or disables the compact encoding of charging profiles that are written from now on. Profiles are
+    /// always read in both encodings
+    void set_compact_encoding(bool enabled);
+
     // transactions
     /// \brief Inserts a transaction with the given parameter to the TRANSACTIONS table.
     void insert_transaction(const std::string& session_id, const std::int32_t transaction_id,
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <limits>
 
+#include <ocpp/common/executor.hpp>
 #include <ocpp/v16/charge_point_configuration.hpp>
 #include <ocpp/v16/connector.hpp>
 #include <ocpp/v16/database_handler.hpp>
@@ -34,6 +35,10 @@ struct PeriodDateTimePair {
     ocpp::DateTime end_time;
 };
 
+/// \brief Called with the composite schedules of the connectors whose effective limit changed
+using LimitsChangedCallback =
+    std::function<void(const std::map<std::int32_t, EnhancedChargingSchedule>& composite_schedules)>;
+
 /// \brief This class handles and maintains incoming ChargingProfiles and contains the logic
 /// to calculate the composite schedules
 class SmartChargingHandler {
@@ -46,8 +51,20 @@ private:
     std::mutex tx_default_profiles_map_mutex;
     std::mutex tx_profiles_map_mutex;
 
+    /// \brief Runs the timers of the handler
+    std::shared_ptr<Executor> executor;
     std::unique_ptr<Everest::SteadyTimer> clear_profiles_timer;
 
+    std::mutex limits_changed_mutex;
+    LimitsChangedCallback limits_changed_callback;
+    std::function<bool()> is_offline_callback;
+    std::int32_t limits_changed_duration;
+    ChargingRateUnit limits_changed_unit;
+    /// \brief The current period of the composite schedule per connector id that was last passed to the
+    /// limits_changed_callback
+    std::map<std::int32_t, std::optional<EnhancedChargingSchedulePeriod>> reported_limits;
+    std::unique_ptr<Everest::SteadyTimer> next_limits_change_timer;
+
     bool clear_profiles(std::map<std::int32_t, ChargingProfile>& stack_level_profiles_map,
                         std::optional<int> profile_id_opt, std::optional<int> connector_id_opt, const int connector_id,
                         std::optional<int> stack_level_opt,
@@ -59,7 +76,9 @@ protected:
 
 public:
     SmartChargingHandler(std::map<std::int32_t, std::shared_ptr<Connector>>& connectors,
-                         std::shared_ptr<DatabaseHandler> database_handler, ChargePointConfiguration& configuration);
+                         std::shared_ptr<DatabaseHandler> database_handler, ChargePointConfiguration& configuration,
+                         std::shared_ptr<Executor> executor = nullptr);
+    ~SmartChargingHandler();
 
     ///
     /// \brief validates the given \p profile according to the specification
@@ -118,6 +137,33 @@ public:
     ChargingSchedule calculate_composite_schedule(const ocpp::DateTime& start_time, const ocpp::DateTime& end_time,
                                                   const std::int32_t evse_id, ChargingRateUnit charging_rate_unit,
                                                   bool is_offline, bool simulate_transaction_active);
+
+    ///
+    /// \brief Subscribes to changes of the effective limits. The \p callback is called with the enhanced composite
+    /// schedules of all connectors (including 0) whose limit of the current period changed. This is checked on
+    /// notify_limits_changed and at the start of the next period of the installed profiles. The \p callback is called
+    /// once with the composite schedules of all connectors directly after subscribing.
+    /// \param duration_s of the composite schedules passed to the \p callback
+    /// \param unit of the period entries of the composite schedules
+    /// \param is_offline_callback returns if the charge point is offline, which is used to calculate the composite
+    /// schedules
+    /// \param callback called on changes of the effective limits, replaces the callback of a previous subscription
+    ///
+    void subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                  const std::function<bool()>& is_offline_callback,
+                                  const LimitsChangedCallback& callback);
+
+    ///
+    /// \brief Removes the subscription created with subscribe_limits_changed
+    ///
+    void unsubscribe_limits_changed();
+
+    ///
+    /// \brief Calls the subscribed LimitsChangedCallback with the composite schedules of the connectors whose current
+    /// limit changed since the last call and starts the timer for the next check at the start of the next period.
+    /// Has to be called after the installed profiles were changed.
+    ///
+    void notify_limits_changed();
 };
 
 bool validate_schedule(const ChargingSchedule& schedule, const int charging_schedule_max_periods,
@@ -10,6 +10,10 @@
 #include <ocpp/v2/ocpp_types.hpp>
 #include <ocpp/v2/types.hpp>
 #include <ocpp/v2/utils.hpp>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <vector>
 namespace ocpp {
 namespace v2 {
@@ -27,25 +31,33 @@ public:
     void clear_values();
 
 private:
+    // Number of measurands that are averaged: Current.Import, Voltage, Power.Active.Import and Frequency
+    static constexpr std::size_t NUMBER_OF_AVERAGED_MEASURANDS = 4;
+    // Absent phases and locations have their own slot
+    static constexpr std::size_t NUMBER_OF_PHASES = static_cast<std::size_t>(PhaseEnum::L3_L1) + 2;
+    static constexpr std::size_t NUMBER_OF_LOCATIONS = static_cast<std::size_t>(LocationEnum::Upstream) + 2;
+    static constexpr std::size_t NUMBER_OF_SLOTS =
+        NUMBER_OF_AVERAGED_MEASURANDS * NUMBER_OF_PHASES * NUMBER_OF_LOCATIONS;
+
     struct MeterValueCalc {
         double sum;
         int num_elements;
-    };
-    struct MeterValueMeasurands {
-        MeasurandEnum measurand;
-        std::optional<PhaseEnum> phase;       // measurand may or may not have a phase field
-        std::optional<LocationEnum> location; // measurand may or may not have location field
-
-        // Define a comparison operator for the struct
-        bool operator<(const MeterValueMeasurands& other) const {
-            // Using tie here to compare the two lexicographically instead of writing it all out
-            return std::tie(measurand, location, phase) < std::tie(other.measurand, other.location, other.phase);
-        }
+        /// @brief The accumulator is only valid if this matches the generation of the AverageMeterValues object,
+        /// so clearing does not have to touch every slot
+        std::uint32_t generation;
     };
 
     MeterValue averaged_meter_values;
     std::mutex avg_meter_value_mutex;
-    std::map<MeterValueMeasurands, MeterValueCalc> aligned_meter_values;
+    /// @brief Accumulators indexed by the combination of measurand, phase and location, see get_slot()
+    std::array<MeterValueCalc, NUMBER_OF_SLOTS> aligned_meter_values{};
+    std::uint32_t generation = 1;
+
+    /// @return the index of the accumulator of the sample or std::nullopt if its measurand is not averaged
+    static std::optional<std::size_t> get_slot(const SampledValue& sample);
+    /// @return true if the samples of \p meter_value have the same measurands, phases, locations and units in the same
+    /// order as the stored samples
+    bool has_same_layout(const MeterValue& meter_value) const;
     void average_meter_value();
 };
 } // namespace v2
@@ -45,6 +45,7 @@ class SmartChargingInterface;
 class TariffAndCostInterface;
 class TransactionInterface;
 class BidirectionalInterface;
+class DERControlInterface;
 
 class DatabaseHandler;
 class DeviceModel;
@@ -318,6 +319,20 @@ public:
     virtual std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                        const ChargingRateUnitEnum& unit) = 0;
 
+    /// \brief Subscribes to changes of the effective limits, so they do not have to be polled using
+    /// get_all_composite_schedules. The \p callback is called with the composite schedules of the evses (including 0)
+    /// whose limit of the current period changed, either because a charging profile was added or cleared or because the
+    /// next period of the installed profiles started. It is called once with all evses directly after subscribing.
+    /// If smart charging is not available, the \p callback is never called.
+    /// \param duration of the composite schedules passed to the \p callback
+    /// \param unit of the period entries of the composite schedules
+    /// \param callback called on changes of the effective limits, replaces the callback of a previous subscription
+    virtual void subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                          const LimitsChangedCallback& callback) = 0;
+
+    /// \brief Removes the subscription created with subscribe_limits_changed
+    virtual void unsubscribe_limits_changed() = 0;
+
     /// \brief Gets the configured NetworkConnectionProfile based on the given \p configuration_slot . The
     /// central system uri of the connection options will not contain ws:// or wss:// because this method removes it if
     /// present. This returns the value from the cached network connection profiles. \param
@@ -366,6 +381,7 @@ private:
     std::unique_ptr<ProvisioningInterface> provisioning;
     std::unique_ptr<RemoteTransactionControlInterface> remote_transaction_control;
     std::unique_ptr<BidirectionalInterface> bidirectional;
+    std::unique_ptr<DERControlInterface> der_control;
 
     // utility
     std::shared_ptr<MessageQueue<v2::MessageType>> message_queue;
@@ -447,7 +463,7 @@ private:
                     conversions::messagetype_to_string(expected_response_message_type) +
                     ", got: " + conversions::messagetype_to_string(enhanced_response.messageType));
             }
-            const ocpp::CallResult<ResponseType> call_result = enhanced_response.message;
+            const ocpp::CallResult<ResponseType> call_result = *enhanced_response.message;
             return call_result.msg;
         };
     }
@@ -473,10 +489,13 @@ public:
     /// \param message_log_path Path to where logfiles are written to
     /// \param evse_security Pointer to evse_security that manages security related operations
     /// \param callbacks Callbacks that will be registered for ChargePoint
+    /// \param executor Executor that runs the timers of the ChargePoint; can be shared between multiple ChargePoint
+    /// instances. If nullptr, the ChargePoint creates its own executor
     ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connector_structure,
                 std::shared_ptr<DeviceModel> device_model, std::shared_ptr<DatabaseHandler> database_handler,
                 std::shared_ptr<MessageQueue<v2::MessageType>> message_queue, const std::string& message_log_path,
-                const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks);
+                const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks,
+                std::shared_ptr<Executor> executor = nullptr);
 
     /// \brief Construct a new ChargePoint object
     /// \param evse_connector_structure Map that defines the structure of EVSE and connectors of the chargepoint. The
@@ -488,11 +507,14 @@ public:
     /// \param message_log_path Path to where logfiles are written to
     /// \param evse_security Pointer to evse_security that manages security related operations
     /// \param callbacks Callbacks that will be registered for ChargePoint
+    /// \param executor Executor that runs the timers of the ChargePoint; can be shared between multiple ChargePoint
+    /// instances. If nullptr, the ChargePoint creates its own executor
     ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connector_structure,
                 std::unique_ptr<DeviceModelStorageInterface> device_model_storage_interface,
                 const std::string& ocpp_main_path, const std::string& core_database_path,
                 const std::string& sql_init_path, const std::string& message_log_path,
-                const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks);
+                const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks,
+                std::shared_ptr<Executor> executor = nullptr);
 
     /// \brief Construct a new ChargePoint object
     /// \param evse_connector_structure Map that defines the structure of EVSE and connectors of the chargepoint. The
@@ -507,12 +529,14 @@ public:
     /// \param evse_security Pointer to evse_security that manages security related operations; if nullptr
     /// security_configuration must be set
     /// \param callbacks Callbacks that will be registered for ChargePoint
+    /// \param executor Executor that runs the timers of the ChargePoint; can be shared between multiple ChargePoint
+    /// instances. If nullptr, the ChargePoint creates its own executor
     ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connector_structure,
                 const std::string& device_model_storage_address, const std::string& device_model_migration_path,
                 const std::string& device_model_config_path, const std::string& ocpp_main_path,
                 const std::string& core_database_path, const std::string& sql_init_path,
                 const std::string& message_log_path, const std::shared_ptr<EvseSecurity> evse_security,
-                const Callbacks& callbacks);
+                const Callbacks& callbacks, std::shared_ptr<Executor> executor = nullptr);
 
     /// @}  // End chargepoint 2.0.1 member group
 
@@ -611,6 +635,9 @@ public:
                                                             ChargingRateUnitEnum unit) override;
     std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                const ChargingRateUnitEnum& unit) override;
+    void subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                  const LimitsChangedCallback& callback) override;
+    void unsubscribe_limits_changed() override;
 
     std::optional<NetworkConnectionProfile>
     get_network_connection_profile(const std::int32_t configuration_slot) const override;
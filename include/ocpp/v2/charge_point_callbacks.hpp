@@ -5,6 +5,7 @@
 
 #include <ocpp/v2/connectivity_manager.hpp>
 #include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/types.hpp>
 
 #include <ocpp/v2/messages/BootNotification.hpp>
 #include <ocpp/v2/messages/ClearDisplayMessage.hpp>
@@ -184,6 +185,15 @@ struct Callbacks {
                                      const CiString<36> transaction_id)>>
         update_allowed_energy_transfer_modes_callback;
 
+    /// \brief Callback function is called when an AFRRSignalRequest results in a new power setpoint for an EVSE,
+    /// OCPP 2.1. The \p setpoint is in W, positive values charge and negative values discharge the EV. It is called
+    /// directly from the message handler without recalculating the composite schedule and should return quickly
+    std::optional<std::function<void(const std::int32_t evse_id, const float setpoint)>> afrr_signal_callback;
+
+    /// \brief Callback function is called with the results of the active DER curves (e.g. volt-var) after a meter
+    /// value of an EVSE was evaluated, OCPP 2.1
+    std::optional<DERCurveOutputCallback> der_curve_output_callback;
+
     /// @} // End group
 };
 } // namespace ocpp::v2
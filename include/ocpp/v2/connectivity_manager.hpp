@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/websocket/websocket.hpp>
 #include <ocpp/v2/messages/SetNetworkProfile.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
@@ -138,6 +139,8 @@ private:
     /// \brief Callback that is called to configure a network connection profile when none is configured
     std::optional<ConfigureNetworkConnectionProfileCallback> configure_network_connection_profile_callback;
 
+    /// \brief Runs the websocket timer
+    std::shared_ptr<Executor> executor;
     Everest::SteadyTimer websocket_timer;
     std::optional<std::int32_t> pending_configuration_slot;
     bool wants_to_be_connected;
@@ -152,7 +155,9 @@ private:
 public:
     ConnectivityManager(DeviceModel& device_model, std::shared_ptr<EvseSecurity> evse_security,
                         std::shared_ptr<MessageLogging> logging,
-                        const std::function<void(const std::string& message)>& message_callback);
+                        const std::function<void(const std::string& message)>& message_callback,
+                        std::shared_ptr<Executor> executor = nullptr);
+    ~ConnectivityManager() override;
 
     void set_websocket_authorization_key(const std::string& authorization_key) override;
     void set_websocket_connection_options(const WebsocketConnectionOptions& connection_options) override;
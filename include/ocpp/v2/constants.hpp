@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 
 namespace ocpp {
 namespace v2 {
@@ -13,5 +15,20 @@ namespace v2 {
 /// 17000 is the minimum value from OCPP 2.1
 constexpr std::size_t ISO15118_GET_EV_CERTIFICATE_EXI_RESPONSE_SIZE = 17000;
 
+/// \brief Maximum size of a message that is used if MaxMessageSize is not set in the device model
+constexpr std::int32_t DEFAULT_MAX_MESSAGE_SIZE = 65000;
+
+/// \brief Number of transaction metervalues that are buffered before they are written to the database if
+/// MeterValueBufferMaxSize is not set in the device model
+constexpr std::size_t DEFAULT_METER_VALUE_BUFFER_MAX_SIZE = 10;
+
+/// \brief Maximum time transaction metervalues are buffered before they are written to the database if
+/// MeterValueBufferMaxAge is not set in the device model
+constexpr std::chrono::seconds DEFAULT_METER_VALUE_BUFFER_MAX_AGE = std::chrono::minutes(1);
+
+/// \brief Number of times writing the buffered transaction metervalues in one database transaction is attempted before
+/// they are written one by one
+constexpr std::size_t METER_VALUE_BUFFER_MAX_FLUSH_ATTEMPTS = 3;
+
 } // namespace v2
 } // namespace ocpp
@@ -139,6 +139,9 @@ extern const ComponentVariable OcspRequestInterval;
 extern const ComponentVariable WebsocketPingPayload;
 extern const ComponentVariable WebsocketPongTimeout;
 extern const ComponentVariable MonitorsProcessingInterval;
+extern const ComponentVariable NotifyEventItemsPerMessage;
+extern const ComponentVariable NotifyEventBytesPerMessage;
+extern const ComponentVariable NotifyEventLatencyBudget;
 extern const ComponentVariable MaxCustomerInformationDataLength;
 extern const ComponentVariable V2GCertificateExpireCheckInitialDelaySeconds;
 extern const ComponentVariable V2GCertificateExpireCheckIntervalSeconds;
@@ -147,6 +150,9 @@ extern const ComponentVariable ClientCertificateExpireCheckIntervalSeconds;
 extern const ComponentVariable MessageQueueSizeThreshold;
 extern const ComponentVariable MaxMessageSize;
 extern const ComponentVariable ResumeTransactionsOnBoot;
+extern const ComponentVariable CompactDatabaseEncoding;
+extern const ComponentVariable MeterValueBufferMaxSize;
+extern const ComponentVariable MeterValueBufferMaxAge;
 extern const ComponentVariable AllowSecurityLevelZeroConnections;
 extern const RequiredComponentVariable SupportedOcppVersions;
 extern const ComponentVariable AlignedDataCtrlrEnabled;
@@ -299,6 +305,7 @@ extern const ComponentVariable TariffCostCtrlrAvailableCost;
 extern const RequiredComponentVariable TariffCostCtrlrCurrency;
 extern const ComponentVariable TariffCostCtrlrEnabledTariff;
 extern const ComponentVariable TariffCostCtrlrEnabledCost;
+extern const ComponentVariable TariffCostCtrlrMaxElementsTariff;
 extern const RequiredComponentVariable TariffFallbackMessage;
 extern const RequiredComponentVariable TotalCostFallbackMessage;
 extern const ComponentVariable NumberOfDecimalsForCostValues;
@@ -5,13 +5,20 @@
 
 #include "ocpp/v2/types.hpp"
 #include "sqlite3.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <ocpp/common/support_older_cpp_versions.hpp>
 
 #include <everest/database/sqlite/connection.hpp>
+#include <everest/timer.hpp>
 #include <ocpp/common/database/database_handler_common.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 #include <ocpp/v2/transaction.hpp>
+#include <ocpp/v21/messages/SetDERControl.hpp>
 
 #include <everest/logging.hpp>
 
@@ -24,6 +31,12 @@ struct AuthorizationCacheEntry {
     DateTime last_used;
 };
 
+/// \brief DER control as stored in the DER_CONTROLS table
+struct StoredDERControl {
+    v21::SetDERControlRequest control;
+    bool is_superseded;
+};
+
 class DatabaseHandlerInterface {
 public:
     virtual ~DatabaseHandlerInterface() = default;
@@ -121,12 +134,19 @@ public:
 
     // Transaction metervalues
 
-    /// \brief Inserts a \p meter_value to the database linked to transaction with id \p transaction_id
+    /// \brief Inserts a \p meter_value to the database linked to transaction with id \p transaction_id. Implementations
+    /// may buffer the value and write it later, but it must be returned by transaction_metervalues_get_all()
     virtual void transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) = 0;
 
     /// \brief Get all metervalues linked to transaction with id \p transaction_id
     virtual std::vector<MeterValue> transaction_metervalues_get_all(const std::string& transaction_id) = 0;
 
+    /// \brief Calls \p callback with every metervalue linked to transaction with id \p transaction_id, ordered by
+    /// timestamp. In contrast to transaction_metervalues_get_all() the metervalues are not collected in memory. The
+    /// \p callback must not access the database
+    virtual void transaction_metervalues_for_each(const std::string& transaction_id,
+                                                  const std::function<void(MeterValue&& meter_value)>& callback) = 0;
+
     /// \brief Remove all metervalue entries linked to transaction with id \p transaction_id
     virtual void transaction_metervalues_clear(const std::string& transaction_id) = 0;
 
@@ -199,12 +219,88 @@ public:
 
     virtual CiString<20> get_charging_limit_source_for_profile(const int profile_id) = 0;
 
+    /// default tariffs
+
+    /// \brief Inserts or updates the given \p tariff of \p evse_id in the DEFAULT_TARIFFS table
+    virtual void insert_or_update_default_tariff(const std::int32_t evse_id, const Tariff& tariff) = 0;
+
+    /// \brief Retrieves all default tariffs together with the EVSE they are set on
+    virtual std::vector<std::pair<std::int32_t, Tariff>> get_default_tariffs() = 0;
+
+    /// \brief Deletes the default tariff with the given \p tariff_id from \p evse_id
+    /// \return true if a tariff was deleted
+    virtual bool delete_default_tariff(const std::int32_t evse_id, const std::string& tariff_id) = 0;
+
+    /// DER controls
+
+    /// \brief Inserts or updates the given \p control in the DER_CONTROLS table. A control is identified by its
+    /// controlId and isDefault
+    virtual void insert_or_update_der_control(const v21::SetDERControlRequest& control, const bool is_superseded) = 0;
+
+    /// \brief Retrieves all stored DER controls
+    virtual std::vector<StoredDERControl> get_der_controls() = 0;
+
+    /// \brief Deletes the DER controls with the given \p is_default that match \p control_type and \p control_id. A
+    /// criterion that is not given matches all controls
+    /// \return true if at least one control was deleted
+    virtual bool delete_der_controls(const bool is_default, const std::optional<DERControlEnum>& control_type,
+                                     const std::optional<std::string>& control_id) = 0;
+
     virtual std::unique_ptr<everest::db::sqlite::StatementInterface> new_statement(const std::string& sql) = 0;
 };
 
 class DatabaseHandler : public DatabaseHandlerInterface, public common::DatabaseHandlerCommon {
 private:
+    struct BufferedMeterValue {
+        std::string transaction_id;
+        ReadingContextEnum context;
+        MeterValue meter_value;
+    };
+
+    // Transaction metervalues that are not yet written to the database
+    std::mutex meter_value_buffer_mutex;
+    std::vector<BufferedMeterValue> meter_value_buffer;
+    std::chrono::steady_clock::time_point meter_value_buffer_oldest;
+    std::size_t meter_value_buffer_max_size;
+    std::chrono::milliseconds meter_value_buffer_max_age;
+    // Number of failed attempts to write the current buffer in one database transaction
+    std::size_t meter_value_buffer_failed_flushes;
+    // Set on destruction, the meter_value_buffer_timer must not be armed anymore afterwards
+    bool meter_value_buffer_stopped;
+    std::atomic_bool use_compact_encoding;
+    std::shared_ptr<Executor> executor;
+    // Flushes the buffer once the oldest buffered metervalue reaches meter_value_buffer_max_age
+    Everest::SteadyTimer meter_value_buffer_timer;
+
+    // Prepared statements used to write the metervalue buffer, created on first use
+    std::unique_ptr<everest::db::sqlite::StatementInterface> insert_meter_value_stmt;
+    std::unique_ptr<everest::db::sqlite::StatementInterface> insert_meter_value_item_stmt;
+    std::unique_ptr<everest::db::sqlite::StatementInterface> insert_meter_value_block_stmt;
+
     void init_sql() override;
+    void deinit_sql() override;
+
+    /// \brief Writes all buffered metervalues in a single database transaction. If that fails, the buffer is kept and
+    /// written again on the next flush. After METER_VALUE_BUFFER_MAX_FLUSH_ATTEMPTS failed attempts the metervalues
+    /// are written one by one and only the ones that still fail are dropped. The caller must hold
+    /// meter_value_buffer_mutex
+    void flush_meter_value_buffer();
+    /// \brief Writes \p meter_values in a single database transaction
+    void write_meter_values(const std::vector<BufferedMeterValue>& meter_values);
+    /// \brief Writes each of \p meter_values in its own database transaction
+    /// \throws QueryExecutionException if any of them could not be written, after all others were written
+    void write_meter_values_one_by_one(const std::vector<BufferedMeterValue>& meter_values);
+    void prepare_meter_value_statements();
+    /// \brief Arms the meter_value_buffer_timer for the time left until the oldest buffered metervalue reaches
+    /// meter_value_buffer_max_age. The caller must hold meter_value_buffer_mutex
+    void start_meter_value_buffer_timer();
+    void on_meter_value_buffer_timer();
+    void insert_meter_value_rows(const BufferedMeterValue& buffered);
+    void insert_meter_value_item(const std::int64_t meter_value_id, const SampledValue& item);
+    void reset_meter_value_statements();
+    /// \brief Reads the metervalue of the current row of \p select_stmt and its items
+    MeterValue read_meter_value_row(everest::db::sqlite::StatementInterface& select_stmt,
+                                    everest::db::sqlite::StatementInterface& select_items_stmt);
 
     void inintialize_enum_tables();
     void init_enum_table_inner(const std::string& table_name, const int begin, const int end,
@@ -219,8 +315,28 @@ private:
     OperationalStatusEnum get_availability(std::int32_t evse_id, std::int32_t connector_id);
 
 public:
+    /// \param executor Executor that runs the timer flushing the metervalue buffer, the default executor if not
+    /// provided
     DatabaseHandler(std::unique_ptr<everest::db::sqlite::ConnectionInterface> database,
-                    const fs::path& sql_migration_files_path);
+                    const fs::path& sql_migration_files_path, std::shared_ptr<Executor> executor = nullptr);
+
+    ~DatabaseHandler() override;
+
+    /// \brief Sets the bounds of the buffer used by transaction_metervalues_insert(). Buffered metervalues are written
+    /// once \p max_size metervalues are buffered or the oldest buffered metervalue reaches \p max_age, also without
+    /// further inserts.
+    /// Transaction_Begin and Transaction_End metervalues are always written immediately. A \p max_size of 0 disables
+    /// the buffer
+    void set_meter_value_buffer_limits(std::size_t max_size, std::chrono::milliseconds max_age);
+
+    /// \brief Writes all buffered metervalues to the database
+    void transaction_metervalues_flush();
+
+    /// \brief Enables or disables the compact encoding of the metervalues and charging profiles that are written from
+    /// now on. With the compact encoding the metervalues written in one flush are stored as a single row per
+    /// transaction, metervalues with signed data or custom data are still stored in the regular tables. Both encodings
+    /// are always read
+    void set_compact_encoding(bool enabled);
 
     // Authorization cache management
     void authorization_cache_insert_entry(const std::string& id_token_hash, const IdTokenInfo& id_token_info) override;
@@ -257,6 +373,8 @@ public:
     // Transaction metervalues
     void transaction_metervalues_insert(const std::string& transaction_id, const MeterValue& meter_value) override;
     std::vector<MeterValue> transaction_metervalues_get_all(const std::string& transaction_id) override;
+    void transaction_metervalues_for_each(const std::string& transaction_id,
+                                          const std::function<void(MeterValue&& meter_value)>& callback) override;
     void transaction_metervalues_clear(const std::string& transaction_id) override;
 
     // transactions
@@ -285,6 +403,17 @@ public:
     std::map<std::int32_t, std::vector<v2::ChargingProfile>> get_all_charging_profiles_group_by_evse() override;
     CiString<20> get_charging_limit_source_for_profile(const int profile_id) override;
 
+    /// default tariffs
+    void insert_or_update_default_tariff(const std::int32_t evse_id, const Tariff& tariff) override;
+    std::vector<std::pair<std::int32_t, Tariff>> get_default_tariffs() override;
+    bool delete_default_tariff(const std::int32_t evse_id, const std::string& tariff_id) override;
+
+    /// DER controls
+    void insert_or_update_der_control(const v21::SetDERControlRequest& control, const bool is_superseded) override;
+    std::vector<StoredDERControl> get_der_controls() override;
+    bool delete_der_controls(const bool is_default, const std::optional<DERControlEnum>& control_type,
+                             const std::optional<std::string>& control_id) override;
+
     std::unique_ptr<everest::db::sqlite::StatementInterface> new_statement(const std::string& sql) override;
 };
 
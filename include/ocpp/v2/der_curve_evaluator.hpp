@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <ocpp/v2/ocpp_types.hpp>
+
+namespace ocpp::v2 {
+
+/// \brief Evaluates a set of piecewise linear DER curves in one pass.
+///
+/// Every curve is compiled once into a sum of hinge functions: the input is clamped to the x range of the curve and
+/// y = y_0 + sum_k(slope_k * max(0, x - x_k)), with one hinge per segment of the curve. The hinges of all curves are
+/// stored as structure of arrays and padded to the same number per curve, so evaluate() is a branch free loop over all
+/// curves per hinge that the compiler can vectorize. The cost of an evaluation only depends on the number of curves and
+/// the number of points of the longest curve.
+class DERCurveEvaluator {
+public:
+    DERCurveEvaluator() = default;
+
+    /// \brief Compiles \p curves. The points of a curve do not have to be sorted by x. Of multiple points with the same
+    /// x only the first one is used. An empty curve always evaluates to 0
+    explicit DERCurveEvaluator(const std::vector<std::vector<DERCurvePoints>>& curves);
+
+    /// \returns the number of compiled curves
+    std::size_t size() const;
+
+    /// \brief Evaluates curve i at \p inputs[i] and writes the result to \p outputs[i]. Inputs outside of the x range
+    /// of a curve get the y of its first or last point
+    /// \param inputs Must have at least size() elements, additional elements are ignored
+    /// \param outputs Is resized to size() elements
+    /// \throws std::invalid_argument if \p inputs has less than size() elements
+    void evaluate(const std::vector<float>& inputs, std::vector<float>& outputs) const;
+
+private:
+    std::size_t number_of_curves = 0;
+    std::size_t number_of_hinges = 0;
+    std::vector<float> x_min;
+    std::vector<float> x_max;
+    std::vector<float> y_start;
+    /// \brief x of the hinges, hinge major: the hinge k of curve i is at k * number_of_curves + i
+    std::vector<float> knots;
+    /// \brief Change of the slope at the hinges, same layout as knots
+    std::vector<float> slopes;
+};
+
+} // namespace ocpp::v2
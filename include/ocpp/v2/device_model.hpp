@@ -88,6 +88,20 @@ using on_variable_changed = std::function<void(
     const Variable& variable, const VariableCharacteristics& characteristics, const VariableAttribute& attribute,
     const std::string& value_previous, const std::string& value_current)>;
 
+/// \brief Change of the actual value of a monitored variable. The references are only valid during the call of the
+/// listener
+struct VariableChange {
+    const std::unordered_map<std::int64_t, VariableMonitoringMeta>& monitors;
+    const Component& component;
+    const Variable& variable;
+    const VariableCharacteristics& characteristics;
+    const VariableAttribute& attribute;
+    std::string value_previous;
+    std::string value_current;
+};
+
+using on_variables_changed = std::function<void(const std::vector<VariableChange>& changes)>;
+
 using on_monitor_updated = std::function<void(const VariableMonitoringMeta& updated_monitor, const Component& component,
                                               const Variable& variable, const VariableCharacteristics& characteristics,
                                               const VariableAttribute& attribute, const std::string& current_value)>;
@@ -102,6 +116,8 @@ private:
 
     /// \brief Listener for the internal change of a variable
     on_variable_changed variable_listener;
+    /// \brief Listener for the changes of a batch of variables, see set_values
+    on_variables_changed variables_listener;
     /// \brief Listener for the internal update of a monitor
     on_monitor_updated monitor_update_listener;
 
@@ -118,6 +134,12 @@ private:
                                                  const AttributeEnum& attribute_enum, std::string& value,
                                                  bool allow_write_only) const;
 
+    /// \brief Sets the values of \p set_variable_data_vector like set_values. All values are validated against the
+    /// storage before any of them is written, so \p set_variable_data_vector must not contain a VariableAttribute more
+    /// than once
+    std::vector<SetVariableStatusEnum> set_values_batch(const std::vector<SetVariableData>& set_variable_data_vector,
+                                                        const std::string& source, const bool allow_read_only);
+
     /// \brief Iterates over the given \p component_criteria and converts this to the variable names
     /// (Active,Available,Enabled,Problem). If any of the variables can not be found as part of a component this
     /// function returns false. If any of those variable's value is true, this function returns true (except for
@@ -228,6 +250,12 @@ public:
         return {req_status};
     }
 
+    /// \brief Requests the values of all VariableAttributes specified by \p get_variable_data_vector from the device
+    /// model. All values are retrieved from the device model storage with a single request.
+    /// \param get_variable_data_vector
+    /// \return GetVariableResult for each element of \p get_variable_data_vector in the same order
+    std::vector<GetVariableResult> request_values(const std::vector<GetVariableData>& get_variable_data_vector);
+
     /// \brief Get the mutability for the given component, variable and attribute_enum
     /// \param component_id
     /// \param variable_id
@@ -249,6 +277,20 @@ public:
     SetVariableStatusEnum set_value(const Component& component_id, const Variable& variable_id,
                                     const AttributeEnum& attribute_enum, const std::string& value,
                                     const std::string& source, const bool allow_read_only = false);
+    /// \brief Sets the values of all VariableAttributes specified by \p set_variable_data_vector. Each value is
+    /// validated like in set_value, all accepted values are written to the device model storage within a single
+    /// transaction. After the transaction has been committed the variables listener is notified once with all changed
+    /// variables, the variable listener is notified per changed variable if no variables listener is registered.
+    /// If a VariableAttribute is set more than once, the values are applied one after another: the batch is split
+    /// before the repeated VariableAttribute and each part is written and notified on its own.
+    /// \param set_variable_data_vector
+    /// \param source           The source of the values (for example 'csms' or 'default').
+    /// \param allow_read_only If this is true, read-only variables can be changed,
+    ///                        otherwise only non read-only variables can be changed. Defaults to false
+    /// \return Result of the requested operation for each element of \p set_variable_data_vector in the same order
+    std::vector<SetVariableStatusEnum> set_values(const std::vector<SetVariableData>& set_variable_data_vector,
+                                                  const std::string& source, const bool allow_read_only = false);
+
     /// \brief Sets the variable_id attribute \p value specified by \p component_id , \p variable_id and \p
     /// attribute_enum for read only variables only. Only works on certain allowed components.
     /// \param component_id
@@ -289,6 +331,10 @@ public:
         variable_listener = std::move(listener);
     }
 
+    void register_variables_listener(on_variables_changed&& listener) {
+        variables_listener = std::move(listener);
+    }
+
     void register_monitor_listener(on_monitor_updated&& listener) {
         monitor_update_listener = std::move(listener);
     }
@@ -36,6 +36,20 @@ struct VariableMetaData {
     std::optional<std::string> source;
 };
 
+/// \brief Identifies a single VariableAttribute of a component variable, used for batch access to the storage
+struct VariableAttributeKey {
+    Component component;
+    Variable variable;
+    AttributeEnum attribute_enum;
+};
+
+/// \brief A single value update of a VariableAttribute, used for batch writes to the storage
+struct VariableAttributeValueUpdate {
+    VariableAttributeKey key;
+    std::string value;
+    std::string source;
+};
+
 using VariableMap = std::map<Variable, VariableMetaData>;
 using DeviceModelMap = std::map<Component, VariableMap>;
 
@@ -98,6 +112,43 @@ public:
                                                                const AttributeEnum& attribute_enum,
                                                                const std::string& value, const std::string& source) = 0;
 
+    /// \brief Gets the VariableAttribute for each of the given \p keys with as few storage accesses as possible. The
+    /// default implementation calls get_variable_attributes for each key
+    /// \param keys
+    /// \return std::vector with the same size and order as \p keys. An element is std::nullopt if the
+    /// VariableAttribute is not present in the storage
+    virtual std::vector<std::optional<VariableAttribute>>
+    get_variable_attributes_batch(const std::vector<VariableAttributeKey>& keys) {
+        std::vector<std::optional<VariableAttribute>> attributes;
+        attributes.reserve(keys.size());
+        for (const auto& key : keys) {
+            auto key_attributes = this->get_variable_attributes(key.component, key.variable, key.attribute_enum);
+            if (key_attributes.empty()) {
+                attributes.emplace_back(std::nullopt);
+            } else {
+                attributes.emplace_back(std::move(key_attributes.front()));
+            }
+        }
+        return attributes;
+    }
+
+    /// \brief Sets the values of multiple VariableAttributes within a single storage transaction. The default
+    /// implementation calls set_variable_attribute_value for each update, so the updates are not written atomically
+    /// \param updates
+    /// \return std::vector with the same size and order as \p updates containing the result of each update. Accepted
+    /// if the value could be set in the storage, Rejected if not
+    virtual std::vector<SetVariableStatusEnum>
+    set_variable_attribute_values_batch(const std::vector<VariableAttributeValueUpdate>& updates) {
+        std::vector<SetVariableStatusEnum> results;
+        results.reserve(updates.size());
+        for (const auto& update : updates) {
+            results.push_back(this->set_variable_attribute_value(update.key.component, update.key.variable,
+                                                                 update.key.attribute_enum, update.value,
+                                                                 update.source));
+        }
+        return results;
+    }
+
     /// \brief Inserts or replaces a variable monitor in the database
     /// \param data Monitor data to set
     /// \return true if the value could be inserted, or valse otherwise
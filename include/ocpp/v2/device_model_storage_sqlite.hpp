@@ -23,6 +23,10 @@ private:
 
     int get_variable_id(const Component& component_id, const Variable& variable_id);
 
+    /// \brief Resolves the database ids of all variables referenced by \p keys with a single query
+    /// \return map of component and variable to the variable id. Variables that could not be found are not contained
+    std::map<std::pair<Component, Variable>, int> get_variable_ids(const std::vector<VariableAttributeKey>& keys);
+
     void initialize_connection(const fs::path& db_path);
 
 public:
@@ -64,6 +68,12 @@ public:
                                                        const AttributeEnum& attribute_enum, const std::string& value,
                                                        const std::string& source) final;
 
+    std::vector<std::optional<VariableAttribute>>
+    get_variable_attributes_batch(const std::vector<VariableAttributeKey>& keys) final;
+
+    std::vector<SetVariableStatusEnum>
+    set_variable_attribute_values_batch(const std::vector<VariableAttributeValueUpdate>& updates) final;
+
     std::optional<VariableMonitoringMeta> set_monitoring_data(const SetMonitoringData& data,
                                                               const VariableMonitorType type) final;
 
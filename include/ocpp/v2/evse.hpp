@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 
+#include <ocpp/common/latest_value_slot.hpp>
 #include <ocpp/v2/average_meter_values.hpp>
 #include <ocpp/v2/component_state_manager.hpp>
 #include <ocpp/v2/connector.hpp>
@@ -105,7 +108,8 @@ public:
     /// \param event
     virtual void submit_event(const std::int32_t connector_id, ConnectorEvent event) = 0;
 
-    /// \brief Event handler that should be called when a new meter_value for this evse is present
+    /// \brief Event handler that should be called when a new meter_value for this evse is present. The meter_value is
+    /// processed asynchronously, so this does not block. Must not be called concurrently for the same evse
     /// \param meter_value
     virtual void on_meter_value(const MeterValue& meter_value) = 0;
 
@@ -177,7 +181,17 @@ private:
     std::function<void(std::int32_t evse_id)> pause_charging_callback;
     std::unique_ptr<EnhancedTransaction> transaction; // pointer to active transaction (can be nullptr)
     MeterValue meter_value;                           // represents current meter value
-    std::recursive_mutex meter_value_mutex;
+
+    /// \brief State shared with the handlers that process the published metervalues, so a handler that runs after the
+    /// evse was destroyed does nothing
+    struct MeterValueProcessing {
+        std::recursive_mutex mutex;
+        bool stopped = false;
+    };
+    std::shared_ptr<MeterValueProcessing> meter_value_processing;
+    /// \brief Latest metervalue published by on_meter_value() that was not processed yet
+    LatestValueSlot<MeterValue> published_meter_value;
+    std::atomic_bool meter_value_processing_scheduled;
     Everest::SteadyTimer sampled_meter_values_timer;
     std::shared_ptr<DatabaseHandler> database_handler;
 
@@ -186,7 +200,11 @@ private:
     std::unique_ptr<Everest::SystemTimer> trigger_metervalue_at_time_timer;
     std::optional<double> last_triggered_metervalue_power_kw;
     std::function<void(const std::vector<MeterValue>& meter_values)> send_metervalue_function;
-    boost::asio::io_context io_context;
+    boost::asio::io_context& io_context;
+
+    /// \brief Processes the latest metervalue published by on_meter_value() if there is one: updates the averaged
+    /// metervalues and checks the max energy on invalid id and the pricing triggers
+    void process_meter_value();
 
     /// \brief gets the active import energy meter value from meter_value, normalized to Wh.
     std::optional<float> get_active_import_register_meter_value();
@@ -240,12 +258,14 @@ public:
     /// \param transaction_meter_value_req that is called to transmit a meter value request related to a transaction
     /// \param pause_charging_callback that is called when the charging should be paused due to max energy on
     /// invalid id being exceeded
+    /// \param io_context on which the metervalues passed to on_meter_value() are processed
     Evse(const std::int32_t evse_id, const std::int32_t number_of_connectors, DeviceModel& device_model,
          std::shared_ptr<DatabaseHandler> database_handler,
          std::shared_ptr<ComponentStateManagerInterface> component_state_manager,
          const std::function<void(const MeterValue& meter_value, EnhancedTransaction& transaction)>&
              transaction_meter_value_req,
-         const std::function<void(std::int32_t evse_id)>& pause_charging_callback);
+         const std::function<void(std::int32_t evse_id)>& pause_charging_callback,
+         boost::asio::io_context& io_context);
 
     ~Evse() override;
 
@@ -86,7 +86,8 @@ public:
                 std::shared_ptr<ComponentStateManagerInterface> component_state_manager,
                 const std::function<void(const MeterValue& meter_value, EnhancedTransaction& transaction)>&
                     transaction_meter_value_req,
-                const std::function<void(std::int32_t evse_id)>& pause_charging_callback);
+                const std::function<void(std::int32_t evse_id)>& pause_charging_callback,
+                boost::asio::io_context& io_context);
 
     EvseInterface& get_evse(std::int32_t id) override;
     const EvseInterface& get_evse(const std::int32_t id) const override;
@@ -6,6 +6,7 @@
 #include <ocpp/v2/message_handler.hpp>
 
 #include <ocpp/v2/monitoring_updater.hpp>
+#include <ocpp/v2/notify_event_batcher.hpp>
 
 namespace ocpp::v2 {
 class AuthorizationInterface;
@@ -38,6 +39,11 @@ public:
     virtual void stop_monitoring() = 0;
     virtual void start_monitoring() = 0;
     virtual void process_triggered_monitors() = 0;
+    /// \brief Re-reads the monitoring configuration after one of the MonitoringCtrlr variables changed
+    virtual void update_monitoring_config() = 0;
+    /// \brief Re-reads the limits and the latency budget of the NotifyEventRequests after one of the NotifyEvent
+    /// variables of the InternalCtrlr or MaxMessageSize changed
+    virtual void update_notify_event_config() = 0;
 };
 
 class Diagnostics : public DiagnosticsInterface {
@@ -46,16 +52,31 @@ public:
                 GetLogRequestCallback get_log_request_callback,
                 std::optional<GetCustomerInformationCallback> get_customer_information_callback,
                 std::optional<ClearCustomerInformationCallback> clear_customer_information_callback);
+    ~Diagnostics() override;
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
     void notify_event_req(const std::vector<EventData>& events) override;
     void stop_monitoring() override;
     void start_monitoring() override;
     void process_triggered_monitors() override;
+    void update_monitoring_config() override;
+    void update_notify_event_config() override;
 
 private:
     // Members
     const FunctionalBlockContext& context;
     AuthorizationInterface& authorization;
+    /// \brief Combines the events generated by the monitors into as few NotifyEventRequests as possible. Declared
+    /// before the monitoring_updater so that it outlives it
+    NotifyEventBatcher notify_event_batcher;
+    std::mutex notify_event_mutex;
+    /// \brief Held while the pending events are taken and dispatched, so that concurrent flushes from the timer and
+    /// from a full batch dispatch the NotifyEventRequests in order. Locked before notify_event_mutex
+    std::mutex notify_event_flush_mutex;
+    /// \brief Time that events are held back to be combined with other events, 0 to send them immediately
+    std::chrono::milliseconds notify_event_latency_budget;
+    /// \brief Flushes the pending events once the NotifyEventLatencyBudget has passed
+    Everest::SteadyTimer notify_event_timer;
+    bool is_notify_event_flush_scheduled;
     /// \brief Updater for triggered monitors
     MonitoringUpdater monitoring_updater;
     GetLogRequestCallback get_log_request_callback;
@@ -71,6 +92,8 @@ private:
     /* OCPP message requests */
     void notify_customer_information_req(const std::string& data, const std::int32_t request_id);
     void notify_monitoring_report_req(const int request_id, std::vector<MonitoringData>& montoring_data);
+    /// \brief Sends all events that are pending in the notify_event_batcher
+    void flush_notify_events();
 
     /* OCPP message handlers */
     void handle_get_log_req(Call<GetLogRequest> call);
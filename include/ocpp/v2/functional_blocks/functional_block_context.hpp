@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <ocpp/common/contract_certificate_cache.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/common/message_dispatcher.hpp>
 #include <ocpp/v2/types.hpp>
 
@@ -29,12 +31,19 @@ struct FunctionalBlockContext {
     EvseSecurity& evse_security;
     ComponentStateManagerInterface& component_state_manager;
     std::atomic<OcppProtocolVersion>& ocpp_version;
+    /// \brief Runs the timers of the functional blocks
+    std::shared_ptr<Executor> executor;
+    /// \brief Caches the verification of contract certificate chains by evse_security. Has to be cleared when CA
+    /// certificates are installed or deleted
+    std::shared_ptr<ContractCertificateCache> contract_certificate_cache;
 
     FunctionalBlockContext(MessageDispatcherInterface<MessageType>& message_dispatcher, DeviceModel& device_model,
                            ConnectivityManagerInterface& connectivity_manager, EvseManagerInterface& evse_manager,
                            DatabaseHandlerInterface& database_handler, EvseSecurity& evse_security,
                            ComponentStateManagerInterface& component_state_manager,
-                           std::atomic<OcppProtocolVersion>& ocpp_version) :
+                           std::atomic<OcppProtocolVersion>& ocpp_version,
+                           std::shared_ptr<Executor> executor = nullptr,
+                           std::shared_ptr<ContractCertificateCache> contract_certificate_cache = nullptr) :
         message_dispatcher(message_dispatcher),
         device_model(device_model),
         connectivity_manager(connectivity_manager),
@@ -42,7 +51,11 @@ struct FunctionalBlockContext {
         database_handler(database_handler),
         evse_security(evse_security),
         component_state_manager(component_state_manager),
-        ocpp_version(ocpp_version) {
+        ocpp_version(ocpp_version),
+        executor(executor != nullptr ? executor : Executor::get_default()),
+        contract_certificate_cache(contract_certificate_cache != nullptr
+                                       ? contract_certificate_cache
+                                       : std::make_shared<ContractCertificateCache>(evse_security)) {
     }
 };
 } // namespace v2
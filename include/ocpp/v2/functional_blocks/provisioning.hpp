@@ -14,6 +14,7 @@ class SecurityInterface;
 class MeterValuesInterface;
 class DiagnosticsInterface;
 class TransactionInterface;
+class TariffAndCostInterface;
 
 struct BootNotificationResponse;
 struct SetVariablesRequest;
@@ -66,7 +67,8 @@ public:
     Provisioning(const FunctionalBlockContext& functional_block_context, MessageQueue<v2::MessageType>& message_queue,
                  OcspUpdaterInterface& ocsp_updater, AvailabilityInterface& availability,
                  MeterValuesInterface& meter_values, SecurityInterface& security, DiagnosticsInterface& diagnostics,
-                 TransactionInterface& transaction, std::optional<TimeSyncCallback> time_sync_callback,
+                 TransactionInterface& transaction, TariffAndCostInterface& tariff_and_cost,
+                 std::optional<TimeSyncCallback> time_sync_callback,
                  std::optional<BootNotificationCallback> boot_notification_callback,
                  std::optional<ValidateNetworkProfileCallback> validate_network_profile_callback,
                  IsResetAllowedCallback is_reset_allowed_callback, ResetCallback reset_callback,
@@ -74,6 +76,7 @@ public:
                  std::optional<VariableChangedCallback> variable_changed_callback,
 
                  std::atomic<RegistrationStatusEnum>& registration_status);
+    ~Provisioning() override;
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
     void boot_notification_req(const BootReasonEnum& reason, const bool initiated_by_trigger_message = false) override;
     void stop_bootnotification_timer() override;
@@ -93,6 +96,7 @@ private:
     SecurityInterface& security;
     DiagnosticsInterface& diagnostics;
     TransactionInterface& transaction;
+    TariffAndCostInterface& tariff_and_cost;
 
     std::optional<TimeSyncCallback> time_sync_callback;
     std::optional<BootNotificationCallback> boot_notification_callback;
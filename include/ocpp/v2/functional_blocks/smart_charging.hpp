@@ -5,8 +5,16 @@
 
 #include <ocpp/v2/message_handler.hpp>
 
+#include <mutex>
+
+#include <everest/timer.hpp>
+
 #include <ocpp/v2/evse.hpp>
 
+namespace ocpp::v21 {
+struct UpdateDynamicScheduleRequest;
+} // namespace ocpp::v21
+
 namespace ocpp::v2 {
 struct FunctionalBlockContext;
 class SmartChargingHandlerInterface;
@@ -77,7 +85,8 @@ enum class ProfileValidationResultEnum {
     DuplicateTxDefaultProfileFound,
     DuplicateProfileValidityPeriod,
     RequestStartTransactionNonTxProfile,
-    ChargingProfileEmptyChargingSchedules
+    ChargingProfileEmptyChargingSchedules,
+    ChargingProfileNotFound
 };
 
 /// \brief This is used to associate charging profiles with a source.
@@ -118,11 +127,36 @@ public:
     virtual std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                        const ChargingRateUnitEnum& unit) = 0;
 
+    /// \brief Subscribes to changes of the effective limits, so they do not have to be polled using
+    /// get_all_composite_schedules. The \p callback is called with the composite schedules of all evses (including 0)
+    /// whose limit of the current period changed. This is checked when a charging profile is added or cleared and at
+    /// the start of the next period of the installed profiles. The \p callback is called once with the composite
+    /// schedules of all evses directly after subscribing.
+    /// \param duration of the composite schedules passed to the \p callback
+    /// \param unit of the period entries of the composite schedules
+    /// \param callback called on changes of the effective limits, replaces the callback of a previous subscription
+    virtual void subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                          const LimitsChangedCallback& callback) = 0;
+
+    /// \brief Removes the subscription created with subscribe_limits_changed
+    virtual void unsubscribe_limits_changed() = 0;
+
     ///
     /// \brief for the given \p transaction_id removes the associated charging profile.
     ///
     virtual void delete_transaction_tx_profiles(const std::string& transaction_id) = 0;
 
+    ///
+    /// \brief Re-evaluates the limits of \p evse_id for the limits changed subscription after a transaction started or
+    /// finished on it, since TxProfiles only apply during a transaction and relative profiles start with it.
+    ///
+    virtual void on_transaction_changed(const std::int32_t evse_id) = 0;
+
+    ///
+    /// \brief Deletes all stored charging profiles that do not pass the validation anymore, e.g. after a reboot.
+    ///
+    virtual void clear_invalid_profiles() = 0;
+
     ///
     /// \brief validates the given \p profile according to the specification,
     /// adding it to our stored list of profiles if valid.
@@ -168,18 +202,53 @@ private: // Members
     std::map<ChargingProfilePurposeEnum, DateTime> last_charging_profile_update;
     StopTransactionCallback stop_transaction_callback;
 
+    std::mutex limits_changed_mutex;
+    LimitsChangedCallback limits_changed_callback;
+    std::int32_t limits_changed_duration;
+    ChargingRateUnitEnum limits_changed_unit;
+    /// \brief The current period of the composite schedule per evse id that was last passed to the
+    /// limits_changed_callback
+    std::map<std::int32_t, std::optional<ChargingSchedulePeriod>> reported_limits;
+    Everest::SteadyTimer next_limits_change_timer;
+
+    /// \brief Dynamic charging profile that is kept in memory, so that a schedule update does not have to read,
+    /// validate and write the whole profile
+    struct DynamicProfile {
+        std::int32_t evse_id;
+        ChargingProfile profile;
+        CiString<20> charging_limit_source;
+        /// \brief True if the profile was updated after it was last written to the database
+        bool dirty = false;
+        /// \brief Time at which the next PullDynamicScheduleUpdateRequest is sent, if the profile has a
+        /// dynUpdateInterval
+        std::optional<DateTime> next_pull;
+    };
+
+    std::mutex dynamic_profiles_mutex;
+    /// \brief Dynamic profiles by charging profile id
+    std::map<std::int32_t, DynamicProfile> dynamic_profiles;
+    bool dynamic_profiles_persist_pending;
+    Everest::SteadyTimer dynamic_profiles_persist_timer;
+    Everest::SteadyTimer dynamic_update_pull_timer;
+
 public:
     SmartCharging(const FunctionalBlockContext& functional_block_context,
                   std::function<void()> set_charging_profiles_callback,
                   StopTransactionCallback stop_transaction_callback);
+    ~SmartCharging() override;
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
     GetCompositeScheduleResponse get_composite_schedule(const GetCompositeScheduleRequest& request) override;
     std::optional<CompositeSchedule> get_composite_schedule(std::int32_t evse_id, std::chrono::seconds duration,
                                                             ChargingRateUnitEnum unit) override;
     std::vector<CompositeSchedule> get_all_composite_schedules(const std::int32_t duration,
                                                                const ChargingRateUnitEnum& unit) override;
+    void subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                  const LimitsChangedCallback& callback) override;
+    void unsubscribe_limits_changed() override;
 
     void delete_transaction_tx_profiles(const std::string& transaction_id) override;
+    void on_transaction_changed(const std::int32_t evse_id) override;
+    void clear_invalid_profiles() override;
 
     SetChargingProfileResponse conform_validate_and_add_profile(
         ChargingProfile& profile, std::int32_t evse_id,
@@ -250,7 +319,7 @@ protected:
     ///
     /// \brief Gets the charging profiles for the given \p request
     ///
-    std::vector<ReportedChargingProfile> get_reported_profiles(const GetChargingProfilesRequest& request) const;
+    std::vector<ReportedChargingProfile> get_reported_profiles(const GetChargingProfilesRequest& request);
 
     /// \brief Retrieves all profiles that should be considered for calculating the composite schedule. Only profiles
     /// that belong to the given \p evse_id and that are not contained in \p purposes_to_ignore are included in the
@@ -272,10 +341,49 @@ private: // Functions
     void handle_get_charging_profiles_req(Call<GetChargingProfilesRequest> call);
     void handle_get_composite_schedule_req(Call<GetCompositeScheduleRequest> call);
     void handle_notify_ev_charging_needs_response(const EnhancedMessage<MessageType>& call_result);
+    void handle_update_dynamic_schedule_req(Call<v21::UpdateDynamicScheduleRequest> call);
+    void handle_pull_dynamic_schedule_update_response(const EnhancedMessage<MessageType>& call_result);
 
     GetCompositeScheduleResponse get_composite_schedule_internal(const GetCompositeScheduleRequest& request,
                                                                  bool simulate_transaction_active = true);
 
+    ///
+    /// \brief Calls the limits_changed_callback with the composite schedules of the evses whose current limit changed
+    /// since the last call and starts the timer for the next check at the start of the next period
+    ///
+    void notify_limits_changed();
+
+    ///
+    /// \brief Calls the limits_changed_callback with the composite schedule of \p evse_id if its current limit changed.
+    /// Only the composite schedule of this evse is calculated. Falls back to notify_limits_changed for evse id 0
+    ///
+    void notify_evse_limits_changed(std::int32_t evse_id);
+
+    ///
+    /// \brief Applies the values of \p update to the period of the dynamic profile with \p profile_id in memory. The
+    /// profile is written to the database later by persist_dynamic_profiles and the change is published with
+    /// notify_evse_limits_changed
+    /// \return the result, with a reason if the update was rejected
+    ///
+    ProfileValidationResultEnum apply_dynamic_schedule_update(std::int32_t profile_id,
+                                                              const ChargingScheduleUpdate& update,
+                                                              std::optional<std::int32_t>& evse_id);
+
+    /// \brief Loads all dynamic profiles from the database into memory and schedules their pulls
+    void load_dynamic_profiles();
+
+    /// \brief Adds, replaces or removes the in memory copy of \p profile after it was stored in the database
+    void on_profile_stored(const ChargingProfile& profile, std::int32_t evse_id, const CiString<20>& source);
+
+    /// \brief Writes the dynamic profiles that were updated in memory to the database
+    void persist_dynamic_profiles();
+
+    /// \brief Starts the timer for the next PullDynamicScheduleUpdateRequest. dynamic_profiles_mutex must be locked
+    void schedule_dynamic_update_pull();
+
+    /// \brief Sends a PullDynamicScheduleUpdateRequest for every dynamic profile whose dynUpdateInterval elapsed
+    void pull_dynamic_schedule_updates();
+
     ///
     /// \brief Checks a given \p candidate_profile and associated \p evse_id validFrom and validTo range
     /// This method assumes that the existing candidate_profile will have dates set for validFrom and validTo
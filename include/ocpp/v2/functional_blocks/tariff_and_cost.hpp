@@ -3,9 +3,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <ocpp/common/latest_value_slot.hpp>
 #include <ocpp/v2/message_handler.hpp>
 
 #include <ocpp/v2/functional_blocks/display_message.hpp>
+#include <ocpp/v2/tariff_calculator.hpp>
+
+namespace ocpp::v21 {
+struct SetDefaultTariffRequest;
+struct GetTariffsRequest;
+struct ClearTariffsRequest;
+struct ChangeTransactionTariffRequest;
+} // namespace ocpp::v21
 
 namespace ocpp::v2 {
 struct FunctionalBlockContext;
@@ -30,6 +44,24 @@ public:
     virtual void handle_cost_and_tariff(const TransactionEventResponse& response,
                                         const TransactionEventRequest& original_message,
                                         const json& original_transaction_event_response) = 0;
+
+    /// \brief Starts the local cost calculation of the transaction on \p evse_id. The default tariff that is valid at
+    /// \p timestamp is applied, if there is one.
+    virtual void on_transaction_started(const std::int32_t evse_id, const std::string& transaction_id,
+                                        const DateTime& timestamp, const MeterValue& meter_start) = 0;
+
+    /// \brief Adds \p meter_value to the local cost calculation of the transaction on \p evse_id and reports the
+    /// running cost if cost is enabled and a tariff applies to the transaction. The meter value is processed on the
+    /// io_context, so the caller never waits for the calculation.
+    virtual void on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) = 0;
+
+    /// \brief Reports the final cost of the transaction on \p evse_id and stops its local cost calculation.
+    virtual void on_transaction_finished(const std::int32_t evse_id, const DateTime& timestamp,
+                                         const MeterValue& meter_stop) = 0;
+
+    /// \brief Reloads the cost settings (TariffCostCtrlr cost available / enabled and the number of decimals of cost
+    /// values) from the device model. Must be called when one of them changed.
+    virtual void update_cost_config() = 0;
 };
 
 class TariffAndCost : public TariffAndCostInterface {
@@ -38,13 +70,31 @@ public:
                   std::optional<TariffMessageCallback>& tariff_message_callback,
                   std::optional<SetRunningCostCallback>& set_running_cost_callback,
                   boost::asio::io_context& io_context);
+    ~TariffAndCost() override;
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
 
     void handle_cost_and_tariff(const TransactionEventResponse& response,
                                 const TransactionEventRequest& original_message,
                                 const json& original_transaction_event_response) override;
 
+    void on_transaction_started(const std::int32_t evse_id, const std::string& transaction_id,
+                                const DateTime& timestamp, const MeterValue& meter_start) override;
+    void on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) override;
+    void on_transaction_finished(const std::int32_t evse_id, const DateTime& timestamp,
+                                 const MeterValue& meter_stop) override;
+    void update_cost_config() override;
+
 private:
+    /// \brief Local cost calculation of a running transaction
+    struct TransactionTariff {
+        std::string transaction_id;
+        /// \brief Last sample of the transaction, used to start a calculator when a tariff is set during the
+        /// transaction
+        TariffMeterSample last_sample;
+        TariffKindEnum tariff_kind = TariffKindEnum::DefaultTariff;
+        std::optional<TariffCalculator> calculator;
+    };
+
     // Members
     const FunctionalBlockContext& context;
     MeterValuesInterface& meter_values;
@@ -52,9 +102,84 @@ private:
     std::optional<SetRunningCostCallback> set_running_cost_callback;
     boost::asio::io_context& io_context;
 
+    /// \brief Protects default_tariffs and transaction_tariffs, meter values are reported from other threads than
+    /// the messages of the CSMS
+    std::mutex tariffs_mutex;
+    /// \brief Default tariffs by EVSE id, tariffs on EVSE 0 apply to all EVSEs
+    std::map<std::int32_t, std::vector<Tariff>> default_tariffs;
+    /// \brief Tariffs of the running transactions by EVSE id
+    std::map<std::int32_t, TransactionTariff> transaction_tariffs;
+
+    /// \brief Cached cost settings, so processing a meter value does not read the device model
+    std::atomic_bool cost_enabled;
+    std::atomic<std::uint32_t> number_of_decimals;
+
+    /// \brief Latest meter value of an EVSE that was published by on_meter_value() and not processed yet
+    struct PublishedMeterValue {
+        LatestValueSlot<MeterValue> meter_value;
+        std::atomic_bool processing_scheduled{false};
+    };
+    /// \brief Published meter values by EVSE id, created in the constructor and not modified afterwards
+    std::map<std::int32_t, std::unique_ptr<PublishedMeterValue>> published_meter_values;
+
+    /// \brief State shared with the handlers that process the published meter values, so a handler that runs after
+    /// this object was destroyed does nothing
+    struct MeterValueProcessing {
+        std::mutex mutex;
+        bool stopped = false;
+    };
+    std::shared_ptr<MeterValueProcessing> meter_value_processing;
+
     // Functions
+    ///
+    /// \brief Add the latest published meter value of \p evse_id to the local cost calculation of its transaction.
+    ///
+    void process_meter_value(const std::int32_t evse_id);
+
     // Functional Block I: TariffAndCost
     void handle_costupdated_req(const Call<CostUpdatedRequest> call);
+    void handle_set_default_tariff_req(const Call<v21::SetDefaultTariffRequest> call);
+    void handle_get_tariffs_req(const Call<v21::GetTariffsRequest> call);
+    void handle_clear_tariffs_req(const Call<v21::ClearTariffsRequest> call);
+    void handle_change_transaction_tariff_req(const Call<v21::ChangeTransactionTariffRequest> call);
+
+    ///
+    /// \brief Check if \p tariff can be applied by the charging station.
+    /// \return Accepted or the reason why the tariff can not be applied.
+    ///
+    TariffSetStatusEnum validate_tariff(const Tariff& tariff) const;
+
+    ///
+    /// \brief Get the default tariff that applies to a transaction on \p evse_id that starts at \p timestamp. A tariff
+    /// set on the EVSE takes precedence over a tariff set on EVSE 0, of those the one with the latest validFrom that
+    /// is not in the future is selected.
+    ///
+    std::optional<Tariff> get_default_tariff(const std::int32_t evse_id, const DateTime& timestamp) const;
+
+    ///
+    /// \brief Create the running cost of a transaction of which the cost is calculated locally.
+    ///
+    RunningCost create_running_cost(const TransactionTariff& transaction_tariff, const RunningCostState state) const;
+
+    ///
+    /// \brief Call the running cost callback with \p running_cost.
+    ///
+    void report_running_cost(const RunningCost& running_cost, const std::optional<std::string>& currency);
+
+    ///
+    /// \brief Check if the EV is charging in the transaction on \p evse_id.
+    ///
+    bool is_charging(const std::int32_t evse_id);
+
+    ///
+    /// \brief Get the offset of the local time to UTC from ClockCtrlr.TimeOffset.
+    ///
+    std::chrono::minutes get_utc_offset() const;
+
+    ///
+    /// \brief Get the number of decimals the cost values are reported with.
+    ///
+    std::uint32_t get_number_of_decimals() const;
 
     ///
     /// \brief Check if multilanguage setting (variable) is enabled.
@@ -134,6 +134,12 @@ private:
     std::set<std::int32_t> reset_scheduled_evseids;
 
     // Functions
+    /// \brief Maximum size of the metervalues in a TransactionEvent(Ended) request, based on MaxMessageSize
+    std::size_t get_tx_ended_meter_values_max_bytes();
+    /// \brief Interval the TransactionEvent(Ended) metervalues are downsampled to first if they do not fit in the
+    /// request
+    std::chrono::seconds get_tx_ended_downsampling_interval();
+
     /* OCPP message handlers */
 
     // Functional Block E: Transaction
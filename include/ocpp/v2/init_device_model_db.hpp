@@ -130,6 +130,14 @@ private:
 std::map<ComponentKey, std::vector<DeviceModelVariable>>
 get_all_component_configs(const std::filesystem::path& directory);
 
+///
+/// \brief Calculate a fingerprint (SHA-256) over the contents of all component config files in the given directory.
+/// \param directory    The parent directory containing the standardized and custom component config files.
+/// \return The fingerprint as hex string, it changes when any of the component config files is added, removed, renamed
+///         or modified.
+///
+std::string get_component_config_fingerprint(const std::filesystem::path& directory);
+
 class InitDeviceModelDb : public common::DatabaseHandlerCommon {
 private: // Members
     /// \brief Database path of the device model database.
@@ -167,6 +175,21 @@ public:
     void initialize_database(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
                              const bool delete_db_if_exists);
 
+    ///
+    /// \brief Initialize the database schema and component config from the component config files in the given
+    ///        directory.
+    ///
+    /// The fingerprint of the component config files is stored in the database. If the database already contains the
+    /// same fingerprint, the component config files are not read and the database is not reconciled with them.
+    ///
+    /// \param config_path          The parent directory containing the standardized and custom component config files.
+    /// \param delete_db_if_exists  Set to true to delete the database if it already exists.
+    /// \return False if the component config was unchanged and the reconciliation was skipped, true otherwise.
+    ///
+    /// \throws The same exceptions as the overload taking the component configs.
+    ///
+    bool initialize_database(const std::filesystem::path& config_path, const bool delete_db_if_exists);
+
 private: // Functions
     ///
     /// \brief Initialize the database.
@@ -180,6 +203,28 @@ private: // Functions
     ///
     void execute_init_sql(const bool delete_db_if_exists);
 
+    ///
+    /// \brief Check the component config for integrity and insert, update or remove the components in the database
+    ///        accordingly. Must be called after execute_init_sql.
+    /// \param component_configs    A map with all components, variables, characteristics and attributes.
+    /// \param fingerprint          Fingerprint of the component config to store in the database, std::nullopt if the
+    ///                             fingerprint is unknown and any stored fingerprint must be removed.
+    ///
+    void apply_component_configs(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
+                                 const std::optional<std::string>& fingerprint);
+
+    ///
+    /// \brief Get the fingerprint of the component config the database was last initialized with.
+    /// \return The fingerprint or std::nullopt if there is none.
+    ///
+    std::optional<std::string> get_component_config_fingerprint_from_db();
+
+    ///
+    /// \brief Store the fingerprint of the component config in the database, or remove it when \p fingerprint is
+    ///        std::nullopt.
+    ///
+    void set_component_config_fingerprint_in_db(const std::optional<std::string>& fingerprint);
+
     ///
     /// \brief Get all paths to the component configs (*.json) in the given directory.
     /// \param directory    Parent directory holding the standardized and component config's.
@@ -399,10 +444,10 @@ private: // Functions
     std::vector<DbVariableAttribute> get_variable_attributes_from_db(const std::uint64_t& variable_id);
 
     ///
-    /// \brief Get monitors related to a variable from the DB
-    /// \param variable_id  The id of the variable to get the attributes from.
-    /// \return The monitors belonging to the given variables or an empty list
-    std::vector<VariableMonitoringMeta> get_variable_monitors_from_db(const std::uint64_t& variable_id);
+    /// \brief Get the monitors of all variables from the DB with a single query. Custom monitors are not included.
+    /// \return The monitors, mapped by the id of the variable they belong to.
+    ///
+    std::map<std::uint64_t, std::vector<VariableMonitoringMeta>> get_all_variable_monitors_from_db();
 
 protected: // Functions
     // DatabaseHandlerCommon interface
@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <mutex>
+#include <queue>
+#include <set>
 #include <unordered_map>
 
 #include <everest/timer.hpp>
+#include <ocpp/common/executor.hpp>
 
 #include <ocpp/v2/enums.hpp>
 #include <ocpp/v2/ocpp_enums.hpp>
@@ -16,6 +20,7 @@
 namespace ocpp::v2 {
 
 class DeviceModel;
+struct VariableChange;
 
 enum class UpdateMonitorMetaType {
     TRIGGER,
@@ -44,12 +49,29 @@ struct TriggerMetadata {
 };
 
 struct PeriodicMetadata {
-    /// \brief Last time this monitor was triggered
-    std::chrono::time_point<std::chrono::steady_clock> last_trigger_steady;
+    /// \brief Next time when this monitor is due. For clock aligned monitors this is the
+    /// next clock aligned point converted to the steady clock
+    std::chrono::time_point<std::chrono::steady_clock> next_trigger_steady;
+};
+
+/// \brief Entry of the periodic monitor schedule, ordered by the time it is due
+struct ScheduledPeriodicMonitor {
+    std::chrono::time_point<std::chrono::steady_clock> due;
+    std::int32_t monitor_id;
 
-    /// \brief Next time when we require to trigger a clock aligned value. Has meaning
-    /// only for periodic monitors
-    std::chrono::time_point<std::chrono::system_clock> next_trigger_clock_aligned;
+    bool operator>(const ScheduledPeriodicMonitor& other) const {
+        return due > other.due;
+    }
+};
+
+/// \brief Monitoring configuration cached from the device model, so that the processing
+/// of the monitors does not require any device model access
+struct MonitoringConfig {
+    bool enabled = false;
+    int offline_severity = MonitoringLevelSeverity::Warning;
+    int active_monitoring_level = MonitoringLevelSeverity::MAX;
+    MonitoringBaseEnum active_monitoring_base = MonitoringBaseEnum::All;
+    std::chrono::seconds processing_interval{1};
 };
 
 /// \brief Meta data required for our internal keeping needs
@@ -106,7 +128,9 @@ public:
     /// \param notify_csms_events Function that can be invoked with a number of alert events
     /// \param is_chargepoint_offline Function that can be invoked in order to retrieve the
     /// status of the charging station connection to the CSMS
-    MonitoringUpdater(DeviceModel& device_model, notify_events notify_csms_events, is_offline is_chargepoint_offline);
+    /// \param executor Executor that runs the monitors timer, the default executor if not provided
+    MonitoringUpdater(DeviceModel& device_model, notify_events notify_csms_events, is_offline is_chargepoint_offline,
+                      std::shared_ptr<Executor> executor = nullptr);
     ~MonitoringUpdater();
 
     /// \brief Starts monitoring the variables, kicking the timer
@@ -120,6 +144,15 @@ public:
     /// moment, for example in the case of an internal variable modification
     void process_triggered_monitors();
 
+    /// \brief Rebuilds the schedule of the periodic monitors from the device model. Must be
+    /// called after monitors have been set or cleared
+    void update_periodic_monitors();
+
+    /// \brief Re-reads the monitoring configuration (enabled state, active monitoring level and
+    /// base, offline severity) from the device model. Must be called after one of these
+    /// variables has been changed
+    void update_monitoring_config();
+
 private:
     /// \brief Callback that is registered to the 'device_model' that determines if any of
     /// the monitors are triggered for a certain variable when the internal value is used. Will
@@ -133,6 +166,10 @@ private:
                              const VariableCharacteristics& characteristics, const VariableAttribute& attribute,
                              const std::string& value_previous, const std::string& value_current);
 
+    /// \brief Callback that is registered to the 'device_model' for a batch of changed variables. Evaluates the
+    /// monitors of all \p changes like 'on_variable_changed' and reschedules the processing at most once
+    void on_variables_changed(const std::vector<VariableChange>& changes);
+
     /// \brief Callback that is registered to the 'device_model' that determines if any of
     /// the already existing monitors were updated. It is required for some spec requirements
     /// that must refresh monitor data in the case of a monitor update
@@ -147,28 +184,56 @@ private:
                           const VariableAttribute& attribute, const std::string& value_previous,
                           const std::string& value_current);
 
-    /// \brief Processes the periodic monitors. Since this can be somewhat of a costly
-    /// operation (DB query of each triggered monitor's actual value) the processing time
-    /// can be configured using the 'VariableMonitoringProcessTime' internal variable. If
-    // there are also any pending alert triggered monitors, those will be processed too
+    /// \brief Callback of the 'monitors_timer'. Processes the periodic monitors that are due
+    /// and reschedules the timer to the next due periodic monitor
+    void on_monitors_timer();
+
+    /// \brief Processes the periodic monitors that are due and, if there are also any
+    /// pending alert triggered monitors, those will be processed too. Only the periodic
+    /// monitors that are due are visited, the others do not cost any processing time
     void process_monitors_internal(bool allow_periodics, bool allow_trigger);
 
+    /// \brief Determines based on the cached monitoring configuration if the monitor meta
+    /// should be processed at all
+    bool should_process_monitor_meta_internal(const UpdaterMonitorMeta& updater_meta_data, bool is_offline) const;
+
+    /// \brief Processes the alert triggered monitors, adding the events that can be sent to \p outgoing_events
+    void process_triggered_monitors_internal(bool is_offline, std::vector<EventData>& outgoing_events);
+
+    /// \brief Moves the events generated by this meta to \p outgoing_events, to be sent to the CSMS together with
+    /// the events of the other monitors processed in the same pass, and updates the trigger state
+    void send_generated_events_internal(UpdaterMonitorMeta& updater_meta_data, std::vector<EventData>& outgoing_events);
+
     /// \brief Processes the monitor meta, generating in it's internal list all the
     /// required events. It will generate the EventData for a notify regardless
-    /// of the offline state
+    /// of the offline state. Periodic monitors must only be passed when they are due
     void process_monitor_meta_internal(UpdaterMonitorMeta& updater_meta_data);
 
     /// \brief Query the database (from in-memory data for fast retrieval)
     /// and updates our internal monitors with the new database data
     void update_periodic_monitors_internal();
 
-    void get_monitoring_info(bool& out_is_offline, int& out_offline_severity, int& out_active_monitoring_level,
-                             MonitoringBaseEnum& out_active_monitoring_base);
+    /// \brief Calculates the next due time of the given periodic monitor and adds it to the schedule
+    void schedule_periodic_monitor(UpdaterMonitorMeta& periodic_meta);
+
+    /// \brief Starts the 'monitors_timer' so that it fires when the next periodic monitor is due,
+    /// or after the processing interval if there are pending triggers or cached events
+    void schedule_next_processing();
 
-    bool is_monitoring_enabled();
+    /// \brief If there are trigger monitors with events that were not yet generated or sent
+    bool has_pending_triggers_internal() const;
+
+    void update_monitoring_config_internal();
 
     DeviceModel& device_model;
+    std::shared_ptr<Executor> executor;
     Everest::SteadyTimer monitors_timer;
+    /// \brief Protects the monitor metas and the schedule which are accessed from the timer and
+    /// the device model listeners. Recursive since the device model listeners can be invoked
+    /// while the monitors are processed
+    std::recursive_mutex monitors_mutex;
+    bool is_started;
+    MonitoringConfig monitoring_config;
 
     // Charger to CSMS message unique ID for EventData
     std::int32_t unique_id;
@@ -176,7 +241,20 @@ private:
     notify_events notify_csms_events;
     is_offline is_chargepoint_offline;
 
+    /// \brief Monitors that are currently in a triggered state or were cleared but not yet reported
     std::unordered_map<std::int32_t, UpdaterMonitorMeta> updater_monitors_meta;
+
+    /// \brief All active periodic and clock aligned monitors
+    std::unordered_map<std::int32_t, UpdaterMonitorMeta> periodic_monitors_meta;
+
+    /// \brief Min-heap of the periodic monitors ordered by the time they are due. Entries of
+    /// monitors that were removed or rescheduled are skipped when they reach the top
+    std::priority_queue<ScheduledPeriodicMonitor, std::vector<ScheduledPeriodicMonitor>,
+                        std::greater<ScheduledPeriodicMonitor>>
+        periodic_schedule;
+
+    /// \brief Periodic monitors that have generated events that could not be sent yet
+    std::set<std::int32_t> periodic_monitors_with_pending_events;
 };
 
 } // namespace ocpp::v2
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <ocpp/v2/messages/NotifyEvent.hpp>
+#include <ocpp/v2/types.hpp>
+
+namespace ocpp::v2 {
+
+/// \brief Collects the EventData of monitor events that are generated in bursts and pages it into as few
+/// NotifyEventRequest messages as possible, using tbc and seqNo to mark the requests that belong together
+class NotifyEventBatcher {
+public:
+    /// \brief Creates a new batcher
+    /// \param max_items_per_message Maximum number of EventData items per NotifyEventRequest, 0 for no limit
+    /// \param max_bytes_per_message Maximum size of the serialized Call<NotifyEventRequest>, 0 for no limit
+    NotifyEventBatcher(std::size_t max_items_per_message, std::size_t max_bytes_per_message);
+
+    /// \brief Updates the limits that are used for the next requests
+    void set_limits(std::size_t max_items_per_message, std::size_t max_bytes_per_message);
+
+    /// \brief Adds \p events to the pending events
+    /// \returns true if at least one full message worth of events is pending
+    bool add(const std::vector<EventData>& events);
+
+    /// \returns true if there are no pending events
+    bool empty() const;
+
+    /// \brief Takes all the pending events and pages them into NotifyEventRequests. All requests share the
+    /// same generatedAt, seqNo starts at 0 and tbc is set on all but the last request
+    std::vector<NotifyEventRequest> take_requests();
+
+private:
+    std::size_t max_items_per_message;
+    std::size_t max_bytes_per_message;
+
+    std::vector<EventData> pending_events;
+    /// \brief Serialized size of each pending event, so that every event is only serialized once
+    std::vector<std::size_t> pending_event_sizes;
+    // cppcheck-suppress unusedStructMember
+    std::size_t pending_bytes;
+
+    /// \brief Size of a serialized Call<NotifyEventRequest> without any EventData
+    static std::size_t get_skeleton_size(const DateTime& generated_at, std::int32_t seq_no);
+};
+
+} // namespace ocpp::v2
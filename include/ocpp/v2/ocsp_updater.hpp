@@ -6,6 +6,7 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
@@ -46,11 +47,17 @@ public:
     virtual ~OcspUpdaterInterface() = default;
     virtual void start() = 0;
     virtual void stop() = 0;
-    // Wake up the updater thread and tell it to update
+    // Wake up the updater thread and tell it to update the certificates that are due or not known yet
     // Used e.g. when a new charging station cert was just installed
     virtual void trigger_ocsp_cache_update() = 0;
 };
 
+// Keeps the OCSP cache of the V2G certificates up to date. Every certificate is scheduled on its own: its status is
+// requested again halfway between the time it was received and the nextUpdate of the OCSP response, but at least every
+// ocsp_cache_update_interval. A certificate whose status could not be updated is retried after
+// ocsp_cache_update_retry_interval without affecting the other certificates, and every status is written to the cache
+// as soon as it is received.
+
 class OcspUpdater : public OcspUpdaterInterface {
 public:
     OcspUpdater() = delete;
@@ -74,8 +81,12 @@ private:
     std::mutex update_ocsp_cache_lock;
     // Condition variable used to wake up the updater thread
     std::condition_variable explicit_update_trigger;
-    // Deadline by which libocpp must automatically trigger an OCSP cache update
+    // Deadline by which libocpp must automatically trigger an OCSP cache update, the earliest certificate deadline
     std::chrono::time_point<std::chrono::steady_clock> update_deadline;
+    // Deadline by which the OCSP status of a certificate must be updated, by the hash data of the certificate
+    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>> certificate_update_deadlines;
+    // Set after the deadlines were derived from the cached OCSP responses on the first update
+    bool certificate_update_deadlines_seeded;
     std::shared_ptr<EvseSecurity> evse_security;
     // Set this when starting and stopping the updater thread
     bool running;
@@ -90,8 +101,15 @@ private:
 
     // Running loop of the OCSP updater thread
     void updater_thread_loop();
-    // Helper method, only called within updater_thread_loop().
+    // Helper method, only called within updater_thread_loop(). Updates the certificates that are due and sets the
+    // update_deadline
     void execute_ocsp_update();
+    // Requests the OCSP status of the certificate of ocsp_request from the CSMS and returns the OCSP result
+    std::string request_ocsp_status(const ocpp::OCSPRequestData& ocsp_request);
+    // Returns the update deadlines of the certificates whose OCSP response is cached, by the key of the certificate
+    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>> get_cached_certificate_update_deadlines();
+    // Returns the deadline of the next update of a certificate that just received ocsp_result
+    std::chrono::time_point<std::chrono::steady_clock> get_certificate_update_deadline(const std::string& ocsp_result);
 };
 
 } // namespace ocpp::v2
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ocpp/common/types.hpp>
+#include <ocpp/v2/ocpp_enums.hpp>
+#include <ocpp/v2/ocpp_types.hpp>
+
+namespace ocpp::v2 {
+
+/// \brief Cost of a transaction, excluding and including taxes
+struct TariffCost {
+    double excl_tax = 0.0;
+    double incl_tax = 0.0;
+};
+
+/// \brief State of a transaction at a point in time, as used by the TariffCalculator
+struct TariffMeterSample {
+    DateTime timestamp;
+    /// \brief Energy.Active.Import.Register in Wh
+    std::optional<double> energy_wh;
+    /// \brief Power.Active.Import in W
+    std::optional<double> power_w;
+    /// \brief Current.Import in A, the highest phase if only phase values are available
+    std::optional<double> current_a;
+    /// \brief True if the EV is charging, false if it is connected but idle
+    bool charging = true;
+};
+
+/// \brief Creates a TariffMeterSample from the measurands of \p meter_value. Units and multipliers are taken into
+/// account
+TariffMeterSample create_tariff_meter_sample(const MeterValue& meter_value, bool charging);
+
+/// \brief Parses a ClockCtrlr TimeOffset like "+01:00" or "-05:30"
+/// \returns the offset to UTC, 0 if \p time_offset can not be parsed
+std::chrono::minutes parse_time_offset(const std::string& time_offset);
+
+/// \brief Checks if the charging station can evaluate all elements and conditions of \p tariff
+/// \returns false if the tariff uses conditions that can not be evaluated locally (payment brand and recognition)
+bool is_tariff_supported(const Tariff& tariff);
+
+/// \returns the number of price elements of \p tariff, as limited by TariffCostCtrlr.MaxElements[Tariff]
+std::size_t get_number_of_tariff_elements(const Tariff& tariff);
+
+/// \brief Calculates the running cost of a transaction locally from a Tariff, without a round trip to the CSMS.
+///
+/// The cost is accumulated incrementally: every call to update() only adds the cost of the period since the previous
+/// sample, so the effort per meter value does not depend on the duration of the transaction. The conditions of the
+/// tariff are parsed once when the tariff is set. Energy, charging time and idle time are priced with the first price
+/// element whose conditions match at the beginning of a period. The fixed fee is applied once, when the transaction
+/// starts. The total is limited by minCost and maxCost.
+///
+/// Reservation fees are not part of the transaction cost and are ignored. The evseKind condition is ignored if the kind
+/// of the EVSE is not known.
+class TariffCalculator {
+public:
+    /// \param tariff Tariff to apply
+    /// \param start First sample of the transaction
+    /// \param utc_offset Offset of the local time to UTC, used for the time of day, day of week and date conditions
+    /// \param evse_kind Kind of the EVSE, if known
+    TariffCalculator(const Tariff& tariff, const TariffMeterSample& start,
+                     std::chrono::minutes utc_offset = std::chrono::minutes(0),
+                     std::optional<EvseKindEnum> evse_kind = std::nullopt);
+
+    /// \brief Replaces the tariff, e.g. after a ChangeTransactionTariff. The cost accumulated so far is kept, the new
+    /// tariff applies from the last sample on. The fixed fee is not charged again
+    void set_tariff(const Tariff& tariff);
+    const Tariff& get_tariff() const;
+
+    /// \brief Adds the cost of the period between the previous sample and \p sample. Samples that are older than the
+    /// previous sample are ignored
+    void update(const TariffMeterSample& sample);
+
+    /// \returns the cost of the transaction so far, limited by minCost and maxCost of the tariff
+    TariffCost get_cost() const;
+
+    /// \returns the prices that apply at the last sample, for displaying them
+    RunningCostChargingPrice get_current_charging_price() const;
+    RunningCostIdlePrice get_current_idle_price() const;
+
+    /// \returns the last sample that was passed to the calculator
+    const TariffMeterSample& get_last_sample() const;
+
+private:
+    struct Conditions {
+        std::optional<std::int32_t> start_minute_of_day;
+        std::optional<std::int32_t> end_minute_of_day;
+        /// \brief Bit per day of the week, Monday is bit 0. 0 if all days match
+        std::uint8_t days_of_week = 0;
+        std::optional<date::sys_days> valid_from_date;
+        std::optional<date::sys_days> valid_to_date;
+        std::optional<EvseKindEnum> evse_kind;
+        std::optional<float> min_energy;
+        std::optional<float> max_energy;
+        std::optional<float> min_current;
+        std::optional<float> max_current;
+        std::optional<float> min_power;
+        std::optional<float> max_power;
+        std::optional<std::int32_t> min_time;
+        std::optional<std::int32_t> max_time;
+        std::optional<std::int32_t> min_charging_time;
+        std::optional<std::int32_t> max_charging_time;
+        std::optional<std::int32_t> min_idle_time;
+        std::optional<std::int32_t> max_idle_time;
+    };
+
+    struct PriceElement {
+        /// \brief Price per kWh, minute or the fixed price
+        double price;
+        Conditions conditions;
+    };
+
+    struct PriceComponent {
+        std::vector<PriceElement> elements;
+        /// \brief Factor to get the price including taxes
+        double tax_factor = 1.0;
+    };
+
+    /// \brief State the conditions are checked against
+    struct ConditionState {
+        date::sys_seconds local_time;
+        double energy_wh;
+        std::optional<double> power_w;
+        std::optional<double> current_a;
+        double duration_s;
+        double charging_time_s;
+        double idle_time_s;
+    };
+
+    Tariff tariff;
+    std::chrono::minutes utc_offset;
+    std::optional<EvseKindEnum> evse_kind;
+
+    PriceComponent energy;
+    PriceComponent charging_time;
+    PriceComponent idle_time;
+    PriceComponent fixed_fee;
+
+    TariffMeterSample start;
+    TariffMeterSample last_sample;
+    /// \brief Fractional seconds, so that meter values that are less than a second apart are not lost
+    double charging_time_s;
+    double idle_time_s;
+
+    TariffCost energy_cost;
+    TariffCost time_cost;
+    TariffCost fixed_cost;
+
+    void compile(const Tariff& tariff);
+    ConditionState get_condition_state(const TariffMeterSample& sample) const;
+    bool matches(const Conditions& conditions, const ConditionState& state) const;
+    const PriceElement* find_price(const PriceComponent& component, const ConditionState& state) const;
+    void add_cost(TariffCost& cost, const PriceComponent& component, double amount);
+
+    static Conditions to_conditions(const std::optional<TariffConditions>& conditions);
+    static Conditions to_conditions(const std::optional<TariffConditionsFixed>& conditions);
+    static double get_tax_factor(const std::optional<std::vector<TaxRate>>& tax_rates);
+};
+
+} // namespace ocpp::v2
@@ -4,6 +4,7 @@
 #define OCPP_V2_TRANSACTION_HANDLER_HPP
 
 #include <ocpp/common/aligned_timer.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 
 namespace ocpp {
@@ -14,8 +15,16 @@ class DatabaseHandler;
 
 /// \brief Struct that enhances the OCPP Transaction by some meta data and functionality
 struct EnhancedTransaction : public Transaction {
-    explicit EnhancedTransaction(DatabaseHandler& database_handler, bool database_enabled) :
-        database_handler{database_handler}, database_enabled{database_enabled} {
+    /// \param io_context runs the meter value timers of the transaction, the io context of the default executor if
+    /// nullptr
+    explicit EnhancedTransaction(DatabaseHandler& database_handler, bool database_enabled,
+                                 boost::asio::io_context* io_context = nullptr) :
+        sampled_tx_updated_meter_values_timer{get_io_context(io_context)},
+        sampled_tx_ended_meter_values_timer{get_io_context(io_context)},
+        aligned_tx_updated_meter_values_timer{get_io_context(io_context)},
+        aligned_tx_ended_meter_values_timer{get_io_context(io_context)},
+        database_handler{database_handler},
+        database_enabled{database_enabled} {
     }
 
     bool id_token_sent = false;
@@ -44,6 +53,10 @@ struct EnhancedTransaction : public Transaction {
     void set_id_token_sent();
 
 private:
+    static boost::asio::io_context* get_io_context(boost::asio::io_context* io_context) {
+        return io_context != nullptr ? io_context : &Executor::get_default()->get_io_context();
+    }
+
     DatabaseHandler& database_handler;
     bool database_enabled;
 };
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <ocpp/v2/ocpp_types.hpp>
+
+namespace ocpp::v2 {
+
+/// \brief Collects the meter values of a TransactionEvent(Ended) request while they are read from the database. If
+/// the serialized meter values exceed the size limit, the periodic and clock aligned meter values are downsampled:
+/// only the first meter value in each interval aligned to the epoch is kept, so register readings remain at aligned
+/// intervals. The interval is doubled until the meter values fit. The begin, end and interruption readings are always
+/// kept
+class TxEndedMeterValues {
+public:
+    /// \brief Creates a new collector
+    /// \param max_bytes Maximum size of the serialized meterValue array, 0 for no limit
+    /// \param initial_interval Interval that is used for downsampling when \p max_bytes is exceeded the first time
+    TxEndedMeterValues(std::size_t max_bytes, std::chrono::seconds initial_interval);
+
+    /// \brief Adds \p meter_value, which must be newer than all meter values that were added before
+    void add(MeterValue&& meter_value);
+
+    /// \brief Takes all collected meter values
+    std::vector<MeterValue> take();
+
+    /// \returns the interval the periodic and clock aligned meter values are downsampled to, 0 if all are kept
+    std::chrono::seconds get_interval() const;
+
+private:
+    struct Entry {
+        MeterValue meter_value;
+        std::size_t size;
+        bool is_sample;
+    };
+
+    std::size_t max_bytes;
+    std::chrono::seconds initial_interval;
+    std::chrono::seconds interval;
+
+    std::vector<Entry> entries;
+    std::size_t total_bytes;
+    /// \brief Interval number of the last sample that was kept
+    std::optional<std::int64_t> last_sample_interval;
+
+    std::int64_t get_interval_number(const MeterValue& meter_value) const;
+    /// \brief Doubles the interval and removes the samples that do not fit the new interval
+    void downsample();
+};
+
+} // namespace ocpp::v2
@@ -5,8 +5,10 @@
 
 #include <ocpp/v2/ocpp_types.hpp>
 
+#include <functional>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace ocpp {
 namespace v2 {
@@ -179,6 +181,8 @@ enum class MessageType {
     OpenPeriodicEventStreamResponse,
     PullDynamicScheduleUpdate,
     PullDynamicScheduleUpdateResponse,
+    ReportDERControl,
+    ReportDERControlResponse,
     RequestBatterySwap,
     RequestBatterySwapResponse,
     SetDefaultTariff,
@@ -206,6 +210,23 @@ struct ReportedChargingProfile {
     }
 };
 
+/// \brief Called with the composite schedules of the evses whose effective limit changed
+using LimitsChangedCallback = std::function<void(const std::vector<CompositeSchedule>& composite_schedules)>;
+
+/// \brief Result of an active DER curve for the meter values of an EVSE
+struct DERCurveOutput {
+    DERControlEnum control_type;
+    CiString<36> control_id;
+    /// \brief y of the curve at the measured value
+    float value;
+    DERUnitEnum unit;
+};
+
+/// \brief Callback with the results of the active volt-var, volt-watt, freq-watt, watt-var and watt-pf curves after a
+/// meter value of \p evse_id was evaluated
+using DERCurveOutputCallback =
+    std::function<void(const std::int32_t evse_id, const std::vector<DERCurveOutput>& outputs)>;
+
 namespace conversions {
 /// \brief Converts the given MessageType \p m to std::string
 /// \returns a string representation of the MessageType
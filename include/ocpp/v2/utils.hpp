@@ -28,6 +28,16 @@ MeterValue get_meter_value_with_measurands_applied(const MeterValue& _meter_valu
                                                    const std::vector<MeasurandEnum>& measurands,
                                                    bool include_signed = true);
 
+/// \brief Applies the given measurands to a single \p meter_value based on its ReadingContext, like
+/// get_meter_values_with_measurands_applied does for all meter values of a transaction
+/// \retval the filtered meter value or std::nullopt if it is not part of the TxEnded meter values
+std::optional<MeterValue> get_tx_ended_meter_value(const MeterValue& meter_value,
+                                                   const std::vector<MeasurandEnum>& sampled_tx_ended_measurands,
+                                                   const std::vector<MeasurandEnum>& aligned_tx_ended_measurands,
+                                                   const ocpp::DateTime& max_timestamp,
+                                                   bool include_sampled_signed = true,
+                                                   bool include_aligned_signed = true);
+
 /// \brief Applies the given measurands to \p meter_values based on their ReadingContext.
 /// Transaction_Begin, Interruption_Begin, Transaction_End, Interruption_End and Sample_Periodic will be filtered using
 /// \p sampled_tx_ended_measurands.
@@ -3,11 +3,20 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <everest/timer.hpp>
+
 #include <ocpp/v2/evse_manager.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v2/functional_blocks/smart_charging.hpp>
 #include <ocpp/v2/message_handler.hpp>
 #include <ocpp/v2/types.hpp>
 
+#include <ocpp/v21/messages/AFRRSignal.hpp>
 #include <ocpp/v21/messages/NotifyAllowedEnergyTransfer.hpp>
 
 namespace ocpp::v2 {
@@ -16,27 +25,106 @@ using NotifyAllowedEnergyTransferCallback =
     std::function<bool(const std::vector<ocpp::v2::EnergyTransferModeEnum> allowed_energy_transfer_modes,
                        const CiString<36> transaction_id)>;
 
+/// \brief Callback to apply the power setpoint of an EVSE that results from an aFRR signal. The \p setpoint is in W,
+/// positive values charge and negative values discharge the EV
+using AfrrSignalCallback = std::function<void(const std::int32_t evse_id, const float setpoint)>;
+
+/// \brief Looks up \p signal in the v2xSignalWattCurve \p curve. Between two points the power is interpolated linearly,
+/// outside of the curve the power of the first or last point is used.
+/// \param curve Points of the curve, sorted by signal
+/// \returns the power in W, 0 if the curve is empty
+float get_v2x_signal_power(const std::vector<V2XSignalWattPoint>& curve, const std::int32_t signal);
+
 class BidirectionalInterface : public MessageHandlerInterface {
 public:
     ~BidirectionalInterface() override = default;
+
+    /// \brief Rebuilds the aFRR curves of all EVSEs from the stored charging profiles. Must be called when charging
+    /// profiles are added or removed and when a transaction starts or stops
+    virtual void on_charging_profiles_changed() = 0;
+
+    /// \returns the time between the reception of the last AFRRSignalRequest and the return of the aFRR callback
+    virtual std::optional<std::chrono::microseconds> get_last_afrr_signal_latency() const = 0;
 };
 
 class Bidirectional : public BidirectionalInterface {
 private: // Members
     const FunctionalBlockContext& context;
+    /// \brief Calculates the composite limits the aFRR setpoints are clamped to, nullptr if smart charging is not
+    /// available
+    SmartChargingInterface* smart_charging;
 
     std::optional<NotifyAllowedEnergyTransferCallback> notify_allowed_energy_transfer_callback;
+    std::optional<AfrrSignalCallback> afrr_signal_callback;
+
+    /// \brief Schedule period of a profile that can provide an aFRR setpoint at its absolute time
+    struct AfrrCurvePeriod {
+        DateTime start;
+        DateTime end;
+        /// \brief v2xBaseline of the period in W, the power of the curve is added to it
+        float baseline;
+        /// \brief Points of the curve, sorted by signal. std::nullopt if the period has no v2xSignalWattCurve, it then
+        /// still takes precedence over the periods of lower ranked profiles
+        std::optional<std::vector<V2XSignalWattPoint>> curve;
+    };
+
+    /// \brief Period of the composite schedule of an EVSE at its absolute time
+    struct AfrrLimitPeriod {
+        DateTime start;
+        /// \brief Maximum charging power in W
+        float limit;
+        /// \brief Maximum discharging power in W as a negative value, std::nullopt if discharging is not limited
+        std::optional<float> discharge_limit;
+    };
+
+    /// \brief Protects the aFRR curves, the pending signals and the latency
+    mutable std::mutex afrr_mutex;
+    /// \brief Curve periods per EVSE, the period that takes precedence comes first
+    std::map<std::int32_t, std::vector<AfrrCurvePeriod>> afrr_curves;
+    /// \brief Composite schedule periods per EVSE, sorted by start. EVSEs without an entry are not limited
+    std::map<std::int32_t, std::vector<AfrrLimitPeriod>> afrr_limits;
+    /// \brief The curves are calculated up to this time and have to be recalculated afterwards
+    std::optional<DateTime> afrr_curves_valid_until;
+    std::optional<std::chrono::microseconds> last_afrr_signal_latency;
+    /// \brief Signals with a timestamp in the future, by timestamp. They are applied by afrr_signal_timer
+    std::multimap<DateTime, std::int32_t> pending_afrr_signals;
+    Everest::SystemTimer afrr_signal_timer;
 
 public:
-    explicit Bidirectional(const FunctionalBlockContext& context,
-                           std::optional<NotifyAllowedEnergyTransferCallback> notify_allowed_energy_transfer_callback);
+    explicit Bidirectional(const FunctionalBlockContext& context, SmartChargingInterface* smart_charging,
+                           std::optional<NotifyAllowedEnergyTransferCallback> notify_allowed_energy_transfer_callback,
+                           std::optional<AfrrSignalCallback> afrr_signal_callback = std::nullopt);
     ~Bidirectional() override;
 
     void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
+    void on_charging_profiles_changed() override;
+    std::optional<std::chrono::microseconds> get_last_afrr_signal_latency() const override;
 
 private: // Functions
     void
     handle_notify_allowed_energy_transfer(Call<v21::NotifyAllowedEnergyTransferRequest> notify_allowed_energy_transfer);
+    void handle_afrr_signal(Call<v21::AFRRSignalRequest> call,
+                            const std::chrono::steady_clock::time_point& received_at);
+
+    /// \brief Calculates the aFRR curves of all EVSEs from \p now on. afrr_mutex must be locked
+    void load_afrr_curves(const DateTime& now);
+
+    /// \brief Calculates the composite limits of all EVSEs from \p now until \p end. afrr_mutex must be locked
+    void load_afrr_limits(const DateTime& now, const DateTime& end);
+
+    /// \returns \p setpoint of \p evse_id clamped to the composite limits at \p time. afrr_mutex must be locked
+    float clamp_afrr_setpoint(const std::int32_t evse_id, const DateTime& time, const float setpoint) const;
+
+    /// \returns the setpoint per EVSE that results from \p signal with the curves that are active at \p signal_time,
+    /// clamped to the composite limits at that time. afrr_mutex must be locked
+    std::vector<std::pair<std::int32_t, float>> get_afrr_setpoints(const DateTime& signal_time,
+                                                                   const std::int32_t signal);
+
+    /// \brief Applies the latest pending signal whose timestamp is reached and arms afrr_signal_timer for the next one
+    void apply_pending_afrr_signals();
+
+    /// \brief Arms afrr_signal_timer for the first pending signal. afrr_mutex must be locked
+    void schedule_pending_afrr_signals();
 };
 
 } // namespace ocpp::v2
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/io_context.hpp>
+
+#include <ocpp/common/latest_value_slot.hpp>
+#include <ocpp/v2/database_handler.hpp>
+#include <ocpp/v2/der_curve_evaluator.hpp>
+#include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v2/message_handler.hpp>
+#include <ocpp/v2/types.hpp>
+
+#include <ocpp/v21/messages/ClearDERControl.hpp>
+#include <ocpp/v21/messages/GetDERControl.hpp>
+#include <ocpp/v21/messages/NotifyDERAlarm.hpp>
+#include <ocpp/v21/messages/SetDERControl.hpp>
+
+namespace ocpp::v2 {
+
+class DERControlInterface : public MessageHandlerInterface {
+public:
+    ~DERControlInterface() override = default;
+
+    /// \brief Evaluates the active DER curves against the voltage, frequency and active power of \p meter_value.
+    /// Sends a NotifyDERAlarm when a trip curve is crossed and when the measured value returns into its range. The
+    /// evaluation runs on the io_context, so the caller never waits for it
+    virtual void on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) = 0;
+};
+
+/// \brief Handles SetDERControl, GetDERControl and ClearDERControl of OCPP 2.1.
+///
+/// Controls are persisted in the DER_CONTROLS table. Per control type the scheduled control with the highest priority
+/// whose time window contains the current time is active, the default control of the type otherwise. The curves of the
+/// active controls are compiled into one DERCurveEvaluator, which is only rebuilt when a control changes or a time
+/// window starts or ends, so the work per meter value is a single batch evaluation of all active curves.
+///
+/// Meter values are only published by on_meter_value() and evaluated on the io_context. If the io_context is busy, the
+/// meter values of an EVSE that were published meanwhile are replaced by the latest one.
+///
+/// Voltage curves use the voltage in percent of SmartChargingCtrlr.SupplyVoltage, frequency curves use Hz and watt
+/// curves use the active power in percent of the maxLimit of the Power variable of the EVSE. Trip curves (e.g.
+/// HVMustTrip) map the duration of an excursion in seconds to the threshold of the measured value.
+class DERControl : public DERControlInterface {
+private: // Members
+    /// \brief Quantity a curve is evaluated against
+    enum class DERQuantity {
+        Voltage,
+        Frequency,
+        ActivePower,
+    };
+
+    /// \brief Curve of an active control, in the order of the curves of the evaluator
+    struct ActiveCurve {
+        DERControlEnum control_type;
+        CiString<36> control_id;
+        DERUnitEnum unit;
+        DERQuantity quantity;
+        bool is_trip_curve;
+        /// \brief Trip curves only: true if the quantity must stay below the threshold, false if it must stay above
+        bool is_upper_limit;
+        /// \brief Trip curves only: least strict threshold of the curve, an excursion starts when it is crossed
+        float excursion_limit;
+        /// \brief Trip curves only: fault that is reported in the NotifyDERAlarm
+        std::optional<GridEventFaultEnum> grid_event_fault;
+    };
+
+    /// \brief State of a trip curve on an EVSE
+    struct TripState {
+        CiString<36> control_id;
+        std::optional<GridEventFaultEnum> grid_event_fault;
+        std::optional<DateTime> excursion_start;
+        bool alarm = false;
+    };
+
+    const FunctionalBlockContext& context;
+    boost::asio::io_context& io_context;
+    std::optional<DERCurveOutputCallback> der_curve_output_callback;
+    /// \brief Reference voltage of the voltage curves in V
+    float nominal_voltage;
+
+    /// \brief Protects all members below
+    std::mutex der_mutex;
+    std::vector<StoredDERControl> controls;
+    std::vector<ActiveCurve> active_curves;
+    DERCurveEvaluator evaluator;
+    /// \brief The active curves have to be recalculated at this time because a time window starts or ends
+    std::optional<DateTime> active_curves_valid_until;
+    bool active_curves_dirty;
+    std::map<std::int32_t, std::map<DERControlEnum, TripState>> trip_states;
+    /// \brief Rated power per EVSE in W, read from the device model on first use
+    std::map<std::int32_t, std::optional<float>> rated_power;
+    std::vector<float> curve_inputs;
+    std::vector<float> curve_outputs;
+
+    /// \brief Latest meter value of an EVSE that was published by on_meter_value() and not evaluated yet
+    struct PublishedMeterValue {
+        LatestValueSlot<MeterValue> meter_value;
+        std::atomic_bool processing_scheduled{false};
+    };
+    /// \brief Published meter values by EVSE id, created in the constructor and not modified afterwards
+    std::map<std::int32_t, std::unique_ptr<PublishedMeterValue>> published_meter_values;
+
+    /// \brief State shared with the handlers that evaluate the published meter values, so a handler that runs after
+    /// this object was destroyed does nothing
+    struct MeterValueProcessing {
+        std::mutex mutex;
+        bool stopped = false;
+    };
+    std::shared_ptr<MeterValueProcessing> meter_value_processing;
+
+public:
+    DERControl(const FunctionalBlockContext& context, boost::asio::io_context& io_context,
+               std::optional<DERCurveOutputCallback> der_curve_output_callback = std::nullopt);
+    ~DERControl() override;
+
+    void handle_message(const ocpp::EnhancedMessage<MessageType>& message) override;
+    void on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) override;
+
+private: // Functions
+    /// \brief Evaluates the latest published meter value of \p evse_id
+    void process_meter_value(const std::int32_t evse_id);
+    /// \brief Evaluates the active curves against \p meter_value of \p evse_id
+    void evaluate_meter_value(const std::int32_t evse_id, const MeterValue& meter_value);
+
+    void handle_set_der_control_req(Call<v21::SetDERControlRequest> call);
+    void handle_get_der_control_req(Call<v21::GetDERControlRequest> call);
+    void handle_clear_der_control_req(Call<v21::ClearDERControlRequest> call);
+
+    /// \brief Sends a ReportDERControl with \p controls for \p request_id
+    void report_der_controls(const std::int32_t request_id, const std::vector<StoredDERControl>& controls);
+
+    /// \brief Derives the supersession of the controls from the stored controls. A scheduled control is superseded by
+    /// a scheduled control of its type that has not ended at \p now and has a higher priority, or the same priority
+    /// and was set later. Changed controls are persisted. der_mutex must be locked
+    /// \returns the ids of the controls that became superseded
+    std::vector<CiString<36>> update_superseded(const DateTime& now);
+
+    /// \brief Compiles the curves of the controls that are active at \p now. der_mutex must be locked
+    /// \returns the alarms of trip curves that are no longer active and have to be ended
+    std::vector<v21::NotifyDERAlarmRequest> load_active_curves(const DateTime& now);
+
+    /// \returns the curve of \p control if the control has a curve that can be evaluated against meter values
+    static std::optional<ActiveCurve> create_active_curve(const v21::SetDERControlRequest& control);
+
+    /// \returns the rated power of \p evse_id in W. der_mutex must be locked
+    std::optional<float> get_rated_power(const std::int32_t evse_id);
+};
+
+} // namespace ocpp::v2
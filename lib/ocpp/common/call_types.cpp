@@ -3,18 +3,62 @@
 
 #include <ocpp/common/call_types.hpp>
 
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
+#include <array>
+#include <cstdint>
+#include <random>
 
 namespace ocpp {
 
+namespace {
+// Length of a textual UUID: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+constexpr std::size_t UUID_STRING_LENGTH = 36;
+
+std::mt19937_64& get_thread_random_generator() {
+    thread_local std::mt19937_64 generator{[]() {
+        std::random_device random_device;
+        std::seed_seq seed{random_device(), random_device(), random_device(), random_device(),
+                           random_device(), random_device(), random_device(), random_device()};
+        return std::mt19937_64{seed};
+    }()};
+    return generator;
+}
+} // namespace
+
+MessageId MessageId::from_trusted(std::string&& data) {
+    MessageId message_id;
+    message_id.set_unchecked(std::move(data));
+    return message_id;
+}
+
 MessageId create_message_id() {
-    static boost::uuids::random_generator uuid_generator;
-    const boost::uuids::uuid uuid = uuid_generator();
-    std::stringstream s;
-    s << uuid;
-    return MessageId(s.str());
+    static constexpr std::array<char, 16> hex_digits = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                                        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+    auto& generator = get_thread_random_generator();
+    std::array<std::uint8_t, 16> bytes{};
+    for (std::size_t i = 0; i < bytes.size(); i += 8) {
+        auto random = generator();
+        for (std::size_t j = 0; j < 8; ++j) {
+            bytes[i + j] = static_cast<std::uint8_t>(random & 0xff);
+            random >>= 8;
+        }
+    }
+
+    // RFC 4122: version 4 (random) and variant 1
+    bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0f) | 0x40);
+    bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3f) | 0x80);
+
+    std::string uuid(UUID_STRING_LENGTH, '-');
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        if (i == 4 or i == 6 or i == 8 or i == 10) {
+            ++pos; // Keep the dash
+        }
+        uuid[pos++] = hex_digits[bytes[i] >> 4];
+        uuid[pos++] = hex_digits[bytes[i] & 0x0f];
+    }
+
+    return MessageId::from_trusted(std::move(uuid));
 }
 
 bool operator<(const MessageId& lhs, const MessageId& rhs) {
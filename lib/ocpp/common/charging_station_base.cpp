@@ -1,12 +1,17 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2023 Pionix GmbH and Contributors to EVerest
 
-#include <boost/make_shared.hpp>
 #include <ocpp/common/charging_station_base.hpp>
 
+#include <everest/logging.hpp>
+
 namespace ocpp {
 ChargingStationBase::ChargingStationBase(const std::shared_ptr<EvseSecurity> evse_security,
-                                         const std::optional<SecurityConfiguration> security_configuration) {
+                                         const std::optional<SecurityConfiguration> security_configuration,
+                                         std::shared_ptr<Executor> executor) :
+    owns_executor(executor == nullptr),
+    executor(executor != nullptr ? std::move(executor) : std::make_shared<Executor>()),
+    io_context(this->executor->get_io_context()) {
 
     if (evse_security != nullptr) {
         this->evse_security = evse_security;
@@ -17,15 +22,22 @@ ChargingStationBase::ChargingStationBase(const std::shared_ptr<EvseSecurity> evs
         }
         this->evse_security = std::make_shared<EvseSecurityImpl>(security_configuration.value());
     }
-    this->work = boost::make_shared<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
-        boost::asio::make_work_guard(this->io_context));
-    this->io_context_thread = std::thread([this]() { this->io_context.run(); });
+    this->contract_certificate_cache = std::make_shared<ContractCertificateCache>(*this->evse_security);
 }
 
-ChargingStationBase::~ChargingStationBase() {
-    work->get_executor().context().stop();
-    io_context.stop();
-    io_context_thread.join();
+ChargingStationBase::~ChargingStationBase() = default;
+
+void ChargingStationBase::stop_timers_on_executor(const std::function<void()>& stop_timers) {
+    if (this->owns_executor) {
+        this->executor->stop();
+        return;
+    }
+
+    try {
+        this->executor->run_and_wait(stop_timers);
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not stop the timers of the charging station: " << e.what();
+    }
 }
 
 } // namespace ocpp
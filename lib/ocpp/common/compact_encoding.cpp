@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/compact_encoding.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ocpp::compact_encoding {
+
+namespace {
+// Integral floats up to this magnitude are written in decimal notation, which is shorter than their bits
+constexpr float MAX_INTEGRAL_FLOAT = 1e8F;
+
+const std::string PERIODS_KEY = "chargingSchedulePeriod";
+
+template <typename T> void from_chars_exact(std::string_view field, T& value, const int base = 10) {
+    const auto* const end = field.data() + field.size();
+    const auto result = std::from_chars(field.data(), end, value, base);
+    if (result.ec != std::errc() or result.ptr != end) {
+        throw DecodeException("Invalid number '" + std::string(field) + "'");
+    }
+}
+
+/// \brief Calls \p callback with every charging schedule of \p profile, which is a single object in OCPP 1.6 and an
+/// array in OCPP 2.x
+template <typename Callback> void for_each_schedule(json& profile, Callback callback) {
+    auto schedules = profile.find("chargingSchedule");
+    if (schedules == profile.end()) {
+        return;
+    }
+    if (schedules->is_array()) {
+        for (std::size_t i = 0; i < schedules->size(); ++i) {
+            callback(schedules->at(i), i);
+        }
+    } else if (schedules->is_object()) {
+        callback(*schedules, 0);
+    }
+}
+
+bool is_compact_period(const json& period) {
+    if (!period.is_object()) {
+        return false;
+    }
+    for (const auto& [key, value] : period.items()) {
+        if (key == "limit") {
+            if (!value.is_number()) {
+                return false;
+            }
+        } else if (key == "startPeriod" or key == "numberPhases" or key == "phaseToUse") {
+            if (!value.is_number_integer()) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return period.contains("startPeriod");
+}
+
+std::string encode_periods(const json& periods) {
+    std::string encoded;
+    // Typical periods need less than 16 characters
+    encoded.reserve(periods.size() * 16);
+    for (const auto& period : periods) {
+        if (!encoded.empty()) {
+            encoded += ';';
+        }
+        append_int(encoded, period.at("startPeriod").get<std::int64_t>());
+        encoded += ',';
+        if (const auto limit = period.find("limit"); limit != period.end()) {
+            append_float(encoded, limit->get<float>());
+        }
+        encoded += ',';
+        if (const auto number_phases = period.find("numberPhases"); number_phases != period.end()) {
+            append_int(encoded, number_phases->get<std::int64_t>());
+        }
+        encoded += ',';
+        if (const auto phase_to_use = period.find("phaseToUse"); phase_to_use != period.end()) {
+            append_int(encoded, phase_to_use->get<std::int64_t>());
+        }
+    }
+    return encoded;
+}
+
+std::vector<SchedulePeriod> decode_periods(std::string_view encoded) {
+    std::vector<SchedulePeriod> periods;
+    Reader reader(encoded);
+    do {
+        SchedulePeriod period;
+        period.start_period = static_cast<std::int32_t>(reader.read_int());
+        reader.expect(',');
+        period.limit = reader.read_optional_float();
+        reader.expect(',');
+        if (const auto number_phases = reader.read_optional_int(); number_phases.has_value()) {
+            period.number_phases = static_cast<std::int32_t>(number_phases.value());
+        }
+        reader.expect(',');
+        if (const auto phase_to_use = reader.read_optional_int(); phase_to_use.has_value()) {
+            period.phase_to_use = static_cast<std::int32_t>(phase_to_use.value());
+        }
+        periods.push_back(period);
+    } while (reader.skip(';'));
+
+    if (!reader.at_end()) {
+        throw DecodeException("Unexpected characters after the charging schedule periods");
+    }
+    return periods;
+}
+} // namespace
+
+void append_int(std::string& out, const std::int64_t value) {
+    char buffer[std::numeric_limits<std::int64_t>::digits10 + 3];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_float(std::string& out, const float value) {
+    if (std::isfinite(value) and std::trunc(value) == value and std::fabs(value) < MAX_INTEGRAL_FLOAT and
+        !(value == 0.0F and std::signbit(value))) {
+        append_int(out, static_cast<std::int64_t>(value));
+        return;
+    }
+
+    std::uint32_t bits = 0;
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    char buffer[9];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), bits, 16);
+    out += 'x';
+    out.append(buffer, result.ptr);
+}
+
+Reader::Reader(std::string_view encoded) : encoded(encoded), pos(0) {
+}
+
+bool Reader::at_end() const {
+    return this->pos == this->encoded.size();
+}
+
+bool Reader::skip(const char separator) {
+    if (this->pos < this->encoded.size() and this->encoded[this->pos] == separator) {
+        ++this->pos;
+        return true;
+    }
+    return false;
+}
+
+void Reader::expect(const char separator) {
+    if (!this->skip(separator)) {
+        throw DecodeException(std::string("Expected '") + separator + "' at position " + std::to_string(this->pos));
+    }
+}
+
+std::string_view Reader::read_field() {
+    auto end = this->encoded.find_first_of(SEPARATORS, this->pos);
+    if (end == std::string_view::npos) {
+        end = this->encoded.size();
+    }
+    const auto field = this->encoded.substr(this->pos, end - this->pos);
+    this->pos = end;
+    return field;
+}
+
+std::optional<std::int64_t> Reader::read_optional_int() {
+    const auto field = this->read_field();
+    if (field.empty()) {
+        return std::nullopt;
+    }
+    std::int64_t value = 0;
+    from_chars_exact(field, value);
+    return value;
+}
+
+std::int64_t Reader::read_int() {
+    const auto value = this->read_optional_int();
+    if (!value.has_value()) {
+        throw DecodeException("Missing required integer at position " + std::to_string(this->pos));
+    }
+    return value.value();
+}
+
+std::optional<float> Reader::read_optional_float() {
+    const auto field = this->read_field();
+    if (field.empty()) {
+        return std::nullopt;
+    }
+    if (field.front() != 'x') {
+        std::int64_t value = 0;
+        from_chars_exact(field, value);
+        return static_cast<float>(value);
+    }
+
+    std::uint32_t bits = 0;
+    from_chars_exact(field.substr(1), bits, 16);
+    float value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+float Reader::read_float() {
+    const auto value = this->read_optional_float();
+    if (!value.has_value()) {
+        throw DecodeException("Missing required number at position " + std::to_string(this->pos));
+    }
+    return value.value();
+}
+
+std::string_view Reader::read_text() {
+    return this->read_field();
+}
+
+std::string encode_charging_profile(json profile) {
+    for_each_schedule(profile, [](json& schedule, std::size_t /*index*/) {
+        auto periods = schedule.find(PERIODS_KEY);
+        if (periods == schedule.end() or !periods->is_array() or periods->empty() or
+            !std::all_of(periods->begin(), periods->end(), is_compact_period)) {
+            return;
+        }
+        *periods = encode_periods(*periods);
+    });
+
+    return CHARGING_PROFILE_ENCODING_V1 + profile.dump();
+}
+
+DecodedChargingProfile decode_charging_profile(std::string_view stored) {
+    DecodedChargingProfile decoded;
+
+    if (stored.empty()) {
+        throw DecodeException("Empty charging profile");
+    }
+    if (stored.front() == '{') {
+        // Plain json as written before the compact encoding existed
+        decoded.profile = json::parse(stored.begin(), stored.end());
+        return decoded;
+    }
+    if (stored.front() != CHARGING_PROFILE_ENCODING_V1) {
+        throw DecodeException(std::string("Unknown charging profile encoding '") + stored.front() + "'");
+    }
+
+    decoded.profile = json::parse(stored.begin() + 1, stored.end());
+    for_each_schedule(decoded.profile, [&decoded](json& schedule, std::size_t index) {
+        auto periods = schedule.find(PERIODS_KEY);
+        if (periods == schedule.end() or !periods->is_string()) {
+            return;
+        }
+        if (decoded.schedule_periods.size() <= index) {
+            decoded.schedule_periods.resize(index + 1);
+        }
+        decoded.schedule_periods[index] = decode_periods(periods->get_ref<const std::string&>());
+        *periods = json::array();
+    });
+
+    return decoded;
+}
+
+} // namespace ocpp::compact_encoding
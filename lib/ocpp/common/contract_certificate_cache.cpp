@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/contract_certificate_cache.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+namespace ocpp {
+
+namespace {
+/// \returns the raw SHA-256 digest of \p certificate_chain
+std::string get_digest(const std::string& certificate_chain) {
+    std::array<unsigned char, SHA256_DIGEST_LENGTH> hash{};
+    EVP_Digest(certificate_chain.data(), certificate_chain.size(), hash.data(), nullptr, EVP_sha256(), nullptr);
+    return {hash.begin(), hash.end()};
+}
+
+/// \returns the notAfter of the certificate of the PEM formatted \p certificate_chain that expires first, or
+/// std::nullopt if the chain can not be read, is empty or one of its certificates is not valid at the moment
+std::optional<DateTime> get_valid_until(const std::string& certificate_chain) {
+    const std::unique_ptr<BIO, decltype(&BIO_free)> bio(
+        BIO_new_mem_buf(certificate_chain.data(), static_cast<int>(certificate_chain.size())), &BIO_free);
+    if (bio == nullptr) {
+        return std::nullopt;
+    }
+
+    const DateTime now;
+    std::optional<std::chrono::seconds> remaining;
+    while (true) {
+        const std::unique_ptr<X509, decltype(&X509_free)> certificate(
+            PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr), &X509_free);
+        if (certificate == nullptr) {
+            break;
+        }
+        if (X509_cmp_current_time(X509_get0_notBefore(certificate.get())) > 0) {
+            return std::nullopt;
+        }
+        int days = 0;
+        int seconds = 0;
+        if (ASN1_TIME_diff(&days, &seconds, nullptr, X509_get0_notAfter(certificate.get())) == 0) {
+            return std::nullopt;
+        }
+        const auto certificate_remaining = std::chrono::hours(days * 24) + std::chrono::seconds(seconds);
+        if (certificate_remaining.count() <= 0) {
+            return std::nullopt;
+        }
+        if (!remaining.has_value() or certificate_remaining < remaining.value()) {
+            remaining = certificate_remaining;
+        }
+    }
+    // Reading stops with an error at the end of the chain
+    ERR_clear_error();
+
+    if (!remaining.has_value()) {
+        return std::nullopt;
+    }
+    return DateTime(now.to_time_point() + remaining.value());
+}
+} // namespace
+
+ContractCertificateCache::ContractCertificateCache(EvseSecurity& evse_security, const std::size_t max_entries,
+                                                   const std::chrono::seconds negative_result_ttl) :
+    evse_security(evse_security), max_entries(max_entries), negative_result_ttl(negative_result_ttl) {
+}
+
+CertificateValidationResult
+ContractCertificateCache::verify_certificate(const std::string& certificate_chain,
+                                             const std::vector<LeafCertificateType>& certificate_types) {
+    const auto digest = get_digest(certificate_chain);
+    {
+        const std::lock_guard<std::mutex> lock(this->cache_mutex);
+        auto* entry = this->find_entry(digest);
+        if (entry != nullptr) {
+            const auto it = entry->verify_results.find(certificate_types);
+            if (it != entry->verify_results.end()) {
+                if (!it->second.valid_until.has_value() or it->second.valid_until.value() > DateTime()) {
+                    return it->second.result;
+                }
+                entry->verify_results.erase(it);
+            }
+        }
+    }
+
+    // The lock is not held while verifying, so other chains can be looked up in the meantime
+    const auto result = this->evse_security.verify_certificate(certificate_chain, certificate_types);
+    if (result == CertificateValidationResult::Unknown) {
+        return result;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->cache_mutex);
+    auto* entry = this->find_or_create_entry(digest, certificate_chain);
+    if (entry != nullptr) {
+        std::optional<DateTime> valid_until;
+        if (result != CertificateValidationResult::Valid) {
+            valid_until = DateTime(DateTime().to_time_point() + this->negative_result_ttl);
+        }
+        entry->verify_results[certificate_types] = VerifyResult{result, valid_until};
+    }
+    return result;
+}
+
+std::vector<OCSPRequestData> ContractCertificateCache::get_mo_ocsp_request_data(const std::string& certificate_chain) {
+    const auto digest = get_digest(certificate_chain);
+    {
+        const std::lock_guard<std::mutex> lock(this->cache_mutex);
+        const auto* entry = this->find_entry(digest);
+        if (entry != nullptr and entry->ocsp_request_data.has_value()) {
+            return entry->ocsp_request_data.value();
+        }
+    }
+
+    auto ocsp_request_data = this->evse_security.get_mo_ocsp_request_data(certificate_chain);
+    if (ocsp_request_data.empty()) {
+        return ocsp_request_data;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->cache_mutex);
+    auto* entry = this->find_or_create_entry(digest, certificate_chain);
+    if (entry != nullptr) {
+        entry->ocsp_request_data = ocsp_request_data;
+    }
+    return ocsp_request_data;
+}
+
+void ContractCertificateCache::clear() {
+    const std::lock_guard<std::mutex> lock(this->cache_mutex);
+    this->entries.clear();
+    this->entries_by_digest.clear();
+}
+
+std::size_t ContractCertificateCache::size() {
+    const std::lock_guard<std::mutex> lock(this->cache_mutex);
+    return this->entries.size();
+}
+
+ContractCertificateCache::Entry* ContractCertificateCache::find_entry(const std::string& digest) {
+    const auto it = this->entries_by_digest.find(digest);
+    if (it == this->entries_by_digest.end()) {
+        return nullptr;
+    }
+    if (it->second->valid_until <= DateTime()) {
+        this->entries.erase(it->second);
+        this->entries_by_digest.erase(it);
+        return nullptr;
+    }
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return &this->entries.front();
+}
+
+ContractCertificateCache::Entry* ContractCertificateCache::find_or_create_entry(const std::string& digest,
+                                                                                const std::string& certificate_chain) {
+    auto* entry = this->find_entry(digest);
+    if (entry != nullptr) {
+        return entry;
+    }
+    if (this->max_entries == 0) {
+        return nullptr;
+    }
+
+    const auto valid_until = get_valid_until(certificate_chain);
+    if (!valid_until.has_value()) {
+        return nullptr;
+    }
+
+    while (this->entries.size() >= this->max_entries) {
+        this->entries_by_digest.erase(this->entries.back().digest);
+        this->entries.pop_back();
+    }
+    this->entries.push_front(Entry{digest, valid_until.value(), {}, std::nullopt});
+    this->entries_by_digest[digest] = this->entries.begin();
+    return &this->entries.front();
+}
+
+} // namespace ocpp
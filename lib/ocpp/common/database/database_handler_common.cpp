@@ -34,6 +34,13 @@ void DatabaseHandlerCommon::open_connection() {
 }
 
 void DatabaseHandlerCommon::close_connection() {
+    // The connection is closed even if deinit_sql fails
+    try {
+        this->deinit_sql();
+    } catch (...) {
+        this->database->close_connection();
+        throw;
+    }
     this->database->close_connection();
 }
 
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/executor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+
+#include <everest/logging.hpp>
+
+namespace ocpp {
+
+namespace {
+/// \brief Interval in which run_and_wait() checks if the executor was stopped while it waits
+constexpr auto STOPPED_CHECK_INTERVAL = std::chrono::milliseconds(100);
+} // namespace
+
+Executor::Executor(std::size_t number_of_threads) : work(boost::asio::make_work_guard(this->io_context)) {
+    number_of_threads = std::max<std::size_t>(number_of_threads, 1);
+    this->threads.reserve(number_of_threads);
+    for (std::size_t i = 0; i < number_of_threads; ++i) {
+        this->threads.emplace_back([this]() {
+            // A throwing handler must not take down the thread that serves all other components
+            while (true) {
+                try {
+                    this->io_context.run();
+                    return;
+                } catch (const std::exception& e) {
+                    EVLOG_error << "Exception in executor handler: " << e.what();
+                }
+            }
+        });
+    }
+}
+
+Executor::~Executor() {
+    this->stop();
+}
+
+boost::asio::io_context& Executor::get_io_context() {
+    return this->io_context;
+}
+
+std::size_t Executor::get_number_of_threads() const {
+    return this->threads.size();
+}
+
+void Executor::run_and_wait(const std::function<void()>& handler) {
+    run_and_wait(this->io_context, handler);
+}
+
+void Executor::run_and_wait(boost::asio::io_context& io_context, const std::function<void()>& handler) {
+    if (io_context.get_executor().running_in_this_thread() or io_context.stopped()) {
+        handler();
+        return;
+    }
+
+    // Shared with the posted handler, which is dropped without being run if the io_context is stopped meanwhile
+    struct State {
+        std::function<void()> handler;
+        std::atomic_bool started{false};
+        std::promise<void> done;
+    };
+    const auto state = std::make_shared<State>();
+    state->handler = handler;
+    auto future = state->done.get_future();
+
+    const auto run = [](State& state) {
+        if (state.started.exchange(true)) {
+            return;
+        }
+        try {
+            state.handler();
+            state.done.set_value();
+        } catch (...) {
+            state.done.set_exception(std::current_exception());
+        }
+    };
+
+    boost::asio::post(io_context, [state, run]() { run(*state); });
+    while (future.wait_for(STOPPED_CHECK_INTERVAL) != std::future_status::ready) {
+        if (io_context.stopped()) {
+            // No thread picks up the posted handler anymore, unless it is already running
+            run(*state);
+        }
+    }
+    future.get();
+}
+
+void Executor::stop() {
+    this->work.reset();
+    this->io_context.stop();
+    for (auto& thread : this->threads) {
+        if (thread.joinable() and thread.get_id() != std::this_thread::get_id()) {
+            thread.join();
+        } else if (thread.joinable()) {
+            // Stopped from one of its own handlers
+            thread.detach();
+        }
+    }
+}
+
+std::shared_ptr<Executor> Executor::get_default() {
+    static const auto default_executor = std::make_shared<Executor>();
+    return default_executor;
+}
+
+} // namespace ocpp
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/common/rfc3339.hpp>
+
+#include <cstdint>
+#include <sstream>
+
+#include <date/date.h>
+
+namespace ocpp::rfc3339 {
+
+namespace {
+// Length of YYYY-MM-DDTHH:MM:SS
+constexpr std::size_t DATE_TIME_SIZE = 19;
+constexpr int MAX_FRACTION_DIGITS = 9;
+
+bool is_digit(const char c) {
+    return c >= '0' and c <= '9';
+}
+
+/// \brief Reads exactly \p count digits starting at \p pos into \p value
+bool read_digits(std::string_view str, const std::size_t pos, const std::size_t count, int& value) {
+    value = 0;
+    for (std::size_t i = pos; i < pos + count; ++i) {
+        if (!is_digit(str[i])) {
+            return false;
+        }
+        value = value * 10 + (str[i] - '0');
+    }
+    return true;
+}
+
+/// \brief Writes \p value zero padded to exactly \p count digits to \p out
+void write_digits(char* out, const std::size_t count, int value) {
+    for (std::size_t i = count; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+} // namespace
+
+std::optional<utc_time_point> parse_fast(std::string_view timepoint_str) {
+    if (timepoint_str.size() < DATE_TIME_SIZE or timepoint_str[4] != '-' or timepoint_str[7] != '-' or
+        timepoint_str[10] != 'T' or timepoint_str[13] != ':' or timepoint_str[16] != ':') {
+        return std::nullopt;
+    }
+
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    int hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    if (!read_digits(timepoint_str, 0, 4, year) or !read_digits(timepoint_str, 5, 2, month) or
+        !read_digits(timepoint_str, 8, 2, day) or !read_digits(timepoint_str, 11, 2, hours) or
+        !read_digits(timepoint_str, 14, 2, minutes) or !read_digits(timepoint_str, 17, 2, seconds)) {
+        return std::nullopt;
+    }
+
+    // Leap seconds and out of range values are left to date::parse
+    if (hours > 23 or minutes > 59 or seconds > 59) {
+        return std::nullopt;
+    }
+
+    const date::year_month_day ymd{date::year{year}, date::month{static_cast<unsigned>(month)},
+                                   date::day{static_cast<unsigned>(day)}};
+    if (!ymd.ok()) {
+        return std::nullopt;
+    }
+
+    std::size_t pos = DATE_TIME_SIZE;
+
+    std::chrono::nanoseconds fraction{0};
+    if (pos < timepoint_str.size() and timepoint_str[pos] == '.') {
+        ++pos;
+        std::int64_t fraction_value = 0;
+        int fraction_digits = 0;
+        while (pos < timepoint_str.size() and is_digit(timepoint_str[pos])) {
+            if (fraction_digits == MAX_FRACTION_DIGITS) {
+                return std::nullopt;
+            }
+            fraction_value = fraction_value * 10 + (timepoint_str[pos] - '0');
+            ++fraction_digits;
+            ++pos;
+        }
+        if (fraction_digits == 0) {
+            return std::nullopt;
+        }
+        for (int i = fraction_digits; i < MAX_FRACTION_DIGITS; ++i) {
+            fraction_value *= 10;
+        }
+        fraction = std::chrono::nanoseconds(fraction_value);
+    }
+
+    std::chrono::minutes offset{0};
+    if (pos < timepoint_str.size()) {
+        const char designator = timepoint_str[pos];
+        if (designator == 'Z') {
+            ++pos;
+        } else if (designator == '+' or designator == '-') {
+            int offset_hours = 0;
+            int offset_minutes = 0;
+            if (timepoint_str.size() - pos < 6 or timepoint_str[pos + 3] != ':' or
+                !read_digits(timepoint_str, pos + 1, 2, offset_hours) or
+                !read_digits(timepoint_str, pos + 4, 2, offset_minutes) or offset_hours > 23 or
+                offset_minutes > 59) {
+                return std::nullopt;
+            }
+            offset = std::chrono::hours(offset_hours) + std::chrono::minutes(offset_minutes);
+            if (designator == '-') {
+                offset = -offset;
+            }
+            pos += 6;
+        }
+    }
+
+    // Anything that is not fully consumed is left to date::parse, which also accepts trailing characters
+    if (pos != timepoint_str.size()) {
+        return std::nullopt;
+    }
+
+    const date::sys_time<std::chrono::nanoseconds> sys_time = date::sys_days{ymd} + std::chrono::hours(hours) +
+                                                              std::chrono::minutes(minutes) +
+                                                              std::chrono::seconds(seconds) + fraction - offset;
+
+    return std::chrono::time_point_cast<utc_time_point::duration>(date::utc_clock::from_sys(sys_time));
+}
+
+std::optional<utc_time_point> parse_reference(const std::string& timepoint_str) {
+    utc_time_point timepoint;
+    std::istringstream in{timepoint_str};
+    in >> date::parse("%FT%T%Ez", timepoint);
+    if (in.fail()) {
+        in.clear();
+        in.seekg(0);
+        in >> date::parse("%FT%TZ", timepoint);
+        if (in.fail()) {
+            in.clear();
+            in.seekg(0);
+            in >> date::parse("%FT%T", timepoint);
+            if (in.fail()) {
+                return std::nullopt;
+            }
+        }
+    }
+    return timepoint;
+}
+
+bool format_fast(const utc_time_point& timepoint, char* out) {
+    const auto timepoint_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(timepoint);
+
+    // A leap second is written as second 60, which is left to date::format
+    if (date::get_leap_second_info(timepoint_ms).is_leap_second) {
+        return false;
+    }
+
+    const auto sys_time = date::utc_clock::to_sys(timepoint_ms);
+    const auto days = std::chrono::floor<date::days>(sys_time);
+    const date::year_month_day ymd{days};
+
+    const int year = static_cast<int>(ymd.year());
+    if (year < 0 or year > 9999) {
+        return false;
+    }
+
+    auto time_of_day = std::chrono::duration_cast<std::chrono::milliseconds>(sys_time - days).count();
+    const auto milliseconds = static_cast<int>(time_of_day % 1000);
+    time_of_day /= 1000;
+    const auto seconds = static_cast<int>(time_of_day % 60);
+    time_of_day /= 60;
+    const auto minutes = static_cast<int>(time_of_day % 60);
+    const auto hours = static_cast<int>(time_of_day / 60);
+
+    write_digits(out, 4, year);
+    out[4] = '-';
+    write_digits(out + 5, 2, static_cast<int>(static_cast<unsigned>(ymd.month())));
+    out[7] = '-';
+    write_digits(out + 8, 2, static_cast<int>(static_cast<unsigned>(ymd.day())));
+    out[10] = 'T';
+    write_digits(out + 11, 2, hours);
+    out[13] = ':';
+    write_digits(out + 14, 2, minutes);
+    out[16] = ':';
+    write_digits(out + 17, 2, seconds);
+    out[19] = '.';
+    write_digits(out + 20, 3, milliseconds);
+    out[23] = 'Z';
+
+    return true;
+}
+
+std::string format_reference(const utc_time_point& timepoint) {
+    return date::format("%FT%TZ", std::chrono::time_point_cast<std::chrono::milliseconds>(timepoint));
+}
+
+} // namespace ocpp::rfc3339
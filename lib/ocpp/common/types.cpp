@@ -3,6 +3,7 @@
 
 #include <everest/logging.hpp>
 #include <ocpp/common/call_types.hpp>
+#include <ocpp/common/rfc3339.hpp>
 #include <ocpp/common/types.hpp>
 
 namespace ocpp {
@@ -29,25 +30,23 @@ DateTimeImpl::DateTimeImpl(const std::string& timepoint_str) {
 }
 
 std::string DateTimeImpl::to_rfc3339() const {
-    return date::format("%FT%TZ", std::chrono::time_point_cast<std::chrono::milliseconds>(this->timepoint));
+    char formatted[rfc3339::FORMATTED_SIZE];
+    if (rfc3339::format_fast(this->timepoint, formatted)) {
+        return std::string(formatted, rfc3339::FORMATTED_SIZE);
+    }
+    return rfc3339::format_reference(this->timepoint);
 }
 
 void DateTimeImpl::from_rfc3339(const std::string& timepoint_str) {
-    std::istringstream in{timepoint_str};
-    in >> date::parse("%FT%T%Ez", this->timepoint);
-    if (in.fail()) {
-        in.clear();
-        in.seekg(0);
-        in >> date::parse("%FT%TZ", this->timepoint);
-        if (in.fail()) {
-            in.clear();
-            in.seekg(0);
-            in >> date::parse("%FT%T", this->timepoint);
-            if (in.fail()) {
-                throw TimePointParseException(timepoint_str);
-            }
+    auto parsed = rfc3339::parse_fast(timepoint_str);
+    if (!parsed.has_value()) {
+        // Not one of the canonical forms, let date::parse handle it
+        parsed = rfc3339::parse_reference(timepoint_str);
+        if (!parsed.has_value()) {
+            throw TimePointParseException(timepoint_str);
         }
     }
+    this->timepoint = parsed.value();
 }
 
 std::chrono::time_point<date::utc_clock> DateTimeImpl::to_time_point() const {
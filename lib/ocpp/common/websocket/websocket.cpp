@@ -14,9 +14,9 @@ using json = nlohmann::json;
 namespace ocpp {
 
 Websocket::Websocket(const WebsocketConnectionOptions& connection_options, std::shared_ptr<EvseSecurity> evse_security,
-                     std::shared_ptr<MessageLogging> logging) :
+                     std::shared_ptr<MessageLogging> logging, std::shared_ptr<Executor> executor) :
     logging(logging) {
-    this->websocket = std::make_unique<WebsocketLibwebsockets>(connection_options, evse_security);
+    this->websocket = std::make_unique<WebsocketLibwebsockets>(connection_options, evse_security, executor);
 }
 
 bool Websocket::start_connecting() {
@@ -38,6 +38,14 @@ void Websocket::reconnect(long delay) {
     this->websocket->reconnect(delay);
 }
 
+void Websocket::invalidate_tls_context() {
+    this->websocket->invalidate_tls_context();
+}
+
+WebsocketTrafficCounters Websocket::get_traffic_counters() {
+    return this->websocket->get_traffic_counters();
+}
+
 bool Websocket::is_connected() {
     return this->websocket->is_connected();
 }
@@ -7,12 +7,14 @@
 #include <websocketpp_utils/base64.hpp>
 namespace ocpp {
 
-WebsocketBase::WebsocketBase() :
+WebsocketBase::WebsocketBase(std::shared_ptr<Executor> executor) :
     m_is_connected(false),
+    connection_options(),
     connected_callback(nullptr),
     stopped_connecting_callback(nullptr),
     message_callback(nullptr),
     reconnect_timer(nullptr),
+    executor(executor != nullptr ? executor : Executor::get_default()),
     connection_attempts(1),
     ping_cleared(true),
     ping_elapsed_s(0),
@@ -22,7 +24,7 @@ WebsocketBase::WebsocketBase() :
 
     set_connection_options_base(connection_options);
 
-    this->ping_timer = std::make_unique<Everest::SteadyTimer>();
+    this->ping_timer = std::make_unique<Everest::SteadyTimer>(&this->executor->get_io_context());
     const auto auth_key = connection_options.authorization_key;
     if (auth_key.has_value() and auth_key.value().length() < 16) {
         EVLOG_warning << "AuthorizationKey with only " << auth_key.value().length()
@@ -32,7 +34,11 @@ WebsocketBase::WebsocketBase() :
 
 WebsocketBase::~WebsocketBase() {
     try {
-        this->cancel_reconnect_timer();
+        // Stopped on the executor, so the timer handlers can not run while this object is destroyed
+        this->executor->run_and_wait([this]() {
+            this->ping_timer->stop();
+            this->cancel_reconnect_timer();
+        });
     } catch (...) {
         EVLOG_error << "Exception during dtor call of reconnect timer cancellation";
         return;
@@ -7,6 +7,7 @@
 
 #include <libwebsockets.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -50,13 +51,6 @@ public:
     }
 };
 
-template <> class std::default_delete<SSL_CTX> {
-public:
-    void operator()(SSL_CTX* ptr) const {
-        ::SSL_CTX_free(ptr);
-    }
-};
-
 namespace ocpp {
 
 using evse_security::OpenSSLProvider;
@@ -174,7 +168,7 @@ public:
     ///        '::lws_context_destroy(ptr);' and that causes a deadlock
     void reset_connection_data() {
         // Destroy them outside the lock scope
-        std::unique_ptr<SSL_CTX> clear_sec;
+        std::shared_ptr<SSL_CTX> clear_sec;
         std::unique_ptr<lws_context> clear_lws;
 
         {
@@ -191,7 +185,7 @@ public:
         }
     }
 
-    void init_connection_context(lws_context* lws_ctx, SSL_CTX* ssl_ctx) {
+    void init_connection_context(lws_context* lws_ctx, std::shared_ptr<SSL_CTX> ssl_ctx) {
         const std::lock_guard lock(this->mutex);
 
         if (this->lws_ctx || this->sec_context) {
@@ -205,7 +199,7 @@ public:
         this->lws_ctx = std::unique_ptr<lws_context>(lws_ctx);
 
         if (ssl_ctx != nullptr) {
-            this->sec_context = std::unique_ptr<SSL_CTX>(ssl_ctx);
+            this->sec_context = std::move(ssl_ctx);
         }
     }
 
@@ -229,9 +223,20 @@ public:
         return owner;
     }
 
+    // permessage-deflate state, only accessed from the websocket client thread
+    // Set while a message below the compression threshold is handed to lws_write
+    bool deflate_bypass = false;
+    // Set once the CSMS accepted permessage-deflate for this connection
+    bool deflate_negotiated = false;
+
 private:
-    // Openssl context, must be destroyed in this order
-    std::unique_ptr<SSL_CTX> sec_context;
+    // Extensions offered to the CSMS, must outlive the lws context
+    std::string deflate_offer;
+    std::array<lws_extension, 2> extensions{};
+
+    // Openssl context, must be destroyed in this order. Shared with the websocket that keeps it
+    // cached across reconnects
+    std::shared_ptr<SSL_CTX> sec_context;
     // libwebsockets state
     std::unique_ptr<lws_context> lws_ctx;
     // Internal used WSI
@@ -334,14 +339,40 @@ bool verify_csms_cn(const std::string& hostname, bool preverified, const X509_ST
 
     return preverified;
 }
+
+/// \returns true if the TLS context or the resumed session depend on an option that differs between \p lhs and
+/// \p rhs. Sessions must only be resumed with the same CSMS, so the host and port of the CSMS URI are compared as well
+bool tls_options_differ(const WebsocketConnectionOptions& lhs, const WebsocketConnectionOptions& rhs) {
+    auto lhs_uri = lhs.csms_uri;
+    auto rhs_uri = rhs.csms_uri;
+    return lhs.security_profile != rhs.security_profile or lhs_uri.get_hostname() != rhs_uri.get_hostname() or
+           lhs_uri.get_port() != rhs_uri.get_port() or lhs.supported_ciphers_12 != rhs.supported_ciphers_12 or
+           lhs.supported_ciphers_13 != rhs.supported_ciphers_13 or
+           lhs.use_ssl_default_verify_paths != rhs.use_ssl_default_verify_paths or
+           lhs.additional_root_certificate_check != rhs.additional_root_certificate_check or
+           lhs.hostName != rhs.hostName or lhs.verify_csms_common_name != rhs.verify_csms_common_name or
+           lhs.use_tpm_tls != rhs.use_tpm_tls or lhs.verify_csms_allow_wildcards != rhs.verify_csms_allow_wildcards or
+           lhs.enable_tls_keylog != rhs.enable_tls_keylog or lhs.keylog_file != rhs.keylog_file or
+           lhs.enable_tls_session_resumption != rhs.enable_tls_session_resumption;
+}
 } // namespace
 
 WebsocketLibwebsockets::WebsocketLibwebsockets(const WebsocketConnectionOptions& connection_options,
-                                               std::shared_ptr<EvseSecurity> evse_security) :
-    WebsocketBase(), // NOLINT(readability-redundant-member-init): explicitly call base class ctor here for readability
+                                               std::shared_ptr<EvseSecurity> evse_security,
+                                               std::shared_ptr<Executor> executor) :
+    WebsocketBase(executor),
     evse_security(evse_security),
+    reconnect_timer_tpm(&this->executor->get_io_context()),
     stop_deferred_handler(false),
-    connected_ocpp_version{OcppProtocolVersion::Unknown} {
+    connected_ocpp_version{OcppProtocolVersion::Unknown},
+    messages_sent(0),
+    payload_bytes_sent(0),
+    deflate_input_bytes_sent(0),
+    deflate_output_bytes_sent(0),
+    messages_received(0),
+    payload_bytes_received(0),
+    inflate_input_bytes_received(0),
+    inflate_output_bytes_received(0) {
 
     set_connection_options(connection_options);
 
@@ -349,6 +380,13 @@ WebsocketLibwebsockets::WebsocketLibwebsockets(const WebsocketConnectionOptions&
 }
 
 WebsocketLibwebsockets::~WebsocketLibwebsockets() {
+    try {
+        // Stopped on the executor before connection_mutex is locked, the timer handler locks it as well
+        this->executor->run_and_wait([this]() { this->reconnect_timer_tpm.stop(); });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of reconnect timer stop";
+    }
+
     try {
         const std::lock_guard lock(this->connection_mutex);
 
@@ -401,13 +439,29 @@ void WebsocketLibwebsockets::set_connection_options(const WebsocketConnectionOpt
         throw std::invalid_argument("Ocpp_versions may not contain 'Unknown'");
     }
 
+    if (connection_options.enable_permessage_deflate and
+        (connection_options.permessage_deflate_client_max_window_bits < 9 or
+         connection_options.permessage_deflate_client_max_window_bits > 15 or
+         connection_options.permessage_deflate_server_max_window_bits < 9 or
+         connection_options.permessage_deflate_server_max_window_bits > 15)) {
+        throw std::invalid_argument("permessage-deflate window bits must be between 9 and 15");
+    }
+
     if (connection_options.pong_timeout_s > connection_options.ping_interval_s) {
         EVLOG_warning << "Pong timeout of " << connection_options.pong_timeout_s
                       << " s is larger than the ping interval of " << connection_options.ping_interval_s << " s";
     }
 
+    // The TLS context and the session are kept if the new options do not affect them, e.g. when the options are set
+    // again after every successful connection
+    const bool tls_context_affected = tls_options_differ(this->connection_options, connection_options);
+
     set_connection_options_base(connection_options);
 
+    if (tls_context_affected) {
+        invalidate_tls_context();
+    }
+
     // Set secure URI only if it is in TLS mode
     if (connection_options.security_profile >
         security::SecurityProfile::UNSECURED_TRANSPORT_WITH_BASIC_AUTHENTICATION) {
@@ -434,6 +488,77 @@ int callback_minimal(struct lws* wsi, enum lws_callback_reasons reason, void* us
     return 0;
 }
 
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+constexpr auto permessage_deflate_name = "permessage-deflate";
+/// \brief RSV1 bit of the first byte of a websocket frame header, marks a compressed message (RFC 7692)
+constexpr unsigned char FRAME_RSV1 = 0x40;
+
+/// \brief Wraps the libwebsockets permessage-deflate extension to skip the compression of small messages and to count
+/// the bytes before and after compression
+int permessage_deflate_callback(struct lws_context* context, const struct lws_extension* ext, struct lws* wsi,
+                                enum lws_extension_callback_reasons reason, void* user, void* in, size_t len) {
+    ConnectionData* data = nullptr;
+    if (wsi != nullptr) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast): needed for appropriate type
+        data = reinterpret_cast<ConnectionData*>(lws_wsi_user(wsi));
+    }
+
+    if (data == nullptr or data->get_owner() == nullptr) {
+        return lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+    }
+
+    switch (reason) {
+    case LWS_EXT_CB_CLIENT_CONSTRUCT:
+        data->deflate_negotiated = true;
+        break;
+
+    case LWS_EXT_CB_PAYLOAD_TX: {
+        // An uncompressed message is sent without RSV1, which RFC 7692 allows on a connection using the extension. The
+        // payload is not passed to the extension, so it does not mark the frame as compressed
+        if (data->deflate_bypass) {
+            return PMDR_DID_NOTHING;
+        }
+
+        const int result = lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+        if (result >= 0 and result != PMDR_DID_NOTHING) {
+            const auto* ebufs = static_cast<const lws_ext_pm_deflate_rx_ebufs*>(in);
+            data->get_owner()->on_message_deflated(static_cast<std::size_t>(ebufs->eb_out.len));
+        }
+        return result;
+    }
+
+    case LWS_EXT_CB_PACKET_TX_PRESEND:
+        // The extension sets RSV1 on the header of the frame that is about to be sent, passed as lws_tokens. The frame
+        // of an uncompressed message must not carry it, so it is cleared instead of relying on the extension state
+        if (data->deflate_bypass) {
+            auto* frame = static_cast<struct lws_tokens*>(in);
+            if (frame != nullptr and frame->token != nullptr and frame->len > 0) {
+                frame->token[0] &= static_cast<unsigned char>(~FRAME_RSV1);
+            }
+            return 0;
+        }
+        break;
+
+    case LWS_EXT_CB_PAYLOAD_RX: {
+        const auto* ebufs = static_cast<const lws_ext_pm_deflate_rx_ebufs*>(in);
+        const auto input_len = ebufs->eb_in.len;
+
+        const int result = lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+        if (result >= 0 and result != PMDR_DID_NOTHING) {
+            data->get_owner()->on_message_inflated(static_cast<std::size_t>(input_len - ebufs->eb_in.len),
+                                                   static_cast<std::size_t>(ebufs->eb_out.len));
+        }
+        return result;
+    }
+
+    default:
+        break;
+    }
+
+    return lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+}
+#endif
+
 int private_key_callback(char* buf, int size, int /*rwflag*/, void* userdata) {
     const auto* password = static_cast<const std::string*>(userdata);
     const std::size_t max_pass_len = (size - 1); // we exclude the endline
@@ -445,6 +570,31 @@ int private_key_callback(char* buf, int size, int /*rwflag*/, void* userdata) {
 
     return clamp_to<int>(max_copy_chars);
 }
+
+WebsocketLibwebsockets* get_tls_context_owner(const SSL* ssl) {
+    return static_cast<WebsocketLibwebsockets*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+}
+
+int new_session_callback(SSL* ssl, SSL_SESSION* session) {
+    auto* owner = get_tls_context_owner(ssl);
+    if (owner == nullptr) {
+        return 0;
+    }
+    // Returning 1 means that we took ownership of the session
+    return owner->on_tls_session_created(session) ? 1 : 0;
+}
+
+void info_callback(const SSL* ssl, int where, int /*ret*/) {
+    // Only the initial handshake is of interest, before the ClientHello is written
+    if ((where & SSL_CB_HANDSHAKE_START) == 0 or SSL_in_before(ssl) == 0) {
+        return;
+    }
+    auto* owner = get_tls_context_owner(ssl);
+    if (owner != nullptr) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): OpenSSL only provides a const SSL in this callback
+        owner->on_tls_handshake_start(const_cast<SSL*>(ssl));
+    }
+}
 } // namespace
 
 constexpr auto local_protocol_name = "lws-everest-client";
@@ -604,6 +754,145 @@ void WebsocketLibwebsockets::thread_websocket_message_recv_loop(std::shared_ptr<
     EVLOG_debug << "Exit recv loop with ID: " << std::hex << std::this_thread::get_id();
 }
 
+std::shared_ptr<SSL_CTX> WebsocketLibwebsockets::get_tls_context() {
+    const std::lock_guard<std::mutex> lock(this->tls_context_mutex);
+
+    if (this->tls_context == nullptr) {
+        this->tls_context = create_tls_context();
+    } else {
+        EVLOG_debug << "Reusing cached TLS context";
+    }
+
+    return this->tls_context;
+}
+
+std::shared_ptr<SSL_CTX> WebsocketLibwebsockets::create_tls_context() {
+    // Setup context - need to know the key type first
+    std::string path_key;
+    std::string path_chain;
+
+    // Lifetime of this is important since we use the data from this in private_key_callback()
+    std::optional<std::string> private_key_password;
+
+    if (this->connection_options.security_profile == 3) {
+        const auto certificate_response =
+            this->evse_security->get_leaf_certificate_info(CertificateSigningUseEnum::ChargingStationCertificate);
+
+        if (certificate_response.status != ocpp::GetCertificateInfoStatus::Accepted or
+            !certificate_response.info.has_value()) {
+            EVLOG_error << "Connecting with security profile 3 but no client side certificate is present or valid";
+            return nullptr;
+        }
+
+        const auto& certificate_info = certificate_response.info.value();
+
+        if (certificate_info.certificate_path.has_value()) {
+            path_chain = certificate_info.certificate_path.value();
+        } else if (certificate_info.certificate_single_path.has_value()) {
+            path_chain = certificate_info.certificate_single_path.value();
+        } else {
+            EVLOG_error << "Connecting with security profile 3 but no client side certificate is present or valid";
+            return nullptr;
+        }
+
+        path_key = certificate_info.key_path;
+        private_key_password = certificate_info.password;
+    }
+
+    OpenSSLProvider provider;
+    const SSL_METHOD* method = SSLv23_client_method();
+    const std::shared_ptr<SSL_CTX> ssl_ctx(SSL_CTX_new_ex(provider, provider.propquery_default(), method),
+                                           [](SSL_CTX* ptr) { ::SSL_CTX_free(ptr); });
+
+    if (ssl_ctx == nullptr) {
+        ERR_print_errors_fp(stderr);
+        EVLOG_error << "Unable to create ssl context";
+        return nullptr;
+    }
+
+    if (this->connection_options.enable_tls_keylog and this->connection_options.keylog_file.has_value()) {
+        EVLOG_info << "Logging TLS secrets to: " << this->connection_options.keylog_file.value().string();
+        keylog_file = this->connection_options.keylog_file;
+        SSL_CTX_set_keylog_callback(ssl_ctx.get(), keylog_callback);
+    }
+
+    // Init TLS data
+    const bool tls_initialized = tls_init(ssl_ctx.get(), path_chain, path_key, private_key_password);
+
+    // The password is only required while loading the key, the context outlives it
+    SSL_CTX_set_default_passwd_cb_userdata(ssl_ctx.get(), nullptr);
+
+    if (!tls_initialized) {
+        EVLOG_error << "Unable to init tls security options for websocket";
+        return nullptr;
+    }
+
+    if (this->connection_options.enable_tls_session_resumption) {
+        // Keep the sessions (TLS 1.2 session ids and TLS 1.3 tickets) ourselves, OpenSSL never looks up
+        // client sessions in its internal cache
+        SSL_CTX_set_session_cache_mode(ssl_ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ssl_ctx.get(), new_session_callback);
+        SSL_CTX_set_info_callback(ssl_ctx.get(), info_callback);
+        SSL_CTX_set_app_data(ssl_ctx.get(), this);
+    }
+
+    EVLOG_debug << "Created new TLS context";
+    return ssl_ctx;
+}
+
+void WebsocketLibwebsockets::invalidate_tls_context() {
+    const std::lock_guard<std::mutex> lock(this->tls_context_mutex);
+    this->tls_context.reset();
+    this->tls_session.reset();
+}
+
+bool WebsocketLibwebsockets::on_tls_session_created(SSL_SESSION* session) {
+    // Called on the websocket client thread
+    if (SSL_SESSION_is_resumable(session) == 0) {
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->tls_context_mutex);
+    this->tls_session = std::shared_ptr<SSL_SESSION>(session, [](SSL_SESSION* ptr) { ::SSL_SESSION_free(ptr); });
+    return true;
+}
+
+void WebsocketLibwebsockets::on_tls_handshake_start(SSL* ssl) {
+    // Called on the websocket client thread
+    const std::lock_guard<std::mutex> lock(this->tls_context_mutex);
+    if (this->tls_session == nullptr) {
+        return;
+    }
+
+    if (SSL_set_session(ssl, this->tls_session.get()) == 1) {
+        EVLOG_debug << "Attempting to resume TLS session";
+    }
+}
+
+WebsocketTrafficCounters WebsocketLibwebsockets::get_traffic_counters() {
+    WebsocketTrafficCounters counters;
+    counters.messages_sent = this->messages_sent;
+    counters.payload_bytes_sent = this->payload_bytes_sent;
+    counters.deflate_input_bytes_sent = this->deflate_input_bytes_sent;
+    counters.deflate_output_bytes_sent = this->deflate_output_bytes_sent;
+    counters.messages_received = this->messages_received;
+    counters.payload_bytes_received = this->payload_bytes_received;
+    counters.inflate_input_bytes_received = this->inflate_input_bytes_received;
+    counters.inflate_output_bytes_received = this->inflate_output_bytes_received;
+    return counters;
+}
+
+void WebsocketLibwebsockets::on_message_deflated(std::size_t output_bytes) {
+    // Called on the websocket client thread
+    this->deflate_output_bytes_sent += output_bytes;
+}
+
+void WebsocketLibwebsockets::on_message_inflated(std::size_t input_bytes, std::size_t output_bytes) {
+    // Called on the websocket client thread
+    this->inflate_input_bytes_received += input_bytes;
+    this->inflate_output_bytes_received += output_bytes;
+}
+
 bool WebsocketLibwebsockets::initialize_connection_options(std::shared_ptr<ConnectionData>& new_connection_data) {
     // lws_set_log_level(LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_INFO | LLL_DEBUG | LLL_PARSER | LLL_HEADER | LLL_EXT |
     //                          LLL_CLIENT | LLL_LATENCY | LLL_THREAD | LLL_USER, nullptr);
@@ -616,6 +905,22 @@ bool WebsocketLibwebsockets::initialize_connection_options(std::shared_ptr<Conne
     info.port = CONTEXT_PORT_NO_LISTEN; /* we do not run any server */
     info.protocols = protocols.data();
 
+    if (this->connection_options.enable_permessage_deflate) {
+#if defined(LWS_WITHOUT_EXTENSIONS)
+        EVLOG_warning << "permessage-deflate requested but libwebsockets was built without extension support";
+#else
+        new_connection_data->deflate_offer =
+            std::string(permessage_deflate_name) + "; client_max_window_bits=" +
+            std::to_string(this->connection_options.permessage_deflate_client_max_window_bits) +
+            "; server_max_window_bits=" +
+            std::to_string(this->connection_options.permessage_deflate_server_max_window_bits);
+        new_connection_data->extensions[0] = {permessage_deflate_name, permessage_deflate_callback,
+                                              new_connection_data->deflate_offer.c_str()};
+        new_connection_data->extensions[1] = {nullptr, nullptr, nullptr};
+        info.extensions = new_connection_data->extensions.data();
+#endif
+    }
+
     if (this->connection_options.iface.has_value()) {
         EVLOG_info << "Using network iface: " << this->connection_options.iface.value().c_str();
 
@@ -628,64 +933,16 @@ bool WebsocketLibwebsockets::initialize_connection_options(std::shared_ptr<Conne
 
     info.fd_limit_per_thread = 1 + 1 + 1;
 
-    // Lifetime of this is important since we use the data from this in private_key_callback()
-    std::optional<std::string> private_key_password;
-    SSL_CTX* ssl_ctx = nullptr;
+    std::shared_ptr<SSL_CTX> ssl_ctx;
 
     if (this->connection_options.security_profile == 2 || this->connection_options.security_profile == 3) {
-        // Setup context - need to know the key type first
-        std::string path_key;
-        std::string path_chain;
-
-        if (this->connection_options.security_profile == 3) {
-            const auto certificate_response =
-                this->evse_security->get_leaf_certificate_info(CertificateSigningUseEnum::ChargingStationCertificate);
-
-            if (certificate_response.status != ocpp::GetCertificateInfoStatus::Accepted or
-                !certificate_response.info.has_value()) {
-                EVLOG_error << "Connecting with security profile 3 but no client side certificate is present or valid";
-                return false;
-            }
-
-            const auto& certificate_info = certificate_response.info.value();
-
-            if (certificate_info.certificate_path.has_value()) {
-                path_chain = certificate_info.certificate_path.value();
-            } else if (certificate_info.certificate_single_path.has_value()) {
-                path_chain = certificate_info.certificate_single_path.value();
-            } else {
-                EVLOG_error << "Connecting with security profile 3 but no client side certificate is present or valid";
-                return false;
-            }
-
-            path_key = certificate_info.key_path;
-            private_key_password = certificate_info.password;
-        }
-
-        OpenSSLProvider provider;
-        const SSL_METHOD* method = SSLv23_client_method();
-        ssl_ctx = SSL_CTX_new_ex(provider, provider.propquery_default(), method);
-
+        ssl_ctx = get_tls_context();
         if (ssl_ctx == nullptr) {
-            ERR_print_errors_fp(stderr);
-            EVLOG_error << "Unable to create ssl context";
-            return false;
-        }
-
-        if (this->connection_options.enable_tls_keylog and this->connection_options.keylog_file.has_value()) {
-            EVLOG_info << "Logging TLS secrets to: " << this->connection_options.keylog_file.value().string();
-            keylog_file = this->connection_options.keylog_file;
-            SSL_CTX_set_keylog_callback(ssl_ctx, keylog_callback);
-        }
-
-        // Init TLS data
-        if (!tls_init(ssl_ctx, path_chain, path_key, private_key_password)) {
-            EVLOG_error << "Unable to init tls security options for websocket";
             return false;
         }
 
         // Setup our context
-        info.provided_client_ssl_ctx = ssl_ctx;
+        info.provided_client_ssl_ctx = ssl_ctx.get();
     }
 
     lws_context* lws_ctx = lws_create_context(&info);
@@ -695,7 +952,7 @@ bool WebsocketLibwebsockets::initialize_connection_options(std::shared_ptr<Conne
     }
 
     // Conn acquire the lws context and security context
-    new_connection_data->init_connection_context(lws_ctx, ssl_ctx);
+    new_connection_data->init_connection_context(lws_ctx, std::move(ssl_ctx));
     return true;
 }
 
@@ -1060,7 +1317,8 @@ void WebsocketLibwebsockets::reconnect(long delay) {
 }
 
 namespace {
-bool send_internal(lws* wsi, WebsocketMessage* msg) {
+bool send_internal(ConnectionData* data, WebsocketMessage* msg, const std::size_t deflate_threshold_bytes) {
+    lws* wsi = data->get_conn();
     static std::vector<char> buff;
 
     std::string& message = msg->payload;
@@ -1084,9 +1342,14 @@ bool send_internal(lws* wsi, WebsocketMessage* msg) {
     // int flags = lws_write_ws_flags(proto, is_start, is_end);
     // already_written += lws_write(wsi, buff + LWS_PRE, BUFF_SIZE - LWS_PRE, flags);
 
+    // Small messages gain nothing from compression, the extension callback sends them as they are
+    data->deflate_bypass = (message_len < deflate_threshold_bytes);
+
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast): needed for appropriate type
     auto sent = lws_write(wsi, reinterpret_cast<unsigned char*>(&buff[LWS_PRE]), message_len, msg->protocol);
 
+    data->deflate_bypass = false;
+
     if (sent < 0) {
         // Fatal error, conn closed
         EVLOG_error << "Error sending message, conn closed.";
@@ -1392,6 +1655,8 @@ int WebsocketLibwebsockets::process_callback(void* wsi_ptr, int callback_reason,
 
         // Message is complete
         if (lws_remaining_packet_payload(wsi) <= 0) {
+            this->messages_received++;
+            this->payload_bytes_received += recv_buffered_message.size();
             on_conn_message(std::move(recv_buffered_message));
             recv_buffered_message.clear();
         }
@@ -1591,6 +1856,13 @@ void WebsocketLibwebsockets::on_conn_fail(ConnectionData* /*conn_data*/) {
     // Called on the websocket client thread
     EVLOG_error << "OCPP client connection to server failed";
 
+    if (!this->m_is_connected) {
+        // We could not establish a connection with the cached TLS context, it might be outdated (for example
+        // the CSMS root certificates changed) so rebuild it on the next attempt. The session is kept
+        const std::lock_guard<std::mutex> lock(this->tls_context_mutex);
+        this->tls_context.reset();
+    }
+
     if (this->m_is_connected) {
         this->push_deferred_callback([this]() {
             if (this->disconnected_callback) {
@@ -1689,7 +1961,17 @@ void WebsocketLibwebsockets::on_conn_writable() {
         }
 
         // Continue sending message part, for a single message only
-        const bool sent = send_internal(local_data->get_conn(), message.get());
+        const bool sent = send_internal(local_data.get(), message.get(),
+                                        this->connection_options.permessage_deflate_threshold_bytes);
+
+        if (sent and message->protocol == LWS_WRITE_TEXT) {
+            this->messages_sent++;
+            this->payload_bytes_sent += message->payload.length();
+            if (local_data->deflate_negotiated and
+                message->payload.length() >= this->connection_options.permessage_deflate_threshold_bytes) {
+                this->deflate_input_bytes_sent += message->payload.length();
+            }
+        }
 
         // If we failed, attempt again later
         if (!sent) {
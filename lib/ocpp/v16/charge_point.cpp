@@ -13,10 +13,11 @@ namespace v16 {
 ChargePoint::ChargePoint(const std::string& config, const fs::path& share_path, const fs::path& user_config_path,
                          const fs::path& database_path, const fs::path& sql_init_path, const fs::path& message_log_path,
                          const std::shared_ptr<EvseSecurity> evse_security,
-                         const std::optional<SecurityConfiguration> security_configuration) {
+                         const std::optional<SecurityConfiguration> security_configuration,
+                         std::shared_ptr<Executor> executor) {
     this->charge_point =
         std::make_unique<ChargePointImpl>(config, share_path, user_config_path, database_path, sql_init_path,
-                                          message_log_path, evse_security, security_configuration);
+                                          message_log_path, evse_security, security_configuration, executor);
 }
 
 ChargePoint::~ChargePoint() = default;
@@ -104,6 +105,15 @@ ChargePoint::get_all_enhanced_composite_charging_schedules(const std::int32_t du
     return this->charge_point->get_all_enhanced_composite_charging_schedules(duration_s, unit);
 }
 
+void ChargePoint::subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                           const LimitsChangedCallback& callback) {
+    this->charge_point->subscribe_limits_changed(duration_s, unit, callback);
+}
+
+void ChargePoint::unsubscribe_limits_changed() {
+    this->charge_point->unsubscribe_limits_changed();
+}
+
 void ChargePoint::on_meter_values(std::int32_t connector, const Measurement& measurement) {
     this->charge_point->on_meter_values(connector, measurement);
 }
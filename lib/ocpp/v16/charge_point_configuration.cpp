@@ -1171,6 +1171,27 @@ std::optional<std::string> ChargePointConfiguration::getIFace() {
     return iFace_key;
 }
 
+std::optional<bool> ChargePointConfiguration::getCompactDatabaseEncoding() {
+    std::optional<bool> compact_database_encoding = std::nullopt;
+    if (this->config["Internal"].contains("CompactDatabaseEncoding")) {
+        compact_database_encoding.emplace(this->config["Internal"]["CompactDatabaseEncoding"]);
+    }
+    return compact_database_encoding;
+}
+
+std::optional<KeyValue> ChargePointConfiguration::getCompactDatabaseEncodingKeyValue() {
+    std::optional<KeyValue> compact_database_encoding_kv = std::nullopt;
+    auto compact_database_encoding = this->getCompactDatabaseEncoding();
+    if (compact_database_encoding.has_value()) {
+        KeyValue kv;
+        kv.key = "CompactDatabaseEncoding";
+        kv.readonly = true;
+        kv.value.emplace(ocpp::conversions::bool_to_string(compact_database_encoding.value()));
+        compact_database_encoding_kv.emplace(kv);
+    }
+    return compact_database_encoding_kv;
+}
+
 std::optional<bool> ChargePointConfiguration::getQueueAllMessages() {
     std::optional<bool> queue_all_messages = std::nullopt;
     if (this->config["Internal"].contains("QueueAllMessages")) {
@@ -3508,6 +3529,9 @@ std::optional<KeyValue> ChargePointConfiguration::get(CiString<50> key) {
     if (key == "MaxMessageSize") {
         return this->getMaxMessageSizeKeyValue();
     }
+    if (key == "CompactDatabaseEncoding") {
+        return this->getCompactDatabaseEncodingKeyValue();
+    }
     if (key == "QueueAllMessages") {
         return this->getQueueAllMessagesKeyValue();
     }
@@ -40,8 +40,9 @@ ChargePointImpl::ChargePointImpl(const std::string& config, const fs::path& shar
                                  const fs::path& user_config_path, const fs::path& database_path,
                                  const fs::path& sql_init_path, const fs::path& message_log_path,
                                  const std::shared_ptr<EvseSecurity> evse_security,
-                                 const std::optional<SecurityConfiguration> security_configuration) :
-    ocpp::ChargingStationBase(evse_security, security_configuration),
+                                 const std::optional<SecurityConfiguration> security_configuration,
+                                 std::shared_ptr<Executor> executor) :
+    ocpp::ChargingStationBase(evse_security, security_configuration, executor),
     bootreason(BootReasonEnum::PowerUp),
     initialized(false),
     InvalidCSMSCertificate_logged(false),
@@ -51,6 +52,7 @@ ChargePointImpl::ChargePointImpl(const std::string& config, const fs::path& shar
     firmware_status(FirmwareStatus::Idle),
     log_status(UploadLogStatusEnumType::Idle),
     message_log_path(message_log_path.string()), // .string() for compatibility with boost::filesystem
+    websocket_timer(&this->io_context),
     switch_security_profile_callback(nullptr) {
     this->configuration = std::make_shared<ocpp::v16::ChargePointConfiguration>(config, share_path, user_config_path);
     this->heartbeat_timer = std::make_unique<Everest::SteadyTimer>(&this->io_context, [this]() { this->heartbeat(); });
@@ -60,6 +62,7 @@ ChargePointImpl::ChargePointImpl(const std::string& config, const fs::path& shar
     this->database_handler = std::make_shared<DatabaseHandler>(std::move(database_connection), sql_init_path,
                                                                this->configuration->getNumberOfConnectors());
     this->database_handler->open_connection();
+    this->database_handler->set_compact_encoding(this->configuration->getCompactDatabaseEncoding().value_or(false));
     this->transaction_handler = std::make_unique<TransactionHandler>(this->configuration->getNumberOfConnectors());
     this->external_notify = {v16::MessageType::StartTransactionResponse};
     this->message_queue = this->create_message_queue();
@@ -179,7 +182,8 @@ ChargePointImpl::ChargePointImpl(const std::string& config, const fs::path& shar
     }
 
     this->smart_charging_handler =
-        std::make_unique<SmartChargingHandler>(this->connectors, this->database_handler, *this->configuration);
+        std::make_unique<SmartChargingHandler>(this->connectors, this->database_handler, *this->configuration,
+                                               this->executor);
     this->load_charging_profiles();
 
     // ISO15118 PnC handlers
@@ -239,6 +243,22 @@ ChargePointImpl::ChargePointImpl(const std::string& config, const fs::path& shar
     }
 }
 
+ChargePointImpl::~ChargePointImpl() {
+    // The timer handlers access the members of the charge point, so none of them may run while they are destroyed
+    this->stop_timers_on_executor([this]() {
+        this->stop_timers();
+        for (const auto& timer : this->status_notification_timers) {
+            timer->stop();
+        }
+        for (const auto& [id, connector] : this->connectors) {
+            const auto transaction = this->transaction_handler->get_transaction(id);
+            if (transaction != nullptr) {
+                transaction->stop();
+            }
+        }
+    });
+}
+
 std::unique_ptr<ocpp::MessageQueue<v16::MessageType>> ChargePointImpl::create_message_queue() {
 
     // The StartTransaction.conf handler attempts to get the transaction based on the message id. The message id changes
@@ -286,14 +306,15 @@ std::unique_ptr<ocpp::MessageQueue<v16::MessageType>> ChargePointImpl::create_me
             this->configuration->getTransactionMessageRetryInterval(),
             this->configuration->getMessageQueueSizeThreshold().value_or(DEFAULT_MESSAGE_QUEUE_SIZE_THRESHOLD),
             this->configuration->getQueueAllMessages().value_or(false), message_types_discard_for_queueing},
-        this->external_notify, this->database_handler, start_transaction_message_retry_callback);
+        this->external_notify, this->database_handler, start_transaction_message_retry_callback, this->executor);
 }
 
 void ChargePointImpl::init_websocket() {
 
     auto connection_options = this->get_ws_connection_options();
 
-    this->websocket = std::make_unique<Websocket>(connection_options, this->evse_security, this->logging);
+    this->websocket =
+        std::make_unique<Websocket>(connection_options, this->evse_security, this->logging, this->executor);
     this->websocket->register_connected_callback([this](OcppProtocolVersion /*protocol*/) {
         if (this->connection_state_changed_callback != nullptr) {
             this->connection_state_changed_callback(true);
@@ -311,6 +332,7 @@ void ChargePointImpl::init_websocket() {
             not this->configuration->getIgnoredProfilePurposesOffline().empty()) {
             this->signal_set_charging_profiles_callback();
         }
+        this->smart_charging_handler->notify_limits_changed();
         // Reupdate ws connection options once connected so that after upgrading security profile we use the real config
         // values. Prior we would continue using only 1 connection attempt
         auto connection_options = this->get_ws_connection_options();
@@ -336,6 +358,7 @@ void ChargePointImpl::init_websocket() {
             not this->configuration->getIgnoredProfilePurposesOffline().empty()) {
             this->signal_set_charging_profiles_callback();
         }
+        this->smart_charging_handler->notify_limits_changed();
     });
     this->websocket->register_stopped_connecting_callback([this](const WebsocketCloseReason /*reason*/) {
         if (this->switch_security_profile_callback != nullptr) {
@@ -601,6 +624,7 @@ void ChargePointImpl::load_charging_profiles() {
     } catch (const std::exception& e) {
         EVLOG_warning << "Unknown error while loading charging profiles from database: " << e.what();
     }
+    this->smart_charging_handler->notify_limits_changed();
 }
 
 std::optional<MeterValue> ChargePointImpl::get_latest_meter_value(std::int32_t connector,
@@ -1257,38 +1281,42 @@ void ChargePointImpl::stop_all_transactions(Reason reason) {
     }
 }
 
-bool ChargePointImpl::stop() {
-    if (!this->stopped) {
-        EVLOG_info << "Stopping OCPP Chargepoint";
-        if (this->boot_notification_timer != nullptr) {
-            this->boot_notification_timer->stop();
-        }
-        if (this->heartbeat_timer != nullptr) {
-            this->heartbeat_timer->stop();
-        }
-        if (this->clock_aligned_meter_values_timer != nullptr) {
-            this->clock_aligned_meter_values_timer->stop();
-        }
-        if (this->ocsp_request_timer != nullptr) {
-            this->ocsp_request_timer->stop();
-        }
-        if (this->client_certificate_timer != nullptr) {
-            this->client_certificate_timer->stop();
-        }
-        if (this->v2g_certificate_timer != nullptr) {
-            this->v2g_certificate_timer->stop();
-        }
-        if (this->change_time_offset_timer != nullptr) {
-            this->change_time_offset_timer->stop();
-        }
+void ChargePointImpl::stop_timers() {
+    if (this->boot_notification_timer != nullptr) {
+        this->boot_notification_timer->stop();
+    }
+    if (this->heartbeat_timer != nullptr) {
+        this->heartbeat_timer->stop();
+    }
+    if (this->clock_aligned_meter_values_timer != nullptr) {
+        this->clock_aligned_meter_values_timer->stop();
+    }
+    if (this->ocsp_request_timer != nullptr) {
+        this->ocsp_request_timer->stop();
+    }
+    if (this->client_certificate_timer != nullptr) {
+        this->client_certificate_timer->stop();
+    }
+    if (this->v2g_certificate_timer != nullptr) {
+        this->v2g_certificate_timer->stop();
+    }
+    if (this->change_time_offset_timer != nullptr) {
+        this->change_time_offset_timer->stop();
+    }
 
-        for (const auto& [id, connector] : this->connectors) {
-            if (connector->trigger_metervalue_at_time_timer != nullptr) {
-                connector->trigger_metervalue_at_time_timer->stop();
-            }
+    for (const auto& [id, connector] : this->connectors) {
+        if (connector->trigger_metervalue_at_time_timer != nullptr) {
+            connector->trigger_metervalue_at_time_timer->stop();
         }
+    }
 
-        this->websocket_timer.stop();
+    this->websocket_timer.stop();
+}
+
+bool ChargePointImpl::stop() {
+    if (!this->stopped) {
+        EVLOG_info << "Stopping OCPP Chargepoint";
+        this->stop_timers();
 
         this->stop_all_transactions();
 
@@ -1366,7 +1394,7 @@ void ChargePointImpl::message_callback(const std::string& message) {
         return;
     }
 
-    auto json_message = enhanced_message.message;
+    const auto& json_message = *enhanced_message.message;
     this->logging->central_system(conversions::messagetype_to_string(enhanced_message.messageType), message);
     try {
         // reject unsupported messages
@@ -1480,7 +1508,7 @@ void ChargePointImpl::message_callback(const std::string& message) {
 }
 
 void ChargePointImpl::handle_message(const EnhancedMessage<v16::MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
     // lots of messages are allowed here
     switch (message.messageType) {
 
@@ -2212,6 +2240,7 @@ void ChargePointImpl::handleRemoteStartTransactionRequest(ocpp::Call<RemoteStart
                 this->configuration->getChargingScheduleAllowedChargingRateUnitVector())) {
             this->smart_charging_handler->add_tx_profile(call.msg.chargingProfile.value(),
                                                          call.msg.connectorId.value());
+            this->smart_charging_handler->notify_limits_changed();
         } else {
             response.status = RemoteStartStopStatus::Rejected;
             const ocpp::CallResult<RemoteStartTransactionResponse> call_result(response, call.uniqueId);
@@ -2392,8 +2421,8 @@ void ChargePointImpl::handleStartTransactionResponse(ocpp::CallResult<StartTrans
 
 void ChargePointImpl::handleStopTransactionResponse(const EnhancedMessage<v16::MessageType>& message) {
 
-    const CallResult<StopTransactionResponse> call_result = message.message;
-    const Call<StopTransactionRequest>& original_call = message.call_message;
+    const CallResult<StopTransactionResponse> call_result = *message.message;
+    const Call<StopTransactionRequest> original_call = *message.call_message;
 
     StopTransactionResponse stop_transaction_response = call_result.msg;
     const auto transaction = this->transaction_handler->get_transaction(call_result.uniqueId);
@@ -2513,6 +2542,7 @@ void ChargePointImpl::handleSetChargingProfileRequest(ocpp::Call<SetChargingProf
     this->message_dispatcher->dispatch_call_result(call_result);
 
     if (response.status == ChargingProfileStatus::Accepted) {
+        this->smart_charging_handler->notify_limits_changed();
         if (this->signal_set_charging_profiles_callback != nullptr) {
             this->signal_set_charging_profiles_callback();
         } else {
@@ -2585,9 +2615,11 @@ void ChargePointImpl::handleClearChargingProfileRequest(ocpp::Call<ClearCharging
     const ocpp::CallResult<ClearChargingProfileResponse> call_result(response, call.uniqueId);
     this->message_dispatcher->dispatch_call_result(call_result);
 
-    if (response.status == ClearChargingProfileStatus::Accepted and
-        this->signal_set_charging_profiles_callback != nullptr) {
-        this->signal_set_charging_profiles_callback();
+    if (response.status == ClearChargingProfileStatus::Accepted) {
+        this->smart_charging_handler->notify_limits_changed();
+        if (this->signal_set_charging_profiles_callback != nullptr) {
+            this->signal_set_charging_profiles_callback();
+        }
     }
 }
 
@@ -2899,6 +2931,7 @@ void ChargePointImpl::handleCertificateSignedRequest(ocpp::Call<CertificateSigne
     // reconnect with new certificate if valid and security profile is 3
     if (response.status == CertificateSignedStatusEnumType::Accepted &&
         this->configuration->getSecurityProfile() == 3) {
+        this->websocket->invalidate_tls_context();
         this->websocket->reconnect(1000);
     }
 }
@@ -2944,6 +2977,9 @@ void ChargePointImpl::handleDeleteCertificateRequest(ocpp::Call<DeleteCertificat
     const ocpp::CertificateHashDataType certificate_hash_data(json(call.msg.certificateHashData));
 
     const auto result = this->evse_security->delete_certificate(certificate_hash_data);
+    if (result == ocpp::DeleteCertificateResult::Accepted) {
+        this->contract_certificate_cache->clear();
+    }
 
     response.status = conversions::string_to_delete_certificate_status_enum_type(
         ocpp::conversions::delete_certificate_result_to_string(result));
@@ -2966,6 +3002,7 @@ void ChargePointImpl::handleInstallCertificateRequest(ocpp::Call<InstallCertific
     const auto result = this->evse_security->install_ca_certificate(call.msg.certificate.get(), ca_certificate_type);
 
     if (result == ocpp::InstallCertificateResult::Accepted) {
+        this->contract_certificate_cache->clear();
         response.status = InstallCertificateStatusEnumType::Accepted;
     } else if (result == ocpp::InstallCertificateResult::WriteError) {
         response.status = InstallCertificateStatusEnumType::Failed;
@@ -3565,7 +3602,7 @@ EnhancedIdTagInfo ChargePointImpl::authorize_id_token(CiString<20> id_token, con
 
     if (enhanced_message.messageType == MessageType::AuthorizeResponse) {
         try {
-            const ocpp::CallResult<AuthorizeResponse> call_result = enhanced_message.message;
+            const ocpp::CallResult<AuthorizeResponse> call_result = *enhanced_message.message;
             this->database_handler->insert_or_update_authorization_cache_entry(id_token, call_result.msg.idTagInfo);
             enhanced_id_tag_info.id_tag_info = call_result.msg.idTagInfo;
 
@@ -3663,6 +3700,17 @@ ChargePointImpl::get_all_enhanced_composite_charging_schedules(const std::int32_
     return charging_schedules;
 }
 
+void ChargePointImpl::subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                               const LimitsChangedCallback& callback) {
+    this->smart_charging_handler->subscribe_limits_changed(
+        duration_s, unit, [this]() { return this->connection_state != ChargePointConnectionState::Booted; },
+        callback);
+}
+
+void ChargePointImpl::unsubscribe_limits_changed() {
+    this->smart_charging_handler->unsubscribe_limits_changed();
+}
+
 bool ChargePointImpl::is_pnc_enabled() {
     return (this->configuration->getSupportedFeatureProfilesSet().count(SupportedFeatureProfiles::PnC) != 0) and
            this->configuration->getISO15118PnCEnabled();
@@ -3707,7 +3755,7 @@ ocpp::v2::AuthorizeResponse ChargePointImpl::data_transfer_pnc_authorize(
         forward_to_csms = true;
     } else if (certificate.has_value()) {
         // First try to validate the contract certificate locally
-        const CertificateValidationResult local_verify_result = this->evse_security->verify_certificate(
+        const CertificateValidationResult local_verify_result = this->contract_certificate_cache->verify_certificate(
             certificate.value(), {ocpp::LeafCertificateType::MO, ocpp::LeafCertificateType::V2G});
         EVLOG_info << "Local contract validation result: " << local_verify_result;
         const auto central_contract_validation_allowed =
@@ -3731,7 +3779,7 @@ ocpp::v2::AuthorizeResponse ChargePointImpl::data_transfer_pnc_authorize(
             } else {
                 // Try to generate the OCSP data from the certificate chain and use that
                 const auto generated_ocsp_request_data_list = ocpp::evse_security_conversions::to_ocpp_v2(
-                    this->evse_security->get_mo_ocsp_request_data(certificate.value()));
+                    this->contract_certificate_cache->get_mo_ocsp_request_data(certificate.value()));
                 if (!generated_ocsp_request_data_list.empty()) {
                     EVLOG_info << "Online: Pass generated OCSP data to CSMS";
                     authorize_req.iso15118CertificateHashData = generated_ocsp_request_data_list;
@@ -3811,7 +3859,7 @@ ocpp::v2::AuthorizeResponse ChargePointImpl::data_transfer_pnc_authorize(
         if (enhanced_message.messageType == MessageType::DataTransferResponse) {
             try {
                 // parse and return authorize response
-                ocpp::CallResult<DataTransferResponse> call_result = enhanced_message.message;
+                ocpp::CallResult<DataTransferResponse> call_result = *enhanced_message.message;
                 if (call_result.msg.data.has_value()) {
                     authorize_response = json::parse(call_result.msg.data.value());
                 } else {
@@ -3919,7 +3967,7 @@ void ChargePointImpl::data_transfer_pnc_get_15118_ev_certificate(
     if (enhanced_message.messageType == MessageType::DataTransferResponse) {
         // parse and return authorize response
         try {
-            ocpp::CallResult<DataTransferResponse> call_result = enhanced_message.message;
+            ocpp::CallResult<DataTransferResponse> call_result = *enhanced_message.message;
             if (call_result.msg.data.has_value() and call_result.msg.status == DataTransferStatus::Accepted) {
                 const ocpp::v2::Get15118EVCertificateResponse ev_certificate_response =
                     json::parse(call_result.msg.data.value());
@@ -3968,7 +4016,7 @@ void ChargePointImpl::data_transfer_pnc_get_certificate_status(const ocpp::v2::O
 
     if (enhanced_message.messageType == MessageType::DataTransferResponse) {
         try {
-            ocpp::CallResult<DataTransferResponse> call_result = enhanced_message.message;
+            ocpp::CallResult<DataTransferResponse> call_result = *enhanced_message.message;
             if (call_result.msg.data.has_value()) {
                 ocpp::v2::GetCertificateStatusResponse cert_status_response = json::parse(call_result.msg.data.value());
                 if (cert_status_response.status == ocpp::v2::GetCertificateStatusEnum::Accepted) {
@@ -4165,8 +4213,11 @@ void ChargePointImpl::handle_data_transfer_delete_certificate(Call<DataTransferR
             ocpp::v2::DeleteCertificateResponse delete_cert_response;
             const ocpp::CertificateHashDataType certificate_hash_data(json(req.certificateHashData));
 
-            delete_cert_response.status = ocpp::evse_security_conversions::to_ocpp_v2(
-                this->evse_security->delete_certificate(certificate_hash_data));
+            const auto result = this->evse_security->delete_certificate(certificate_hash_data);
+            if (result == ocpp::DeleteCertificateResult::Accepted) {
+                this->contract_certificate_cache->clear();
+            }
+            delete_cert_response.status = ocpp::evse_security_conversions::to_ocpp_v2(result);
 
             response.data.emplace(json(delete_cert_response).dump());
         } catch (const json::exception& e) {
@@ -4194,6 +4245,9 @@ void ChargePointImpl::handle_data_transfer_install_certificate(Call<DataTransfer
             const ocpp::CaCertificateType ca_certificate_type =
                 evse_security_conversions::from_ocpp_v2(req.certificateType);
             const auto result = this->evse_security->install_ca_certificate(req.certificate.get(), ca_certificate_type);
+            if (result == ocpp::InstallCertificateResult::Accepted) {
+                this->contract_certificate_cache->clear();
+            }
             ocpp::v2::InstallCertificateResponse install_cert_response;
             install_cert_response.status = ocpp::evse_security_conversions::to_ocpp_v2(result);
             response.data.emplace(json(install_cert_response).dump());
@@ -4238,7 +4292,7 @@ std::optional<DataTransferResponse> ChargePointImpl::data_transfer(const CiStrin
     auto enhanced_message = data_transfer_future.get();
     if (enhanced_message.messageType == MessageType::DataTransferResponse) {
         try {
-            const ocpp::CallResult<DataTransferResponse> call_result = enhanced_message.message;
+            const ocpp::CallResult<DataTransferResponse> call_result = *enhanced_message.message;
             response = call_result.msg;
         } catch (json::exception& e) {
             EVLOG_warning << "Could not parse DataTransfer.conf message from CSMS";
@@ -4451,8 +4505,11 @@ void ChargePointImpl::on_transaction_stopped(const std::int32_t connector, const
 
     const auto profile_cleared = this->smart_charging_handler->clear_all_profiles_with_filter(
         std::nullopt, connector, std::nullopt, ChargingProfilePurposeType::TxProfile, false);
-    if (profile_cleared and this->signal_set_charging_profiles_callback != nullptr) {
-        this->signal_set_charging_profiles_callback();
+    if (profile_cleared) {
+        this->smart_charging_handler->notify_limits_changed();
+        if (this->signal_set_charging_profiles_callback != nullptr) {
+            this->signal_set_charging_profiles_callback();
+        }
     }
     reset_pricing_triggers(connector);
 }
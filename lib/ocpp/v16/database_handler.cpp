@@ -3,6 +3,7 @@
 
 #include <everest/logging.hpp>
 
+#include <ocpp/common/compact_encoding.hpp>
 #include <ocpp/v16/database_handler.hpp>
 
 using namespace everest::db;
@@ -17,7 +18,12 @@ namespace v16 {
 DatabaseHandler::DatabaseHandler(std::unique_ptr<ConnectionInterface> database,
                                  const fs::path& sql_migration_files_path, std::int32_t number_of_connectors) :
     DatabaseHandlerCommon(std::move(database), sql_migration_files_path, MIGRATION_FILE_VERSION_V16),
-    number_of_connectors(number_of_connectors) {
+    number_of_connectors(number_of_connectors),
+    use_compact_encoding(false) {
+}
+
+void DatabaseHandler::set_compact_encoding(bool enabled) {
+    this->use_compact_encoding = enabled;
 }
 
 void DatabaseHandler::init_sql() {
@@ -531,9 +537,7 @@ void DatabaseHandler::insert_or_update_charging_profile(const int connector_id,
     //     and Purpose that already exists in the Charge Point, the Charge Point
     //     SHALL replace the existing profile.
 
-    std::string sql = "DELETE FROM CHARGING_PROFILES WHERE "
-                      "Json_extract(PROFILE, '$.stackLevel') = @level AND "
-                      "Json_extract(PROFILE, '$.chargingProfilePurpose') = @purpose";
+    std::string sql = "DELETE FROM CHARGING_PROFILES WHERE STACK_LEVEL = @level AND CHARGING_PROFILE_PURPOSE = @purpose";
     auto stmt = this->database->new_statement(sql);
 
     const std::string purpose =
@@ -547,15 +551,21 @@ void DatabaseHandler::insert_or_update_charging_profile(const int connector_id,
     }
 
     // add or replace
-    sql = "INSERT OR REPLACE INTO CHARGING_PROFILES (ID, CONNECTOR_ID, PROFILE) VALUES "
-          "(@id, @connector_id, @profile)";
+    sql = "INSERT OR REPLACE INTO CHARGING_PROFILES (ID, CONNECTOR_ID, STACK_LEVEL, CHARGING_PROFILE_PURPOSE, PROFILE) "
+          "VALUES (@id, @connector_id, @level, @purpose, @profile)";
     stmt = this->database->new_statement(sql);
 
     const json json_profile(profile);
 
     stmt->bind_int("@id", profile.chargingProfileId);
     stmt->bind_int("@connector_id", connector_id);
-    stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
+    stmt->bind_int("@level", profile.stackLevel);
+    stmt->bind_text("@purpose", purpose, SQLiteString::Transient);
+    if (this->use_compact_encoding) {
+        stmt->bind_text("@profile", compact_encoding::encode_charging_profile(json_profile), SQLiteString::Transient);
+    } else {
+        stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
+    }
 
     if (stmt->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
@@ -582,12 +592,23 @@ void DatabaseHandler::delete_charging_profiles() {
 std::vector<v16::ChargingProfile> DatabaseHandler::get_charging_profiles() {
 
     std::vector<v16::ChargingProfile> profiles;
-    const std::string sql = "SELECT * FROM CHARGING_PROFILES";
+    const std::string sql = "SELECT PROFILE FROM CHARGING_PROFILES";
     auto stmt = this->database->new_statement(sql);
 
     int status = SQLITE_ERROR;
     while ((status = stmt->step()) == SQLITE_ROW) {
-        profiles.emplace_back(json::parse(stmt->column_text(2)));
+        auto decoded = compact_encoding::decode_charging_profile(stmt->column_text(0));
+        v16::ChargingProfile profile = decoded.profile;
+        if (!decoded.schedule_periods.empty() and decoded.schedule_periods.at(0).has_value()) {
+            for (const auto& period : decoded.schedule_periods.at(0).value()) {
+                if (!period.limit.has_value()) {
+                    throw compact_encoding::DecodeException("Charging schedule period without limit");
+                }
+                profile.chargingSchedule.chargingSchedulePeriod.push_back(
+                    {period.start_period, period.limit.value(), period.number_phases});
+            }
+        }
+        profiles.push_back(std::move(profile));
     }
 
     if (status != SQLITE_DONE) {
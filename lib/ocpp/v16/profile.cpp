@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <limits>
 #include <optional>
+#include <queue>
 
 #include <ocpp/common/constants.hpp>
 #include <ocpp/common/types.hpp>
@@ -484,9 +487,74 @@ IntermediateProfile generate_profile_from_periods(std::vector<period_entry_t>& p
 namespace {
 
 using period_iterator = IntermediateProfile::const_iterator;
-using period_pair_vector = std::vector<std::pair<period_iterator, period_iterator>>;
 using IntermediateProfileRef = std::reference_wrapper<const IntermediateProfile>;
 
+/// \brief Marks an unset number of phases in ActivePeriods
+constexpr std::int32_t NUMBER_PHASES_NOT_SET = std::numeric_limits<std::int32_t>::min();
+
+/// \brief The current period of every profile that is combined, stored as structure of arrays so the reductions of
+/// the combinators over all profiles run over contiguous memory. Only the entries of the profiles that advance to
+/// their next period are updated per step.
+struct ActivePeriods {
+    std::vector<float> current_limit;
+    std::vector<float> power_limit;
+    std::vector<std::int32_t> stack_level_current;
+    std::vector<std::int32_t> stack_level_power;
+    std::vector<std::int32_t> number_phases; ///< NUMBER_PHASES_NOT_SET if not set
+
+    void push_back(const IntermediatePeriod& period) {
+        current_limit.push_back(period.current_limit);
+        power_limit.push_back(period.power_limit);
+        stack_level_current.push_back(period.stack_level_current);
+        stack_level_power.push_back(period.stack_level_power);
+        number_phases.push_back(period.numberPhases.value_or(NUMBER_PHASES_NOT_SET));
+    }
+
+    void set(const std::size_t index, const IntermediatePeriod& period) {
+        current_limit[index] = period.current_limit;
+        power_limit[index] = period.power_limit;
+        stack_level_current[index] = period.stack_level_current;
+        stack_level_power[index] = period.stack_level_power;
+        number_phases[index] = period.numberPhases.value_or(NUMBER_PHASES_NOT_SET);
+    }
+
+    std::size_t size() const {
+        return current_limit.size();
+    }
+
+    std::optional<std::int32_t> get_number_phases(const std::size_t index) const {
+        if (number_phases[index] == NUMBER_PHASES_NOT_SET) {
+            return std::nullopt;
+        }
+        return number_phases[index];
+    }
+
+    /// \brief Lowest number of phases of all periods that have one set
+    std::optional<std::int32_t> get_min_number_phases() const {
+        std::int32_t min_phases = std::numeric_limits<std::int32_t>::max();
+        for (const auto phases : number_phases) {
+            // Unset phases are the lowest value, which is skipped by taking them as the maximum
+            min_phases = std::min(min_phases, phases == NUMBER_PHASES_NOT_SET ? min_phases : phases);
+        }
+        if (min_phases == std::numeric_limits<std::int32_t>::max()) {
+            return std::nullopt;
+        }
+        return min_phases;
+    }
+
+    /// \brief Highest number of phases of all periods that have one set
+    std::optional<std::int32_t> get_max_number_phases() const {
+        std::int32_t max_phases = NUMBER_PHASES_NOT_SET;
+        for (const auto phases : number_phases) {
+            max_phases = std::max(max_phases, phases);
+        }
+        if (max_phases == NUMBER_PHASES_NOT_SET) {
+            return std::nullopt;
+        }
+        return max_phases;
+    }
+};
+
 inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vector<IntermediateProfile>& profiles) {
     std::vector<IntermediateProfileRef> references{};
     references.reserve(profiles.size());
@@ -496,8 +564,11 @@ inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vect
     return references;
 }
 
+/// \brief Combines the profiles into a single profile by merging the period boundaries of all profiles (k-way merge
+/// using a min heap of the start of the next period of every profile) and calling the \p combinator for every
+/// resulting period
 IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfileRef>& profiles,
-                                             std::function<IntermediatePeriod(const period_pair_vector&)> combinator) {
+                                             const std::function<IntermediatePeriod(const ActivePeriods&)>& combinator) {
     if (profiles.empty()) {
         // We should never get here as there are always profiles, otherwise there is a mistake in the calling function
         // Return an empty profile to be safe
@@ -506,19 +577,29 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
 
     IntermediateProfile combined{};
 
-    period_pair_vector profile_iterators{};
+    std::vector<std::pair<period_iterator, period_iterator>> profile_iterators{};
+    ActivePeriods active_periods{};
     for (const auto& wrapped_profile : profiles) {
         auto& profile = wrapped_profile.get();
         if (!profile.empty()) {
             profile_iterators.emplace_back(profile.begin(), profile.end());
+            active_periods.push_back(profile.front());
         }
     }
 
-    std::int32_t current_period = 0;
-    while (std::any_of(profile_iterators.begin(), profile_iterators.end(),
-                       [](const std::pair<period_iterator, period_iterator>& it) { return it.first != it.second; })) {
+    // Start of the next period and the index of its profile, earliest first
+    using period_boundary = std::pair<std::int32_t, std::size_t>;
+    std::priority_queue<period_boundary, std::vector<period_boundary>, std::greater<>> next_periods;
+    for (std::size_t i = 0; i < profile_iterators.size(); i++) {
+        const auto next = profile_iterators[i].first + 1;
+        if (next != profile_iterators[i].second) {
+            next_periods.emplace(next->startPeriod, i);
+        }
+    }
 
-        IntermediatePeriod period = combinator(profile_iterators);
+    std::int32_t current_period = 0;
+    while (!profile_iterators.empty()) {
+        IntermediatePeriod period = combinator(active_periods);
         period.startPeriod = current_period;
 
         if (combined.empty() || (period.current_limit != combined.back().current_limit) ||
@@ -529,26 +610,29 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
             combined.push_back(period);
         }
 
-        // Determine the next earliest period
-        std::int32_t next_lowest_period = std::numeric_limits<std::int32_t>::max();
-
-        for (const auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod > current_period && next->startPeriod < next_lowest_period) {
-                next_lowest_period = next->startPeriod;
-            }
+        // A profile whose next period does not start after the current one can not advance anymore
+        while (!next_periods.empty() && next_periods.top().first <= current_period) {
+            next_periods.pop();
         }
 
-        // If there is none, we are done
-        if (next_lowest_period == std::numeric_limits<std::int32_t>::max()) {
+        // If there is no next period, we are done
+        if (next_periods.empty()) {
             break;
         }
 
-        // Otherwise update to next earliest period
-        for (auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod == next_lowest_period) {
-                it++;
+        // Otherwise advance all profiles that have a period starting at the next earliest period
+        const std::int32_t next_lowest_period = next_periods.top().first;
+        while (!next_periods.empty() && next_periods.top().first == next_lowest_period) {
+            const std::size_t index = next_periods.top().second;
+            next_periods.pop();
+
+            auto& [it, end] = profile_iterators[index];
+            it++;
+            active_periods.set(index, *it);
+
+            const auto next = it + 1;
+            if (next != end) {
+                next_periods.emplace(next->startPeriod, index);
             }
         }
         current_period = next_lowest_period;
@@ -566,20 +650,20 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
 IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateProfile& tx_profile,
                                                              const IntermediateProfile& tx_default_profile) {
 
-    auto combinator = [](const period_pair_vector& periods) {
+    auto combinator = [](const ActivePeriods& periods) {
         IntermediatePeriod period{};
         period.current_limit = NO_LIMIT_SPECIFIED;
         period.power_limit = NO_LIMIT_SPECIFIED;
         period.stack_level_current = 0;
         period.stack_level_power = 0;
 
-        for (const auto& [it, end] : periods) {
-            if (it->current_limit != NO_LIMIT_SPECIFIED || it->power_limit != NO_LIMIT_SPECIFIED) {
-                period.current_limit = it->current_limit;
-                period.power_limit = it->power_limit;
-                period.numberPhases = it->numberPhases;
-                period.stack_level_current = it->stack_level_current;
-                period.stack_level_power = it->stack_level_power;
+        for (std::size_t i = 0; i < periods.size(); i++) {
+            if (periods.current_limit[i] != NO_LIMIT_SPECIFIED || periods.power_limit[i] != NO_LIMIT_SPECIFIED) {
+                period.current_limit = periods.current_limit[i];
+                period.power_limit = periods.power_limit[i];
+                period.numberPhases = periods.get_number_phases(i);
+                period.stack_level_current = periods.stack_level_current[i];
+                period.stack_level_power = periods.stack_level_power[i];
                 break;
             }
         }
@@ -594,30 +678,27 @@ IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateP
 }
 
 IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<IntermediateProfile>& profiles) {
-    auto combinator = [](const period_pair_vector& periods) {
+    auto combinator = [](const ActivePeriods& periods) {
         IntermediatePeriod period{};
         period.current_limit = std::numeric_limits<float>::max();
         period.power_limit = std::numeric_limits<float>::max();
 
-        for (const auto& [it, end] : periods) {
-            if (it->current_limit >= 0.0F && it->current_limit < period.current_limit) {
-                period.current_limit = it->current_limit;
-                period.stack_level_current = it->stack_level_current;
+        for (std::size_t i = 0; i < periods.size(); i++) {
+            if (periods.current_limit[i] >= 0.0F && periods.current_limit[i] < period.current_limit) {
+                period.current_limit = periods.current_limit[i];
+                period.stack_level_current = periods.stack_level_current[i];
             }
-            if (it->power_limit >= 0.0F && it->power_limit < period.power_limit) {
-                period.power_limit = it->power_limit;
-                period.stack_level_power = it->stack_level_power;
-            }
-
-            // Copy number of phases if lower
-            if (!period.numberPhases.has_value()) { // NOLINT(bugprone-branch-clone): readability
-                // Don't care if this copies a nullopt, thats what it was already
-                period.numberPhases = it->numberPhases;
-            } else if (it->numberPhases.has_value() && it->numberPhases.value() < period.numberPhases.value()) {
-                period.numberPhases = it->numberPhases;
+        }
+        for (std::size_t i = 0; i < periods.size(); i++) {
+            if (periods.power_limit[i] >= 0.0F && periods.power_limit[i] < period.power_limit) {
+                period.power_limit = periods.power_limit[i];
+                period.stack_level_power = periods.stack_level_power[i];
             }
         }
 
+        // Lowest number of phases
+        period.numberPhases = periods.get_min_number_phases();
+
         if (period.current_limit == std::numeric_limits<float>::max()) {
             period.current_limit = NO_LIMIT_SPECIFIED;
             period.stack_level_current = 0;
@@ -635,22 +716,21 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
 
 IntermediateProfile merge_profiles_by_summing_limits(const std::vector<IntermediateProfile>& profiles,
                                                      float current_default, float power_default) {
-    auto combinator = [current_default, power_default](const period_pair_vector& periods) {
+    auto combinator = [current_default, power_default](const ActivePeriods& periods) {
         IntermediatePeriod period{};
-        for (const auto& [it, end] : periods) {
-            period.current_limit += it->current_limit >= 0.0F ? it->current_limit : current_default;
-            period.power_limit += it->power_limit >= 0.0F ? it->power_limit : power_default;
-            period.stack_level_current = 0; // Stack level cant be determined when summing intermediate profiles
-            period.stack_level_power = 0;   // Stack level cant be determined when summing intermediate profiles
-
-            // Copy number of phases if higher
-            if (!period.numberPhases.has_value()) { // NOLINT(bugprone-branch-clone): readability
-                // Don't care if this copies a nullopt, thats what it was already
-                period.numberPhases = it->numberPhases;
-            } else if (it->numberPhases.has_value() && it->numberPhases.value() > period.numberPhases.value()) {
-                period.numberPhases = it->numberPhases;
-            }
+        for (const auto limit : periods.current_limit) {
+            period.current_limit += limit >= 0.0F ? limit : current_default;
+        }
+        for (const auto limit : periods.power_limit) {
+            period.power_limit += limit >= 0.0F ? limit : power_default;
         }
+
+        // Stack level cant be determined when summing intermediate profiles
+        period.stack_level_current = 0;
+        period.stack_level_power = 0;
+
+        // Highest number of phases
+        period.numberPhases = periods.get_max_number_phases();
         return period;
     };
 
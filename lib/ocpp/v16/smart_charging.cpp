@@ -16,6 +16,12 @@ using QueryExecutionException = everest::db::QueryExecutionException;
 const std::int32_t STATION_WIDE_ID = 0;
 
 namespace {
+/// \brief Shortest duration of the composite schedules of a limits changed subscription
+constexpr std::int32_t LIMITS_CHANGED_MIN_DURATION_S = 1;
+/// \brief Shortest time between two evaluations of the limits changed subscription, so that a period change in the
+/// past does not re-arm the timer immediately
+constexpr milliseconds LIMITS_CHANGED_MIN_INTERVAL{1000};
+
 /**
  * \brief remove expired profiles from the memory map structure and database
  * \param[in] now - profiles with a validTo time earlier that this are removed
@@ -61,6 +67,16 @@ void clear_expired_profiles(const date::utc_clock::time_point& now, ocpp::v16::D
         }
     }
 }
+
+/// \brief Checks if the current periods \p lhs and \p rhs of two composite schedules have the same limits
+bool is_same_period(const std::optional<ocpp::v16::EnhancedChargingSchedulePeriod>& lhs,
+                    const std::optional<ocpp::v16::EnhancedChargingSchedulePeriod>& rhs) {
+    if (!lhs.has_value() or !rhs.has_value()) {
+        return lhs.has_value() == rhs.has_value();
+    }
+    return lhs->limit == rhs->limit and lhs->numberPhases == rhs->numberPhases and
+           lhs->stackLevel == rhs->stackLevel;
+}
 } // namespace
 
 namespace ocpp {
@@ -101,11 +117,30 @@ bool validate_schedule(const ChargingSchedule& schedule, const int charging_sche
 
 SmartChargingHandler::SmartChargingHandler(std::map<std::int32_t, std::shared_ptr<Connector>>& connectors,
                                            std::shared_ptr<DatabaseHandler> database_handler,
-                                           ChargePointConfiguration& configuration) :
-    connectors(connectors), database_handler(database_handler), configuration(configuration) {
-    this->clear_profiles_timer = std::make_unique<Everest::SteadyTimer>();
+                                           ChargePointConfiguration& configuration,
+                                           std::shared_ptr<Executor> executor) :
+    connectors(connectors),
+    database_handler(database_handler),
+    configuration(configuration),
+    executor(executor != nullptr ? executor : Executor::get_default()),
+    limits_changed_duration(0),
+    limits_changed_unit(ChargingRateUnit::A) {
+    this->clear_profiles_timer = std::make_unique<Everest::SteadyTimer>(&this->executor->get_io_context());
     this->clear_profiles_timer->interval([this]() { this->clear_expired_profiles(date::utc_clock::now()); },
                                          hours(HOURS_PER_DAY));
+    this->next_limits_change_timer = std::make_unique<Everest::SteadyTimer>(&this->executor->get_io_context());
+}
+
+SmartChargingHandler::~SmartChargingHandler() {
+    try {
+        // Stopped on the executor, so the timer handlers can not run while this object is destroyed
+        this->executor->run_and_wait([this]() {
+            this->clear_profiles_timer->stop();
+            this->next_limits_change_timer->stop();
+        });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of smart charging timer stop";
+    }
 }
 
 void SmartChargingHandler::clear_expired_profiles(const date::utc_clock::time_point& now) {
@@ -301,6 +336,81 @@ EnhancedChargingSchedule SmartChargingHandler::calculate_enhanced_composite_sche
     return composite;
 }
 
+void SmartChargingHandler::subscribe_limits_changed(const std::int32_t duration_s, const ChargingRateUnit unit,
+                                                    const std::function<bool()>& is_offline_callback,
+                                                    const LimitsChangedCallback& callback) {
+    if (duration_s < LIMITS_CHANGED_MIN_DURATION_S) {
+        EVLOG_warning << "Limits changed subscription with a duration of " << duration_s << "s, using "
+                      << LIMITS_CHANGED_MIN_DURATION_S << "s instead";
+    }
+    {
+        const std::lock_guard<std::mutex> lk(this->limits_changed_mutex);
+        this->limits_changed_callback = callback;
+        this->is_offline_callback = is_offline_callback;
+        this->limits_changed_duration = std::max(duration_s, LIMITS_CHANGED_MIN_DURATION_S);
+        this->limits_changed_unit = unit;
+        this->reported_limits.clear();
+    }
+    this->notify_limits_changed();
+}
+
+void SmartChargingHandler::unsubscribe_limits_changed() {
+    const std::lock_guard<std::mutex> lk(this->limits_changed_mutex);
+    this->next_limits_change_timer->stop();
+    this->limits_changed_callback = nullptr;
+    this->is_offline_callback = nullptr;
+    this->reported_limits.clear();
+}
+
+void SmartChargingHandler::notify_limits_changed() {
+    LimitsChangedCallback callback;
+    std::map<std::int32_t, EnhancedChargingSchedule> changed_schedules;
+    {
+        const std::lock_guard<std::mutex> lk(this->limits_changed_mutex);
+        if (this->limits_changed_callback == nullptr) {
+            return;
+        }
+        callback = this->limits_changed_callback;
+
+        const auto is_offline = this->is_offline_callback != nullptr and this->is_offline_callback();
+        const auto start_time = ocpp::DateTime();
+        const auto end_time = ocpp::DateTime(start_time.to_time_point() + seconds(this->limits_changed_duration));
+
+        // Profiles that start after the duration of the composite schedules are picked up at its end
+        auto next_change = end_time.to_time_point();
+
+        for (const auto& [connector_id, connector] : this->connectors) {
+            auto schedule = this->calculate_enhanced_composite_schedule(
+                start_time, end_time, connector_id, this->limits_changed_unit, is_offline, true);
+
+            const auto& periods = schedule.chargingSchedulePeriod;
+            if (periods.size() > 1 and schedule.startSchedule.has_value()) {
+                next_change = std::min(next_change, schedule.startSchedule.value().to_time_point() +
+                                                        seconds(periods.at(1).startPeriod));
+            }
+
+            std::optional<EnhancedChargingSchedulePeriod> current_period;
+            if (!periods.empty()) {
+                current_period = periods.front();
+            }
+
+            const auto reported = this->reported_limits.find(connector_id);
+            if (reported == this->reported_limits.end() or !is_same_period(reported->second, current_period)) {
+                this->reported_limits[connector_id] = current_period;
+                changed_schedules.emplace(connector_id, std::move(schedule));
+            }
+        }
+
+        const auto timeout = std::max(duration_cast<milliseconds>(next_change - start_time.to_time_point()),
+                                      LIMITS_CHANGED_MIN_INTERVAL);
+        this->next_limits_change_timer->timeout([this]() { this->notify_limits_changed(); }, timeout);
+    }
+
+    if (!changed_schedules.empty()) {
+        callback(changed_schedules);
+    }
+}
+
 bool SmartChargingHandler::validate_profile(
     ChargingProfile& profile, const int connector_id, bool ignore_no_transaction, const int profile_max_stack_level,
     const int max_charging_profiles_installed, const int charging_schedule_max_periods,
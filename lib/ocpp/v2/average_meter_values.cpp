@@ -7,41 +7,117 @@
 
 namespace ocpp {
 namespace v2 {
+
 namespace {
-bool is_avg_meas(const SampledValue& sample) {
-    if (sample.measurand.has_value() and (sample.measurand == MeasurandEnum::Current_Import) or
-        (sample.measurand == MeasurandEnum::Voltage) or (sample.measurand == MeasurandEnum::Power_Active_Import) or
-        (sample.measurand == MeasurandEnum::Frequency)) {
-        return true;
+/// \returns true if \p lhs and \p rhs have the same unit and multiplier
+bool has_same_unit(const std::optional<UnitOfMeasure>& lhs, const std::optional<UnitOfMeasure>& rhs) {
+    if (!lhs.has_value() or !rhs.has_value()) {
+        return lhs.has_value() == rhs.has_value();
     }
-    return false;
+    return lhs->unit == rhs->unit and lhs->multiplier == rhs->multiplier;
 }
 } // namespace
 
+std::optional<std::size_t> AverageMeterValues::get_slot(const SampledValue& sample) {
+    if (!sample.measurand.has_value()) {
+        return std::nullopt;
+    }
+
+    std::size_t measurand_index = 0;
+    switch (sample.measurand.value()) {
+    case MeasurandEnum::Current_Import:
+        measurand_index = 0;
+        break;
+    case MeasurandEnum::Voltage:
+        measurand_index = 1;
+        break;
+    case MeasurandEnum::Power_Active_Import:
+        measurand_index = 2;
+        break;
+    case MeasurandEnum::Frequency:
+        measurand_index = 3;
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    const std::size_t phase_index = sample.phase.has_value() ? static_cast<std::size_t>(sample.phase.value()) + 1 : 0;
+    const std::size_t location_index =
+        sample.location.has_value() ? static_cast<std::size_t>(sample.location.value()) + 1 : 0;
+    return (measurand_index * NUMBER_OF_PHASES + phase_index) * NUMBER_OF_LOCATIONS + location_index;
+}
+
 void AverageMeterValues::clear_values() {
     const std::lock_guard<std::mutex> lk(this->avg_meter_value_mutex);
-    this->aligned_meter_values.clear();
+    // Invalidates all accumulators at once
+    ++this->generation;
+    if (this->generation == 0) {
+        // Wrapped around, so a stale accumulator could look valid again
+        this->aligned_meter_values.fill(MeterValueCalc{0.0, 0, 0});
+        this->generation = 1;
+    }
     this->averaged_meter_values.sampledValue.clear();
 }
 
+bool AverageMeterValues::has_same_layout(const MeterValue& meter_value) const {
+    const auto& stored = this->averaged_meter_values.sampledValue;
+    if (stored.size() != meter_value.sampledValue.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < stored.size(); i++) {
+        const auto& sample = meter_value.sampledValue[i];
+        if (stored[i].measurand != sample.measurand or stored[i].phase != sample.phase or
+            stored[i].location != sample.location or !has_same_unit(stored[i].unitOfMeasure, sample.unitOfMeasure)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void AverageMeterValues::set_values(const MeterValue& meter_value) {
     const std::lock_guard<std::mutex> lk(this->avg_meter_value_mutex);
-    // store all the meter values in the struct
-    this->averaged_meter_values = meter_value;
+    // The structure of the meter value is only copied when the aggregation window starts or the layout of the samples
+    // changes, otherwise the latest values are written into the stored samples without allocating
+    if (this->averaged_meter_values.sampledValue.empty() or !this->has_same_layout(meter_value)) {
+        this->averaged_meter_values = meter_value;
+    } else {
+        this->averaged_meter_values.timestamp = meter_value.timestamp;
+        if (meter_value.customData.has_value() or this->averaged_meter_values.customData.has_value()) {
+            this->averaged_meter_values.customData = meter_value.customData;
+        }
+        for (std::size_t i = 0; i < meter_value.sampledValue.size(); i++) {
+            const auto& sample = meter_value.sampledValue[i];
+            auto& stored = this->averaged_meter_values.sampledValue[i];
+            // Averaged samples get their value in average_meter_value()
+            stored.value = sample.value;
+            stored.context = sample.context;
+            // Same unit and multiplier, so only a changed customData of the unit is copied
+            if (sample.unitOfMeasure.has_value() and
+                (sample.unitOfMeasure->customData.has_value() or stored.unitOfMeasure->customData.has_value())) {
+                stored.unitOfMeasure->customData = sample.unitOfMeasure->customData;
+            }
+            if (sample.signedMeterValue.has_value() or stored.signedMeterValue.has_value()) {
+                stored.signedMeterValue = sample.signedMeterValue;
+            }
+            if (sample.customData.has_value() or stored.customData.has_value()) {
+                stored.customData = sample.customData;
+            }
+        }
+    }
 
     // avg all the possible measurerands
-    for (auto& element : meter_value.sampledValue) {
-        if (is_avg_meas(element)) {
-            if (element.measurand.has_value()) {
-                const MeterValueMeasurands key{element.measurand.value(), element.phase, element.location};
-                this->aligned_meter_values.try_emplace(key,
-                                                       MeterValueCalc{0.0, 0}); // If not exists yet, set to default
+    for (const auto& element : meter_value.sampledValue) {
+        const auto slot = get_slot(element);
+        if (!slot.has_value()) {
+            continue;
+        }
 
-                MeterValueCalc& temp = this->aligned_meter_values.at(key);
-                temp.sum += element.value;
-                temp.num_elements++;
-            }
+        MeterValueCalc& temp = this->aligned_meter_values[slot.value()];
+        if (temp.generation != this->generation) {
+            temp = MeterValueCalc{0.0, 0, this->generation};
         }
+        temp.sum += element.value;
+        temp.num_elements++;
     }
 }
 
@@ -53,17 +129,16 @@ MeterValue AverageMeterValues::retrieve_processed_values() {
 
 void AverageMeterValues::average_meter_value() {
     for (auto& element : this->averaged_meter_values.sampledValue) {
-        if (is_avg_meas(element)) {
-            if (element.measurand.has_value()) {
-                const auto measurand = element.measurand.value();
-                const MeterValueMeasurands key{measurand, element.phase, element.location};
-                if (this->aligned_meter_values.find(key) == this->aligned_meter_values.end()) {
-                    EVLOG_warning << "Measurand: " << measurand << " not present in map";
-                } else {
-                    const MeterValueCalc& temp = this->aligned_meter_values.at(key);
-                    element.value = static_cast<float>(temp.sum / temp.num_elements);
-                }
-            }
+        const auto slot = get_slot(element);
+        if (!slot.has_value()) {
+            continue;
+        }
+
+        const MeterValueCalc& temp = this->aligned_meter_values[slot.value()];
+        if (temp.generation != this->generation or temp.num_elements == 0) {
+            EVLOG_warning << "Measurand: " << element.measurand.value() << " not present in map";
+        } else {
+            element.value = static_cast<float>(temp.sum / temp.num_elements);
         }
     }
 }
@@ -5,6 +5,7 @@
 
 #include <ocpp/common/constants.hpp>
 #include <ocpp/common/types.hpp>
+#include <ocpp/v2/constants.hpp>
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/device_model.hpp>
@@ -31,6 +32,7 @@
 #include <ocpp/v2/functional_blocks/transaction.hpp>
 
 #include <ocpp/v21/functional_blocks/bidirectional.hpp>
+#include <ocpp/v21/functional_blocks/der_control.hpp>
 
 #include <ocpp/v2/messages/LogStatusNotification.hpp>
 #include <ocpp/v2/messages/RequestStopTransaction.hpp>
@@ -51,8 +53,8 @@ ChargePoint::ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connec
                          std::shared_ptr<DeviceModel> device_model, std::shared_ptr<DatabaseHandler> database_handler,
                          std::shared_ptr<MessageQueue<v2::MessageType>> message_queue,
                          const std::string& message_log_path, const std::shared_ptr<EvseSecurity> evse_security,
-                         const Callbacks& callbacks) :
-    ocpp::ChargingStationBase(evse_security),
+                         const Callbacks& callbacks, std::shared_ptr<Executor> executor) :
+    ocpp::ChargingStationBase(evse_security, std::nullopt, executor),
     message_queue(message_queue),
     device_model(device_model),
     database_handler(database_handler),
@@ -94,12 +96,15 @@ ChargePoint::ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connec
                          std::unique_ptr<DeviceModelStorageInterface> device_model_storage_interface,
                          const std::string& /*ocpp_main_path*/, const std::string& core_database_path,
                          const std::string& sql_init_path, const std::string& message_log_path,
-                         const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks) :
+                         const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks,
+                         std::shared_ptr<Executor> executor) :
     ChargePoint(
         evse_connector_structure, std::make_shared<DeviceModel>(std::move(device_model_storage_interface)),
         std::make_shared<DatabaseHandler>(
-            std::make_unique<everest::db::sqlite::Connection>(fs::path(core_database_path) / "cp.db"), sql_init_path),
-        nullptr /* message_queue initialized in this constructor */, message_log_path, evse_security, callbacks) {
+            std::make_unique<everest::db::sqlite::Connection>(fs::path(core_database_path) / "cp.db"), sql_init_path,
+            executor),
+        nullptr /* message_queue initialized in this constructor */, message_log_path, evse_security, callbacks,
+        executor) {
 }
 
 ChargePoint::ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connector_structure,
@@ -107,14 +112,25 @@ ChargePoint::ChargePoint(const std::map<std::int32_t, std::int32_t>& evse_connec
                          const std::string& device_model_migration_path, const std::string& device_model_config_path,
                          const std::string& ocpp_main_path, const std::string& core_database_path,
                          const std::string& sql_init_path, const std::string& message_log_path,
-                         const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks) :
+                         const std::shared_ptr<EvseSecurity> evse_security, const Callbacks& callbacks,
+                         std::shared_ptr<Executor> executor) :
     ChargePoint(evse_connector_structure,
                 std::make_unique<DeviceModelStorageSqlite>(device_model_storage_address, device_model_migration_path,
                                                            device_model_config_path),
-                ocpp_main_path, core_database_path, sql_init_path, message_log_path, evse_security, callbacks) {
+                ocpp_main_path, core_database_path, sql_init_path, message_log_path, evse_security, callbacks,
+                executor) {
 }
 
-ChargePoint::~ChargePoint() = default;
+ChargePoint::~ChargePoint() {
+    // The timer handlers access the functional blocks, so none of them may run while they are destroyed. The
+    // remaining timers are stopped by the destructors of the components that own them
+    this->stop_timers_on_executor([this]() {
+        this->availability->stop_heartbeat_timer();
+        this->provisioning->stop_bootnotification_timer();
+        this->security->stop_certificate_expiration_check_timers();
+        this->security->stop_certificate_signed_timer();
+    });
+}
 
 void ChargePoint::start(BootReasonEnum bootreason, bool start_connecting) {
     this->message_queue->start();
@@ -215,6 +231,10 @@ void ChargePoint::on_transaction_started(const std::int32_t evse_id, const std::
     this->transaction->on_transaction_started(evse_id, connector_id, session_id, timestamp, trigger_reason, meter_start,
                                               id_token, group_id_token, reservation_id, remote_start_id,
                                               charging_state);
+    this->tariff_and_cost->on_transaction_started(evse_id, session_id, timestamp, meter_start);
+    if (this->bidirectional != nullptr) {
+        this->bidirectional->on_charging_profiles_changed();
+    }
 }
 
 void ChargePoint::on_transaction_finished(const std::int32_t evse_id, const DateTime& timestamp,
@@ -223,8 +243,12 @@ void ChargePoint::on_transaction_finished(const std::int32_t evse_id, const Date
                                           const std::optional<IdToken>& id_token,
                                           const std::optional<std::string>& signed_meter_value,
                                           const ChargingStateEnum charging_state) {
+    this->tariff_and_cost->on_transaction_finished(evse_id, timestamp, meter_stop);
     this->transaction->on_transaction_finished(evse_id, timestamp, meter_stop, reason, trigger_reason, id_token,
                                                signed_meter_value, charging_state);
+    if (this->bidirectional != nullptr) {
+        this->bidirectional->on_charging_profiles_changed();
+    }
 }
 
 void ChargePoint::on_session_finished(const std::int32_t evse_id, const std::int32_t connector_id) {
@@ -255,6 +279,10 @@ void ChargePoint::on_authorized(const std::int32_t evse_id, const std::int32_t /
 
 void ChargePoint::on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) {
     this->meter_values->on_meter_value(evse_id, meter_value);
+    this->tariff_and_cost->on_meter_value(evse_id, meter_value);
+    if (this->der_control != nullptr) {
+        this->der_control->on_meter_value(evse_id, meter_value);
+    }
 }
 
 void ChargePoint::configure_message_logging_format(const std::string& message_log_path) {
@@ -422,6 +450,15 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
                              const std::string& message_log_path) {
     this->device_model->check_integrity(evse_connector_structure);
     this->database_handler->open_connection();
+    this->database_handler->set_compact_encoding(
+        this->device_model->get_optional_value<bool>(ControllerComponentVariables::CompactDatabaseEncoding)
+            .value_or(false));
+    this->database_handler->set_meter_value_buffer_limits(
+        this->device_model->get_optional_value<int>(ControllerComponentVariables::MeterValueBufferMaxSize)
+            .value_or(DEFAULT_METER_VALUE_BUFFER_MAX_SIZE),
+        std::chrono::seconds(
+            this->device_model->get_optional_value<int>(ControllerComponentVariables::MeterValueBufferMaxAge)
+                .value_or(DEFAULT_METER_VALUE_BUFFER_MAX_AGE.count())));
     this->component_state_manager = std::make_shared<ComponentStateManager>(
         evse_connector_structure, database_handler,
         [this](auto evse_id, auto connector_id, auto status, bool initiated_by_trigger_message) {
@@ -474,12 +511,13 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 
     this->evse_manager = std::make_unique<EvseManager>(
         evse_connector_structure, *this->device_model, this->database_handler, component_state_manager,
-        transaction_meter_value_callback, this->callbacks.pause_charging_callback);
+        transaction_meter_value_callback, this->callbacks.pause_charging_callback, this->io_context);
     this->configure_message_logging_format(message_log_path);
 
     this->connectivity_manager =
         std::make_unique<ConnectivityManager>(*this->device_model, this->evse_security, this->logging,
-                                              [this](const std::string& message) { this->message_callback(message); });
+                                              [this](const std::string& message) { this->message_callback(message); },
+                                              this->executor);
 
     this->connectivity_manager->set_websocket_connected_callback(
         [this](int configuration_slot, const NetworkConnectionProfile& network_connection_profile,
@@ -523,7 +561,7 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
                     .value_or(false),
                 message_types_discard_for_queueing,
                 this->device_model->get_value<int>(ControllerComponentVariables::MessageTimeout)},
-            this->database_handler);
+            this->database_handler, this->executor);
     }
 
     this->message_dispatcher =
@@ -532,7 +570,8 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
     // Construct functional blocks.
     functional_block_context = std::make_unique<FunctionalBlockContext>(
         *this->message_dispatcher, *this->device_model, *this->connectivity_manager, *this->evse_manager,
-        *this->database_handler, *this->evse_security, *this->component_state_manager, this->ocpp_version);
+        *this->database_handler, *this->evse_security, *this->component_state_manager, this->ocpp_version,
+        this->executor, this->contract_certificate_cache);
 
     this->data_transfer = std::make_unique<DataTransfer>(
         *this->functional_block_context, this->callbacks.data_transfer_callback, DEFAULT_WAIT_FOR_FUTURE_TIMEOUT);
@@ -587,9 +626,15 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 
     if (device_model->get_optional_value<bool>(ControllerComponentVariables::SmartChargingCtrlrAvailable)
             .value_or(false)) {
-        this->smart_charging = std::make_unique<SmartCharging>(*this->functional_block_context,
-                                                               this->callbacks.set_charging_profiles_callback,
-                                                               this->callbacks.stop_transaction_callback);
+        this->smart_charging = std::make_unique<SmartCharging>(
+            *this->functional_block_context,
+            [this]() {
+                if (this->bidirectional != nullptr) {
+                    this->bidirectional->on_charging_profiles_changed();
+                }
+                this->callbacks.set_charging_profiles_callback();
+            },
+            this->callbacks.stop_transaction_callback);
     }
 
     this->tariff_and_cost = std::make_unique<TariffAndCost>(
@@ -608,7 +653,7 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 
     this->provisioning = std::make_unique<Provisioning>(
         *this->functional_block_context, *this->message_queue, this->ocsp_updater, *this->availability,
-        *this->meter_values, *this->security, *this->diagnostics, *this->transaction,
+        *this->meter_values, *this->security, *this->diagnostics, *this->transaction, *this->tariff_and_cost,
         this->callbacks.time_sync_callback, this->callbacks.boot_notification_callback,
         this->callbacks.validate_network_profile_callback, this->callbacks.is_reset_allowed_callback,
         this->callbacks.reset_callback, this->callbacks.stop_transaction_callback,
@@ -632,7 +677,10 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 
     if (v2x_available) {
         this->bidirectional = std::make_unique<Bidirectional>(
-            *this->functional_block_context, this->callbacks.update_allowed_energy_transfer_modes_callback);
+            *this->functional_block_context, this->smart_charging.get(),
+            this->callbacks.update_allowed_energy_transfer_modes_callback, this->callbacks.afrr_signal_callback);
+        this->der_control = std::make_unique<DERControl>(*this->functional_block_context, this->io_context,
+                                                         this->callbacks.der_curve_output_callback);
     }
 
     Variable field_length = {"FieldLength"};
@@ -643,7 +691,7 @@ void ChargePoint::initialize(const std::map<std::int32_t, std::int32_t>& evse_co
 }
 
 void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
     try {
         switch (message.messageType) {
         case MessageType::BootNotificationResponse:
@@ -709,6 +757,8 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
         case MessageType::GetChargingProfiles:
         case MessageType::GetCompositeSchedule:
         case MessageType::NotifyEVChargingNeedsResponse:
+        case MessageType::UpdateDynamicSchedule:
+        case MessageType::PullDynamicScheduleUpdateResponse:
             if (this->smart_charging != nullptr) {
                 this->smart_charging->handle_message(message);
             } else {
@@ -725,14 +775,29 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
             }
             break;
         case MessageType::CostUpdated:
+        case MessageType::SetDefaultTariff:
+        case MessageType::GetTariffs:
+        case MessageType::ClearTariffs:
+        case MessageType::ChangeTransactionTariff:
             if (this->tariff_and_cost != nullptr) {
                 this->tariff_and_cost->handle_message(message);
             } else {
                 send_not_implemented_error(message.uniqueId, message.messageTypeId);
             }
 
+            break;
+        case MessageType::SetDERControl:
+        case MessageType::GetDERControl:
+        case MessageType::ClearDERControl:
+            if (this->der_control != nullptr) {
+                this->der_control->handle_message(message);
+            } else {
+                send_not_implemented_error(message.uniqueId, message.messageTypeId);
+            }
+
             break;
         case MessageType::NotifyAllowedEnergyTransfer:
+        case MessageType::AFRRSignal:
             if (this->bidirectional != nullptr) {
                 this->bidirectional->handle_message(message);
             } else {
@@ -828,25 +893,19 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
         case MessageType::UpdateFirmwareResponse:
         case MessageType::AdjustPeriodicEventStream:
         case MessageType::AdjustPeriodicEventStreamResponse:
-        case MessageType::AFRRSignal:
         case MessageType::AFRRSignalResponse:
         case MessageType::BatterySwap:
         case MessageType::BatterySwapResponse:
-        case MessageType::ChangeTransactionTariff:
         case MessageType::ChangeTransactionTariffResponse:
-        case MessageType::ClearDERControl:
         case MessageType::ClearDERControlResponse:
-        case MessageType::ClearTariffs:
         case MessageType::ClearTariffsResponse:
         case MessageType::ClosePeriodicEventStream:
         case MessageType::ClosePeriodicEventStreamResponse:
         case MessageType::GetCRL:
         case MessageType::GetCRLResponse:
-        case MessageType::GetDERControl:
         case MessageType::GetDERControlResponse:
         case MessageType::GetPeriodicEventStream:
         case MessageType::GetPeriodicEventStreamResponse:
-        case MessageType::GetTariffs:
         case MessageType::GetTariffsResponse:
         case MessageType::NotifyDERAlarm:
         case MessageType::NotifyDERAlarmResponse:
@@ -861,14 +920,12 @@ void ChargePoint::handle_message(const EnhancedMessage<v2::MessageType>& message
         case MessageType::OpenPeriodicEventStream:
         case MessageType::OpenPeriodicEventStreamResponse:
         case MessageType::PullDynamicScheduleUpdate:
-        case MessageType::PullDynamicScheduleUpdateResponse:
+        case MessageType::ReportDERControl:
+        case MessageType::ReportDERControlResponse:
         case MessageType::RequestBatterySwap:
         case MessageType::RequestBatterySwapResponse:
-        case MessageType::SetDefaultTariff:
         case MessageType::SetDefaultTariffResponse:
-        case MessageType::SetDERControl:
         case MessageType::SetDERControlResponse:
-        case MessageType::UpdateDynamicSchedule:
         case MessageType::UpdateDynamicScheduleResponse:
         case MessageType::UsePriorityCharging:
         case MessageType::UsePriorityChargingResponse:
@@ -948,7 +1005,7 @@ void ChargePoint::message_callback(const std::string& message) {
     }
 
     enhanced_message.message_size = message.size();
-    auto json_message = enhanced_message.message;
+    const auto& json_message = *enhanced_message.message;
     this->logging->central_system(conversions::messagetype_to_string(enhanced_message.messageType), message);
     try {
         if (this->registration_status == RegistrationStatusEnum::Accepted) {
@@ -1180,24 +1237,8 @@ void ChargePoint::update_dm_availability_state(const std::int32_t evse_id, const
 }
 
 void ChargePoint::clear_invalid_charging_profiles() {
-    try {
-        auto evses = this->database_handler->get_all_charging_profiles_group_by_evse();
-        EVLOG_info << "Found " << evses.size() << " evse in the database";
-        for (const auto& [evse_id, profiles] : evses) {
-            for (auto profile : profiles) {
-                try {
-                    if (this->smart_charging != nullptr &&
-                        this->smart_charging->conform_and_validate_profile(profile, evse_id) !=
-                            ProfileValidationResultEnum::Valid) {
-                        this->database_handler->delete_charging_profile(profile.id);
-                    }
-                } catch (const everest::db::QueryExecutionException& e) {
-                    EVLOG_warning << "Failed database operation for ChargingProfiles: " << e.what();
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-        EVLOG_warning << "Unknown error while loading charging profiles from database: " << e.what();
+    if (this->smart_charging != nullptr) {
+        this->smart_charging->clear_invalid_profiles();
     }
 }
 
@@ -1237,6 +1278,20 @@ std::vector<CompositeSchedule> ChargePoint::get_all_composite_schedules(const st
     return this->smart_charging->get_all_composite_schedules(duration_s, unit);
 }
 
+void ChargePoint::subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                           const LimitsChangedCallback& callback) {
+    if (this->smart_charging == nullptr) {
+        return;
+    }
+    this->smart_charging->subscribe_limits_changed(duration, unit, callback);
+}
+
+void ChargePoint::unsubscribe_limits_changed() {
+    if (this->smart_charging != nullptr) {
+        this->smart_charging->unsubscribe_limits_changed();
+    }
+}
+
 std::optional<NetworkConnectionProfile>
 ChargePoint::get_network_connection_profile(const std::int32_t configuration_slot) const {
     return this->connectivity_manager->get_network_connection_profile(configuration_slot);
@@ -21,12 +21,15 @@ namespace v2 {
 
 ConnectivityManager::ConnectivityManager(DeviceModel& device_model, std::shared_ptr<EvseSecurity> evse_security,
                                          std::shared_ptr<MessageLogging> logging,
-                                         const std::function<void(const std::string& message)>& message_callback) :
+                                         const std::function<void(const std::string& message)>& message_callback,
+                                         std::shared_ptr<Executor> executor) :
     device_model{device_model},
     evse_security{evse_security},
     logging{logging},
     websocket{nullptr},
     message_callback{message_callback},
+    executor{executor != nullptr ? executor : Executor::get_default()},
+    websocket_timer{&this->executor->get_io_context()},
     wants_to_be_connected{false},
     active_network_configuration_priority{0},
     last_known_security_level{0},
@@ -34,6 +37,15 @@ ConnectivityManager::ConnectivityManager(DeviceModel& device_model, std::shared_
     cache_network_connection_profiles();
 }
 
+ConnectivityManager::~ConnectivityManager() {
+    try {
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed
+        this->executor->run_and_wait([this]() { this->websocket_timer.stop(); });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of websocket timer stop";
+    }
+}
+
 void ConnectivityManager::set_websocket_authorization_key(const std::string& authorization_key) {
     if (this->websocket != nullptr) {
         this->websocket->set_authorization_key(authorization_key);
@@ -234,7 +246,8 @@ void ConnectivityManager::try_connect_websocket() {
     }
 
     if (this->websocket == nullptr) {
-        this->websocket = std::make_unique<Websocket>(connection_options.value(), this->evse_security, this->logging);
+        this->websocket = std::make_unique<Websocket>(connection_options.value(), this->evse_security, this->logging,
+                                                      this->executor);
 
         this->websocket->register_connected_callback(
             [this](OcppProtocolVersion protocol) { this->on_websocket_connected(protocol); });
@@ -316,6 +329,7 @@ void ConnectivityManager::on_network_disconnected(OCPPInterfaceEnum ocpp_interfa
 
 void ConnectivityManager::on_charging_station_certificate_changed() {
     if (this->websocket != nullptr) {
+        this->websocket->invalidate_tls_context();
         // After the websocket gets closed a reconnect will be triggered
         this->websocket->disconnect(WebsocketCloseReason::ServiceRestart);
     }
@@ -277,6 +277,24 @@ const ComponentVariable MonitorsProcessingInterval = {
         "MonitorsProcessingInterval",
     }),
 };
+const ComponentVariable NotifyEventItemsPerMessage = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "NotifyEventItemsPerMessage",
+    }),
+};
+const ComponentVariable NotifyEventBytesPerMessage = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "NotifyEventBytesPerMessage",
+    }),
+};
+const ComponentVariable NotifyEventLatencyBudget = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "NotifyEventLatencyBudget",
+    }),
+};
 const ComponentVariable MaxCustomerInformationDataLength = {
     ControllerComponents::InternalCtrlr,
     std::optional<Variable>({
@@ -325,6 +343,24 @@ const ComponentVariable ResumeTransactionsOnBoot = {
         "ResumeTransactionsOnBoot",
     }),
 };
+const ComponentVariable CompactDatabaseEncoding = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "CompactDatabaseEncoding",
+    }),
+};
+const ComponentVariable MeterValueBufferMaxSize = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "MeterValueBufferMaxSize",
+    }),
+};
+const ComponentVariable MeterValueBufferMaxAge = {
+    ControllerComponents::InternalCtrlr,
+    std::optional<Variable>({
+        "MeterValueBufferMaxAge",
+    }),
+};
 const ComponentVariable AllowCSMSRootCertInstallWithUnsecureConnection = {
     ControllerComponents::InternalCtrlr,
     std::optional<Variable>({
@@ -1149,6 +1185,10 @@ const ComponentVariable TariffCostCtrlrEnabledCost = {
     ControllerComponents::TariffCostCtrlr,
     std::optional<Variable>({"Enabled", "Cost"}),
 };
+const ComponentVariable TariffCostCtrlrMaxElementsTariff = {
+    ControllerComponents::TariffCostCtrlr,
+    std::optional<Variable>({"MaxElements", "Tariff"}),
+};
 const RequiredComponentVariable TariffFallbackMessage = {
     ControllerComponents::TariffCostCtrlr,
     std::optional<Variable>({
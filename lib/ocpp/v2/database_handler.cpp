@@ -4,11 +4,15 @@
 #include "everest/logging.hpp"
 #include "ocpp/v2/ocpp_enums.hpp"
 #include "ocpp/v2/ocpp_types.hpp"
+#include <algorithm>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <everest/database/sqlite/statement.hpp>
+#include <map>
 #include <numeric>
+#include <ocpp/common/compact_encoding.hpp>
 #include <ocpp/common/message_queue.hpp>
+#include <ocpp/v2/constants.hpp>
 #include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/types.hpp>
 #include <ocpp/v2/utils.hpp>
@@ -34,9 +38,200 @@ DateTime from_unix_milliseconds(std::int64_t ms_since_epoch) {
 
 namespace v2 {
 
+namespace {
+constexpr char METER_VALUE_BLOCK_ENCODING_V1 = '1';
+
+bool is_compact_text(const std::optional<CiString<20>>& text) {
+    return !text.has_value() or
+           (!text->get().empty() and text->get().find_first_of(compact_encoding::SEPARATORS) == std::string::npos);
+}
+
+/// \brief Metervalues can be stored compactly if they do not carry signed data or custom data
+bool is_compact_meter_value(const MeterValue& meter_value) {
+    return std::all_of(meter_value.sampledValue.begin(), meter_value.sampledValue.end(), [](const SampledValue& item) {
+        return !item.customData.has_value() and !item.signedMeterValue.has_value() and
+               (!item.unitOfMeasure.has_value() or
+                (!item.unitOfMeasure->customData.has_value() and is_compact_text(item.unitOfMeasure->unit)));
+    });
+}
+
+void append_optional_int(std::string& out, const std::optional<std::int64_t>& value) {
+    out += ',';
+    if (value.has_value()) {
+        compact_encoding::append_int(out, value.value());
+    }
+}
+
+template <typename T> std::optional<std::int64_t> to_optional_int(const std::optional<T>& value) {
+    if (value.has_value()) {
+        return static_cast<std::int64_t>(value.value());
+    }
+    return std::nullopt;
+}
+
+/// \brief Appends \p meter_value to \p block as ";<timestamp delta>,<context>" followed by
+/// "|<value>,<measurand>,<phase>,<location>,<unit>,<multiplier>" for every sampled value. The timestamp is stored as
+/// the difference in ms to \p last_timestamp, enums are stored as their ids in the enum tables
+void append_meter_value(std::string& block, std::int64_t& last_timestamp, const ReadingContextEnum context,
+                        const MeterValue& meter_value) {
+    const auto timestamp = to_unix_milliseconds(meter_value.timestamp);
+    block += ';';
+    compact_encoding::append_int(block, timestamp - last_timestamp);
+    last_timestamp = timestamp;
+    block += ',';
+    compact_encoding::append_int(block, static_cast<std::int64_t>(context));
+
+    for (const auto& item : meter_value.sampledValue) {
+        block += '|';
+        compact_encoding::append_float(block, item.value);
+        append_optional_int(block, to_optional_int(item.measurand));
+        append_optional_int(block, to_optional_int(item.phase));
+        append_optional_int(block, to_optional_int(item.location));
+        block += ',';
+        if (item.unitOfMeasure.has_value() and item.unitOfMeasure->unit.has_value()) {
+            block += item.unitOfMeasure->unit->get();
+        }
+        append_optional_int(block, item.unitOfMeasure.has_value() ? to_optional_int(item.unitOfMeasure->multiplier)
+                                                                  : std::nullopt);
+    }
+}
+
+/// \brief Decodes a block written by append_meter_value and appends the metervalues to \p meter_values
+void decode_meter_value_block(std::string_view block, std::vector<MeterValue>& meter_values) {
+    if (block.empty() or block.front() != METER_VALUE_BLOCK_ENCODING_V1) {
+        throw compact_encoding::DecodeException("Unknown metervalue encoding");
+    }
+
+    compact_encoding::Reader reader(block.substr(1));
+    std::int64_t timestamp = 0;
+    while (reader.skip(';')) {
+        timestamp += reader.read_int();
+        reader.expect(',');
+        const auto context = static_cast<ReadingContextEnum>(reader.read_int());
+
+        MeterValue meter_value;
+        meter_value.timestamp = from_unix_milliseconds(timestamp);
+        while (reader.skip('|')) {
+            SampledValue sampled_value;
+            sampled_value.value = reader.read_float();
+            sampled_value.context = context;
+            reader.expect(',');
+            if (const auto measurand = reader.read_optional_int(); measurand.has_value()) {
+                sampled_value.measurand = static_cast<MeasurandEnum>(measurand.value());
+            }
+            reader.expect(',');
+            if (const auto phase = reader.read_optional_int(); phase.has_value()) {
+                sampled_value.phase = static_cast<PhaseEnum>(phase.value());
+            }
+            reader.expect(',');
+            if (const auto location = reader.read_optional_int(); location.has_value()) {
+                sampled_value.location = static_cast<LocationEnum>(location.value());
+            }
+            reader.expect(',');
+            const auto unit = reader.read_text();
+            reader.expect(',');
+            const auto multiplier = reader.read_optional_int();
+            if (!unit.empty() or multiplier.has_value()) {
+                UnitOfMeasure unit_of_measure;
+                if (!unit.empty()) {
+                    unit_of_measure.unit = std::string(unit);
+                }
+                if (multiplier.has_value()) {
+                    unit_of_measure.multiplier = static_cast<std::int32_t>(multiplier.value());
+                }
+                sampled_value.unitOfMeasure = unit_of_measure;
+            }
+            meter_value.sampledValue.push_back(std::move(sampled_value));
+        }
+        meter_values.push_back(std::move(meter_value));
+    }
+
+    if (!reader.at_end()) {
+        throw compact_encoding::DecodeException("Unexpected characters in metervalue block");
+    }
+}
+
+/// \brief Reads a charging profile stored as json or with compact_encoding::encode_charging_profile
+ChargingProfile read_charging_profile(const std::string& stored) {
+    auto decoded = compact_encoding::decode_charging_profile(stored);
+    ChargingProfile profile = decoded.profile;
+    for (std::size_t i = 0; i < decoded.schedule_periods.size() and i < profile.chargingSchedule.size(); ++i) {
+        if (!decoded.schedule_periods[i].has_value()) {
+            continue;
+        }
+        auto& periods = profile.chargingSchedule[i].chargingSchedulePeriod;
+        for (const auto& compact_period : decoded.schedule_periods[i].value()) {
+            ChargingSchedulePeriod period;
+            period.startPeriod = compact_period.start_period;
+            period.limit = compact_period.limit;
+            period.numberPhases = compact_period.number_phases;
+            period.phaseToUse = compact_period.phase_to_use;
+            periods.push_back(std::move(period));
+        }
+    }
+    return profile;
+}
+} // namespace
+
 DatabaseHandler::DatabaseHandler(std::unique_ptr<ConnectionInterface> database,
-                                 const fs::path& sql_migration_files_path) :
-    DatabaseHandlerCommon(std::move(database), sql_migration_files_path, MIGRATION_FILE_VERSION_V2) {
+                                 const fs::path& sql_migration_files_path, std::shared_ptr<Executor> executor) :
+    DatabaseHandlerCommon(std::move(database), sql_migration_files_path, MIGRATION_FILE_VERSION_V2),
+    meter_value_buffer_max_size(DEFAULT_METER_VALUE_BUFFER_MAX_SIZE),
+    meter_value_buffer_max_age(DEFAULT_METER_VALUE_BUFFER_MAX_AGE),
+    meter_value_buffer_failed_flushes(0),
+    meter_value_buffer_stopped(false),
+    use_compact_encoding(false),
+    executor(executor != nullptr ? executor : Executor::get_default()),
+    meter_value_buffer_timer(&this->executor->get_io_context(), [this]() { this->on_meter_value_buffer_timer(); }) {
+}
+
+DatabaseHandler::~DatabaseHandler() {
+    try {
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed. The remaining
+        // buffer is written by deinit_sql under the buffer lock without arming the timer again
+        this->executor->run_and_wait([this]() {
+            const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+            this->meter_value_buffer_stopped = true;
+            this->meter_value_buffer_timer.stop();
+        });
+        this->deinit_sql();
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not write buffered metervalues to the database: " << e.what();
+    }
+}
+
+void DatabaseHandler::set_meter_value_buffer_limits(std::size_t max_size, std::chrono::milliseconds max_age) {
+    const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+    this->meter_value_buffer_max_size = max_size;
+    this->meter_value_buffer_max_age = max_age;
+    if (this->meter_value_buffer.size() >= max_size) {
+        this->flush_meter_value_buffer();
+    } else if (!this->meter_value_buffer.empty()) {
+        this->start_meter_value_buffer_timer();
+    }
+}
+
+void DatabaseHandler::start_meter_value_buffer_timer() {
+    if (this->meter_value_buffer_stopped) {
+        return;
+    }
+    const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                           this->meter_value_buffer_oldest);
+    const auto remaining = this->meter_value_buffer_max_age - age;
+    this->meter_value_buffer_timer.timeout(std::max(remaining, std::chrono::milliseconds(0)));
+}
+
+void DatabaseHandler::on_meter_value_buffer_timer() {
+    const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+    try {
+        this->flush_meter_value_buffer();
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not write buffered metervalues to the database: " << e.what();
+    }
+}
+
+void DatabaseHandler::set_compact_encoding(bool enabled) {
+    this->use_compact_encoding = enabled;
 }
 
 void DatabaseHandler::init_sql() {
@@ -44,6 +239,8 @@ void DatabaseHandler::init_sql() {
         throw std::logic_error("SQLite must be in serialized thread mode");
     }
 
+    this->reset_meter_value_statements();
+
     auto get_stmt = this->database->new_statement("SELECT * FROM TRANSACTIONS");
     if (get_stmt->step() == SQLITE_ROW) {
         EVLOG_info << "Not clearing tables as there is an ongoing transaction";
@@ -52,12 +249,31 @@ void DatabaseHandler::init_sql() {
     }
 }
 
+void DatabaseHandler::deinit_sql() {
+    const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+    // Release the statements even if the flush fails, the connection can not be closed while they exist
+    try {
+        this->flush_meter_value_buffer();
+    } catch (...) {
+        this->reset_meter_value_statements();
+        throw;
+    }
+    this->reset_meter_value_statements();
+}
+
+void DatabaseHandler::reset_meter_value_statements() {
+    this->insert_meter_value_stmt.reset();
+    this->insert_meter_value_item_stmt.reset();
+    this->insert_meter_value_block_stmt.reset();
+}
+
 void DatabaseHandler::inintialize_enum_tables() {
 
     // TODO: Don't throw away all meter value items to allow resuming transactions
     // Also we should add functionality then to clean up old/unknown transactions from the database
-    if (!this->database->clear_table("METER_VALUE_ITEMS") or !this->database->clear_table("METER_VALUES")) {
-        EVLOG_error << "Could not clear tables METER_VALUE_ITEMS or METER_VALUES";
+    if (!this->database->clear_table("METER_VALUE_ITEMS") or !this->database->clear_table("METER_VALUES") or
+        !this->database->clear_table("METER_VALUE_BLOCKS")) {
+        EVLOG_error << "Could not clear tables METER_VALUE_ITEMS, METER_VALUES or METER_VALUE_BLOCKS";
         throw QueryExecutionException(this->database->get_error_message());
     }
 
@@ -396,204 +612,400 @@ void DatabaseHandler::transaction_metervalues_insert(const std::string& transact
         throw std::invalid_argument("All metervalues must have the same context");
     }
 
-    const std::string sql1 =
-        "INSERT INTO METER_VALUES (TRANSACTION_ID, TIMESTAMP, READING_CONTEXT, CUSTOM_DATA) VALUES "
-        "(@transaction_id, @timestamp, @context, @custom_data)";
+    const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
 
-    auto stmt = this->database->new_statement(sql1);
-
-    stmt->bind_text("@transaction_id", transaction_id);
-    stmt->bind_int64("@timestamp", to_unix_milliseconds(meter_value.timestamp));
-    stmt->bind_int("@context", static_cast<int>(context));
-    stmt->bind_null("@custom_data");
-
-    if (stmt->step() != SQLITE_DONE) {
-        EVLOG_warning << "Could not insert meter values into database";
-        throw QueryExecutionException(this->database->get_error_message());
+    const auto now = std::chrono::steady_clock::now();
+    const bool is_first = this->meter_value_buffer.empty();
+    if (is_first) {
+        this->meter_value_buffer_oldest = now;
     }
+    this->meter_value_buffer.push_back({transaction_id, context, meter_value});
 
-    auto last_row_id = this->database->get_last_inserted_rowid();
-    (*stmt).reset();
-
-    const std::string sql2 =
-        "INSERT INTO METER_VALUE_ITEMS (METER_VALUE_ID, VALUE, MEASURAND, PHASE, LOCATION, CUSTOM_DATA, "
-        "UNIT_CUSTOM_DATA, UNIT_TEXT, UNIT_MULTIPLIER, SIGNED_METER_DATA, SIGNING_METHOD, "
-        "ENCODING_METHOD, PUBLIC_KEY) VALUES (@meter_value_id, @value, @measurand, "
-        "@phase, @location, @custom_data, @unit_custom_data, @unit_text, @unit_multiplier, "
-        "@signed_meter_data, @signing_method, @encoding_method, @public_key);";
-
-    auto transaction = this->database->begin_transaction();
-    auto insert_stmt = this->database->new_statement(sql2);
+    // The readings at the begin and end of a transaction are needed for crash recovery and the TransactionEvent(Ended)
+    // so they are written right away together with everything that was buffered before
+    if (context == ReadingContextEnum::Transaction_Begin or context == ReadingContextEnum::Transaction_End or
+        this->meter_value_buffer.size() >= this->meter_value_buffer_max_size or
+        now - this->meter_value_buffer_oldest >= this->meter_value_buffer_max_age) {
+        this->flush_meter_value_buffer();
+    } else if (is_first) {
+        // Without further inserts the buffered values would otherwise stay in memory until the transaction ends
+        this->start_meter_value_buffer_timer();
+    }
+}
 
-    for (const auto& item : meter_value.sampledValue) {
-        insert_stmt->bind_int("@meter_value_id", clamp_to<int>(last_row_id));
-        insert_stmt->bind_double("@value", item.value);
+void DatabaseHandler::transaction_metervalues_flush() {
+    const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+    this->flush_meter_value_buffer();
+}
 
-        if (item.measurand.has_value()) {
-            insert_stmt->bind_int("@measurand", static_cast<int>(item.measurand.value()));
-        } else {
-            insert_stmt->bind_null("@measurand");
+void DatabaseHandler::flush_meter_value_buffer() {
+    if (this->meter_value_buffer.empty()) {
+        return;
+    }
+    this->meter_value_buffer_timer.stop();
+
+    bool write_one_by_one = false;
+    try {
+        this->write_meter_values(this->meter_value_buffer);
+    } catch (const std::exception& e) {
+        this->meter_value_buffer_failed_flushes++;
+        // On destruction there is no next flush, so the metervalues are written one by one right away
+        if (this->meter_value_buffer_failed_flushes < METER_VALUE_BUFFER_MAX_FLUSH_ATTEMPTS and
+            !this->meter_value_buffer_stopped) {
+            // The buffer is kept and written again on the next flush, at the latest after the maximum age
+            this->meter_value_buffer_timer.timeout(this->meter_value_buffer_max_age);
+            throw;
         }
+        EVLOG_warning << "Could not write " << this->meter_value_buffer.size() << " buffered metervalues after "
+                      << this->meter_value_buffer_failed_flushes << " attempt(s), writing them one by one: "
+                      << e.what();
+        write_one_by_one = true;
+    }
 
-        if (item.phase.has_value()) {
-            insert_stmt->bind_int("@phase", static_cast<int>(item.phase.value()));
-        } else {
-            insert_stmt->bind_null("@phase");
-        }
+    auto buffer = std::move(this->meter_value_buffer);
+    this->meter_value_buffer.clear();
+    this->meter_value_buffer_failed_flushes = 0;
+    if (write_one_by_one) {
+        this->write_meter_values_one_by_one(buffer);
+    }
+}
 
-        if (item.location.has_value()) {
-            insert_stmt->bind_int("@location", static_cast<int>(item.location.value()));
-        }
+void DatabaseHandler::write_meter_values(const std::vector<BufferedMeterValue>& meter_values) {
+    this->prepare_meter_value_statements();
 
-        if (item.customData.has_value()) {
-            insert_stmt->bind_text("@custom_data", item.customData.value().at("vendorId").get<std::string>(),
-                                   SQLiteString::Transient);
-        }
+    try {
+        auto transaction = this->database->begin_transaction();
 
-        if (item.unitOfMeasure.has_value()) {
-            const auto& unitOfMeasure = item.unitOfMeasure.value();
+        // Compactly encoded metervalues of every transaction and the timestamp their deltas are based on
+        std::map<std::string, std::pair<std::string, std::int64_t>> blocks;
+        const bool compact = this->use_compact_encoding;
 
-            if (unitOfMeasure.customData.has_value()) {
-                insert_stmt->bind_text("@unit_custom_data",
-                                       unitOfMeasure.customData.value().at("vendorId").get<std::string>(),
-                                       SQLiteString::Transient);
-            }
-            if (unitOfMeasure.unit.has_value()) {
-                insert_stmt->bind_text("@unit_text", unitOfMeasure.unit.value().get(), SQLiteString::Transient);
-            }
-            if (unitOfMeasure.multiplier.has_value()) {
-                insert_stmt->bind_int("@unit_multiplier", unitOfMeasure.multiplier.value());
+        for (const auto& buffered : meter_values) {
+            if (compact and is_compact_meter_value(buffered.meter_value)) {
+                auto& [block, last_timestamp] = blocks[buffered.transaction_id];
+                if (block.empty()) {
+                    block += METER_VALUE_BLOCK_ENCODING_V1;
+                }
+                append_meter_value(block, last_timestamp, buffered.context, buffered.meter_value);
+            } else {
+                this->insert_meter_value_rows(buffered);
             }
         }
 
-        if (item.signedMeterValue.has_value()) {
-            const auto& signedMeterValue = item.signedMeterValue.value();
+        for (const auto& [transaction_id, encoded] : blocks) {
+            auto& stmt = *this->insert_meter_value_block_stmt;
+            stmt.bind_text("@transaction_id", transaction_id);
+            stmt.bind_text("@data", encoded.first);
 
-            insert_stmt->bind_text("@signed_meter_data", signedMeterValue.signedMeterData.get(),
-                                   SQLiteString::Transient);
-            if (signedMeterValue.signingMethod.has_value()) {
-                insert_stmt->bind_text("@signing_method", signedMeterValue.signingMethod.value().get(),
-                                       SQLiteString::Transient);
-            } else {
-                insert_stmt->bind_null("@signing_method");
-            }
-            insert_stmt->bind_text("@encoding_method", signedMeterValue.encodingMethod.get(), SQLiteString::Transient);
-            if (signedMeterValue.publicKey.has_value()) {
-                insert_stmt->bind_text("@public_key", signedMeterValue.publicKey.value().get(),
-                                       SQLiteString::Transient);
-            } else {
-                insert_stmt->bind_null("@public_key");
+            if (stmt.step() != SQLITE_DONE) {
+                EVLOG_warning << "Could not insert meter values into database";
+                throw QueryExecutionException(this->database->get_error_message());
             }
-        } else {
-            insert_stmt->bind_null("@signed_meter_data");
-            insert_stmt->bind_null("@signing_method");
-            insert_stmt->bind_null("@encoding_method");
-            insert_stmt->bind_null("@public_key");
+            stmt.reset();
         }
 
-        if (insert_stmt->step() != SQLITE_DONE) {
-            throw QueryExecutionException(this->database->get_error_message());
+        transaction->commit();
+    } catch (...) {
+        // The statements may be left in a stepped state, so they are prepared again on the next write
+        this->reset_meter_value_statements();
+        throw;
+    }
+}
+
+void DatabaseHandler::write_meter_values_one_by_one(const std::vector<BufferedMeterValue>& meter_values) {
+    std::size_t dropped = 0;
+    for (const auto& buffered : meter_values) {
+        try {
+            this->write_meter_values({buffered});
+        } catch (const std::exception& e) {
+            EVLOG_error << "Dropping metervalue of transaction " << buffered.transaction_id
+                        << " that could not be written to the database: " << e.what();
+            dropped++;
         }
+    }
+    if (dropped > 0) {
+        throw QueryExecutionException("Could not write " + std::to_string(dropped) + " of " +
+                                      std::to_string(meter_values.size()) + " buffered metervalues");
+    }
+}
 
-        (*insert_stmt).reset();
+void DatabaseHandler::prepare_meter_value_statements() {
+    if (this->insert_meter_value_stmt == nullptr) {
+        this->insert_meter_value_stmt =
+            this->database->new_statement("INSERT INTO METER_VALUES (TRANSACTION_ID, TIMESTAMP, READING_CONTEXT, "
+                                          "CUSTOM_DATA) VALUES (@transaction_id, @timestamp, @context, @custom_data)");
+    }
+    if (this->insert_meter_value_item_stmt == nullptr) {
+        this->insert_meter_value_item_stmt = this->database->new_statement(
+            "INSERT INTO METER_VALUE_ITEMS (METER_VALUE_ID, VALUE, MEASURAND, PHASE, LOCATION, CUSTOM_DATA, "
+            "UNIT_CUSTOM_DATA, UNIT_TEXT, UNIT_MULTIPLIER, SIGNED_METER_DATA, SIGNING_METHOD, "
+            "ENCODING_METHOD, PUBLIC_KEY) VALUES (@meter_value_id, @value, @measurand, "
+            "@phase, @location, @custom_data, @unit_custom_data, @unit_text, @unit_multiplier, "
+            "@signed_meter_data, @signing_method, @encoding_method, @public_key);");
     }
 
-    transaction->commit();
+    if (this->insert_meter_value_block_stmt == nullptr) {
+        this->insert_meter_value_block_stmt = this->database->new_statement(
+            "INSERT INTO METER_VALUE_BLOCKS (TRANSACTION_ID, DATA) VALUES (@transaction_id, @data)");
+    }
 }
 
-std::vector<MeterValue> DatabaseHandler::transaction_metervalues_get_all(const std::string& transaction_id) {
+void DatabaseHandler::insert_meter_value_rows(const BufferedMeterValue& buffered) {
+    auto& stmt = *this->insert_meter_value_stmt;
+    stmt.bind_text("@transaction_id", buffered.transaction_id);
+    stmt.bind_int64("@timestamp", to_unix_milliseconds(buffered.meter_value.timestamp));
+    stmt.bind_int("@context", static_cast<int>(buffered.context));
+    stmt.bind_null("@custom_data");
 
-    const std::string sql1 = "SELECT * FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id;";
-    const std::string sql2 = "SELECT * FROM METER_VALUE_ITEMS WHERE METER_VALUE_ID = @row_id;";
-    auto select_stmt = this->database->new_statement(sql1);
-    auto select_stmt2 = this->database->new_statement(sql2);
+    if (stmt.step() != SQLITE_DONE) {
+        EVLOG_warning << "Could not insert meter values into database";
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+    stmt.reset();
 
-    select_stmt->bind_text("@transaction_id", transaction_id);
+    const auto meter_value_id = this->database->get_last_inserted_rowid();
+    for (const auto& item : buffered.meter_value.sampledValue) {
+        this->insert_meter_value_item(meter_value_id, item);
+    }
+}
 
-    std::vector<MeterValue> result;
+void DatabaseHandler::insert_meter_value_item(const std::int64_t meter_value_id, const SampledValue& item) {
+    auto& stmt = *this->insert_meter_value_item_stmt;
 
-    int status = SQLITE_ERROR;
-    while ((status = select_stmt->step()) == SQLITE_ROW) {
-        MeterValue value;
-        value.timestamp = from_unix_milliseconds(select_stmt->column_int64(2));
+    // The statement is reused, so every parameter is bound to clear the values of the previous item
+    stmt.bind_int("@meter_value_id", clamp_to<int>(meter_value_id));
+    stmt.bind_double("@value", item.value);
+
+    if (item.measurand.has_value()) {
+        stmt.bind_int("@measurand", static_cast<int>(item.measurand.value()));
+    } else {
+        stmt.bind_null("@measurand");
+    }
+
+    if (item.phase.has_value()) {
+        stmt.bind_int("@phase", static_cast<int>(item.phase.value()));
+    } else {
+        stmt.bind_null("@phase");
+    }
+
+    if (item.location.has_value()) {
+        stmt.bind_int("@location", static_cast<int>(item.location.value()));
+    } else {
+        stmt.bind_null("@location");
+    }
+
+    if (item.customData.has_value()) {
+        stmt.bind_text("@custom_data", item.customData.value().at("vendorId").get<std::string>(),
+                       SQLiteString::Transient);
+    } else {
+        stmt.bind_null("@custom_data");
+    }
+
+    stmt.bind_null("@unit_custom_data");
+    stmt.bind_null("@unit_text");
+    stmt.bind_null("@unit_multiplier");
+    if (item.unitOfMeasure.has_value()) {
+        const auto& unitOfMeasure = item.unitOfMeasure.value();
 
-        if (select_stmt->column_type(4) == SQLITE_TEXT) {
-            value.customData = CustomData{select_stmt->column_text(4)};
+        if (unitOfMeasure.customData.has_value()) {
+            stmt.bind_text("@unit_custom_data", unitOfMeasure.customData.value().at("vendorId").get<std::string>(),
+                           SQLiteString::Transient);
+        }
+        if (unitOfMeasure.unit.has_value()) {
+            stmt.bind_text("@unit_text", unitOfMeasure.unit.value().get(), SQLiteString::Transient);
         }
+        if (unitOfMeasure.multiplier.has_value()) {
+            stmt.bind_int("@unit_multiplier", unitOfMeasure.multiplier.value());
+        }
+    }
 
-        auto row_id = select_stmt->column_int(0);
-        auto context = static_cast<ReadingContextEnum>(select_stmt->column_int(3));
+    if (item.signedMeterValue.has_value()) {
+        const auto& signedMeterValue = item.signedMeterValue.value();
 
-        select_stmt2->bind_int("@row_id", row_id);
+        stmt.bind_text("@signed_meter_data", signedMeterValue.signedMeterData.get(), SQLiteString::Transient);
+        if (signedMeterValue.signingMethod.has_value()) {
+            stmt.bind_text("@signing_method", signedMeterValue.signingMethod.value().get(), SQLiteString::Transient);
+        } else {
+            stmt.bind_null("@signing_method");
+        }
+        stmt.bind_text("@encoding_method", signedMeterValue.encodingMethod.get(), SQLiteString::Transient);
+        if (signedMeterValue.publicKey.has_value()) {
+            stmt.bind_text("@public_key", signedMeterValue.publicKey.value().get(), SQLiteString::Transient);
+        } else {
+            stmt.bind_null("@public_key");
+        }
+    } else {
+        stmt.bind_null("@signed_meter_data");
+        stmt.bind_null("@signing_method");
+        stmt.bind_null("@encoding_method");
+        stmt.bind_null("@public_key");
+    }
 
-        while ((status = select_stmt2->step()) == SQLITE_ROW) {
-            SampledValue sampled_value;
+    if (stmt.step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
 
-            sampled_value.value = clamp_to<float>(select_stmt2->column_double(1));
-            sampled_value.context = context;
+    stmt.reset();
+}
 
-            if (select_stmt2->column_type(2) == SQLITE_INTEGER) {
-                sampled_value.measurand = static_cast<MeasurandEnum>(select_stmt2->column_int(2));
-            }
+MeterValue DatabaseHandler::read_meter_value_row(everest::db::sqlite::StatementInterface& select_stmt,
+                                                 everest::db::sqlite::StatementInterface& select_items_stmt) {
+    MeterValue value;
+    value.timestamp = from_unix_milliseconds(select_stmt.column_int64(2));
 
-            if (select_stmt2->column_type(3) == SQLITE_INTEGER) {
-                sampled_value.phase = static_cast<PhaseEnum>(select_stmt2->column_int(3));
-            }
+    if (select_stmt.column_type(4) == SQLITE_TEXT) {
+        value.customData = CustomData{select_stmt.column_text(4)};
+    }
 
-            if (select_stmt2->column_type(4) == SQLITE_INTEGER) {
-                sampled_value.location = static_cast<LocationEnum>(select_stmt2->column_int(4));
-            }
+    auto row_id = select_stmt.column_int(0);
+    auto context = static_cast<ReadingContextEnum>(select_stmt.column_int(3));
 
-            if (select_stmt2->column_type(5) == SQLITE_TEXT) {
-                sampled_value.customData = CustomData{select_stmt->column_text(5)};
-            }
+    select_items_stmt.bind_int("@row_id", row_id);
 
-            if (select_stmt2->column_type(6) == SQLITE_TEXT or select_stmt2->column_type(7) == SQLITE_TEXT or
-                select_stmt2->column_type(8) == SQLITE_INTEGER) {
-                UnitOfMeasure unit;
-                if (select_stmt2->column_type(6) == SQLITE_TEXT) {
-                    unit.customData = CustomData{select_stmt2->column_text(6)};
-                }
-                if (select_stmt2->column_type(7) == SQLITE_TEXT) {
-                    unit.unit = select_stmt2->column_text(7);
-                }
-                if (select_stmt2->column_type(8) == SQLITE_INTEGER) {
-                    unit.multiplier = select_stmt2->column_int(8);
-                }
-                sampled_value.unitOfMeasure.emplace(unit);
-            }
+    int status = SQLITE_ERROR;
+    while ((status = select_items_stmt.step()) == SQLITE_ROW) {
+        SampledValue sampled_value;
 
-            if (select_stmt2->column_type(9) == SQLITE_TEXT and select_stmt2->column_type(10) == SQLITE_TEXT and
-                select_stmt2->column_type(11) == SQLITE_TEXT and select_stmt2->column_type(12) == SQLITE_TEXT) {
-                SignedMeterValue signed_meter_value;
-                signed_meter_value.signedMeterData = select_stmt2->column_text(9);
-                signed_meter_value.signingMethod = select_stmt2->column_text(10);
-                signed_meter_value.encodingMethod = select_stmt2->column_text(11);
-                signed_meter_value.publicKey = select_stmt2->column_text(12);
+        sampled_value.value = clamp_to<float>(select_items_stmt.column_double(1));
+        sampled_value.context = context;
 
-                sampled_value.signedMeterValue.emplace(signed_meter_value);
-            }
+        if (select_items_stmt.column_type(2) == SQLITE_INTEGER) {
+            sampled_value.measurand = static_cast<MeasurandEnum>(select_items_stmt.column_int(2));
+        }
 
-            value.sampledValue.push_back(std::move(sampled_value));
+        if (select_items_stmt.column_type(3) == SQLITE_INTEGER) {
+            sampled_value.phase = static_cast<PhaseEnum>(select_items_stmt.column_int(3));
         }
 
-        if (status != SQLITE_DONE) {
-            throw QueryExecutionException(this->database->get_error_message());
+        if (select_items_stmt.column_type(4) == SQLITE_INTEGER) {
+            sampled_value.location = static_cast<LocationEnum>(select_items_stmt.column_int(4));
+        }
+
+        if (select_items_stmt.column_type(5) == SQLITE_TEXT) {
+            sampled_value.customData = CustomData{select_items_stmt.column_text(5)};
+        }
+
+        if (select_items_stmt.column_type(6) == SQLITE_TEXT or select_items_stmt.column_type(7) == SQLITE_TEXT or
+            select_items_stmt.column_type(8) == SQLITE_INTEGER) {
+            UnitOfMeasure unit;
+            if (select_items_stmt.column_type(6) == SQLITE_TEXT) {
+                unit.customData = CustomData{select_items_stmt.column_text(6)};
+            }
+            if (select_items_stmt.column_type(7) == SQLITE_TEXT) {
+                unit.unit = select_items_stmt.column_text(7);
+            }
+            if (select_items_stmt.column_type(8) == SQLITE_INTEGER) {
+                unit.multiplier = select_items_stmt.column_int(8);
+            }
+            sampled_value.unitOfMeasure.emplace(unit);
         }
 
-        result.push_back(std::move(value));
+        if (select_items_stmt.column_type(9) == SQLITE_TEXT and select_items_stmt.column_type(10) == SQLITE_TEXT and
+            select_items_stmt.column_type(11) == SQLITE_TEXT and select_items_stmt.column_type(12) == SQLITE_TEXT) {
+            SignedMeterValue signed_meter_value;
+            signed_meter_value.signedMeterData = select_items_stmt.column_text(9);
+            signed_meter_value.signingMethod = select_items_stmt.column_text(10);
+            signed_meter_value.encodingMethod = select_items_stmt.column_text(11);
+            signed_meter_value.publicKey = select_items_stmt.column_text(12);
 
-        (*select_stmt2).reset();
+            sampled_value.signedMeterValue.emplace(signed_meter_value);
+        }
+
+        value.sampledValue.push_back(std::move(sampled_value));
     }
 
     if (status != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+    select_items_stmt.reset();
+    return value;
+}
 
+std::vector<MeterValue> DatabaseHandler::transaction_metervalues_get_all(const std::string& transaction_id) {
+    std::vector<MeterValue> result;
+    this->transaction_metervalues_for_each(
+        transaction_id, [&result](MeterValue&& meter_value) { result.push_back(std::move(meter_value)); });
     return result;
 }
 
+void DatabaseHandler::transaction_metervalues_for_each(const std::string& transaction_id,
+                                                       const std::function<void(MeterValue&& meter_value)>& callback) {
+    this->transaction_metervalues_flush();
+
+    auto select_stmt = this->database->new_statement(
+        "SELECT * FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id ORDER BY TIMESTAMP, ROWID;");
+    auto select_items_stmt =
+        this->database->new_statement("SELECT * FROM METER_VALUE_ITEMS WHERE METER_VALUE_ID = @row_id;");
+    auto select_blocks_stmt = this->database->new_statement(
+        "SELECT DATA FROM METER_VALUE_BLOCKS WHERE TRANSACTION_ID = @transaction_id ORDER BY ROWID;");
+    select_stmt->bind_text("@transaction_id", transaction_id);
+    select_blocks_stmt->bind_text("@transaction_id", transaction_id);
+
+    auto read_next_row = [&]() -> std::optional<MeterValue> {
+        const auto status = select_stmt->step();
+        if (status == SQLITE_ROW) {
+            return this->read_meter_value_row(*select_stmt, *select_items_stmt);
+        }
+        if (status != SQLITE_DONE) {
+            throw QueryExecutionException(this->database->get_error_message());
+        }
+        return std::nullopt;
+    };
+
+    // Only a single block is decoded at a time, so the metervalues of long transactions are never all in memory
+    std::vector<MeterValue> block;
+    std::size_t block_pos = 0;
+    // A statement that is stepped again after SQLITE_DONE starts over, so it must not be stepped once it is done
+    bool blocks_done = false;
+    auto peek_next_block_value = [&]() -> MeterValue* {
+        while (block_pos >= block.size()) {
+            if (blocks_done) {
+                return nullptr;
+            }
+            const auto status = select_blocks_stmt->step();
+            if (status == SQLITE_DONE) {
+                blocks_done = true;
+                return nullptr;
+            }
+            if (status != SQLITE_ROW) {
+                throw QueryExecutionException(this->database->get_error_message());
+            }
+            block.clear();
+            block_pos = 0;
+            decode_meter_value_block(select_blocks_stmt->column_text(0), block);
+        }
+        return &block[block_pos];
+    };
+
+    // Metervalues in blocks and in the regular tables are interleaved when the encoding changed during the
+    // transaction, so both are merged by timestamp
+    auto row_value = read_next_row();
+    while (true) {
+        auto* block_value = peek_next_block_value();
+        if (row_value.has_value() and (block_value == nullptr or !(block_value->timestamp < row_value->timestamp))) {
+            callback(std::move(row_value.value()));
+            row_value = read_next_row();
+        } else if (block_value != nullptr) {
+            callback(std::move(*block_value));
+            ++block_pos;
+        } else {
+            break;
+        }
+    }
+}
+
 void DatabaseHandler::transaction_metervalues_clear(const std::string& transaction_id) {
+    {
+        const std::lock_guard<std::mutex> lk(this->meter_value_buffer_mutex);
+        this->meter_value_buffer.erase(std::remove_if(this->meter_value_buffer.begin(), this->meter_value_buffer.end(),
+                                                      [&transaction_id](const BufferedMeterValue& buffered) {
+                                                          return buffered.transaction_id == transaction_id;
+                                                      }),
+                                       this->meter_value_buffer.end());
+        if (this->meter_value_buffer.empty()) {
+            this->meter_value_buffer_timer.stop();
+        }
+    }
 
     const std::string sql1 = "SELECT ROWID FROM METER_VALUES WHERE TRANSACTION_ID = @transaction_id;";
 
@@ -624,6 +1036,13 @@ void DatabaseHandler::transaction_metervalues_clear(const std::string& transacti
     if (delete_stmt2->step() != SQLITE_DONE) {
         throw QueryExecutionException(this->database->get_error_message());
     }
+
+    const std::string sql4 = "DELETE FROM METER_VALUE_BLOCKS WHERE TRANSACTION_ID = @transaction_id";
+    auto delete_stmt3 = this->database->new_statement(sql4);
+    delete_stmt3->bind_text("@transaction_id", transaction_id);
+    if (delete_stmt3->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
 }
 
 void DatabaseHandler::insert_cs_availability(OperationalStatusEnum operational_status, bool replace) {
@@ -782,7 +1201,11 @@ void DatabaseHandler::insert_or_update_charging_profile(const int evse_id, const
         stmt->bind_null("@transaction_id");
     }
 
-    stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
+    if (this->use_compact_encoding) {
+        stmt->bind_text("@profile", compact_encoding::encode_charging_profile(json_profile), SQLiteString::Transient);
+    } else {
+        stmt->bind_text("@profile", json_profile.dump(), SQLiteString::Transient);
+    }
     stmt->bind_text("@charging_limit_source", charging_limit_source.get());
 
     if (stmt->step() != SQLITE_DONE) {
@@ -903,7 +1326,7 @@ DatabaseHandler::get_charging_profiles_matching_criteria(const std::optional<std
         }
 
         while (stmt->step() != SQLITE_DONE) {
-            results.emplace_back(json::parse(stmt->column_text(1)), // profile
+            results.emplace_back(read_charging_profile(stmt->column_text(1)), // profile
                                  stmt->column_int(0),               // EVSE ID
                                  CiString<20>(stmt->column_text(2)) // source
             );
@@ -949,7 +1372,7 @@ DatabaseHandler::get_charging_profiles_matching_criteria(const std::optional<std
     }
 
     while (stmt->step() != SQLITE_DONE) {
-        results.emplace_back(json::parse(stmt->column_text(1)), // profile
+        results.emplace_back(read_charging_profile(stmt->column_text(1)), // profile
                              stmt->column_int(0),               // EVSE ID
                              CiString<20>(stmt->column_text(2)) // source
         );
@@ -968,7 +1391,7 @@ std::vector<v2::ChargingProfile> DatabaseHandler::get_charging_profiles_for_evse
     stmt->bind_int("@evse_id", evse_id);
 
     while (stmt->step() != SQLITE_DONE) {
-        auto profile = json::parse(stmt->column_text(0));
+        auto profile = read_charging_profile(stmt->column_text(0));
         profiles.push_back(profile);
     }
 
@@ -983,7 +1406,7 @@ std::vector<v2::ChargingProfile> DatabaseHandler::get_all_charging_profiles() {
     auto stmt = this->database->new_statement(sql);
 
     while (stmt->step() != SQLITE_DONE) {
-        auto profile = json::parse(stmt->column_text(0));
+        auto profile = read_charging_profile(stmt->column_text(0));
         profiles.push_back(profile);
     }
 
@@ -999,7 +1422,7 @@ std::map<std::int32_t, std::vector<v2::ChargingProfile>> DatabaseHandler::get_al
 
     while (stmt->step() != SQLITE_DONE) {
         auto evse_id = stmt->column_int(0);
-        auto profile = json::parse(stmt->column_text(1));
+        auto profile = read_charging_profile(stmt->column_text(1));
 
         auto profiles = map[evse_id];
         profiles.emplace_back(profile);
@@ -1030,6 +1453,114 @@ CiString<20> DatabaseHandler::get_charging_limit_source_for_profile(const int pr
     return res;
 }
 
+void DatabaseHandler::insert_or_update_default_tariff(const std::int32_t evse_id, const Tariff& tariff) {
+    const std::string sql =
+        "INSERT OR REPLACE INTO DEFAULT_TARIFFS (TARIFF_ID, EVSE_ID, TARIFF) VALUES (@tariff_id, @evse_id, @tariff)";
+    auto stmt = this->database->new_statement(sql);
+
+    stmt->bind_text("@tariff_id", tariff.tariffId.get(), SQLiteString::Transient);
+    stmt->bind_int("@evse_id", evse_id);
+    stmt->bind_text("@tariff", json(tariff).dump(), SQLiteString::Transient);
+
+    if (stmt->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+}
+
+std::vector<std::pair<std::int32_t, Tariff>> DatabaseHandler::get_default_tariffs() {
+    std::vector<std::pair<std::int32_t, Tariff>> tariffs;
+
+    const std::string sql = "SELECT EVSE_ID, TARIFF FROM DEFAULT_TARIFFS";
+    auto stmt = this->database->new_statement(sql);
+
+    int status = SQLITE_ERROR;
+    while ((status = stmt->step()) == SQLITE_ROW) {
+        tariffs.emplace_back(stmt->column_int(0), json::parse(stmt->column_text(1)));
+    }
+
+    if (status != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    return tariffs;
+}
+
+bool DatabaseHandler::delete_default_tariff(const std::int32_t evse_id, const std::string& tariff_id) {
+    const std::string sql = "DELETE FROM DEFAULT_TARIFFS WHERE TARIFF_ID = @tariff_id AND EVSE_ID = @evse_id";
+    auto stmt = this->database->new_statement(sql);
+
+    stmt->bind_text("@tariff_id", tariff_id, SQLiteString::Transient);
+    stmt->bind_int("@evse_id", evse_id);
+    if (stmt->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    return stmt->changes() > 0;
+}
+
+void DatabaseHandler::insert_or_update_der_control(const v21::SetDERControlRequest& control,
+                                                   const bool is_superseded) {
+    const std::string sql = "INSERT OR REPLACE INTO DER_CONTROLS (CONTROL_ID, IS_DEFAULT, CONTROL_TYPE, IS_SUPERSEDED, "
+                            "CONTROL) VALUES (@control_id, @is_default, @control_type, @is_superseded, @control)";
+    auto stmt = this->database->new_statement(sql);
+
+    stmt->bind_text("@control_id", control.controlId.get(), SQLiteString::Transient);
+    stmt->bind_int("@is_default", control.isDefault ? 1 : 0);
+    stmt->bind_text("@control_type", conversions::dercontrol_enum_to_string(control.controlType),
+                    SQLiteString::Transient);
+    stmt->bind_int("@is_superseded", is_superseded ? 1 : 0);
+    stmt->bind_text("@control", json(control).dump(), SQLiteString::Transient);
+
+    if (stmt->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+}
+
+std::vector<StoredDERControl> DatabaseHandler::get_der_controls() {
+    std::vector<StoredDERControl> controls;
+
+    const std::string sql = "SELECT CONTROL, IS_SUPERSEDED FROM DER_CONTROLS";
+    auto stmt = this->database->new_statement(sql);
+
+    int status = SQLITE_ERROR;
+    while ((status = stmt->step()) == SQLITE_ROW) {
+        const v21::SetDERControlRequest control = json::parse(stmt->column_text(0));
+        controls.push_back({control, stmt->column_int(1) != 0});
+    }
+
+    if (status != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    return controls;
+}
+
+bool DatabaseHandler::delete_der_controls(const bool is_default, const std::optional<DERControlEnum>& control_type,
+                                          const std::optional<std::string>& control_id) {
+    std::string sql = "DELETE FROM DER_CONTROLS WHERE IS_DEFAULT = @is_default";
+    if (control_type.has_value()) {
+        sql += " AND CONTROL_TYPE = @control_type";
+    }
+    if (control_id.has_value()) {
+        sql += " AND CONTROL_ID = @control_id";
+    }
+    auto stmt = this->database->new_statement(sql);
+
+    stmt->bind_int("@is_default", is_default ? 1 : 0);
+    if (control_type.has_value()) {
+        stmt->bind_text("@control_type", conversions::dercontrol_enum_to_string(control_type.value()),
+                        SQLiteString::Transient);
+    }
+    if (control_id.has_value()) {
+        stmt->bind_text("@control_id", control_id.value(), SQLiteString::Transient);
+    }
+    if (stmt->step() != SQLITE_DONE) {
+        throw QueryExecutionException(this->database->get_error_message());
+    }
+
+    return stmt->changes() > 0;
+}
+
 std::unique_ptr<StatementInterface> DatabaseHandler::new_statement(const std::string& sql) {
     return this->database->new_statement(sql);
 }
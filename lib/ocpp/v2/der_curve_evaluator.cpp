@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/der_curve_evaluator.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace ocpp::v2 {
+
+namespace {
+/// \returns the points of \p curve sorted by x, without points that have the same x as their predecessor
+std::vector<DERCurvePoints> normalize(const std::vector<DERCurvePoints>& curve) {
+    std::vector<DERCurvePoints> points = curve;
+    std::stable_sort(points.begin(), points.end(),
+                     [](const DERCurvePoints& lhs, const DERCurvePoints& rhs) { return lhs.x < rhs.x; });
+    points.erase(std::unique(points.begin(), points.end(),
+                             [](const DERCurvePoints& lhs, const DERCurvePoints& rhs) { return lhs.x == rhs.x; }),
+                 points.end());
+    return points;
+}
+} // namespace
+
+DERCurveEvaluator::DERCurveEvaluator(const std::vector<std::vector<DERCurvePoints>>& curves) :
+    number_of_curves(curves.size()) {
+    std::vector<std::vector<DERCurvePoints>> normalized;
+    normalized.reserve(curves.size());
+    for (const auto& curve : curves) {
+        normalized.push_back(normalize(curve));
+        // A curve with n points has n - 1 segments and therefore n - 1 hinges
+        const auto& points = normalized.back();
+        if (points.size() > 1) {
+            this->number_of_hinges = std::max(this->number_of_hinges, points.size() - 1);
+        }
+    }
+
+    this->x_min.resize(this->number_of_curves, 0.0F);
+    this->x_max.resize(this->number_of_curves, 0.0F);
+    this->y_start.resize(this->number_of_curves, 0.0F);
+    // Padding hinges have a slope of 0, so they do not contribute to the result
+    this->knots.resize(this->number_of_hinges * this->number_of_curves, 0.0F);
+    this->slopes.resize(this->number_of_hinges * this->number_of_curves, 0.0F);
+
+    for (std::size_t i = 0; i < this->number_of_curves; i++) {
+        const auto& points = normalized.at(i);
+        if (points.empty()) {
+            continue;
+        }
+        this->x_min[i] = points.front().x;
+        this->x_max[i] = points.back().x;
+        this->y_start[i] = points.front().y;
+
+        float previous_slope = 0.0F;
+        for (std::size_t k = 0; k + 1 < points.size(); k++) {
+            const auto slope = (points[k + 1].y - points[k].y) / (points[k + 1].x - points[k].x);
+            this->knots[(k * this->number_of_curves) + i] = points[k].x;
+            this->slopes[(k * this->number_of_curves) + i] = slope - previous_slope;
+            previous_slope = slope;
+        }
+    }
+}
+
+std::size_t DERCurveEvaluator::size() const {
+    return this->number_of_curves;
+}
+
+void DERCurveEvaluator::evaluate(const std::vector<float>& inputs, std::vector<float>& outputs) const {
+    const auto n = this->number_of_curves;
+    if (inputs.size() < n) {
+        throw std::invalid_argument("DERCurveEvaluator needs an input for each of the " + std::to_string(n) +
+                                    " curves, got " + std::to_string(inputs.size()));
+    }
+    outputs.resize(n);
+
+    const float* x_min = this->x_min.data();
+    const float* x_max = this->x_max.data();
+    const float* x = inputs.data();
+    float* y = outputs.data();
+
+    for (std::size_t i = 0; i < n; i++) {
+        y[i] = this->y_start[i];
+    }
+    for (std::size_t k = 0; k < this->number_of_hinges; k++) {
+        const float* knot = this->knots.data() + (k * n);
+        const float* slope = this->slopes.data() + (k * n);
+        for (std::size_t i = 0; i < n; i++) {
+            const auto clamped = std::min(std::max(x[i], x_min[i]), x_max[i]);
+            y[i] += slope[i] * std::max(0.0F, clamped - knot[i]);
+        }
+    }
+}
+
+} // namespace ocpp::v2
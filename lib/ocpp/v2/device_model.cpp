@@ -8,6 +8,9 @@
 #include <ocpp/v2/device_model_storage_sqlite.hpp>
 #include <ocpp/v2/utils.hpp>
 
+#include <set>
+#include <tuple>
+
 namespace ocpp {
 
 namespace v2 {
@@ -432,6 +435,196 @@ SetVariableStatusEnum DeviceModel::set_value(const Component& component, const V
     return result;
 };
 
+std::vector<GetVariableResult>
+DeviceModel::request_values(const std::vector<GetVariableData>& get_variable_data_vector) {
+    std::vector<GetVariableResult> results;
+    results.reserve(get_variable_data_vector.size());
+
+    // indices into results that require a lookup in the storage
+    std::vector<std::size_t> pending;
+    std::vector<VariableAttributeKey> keys;
+
+    for (const auto& get_variable_data : get_variable_data_vector) {
+        GetVariableResult result;
+        result.component = get_variable_data.component;
+        result.variable = get_variable_data.variable;
+        result.attributeType = get_variable_data.attributeType.value_or(AttributeEnum::Actual);
+
+        const auto component_it = this->device_model_map.find(get_variable_data.component);
+        if (component_it == this->device_model_map.end()) {
+            result.attributeStatus = GetVariableStatusEnum::UnknownComponent;
+        } else if (component_it->second.find(get_variable_data.variable) == component_it->second.end()) {
+            result.attributeStatus = GetVariableStatusEnum::UnknownVariable;
+        } else {
+            pending.push_back(results.size());
+            keys.push_back({get_variable_data.component, get_variable_data.variable, result.attributeType.value()});
+        }
+        results.push_back(std::move(result));
+    }
+
+    const auto attributes = this->device_model->get_variable_attributes_batch(keys);
+
+    for (std::size_t i = 0; i < pending.size(); i++) {
+        auto& result = results.at(pending[i]);
+        const auto& attribute_opt = attributes.at(i);
+
+        if ((not attribute_opt) or (not attribute_opt->value)) {
+            result.attributeStatus = GetVariableStatusEnum::NotSupportedAttributeType;
+        } else if (attribute_opt->mutability.has_value() and
+                   attribute_opt->mutability.value() == MutabilityEnum::WriteOnly) {
+            result.attributeStatus = GetVariableStatusEnum::Rejected;
+        } else {
+            result.attributeStatus = GetVariableStatusEnum::Accepted;
+            result.attributeValue = attribute_opt->value.value();
+        }
+    }
+
+    return results;
+}
+
+std::vector<SetVariableStatusEnum> DeviceModel::set_values(const std::vector<SetVariableData>& set_variable_data_vector,
+                                                           const std::string& source, const bool allow_read_only) {
+    std::vector<SetVariableStatusEnum> results;
+    results.reserve(set_variable_data_vector.size());
+
+    std::size_t first = 0;
+    while (first < set_variable_data_vector.size()) {
+        // Extend the batch until a VariableAttribute repeats, its value has to be validated against the earlier one
+        std::set<std::tuple<Component, Variable, AttributeEnum>> batch_keys;
+        std::size_t last = first;
+        while (last < set_variable_data_vector.size()) {
+            const auto& set_variable_data = set_variable_data_vector[last];
+            if (!batch_keys
+                     .emplace(set_variable_data.component, set_variable_data.variable,
+                              set_variable_data.attributeType.value_or(AttributeEnum::Actual))
+                     .second) {
+                break;
+            }
+            last++;
+        }
+
+        if (first == 0 and last == set_variable_data_vector.size()) {
+            return this->set_values_batch(set_variable_data_vector, source, allow_read_only);
+        }
+
+        const auto batch_results =
+            this->set_values_batch({set_variable_data_vector.begin() + first, set_variable_data_vector.begin() + last},
+                                   source, allow_read_only);
+        results.insert(results.end(), batch_results.begin(), batch_results.end());
+        first = last;
+    }
+
+    return results;
+}
+
+std::vector<SetVariableStatusEnum>
+DeviceModel::set_values_batch(const std::vector<SetVariableData>& set_variable_data_vector, const std::string& source,
+                              const bool allow_read_only) {
+    std::vector<SetVariableStatusEnum> results(set_variable_data_vector.size(), SetVariableStatusEnum::Rejected);
+
+    // indices into set_variable_data_vector that passed the validation against the in-memory device model
+    std::vector<std::size_t> pending;
+    std::vector<VariableAttributeKey> keys;
+
+    for (std::size_t i = 0; i < set_variable_data_vector.size(); i++) {
+        const auto& set_variable_data = set_variable_data_vector[i];
+        const auto& component = set_variable_data.component;
+        const auto& variable = set_variable_data.variable;
+        const auto& value = set_variable_data.attributeValue.get();
+
+        const auto component_it = this->device_model_map.find(component);
+        if (component_it == this->device_model_map.end()) {
+            results[i] = SetVariableStatusEnum::UnknownComponent;
+            continue;
+        }
+        const auto variable_it = component_it->second.find(variable);
+        if (variable_it == component_it->second.end()) {
+            results[i] = SetVariableStatusEnum::UnknownVariable;
+            continue;
+        }
+
+        try {
+            if (!validate_value(variable_it->second.characteristics, value, allow_zero(component, variable))) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Could not validate value: " << value << " for component: " << component
+                          << " and variable: " << variable;
+            continue;
+        }
+
+        pending.push_back(i);
+        keys.push_back({component, variable, set_variable_data.attributeType.value_or(AttributeEnum::Actual)});
+    }
+
+    const auto attributes = this->device_model->get_variable_attributes_batch(keys);
+
+    std::vector<std::size_t> writable;
+    std::vector<VariableAttributeValueUpdate> updates;
+    for (std::size_t i = 0; i < pending.size(); i++) {
+        const auto& attribute = attributes.at(i);
+        if (!attribute.has_value()) {
+            results[pending[i]] = SetVariableStatusEnum::NotSupportedAttributeType;
+            continue;
+        }
+
+        // If allow_read_only is false, don't allow read only
+        if (!attribute.value().mutability.has_value() or
+            ((attribute.value().mutability.value() == MutabilityEnum::ReadOnly) and !allow_read_only)) {
+            continue;
+        }
+
+        writable.push_back(i);
+        updates.push_back({keys.at(i), set_variable_data_vector[pending[i]].attributeValue.get(), source});
+    }
+
+    const auto update_results = this->device_model->set_variable_attribute_values_batch(updates);
+
+    std::vector<VariableChange> changes;
+    for (std::size_t i = 0; i < writable.size(); i++) {
+        const auto pending_index = writable[i];
+        const auto data_index = pending[pending_index];
+        results[data_index] = update_results.at(i);
+
+        const auto& key = keys.at(pending_index);
+        // Only trigger for actual values
+        if (key.attribute_enum != AttributeEnum::Actual or update_results.at(i) != SetVariableStatusEnum::Accepted or
+            (!variables_listener and !variable_listener)) {
+            continue;
+        }
+
+        const auto& meta_data = this->device_model_map.at(key.component).at(key.variable);
+        if (meta_data.monitors.empty()) {
+            continue;
+        }
+
+        const auto& attribute = attributes.at(pending_index).value();
+        auto value_previous = attribute.value.has_value() ? attribute.value->get() : std::string{};
+        auto value_current = set_variable_data_vector[data_index].attributeValue.get();
+
+        // If we had a variable value change, the listener is triggered once the whole batch has been handled
+        if (value_previous != value_current) {
+            changes.push_back({meta_data.monitors, key.component, key.variable, meta_data.characteristics, attribute,
+                               std::move(value_previous), std::move(value_current)});
+        }
+    }
+
+    if (changes.empty()) {
+        return results;
+    }
+
+    if (variables_listener) {
+        variables_listener(changes);
+    } else {
+        for (const auto& change : changes) {
+            variable_listener(change.monitors, change.component, change.variable, change.characteristics,
+                              change.attribute, change.value_previous, change.value_current);
+        }
+    }
+
+    return results;
+}
+
 DeviceModel::DeviceModel(std::unique_ptr<DeviceModelStorageInterface> device_model_storage_interface) :
     device_model{std::move(device_model_storage_interface)} {
     this->device_model_map = this->device_model->get_device_model();
@@ -3,7 +3,10 @@
 
 #include <everest/database/sqlite/statement.hpp>
 #include <everest/logging.hpp>
+#include <algorithm>
 #include <limits>
+#include <set>
+#include <tuple>
 #include <ocpp/v2/charge_point.hpp>
 #include <ocpp/v2/device_model_storage_sqlite.hpp>
 #include <ocpp/v2/init_device_model_db.hpp>
@@ -17,14 +20,79 @@ using namespace common;
 
 namespace v2 {
 
+namespace {
+/// \brief Maximum number of keys that are resolved by a single query. Each key binds at most a component name and a
+/// variable name, which keeps a query below the SQLITE_MAX_VARIABLE_NUMBER of 999 of older SQLite versions
+constexpr std::size_t MAX_KEYS_PER_QUERY = 499;
+
+/// \brief Creates a comma separated list of \p count sqlite parameter placeholders
+std::string make_placeholders(const std::size_t count) {
+    std::string placeholders;
+    for (std::size_t i = 0; i < count; i++) {
+        placeholders += (i == 0) ? "?" : ", ?";
+    }
+    return placeholders;
+}
+
+/// \brief Reads a component (NAME, INSTANCE, EVSE_ID, CONNECTOR_ID) from the given statement starting at column
+/// \p first_column
+Component read_component(StatementInterface& stmt, const int first_column) {
+    Component component;
+    component.name = stmt.column_text(first_column);
+    if (stmt.column_type(first_column + 1) != SQLITE_NULL) {
+        component.instance = stmt.column_text(first_column + 1);
+    }
+    if (stmt.column_type(first_column + 2) != SQLITE_NULL) {
+        EVSE evse;
+        evse.id = stmt.column_int(first_column + 2);
+        if (stmt.column_type(first_column + 3) != SQLITE_NULL) {
+            evse.connectorId = stmt.column_int(first_column + 3);
+        }
+        component.evse = evse;
+    }
+    return component;
+}
+
+/// \brief Reads a variable (NAME, INSTANCE) from the given statement starting at column \p first_column
+Variable read_variable(StatementInterface& stmt, const int first_column) {
+    Variable variable;
+    variable.name = stmt.column_text(first_column);
+    if (stmt.column_type(first_column + 1) != SQLITE_NULL) {
+        variable.instance = stmt.column_text(first_column + 1);
+    }
+    return variable;
+}
+
+/// \brief Binds the given \p component_names followed by the \p variable_names to \p stmt, starting at parameter
+/// index 1
+void bind_component_and_variable_names(StatementInterface& stmt, const std::set<std::string>& component_names,
+                                       const std::set<std::string>& variable_names) {
+    int index = 1;
+    for (const auto& name : component_names) {
+        stmt.bind_text(index++, name, SQLiteString::Transient);
+    }
+    for (const auto& name : variable_names) {
+        stmt.bind_text(index++, name, SQLiteString::Transient);
+    }
+}
+
+/// \brief Collects the component and variable names of the keys in [\p first, \p last)
+void collect_names(const std::vector<VariableAttributeKey>& keys, const std::size_t first, const std::size_t last,
+                   std::set<std::string>& component_names, std::set<std::string>& variable_names) {
+    for (std::size_t i = first; i < last; i++) {
+        component_names.insert(keys[i].component.name.get());
+        variable_names.insert(keys[i].variable.name.get());
+    }
+}
+} // namespace
+
 DeviceModelStorageSqlite::DeviceModelStorageSqlite(const fs::path& db_path, const fs::path& migration_files_path,
                                                    const fs::path& config_path) {
     if (db_path.empty() || migration_files_path.empty() || config_path.empty()) {
         EVLOG_AND_THROW(DeviceModelError("Can not initialize device model storage: one of the paths is empty."));
     }
-    const auto component_configs = get_all_component_configs(config_path);
     InitDeviceModelDb init_device_model_db(db_path, migration_files_path);
-    init_device_model_db.initialize_database(component_configs, false);
+    init_device_model_db.initialize_database(config_path, false);
 
     initialize_connection(db_path);
 }
@@ -97,6 +165,48 @@ int DeviceModelStorageSqlite::get_variable_id(const Component& component_id, con
     return -1;
 }
 
+std::map<std::pair<Component, Variable>, int>
+DeviceModelStorageSqlite::get_variable_ids(const std::vector<VariableAttributeKey>& keys) {
+    std::map<std::pair<Component, Variable>, int> variable_ids;
+    if (keys.empty()) {
+        return variable_ids;
+    }
+
+    std::set<std::pair<Component, Variable>> requested;
+    for (const auto& key : keys) {
+        requested.emplace(key.component, key.variable);
+    }
+
+    for (std::size_t first = 0; first < keys.size(); first += MAX_KEYS_PER_QUERY) {
+        std::set<std::string> component_names;
+        std::set<std::string> variable_names;
+        collect_names(keys, first, std::min(first + MAX_KEYS_PER_QUERY, keys.size()), component_names,
+                      variable_names);
+
+        // Narrow the candidates down by name in the query, the exact match including instance and evse is done below
+        const std::string select_query =
+            "SELECT v.ID, c.NAME, c.INSTANCE, c.EVSE_ID, c.CONNECTOR_ID, v.NAME, v.INSTANCE "
+            "FROM COMPONENT c "
+            "JOIN VARIABLE v ON c.ID = v.COMPONENT_ID "
+            "WHERE c.NAME IN (" +
+            make_placeholders(component_names.size()) + ") AND v.NAME IN (" +
+            make_placeholders(variable_names.size()) + ")";
+
+        auto select_stmt = this->db->new_statement(select_query);
+        bind_component_and_variable_names(*select_stmt, component_names, variable_names);
+
+        while (select_stmt->step() == SQLITE_ROW) {
+            auto component_variable =
+                std::make_pair(read_component(*select_stmt, 1), read_variable(*select_stmt, 5));
+            if (requested.count(component_variable) != 0) {
+                variable_ids[std::move(component_variable)] = select_stmt->column_int(0);
+            }
+        }
+    }
+
+    return variable_ids;
+}
+
 DeviceModelMap DeviceModelStorageSqlite::get_device_model() {
     std::map<Component, std::map<Variable, VariableMetaData>> device_model;
 
@@ -255,6 +365,106 @@ SetVariableStatusEnum DeviceModelStorageSqlite::set_variable_attribute_value(con
     return SetVariableStatusEnum::Accepted;
 }
 
+std::vector<std::optional<VariableAttribute>>
+DeviceModelStorageSqlite::get_variable_attributes_batch(const std::vector<VariableAttributeKey>& keys) {
+    std::vector<std::optional<VariableAttribute>> attributes(keys.size());
+    if (keys.empty()) {
+        return attributes;
+    }
+
+    // Index the requested keys, a key can be requested multiple times within one batch
+    std::map<std::tuple<Component, Variable, AttributeEnum>, std::vector<std::size_t>> requested;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        requested[std::make_tuple(keys[i].component, keys[i].variable, keys[i].attribute_enum)].push_back(i);
+    }
+
+    for (std::size_t first = 0; first < keys.size(); first += MAX_KEYS_PER_QUERY) {
+        std::set<std::string> component_names;
+        std::set<std::string> variable_names;
+        collect_names(keys, first, std::min(first + MAX_KEYS_PER_QUERY, keys.size()), component_names,
+                      variable_names);
+
+        const std::string select_query =
+            "SELECT c.NAME, c.INSTANCE, c.EVSE_ID, c.CONNECTOR_ID, v.NAME, v.INSTANCE, "
+            "va.VALUE, va.MUTABILITY_ID, va.PERSISTENT, va.CONSTANT, va.TYPE_ID "
+            "FROM COMPONENT c "
+            "JOIN VARIABLE v ON c.ID = v.COMPONENT_ID "
+            "JOIN VARIABLE_ATTRIBUTE va ON v.ID = va.VARIABLE_ID "
+            "WHERE c.NAME IN (" +
+            make_placeholders(component_names.size()) + ") AND v.NAME IN (" +
+            make_placeholders(variable_names.size()) + ")";
+
+        auto select_stmt = this->db->new_statement(select_query);
+        bind_component_and_variable_names(*select_stmt, component_names, variable_names);
+
+        while (select_stmt->step() == SQLITE_ROW) {
+            VariableAttribute attribute;
+            if (select_stmt->column_type(6) != SQLITE_NULL) {
+                attribute.value = select_stmt->column_text(6);
+            }
+            attribute.mutability = static_cast<MutabilityEnum>(select_stmt->column_int(7));
+            attribute.persistent = static_cast<bool>(select_stmt->column_int(8));
+            attribute.constant = static_cast<bool>(select_stmt->column_int(9));
+            attribute.type = static_cast<AttributeEnum>(select_stmt->column_int(10));
+
+            const auto it = requested.find(std::make_tuple(read_component(*select_stmt, 0),
+                                                           read_variable(*select_stmt, 4), attribute.type.value()));
+            if (it == requested.end()) {
+                continue;
+            }
+            for (const auto index : it->second) {
+                attributes[index] = attribute;
+            }
+        }
+    }
+
+    return attributes;
+}
+
+std::vector<SetVariableStatusEnum> DeviceModelStorageSqlite::set_variable_attribute_values_batch(
+    const std::vector<VariableAttributeValueUpdate>& updates) {
+    std::vector<SetVariableStatusEnum> results(updates.size(), SetVariableStatusEnum::Rejected);
+    if (updates.empty()) {
+        return results;
+    }
+
+    std::vector<VariableAttributeKey> keys;
+    keys.reserve(updates.size());
+    for (const auto& update : updates) {
+        keys.push_back(update.key);
+    }
+    const auto variable_ids = this->get_variable_ids(keys);
+
+    auto transaction = this->db->begin_transaction();
+
+    const std::string update_query =
+        "UPDATE VARIABLE_ATTRIBUTE SET VALUE = ?, VALUE_SOURCE = ? WHERE VARIABLE_ID = ? AND TYPE_ID = ?";
+    auto update_stmt = this->db->new_statement(update_query);
+
+    for (std::size_t i = 0; i < updates.size(); i++) {
+        const auto& update = updates[i];
+        const auto variable_id_it = variable_ids.find(std::make_pair(update.key.component, update.key.variable));
+        if (variable_id_it == variable_ids.end()) {
+            continue;
+        }
+
+        update_stmt->bind_text(1, update.value);
+        update_stmt->bind_text(2, update.source);
+        update_stmt->bind_int(3, variable_id_it->second);
+        update_stmt->bind_int(4, static_cast<int>(update.key.attribute_enum));
+        if (update_stmt->step() != SQLITE_DONE) {
+            // Rolls back all updates of this batch when the transaction goes out of scope
+            EVLOG_error << this->db->get_error_message();
+            return std::vector<SetVariableStatusEnum>(updates.size(), SetVariableStatusEnum::Rejected);
+        }
+        update_stmt->reset();
+        results[i] = SetVariableStatusEnum::Accepted;
+    }
+
+    transaction->commit();
+    return results;
+}
+
 bool DeviceModelStorageSqlite::update_monitoring_reference(const std::int32_t monitor_id,
                                                            const std::string& reference_value) {
     auto transaction = this->db->begin_transaction();
@@ -6,8 +6,11 @@
 #include <optional>
 #include <utility>
 
+#include <boost/asio/post.hpp>
+
 #include <everest/database/exceptions.hpp>
 #include <everest/logging.hpp>
+#include <ocpp/common/executor.hpp>
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/evse.hpp>
 
@@ -50,12 +53,17 @@ Evse::Evse(const std::int32_t evse_id, const std::int32_t number_of_connectors,
            std::shared_ptr<ComponentStateManagerInterface> component_state_manager,
            const std::function<void(const MeterValue& meter_value, EnhancedTransaction& transaction)>&
                transaction_meter_value_req,
-           const std::function<void(std::int32_t evse_id)>& pause_charging_callback) :
+           const std::function<void(std::int32_t evse_id)>& pause_charging_callback,
+           boost::asio::io_context& io_context) :
     evse_id(evse_id),
     device_model(device_model),
     transaction_meter_value_req(transaction_meter_value_req),
     pause_charging_callback(pause_charging_callback),
+    meter_value_processing(std::make_shared<MeterValueProcessing>()),
+    meter_value_processing_scheduled(false),
+    sampled_meter_values_timer(&io_context),
     database_handler(database_handler),
+    io_context(io_context),
     component_state_manager(component_state_manager),
     transaction(nullptr) {
     for (int connector_id = 1; connector_id <= number_of_connectors; connector_id++) {
@@ -72,11 +80,21 @@ Evse::Evse(const std::int32_t evse_id, const std::int32_t number_of_connectors,
 }
 
 Evse::~Evse() {
+    {
+        // Handlers that are still queued on the io_context must not access this evse anymore
+        const std::lock_guard<std::recursive_mutex> lk(this->meter_value_processing->mutex);
+        this->meter_value_processing->stopped = true;
+    }
+
     try {
-        if (this->trigger_metervalue_at_time_timer != nullptr) {
-            this->trigger_metervalue_at_time_timer->stop();
-            this->trigger_metervalue_at_time_timer = nullptr;
-        }
+        // Stopped on the executor, so the timer handlers can not run while this evse is destroyed
+        Executor::run_and_wait(this->io_context, [this]() {
+            this->sampled_meter_values_timer.stop();
+            if (this->trigger_metervalue_at_time_timer != nullptr) {
+                this->trigger_metervalue_at_time_timer->stop();
+                this->trigger_metervalue_at_time_timer = nullptr;
+            }
+        });
     } catch (...) {
         EVLOG_error << "Exception during dtor call trigger metervalue at time timer stop";
         return;
@@ -251,11 +269,13 @@ void Evse::open_transaction(const std::string& transaction_id, const std::int32_
         this->device_model.get_optional_value<bool>(ControllerComponentVariables::ResumeTransactionsOnBoot)
             .value_or(false);
 
-    this->transaction = std::make_unique<EnhancedTransaction>(*this->database_handler.get(), tx_database_enabled);
+    this->transaction =
+        std::make_unique<EnhancedTransaction>(*this->database_handler.get(), tx_database_enabled, &this->io_context);
     this->transaction->transactionId = transaction_id;
     this->transaction->connector_id = connector_id;
     this->transaction->id_token_sent = id_token.has_value();
     this->transaction->start_time = timestamp;
+    this->process_meter_value();
     this->transaction->active_energy_import_start_value = this->get_active_import_register_meter_value();
     this->transaction->chargingState = charging_state;
 
@@ -312,6 +332,7 @@ void Evse::close_transaction(const DateTime& /*timestamp*/, const MeterValue& me
 
 void Evse::start_checking_max_energy_on_invalid_id() {
     if (this->transaction != nullptr) {
+        this->process_meter_value();
         this->transaction->check_max_active_import_energy = true;
         this->check_max_energy_on_invalid_id();
     } else {
@@ -357,29 +378,52 @@ void Evse::submit_event(const std::int32_t connector_id, ConnectorEvent event) {
 }
 
 void Evse::on_meter_value(const MeterValue& meter_value) {
-    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_mutex);
-    this->meter_value = meter_value;
-    this->aligned_data_updated.set_values(meter_value);
-    this->aligned_data_tx_end.set_values(meter_value);
+    // Only the latest metervalue is handed over, the caller never waits for the processing
+    this->published_meter_value.publish(meter_value);
+    if (this->meter_value_processing_scheduled.exchange(true)) {
+        return;
+    }
+
+    boost::asio::post(this->io_context, [this, processing = this->meter_value_processing]() {
+        const std::lock_guard<std::recursive_mutex> lk(processing->mutex);
+        if (!processing->stopped) {
+            this->process_meter_value();
+        }
+    });
+}
+
+void Evse::process_meter_value() {
+    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_processing->mutex);
+    // Reset before consuming, so a metervalue that is published meanwhile schedules a new processing
+    this->meter_value_processing_scheduled = false;
+    if (!this->published_meter_value.consume(this->meter_value)) {
+        return;
+    }
+
+    this->aligned_data_updated.set_values(this->meter_value);
+    this->aligned_data_tx_end.set_values(this->meter_value);
     this->check_max_energy_on_invalid_id();
-    this->send_meter_value_on_pricing_trigger(meter_value);
+    this->send_meter_value_on_pricing_trigger(this->meter_value);
 }
 
 MeterValue Evse::get_meter_value() {
-    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_mutex);
+    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_processing->mutex);
+    this->process_meter_value();
     return this->meter_value;
 }
 
 MeterValue Evse::get_idle_meter_value() {
+    this->process_meter_value();
     return this->aligned_data_updated.retrieve_processed_values();
 }
 
 void Evse::clear_idle_meter_values() {
+    this->process_meter_value();
     this->aligned_data_updated.clear_values();
 }
 
 std::optional<float> Evse::get_active_import_register_meter_value() {
-    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_mutex);
+    const std::lock_guard<std::recursive_mutex> lk(this->meter_value_processing->mutex);
     auto it = std::find_if(
         this->meter_value.sampledValue.begin(), this->meter_value.sampledValue.end(), [](const SampledValue& value) {
             return value.measurand == MeasurandEnum::Energy_Active_Import_Register and !value.phase.has_value();
@@ -392,11 +436,14 @@ std::optional<float> Evse::get_active_import_register_meter_value() {
 
 void Evse::check_max_energy_on_invalid_id() {
     // Handle E05.02
+    auto& transaction = this->transaction;
+    if (transaction == nullptr or !transaction->check_max_active_import_energy) {
+        // Avoid reading the device model for every metervalue when there is nothing to check
+        return;
+    }
     auto max_energy_on_invalid_id =
         this->device_model.get_optional_value<std::int32_t>(ControllerComponentVariables::MaxEnergyOnInvalidId);
-    auto& transaction = this->transaction;
-    if (transaction != nullptr and max_energy_on_invalid_id.has_value() and
-        transaction->check_max_active_import_energy) {
+    if (max_energy_on_invalid_id.has_value()) {
         const auto opt_energy_value = this->get_active_import_register_meter_value();
         auto active_energy_import_start_value = transaction->active_energy_import_start_value;
         if (opt_energy_value.has_value() and active_energy_import_start_value.has_value()) {
@@ -454,6 +501,7 @@ void Evse::start_metering_timers(const DateTime& timestamp) {
                         .value_or(false)) {
                     return;
                 }
+                this->process_meter_value();
                 auto meter_value = this->aligned_data_updated.retrieve_processed_values();
 
                 // If empty fallback on last updated metervalue
@@ -478,6 +526,7 @@ void Evse::start_metering_timers(const DateTime& timestamp) {
 
     if (aligned_data_tx_ended_interval > 0s) {
         auto store_aligned_metervalue = [this, aligned_data_tx_ended_interval] {
+            this->process_meter_value();
             auto meter_value = this->aligned_data_tx_end.retrieve_processed_values();
 
             // If empty fallback on last updated metervalue
@@ -13,12 +13,13 @@ EvseManager::EvseManager(const std::map<std::int32_t, std::int32_t>& evse_connec
                          std::shared_ptr<ComponentStateManagerInterface> component_state_manager,
                          const std::function<void(const MeterValue& meter_value, EnhancedTransaction& transaction)>&
                              transaction_meter_value_req,
-                         const std::function<void(std::int32_t evse_id)>& pause_charging_callback) {
+                         const std::function<void(std::int32_t evse_id)>& pause_charging_callback,
+                         boost::asio::io_context& io_context) {
     evses.reserve(evse_connector_structure.size());
     for (const auto& [evse_id, connectors] : evse_connector_structure) {
         evses.push_back(std::make_unique<Evse>(evse_id, connectors, device_model, database_handler,
                                                component_state_manager, transaction_meter_value_req,
-                                               pause_charging_callback));
+                                               pause_charging_callback, io_context));
     }
 }
 
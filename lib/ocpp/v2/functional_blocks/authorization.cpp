@@ -43,7 +43,7 @@ void ocpp::v2::Authorization::start_auth_cache_cleanup_thread() {
 }
 
 void ocpp::v2::Authorization::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::ClearCache) {
         this->handle_clear_cache_req(json_message);
@@ -92,7 +92,7 @@ ocpp::v2::Authorization::authorize_req(const IdToken id_token, const std::option
     }
 
     try {
-        const ocpp::CallResult<AuthorizeResponse> call_result = enhanced_message.message;
+        const ocpp::CallResult<AuthorizeResponse> call_result = *enhanced_message.message;
         return call_result.msg;
     } catch (const EnumConversionException& e) {
         // We don't get here normally, because the future.get() already throws. Code was not removed, because something
@@ -184,8 +184,9 @@ ocpp::v2::Authorization::validate_token(const IdToken id_token, const std::optio
             forwarded_to_csms = true;
         } else if (certificate.has_value()) {
             // First try to validate the contract certificate locally
-            const CertificateValidationResult local_verify_result = this->context.evse_security.verify_certificate(
-                certificate.value().get(), {ocpp::LeafCertificateType::MO, ocpp::LeafCertificateType::V2G});
+            const CertificateValidationResult local_verify_result =
+                this->context.contract_certificate_cache->verify_certificate(
+                    certificate.value().get(), {ocpp::LeafCertificateType::MO, ocpp::LeafCertificateType::V2G});
             EVLOG_info << "Local contract validation result: " << local_verify_result;
 
             const bool central_contract_validation_allowed =
@@ -215,7 +216,7 @@ ocpp::v2::Authorization::validate_token(const IdToken id_token, const std::optio
                 } else {
                     // Try to generate the OCSP data from the certificate chain and use that
                     const auto generated_ocsp_request_data_list = ocpp::evse_security_conversions::to_ocpp_v2(
-                        this->context.evse_security.get_mo_ocsp_request_data(certificate.value()));
+                        this->context.contract_certificate_cache->get_mo_ocsp_request_data(certificate.value()));
                     if (!generated_ocsp_request_data_list.empty()) {
                         EVLOG_info << "Online: Pass generated OCSP data to CSMS";
                         response = this->authorize_req(id_token, std::nullopt, generated_ocsp_request_data_list);
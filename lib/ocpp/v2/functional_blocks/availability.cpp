@@ -17,12 +17,14 @@ Availability::Availability(const FunctionalBlockContext& functional_block_contex
                            std::optional<AllConnectorsUnavailableCallback> all_connectors_unavailable_callback) :
     context(functional_block_context),
     time_sync_callback(time_sync_callback),
-    all_connectors_unavailable_callback(all_connectors_unavailable_callback) {
+    all_connectors_unavailable_callback(all_connectors_unavailable_callback),
+    heartbeat_timer(&functional_block_context.executor->get_io_context()) {
 }
 
 Availability::~Availability() {
     try {
-        this->stop_heartbeat_timer();
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed
+        this->context.executor->run_and_wait([this]() { this->stop_heartbeat_timer(); });
     } catch (...) {
         EVLOG_error << "Exception during dtor call of stop heartbeat timer";
         return;
@@ -30,7 +32,7 @@ Availability::~Availability() {
 }
 
 void Availability::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::ChangeAvailability) {
         this->handle_change_availability_req(json_message);
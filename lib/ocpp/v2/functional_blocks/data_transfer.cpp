@@ -15,7 +15,7 @@ void DataTransfer::handle_message(const EnhancedMessage<MessageType>& message) {
         throw MessageTypeNotImplementedException(message.messageType);
     }
 
-    const Call<DataTransferRequest> call = message.message;
+    const Call<DataTransferRequest> call = *message.message;
     const auto msg = call.msg;
     DataTransferResponse response;
     response.status = DataTransferStatusEnum::UnknownVendorId;
@@ -62,7 +62,7 @@ std::optional<DataTransferResponse> DataTransfer::data_transfer_req(const DataTr
 
     if (enhanced_message.messageType == MessageType::DataTransferResponse) {
         try {
-            const ocpp::CallResult<DataTransferResponse> call_result = enhanced_message.message;
+            const ocpp::CallResult<DataTransferResponse> call_result = *enhanced_message.message;
             response = call_result.msg;
         } catch (const EnumConversionException& e) {
             EVLOG_error << "EnumConversionException during handling of message: " << e.what();
@@ -70,7 +70,7 @@ std::optional<DataTransferResponse> DataTransfer::data_transfer_req(const DataTr
             this->context.message_dispatcher.dispatch_call_error(call_error);
             return std::nullopt;
         } catch (const json::exception& e) {
-            EVLOG_error << "Unable to parse DataTransfer.conf from CSMS: " << enhanced_message.message;
+            EVLOG_error << "Unable to parse DataTransfer.conf from CSMS: " << *enhanced_message.message;
             auto call_error = CallError(enhanced_message.uniqueId, "FormationViolation", e.what(), json({}));
             this->context.message_dispatcher.dispatch_call_error(call_error);
             return std::nullopt;
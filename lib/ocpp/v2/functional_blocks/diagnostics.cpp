@@ -5,6 +5,7 @@
 
 #include <ocpp/common/constants.hpp>
 #include <ocpp/v2/connectivity_manager.hpp>
+#include <ocpp/v2/constants.hpp>
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/device_model.hpp>
@@ -24,6 +25,9 @@
 #include <ocpp/v2/messages/SetVariableMonitoring.hpp>
 
 const auto DEFAULT_MAX_CUSTOMER_INFORMATION_DATA_LENGTH = 51200;
+// Defaults of NotifyEventItemsPerMessage and NotifyEventLatencyBudget in the InternalCtrlr component config
+const auto DEFAULT_NOTIFY_EVENT_ITEMS_PER_MESSAGE = 100;
+const auto DEFAULT_NOTIFY_EVENT_LATENCY_BUDGET_MS = 100;
 
 namespace ocpp::v2 {
 
@@ -33,19 +37,43 @@ Diagnostics::Diagnostics(const FunctionalBlockContext& context, AuthorizationInt
                          std::optional<ClearCustomerInformationCallback> clear_customer_information_callback) :
     context(context),
     authorization(authorization),
+    notify_event_batcher(0, 0),
+    notify_event_latency_budget(0),
+    notify_event_timer(&context.executor->get_io_context(), [this]() { this->flush_notify_events(); }),
+    is_notify_event_flush_scheduled(false),
     monitoring_updater(
         context.device_model, [this](const std::vector<EventData>& events) { this->notify_event_req(events); },
-        [this]() { return !this->context.connectivity_manager.is_websocket_connected(); }),
+        [this]() { return !this->context.connectivity_manager.is_websocket_connected(); }, context.executor),
     get_log_request_callback(get_log_request_callback),
     get_customer_information_callback(get_customer_information_callback),
     clear_customer_information_callback(clear_customer_information_callback),
     is_monitoring_available(
         this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringCtrlrAvailable)
             .value_or(false)) {
+    this->update_notify_event_config();
+}
+
+Diagnostics::~Diagnostics() {
+    // Pending events are flushed by ChargePoint::stop. The message queue the dispatcher sends through may already be
+    // destroyed here, so the remaining events are dropped without dispatching them. The timers are stopped on the
+    // executor, so their handlers can not run while this object is destroyed
+    try {
+        this->context.executor->run_and_wait([this]() {
+            this->monitoring_updater.stop_monitoring();
+            const std::lock_guard<std::mutex> lock(this->notify_event_mutex);
+            this->is_notify_event_flush_scheduled = false;
+            this->notify_event_timer.stop();
+            if (!this->notify_event_batcher.empty()) {
+                EVLOG_warning << "Dropping pending NotifyEvent messages on destruction";
+            }
+        });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of stop monitoring";
+    }
 }
 
 void Diagnostics::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::GetLog) {
         this->handle_get_log_req(json_message);
@@ -72,17 +100,51 @@ void Diagnostics::handle_message(const ocpp::EnhancedMessage<MessageType>& messa
 }
 
 void Diagnostics::notify_event_req(const std::vector<EventData>& events) {
-    NotifyEventRequest req;
-    req.eventData = events;
-    req.generatedAt = DateTime();
-    req.seqNo = 0;
+    if (events.empty()) {
+        return;
+    }
 
-    const ocpp::Call<NotifyEventRequest> call(req);
-    this->context.message_dispatcher.dispatch_call(call);
+    bool flush_now = false;
+    {
+        const std::lock_guard<std::mutex> lock(this->notify_event_mutex);
+        const bool is_full = this->notify_event_batcher.add(events);
+
+        // Send right away if there is no time to wait for more events or if waiting would not make the
+        // messages any fewer
+        if (this->notify_event_latency_budget.count() <= 0 or is_full) {
+            flush_now = true;
+        } else if (!this->is_notify_event_flush_scheduled) {
+            this->is_notify_event_flush_scheduled = true;
+            this->notify_event_timer.timeout(this->notify_event_latency_budget);
+        }
+    }
+
+    if (flush_now) {
+        this->flush_notify_events();
+    }
+}
+
+void Diagnostics::flush_notify_events() {
+    const std::lock_guard<std::mutex> flush_lock(this->notify_event_flush_mutex);
+    std::vector<NotifyEventRequest> requests;
+    {
+        const std::lock_guard<std::mutex> lock(this->notify_event_mutex);
+        if (this->is_notify_event_flush_scheduled) {
+            this->is_notify_event_flush_scheduled = false;
+            this->notify_event_timer.stop();
+        }
+        requests = this->notify_event_batcher.take_requests();
+    }
+
+    for (const auto& req : requests) {
+        const ocpp::Call<NotifyEventRequest> call(req);
+        this->context.message_dispatcher.dispatch_call(call);
+    }
 }
 
 void Diagnostics::stop_monitoring() {
     monitoring_updater.stop_monitoring();
+    this->flush_notify_events();
 }
 
 void Diagnostics::start_monitoring() {
@@ -93,6 +155,27 @@ void Diagnostics::process_triggered_monitors() {
     monitoring_updater.process_triggered_monitors();
 }
 
+void Diagnostics::update_monitoring_config() {
+    monitoring_updater.update_monitoring_config();
+}
+
+void Diagnostics::update_notify_event_config() {
+    const auto max_items_per_message =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::NotifyEventItemsPerMessage)
+            .value_or(DEFAULT_NOTIFY_EVENT_ITEMS_PER_MESSAGE);
+    const auto max_bytes_per_message =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::NotifyEventBytesPerMessage)
+            .value_or(this->context.device_model.get_optional_value<int>(ControllerComponentVariables::MaxMessageSize)
+                          .value_or(DEFAULT_MAX_MESSAGE_SIZE));
+    const auto latency_budget =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::NotifyEventLatencyBudget)
+            .value_or(DEFAULT_NOTIFY_EVENT_LATENCY_BUDGET_MS);
+
+    const std::lock_guard<std::mutex> lock(this->notify_event_mutex);
+    this->notify_event_batcher.set_limits(std::max(max_items_per_message, 0), std::max(max_bytes_per_message, 0));
+    this->notify_event_latency_budget = std::chrono::milliseconds(std::max(latency_budget, 0));
+}
+
 void Diagnostics::notify_customer_information_req(const std::string& data, const std::int32_t request_id) {
     size_t pos = 0;
     std::int32_t seq_no = 0;
@@ -240,6 +323,7 @@ void Diagnostics::handle_set_monitoring_base_req(Call<SetMonitoringBaseRequest>
         response.status = GenericDeviceModelStatusEnum::Rejected;
     } else {
         response.status = GenericDeviceModelStatusEnum::Accepted;
+        this->monitoring_updater.update_monitoring_config();
 
         if (msg.monitoringBase == MonitoringBaseEnum::HardWiredOnly or
             msg.monitoringBase == MonitoringBaseEnum::FactoryDefault) {
@@ -249,6 +333,7 @@ void Diagnostics::handle_set_monitoring_base_req(Call<SetMonitoringBaseRequest>
                 EVLOG_warning << "Could not clear custom monitors from DB: " << e.what();
                 response.status = GenericDeviceModelStatusEnum::Rejected;
             }
+            this->monitoring_updater.update_periodic_monitors();
         }
     }
 
@@ -278,6 +363,7 @@ void Diagnostics::handle_set_monitoring_level_req(Call<SetMonitoringLevelRequest
             response.status = GenericStatusEnum::Rejected;
         } else {
             response.status = GenericStatusEnum::Accepted;
+            this->monitoring_updater.update_monitoring_config();
         }
     }
 
@@ -286,7 +372,7 @@ void Diagnostics::handle_set_monitoring_level_req(Call<SetMonitoringLevelRequest
 }
 
 void Diagnostics::handle_set_variable_monitoring_req(const EnhancedMessage<MessageType>& message) {
-    const Call<SetVariableMonitoringRequest> call = message.call_message;
+    const Call<SetVariableMonitoringRequest> call = *message.message;
     SetVariableMonitoringResponse response;
     const auto& msg = call.msg;
 
@@ -314,6 +400,8 @@ void Diagnostics::handle_set_variable_monitoring_req(const EnhancedMessage<Messa
         EVLOG_error << "Set monitors failed:" << e.what();
     }
 
+    this->monitoring_updater.update_periodic_monitors();
+
     const ocpp::CallResult<SetVariableMonitoringResponse> call_result(response, call.uniqueId);
     this->context.message_dispatcher.dispatch_call_result(call_result);
 }
@@ -368,6 +456,8 @@ void Diagnostics::handle_clear_variable_monitoring_req(Call<ClearVariableMonitor
         EVLOG_error << "Clear variable monitoring failed:" << e.what();
     }
 
+    this->monitoring_updater.update_periodic_monitors();
+
     const ocpp::CallResult<ClearVariableMonitoringResponse> call_result(response, call.uniqueId);
     this->context.message_dispatcher.dispatch_call_result(call_result);
 }
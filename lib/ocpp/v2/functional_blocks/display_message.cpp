@@ -24,7 +24,7 @@ DisplayMessageBlock::DisplayMessageBlock(const FunctionalBlockContext& functiona
 }
 
 void DisplayMessageBlock::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::GetDisplayMessages) {
         this->handle_get_display_message(json_message);
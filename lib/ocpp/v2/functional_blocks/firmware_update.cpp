@@ -36,7 +36,7 @@ FirmwareUpdate::FirmwareUpdate(const FunctionalBlockContext& functional_block_co
 
 void FirmwareUpdate::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
     if (message.messageType == MessageType::UpdateFirmware) {
-        this->handle_firmware_update_req(message.message);
+        this->handle_firmware_update_req(*message.message);
     } else {
         throw MessageTypeNotImplementedException(message.messageType);
     }
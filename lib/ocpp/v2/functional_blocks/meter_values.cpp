@@ -12,7 +12,8 @@
 #include <ocpp/v2/messages/MeterValues.hpp>
 
 ocpp::v2::MeterValues::MeterValues(const FunctionalBlockContext& functional_block_context) :
-    context(functional_block_context) {
+    context(functional_block_context),
+    aligned_meter_values_timer(&functional_block_context.executor->get_io_context()) {
 }
 
 void ocpp::v2::MeterValues::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
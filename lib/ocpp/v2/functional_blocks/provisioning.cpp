@@ -7,6 +7,7 @@
 #include <ocpp/common/evse_security.hpp>
 #include <ocpp/v2/component_state_manager.hpp>
 #include <ocpp/v2/connectivity_manager.hpp>
+#include <ocpp/v2/constants.hpp>
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/evse_manager.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
@@ -16,6 +17,7 @@
 #include <ocpp/v2/functional_blocks/diagnostics.hpp>
 #include <ocpp/v2/functional_blocks/meter_values.hpp>
 #include <ocpp/v2/functional_blocks/security.hpp>
+#include <ocpp/v2/functional_blocks/tariff_and_cost.hpp>
 #include <ocpp/v2/functional_blocks/transaction.hpp>
 
 #include <ocpp/v2/messages/BootNotification.hpp>
@@ -27,7 +29,6 @@
 #include <ocpp/v2/messages/SetNetworkProfile.hpp>
 #include <ocpp/v2/messages/SetVariables.hpp>
 
-const auto DEFAULT_MAX_MESSAGE_SIZE = 65000;
 const auto DEFAULT_BOOT_NOTIFICATION_RETRY_INTERVAL = std::chrono::seconds(30);
 
 namespace ocpp::v2 {
@@ -35,13 +36,21 @@ namespace ocpp::v2 {
 namespace {
 bool component_variable_change_requires_websocket_option_update_without_reconnect(
     const ComponentVariable& component_variable);
+
+/// \brief Returns true if the validation of \p set_variable_data in validate_set_variable reads other variables from
+/// the device model, so it has to see the values that were set before it within the same request
+bool validation_depends_on_device_model(const SetVariableData& set_variable_data) {
+    const ComponentVariable cv = {set_variable_data.component, set_variable_data.variable, std::nullopt};
+    return cv == ControllerComponentVariables::NetworkConfigurationPriority;
 }
+} // namespace
 
 Provisioning::Provisioning(const FunctionalBlockContext& functional_block_context,
                            MessageQueue<MessageType>& message_queue, OcspUpdaterInterface& ocsp_updater,
                            AvailabilityInterface& availability, MeterValuesInterface& meter_values,
                            SecurityInterface& security, DiagnosticsInterface& diagnostics,
-                           TransactionInterface& transaction, std::optional<TimeSyncCallback> time_sync_callback,
+                           TransactionInterface& transaction, TariffAndCostInterface& tariff_and_cost,
+                           std::optional<TimeSyncCallback> time_sync_callback,
                            std::optional<BootNotificationCallback> boot_notification_callback,
                            std::optional<ValidateNetworkProfileCallback> validate_network_profile_callback,
                            IsResetAllowedCallback is_reset_allowed_callback, ResetCallback reset_callback,
@@ -56,6 +65,7 @@ Provisioning::Provisioning(const FunctionalBlockContext& functional_block_contex
     security(security),
     diagnostics(diagnostics),
     transaction(transaction),
+    tariff_and_cost(tariff_and_cost),
     time_sync_callback(time_sync_callback),
     boot_notification_callback(boot_notification_callback),
     validate_network_profile_callback(validate_network_profile_callback),
@@ -63,11 +73,21 @@ Provisioning::Provisioning(const FunctionalBlockContext& functional_block_contex
     reset_callback(reset_callback),
     stop_transaction_callback(stop_transaction_callback),
     variable_changed_callback(variable_changed_callback),
-    registration_status(registration_status) {
+    registration_status(registration_status),
+    boot_notification_timer(&functional_block_context.executor->get_io_context()) {
+}
+
+Provisioning::~Provisioning() {
+    try {
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed
+        this->context.executor->run_and_wait([this]() { this->stop_bootnotification_timer(); });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of boot notification timer stop";
+    }
 }
 
 void Provisioning::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::BootNotificationResponse) {
         this->handle_boot_notification_response(json_message);
@@ -119,23 +139,7 @@ void Provisioning::on_variable_changed(const SetVariableData& set_variable_data)
 
 std::vector<GetVariableResult>
 Provisioning::get_variables(const std::vector<GetVariableData>& get_variable_data_vector) {
-    std::vector<GetVariableResult> response;
-    for (const auto& get_variable_data : get_variable_data_vector) {
-        GetVariableResult get_variable_result;
-        get_variable_result.component = get_variable_data.component;
-        get_variable_result.variable = get_variable_data.variable;
-        get_variable_result.attributeType = get_variable_data.attributeType.value_or(AttributeEnum::Actual);
-        const auto request_value_response = this->context.device_model.request_value<std::string>(
-            get_variable_data.component, get_variable_data.variable,
-            get_variable_data.attributeType.value_or(AttributeEnum::Actual));
-        if (request_value_response.status == GetVariableStatusEnum::Accepted and
-            request_value_response.value.has_value()) {
-            get_variable_result.attributeValue = request_value_response.value.value();
-        }
-        get_variable_result.attributeStatus = request_value_response.status;
-        response.push_back(get_variable_result);
-    }
-    return response;
+    return this->context.device_model.request_values(get_variable_data_vector);
 }
 
 std::map<SetVariableData, SetVariableResult>
@@ -244,7 +248,7 @@ void Provisioning::handle_set_variables_req(Call<SetVariablesRequest> call) {
 }
 
 void Provisioning::handle_get_variables_req(const EnhancedMessage<MessageType>& message) {
-    const Call<GetVariablesRequest> call = message.call_message;
+    const Call<GetVariablesRequest> call = *message.message;
     const auto msg = call.msg;
 
     const auto max_variables_per_message =
@@ -290,7 +294,7 @@ void Provisioning::handle_get_base_report_req(Call<GetBaseReportRequest> call) {
 }
 
 void Provisioning::handle_get_report_req(const EnhancedMessage<MessageType>& message) {
-    const Call<GetReportRequest> call = message.call_message;
+    const Call<GetReportRequest> call = *message.message;
     const auto msg = call.msg;
     std::vector<ReportData> report_data;
     GetReportResponse response;
@@ -592,6 +596,23 @@ void Provisioning::handle_variable_changed(const SetVariableData& set_variable_d
         }
     }
 
+    if (set_variable_data.component == ControllerComponents::MonitoringCtrlr) {
+        this->diagnostics.update_monitoring_config();
+    }
+
+    if (component_variable == ControllerComponentVariables::NotifyEventItemsPerMessage or
+        component_variable == ControllerComponentVariables::NotifyEventBytesPerMessage or
+        component_variable == ControllerComponentVariables::NotifyEventLatencyBudget or
+        component_variable == ControllerComponentVariables::MaxMessageSize) {
+        this->diagnostics.update_notify_event_config();
+    }
+
+    if (component_variable == ControllerComponentVariables::TariffCostCtrlrAvailableCost or
+        component_variable == ControllerComponentVariables::TariffCostCtrlrEnabledCost or
+        component_variable == ControllerComponentVariables::NumberOfDecimalsForCostValues) {
+        this->tariff_and_cost.update_cost_config();
+    }
+
     // TODO(piet): other special handling of changed variables can be added here...
 }
 
@@ -685,23 +706,43 @@ Provisioning::set_variables_internal(const std::vector<SetVariableData>& set_var
                                      const std::string& source, const bool allow_read_only) {
     std::map<SetVariableData, SetVariableResult> response;
 
-    // iterate over the set_variable_data_vector
-    for (const auto& set_variable_data : set_variable_data_vector) {
+    // validates variables against business logic of the spec, only valid ones are passed on to the device model. The
+    // values are written in batches, a value whose validation reads the device model starts a new batch so that the
+    // request behaves as if the values were set one after another
+    std::vector<SetVariableStatusEnum> statuses(set_variable_data_vector.size(), SetVariableStatusEnum::Rejected);
+    std::vector<std::size_t> batch_indices;
+    std::vector<SetVariableData> batch;
+    const auto write_batch = [&]() {
+        // attempt to set the values in one go includes device model validation
+        const auto batch_statuses = this->context.device_model.set_values(batch, source, allow_read_only);
+        for (std::size_t i = 0; i < batch_indices.size(); i++) {
+            statuses[batch_indices[i]] = batch_statuses.at(i);
+        }
+        batch_indices.clear();
+        batch.clear();
+    };
+
+    for (std::size_t i = 0; i < set_variable_data_vector.size(); i++) {
+        const auto& set_variable_data = set_variable_data_vector[i];
+        if (!batch.empty() and validation_depends_on_device_model(set_variable_data)) {
+            write_batch();
+        }
+        if (this->validate_set_variable(set_variable_data)) {
+            batch_indices.push_back(i);
+            batch.push_back(set_variable_data);
+        }
+    }
+    if (!batch.empty()) {
+        write_batch();
+    }
+
+    for (std::size_t i = 0; i < set_variable_data_vector.size(); i++) {
+        const auto& set_variable_data = set_variable_data_vector[i];
         SetVariableResult set_variable_result;
         set_variable_result.component = set_variable_data.component;
         set_variable_result.variable = set_variable_data.variable;
         set_variable_result.attributeType = set_variable_data.attributeType.value_or(AttributeEnum::Actual);
-
-        // validates variable against business logic of the spec
-        if (this->validate_set_variable(set_variable_data)) {
-            // attempt to set the value includes device model validation
-            set_variable_result.attributeStatus =
-                this->context.device_model.set_value(set_variable_data.component, set_variable_data.variable,
-                                                     set_variable_data.attributeType.value_or(AttributeEnum::Actual),
-                                                     set_variable_data.attributeValue.get(), source, allow_read_only);
-        } else {
-            set_variable_result.attributeStatus = SetVariableStatusEnum::Rejected;
-        }
+        set_variable_result.attributeStatus = statuses[i];
         response[set_variable_data] = set_variable_result;
     }
 
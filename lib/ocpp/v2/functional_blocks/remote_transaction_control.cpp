@@ -82,7 +82,7 @@ RemoteTransactionControl::RemoteTransactionControl(
 }
 
 void RemoteTransactionControl::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::RequestStartTransaction) {
         this->handle_remote_start_transaction_request(json_message);
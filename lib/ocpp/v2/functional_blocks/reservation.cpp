@@ -24,7 +24,7 @@ Reservation::Reservation(const FunctionalBlockContext& functional_block_context,
 }
 
 void Reservation::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::ReserveNow) {
         this->handle_reserve_now_request(json_message);
@@ -29,15 +29,21 @@ Security::Security(const FunctionalBlockContext& functional_block_context, Messa
     logging(logging),
     ocsp_updater(ocsp_updater),
     security_event_callback(security_event_callback),
+    certificate_signed_timer(&functional_block_context.executor->get_io_context()),
     csr_attempt(1),
-    client_certificate_expiration_check_timer([this]() { this->scheduled_check_client_certificate_expiration(); }),
-    v2g_certificate_expiration_check_timer([this]() { this->scheduled_check_v2g_certificate_expiration(); }) {
+    client_certificate_expiration_check_timer(&functional_block_context.executor->get_io_context(),
+                                              [this]() { this->scheduled_check_client_certificate_expiration(); }),
+    v2g_certificate_expiration_check_timer(&functional_block_context.executor->get_io_context(),
+                                           [this]() { this->scheduled_check_v2g_certificate_expiration(); }) {
 }
 
 Security::~Security() {
     try {
-        stop_certificate_signed_timer();
-        stop_certificate_expiration_check_timers();
+        // Stopped on the executor, so the timer handlers can not run while this object is destroyed
+        this->context.executor->run_and_wait([this]() {
+            this->stop_certificate_signed_timer();
+            this->stop_certificate_expiration_check_timers();
+        });
     } catch (...) {
         EVLOG_error << "Exception during dtor call of certificate timer stop";
         return;
@@ -45,7 +51,7 @@ Security::~Security() {
 }
 
 void Security::handle_message(const EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::CertificateSigned) {
         this->handle_certificate_signed_req(json_message);
@@ -90,14 +96,14 @@ Security::on_get_15118_ev_certificate_request(const Get15118EVCertificateRequest
     }
 
     const auto response_message = future_res.get();
-    EVLOG_debug << "Received Get15118EVCertificateResponse " << response_message.message;
+    EVLOG_debug << "Received Get15118EVCertificateResponse " << *response_message.message;
     if (response_message.messageType != MessageType::Get15118EVCertificateResponse) {
         response.status = Iso15118EVCertificateStatusEnum::Failed;
         return response;
     }
 
     try {
-        const ocpp::CallResult<Get15118EVCertificateResponse> call_result = response_message.message;
+        const ocpp::CallResult<Get15118EVCertificateResponse> call_result = *response_message.message;
         return call_result.msg;
     } catch (const EnumConversionException& e) {
         EVLOG_error << "EnumConversionException during handling of message: " << e.what();
@@ -396,6 +402,7 @@ void Security::handle_install_certificate_req(Call<InstallCertificateRequest> ca
             msg.certificate.get(), ocpp::evse_security_conversions::from_ocpp_v2(msg.certificateType));
         response.status = ocpp::evse_security_conversions::to_ocpp_v2(result);
         if (response.status == InstallCertificateStatusEnum::Accepted) {
+            this->context.contract_certificate_cache->clear();
             const auto& security_event = ocpp::security_events::RECONFIGURATIONOFSECURITYPARAMETERS;
             const std::string tech_info =
                 "Installed certificate: " + conversions::install_certificate_use_enum_to_string(msg.certificateType);
@@ -420,6 +427,7 @@ void Security::handle_delete_certificate_req(Call<DeleteCertificateRequest> call
     response.status = ocpp::evse_security_conversions::to_ocpp_v2(status);
 
     if (response.status == DeleteCertificateStatusEnum::Accepted) {
+        this->context.contract_certificate_cache->clear();
         const auto& security_event = ocpp::security_events::RECONFIGURATIONOFSECURITYPARAMETERS;
         const std::string tech_info =
             "Deleted certificate with serial number: " + msg.certificateHashData.serialNumber.get();
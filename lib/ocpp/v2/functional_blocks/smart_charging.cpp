@@ -21,6 +21,8 @@
 #include <ocpp/v2/messages/NotifyEVChargingNeeds.hpp>
 #include <ocpp/v2/messages/ReportChargingProfiles.hpp>
 #include <ocpp/v2/messages/SetChargingProfile.hpp>
+#include <ocpp/v21/messages/PullDynamicScheduleUpdate.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
 
 const std::int32_t STATION_WIDE_ID = 0;
 
@@ -28,6 +30,65 @@ using namespace std::chrono;
 
 namespace ocpp::v2 {
 namespace {
+/// \brief Time after which dynamic profiles that were updated in memory are written to the database
+constexpr seconds DYNAMIC_PROFILE_PERSIST_INTERVAL{60};
+
+/// \brief Shortest duration of the composite schedules of a limits changed subscription
+constexpr std::int32_t LIMITS_CHANGED_MIN_DURATION_S = 1;
+/// \brief Shortest time between two evaluations of the limits changed subscription, so that a period change in the
+/// past does not re-arm the timer immediately
+constexpr milliseconds LIMITS_CHANGED_MIN_INTERVAL{1000};
+
+/// \brief Replaces the values of \p period that are present in \p update
+void apply_schedule_update(ChargingSchedulePeriod& period, const ChargingScheduleUpdate& update) {
+    const auto replace = [](std::optional<float>& value, const std::optional<float>& new_value) {
+        if (new_value.has_value()) {
+            value = new_value;
+        }
+    };
+    replace(period.limit, update.limit);
+    replace(period.limit_L2, update.limit_L2);
+    replace(period.limit_L3, update.limit_L3);
+    replace(period.dischargeLimit, update.dischargeLimit);
+    replace(period.dischargeLimit_L2, update.dischargeLimit_L2);
+    replace(period.dischargeLimit_L3, update.dischargeLimit_L3);
+    replace(period.setpoint, update.setpoint);
+    replace(period.setpoint_L2, update.setpoint_L2);
+    replace(period.setpoint_L3, update.setpoint_L3);
+    replace(period.setpointReactive, update.setpointReactive);
+    replace(period.setpointReactive_L2, update.setpointReactive_L2);
+    replace(period.setpointReactive_L3, update.setpointReactive_L3);
+}
+
+/// \brief Checks that the limits of \p update are not negative and the discharge limits are not positive
+bool has_valid_signs(const ChargingScheduleUpdate& update) {
+    const auto is_negative = [](const std::optional<float>& value) { return value.has_value() and value.value() < 0; };
+    const auto is_positive = [](const std::optional<float>& value) { return value.has_value() and value.value() > 0; };
+    return !is_negative(update.limit) and !is_negative(update.limit_L2) and !is_negative(update.limit_L3) and
+           !is_positive(update.dischargeLimit) and !is_positive(update.dischargeLimit_L2) and
+           !is_positive(update.dischargeLimit_L3);
+}
+
+/// \returns the time of the first pull of a dynamic \p profile, std::nullopt if the profile is not pulled
+std::optional<DateTime> get_first_pull(const ChargingProfile& profile) {
+    if (!profile.dynUpdateInterval.has_value() or profile.dynUpdateInterval.value() <= 0) {
+        return std::nullopt;
+    }
+    const auto now = DateTime();
+    const auto last_update = profile.dynUpdateTime.value_or(now);
+    const auto next_pull = DateTime(last_update.to_time_point() + seconds(profile.dynUpdateInterval.value()));
+    return next_pull < now ? now : next_pull;
+}
+
+/// \brief Checks if the current periods \p lhs and \p rhs of two composite schedules have the same limits
+bool is_same_period(const std::optional<ChargingSchedulePeriod>& lhs,
+                    const std::optional<ChargingSchedulePeriod>& rhs) {
+    if (!lhs.has_value() or !rhs.has_value()) {
+        return lhs.has_value() == rhs.has_value();
+    }
+    return json(lhs.value()) == json(rhs.value());
+}
+
 /// \brief validates that the given \p profile from a RequestStartTransactionRequest is of the correct type
 /// TxProfile
 ProfileValidationResultEnum validate_request_start_transaction_profile(const ChargingProfile& profile) {
@@ -154,6 +215,8 @@ std::string profile_validation_result_to_string(ProfileValidationResultEnum e) {
         return "RequestStartTransactionNonTxProfile";
     case ProfileValidationResultEnum::ChargingProfileEmptyChargingSchedules:
         return "ChargingProfileEmptyChargingSchedules";
+    case ProfileValidationResultEnum::ChargingProfileNotFound:
+        return "ChargingProfileNotFound";
     }
 
     throw EnumToStringException{e, "ProfileValidationResultEnum"};
@@ -184,6 +247,8 @@ std::string profile_validation_result_to_reason_code(ProfileValidationResultEnum
         return "UnsupportedKind";
     case ProfileValidationResultEnum::ChargingProfileNotDynamic:
         return "InvalidProfile";
+    case ProfileValidationResultEnum::ChargingProfileNotFound:
+        return "UnknownProfile";
     case ProfileValidationResultEnum::ChargingProfileNoChargingSchedulePeriods:
     case ProfileValidationResultEnum::ChargingProfileFirstStartScheduleIsNotZero:
     case ProfileValidationResultEnum::ChargingProfileMissingRequiredStartSchedule:
@@ -274,11 +339,32 @@ SmartCharging::SmartCharging(const FunctionalBlockContext& functional_block_cont
                              StopTransactionCallback stop_transaction_callback) :
     context(functional_block_context),
     set_charging_profiles_callback(set_charging_profiles_callback),
-    stop_transaction_callback(stop_transaction_callback) {
+    stop_transaction_callback(stop_transaction_callback),
+    limits_changed_duration(0),
+    limits_changed_unit(ChargingRateUnitEnum::A),
+    next_limits_change_timer(&functional_block_context.executor->get_io_context()),
+    dynamic_profiles_persist_pending(false),
+    dynamic_profiles_persist_timer(&functional_block_context.executor->get_io_context()),
+    dynamic_update_pull_timer(&functional_block_context.executor->get_io_context()) {
+    this->load_dynamic_profiles();
+}
+
+SmartCharging::~SmartCharging() {
+    try {
+        // Stopped on the executor, so the timer handlers can not run while this object is destroyed
+        this->context.executor->run_and_wait([this]() {
+            this->next_limits_change_timer.stop();
+            this->dynamic_update_pull_timer.stop();
+            this->dynamic_profiles_persist_timer.stop();
+        });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of smart charging timer stop";
+    }
+    this->persist_dynamic_profiles();
 }
 
 void SmartCharging::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::SetChargingProfile) {
         this->handle_set_charging_profile_req(json_message);
@@ -290,6 +376,11 @@ void SmartCharging::handle_message(const ocpp::EnhancedMessage<MessageType>& mes
         this->handle_get_composite_schedule_req(json_message);
     } else if (message.messageType == MessageType::NotifyEVChargingNeedsResponse) {
         this->handle_notify_ev_charging_needs_response(message);
+    } else if (message.messageType == MessageType::UpdateDynamicSchedule and
+               this->context.ocpp_version == OcppProtocolVersion::v21) {
+        this->handle_update_dynamic_schedule_req(json_message);
+    } else if (message.messageType == MessageType::PullDynamicScheduleUpdateResponse) {
+        this->handle_pull_dynamic_schedule_update_response(message);
     } else {
         throw MessageTypeNotImplementedException(message.messageType);
     }
@@ -384,8 +475,62 @@ std::vector<CompositeSchedule> SmartCharging::get_all_composite_schedules(const
     return composite_schedules;
 }
 
+void SmartCharging::subscribe_limits_changed(const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                                             const LimitsChangedCallback& callback) {
+    if (duration < LIMITS_CHANGED_MIN_DURATION_S) {
+        EVLOG_warning << "Limits changed subscription with a duration of " << duration << "s, using "
+                      << LIMITS_CHANGED_MIN_DURATION_S << "s instead";
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->limits_changed_mutex);
+        this->limits_changed_callback = callback;
+        this->limits_changed_duration = std::max(duration, LIMITS_CHANGED_MIN_DURATION_S);
+        this->limits_changed_unit = unit;
+        this->reported_limits.clear();
+    }
+    this->notify_limits_changed();
+}
+
+void SmartCharging::unsubscribe_limits_changed() {
+    std::lock_guard<std::mutex> lock(this->limits_changed_mutex);
+    this->next_limits_change_timer.stop();
+    this->limits_changed_callback = nullptr;
+    this->reported_limits.clear();
+}
+
 void SmartCharging::delete_transaction_tx_profiles(const std::string& transaction_id) {
+    this->persist_dynamic_profiles();
     this->context.database_handler.delete_charging_profile_by_transaction_id(transaction_id);
+    this->load_dynamic_profiles();
+    this->notify_limits_changed();
+}
+
+void SmartCharging::on_transaction_changed(const std::int32_t evse_id) {
+    this->notify_evse_limits_changed(evse_id);
+}
+
+void SmartCharging::clear_invalid_profiles() {
+    // Deleted profiles must also be dropped from the in-memory dynamic profiles, otherwise they are written back
+    this->persist_dynamic_profiles();
+    try {
+        auto evses = this->context.database_handler.get_all_charging_profiles_group_by_evse();
+        EVLOG_info << "Found " << evses.size() << " evse in the database";
+        for (const auto& [evse_id, profiles] : evses) {
+            for (auto profile : profiles) {
+                try {
+                    if (this->conform_and_validate_profile(profile, evse_id) != ProfileValidationResultEnum::Valid) {
+                        this->context.database_handler.delete_charging_profile(profile.id);
+                    }
+                } catch (const everest::db::QueryExecutionException& e) {
+                    EVLOG_warning << "Failed database operation for ChargingProfiles: " << e.what();
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Unknown error while loading charging profiles from database: " << e.what();
+    }
+    this->load_dynamic_profiles();
+    this->notify_limits_changed();
 }
 
 SetChargingProfileResponse SmartCharging::conform_validate_and_add_profile(ChargingProfile& profile,
@@ -996,6 +1141,7 @@ SetChargingProfileResponse SmartCharging::add_profile(ChargingProfile& profile,
         // only store ChargingStationMaxProfile, TxDefaultProfile and PriorityCharging, but currently we store
         // everything here.
         this->context.database_handler.insert_or_update_charging_profile(evse_id, profile, charging_limit_source);
+        this->on_profile_stored(profile, evse_id, charging_limit_source);
     } catch (const everest::db::QueryExecutionException& e) {
         EVLOG_error << "Could not store ChargingProfile in the database: " << e.what();
         response.status = ChargingProfileStatusEnum::Rejected;
@@ -1003,6 +1149,10 @@ SetChargingProfileResponse SmartCharging::add_profile(ChargingProfile& profile,
         response.statusInfo->reasonCode = "InternalError";
     }
 
+    if (response.status == ChargingProfileStatusEnum::Accepted) {
+        this->notify_limits_changed();
+    }
+
     return response;
 }
 
@@ -1010,16 +1160,20 @@ ClearChargingProfileResponse SmartCharging::clear_profiles(const ClearChargingPr
     ClearChargingProfileResponse response;
     response.status = ClearChargingProfileStatusEnum::Unknown;
 
+    this->persist_dynamic_profiles();
     if (this->context.database_handler.clear_charging_profiles_matching_criteria(request.chargingProfileId,
                                                                                  request.chargingProfileCriteria)) {
         response.status = ClearChargingProfileStatusEnum::Accepted;
+        this->load_dynamic_profiles();
+        this->notify_limits_changed();
     }
 
     return response;
 }
 
 std::vector<ReportedChargingProfile>
-SmartCharging::get_reported_profiles(const GetChargingProfilesRequest& request) const {
+SmartCharging::get_reported_profiles(const GetChargingProfilesRequest& request) {
+    this->persist_dynamic_profiles();
     return this->context.database_handler.get_charging_profiles_matching_criteria(request.evseId,
                                                                                   request.chargingProfile);
 }
@@ -1214,8 +1368,8 @@ void SmartCharging::handle_get_charging_profiles_req(Call<GetChargingProfilesReq
 }
 
 void SmartCharging::handle_notify_ev_charging_needs_response(const EnhancedMessage<MessageType>& call_result) {
-    CallResult<NotifyEVChargingNeedsResponse> response = call_result.message;
-    const Call<NotifyEVChargingNeedsRequest> request = call_result.call_message;
+    CallResult<NotifyEVChargingNeedsResponse> response = *call_result.message;
+    const Call<NotifyEVChargingNeedsRequest> request = *call_result.call_message;
     EVLOG_debug << "Received NotifyEVChargingNeedsResponse: " << response.msg
                 << "\nwith messageId: " << response.uniqueId;
     const bool is_15118_20 = request.msg.chargingNeeds.v2xChargingParameters.has_value();
@@ -1260,6 +1414,50 @@ void SmartCharging::handle_notify_ev_charging_needs_response(const EnhancedMessa
     }
 }
 
+void SmartCharging::handle_update_dynamic_schedule_req(Call<v21::UpdateDynamicScheduleRequest> call) {
+    EVLOG_debug << "Received UpdateDynamicScheduleRequest: " << call.msg << "\nwith messageId: " << call.uniqueId;
+    v21::UpdateDynamicScheduleResponse response;
+    response.status = ChargingProfileStatusEnum::Accepted;
+
+    std::optional<std::int32_t> evse_id;
+    const auto result =
+        this->apply_dynamic_schedule_update(call.msg.chargingProfileId, call.msg.scheduleUpdate, evse_id);
+    if (result != ProfileValidationResultEnum::Valid) {
+        response.status = ChargingProfileStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = conversions::profile_validation_result_to_reason_code(result);
+        response.statusInfo->additionalInfo = conversions::profile_validation_result_to_string(result);
+    }
+
+    const ocpp::CallResult<v21::UpdateDynamicScheduleResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+
+    if (evse_id.has_value()) {
+        this->notify_evse_limits_changed(evse_id.value());
+    }
+}
+
+void SmartCharging::handle_pull_dynamic_schedule_update_response(const EnhancedMessage<MessageType>& call_result) {
+    const CallResult<v21::PullDynamicScheduleUpdateResponse> response = *call_result.message;
+    const Call<v21::PullDynamicScheduleUpdateRequest> request = *call_result.call_message;
+    EVLOG_debug << "Received PullDynamicScheduleUpdateResponse: " << response.msg
+                << "\nwith messageId: " << response.uniqueId;
+
+    if (response.msg.status != ChargingProfileStatusEnum::Accepted or !response.msg.scheduleUpdate.has_value()) {
+        return;
+    }
+
+    std::optional<std::int32_t> evse_id;
+    const auto result = this->apply_dynamic_schedule_update(request.msg.chargingProfileId,
+                                                            response.msg.scheduleUpdate.value(), evse_id);
+    if (result != ProfileValidationResultEnum::Valid) {
+        EVLOG_warning << "Could not apply the schedule update of charging profile " << request.msg.chargingProfileId
+                      << ": " << result;
+        return;
+    }
+    this->notify_evse_limits_changed(evse_id.value());
+}
+
 void SmartCharging::handle_get_composite_schedule_req(Call<GetCompositeScheduleRequest> call) {
     EVLOG_debug << "Received GetCompositeScheduleRequest: " << call.msg << "\nwith messageId: " << call.uniqueId;
     const auto response = this->get_composite_schedule_internal(call.msg);
@@ -1316,6 +1514,235 @@ GetCompositeScheduleResponse SmartCharging::get_composite_schedule_internal(cons
     return response;
 }
 
+void SmartCharging::notify_limits_changed() {
+    LimitsChangedCallback callback;
+    std::vector<CompositeSchedule> changed_schedules;
+    {
+        std::lock_guard<std::mutex> lock(this->limits_changed_mutex);
+        if (this->limits_changed_callback == nullptr) {
+            return;
+        }
+        callback = this->limits_changed_callback;
+
+        const auto now = DateTime().to_time_point();
+        // Profiles that start after the duration of the composite schedules are picked up at its end
+        auto next_change = now + seconds(this->limits_changed_duration);
+
+        for (auto& schedule : this->get_all_composite_schedules(this->limits_changed_duration,
+                                                                this->limits_changed_unit)) {
+            const auto& periods = schedule.chargingSchedulePeriod;
+            if (periods.size() > 1) {
+                next_change =
+                    std::min(next_change, schedule.scheduleStart.to_time_point() + seconds(periods.at(1).startPeriod));
+            }
+
+            std::optional<ChargingSchedulePeriod> current_period;
+            if (!periods.empty()) {
+                current_period = periods.front();
+            }
+
+            const auto reported = this->reported_limits.find(schedule.evseId);
+            if (reported == this->reported_limits.end() or !is_same_period(reported->second, current_period)) {
+                this->reported_limits[schedule.evseId] = current_period;
+                changed_schedules.push_back(std::move(schedule));
+            }
+        }
+
+        const auto timeout = std::max(duration_cast<milliseconds>(next_change - now), LIMITS_CHANGED_MIN_INTERVAL);
+        this->next_limits_change_timer.timeout([this]() { this->notify_limits_changed(); }, timeout);
+    }
+
+    if (!changed_schedules.empty()) {
+        callback(changed_schedules);
+    }
+}
+
+void SmartCharging::notify_evse_limits_changed(const std::int32_t evse_id) {
+    if (evse_id == STATION_WIDE_ID) {
+        // A station wide profile can change the limits of all evses
+        this->notify_limits_changed();
+        return;
+    }
+
+    LimitsChangedCallback callback;
+    std::optional<CompositeSchedule> changed_schedule;
+    {
+        std::lock_guard<std::mutex> lock(this->limits_changed_mutex);
+        if (this->limits_changed_callback == nullptr) {
+            return;
+        }
+        callback = this->limits_changed_callback;
+
+        GetCompositeScheduleRequest request;
+        request.duration = this->limits_changed_duration;
+        request.evseId = evse_id;
+        request.chargingRateUnit = this->limits_changed_unit;
+        auto response = this->get_composite_schedule_internal(request);
+        if (response.status != GenericStatusEnum::Accepted or !response.schedule.has_value()) {
+            return;
+        }
+
+        const auto& periods = response.schedule->chargingSchedulePeriod;
+        std::optional<ChargingSchedulePeriod> current_period;
+        if (!periods.empty()) {
+            current_period = periods.front();
+        }
+        const auto reported = this->reported_limits.find(evse_id);
+        if (reported == this->reported_limits.end() or !is_same_period(reported->second, current_period)) {
+            this->reported_limits[evse_id] = current_period;
+            changed_schedule = std::move(response.schedule);
+        }
+    }
+
+    if (changed_schedule.has_value()) {
+        callback({changed_schedule.value()});
+    }
+}
+
+ProfileValidationResultEnum SmartCharging::apply_dynamic_schedule_update(const std::int32_t profile_id,
+                                                                         const ChargingScheduleUpdate& update,
+                                                                         std::optional<std::int32_t>& evse_id) {
+    std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+    const auto it = this->dynamic_profiles.find(profile_id);
+    if (it == this->dynamic_profiles.end()) {
+        return ProfileValidationResultEnum::ChargingProfileNotFound;
+    }
+    if (!has_valid_signs(update)) {
+        return ProfileValidationResultEnum::ChargingSchedulePeriodSignDifference;
+    }
+
+    auto& dynamic_profile = it->second;
+    auto& schedules = dynamic_profile.profile.chargingSchedule;
+    if (schedules.empty() or schedules.front().chargingSchedulePeriod.empty()) {
+        return ProfileValidationResultEnum::ChargingProfileNoChargingSchedulePeriods;
+    }
+
+    // A dynamic profile has a single period, which is updated in place
+    apply_schedule_update(schedules.front().chargingSchedulePeriod.front(), update);
+    const DateTime now;
+    dynamic_profile.profile.dynUpdateTime = now;
+    dynamic_profile.dirty = true;
+    if (dynamic_profile.next_pull.has_value()) {
+        dynamic_profile.next_pull = get_first_pull(dynamic_profile.profile);
+        this->schedule_dynamic_update_pull();
+    }
+    evse_id = dynamic_profile.evse_id;
+
+    if (!this->dynamic_profiles_persist_pending) {
+        this->dynamic_profiles_persist_pending = true;
+        this->dynamic_profiles_persist_timer.timeout([this]() { this->persist_dynamic_profiles(); },
+                                                     DYNAMIC_PROFILE_PERSIST_INTERVAL);
+    }
+
+    return ProfileValidationResultEnum::Valid;
+}
+
+void SmartCharging::load_dynamic_profiles() {
+    std::map<std::int32_t, std::vector<ChargingProfile>> profiles;
+    try {
+        profiles = this->context.database_handler.get_all_charging_profiles_group_by_evse();
+    } catch (const everest::db::QueryExecutionException& e) {
+        EVLOG_error << "Could not load dynamic charging profiles: " << e.what();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+    this->dynamic_profiles.clear();
+    for (const auto& [evse_id, evse_profiles] : profiles) {
+        for (const auto& profile : evse_profiles) {
+            if (profile.chargingProfileKind != ChargingProfileKindEnum::Dynamic) {
+                continue;
+            }
+            DynamicProfile dynamic_profile{evse_id, profile,
+                                           this->context.database_handler.get_charging_limit_source_for_profile(
+                                               profile.id)};
+            dynamic_profile.next_pull = get_first_pull(profile);
+            this->dynamic_profiles.insert({profile.id, std::move(dynamic_profile)});
+        }
+    }
+    this->schedule_dynamic_update_pull();
+}
+
+void SmartCharging::on_profile_stored(const ChargingProfile& profile, const std::int32_t evse_id,
+                                      const CiString<20>& source) {
+    std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+    if (profile.chargingProfileKind != ChargingProfileKindEnum::Dynamic) {
+        // The id may have belonged to a dynamic profile before
+        if (this->dynamic_profiles.erase(profile.id) > 0) {
+            this->schedule_dynamic_update_pull();
+        }
+        return;
+    }
+
+    DynamicProfile dynamic_profile{evse_id, profile, source};
+    dynamic_profile.next_pull = get_first_pull(profile);
+    this->dynamic_profiles.insert_or_assign(profile.id, std::move(dynamic_profile));
+    this->schedule_dynamic_update_pull();
+}
+
+void SmartCharging::persist_dynamic_profiles() {
+    std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+    this->dynamic_profiles_persist_pending = false;
+    for (auto& [profile_id, dynamic_profile] : this->dynamic_profiles) {
+        if (!dynamic_profile.dirty) {
+            continue;
+        }
+        try {
+            this->context.database_handler.insert_or_update_charging_profile(
+                dynamic_profile.evse_id, dynamic_profile.profile, dynamic_profile.charging_limit_source);
+            dynamic_profile.dirty = false;
+        } catch (const everest::db::QueryExecutionException& e) {
+            EVLOG_error << "Could not store dynamic ChargingProfile " << profile_id << " in the database: " << e.what();
+        }
+    }
+}
+
+void SmartCharging::schedule_dynamic_update_pull() {
+    std::optional<DateTime> next_pull;
+    for (const auto& [profile_id, dynamic_profile] : this->dynamic_profiles) {
+        if (dynamic_profile.next_pull.has_value() and
+            (!next_pull.has_value() or dynamic_profile.next_pull.value() < next_pull.value())) {
+            next_pull = dynamic_profile.next_pull;
+        }
+    }
+
+    if (!next_pull.has_value()) {
+        this->dynamic_update_pull_timer.stop();
+        return;
+    }
+    const auto timeout =
+        std::max(duration_cast<milliseconds>(next_pull.value().to_time_point() - DateTime().to_time_point()),
+                 milliseconds(0));
+    this->dynamic_update_pull_timer.timeout([this]() { this->pull_dynamic_schedule_updates(); }, timeout);
+}
+
+void SmartCharging::pull_dynamic_schedule_updates() {
+    std::vector<std::int32_t> profile_ids;
+    {
+        std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+        const DateTime now;
+        for (auto& [profile_id, dynamic_profile] : this->dynamic_profiles) {
+            if (!dynamic_profile.next_pull.has_value() or now < dynamic_profile.next_pull.value()) {
+                continue;
+            }
+            profile_ids.push_back(profile_id);
+            dynamic_profile.next_pull =
+                DateTime(now.to_time_point() + seconds(dynamic_profile.profile.dynUpdateInterval.value_or(0)));
+        }
+        this->schedule_dynamic_update_pull();
+    }
+
+    if (this->context.ocpp_version != OcppProtocolVersion::v21) {
+        return;
+    }
+    for (const auto profile_id : profile_ids) {
+        v21::PullDynamicScheduleUpdateRequest request;
+        request.chargingProfileId = profile_id;
+        const ocpp::Call<v21::PullDynamicScheduleUpdateRequest> call(request);
+        this->context.message_dispatcher.dispatch_call(call);
+    }
+}
+
 bool SmartCharging::is_overlapping_validity_period(const ChargingProfile& candidate_profile,
                                                    std::int32_t candidate_evse_id) const {
     if (candidate_profile.chargingProfilePurpose == ChargingProfilePurposeEnum::TxProfile) {
@@ -1390,6 +1817,16 @@ SmartCharging::get_valid_profiles_for_evse(std::int32_t evse_id,
     std::vector<ChargingProfile> valid_profiles;
 
     auto evse_profiles = this->context.database_handler.get_charging_profiles_for_evse(evse_id);
+    {
+        // Dynamic profiles may have been updated in memory and not yet been written to the database
+        std::lock_guard<std::mutex> lock(this->dynamic_profiles_mutex);
+        for (auto& profile : evse_profiles) {
+            const auto it = this->dynamic_profiles.find(profile.id);
+            if (it != this->dynamic_profiles.end() and it->second.dirty) {
+                profile = it->second.profile;
+            }
+        }
+    }
     for (auto profile : evse_profiles) {
         if (this->conform_and_validate_profile(profile, evse_id) == ProfileValidationResultEnum::Valid and
             std::find(std::begin(purposes_to_ignore), std::end(purposes_to_ignore), profile.chargingProfilePurpose) ==
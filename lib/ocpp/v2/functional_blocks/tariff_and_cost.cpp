@@ -3,7 +3,10 @@
 
 #include <ocpp/v2/functional_blocks/tariff_and_cost.hpp>
 
+#include <boost/asio/post.hpp>
+
 #include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/device_model.hpp>
 #include <ocpp/v2/evse_manager.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
@@ -11,6 +14,11 @@
 
 #include <ocpp/v2/messages/CostUpdated.hpp>
 
+#include <ocpp/v21/messages/ChangeTransactionTariff.hpp>
+#include <ocpp/v21/messages/ClearTariffs.hpp>
+#include <ocpp/v21/messages/GetTariffs.hpp>
+#include <ocpp/v21/messages/SetDefaultTariff.hpp>
+
 const auto DEFAULT_PRICE_NUMBER_OF_DECIMALS = 3;
 
 namespace ocpp::v2 {
@@ -22,13 +30,46 @@ TariffAndCost::TariffAndCost(const FunctionalBlockContext& functional_block_cont
     meter_values(meter_values),
     tariff_message_callback(tariff_message_callback),
     set_running_cost_callback(set_running_cost_callback),
-    io_context(io_context) {
+    io_context(io_context),
+    cost_enabled(false),
+    number_of_decimals(DEFAULT_PRICE_NUMBER_OF_DECIMALS),
+    meter_value_processing(std::make_shared<MeterValueProcessing>()) {
+    try {
+        for (auto& [evse_id, tariff] : this->context.database_handler.get_default_tariffs()) {
+            this->default_tariffs[evse_id].push_back(std::move(tariff));
+        }
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Could not load the default tariffs from the database: " << e.what();
+    }
+
+    for (auto& evse : this->context.evse_manager) {
+        this->published_meter_values.emplace(evse.get_id(), std::make_unique<PublishedMeterValue>());
+    }
+
+    this->update_cost_config();
+}
+
+TariffAndCost::~TariffAndCost() {
+    // Handlers that are still queued on the io_context must not access this object anymore
+    const std::lock_guard<std::mutex> lk(this->meter_value_processing->mutex);
+    this->meter_value_processing->stopped = true;
 }
 
 void TariffAndCost::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
+    const auto& json_message = *message.message;
     if (message.messageType == MessageType::CostUpdated) {
-        const auto& json_message = message.message;
         this->handle_costupdated_req(json_message);
+    } else if (this->context.ocpp_version != OcppProtocolVersion::v21) {
+        // The tariff messages were introduced with OCPP 2.1
+        throw MessageTypeNotImplementedException(message.messageType);
+    } else if (message.messageType == MessageType::SetDefaultTariff) {
+        this->handle_set_default_tariff_req(json_message);
+    } else if (message.messageType == MessageType::GetTariffs) {
+        this->handle_get_tariffs_req(json_message);
+    } else if (message.messageType == MessageType::ClearTariffs) {
+        this->handle_clear_tariffs_req(json_message);
+    } else if (message.messageType == MessageType::ChangeTransactionTariff) {
+        this->handle_change_transaction_tariff_req(json_message);
     } else {
         throw MessageTypeNotImplementedException(message.messageType);
     }
@@ -169,15 +210,9 @@ void TariffAndCost::handle_cost_and_tariff(const TransactionEventResponse& respo
             running_cost.cost_messages = cost_messages;
         }
 
-        const int number_of_decimals =
-            this->context.device_model
-                .get_optional_value<int>(ControllerComponentVariables::NumberOfDecimalsForCostValues)
-                .value_or(DEFAULT_PRICE_NUMBER_OF_DECIMALS);
-        const std::uint32_t decimals = (number_of_decimals < 0 ? DEFAULT_PRICE_NUMBER_OF_DECIMALS
-                                                               : static_cast<std::uint32_t>(number_of_decimals));
         const std::optional<std::string> currency =
             this->context.device_model.get_value<std::string>(ControllerComponentVariables::TariffCostCtrlrCurrency);
-        this->set_running_cost_callback.value()(running_cost, decimals, currency);
+        this->set_running_cost_callback.value()(running_cost, this->get_number_of_decimals(), currency);
     }
 }
 
@@ -222,14 +257,9 @@ void TariffAndCost::handle_costupdated_req(const Call<CostUpdatedRequest> call)
         EVLOG_error << "Received CostUpdatedRequest, but transaction id is not a valid transaction id.";
     }
 
-    const int number_of_decimals =
-        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::NumberOfDecimalsForCostValues)
-            .value_or(DEFAULT_PRICE_NUMBER_OF_DECIMALS);
-    const std::uint32_t decimals =
-        (number_of_decimals < 0 ? DEFAULT_PRICE_NUMBER_OF_DECIMALS : static_cast<std::uint32_t>(number_of_decimals));
     const std::optional<std::string> currency =
         this->context.device_model.get_value<std::string>(ControllerComponentVariables::TariffCostCtrlrCurrency);
-    this->set_running_cost_callback.value()(running_cost, decimals, currency);
+    this->set_running_cost_callback.value()(running_cost, this->get_number_of_decimals(), currency);
 
     this->context.message_dispatcher.dispatch_call_result(call_result);
 
@@ -256,6 +286,444 @@ void TariffAndCost::handle_costupdated_req(const Call<CostUpdatedRequest> call)
         this->io_context);
 }
 
+void TariffAndCost::on_transaction_started(const std::int32_t evse_id, const std::string& transaction_id,
+                                           const DateTime& timestamp, const MeterValue& meter_start) {
+    const bool charging = this->is_charging(evse_id);
+    const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+
+    TransactionTariff transaction_tariff;
+    transaction_tariff.transaction_id = transaction_id;
+    transaction_tariff.last_sample = create_tariff_meter_sample(meter_start, charging);
+    transaction_tariff.last_sample.timestamp = timestamp;
+
+    if (this->is_tariff_enabled()) {
+        const auto tariff = this->get_default_tariff(evse_id, timestamp);
+        if (tariff.has_value()) {
+            transaction_tariff.calculator.emplace(tariff.value(), transaction_tariff.last_sample,
+                                                  this->get_utc_offset());
+        }
+    }
+
+    this->transaction_tariffs.insert_or_assign(evse_id, std::move(transaction_tariff));
+}
+
+void TariffAndCost::on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) {
+    const auto published = this->published_meter_values.find(evse_id);
+    if (published == this->published_meter_values.end()) {
+        // No transaction can be started on an unknown EVSE, so there is no cost to calculate
+        return;
+    }
+
+    // Only the latest meter value is handed over, the caller never waits for the cost calculation
+    auto& published_meter_value = *published->second;
+    published_meter_value.meter_value.publish(meter_value);
+    if (published_meter_value.processing_scheduled.exchange(true)) {
+        return;
+    }
+
+    boost::asio::post(this->io_context, [this, evse_id, processing = this->meter_value_processing]() {
+        const std::lock_guard<std::mutex> lk(processing->mutex);
+        if (!processing->stopped) {
+            this->process_meter_value(evse_id);
+        }
+    });
+}
+
+void TariffAndCost::process_meter_value(const std::int32_t evse_id) {
+    auto& published_meter_value = *this->published_meter_values.at(evse_id);
+    // Reset before consuming, so a meter value that is published meanwhile schedules a new processing
+    published_meter_value.processing_scheduled = false;
+    MeterValue meter_value;
+    if (!published_meter_value.meter_value.consume(meter_value)) {
+        return;
+    }
+
+    std::optional<RunningCost> running_cost;
+    std::optional<std::string> currency;
+    {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        const auto it = this->transaction_tariffs.find(evse_id);
+        if (it == this->transaction_tariffs.end()) {
+            return;
+        }
+
+        auto& transaction_tariff = it->second;
+        const bool charging = this->is_charging(evse_id);
+        auto sample = create_tariff_meter_sample(meter_value, charging);
+        if (!sample.energy_wh.has_value()) {
+            sample.energy_wh = transaction_tariff.last_sample.energy_wh;
+        }
+        transaction_tariff.last_sample = sample;
+        if (!transaction_tariff.calculator.has_value()) {
+            return;
+        }
+
+        transaction_tariff.calculator->update(sample);
+        if (this->is_cost_enabled()) {
+            running_cost = this->create_running_cost(transaction_tariff, charging ? RunningCostState::Charging
+                                                                                  : RunningCostState::Idle);
+            currency = transaction_tariff.calculator->get_tariff().currency.get();
+        }
+    }
+
+    if (running_cost.has_value()) {
+        this->report_running_cost(running_cost.value(), currency);
+    }
+}
+
+void TariffAndCost::on_transaction_finished(const std::int32_t evse_id, const DateTime& timestamp,
+                                            const MeterValue& meter_stop) {
+    std::optional<RunningCost> running_cost;
+    std::optional<std::string> currency;
+    {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        const auto it = this->transaction_tariffs.find(evse_id);
+        if (it == this->transaction_tariffs.end()) {
+            return;
+        }
+
+        auto& transaction_tariff = it->second;
+        if (transaction_tariff.calculator.has_value()) {
+            auto sample = create_tariff_meter_sample(meter_stop, false);
+            sample.timestamp = timestamp;
+            // The EV did not change its state since the last meter value, so the last period is priced with that
+            // state
+            sample.charging = transaction_tariff.last_sample.charging;
+            transaction_tariff.calculator->update(sample);
+            if (this->is_cost_enabled()) {
+                running_cost = this->create_running_cost(transaction_tariff, RunningCostState::Finished);
+                currency = transaction_tariff.calculator->get_tariff().currency.get();
+            }
+        }
+        this->transaction_tariffs.erase(it);
+    }
+
+    if (running_cost.has_value()) {
+        this->report_running_cost(running_cost.value(), currency);
+    }
+}
+
+void TariffAndCost::handle_set_default_tariff_req(const Call<v21::SetDefaultTariffRequest> call) {
+    v21::SetDefaultTariffResponse response;
+    const auto& tariff = call.msg.tariff;
+
+    if (!this->is_tariff_enabled()) {
+        response.status = TariffSetStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "NotEnabled";
+    } else if (call.msg.evseId != 0 and !this->context.evse_manager.does_evse_exist(call.msg.evseId)) {
+        response.status = TariffSetStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "UnknownEvse";
+    } else {
+        response.status = this->validate_tariff(tariff);
+    }
+
+    if (response.status == TariffSetStatusEnum::Accepted) {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        const json tariff_json = tariff;
+        // A tariff id may be set on several EVSEs, but it has to refer to the same tariff on all of them
+        for (const auto& [evse_id, tariffs] : this->default_tariffs) {
+            for (const auto& existing : tariffs) {
+                if (existing.tariffId == tariff.tariffId and json(existing) != tariff_json) {
+                    response.status = TariffSetStatusEnum::DuplicateTariffId;
+                }
+            }
+        }
+
+        if (response.status == TariffSetStatusEnum::Accepted) {
+            try {
+                this->context.database_handler.insert_or_update_default_tariff(call.msg.evseId, tariff);
+                auto& tariffs = this->default_tariffs[call.msg.evseId];
+                auto it = std::find_if(tariffs.begin(), tariffs.end(), [&tariff](const Tariff& existing) {
+                    return existing.tariffId == tariff.tariffId;
+                });
+                if (it == tariffs.end()) {
+                    tariffs.push_back(tariff);
+                } else {
+                    *it = tariff;
+                }
+            } catch (const everest::db::QueryExecutionException& e) {
+                EVLOG_error << "Could not store default tariff: " << e.what();
+                response.status = TariffSetStatusEnum::Rejected;
+            }
+        }
+    }
+
+    const ocpp::CallResult<v21::SetDefaultTariffResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+void TariffAndCost::handle_get_tariffs_req(const Call<v21::GetTariffsRequest> call) {
+    v21::GetTariffsResponse response;
+    response.status = TariffGetStatusEnum::Accepted;
+
+    if (!this->is_tariff_enabled()) {
+        response.status = TariffGetStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "NotEnabled";
+    } else if (call.msg.evseId != 0 and !this->context.evse_manager.does_evse_exist(call.msg.evseId)) {
+        response.status = TariffGetStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "UnknownEvse";
+    } else {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        std::vector<TariffAssignment> assignments;
+        const auto add_assignment = [&assignments](const Tariff& tariff, const TariffKindEnum kind,
+                                                   const std::int32_t evse_id) {
+            auto it = std::find_if(assignments.begin(), assignments.end(), [&](const TariffAssignment& assignment) {
+                return assignment.tariffId == tariff.tariffId and assignment.tariffKind == kind;
+            });
+            if (it == assignments.end()) {
+                TariffAssignment assignment;
+                assignment.tariffId = tariff.tariffId;
+                assignment.tariffKind = kind;
+                assignment.validFrom = tariff.validFrom;
+                it = assignments.insert(assignments.end(), assignment);
+            }
+            if (evse_id != 0) {
+                if (!it->evseIds.has_value()) {
+                    it->evseIds.emplace();
+                }
+                it->evseIds->push_back(evse_id);
+            }
+        };
+
+        // Tariffs on EVSE 0 apply to every EVSE, so they are always reported
+        for (const auto& [evse_id, tariffs] : this->default_tariffs) {
+            if (call.msg.evseId == 0 or evse_id == 0 or evse_id == call.msg.evseId) {
+                for (const auto& tariff : tariffs) {
+                    add_assignment(tariff, TariffKindEnum::DefaultTariff, evse_id);
+                }
+            }
+        }
+        for (const auto& [evse_id, transaction_tariff] : this->transaction_tariffs) {
+            if ((call.msg.evseId == 0 or evse_id == call.msg.evseId) and
+                transaction_tariff.tariff_kind == TariffKindEnum::DriverTariff and
+                transaction_tariff.calculator.has_value()) {
+                add_assignment(transaction_tariff.calculator->get_tariff(), TariffKindEnum::DriverTariff, evse_id);
+            }
+        }
+
+        if (assignments.empty()) {
+            response.status = TariffGetStatusEnum::NoTariff;
+        } else {
+            response.tariffAssignments = std::move(assignments);
+        }
+    }
+
+    const ocpp::CallResult<v21::GetTariffsResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+void TariffAndCost::handle_clear_tariffs_req(const Call<v21::ClearTariffsRequest> call) {
+    v21::ClearTariffsResponse response;
+
+    if (!this->is_tariff_enabled()) {
+        ClearTariffsResult result;
+        result.status = TariffClearStatusEnum::Rejected;
+        result.statusInfo = StatusInfo();
+        result.statusInfo->reasonCode = "NotEnabled";
+        response.clearTariffsResult.push_back(result);
+    } else {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        const auto& tariff_ids = call.msg.tariffIds;
+        // Only default tariffs are cleared, the tariff of a running transaction stays until it ends
+        std::vector<CiString<60>> cleared;
+        try {
+            for (auto& [evse_id, tariffs] : this->default_tariffs) {
+                if (call.msg.evseId.has_value() and call.msg.evseId.value() != evse_id) {
+                    continue;
+                }
+                for (auto it = tariffs.begin(); it != tariffs.end();) {
+                    if (tariff_ids.has_value() and std::find(tariff_ids->begin(), tariff_ids->end(), it->tariffId) ==
+                                                       tariff_ids->end()) {
+                        ++it;
+                        continue;
+                    }
+                    this->context.database_handler.delete_default_tariff(evse_id, it->tariffId.get());
+                    if (std::find(cleared.begin(), cleared.end(), it->tariffId) == cleared.end()) {
+                        cleared.push_back(it->tariffId);
+                    }
+                    it = tariffs.erase(it);
+                }
+            }
+        } catch (const everest::db::QueryExecutionException& e) {
+            EVLOG_error << "Could not delete default tariff: " << e.what();
+        }
+
+        if (tariff_ids.has_value()) {
+            for (const auto& tariff_id : tariff_ids.value()) {
+                ClearTariffsResult result;
+                result.tariffId = tariff_id;
+                result.status = std::find(cleared.begin(), cleared.end(), tariff_id) != cleared.end()
+                                    ? TariffClearStatusEnum::Accepted
+                                    : TariffClearStatusEnum::NoTariff;
+                response.clearTariffsResult.push_back(result);
+            }
+        } else if (cleared.empty()) {
+            ClearTariffsResult result;
+            result.status = TariffClearStatusEnum::NoTariff;
+            response.clearTariffsResult.push_back(result);
+        } else {
+            for (const auto& tariff_id : cleared) {
+                ClearTariffsResult result;
+                result.tariffId = tariff_id;
+                result.status = TariffClearStatusEnum::Accepted;
+                response.clearTariffsResult.push_back(result);
+            }
+        }
+    }
+
+    const ocpp::CallResult<v21::ClearTariffsResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+void TariffAndCost::handle_change_transaction_tariff_req(const Call<v21::ChangeTransactionTariffRequest> call) {
+    v21::ChangeTransactionTariffResponse response;
+    response.status = TariffChangeStatusEnum::Accepted;
+    const auto& tariff = call.msg.tariff;
+
+    if (!this->is_tariff_enabled()) {
+        response.status = TariffChangeStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "NotEnabled";
+    } else {
+        switch (this->validate_tariff(tariff)) {
+        case TariffSetStatusEnum::TooManyElements:
+            response.status = TariffChangeStatusEnum::TooManyElements;
+            break;
+        case TariffSetStatusEnum::ConditionNotSupported:
+            response.status = TariffChangeStatusEnum::ConditionNotSupported;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (response.status == TariffChangeStatusEnum::Accepted) {
+        const std::lock_guard<std::mutex> lock(this->tariffs_mutex);
+        auto it = std::find_if(this->transaction_tariffs.begin(), this->transaction_tariffs.end(),
+                               [&call](const auto& entry) {
+                                   return entry.second.transaction_id == call.msg.transactionId.get();
+                               });
+        if (it == this->transaction_tariffs.end()) {
+            response.status = TariffChangeStatusEnum::TxNotFound;
+        } else if (it->second.calculator.has_value() and
+                   it->second.calculator->get_tariff().currency != tariff.currency) {
+            response.status = TariffChangeStatusEnum::NoCurrencyChange;
+        } else if (it->second.calculator.has_value()) {
+            it->second.calculator->set_tariff(tariff);
+            it->second.tariff_kind = TariffKindEnum::DriverTariff;
+        } else {
+            // No tariff applied to the transaction so far, the cost is calculated from now on
+            it->second.calculator.emplace(tariff, it->second.last_sample, this->get_utc_offset());
+            it->second.tariff_kind = TariffKindEnum::DriverTariff;
+        }
+    }
+
+    const ocpp::CallResult<v21::ChangeTransactionTariffResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+TariffSetStatusEnum TariffAndCost::validate_tariff(const Tariff& tariff) const {
+    const auto max_elements = this->context.device_model.get_optional_value<int>(
+        ControllerComponentVariables::TariffCostCtrlrMaxElementsTariff);
+    if (max_elements.has_value() and max_elements.value() >= 0 and
+        get_number_of_tariff_elements(tariff) > static_cast<std::size_t>(max_elements.value())) {
+        return TariffSetStatusEnum::TooManyElements;
+    }
+    if (!is_tariff_supported(tariff)) {
+        return TariffSetStatusEnum::ConditionNotSupported;
+    }
+    return TariffSetStatusEnum::Accepted;
+}
+
+std::optional<Tariff> TariffAndCost::get_default_tariff(const std::int32_t evse_id, const DateTime& timestamp) const {
+    for (const auto id : {evse_id, 0}) {
+        const auto it = this->default_tariffs.find(id);
+        if (it == this->default_tariffs.end()) {
+            continue;
+        }
+
+        const Tariff* selected = nullptr;
+        for (const auto& tariff : it->second) {
+            if (tariff.validFrom.has_value() and tariff.validFrom.value() > timestamp) {
+                continue;
+            }
+            // A tariff without validFrom is valid since forever, so it is replaced by any tariff with validFrom
+            if (selected == nullptr or
+                (tariff.validFrom.has_value() and
+                 (!selected->validFrom.has_value() or tariff.validFrom.value() > selected->validFrom.value()))) {
+                selected = &tariff;
+            }
+        }
+        if (selected != nullptr) {
+            return *selected;
+        }
+    }
+    return std::nullopt;
+}
+
+RunningCost TariffAndCost::create_running_cost(const TransactionTariff& transaction_tariff,
+                                               const RunningCostState state) const {
+    const auto& calculator = transaction_tariff.calculator.value();
+    const auto& sample = calculator.get_last_sample();
+
+    RunningCost running_cost;
+    running_cost.transaction_id = transaction_tariff.transaction_id;
+    running_cost.timestamp = sample.timestamp;
+    running_cost.state = state;
+    running_cost.cost = calculator.get_cost().incl_tax;
+    if (sample.energy_wh.has_value()) {
+        running_cost.meter_value = static_cast<std::int32_t>(sample.energy_wh.value());
+    }
+    running_cost.charging_price = calculator.get_current_charging_price();
+    running_cost.idle_price = calculator.get_current_idle_price();
+    return running_cost;
+}
+
+void TariffAndCost::report_running_cost(const RunningCost& running_cost, const std::optional<std::string>& currency) {
+    if (this->set_running_cost_callback.has_value()) {
+        this->set_running_cost_callback.value()(running_cost, this->get_number_of_decimals(), currency);
+    }
+}
+
+bool TariffAndCost::is_charging(const std::int32_t evse_id) {
+    if (!this->context.evse_manager.does_evse_exist(evse_id)) {
+        return false;
+    }
+    auto& evse = this->context.evse_manager.get_evse(evse_id);
+    if (!evse.has_active_transaction()) {
+        // The transaction is not open yet when it is started, so the EV is expected to charge
+        return true;
+    }
+    return evse.get_transaction()->chargingState == ChargingStateEnum::Charging;
+}
+
+std::chrono::minutes TariffAndCost::get_utc_offset() const {
+    const auto time_offset =
+        this->context.device_model.get_optional_value<std::string>(ControllerComponentVariables::TimeOffset);
+    return time_offset.has_value() ? parse_time_offset(time_offset.value()) : std::chrono::minutes(0);
+}
+
+void TariffAndCost::update_cost_config() {
+    this->cost_enabled =
+        this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::TariffCostCtrlrAvailableCost)
+            .value_or(false) and
+        this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::TariffCostCtrlrEnabledCost)
+            .value_or(false);
+
+    const int decimals =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::NumberOfDecimalsForCostValues)
+            .value_or(DEFAULT_PRICE_NUMBER_OF_DECIMALS);
+    this->number_of_decimals = decimals < 0 ? DEFAULT_PRICE_NUMBER_OF_DECIMALS : static_cast<std::uint32_t>(decimals);
+}
+
+std::uint32_t TariffAndCost::get_number_of_decimals() const {
+    return this->number_of_decimals;
+}
+
 bool TariffAndCost::is_multilanguage_enabled() const {
     return this->context.device_model
         .get_optional_value<bool>(ControllerComponentVariables::CustomImplementationMultiLanguageEnabled)
@@ -272,10 +740,6 @@ bool TariffAndCost::is_tariff_enabled() const {
 }
 
 bool TariffAndCost::is_cost_enabled() const {
-    return this->context.device_model
-               .get_optional_value<bool>(ControllerComponentVariables::TariffCostCtrlrAvailableCost)
-               .value_or(false) and
-           this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::TariffCostCtrlrEnabledCost)
-               .value_or(false);
+    return this->cost_enabled;
 }
 } // namespace ocpp::v2
@@ -4,10 +4,12 @@
 #include <ocpp/v2/functional_blocks/transaction.hpp>
 
 #include <ocpp/v2/connectivity_manager.hpp>
+#include <ocpp/v2/constants.hpp>
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/device_model.hpp>
 #include <ocpp/v2/evse_manager.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v2/tx_ended_meter_values.hpp>
 #include <ocpp/v2/utils.hpp>
 
 #include <ocpp/v2/functional_blocks/authorization.hpp>
@@ -19,6 +21,14 @@
 #include <ocpp/v2/messages/TransactionEvent.hpp>
 
 namespace ocpp::v2 {
+
+namespace {
+// Part of the message size that is reserved for the TransactionEvent(Ended) fields besides the metervalues
+constexpr std::int32_t TX_ENDED_MESSAGE_RESERVE = 2048;
+// Downsampling interval used first if neither SampledDataTxEndedInterval nor AlignedDataTxEndedInterval is set
+constexpr std::chrono::seconds DEFAULT_TX_ENDED_DOWNSAMPLING_INTERVAL{60};
+} // namespace
+
 TransactionBlock::TransactionBlock(
     const FunctionalBlockContext& functional_block_context, MessageQueue<v2::MessageType>& message_queue,
     AuthorizationInterface& authorization, AvailabilityInterface& availability, SmartChargingInterface& smart_charging,
@@ -40,7 +50,7 @@ TransactionBlock::TransactionBlock(
 }
 
 void TransactionBlock::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::TransactionEventResponse) {
         this->handle_transaction_event_response(message);
@@ -67,6 +77,9 @@ void TransactionBlock::on_transaction_started(const std::int32_t evse_id, const
         meter_start, utils::get_measurands_vec(this->context.device_model.get_value<std::string>(
                          ControllerComponentVariables::SampledDataTxStartedMeasurands)));
 
+    // Relative charging profiles start with the transaction, so the limits of the evse may have changed
+    this->smart_charging.on_transaction_changed(evse_id);
+
     const auto& enhanced_transaction = evse_handle.get_transaction();
     Transaction transaction{enhanced_transaction->transactionId};
     transaction.chargingState = charging_state;
@@ -106,17 +119,31 @@ void TransactionBlock::on_transaction_finished(const std::int32_t evse_id, const
 
     std::optional<std::vector<ocpp::v2::MeterValue>> meter_values = std::nullopt;
     try {
-        meter_values = std::make_optional(utils::get_meter_values_with_measurands_applied(
-            this->context.database_handler.transaction_metervalues_get_all(enhanced_transaction->transactionId.get()),
-            utils::get_measurands_vec(this->context.device_model.get_value<std::string>(
-                ControllerComponentVariables::SampledDataTxEndedMeasurands)),
-            utils::get_measurands_vec(this->context.device_model.get_value<std::string>(
-                ControllerComponentVariables::AlignedDataTxEndedMeasurands)),
-            timestamp,
+        const auto sampled_measurands = utils::get_measurands_vec(this->context.device_model.get_value<std::string>(
+            ControllerComponentVariables::SampledDataTxEndedMeasurands));
+        const auto aligned_measurands = utils::get_measurands_vec(this->context.device_model.get_value<std::string>(
+            ControllerComponentVariables::AlignedDataTxEndedMeasurands));
+        const auto sampled_sign_readings =
             this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::SampledDataSignReadings)
-                .value_or(false),
+                .value_or(false);
+        const auto aligned_sign_readings =
             this->context.device_model.get_optional_value<bool>(ControllerComponentVariables::AlignedDataSignReadings)
-                .value_or(false)));
+                .value_or(false);
+
+        // The metervalues are read one by one, so they never have to be in memory all at once. If they do not fit in
+        // the message they are downsampled
+        TxEndedMeterValues tx_ended_meter_values{this->get_tx_ended_meter_values_max_bytes(),
+                                                 this->get_tx_ended_downsampling_interval()};
+        this->context.database_handler.transaction_metervalues_for_each(
+            enhanced_transaction->transactionId.get(), [&](MeterValue&& meter_value) {
+                auto tx_ended_meter_value =
+                    utils::get_tx_ended_meter_value(meter_value, sampled_measurands, aligned_measurands, timestamp,
+                                                    sampled_sign_readings, aligned_sign_readings);
+                if (tx_ended_meter_value.has_value()) {
+                    tx_ended_meter_values.add(std::move(tx_ended_meter_value.value()));
+                }
+            });
+        meter_values = tx_ended_meter_values.take();
 
         if (meter_values.value().empty()) {
             meter_values.reset();
@@ -137,6 +164,8 @@ void TransactionBlock::on_transaction_finished(const std::int32_t evse_id, const
     // K02.FR.05 The transaction is over, so delete the TxProfiles associated with the transaction.
     smart_charging.delete_transaction_tx_profiles(enhanced_transaction->get_transaction().transactionId);
     evse_handle.release_transaction();
+    // The TxProfiles are deleted and relative charging profiles do not refer to the transaction anymore
+    smart_charging.on_transaction_changed(evse_id);
 
     bool send_reset = false;
     if (this->reset_scheduled) {
@@ -264,16 +293,36 @@ void TransactionBlock::schedule_reset(const std::optional<std::int32_t> reset_sc
     }
 }
 
+std::size_t TransactionBlock::get_tx_ended_meter_values_max_bytes() {
+    const auto max_message_size =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::MaxMessageSize)
+            .value_or(DEFAULT_MAX_MESSAGE_SIZE);
+    return static_cast<std::size_t>(std::max(max_message_size - TX_ENDED_MESSAGE_RESERVE, 1));
+}
+
+std::chrono::seconds TransactionBlock::get_tx_ended_downsampling_interval() {
+    const auto interval = std::max(
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::SampledDataTxEndedInterval)
+            .value_or(0),
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::AlignedDataTxEndedInterval)
+            .value_or(0));
+    if (interval <= 0) {
+        return DEFAULT_TX_ENDED_DOWNSAMPLING_INTERVAL;
+    }
+    return std::chrono::seconds(interval);
+}
+
 void TransactionBlock::handle_transaction_event_response(const EnhancedMessage<MessageType>& message) {
-    const CallResult<TransactionEventResponse> call_result = message.message;
-    const Call<TransactionEventRequest>& original_call = message.call_message;
+    const CallResult<TransactionEventResponse> call_result = *message.message;
+    const Call<TransactionEventRequest> original_call = *message.call_message;
     const auto& original_msg = original_call.msg;
 
     if (this->transaction_event_response_callback.has_value()) {
         this->transaction_event_response_callback.value()(original_msg, call_result.msg);
     }
 
-    this->tariff_and_cost.handle_cost_and_tariff(call_result.msg, original_msg, message.message[CALLRESULT_PAYLOAD]);
+    this->tariff_and_cost.handle_cost_and_tariff(call_result.msg, original_msg,
+                                                 message.message->at(CALLRESULT_PAYLOAD));
 
     if (original_msg.eventType == TransactionEventEnum::Ended) {
         // nothing to do for TransactionEventEnum::Ended
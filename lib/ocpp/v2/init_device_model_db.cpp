@@ -3,11 +3,18 @@
 
 #include <ocpp/v2/init_device_model_db.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <map>
+#include <memory>
+#include <sstream>
 #include <string>
 
+#include <openssl/evp.h>
+
 #include <everest/logging.hpp>
 #include <ocpp/v2/enums.hpp>
 
@@ -24,7 +31,6 @@ namespace {
 void check_integrity(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs);
 std::vector<std::string> check_integrity_value_type(const DeviceModelVariable& variable);
 bool value_is_of_type(const std::string& value, const DataEnum& type);
-bool is_same_component_key(const ComponentKey& component_key1, const ComponentKey& component_key2);
 bool is_same_attribute_type(const VariableAttribute attribute1, const VariableAttribute& attribute2);
 bool is_attribute_different(const VariableAttribute& attribute1, const VariableAttribute& attribute2);
 bool variable_has_same_attributes(const std::vector<DbVariableAttribute>& attributes1,
@@ -79,6 +85,27 @@ void InitDeviceModelDb::initialize_database(
     bool delete_db_if_exists = true) {
     execute_init_sql(delete_db_if_exists);
 
+    // The given component configs can not be related to config files, so any stored fingerprint is outdated.
+    apply_component_configs(component_configs, std::nullopt);
+}
+
+bool InitDeviceModelDb::initialize_database(const std::filesystem::path& config_path,
+                                            const bool delete_db_if_exists) {
+    execute_init_sql(delete_db_if_exists);
+
+    const std::string fingerprint = get_component_config_fingerprint(config_path);
+    if (this->database_exists && get_component_config_fingerprint_from_db() == fingerprint) {
+        EVLOG_info << "Component config is unchanged, skipping device model database initialization";
+        return false;
+    }
+
+    apply_component_configs(get_all_component_configs(config_path), fingerprint);
+    return true;
+}
+
+void InitDeviceModelDb::apply_component_configs(
+    const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_configs,
+    const std::optional<std::string>& fingerprint) {
     // Get existing components from the database.
     std::map<ComponentKey, std::vector<DeviceModelVariable>> existing_components;
     if (this->database_exists) {
@@ -97,9 +124,51 @@ void InitDeviceModelDb::initialize_database(
     // few milliseconds if it is done inside a transaction).
     std::unique_ptr<TransactionInterface> transaction = database->begin_transaction();
     insert_components(component_configs, existing_components);
+    set_component_config_fingerprint_in_db(fingerprint);
     transaction->commit();
 }
 
+std::optional<std::string> InitDeviceModelDb::get_component_config_fingerprint_from_db() {
+    static const std::string select_fingerprint_statement =
+        "SELECT FINGERPRINT FROM COMPONENT_CONFIG_FINGERPRINT WHERE ID = 1";
+
+    std::unique_ptr<StatementInterface> select_statement;
+    try {
+        select_statement = this->database->new_statement(select_fingerprint_statement);
+    } catch (const QueryExecutionException&) {
+        throw InitDeviceModelDbError("Could not create statement " + select_fingerprint_statement);
+    }
+
+    if (select_statement->step() != SQLITE_ROW) {
+        return std::nullopt;
+    }
+
+    return select_statement->column_text(0);
+}
+
+void InitDeviceModelDb::set_component_config_fingerprint_in_db(const std::optional<std::string>& fingerprint) {
+    const std::string statement =
+        fingerprint.has_value()
+            ? "INSERT OR REPLACE INTO COMPONENT_CONFIG_FINGERPRINT (ID, FINGERPRINT) VALUES (1, @fingerprint)"
+            : "DELETE FROM COMPONENT_CONFIG_FINGERPRINT";
+
+    std::unique_ptr<StatementInterface> fingerprint_statement;
+    try {
+        fingerprint_statement = this->database->new_statement(statement);
+    } catch (const QueryExecutionException&) {
+        throw InitDeviceModelDbError("Could not create statement " + statement);
+    }
+
+    if (fingerprint.has_value()) {
+        fingerprint_statement->bind_text("@fingerprint", fingerprint.value(), SQLiteString::Transient);
+    }
+
+    if (fingerprint_statement->step() != SQLITE_DONE) {
+        throw InitDeviceModelDbError("Could not store component config fingerprint: " +
+                                     std::string(this->database->get_error_message()));
+    }
+}
+
 void InitDeviceModelDb::execute_init_sql(const bool delete_db_if_exists) {
     if (delete_db_if_exists) {
         if (std::filesystem::exists(database_path)) {
@@ -188,8 +257,65 @@ read_component_config(const std::vector<std::filesystem::path>& components_confi
     return components;
 }
 
+///
+/// \brief Adds the relative path and the contents of the given component config files to the digest.
+///
+void add_component_config_files_to_digest(EVP_MD_CTX* context, const std::string& relative_dir,
+                                          std::vector<std::filesystem::path> component_config_files) {
+    // Directory iteration order is unspecified
+    std::sort(component_config_files.begin(), component_config_files.end());
+
+    for (const auto& path : component_config_files) {
+        std::ifstream config_file(path, std::ios::binary);
+        if (!config_file) {
+            throw InitDeviceModelDbError("Could not read component config file " + path.string());
+        }
+        const std::string contents{std::istreambuf_iterator<char>(config_file), std::istreambuf_iterator<char>()};
+
+        // Prefix every file with its name and size so that moving content between files changes the fingerprint.
+        const std::string header =
+            relative_dir + "/" + path.filename().string() + '\0' + std::to_string(contents.size()) + '\0';
+        EVP_DigestUpdate(context, header.data(), header.size());
+        EVP_DigestUpdate(context, contents.data(), contents.size());
+    }
+}
+
 } // namespace
 
+std::string get_component_config_fingerprint(const std::filesystem::path& directory) {
+    const auto standardized_dir = directory / STANDARDIZED_COMPONENT_CONFIG_DIR;
+    const auto custom_dir = directory / CUSTOM_COMPONENT_CONFIG_DIR;
+
+    const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    if (context == nullptr or EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != 1) {
+        throw InitDeviceModelDbError("Could not initialize digest for the component config fingerprint");
+    }
+
+    // The database schema version is part of the fingerprint, so the component config is applied again after a
+    // migration of the device model database.
+    const std::string schema_version = std::to_string(MIGRATION_DEVICE_MODEL_FILE_VERSION_V2);
+    EVP_DigestUpdate(context.get(), schema_version.data(), schema_version.size());
+
+    add_component_config_files_to_digest(context.get(), STANDARDIZED_COMPONENT_CONFIG_DIR,
+                                         get_component_config_from_directory(standardized_dir));
+    if (std::filesystem::exists(custom_dir)) {
+        add_component_config_files_to_digest(context.get(), CUSTOM_COMPONENT_CONFIG_DIR,
+                                             get_component_config_from_directory(custom_dir));
+    }
+
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+    unsigned int digest_size = 0;
+    if (EVP_DigestFinal_ex(context.get(), digest.data(), &digest_size) != 1) {
+        throw InitDeviceModelDbError("Could not calculate the component config fingerprint");
+    }
+
+    std::ostringstream fingerprint;
+    for (unsigned int i = 0; i < digest_size; ++i) {
+        fingerprint << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest.at(i));
+    }
+    return fingerprint.str();
+}
+
 std::map<ComponentKey, std::vector<DeviceModelVariable>>
 get_all_component_configs(const std::filesystem::path& directory) {
 
@@ -860,7 +986,12 @@ std::map<ComponentKey, std::vector<DeviceModelVariable>> InitDeviceModelDb::get_
         throw InitDeviceModelDbError("Could not create statement " + statement);
     }
 
+    // All monitors are read with a single query instead of one query per variable
+    std::map<std::uint64_t, std::vector<VariableMonitoringMeta>> monitors = get_all_variable_monitors_from_db();
+
     std::map<ComponentKey, std::vector<DeviceModelVariable>> components;
+    // Position of every variable in the variable vector of its component, by variable id
+    std::map<std::int64_t, std::size_t> variable_indices;
 
     int status = SQLITE_ERROR;
     while ((status = select_statement->step()) == SQLITE_ROW) {
@@ -876,30 +1007,17 @@ std::map<ComponentKey, std::vector<DeviceModelVariable>> InitDeviceModelDb::get_
             component_key.connector_id = select_statement->column_int(4);
         }
 
-        bool variable_exists = false;
-        DeviceModelVariable new_variable;
-        new_variable.db_id = select_statement->column_int(5);
-        new_variable.name = select_statement->column_text(6);
-        new_variable.instance = select_statement->column_text_nullable(7);
-
-        DeviceModelVariable* variable = nullptr;
-        // Check if the variable is already added to the component. If it is, the attribute should be added to the
-        // vector of attributes, otherwise the whole variable must be added to the variable vector of the component.
-        const auto& it = components.find(component_key);
-        if (it != components.end()) {
-            // Component found. Now search for variables.
-            std::vector<DeviceModelVariable>& variables = it->second;
-            for (DeviceModelVariable& v : variables) {
-                if (is_same_variable(v, new_variable)) {
-                    // Variable found as well. Set variable pointer to the found variable.
-                    variable = &v;
-                    variable_exists = true;
-                }
-            }
-        }
-
-        if (!variable_exists) {
-            // Variable does not exist, add extra information from database.
+        std::vector<DeviceModelVariable>& variables = components[component_key];
+        const std::int64_t variable_id = select_statement->column_int(5);
+
+        // Every attribute of a variable is a separate row. Only the first row of a variable adds the variable itself,
+        // the following rows only add their attribute to it.
+        const auto variable_index = variable_indices.find(variable_id);
+        if (variable_index == variable_indices.end()) {
+            DeviceModelVariable new_variable;
+            new_variable.db_id = variable_id;
+            new_variable.name = select_statement->column_text(6);
+            new_variable.instance = select_statement->column_text_nullable(7);
             new_variable.variable_characteristics_db_id = select_statement->column_int(8);
             new_variable.characteristics.dataType = static_cast<DataEnum>(select_statement->column_int(9));
             if (select_statement->column_type(10) != SQLITE_NULL) {
@@ -912,10 +1030,25 @@ std::map<ComponentKey, std::vector<DeviceModelVariable>> InitDeviceModelDb::get_
             new_variable.characteristics.unit = select_statement->column_text_nullable(13);
             new_variable.characteristics.valuesList = select_statement->column_text_nullable(14);
 
-            // Variable is new, set variable pointer to this new variable.
-            variable = &new_variable;
+            if (select_statement->column_type(22) != SQLITE_NULL) {
+                try {
+                    new_variable.source = select_statement->column_text(22);
+                } catch (const std::out_of_range& e) {
+                    EVLOG_error << e.what() << ": Variable Source will not be set (so default will be used)";
+                }
+            }
+
+            const auto variable_monitors = monitors.find(static_cast<std::uint64_t>(variable_id));
+            if (variable_monitors != monitors.end()) {
+                new_variable.monitors = std::move(variable_monitors->second);
+            }
+
+            variable_indices.emplace(variable_id, variables.size());
+            variables.push_back(std::move(new_variable));
         }
 
+        DeviceModelVariable& variable = variables.at(variable_indices.at(variable_id));
+
         DbVariableAttribute attribute;
         attribute.db_id = select_statement->column_int(15);
         if (select_statement->column_type(16) != SQLITE_NULL) {
@@ -933,37 +1066,7 @@ std::map<ComponentKey, std::vector<DeviceModelVariable>> InitDeviceModelDb::get_
         attribute.variable_attribute.value = select_statement->column_text_nullable(20);
         attribute.value_source = select_statement->column_text_nullable(21);
 
-        if (select_statement->column_type(22) != SQLITE_NULL) {
-            try {
-                variable->source = select_statement->column_text(22);
-            } catch (const std::out_of_range& e) {
-                EVLOG_error << e.what() << ": Variable Source will not be set (so default will be used)";
-            }
-        }
-
-        variable->attributes.push_back(attribute);
-
-        // Query all monitors
-        if (variable->db_id.has_value()) {
-            auto monitors = get_variable_monitors_from_db(variable->db_id.value());
-
-            for (auto& monitor_meta : monitors) {
-                // If monitor is not already contained in the list
-                const bool contained =
-                    std::find_if(std::begin(variable->monitors), std::end(variable->monitors),
-                                 [&monitor_meta](const auto& contained_monitor) {
-                                     return (contained_monitor.monitor.id == monitor_meta.monitor.id);
-                                 }) != std::end(variable->monitors);
-
-                if (!contained) {
-                    variable->monitors.push_back(std::move(monitor_meta));
-                }
-            }
-        }
-
-        if (!variable_exists) {
-            components[component_key].push_back(*variable);
-        }
+        variable.attributes.push_back(attribute);
     }
 
     if (status != SQLITE_DONE) {
@@ -978,10 +1081,10 @@ namespace {
 std::optional<std::pair<ComponentKey, std::vector<DeviceModelVariable>>>
 component_exists_in_db(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& db_components,
                        const ComponentKey& component) {
-    for (const auto& db_component : db_components) {
-        if (is_same_component_key(db_component.first, component)) {
-            return db_component;
-        }
+    // The map is ordered by the same fields that make up a component key
+    const auto it = db_components.find(component);
+    if (it != db_components.end()) {
+        return *it;
     }
 
     return std::nullopt;
@@ -989,13 +1092,7 @@ component_exists_in_db(const std::map<ComponentKey, std::vector<DeviceModelVaria
 
 bool component_exists_in_config(const std::map<ComponentKey, std::vector<DeviceModelVariable>>& component_config,
                                 const ComponentKey& component) {
-    for (const auto& component_in_config : component_config) {
-        if (is_same_component_key(component, component_in_config.first)) {
-            return true;
-        }
-    }
-
-    return false;
+    return component_config.find(component) != component_config.end();
 }
 } // namespace
 
@@ -1121,16 +1218,14 @@ std::vector<DbVariableAttribute> InitDeviceModelDb::get_variable_attributes_from
     return attributes;
 }
 
-std::vector<VariableMonitoringMeta> InitDeviceModelDb::get_variable_monitors_from_db(const std::uint64_t& variable_id) {
-    std::vector<VariableMonitoringMeta> monitors{};
+std::map<std::uint64_t, std::vector<VariableMonitoringMeta>> InitDeviceModelDb::get_all_variable_monitors_from_db() {
+    std::map<std::uint64_t, std::vector<VariableMonitoringMeta>> monitors;
 
-    const std::string select_query =
-        "SELECT vm.TYPE_ID, vm.ID, vm.SEVERITY, vm.'TRANSACTION', vm.VALUE, vm.CONFIG_TYPE_ID, vm.REFERENCE_VALUE "
-        "FROM VARIABLE_MONITORING vm "
-        "WHERE vm.VARIABLE_ID = @variable_id";
+    const std::string select_query = "SELECT vm.TYPE_ID, vm.ID, vm.SEVERITY, vm.'TRANSACTION', vm.VALUE, "
+                                     "vm.CONFIG_TYPE_ID, vm.REFERENCE_VALUE, vm.VARIABLE_ID "
+                                     "FROM VARIABLE_MONITORING vm";
 
     auto select_stmt = this->database->new_statement(select_query);
-    select_stmt->bind_int(1, clamp_to<int>(variable_id));
 
     int status = SQLITE_ERROR;
     while ((status = select_stmt->step()) == SQLITE_ROW) {
@@ -1158,7 +1253,7 @@ std::vector<VariableMonitoringMeta> InitDeviceModelDb::get_variable_monitors_fro
         monitor_meta.reference_value = reference_value;
         monitor_meta.type = type;
 
-        monitors.push_back(monitor_meta);
+        monitors[static_cast<std::uint64_t>(select_stmt->column_int(7))].push_back(monitor_meta);
     }
 
     if (status != SQLITE_DONE) {
@@ -1383,23 +1478,6 @@ bool value_is_of_type(const std::string& value, const DataEnum& type) {
  * the database).
  */
 
-///
-/// \brief Check if the component keys are the same given their unique properties (name, evse id, connector id and
-///        instance)
-/// \param component_key1   Component key 1
-/// \param component_key2   Component key 2
-/// \return True if those are the same components.
-///
-bool is_same_component_key(const ComponentKey& component_key1, const ComponentKey& component_key2) {
-    if ((component_key1.name == component_key2.name) && (component_key1.evse_id == component_key2.evse_id) &&
-        (component_key1.connector_id == component_key2.connector_id) &&
-        (component_key1.instance == component_key2.instance)) {
-        return true;
-    }
-
-    return false;
-}
-
 ///
 /// \brief Check if the two given attributes are the same  given their unique properties (type)
 /// \param attribute1   Attribute 1
@@ -3,7 +3,9 @@
 
 #include <ocpp/v2/monitoring_updater.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 
 #include <ocpp/v2/ctrlr_component_variables.hpp>
 #include <ocpp/v2/device_model.hpp>
@@ -65,27 +67,30 @@ bool is_monitor_active(MonitoringBaseEnum active_monitoring_base, const Variable
     return true;
 }
 
+std::chrono::seconds get_monitor_interval(float monitor_value) {
+    // Guard against a zero interval that would make the monitor due all the time
+    return std::max(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::duration<float>(monitor_value)),
+                    std::chrono::seconds(1));
+}
+
 std::chrono::time_point<std::chrono::system_clock> get_next_clock_aligned_point(float monitor_interval) {
-    auto monitor_seconds =
-        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::duration<float>(monitor_interval));
+    auto monitor_seconds = get_monitor_interval(monitor_interval);
 
     auto sys_time_now = std::chrono::system_clock::now();
     auto hours_now = std::chrono::floor<std::chrono::hours>(sys_time_now);
     auto seconds_now = std::chrono::duration_cast<std::chrono::seconds>(sys_time_now - hours_now);
 
-    // Round next seconds, for ex at an interval of 900 while we are at second 2700 will yield
-    // the result is 3600, and that is a roll-over, we will call the next monitor at the precise hour
-    auto next_seconds =
-        (std::ceil((double)seconds_now.count() / (double)monitor_seconds.count()) * monitor_seconds).count();
+    // Next multiple strictly after now, for ex at an interval of 900 while we are at second 2700 will yield
+    // 3600, and that is a roll-over, we will call the next monitor at the precise hour
+    auto next_seconds = (seconds_now / monitor_seconds + 1) * monitor_seconds;
 
     std::chrono::time_point<std::chrono::system_clock> aligned_timepoint;
 
-    if (next_seconds >= static_cast<decltype(next_seconds)>(3600)) {
+    if (next_seconds >= std::chrono::hours(1)) {
         // If we rolled over, move to the next hour
         aligned_timepoint = (hours_now + std::chrono::hours(1));
     } else {
-        aligned_timepoint = (hours_now + std::chrono::duration_cast<std::chrono::seconds>(
-                                             std::chrono::duration<decltype(next_seconds)>(next_seconds)));
+        aligned_timepoint = (hours_now + next_seconds);
     }
 
     auto dbg_time_now = std::chrono::system_clock::to_time_t(sys_time_now);
@@ -135,9 +140,11 @@ EventData create_notify_event(std::int32_t unique_id, const std::string& reporte
 } // namespace
 
 MonitoringUpdater::MonitoringUpdater(DeviceModel& device_model, notify_events notify_csms_events,
-                                     is_offline is_chargepoint_offline) :
+                                     is_offline is_chargepoint_offline, std::shared_ptr<Executor> executor) :
     device_model(device_model),
-    monitors_timer([this]() { this->process_monitors_internal(true, true); }),
+    executor(executor != nullptr ? executor : Executor::get_default()),
+    monitors_timer(&this->executor->get_io_context(), [this]() { this->on_monitors_timer(); }),
+    is_started(false),
     unique_id(0),
     notify_csms_events(std::move(notify_csms_events)),
     is_chargepoint_offline(std::move(is_chargepoint_offline)) {
@@ -145,7 +152,8 @@ MonitoringUpdater::MonitoringUpdater(DeviceModel& device_model, notify_events no
 
 MonitoringUpdater::~MonitoringUpdater() {
     try {
-        stop_monitoring();
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed
+        this->executor->run_and_wait([this]() { this->stop_monitoring(); });
     } catch (...) {
         EVLOG_error << "Exception during dtor call of stop monitoring";
         return;
@@ -162,6 +170,8 @@ void MonitoringUpdater::start_monitoring() {
                                   value_current);
     };
     device_model.register_variable_listener(std::move(fn));
+    device_model.register_variables_listener(
+        [this](const std::vector<VariableChange>& changes) { this->on_variables_changed(changes); });
 
     auto fn_monitor = [this](const VariableMonitoringMeta& updated_monitor, const Component& component,
                              const Variable& variable, const VariableCharacteristics& characteristics,
@@ -170,31 +180,69 @@ void MonitoringUpdater::start_monitoring() {
     };
     device_model.register_monitor_listener(std::move(fn_monitor));
 
-    // No point in starting the monitor if this variable does not exist. It will never start to exist later on.
-    if (this->device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringCtrlrEnabled)
-            .value_or(false)) {
-        const int process_interval_seconds =
-            this->device_model.get_optional_value<int>(ControllerComponentVariables::MonitorsProcessingInterval)
-                .value_or(1);
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+    this->is_started = true;
+    update_monitoring_config_internal();
 
-        EVLOG_info << "Started monitoring timer with interval: " << process_interval_seconds;
-        monitors_timer.interval(std::chrono::seconds(process_interval_seconds));
+    // No point in scheduling the monitors if this variable does not exist, the schedule is started when
+    // monitoring is enabled later on
+    if (this->monitoring_config.enabled) {
+        update_periodic_monitors_internal();
+        EVLOG_info << "Started monitoring with " << this->periodic_monitors_meta.size() << " periodic monitors";
     } else {
         EVLOG_warning << "Attempted to start monitoring without 'MonitoringCtrlrEnabled'";
     }
+    schedule_next_processing();
 }
 
 void MonitoringUpdater::stop_monitoring() {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+    this->is_started = false;
     monitors_timer.stop();
 }
 
 void MonitoringUpdater::process_triggered_monitors() {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
     this->process_monitors_internal(false, true);
+    schedule_next_processing();
+}
+
+void MonitoringUpdater::update_periodic_monitors() {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+    update_periodic_monitors_internal();
+    schedule_next_processing();
+}
+
+void MonitoringUpdater::update_monitoring_config() {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+    const bool was_enabled = this->monitoring_config.enabled;
+    update_monitoring_config_internal();
+    if (!was_enabled and this->monitoring_config.enabled) {
+        update_periodic_monitors_internal();
+    }
+    schedule_next_processing();
+}
+
+void MonitoringUpdater::on_monitors_timer() {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+    this->process_monitors_internal(true, true);
+    schedule_next_processing();
 }
 
 void MonitoringUpdater::on_monitor_updated(const VariableMonitoringMeta& updated_monitor, const Component& component,
                                            const Variable& variable, const VariableCharacteristics& characteristics,
                                            const VariableAttribute& attribute, const std::string& current_value) {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+
+    auto periodic_it = periodic_monitors_meta.find(updated_monitor.monitor.id);
+    if (periodic_it != std::end(periodic_monitors_meta)) {
+        // The interval might have changed, reschedule based on the new monitor data
+        periodic_it->second.monitor_meta = updated_monitor;
+        schedule_periodic_monitor(periodic_it->second);
+        schedule_next_processing();
+        return;
+    }
+
     auto it = updater_monitors_meta.find(updated_monitor.monitor.id);
 
     // Not contained, ignored
@@ -357,35 +405,61 @@ void MonitoringUpdater::on_variable_changed(const std::unordered_map<std::int64_
                                             const VariableCharacteristics& characteristics,
                                             const VariableAttribute& attribute, const std::string& value_previous,
                                             const std::string& value_current) {
-    EVLOG_debug << "Variable: " << variable.name.get() << " changed value from: [" << value_previous << "] to: ["
-                << value_current << "]";
+    this->on_variables_changed(
+        {{monitors, component, variable, characteristics, attribute, value_previous, value_current}});
+}
 
-    // Ignore non-actual values
-    if (attribute.type.has_value() && attribute.type.value() != AttributeEnum::Actual) {
-        return;
+void MonitoringUpdater::on_variables_changed(const std::vector<VariableChange>& changes) {
+    const std::lock_guard<std::recursive_mutex> lock(this->monitors_mutex);
+
+    const bool had_pending_triggers = has_pending_triggers_internal();
+
+    for (const auto& change : changes) {
+        EVLOG_debug << "Variable: " << change.variable.name.get() << " changed value from: [" << change.value_previous
+                    << "] to: [" << change.value_current << "]";
+
+        // Ignore non-actual values
+        if (change.attribute.type.has_value() && change.attribute.type.value() != AttributeEnum::Actual) {
+            continue;
+        }
+
+        // Iterate monitors and search for a triggered monitor
+        for (const auto& [monitor_id, monitor_meta] : change.monitors) {
+            // Evaluate the monitor
+            evaluate_monitor(monitor_meta, change.component, change.variable, change.characteristics,
+                             change.attribute, change.value_previous, change.value_current);
+        }
     }
 
-    // Iterate monitors and search for a triggered monitor
-    for (const auto& [monitor_id, monitor_meta] : monitors) {
-        // Evaluate the monitor
-        evaluate_monitor(monitor_meta, component, variable, characteristics, attribute, value_previous, value_current);
+    // If triggers were already pending the timer is already running with the processing interval,
+    // rescheduling it on every change would delay their processing
+    if (!had_pending_triggers and has_pending_triggers_internal()) {
+        schedule_next_processing();
     }
 }
 
 void MonitoringUpdater::update_periodic_monitors_internal() {
     // Update the list of periodic monitors
     auto periodic_monitors = this->device_model.get_periodic_monitors();
+    std::set<std::int32_t> periodic_monitor_ids;
 
     for (auto& component_variable_monitors : periodic_monitors) {
         for (auto& periodic_monitor_meta : component_variable_monitors.monitors) {
+            periodic_monitor_ids.insert(periodic_monitor_meta.monitor.id);
+
             // See if we already have the local monitor
-            auto it = this->updater_monitors_meta.find(periodic_monitor_meta.monitor.id);
+            auto it = this->periodic_monitors_meta.find(periodic_monitor_meta.monitor.id);
 
-            if (it != std::end(this->updater_monitors_meta)) {
+            if (it != std::end(this->periodic_monitors_meta)) {
                 // If we already contain it inside, skip
                 continue;
             }
 
+            if (periodic_monitor_meta.monitor.type != MonitorEnum::Periodic and
+                periodic_monitor_meta.monitor.type != MonitorEnum::PeriodicClockAligned) {
+                EVLOG_AND_THROW(std::runtime_error("Invalid type in periodic monitor list, should never happen!"));
+            }
+
             // If it is not found, add a new entry to our managed monitor list
             UpdaterMonitorMeta periodic_meta;
 
@@ -396,126 +470,118 @@ void MonitoringUpdater::update_periodic_monitors_internal() {
             periodic_meta.monitor_meta = periodic_monitor_meta;
             periodic_meta.is_writeonly = 0;
 
-            if (periodic_monitor_meta.monitor.type == MonitorEnum::Periodic) {
-                // Set the trigger to the current time
-                periodic_meta.meta_periodic.last_trigger_steady = std::chrono::steady_clock::now();
-            } else if (periodic_monitor_meta.monitor.type == MonitorEnum::PeriodicClockAligned) {
-                // Snap to the closest monitor multiple
-                periodic_meta.meta_periodic.next_trigger_clock_aligned =
-                    get_next_clock_aligned_point(periodic_meta.monitor_meta.monitor.value);
-                EVLOG_debug << "First aligned timepoint for monitor ID: " << periodic_monitor_meta.monitor.id;
-            } else {
-                EVLOG_AND_THROW(std::runtime_error("Invalid type in periodic monitor list, should never happen!"));
-            }
-
-            auto res = this->updater_monitors_meta.insert(
+            auto res = this->periodic_monitors_meta.insert(
                 std::pair{periodic_monitor_meta.monitor.id, std::move(periodic_meta)});
 
             if (!res.second) {
                 EVLOG_warning << "Could not insert periodic monitor to internal monitor map!";
                 continue;
             }
+
+            schedule_periodic_monitor(res.first->second);
         }
     }
 
-    // Remove the monitors in our list that don't exist any more in the database
-    for (auto it = std::begin(updater_monitors_meta); it != std::end(updater_monitors_meta);) {
-        std::int32_t updater_meta_id = it->first;
-        auto updater_meta_data = it->second;
-
-        // Ignore triggers
-        if (updater_meta_data.type == UpdateMonitorMetaType::TRIGGER) {
+    // Remove the monitors in our list that don't exist any more in the database, their
+    // entries in the schedule are skipped when they are due
+    for (auto it = std::begin(periodic_monitors_meta); it != std::end(periodic_monitors_meta);) {
+        if (periodic_monitor_ids.count(it->first) == 0) {
+            periodic_monitors_with_pending_events.erase(it->first);
+            it = periodic_monitors_meta.erase(it);
+        } else {
             ++it;
-            continue;
         }
+    }
+}
 
-        const bool found_in_new_periodics =
-            std::find_if(std::begin(periodic_monitors), std::end(periodic_monitors),
-                         [&updater_meta_id](const auto& periodic_monitor) {
-                             const auto& monitors = periodic_monitor.monitors;
+void MonitoringUpdater::schedule_periodic_monitor(UpdaterMonitorMeta& periodic_meta) {
+    const auto& monitor = periodic_meta.monitor_meta.monitor;
+    const auto now_steady = std::chrono::steady_clock::now();
+
+    if (monitor.type == MonitorEnum::PeriodicClockAligned) {
+        // 3.55
+        // PeriodicClockAligned Triggers an event notice every monitorValue
+        // seconds interval, starting from the nearest clock-aligned interval
+        // after this monitor was set. For example, a monitorValue of 900 will
+        // trigger event notices at 0, 15, 30 and 45 minutes after the hour, every hour.
+        const auto next_clock_aligned = get_next_clock_aligned_point(monitor.value);
+        periodic_meta.meta_periodic.next_trigger_steady =
+            now_steady + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             next_clock_aligned - std::chrono::system_clock::now());
+    } else {
+        periodic_meta.meta_periodic.next_trigger_steady = now_steady + get_monitor_interval(monitor.value);
+    }
 
-                             return std::find_if(std::begin(monitors), std::end(monitors),
-                                                 [&updater_meta_id](const auto& monitor_meta) {
-                                                     return (updater_meta_id == monitor_meta.monitor.id);
-                                                 }) != std::end(monitors);
-                         }) != std::end(periodic_monitors);
+    this->periodic_schedule.push({periodic_meta.meta_periodic.next_trigger_steady, periodic_meta.monitor_id});
+}
 
-        // If not found, erse from our list as not being relevant
-        if (!found_in_new_periodics) {
-            it = updater_monitors_meta.erase(it);
-        } else {
-            ++it;
+bool MonitoringUpdater::has_pending_triggers_internal() const {
+    return std::any_of(std::begin(updater_monitors_meta), std::end(updater_monitors_meta), [](const auto& entry) {
+        return entry.second.meta_trigger.is_event_generated == 0 or !entry.second.generated_monitor_events.empty();
+    });
+}
+
+void MonitoringUpdater::schedule_next_processing() {
+    if (!this->is_started or !this->monitoring_config.enabled) {
+        monitors_timer.stop();
+        return;
+    }
+
+    // Drop the entries of removed or rescheduled monitors so that we don't wake up for them
+    while (!this->periodic_schedule.empty()) {
+        const auto& top = this->periodic_schedule.top();
+        const auto it = this->periodic_monitors_meta.find(top.monitor_id);
+        if (it != std::end(this->periodic_monitors_meta) and
+            it->second.meta_periodic.next_trigger_steady == top.due) {
+            break;
         }
+        this->periodic_schedule.pop();
     }
-}
 
-void MonitoringUpdater::process_monitor_meta_internal(UpdaterMonitorMeta& updater_meta_data) {
-    const auto& monitor_meta = updater_meta_data.monitor_meta;
-    const auto& monitor = monitor_meta.monitor;
+    const auto now = std::chrono::steady_clock::now();
+    std::optional<std::chrono::time_point<std::chrono::steady_clock>> next_processing;
 
-    // Process if it is a periodic
-    if (updater_meta_data.type == UpdateMonitorMetaType::PERIODIC) {
-        // Monitor seconds interval
-        auto monitor_seconds =
-            std::chrono::duration_cast<std::chrono::seconds>(std::chrono::duration<float>(monitor.value));
+    if (!this->periodic_schedule.empty()) {
+        next_processing = this->periodic_schedule.top().due;
+    }
 
-        // If we match the trigger time
-        bool matches_time = false;
+    // Triggers and events that could not be processed or sent yet are retried after the processing interval
+    if (has_pending_triggers_internal() or !this->periodic_monitors_with_pending_events.empty()) {
+        const auto retry = now + this->monitoring_config.processing_interval;
+        if (!next_processing.has_value() or retry < next_processing.value()) {
+            next_processing = retry;
+        }
+    }
 
-        if (monitor.type == MonitorEnum::Periodic) {
-            auto current_time = std::chrono::steady_clock::now();
-            auto delta = current_time - updater_meta_data.meta_periodic.last_trigger_steady;
+    if (!next_processing.has_value()) {
+        monitors_timer.stop();
+        return;
+    }
 
-            if (delta > monitor_seconds) {
-                // Update last time
-                updater_meta_data.meta_periodic.last_trigger_steady = current_time;
-                matches_time = true;
-            }
-        } else if (monitor.type == MonitorEnum::PeriodicClockAligned) {
-            // 3.55
-            // PeriodicClockAligned Triggers an event notice every monitorValue
-            // seconds interval, starting from the nearest clock-aligned interval
-            // after this monitor was set. For example, a monitorValue of 900 will
-            // trigger event notices at 0, 15, 30 and 45 minutes after the hour, every hour.
-            auto current_time = std::chrono::system_clock::now();
-
-            if (current_time > updater_meta_data.meta_periodic.next_trigger_clock_aligned) {
-                auto distance = std::chrono::duration_cast<std::chrono::seconds>(
-                                    current_time - updater_meta_data.meta_periodic.next_trigger_clock_aligned)
-                                    .count();
-
-                // Handles with: N08.FR.03, events should be queued and
-                // send when the charger is back online
-                if (distance > static_cast<decltype(distance)>(60)) {
-                    EVLOG_warning << "Missed scheduled monitor time by: " << distance;
-                }
-                matches_time = true;
-                EVLOG_debug << "Reporting periodic monitor with id: " << monitor.id;
+    monitors_timer.timeout(std::max(
+        std::chrono::duration_cast<std::chrono::milliseconds>(next_processing.value() - now),
+        std::chrono::milliseconds(0)));
+}
 
-                updater_meta_data.meta_periodic.next_trigger_clock_aligned =
-                    get_next_clock_aligned_point(monitor.value);
-            }
-        } else {
-            // Should never happen
-            EVLOG_AND_THROW(std::runtime_error(std::string("Invalid monitor type from: 'get_periodic_monitors': ") +
-                                               conversions::monitor_enum_to_string(monitor.type)));
-        }
+void MonitoringUpdater::process_monitor_meta_internal(UpdaterMonitorMeta& updater_meta_data) {
+    const auto& monitor_meta = updater_meta_data.monitor_meta;
+    const auto& monitor = monitor_meta.monitor;
 
-        if (matches_time) {
-            RequiredComponentVariable comp_var;
-            comp_var.component = updater_meta_data.component;
-            comp_var.variable = updater_meta_data.variable;
+    // Process if it is a periodic, it is only passed here when it is due
+    if (updater_meta_data.type == UpdateMonitorMetaType::PERIODIC) {
+        RequiredComponentVariable comp_var;
+        comp_var.component = updater_meta_data.component;
+        comp_var.variable = updater_meta_data.variable;
 
-            // This operation can cause a small stall, but only if this is triggered
-            const auto current_value = this->device_model.get_value<std::string>(comp_var);
+        // This operation can cause a small stall, but only if this is triggered
+        const auto current_value = this->device_model.get_value<std::string>(comp_var);
 
-            EventData notify_event =
-                std::move(create_notify_event(this->unique_id++, current_value, updater_meta_data.component,
-                                              updater_meta_data.variable, monitor_meta));
+        EventData notify_event = std::move(create_notify_event(this->unique_id++, current_value,
+                                                               updater_meta_data.component,
+                                                               updater_meta_data.variable, monitor_meta));
 
-            // Generate one event that will either be sent now, or later based on the offline state
-            updater_meta_data.generated_monitor_events.push_back(std::move(notify_event));
-        }
+        // Generate one event that will either be sent now, or later based on the offline state
+        updater_meta_data.generated_monitor_events.push_back(std::move(notify_event));
     } else if (updater_meta_data.type == UpdateMonitorMetaType::TRIGGER) {
         // If we did not generate an event for this trigger, create the notify event
         if (updater_meta_data.meta_trigger.is_event_generated == 0) {
@@ -580,66 +646,105 @@ bool should_remove_monitor_meta_internal(const UpdaterMonitorMeta& updater_meta_
 } // namespace
 
 void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool allow_trigger) {
-    if (!is_monitoring_enabled()) {
+    if (!this->monitoring_config.enabled) {
         return;
     }
 
-    bool is_offline = true;
-    int offline_severity = MonitoringLevelSeverity::Danger;
-    int active_monitoring_level = MonitoringLevelSeverity::MAX;
-    MonitoringBaseEnum active_monitoring_base = MonitoringBaseEnum::All;
+    const bool is_offline = is_chargepoint_offline();
 
-    get_monitoring_info(is_offline, offline_severity, active_monitoring_level, active_monitoring_base);
+    // All the events of this pass are handed over at once, so that they can be sent in as few messages as possible
+    std::vector<EventData> outgoing_events;
 
     EVLOG_debug << "Processing internal monitors with periodics: " << allow_periodics
                 << " and triggers: " << allow_trigger;
 
     if (allow_periodics) {
-        // Rebuild the periodic monitor information
-        update_periodic_monitors_internal();
-    }
+        const auto now = std::chrono::steady_clock::now();
 
-    // Iterate all internal monitors and process them
-    for (auto it = std::begin(updater_monitors_meta); it != std::end(updater_monitors_meta);) {
-        auto& updater_monitor_meta = it->second;
-        const auto& meta_monitor_id = it->first;
-        const auto& monitor_meta = updater_monitor_meta.monitor_meta;
+        // Only visit the periodic monitors that are due
+        while (!this->periodic_schedule.empty() and this->periodic_schedule.top().due <= now) {
+            const auto scheduled = this->periodic_schedule.top();
+            this->periodic_schedule.pop();
 
-        if (((allow_periodics == false) && (updater_monitor_meta.type == UpdateMonitorMetaType::PERIODIC)) ||
-            ((allow_trigger == false) && (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER))) {
-            continue;
-        }
+            auto it = this->periodic_monitors_meta.find(scheduled.monitor_id);
 
-        bool should_process = true;
+            // Skip the entries of monitors that were removed or rescheduled in the meantime
+            if (it == std::end(this->periodic_monitors_meta) or
+                it->second.meta_periodic.next_trigger_steady != scheduled.due) {
+                continue;
+            }
 
-        // Skip non-active monitors
-        if (!is_monitor_active(active_monitoring_base, monitor_meta)) {
-            should_process = false;
-        }
+            auto& periodic_meta = it->second;
+            schedule_periodic_monitor(periodic_meta);
 
-        if (is_offline) {
-            // If we are offline, just discard triggers that have a severity > than 'offline_severity'
-            if (it->second.monitor_meta.monitor.severity > offline_severity) {
-                should_process = false;
+            const auto missed_by = std::chrono::duration_cast<std::chrono::seconds>(now - scheduled.due).count();
+            if (missed_by > static_cast<decltype(missed_by)>(60)) {
+                EVLOG_warning << "Missed scheduled monitor time by: " << missed_by;
             }
-        } else {
-            // If we are online, discard the triggers that have a severity > than 'active_monitoring_level'
-            if (it->second.monitor_meta.monitor.severity > active_monitoring_level) {
-                should_process = false;
+
+            if (!should_process_monitor_meta_internal(periodic_meta, is_offline)) {
+                EVLOG_debug << "Monitor: " << periodic_meta.monitor_meta.monitor << " processed: false";
+                continue;
             }
+
+            EVLOG_debug << "Reporting periodic monitor with id: " << periodic_meta.monitor_id;
+
+            // Handles with: N08.FR.03, events should be queued and
+            // send when the charger is back online
+            process_monitor_meta_internal(periodic_meta);
+            this->periodic_monitors_with_pending_events.insert(periodic_meta.monitor_id);
         }
 
-        EVLOG_debug << "Monitor: " << updater_monitor_meta.monitor_meta.monitor << " processed: " << should_process;
+        // Send the events of all periodic monitors that have some pending
+        for (auto id_it = std::begin(this->periodic_monitors_with_pending_events);
+             id_it != std::end(this->periodic_monitors_with_pending_events);) {
+            auto it = this->periodic_monitors_meta.find(*id_it);
+            if (it == std::end(this->periodic_monitors_meta)) {
+                id_it = this->periodic_monitors_with_pending_events.erase(id_it);
+                continue;
+            }
 
-        if (!should_process) {
-            if (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER) {
-                // The triggers that are not active, should simply pe discarded
-                it = updater_monitors_meta.erase(it);
-            } else if (updater_monitor_meta.type == UpdateMonitorMetaType::PERIODIC) {
+            auto& periodic_meta = it->second;
+            if (!should_process_monitor_meta_internal(periodic_meta, is_offline)) {
                 // Just clear the events, since we don't require them cached
-                updater_monitor_meta.generated_monitor_events.clear();
+                periodic_meta.generated_monitor_events.clear();
+            } else if (!is_offline) {
+                send_generated_events_internal(periodic_meta, outgoing_events);
+            } else {
+                // If we are offline but we passed the 'should_process' test, it means that
+                // we should keep the generated events and send them at a further occasion
+                EVLOG_debug << "We are offline, cached generated events for later!";
+            }
+
+            if (periodic_meta.generated_monitor_events.empty()) {
+                id_it = this->periodic_monitors_with_pending_events.erase(id_it);
+            } else {
+                ++id_it;
             }
+        }
+    }
+
+    if (allow_trigger) {
+        process_triggered_monitors_internal(is_offline, outgoing_events);
+    }
 
+    if (!outgoing_events.empty()) {
+        notify_csms_events(outgoing_events);
+    }
+}
+
+void MonitoringUpdater::process_triggered_monitors_internal(bool is_offline, std::vector<EventData>& outgoing_events) {
+    // Iterate all triggered monitors and process them
+    for (auto it = std::begin(updater_monitors_meta); it != std::end(updater_monitors_meta);) {
+        auto& updater_monitor_meta = it->second;
+
+        const bool should_process = should_process_monitor_meta_internal(updater_monitor_meta, is_offline);
+
+        EVLOG_debug << "Monitor: " << updater_monitor_meta.monitor_meta.monitor << " processed: " << should_process;
+
+        if (!should_process) {
+            // The triggers that are not active, should simply pe discarded
+            it = updater_monitors_meta.erase(it);
             continue;
         }
 
@@ -648,26 +753,7 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
 
         // If we are not offline, send the queued events generated by this meta
         if (!is_offline) {
-            if (!updater_monitor_meta.generated_monitor_events.empty()) {
-                EVLOG_debug << "Sent data for monitor: " << updater_monitor_meta.monitor_meta.monitor;
-
-                // Send the events
-                notify_csms_events(updater_monitor_meta.generated_monitor_events);
-                updater_monitor_meta.generated_monitor_events.clear();
-
-                if (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER) {
-                    // If we have a trigger mark the events as being sent
-                    // for the curent state
-                    updater_monitor_meta.meta_trigger.is_csms_sent = true;
-
-                    // If this was a state trigger, them also mark that
-                    // we sent this 'dangerous' state to the CSMS at least once
-                    // since in that case the clear logic changes
-                    if (updater_monitor_meta.meta_trigger.is_cleared == 0) {
-                        updater_monitor_meta.meta_trigger.is_csms_sent_triggered = true;
-                    }
-                }
-            }
+            send_generated_events_internal(updater_monitor_meta, outgoing_events);
         } else {
             // If we are offline but we passed the 'should_process' test, it means that
             // we should keep the generated events and send them at a further occasion
@@ -682,23 +768,62 @@ void MonitoringUpdater::process_monitors_internal(bool allow_periodics, bool all
     }
 }
 
-bool MonitoringUpdater::is_monitoring_enabled() {
-    return this->device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringCtrlrEnabled)
-        .value_or(false);
+bool MonitoringUpdater::should_process_monitor_meta_internal(const UpdaterMonitorMeta& updater_meta_data,
+                                                             bool is_offline) const {
+    const auto& monitor_meta = updater_meta_data.monitor_meta;
+
+    // Skip non-active monitors
+    if (!is_monitor_active(this->monitoring_config.active_monitoring_base, monitor_meta)) {
+        return false;
+    }
+
+    if (is_offline) {
+        // If we are offline, just discard triggers that have a severity > than 'offline_severity'
+        return monitor_meta.monitor.severity <= this->monitoring_config.offline_severity;
+    }
+
+    // If we are online, discard the triggers that have a severity > than 'active_monitoring_level'
+    return monitor_meta.monitor.severity <= this->monitoring_config.active_monitoring_level;
+}
+
+void MonitoringUpdater::send_generated_events_internal(UpdaterMonitorMeta& updater_monitor_meta,
+                                                       std::vector<EventData>& outgoing_events) {
+    if (updater_monitor_meta.generated_monitor_events.empty()) {
+        return;
+    }
+
+    EVLOG_debug << "Sent data for monitor: " << updater_monitor_meta.monitor_meta.monitor;
+
+    // Queue the events for sending
+    std::move(std::begin(updater_monitor_meta.generated_monitor_events),
+              std::end(updater_monitor_meta.generated_monitor_events), std::back_inserter(outgoing_events));
+    updater_monitor_meta.generated_monitor_events.clear();
+
+    if (updater_monitor_meta.type == UpdateMonitorMetaType::TRIGGER) {
+        // If we have a trigger mark the events as being sent
+        // for the curent state
+        updater_monitor_meta.meta_trigger.is_csms_sent = true;
+
+        // If this was a state trigger, them also mark that
+        // we sent this 'dangerous' state to the CSMS at least once
+        // since in that case the clear logic changes
+        if (updater_monitor_meta.meta_trigger.is_cleared == 0) {
+            updater_monitor_meta.meta_trigger.is_csms_sent_triggered = true;
+        }
+    }
 }
 
-void MonitoringUpdater::get_monitoring_info(bool& out_is_offline, int& out_offline_severity,
-                                            int& out_active_monitoring_level,
-                                            MonitoringBaseEnum& out_active_monitoring_base) {
-    // Persist OfflineMonitoringEventQueuingSeverity even when offline if we have a problem
-    out_is_offline = is_chargepoint_offline();
+void MonitoringUpdater::update_monitoring_config_internal() {
+    this->monitoring_config.enabled =
+        this->device_model.get_optional_value<bool>(ControllerComponentVariables::MonitoringCtrlrEnabled)
+            .value_or(false);
 
     // By default (if the comp is missing we are reporting up to 'Warning')
-    out_offline_severity =
+    this->monitoring_config.offline_severity =
         this->device_model.get_optional_value<int>(ControllerComponentVariables::OfflineQueuingSeverity)
             .value_or(MonitoringLevelSeverity::Warning);
 
-    out_active_monitoring_level =
+    this->monitoring_config.active_monitoring_level =
         this->device_model.get_optional_value<int>(ControllerComponentVariables::ActiveMonitoringLevel)
             .value_or(MonitoringLevelSeverity::MAX);
 
@@ -706,7 +831,14 @@ void MonitoringUpdater::get_monitoring_info(bool& out_is_offline, int& out_offli
         this->device_model.get_optional_value<std::string>(ControllerComponentVariables::ActiveMonitoringBase)
             .value_or(conversions::monitoring_base_enum_to_string(MonitoringBaseEnum::All));
 
-    out_active_monitoring_base = conversions::string_to_monitoring_base_enum(active_monitoring_base_string);
+    this->monitoring_config.active_monitoring_base =
+        conversions::string_to_monitoring_base_enum(active_monitoring_base_string);
+
+    this->monitoring_config.processing_interval = std::max(
+        std::chrono::seconds(
+            this->device_model.get_optional_value<int>(ControllerComponentVariables::MonitorsProcessingInterval)
+                .value_or(1)),
+        std::chrono::seconds(1));
 }
 
 } // namespace ocpp::v2
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/notify_event_batcher.hpp>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/common/call_types.hpp>
+
+namespace ocpp::v2 {
+
+namespace {
+const std::string MESSAGE_TYPE = conversions::messagetype_to_string(MessageType::NotifyEvent);
+
+// Size of a message id as generated by create_message_id (uuid)
+constexpr std::size_t MESSAGE_ID_SIZE = 36;
+} // namespace
+
+NotifyEventBatcher::NotifyEventBatcher(std::size_t max_items_per_message, std::size_t max_bytes_per_message) :
+    max_items_per_message(max_items_per_message), max_bytes_per_message(max_bytes_per_message), pending_bytes(0) {
+}
+
+void NotifyEventBatcher::set_limits(std::size_t max_items_per_message, std::size_t max_bytes_per_message) {
+    this->max_items_per_message = max_items_per_message;
+    this->max_bytes_per_message = max_bytes_per_message;
+}
+
+bool NotifyEventBatcher::add(const std::vector<EventData>& events) {
+    for (const auto& event : events) {
+        // The event is added to the eventData array, preceded by a separating comma
+        const auto size = json(event).dump().size() + 1;
+        this->pending_events.push_back(event);
+        this->pending_event_sizes.push_back(size);
+        this->pending_bytes += size;
+    }
+
+    if (this->max_items_per_message > 0 and this->pending_events.size() >= this->max_items_per_message) {
+        return true;
+    }
+
+    return this->max_bytes_per_message > 0 and
+           this->pending_bytes + get_skeleton_size(DateTime(), 0) >= this->max_bytes_per_message;
+}
+
+bool NotifyEventBatcher::empty() const {
+    return this->pending_events.empty();
+}
+
+std::vector<NotifyEventRequest> NotifyEventBatcher::take_requests() {
+    std::vector<NotifyEventRequest> requests;
+
+    if (this->pending_events.empty()) {
+        return requests;
+    }
+
+    const DateTime generated_at;
+    std::size_t index = 0;
+
+    while (index < this->pending_events.size()) {
+        NotifyEventRequest req;
+        req.generatedAt = generated_at;
+        req.seqNo = static_cast<std::int32_t>(requests.size());
+
+        std::size_t size = get_skeleton_size(generated_at, req.seqNo);
+
+        // Every request contains at least one event, even if that single event exceeds the byte limit
+        do {
+            size += this->pending_event_sizes[index];
+            req.eventData.push_back(std::move(this->pending_events[index]));
+            ++index;
+        } while (index < this->pending_events.size() and
+                 (this->max_items_per_message == 0 or req.eventData.size() < this->max_items_per_message) and
+                 (this->max_bytes_per_message == 0 or
+                  size + this->pending_event_sizes[index] <= this->max_bytes_per_message));
+
+        req.tbc = index < this->pending_events.size();
+        requests.push_back(std::move(req));
+    }
+
+    if (requests.size() > 1) {
+        EVLOG_debug << "Combined " << this->pending_events.size() << " events into " << requests.size()
+                    << " NotifyEventRequests";
+    }
+
+    this->pending_events.clear();
+    this->pending_event_sizes.clear();
+    this->pending_bytes = 0;
+
+    return requests;
+}
+
+std::size_t NotifyEventBatcher::get_skeleton_size(const DateTime& generated_at, std::int32_t seq_no) {
+    NotifyEventRequest req;
+    req.generatedAt = generated_at;
+    req.seqNo = seq_no;
+    req.tbc = false;
+
+    // Skeleton json sizeof( [MessageTypeId::CALL, "<message_id>", "NotifyEvent", {<json of request with an empty
+    // eventData array>}] )
+    return json{MessageTypeId::CALL, std::string(MESSAGE_ID_SIZE, ' '), MESSAGE_TYPE, req}.dump().size();
+}
+
+} // namespace ocpp::v2
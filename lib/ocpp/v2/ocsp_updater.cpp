@@ -1,11 +1,18 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2023 Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <thread>
 
 #include <everest/logging.hpp>
+#include <openssl/evp.h>
+#include <openssl/ocsp.h>
 
 #include <ocpp/v2/charge_point.hpp>
 #include <ocpp/v2/messages/GetCertificateStatus.hpp>
@@ -14,12 +21,102 @@
 
 namespace ocpp::v2 {
 
+namespace {
+// Returns the key of the certificate of ocsp_request in certificate_update_deadlines
+std::string get_certificate_key(const ocpp::OCSPRequestData& ocsp_request) {
+    return ocpp::conversions::hash_algorithm_enum_type_to_string(ocsp_request.hashAlgorithm) + ":" +
+           ocsp_request.issuerNameHash + ":" + ocsp_request.issuerKeyHash + ":" + ocsp_request.serialNumber;
+}
+
+std::string get_certificate_key(const ocpp::CertificateHashDataType& hash_data) {
+    return ocpp::conversions::hash_algorithm_enum_type_to_string(hash_data.hashAlgorithm) + ":" +
+           hash_data.issuerNameHash.get() + ":" + hash_data.issuerKeyHash.get() + ":" + hash_data.serialNumber.get();
+}
+
+// Parses the DER encoded OCSP response of data, which may also be base64 encoded. Returns nullptr if it can not be
+// parsed
+std::unique_ptr<OCSP_RESPONSE, decltype(&OCSP_RESPONSE_free)> decode_ocsp_response(const std::string& data) {
+    std::vector<unsigned char> der((data.size() / 4 + 1) * 3);
+    const auto decoded_size = EVP_DecodeBlock(der.data(), reinterpret_cast<const unsigned char*>(data.data()),
+                                              static_cast<int>(data.size()));
+    if (decoded_size > 0) {
+        // The zero bytes EVP_DecodeBlock decodes from the padding are ignored, since the DER encoding contains its
+        // length
+        const unsigned char* der_ptr = der.data();
+        std::unique_ptr<OCSP_RESPONSE, decltype(&OCSP_RESPONSE_free)> response(
+            d2i_OCSP_RESPONSE(nullptr, &der_ptr, decoded_size), &OCSP_RESPONSE_free);
+        if (response != nullptr) {
+            return response;
+        }
+    }
+
+    const auto* data_ptr = reinterpret_cast<const unsigned char*>(data.data());
+    return {d2i_OCSP_RESPONSE(nullptr, &data_ptr, static_cast<long>(data.size())), &OCSP_RESPONSE_free};
+}
+
+// Validity of an OCSP response relative to now
+struct OcspValidity {
+    // Time since the earliest thisUpdate
+    std::chrono::seconds elapsed{0};
+    // Time until the earliest nextUpdate, std::nullopt if the response has no nextUpdate
+    std::optional<std::chrono::seconds> remaining;
+};
+
+std::chrono::seconds to_seconds(const int days, const int seconds) {
+    return std::chrono::hours(days * 24) + std::chrono::seconds(seconds);
+}
+
+// Returns the validity of the OCSP response ocsp_response, or std::nullopt if it can not be parsed
+std::optional<OcspValidity> get_validity(const std::string& ocsp_response) {
+    const auto response = decode_ocsp_response(ocsp_response);
+    if (response == nullptr or OCSP_response_status(response.get()) != OCSP_RESPONSE_STATUS_SUCCESSFUL) {
+        return std::nullopt;
+    }
+    const std::unique_ptr<OCSP_BASICRESP, decltype(&OCSP_BASICRESP_free)> basic_response(
+        OCSP_response_get1_basic(response.get()), &OCSP_BASICRESP_free);
+    if (basic_response == nullptr) {
+        return std::nullopt;
+    }
+
+    OcspValidity validity;
+    for (int i = 0; i < OCSP_resp_count(basic_response.get()); i++) {
+        ASN1_GENERALIZEDTIME* this_update = nullptr;
+        ASN1_GENERALIZEDTIME* next_update = nullptr;
+        OCSP_single_get0_status(OCSP_resp_get0(basic_response.get(), i), nullptr, nullptr, &this_update,
+                                &next_update);
+        int days = 0;
+        int seconds = 0;
+        if (this_update != nullptr and ASN1_TIME_diff(&days, &seconds, this_update, nullptr) != 0) {
+            validity.elapsed = std::max(validity.elapsed, to_seconds(days, seconds));
+        }
+        if (next_update == nullptr or ASN1_TIME_diff(&days, &seconds, nullptr, next_update) == 0) {
+            continue;
+        }
+        const auto single_remaining = to_seconds(days, seconds);
+        if (!validity.remaining.has_value() or single_remaining < validity.remaining.value()) {
+            validity.remaining = single_remaining;
+        }
+    }
+    return validity;
+}
+
+// Returns the OCSP response cached in ocsp_path, or std::nullopt if it can not be read
+std::optional<std::string> read_cached_ocsp_response(const fs::path& ocsp_path) {
+    std::ifstream file(ocsp_path.string(), std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+} // namespace
+
 OcspUpdater::OcspUpdater(std::shared_ptr<EvseSecurity> evse_security, cert_status_func get_cert_status_from_csms,
                          std::chrono::seconds ocsp_cache_update_interval,
                          std::chrono::seconds ocsp_cache_update_retry_interval) :
     evse_security(std::move(evse_security)),
     get_cert_status_from_csms(std::move(get_cert_status_from_csms)),
     update_deadline(std::chrono::steady_clock::now()),
+    certificate_update_deadlines_seeded(false),
     ocsp_cache_update_interval(ocsp_cache_update_interval),
     ocsp_cache_update_retry_interval(ocsp_cache_update_retry_interval),
     running(false) {
@@ -72,11 +169,9 @@ void OcspUpdater::updater_thread_loop() {
             continue;
         }
 
-        // Perform the OCPP cache update
+        // Perform the OCPP cache update, this sets the deadline of the next update
         try {
             this->execute_ocsp_update();
-            // Successful update, set the deadline at a week from now and go back to sleep
-            this->update_deadline = std::chrono::steady_clock::now() + this->ocsp_cache_update_interval;
         } catch (OcspUpdateFailedException& e) {
             // Unsuccessful update
             if (e.allows_retry()) {
@@ -96,56 +191,169 @@ void OcspUpdater::updater_thread_loop() {
 }
 
 void OcspUpdater::execute_ocsp_update() {
-    auto ocsp_request_list = this->evse_security->get_v2g_ocsp_request_data();
-    std::vector<std::pair<ocpp::CertificateHashDataType, std::string>> ocsp_responses;
+    const auto ocsp_request_list = this->evse_security->get_v2g_ocsp_request_data();
+    const auto now = std::chrono::steady_clock::now();
 
-    EVLOG_info << "libocpp: Updating OCSP cache on " << ocsp_request_list.size() << " certificates";
+    // The deadlines are only kept in memory, so after a restart they are derived from the cached OCSP responses
+    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>> cached_deadlines;
+    if (!this->certificate_update_deadlines_seeded) {
+        cached_deadlines = this->get_cached_certificate_update_deadlines();
+        this->certificate_update_deadlines_seeded = true;
+    }
 
-    for (auto& ocsp_request : ocsp_request_list) {
-        GetCertificateStatusRequest request;
-        switch (ocsp_request.hashAlgorithm) {
-        case HashAlgorithmEnumType::SHA256:
-            request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA256;
-            break;
-        case HashAlgorithmEnumType::SHA384:
-            request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA384;
-            break;
-        case HashAlgorithmEnumType::SHA512:
-            request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA512;
-            break;
-        }
-        request.ocspRequestData.issuerKeyHash = ocsp_request.issuerKeyHash;
-        request.ocspRequestData.issuerNameHash = ocsp_request.issuerNameHash;
-        request.ocspRequestData.serialNumber = ocsp_request.serialNumber;
-        request.ocspRequestData.responderURL = ocsp_request.responderUrl;
-
-        const auto response = this->get_cert_status_from_csms(request);
-
-        if (response.status != GetCertificateStatusEnum::Accepted) {
-            const std::string error_msg = (response.statusInfo.has_value())
-                                              ? response.statusInfo.value().reasonCode.get()
-                                              : "(No status info provided)";
-            throw OcspUpdateFailedException(std::string("CSMS rejected certificate status update: ") + error_msg, true);
+    // Certificates that are no longer installed are dropped, newly installed certificates without a cached OCSP
+    // response are due immediately
+    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>> deadlines;
+    for (const auto& ocsp_request : ocsp_request_list) {
+        const auto key = get_certificate_key(ocsp_request);
+        const auto it = this->certificate_update_deadlines.find(key);
+        const auto cached = cached_deadlines.find(key);
+        if (it != this->certificate_update_deadlines.end()) {
+            deadlines[key] = it->second;
+        } else if (cached != cached_deadlines.end()) {
+            deadlines[key] = cached->second;
+        } else {
+            deadlines[key] = now;
         }
+    }
+    this->certificate_update_deadlines = std::move(deadlines);
+
+    const auto number_of_due_certificates =
+        std::count_if(this->certificate_update_deadlines.begin(), this->certificate_update_deadlines.end(),
+                      [now](const auto& deadline) { return deadline.second <= now; });
+    EVLOG_info << "libocpp: Updating OCSP cache on " << number_of_due_certificates << " of "
+               << this->certificate_update_deadlines.size() << " certificates";
 
-        if (!response.ocspResult.has_value()) {
-            throw OcspUpdateFailedException(
-                std::string("CSMS sent an Accepted GetCertificateStatusResponse with no ocspResult"), true);
+    for (const auto& ocsp_request : ocsp_request_list) {
+        auto& deadline = this->certificate_update_deadlines.at(get_certificate_key(ocsp_request));
+        if (deadline > now) {
+            // Still fresh, or a duplicate of a certificate that was already updated in this run
+            continue;
         }
 
-        ocpp::CertificateHashDataType hash_data;
-        hash_data.hashAlgorithm = ocsp_request.hashAlgorithm;
-        hash_data.issuerNameHash = ocsp_request.issuerNameHash;
-        hash_data.issuerKeyHash = ocsp_request.issuerKeyHash;
-        hash_data.serialNumber = ocsp_request.serialNumber;
-        ocsp_responses.emplace_back(std::pair(hash_data, response.ocspResult.value()));
+        try {
+            const auto ocsp_result = this->request_ocsp_status(ocsp_request);
+
+            ocpp::CertificateHashDataType hash_data;
+            hash_data.hashAlgorithm = ocsp_request.hashAlgorithm;
+            hash_data.issuerNameHash = ocsp_request.issuerNameHash;
+            hash_data.issuerKeyHash = ocsp_request.issuerKeyHash;
+            hash_data.serialNumber = ocsp_request.serialNumber;
+            // Written right away, so it is kept even if the update of a later certificate fails
+            this->evse_security->update_ocsp_cache(hash_data, ocsp_result);
+            deadline = this->get_certificate_update_deadline(ocsp_result);
+        } catch (OcspUpdateFailedException& e) {
+            if (!e.allows_retry()) {
+                throw;
+            }
+            EVLOG_warning << "libocpp: OCSP status update of certificate " << ocsp_request.serialNumber
+                          << " failed: " << e.what() << ", will retry.";
+            deadline = std::chrono::steady_clock::now() + this->ocsp_cache_update_retry_interval;
+        } catch (UnexpectedMessageTypeFromCSMS& e) {
+            EVLOG_warning << "libocpp: " << e.what() << ", will retry.";
+            deadline = std::chrono::steady_clock::now() + this->ocsp_cache_update_retry_interval;
+        }
     }
 
-    for (auto& response : ocsp_responses) {
-        this->evse_security->update_ocsp_cache(response.first, response.second);
+    if (this->certificate_update_deadlines.empty()) {
+        this->update_deadline = std::chrono::steady_clock::now() + this->ocsp_cache_update_interval;
+    } else {
+        const auto earliest =
+            std::min_element(this->certificate_update_deadlines.begin(), this->certificate_update_deadlines.end(),
+                             [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+        this->update_deadline = earliest->second;
     }
 
     EVLOG_info << "libocpp: Done updating OCSP cache";
 }
 
+std::string OcspUpdater::request_ocsp_status(const ocpp::OCSPRequestData& ocsp_request) {
+    GetCertificateStatusRequest request;
+    switch (ocsp_request.hashAlgorithm) {
+    case HashAlgorithmEnumType::SHA256:
+        request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA256;
+        break;
+    case HashAlgorithmEnumType::SHA384:
+        request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA384;
+        break;
+    case HashAlgorithmEnumType::SHA512:
+        request.ocspRequestData.hashAlgorithm = ocpp::v2::HashAlgorithmEnum::SHA512;
+        break;
+    }
+    request.ocspRequestData.issuerKeyHash = ocsp_request.issuerKeyHash;
+    request.ocspRequestData.issuerNameHash = ocsp_request.issuerNameHash;
+    request.ocspRequestData.serialNumber = ocsp_request.serialNumber;
+    request.ocspRequestData.responderURL = ocsp_request.responderUrl;
+
+    const auto response = this->get_cert_status_from_csms(request);
+
+    if (response.status != GetCertificateStatusEnum::Accepted) {
+        const std::string error_msg = (response.statusInfo.has_value()) ? response.statusInfo.value().reasonCode.get()
+                                                                         : "(No status info provided)";
+        throw OcspUpdateFailedException(std::string("CSMS rejected certificate status update: ") + error_msg, true);
+    }
+
+    if (!response.ocspResult.has_value()) {
+        throw OcspUpdateFailedException(
+            std::string("CSMS sent an Accepted GetCertificateStatusResponse with no ocspResult"), true);
+    }
+    return response.ocspResult.value();
+}
+
+std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>>
+OcspUpdater::get_cached_certificate_update_deadlines() {
+    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock>> deadlines;
+    GetCertificateInfoResult result;
+    try {
+        result = this->evse_security->get_leaf_certificate_info(CertificateSigningUseEnum::V2GCertificate, true);
+    } catch (const std::exception& e) {
+        EVLOG_warning << "libocpp: Could not read the cached OCSP responses: " << e.what();
+        return deadlines;
+    }
+    if (result.status != GetCertificateInfoStatus::Accepted or !result.info.has_value()) {
+        return deadlines;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& certificate_ocsp : result.info->ocsp) {
+        if (!certificate_ocsp.ocsp_path.has_value()) {
+            continue;
+        }
+        const auto cached_response = read_cached_ocsp_response(certificate_ocsp.ocsp_path.value());
+        if (!cached_response.has_value()) {
+            continue;
+        }
+        const auto validity = get_validity(cached_response.value());
+        if (!validity.has_value()) {
+            continue;
+        }
+
+        // Like for a status that was just received: halfway through the validity, but at most
+        // ocsp_cache_update_interval after the status was produced
+        auto until_update = this->ocsp_cache_update_interval - validity->elapsed;
+        if (validity->remaining.has_value()) {
+            until_update =
+                std::min(until_update, (validity->elapsed + validity->remaining.value()) / 2 - validity->elapsed);
+        }
+        deadlines[get_certificate_key(certificate_ocsp.hash)] = now + std::max(until_update, std::chrono::seconds(0));
+    }
+    return deadlines;
+}
+
+std::chrono::time_point<std::chrono::steady_clock>
+OcspUpdater::get_certificate_update_deadline(const std::string& ocsp_result) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto validity = get_validity(ocsp_result);
+    if (!validity.has_value() or !validity->remaining.has_value()) {
+        return now + this->ocsp_cache_update_interval;
+    }
+    const auto remaining_validity = validity->remaining.value();
+    if (remaining_validity <= std::chrono::seconds(0)) {
+        // The CSMS sent a status that is already outdated, asking again right away would likely return the same one
+        return now + this->ocsp_cache_update_retry_interval;
+    }
+    // Refresh halfway through the validity, so there is time for retries before the status expires
+    return now + std::min<std::chrono::seconds>(this->ocsp_cache_update_interval, remaining_validity / 2);
+}
+
 } // namespace ocpp::v2
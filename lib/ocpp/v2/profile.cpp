@@ -6,6 +6,9 @@
 #include <ocpp/common/constants.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
 
+#include <functional>
+#include <queue>
+
 using std::chrono::duration_cast;
 using std::chrono::seconds;
 
@@ -485,9 +488,58 @@ IntermediateProfile generate_profile_from_periods(std::vector<period_entry_t>& p
 namespace {
 
 using period_iterator = IntermediateProfile::const_iterator;
-using period_pair_vector = std::vector<std::pair<period_iterator, period_iterator>>;
 using IntermediateProfileRef = std::reference_wrapper<const IntermediateProfile>;
 
+/// \brief Marks an unset number of phases in ActivePeriods
+constexpr std::int32_t NUMBER_PHASES_NOT_SET = std::numeric_limits<std::int32_t>::min();
+
+/// \brief The current period of every profile that is combined. The values used by the reductions over all profiles
+/// are additionally stored as structure of arrays, so these reductions run over contiguous memory. Only the entries of
+/// the profiles that advance to their next period are updated per step.
+struct ActivePeriods {
+    std::vector<const IntermediatePeriod*> periods;
+    std::vector<float> current_limit;        ///< First phase of the current limit
+    std::vector<float> power_limit;          ///< First phase of the power limit
+    std::vector<std::int32_t> number_phases; ///< NUMBER_PHASES_NOT_SET if not set
+    /// \brief Number of periods that use three phase values, see uses_three_phase_values
+    std::size_t three_phase_periods = 0;
+
+    void push_back(const IntermediatePeriod& period) {
+        periods.push_back(&period);
+        current_limit.push_back(period.current_limit.limit);
+        power_limit.push_back(period.power_limit.limit);
+        number_phases.push_back(period.numberPhases.value_or(NUMBER_PHASES_NOT_SET));
+        if (uses_three_phase_values(period)) {
+            three_phase_periods++;
+        }
+    }
+
+    void set(const std::size_t index, const IntermediatePeriod& period) {
+        if (uses_three_phase_values(*periods[index])) {
+            three_phase_periods--;
+        }
+        periods[index] = &period;
+        current_limit[index] = period.current_limit.limit;
+        power_limit[index] = period.power_limit.limit;
+        number_phases[index] = period.numberPhases.value_or(NUMBER_PHASES_NOT_SET);
+        if (uses_three_phase_values(period)) {
+            three_phase_periods++;
+        }
+    }
+
+    /// \brief Highest number of phases of all periods that have one set
+    std::optional<std::int32_t> get_max_number_phases() const {
+        std::int32_t max_phases = NUMBER_PHASES_NOT_SET;
+        for (const auto phases : number_phases) {
+            max_phases = std::max(max_phases, phases);
+        }
+        if (max_phases == NUMBER_PHASES_NOT_SET) {
+            return std::nullopt;
+        }
+        return max_phases;
+    }
+};
+
 inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vector<IntermediateProfile>& profiles) {
     std::vector<IntermediateProfileRef> references{};
     references.reserve(profiles.size());
@@ -497,8 +549,11 @@ inline std::vector<IntermediateProfileRef> convert_to_ref_vector(const std::vect
     return references;
 }
 
+/// \brief Combines the profiles into a single profile by merging the period boundaries of all profiles (k-way merge
+/// using a min heap of the start of the next period of every profile) and calling the \p combinator for every
+/// resulting period
 IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfileRef>& profiles,
-                                             std::function<IntermediatePeriod(const period_pair_vector&)> combinator) {
+                                             const std::function<IntermediatePeriod(const ActivePeriods&)>& combinator) {
     if (profiles.empty()) {
         // We should never get here as there are always profiles, otherwise there is a mistake in the calling
         // function Return an empty profile to be safe
@@ -507,19 +562,29 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
 
     IntermediateProfile combined{};
 
-    period_pair_vector profile_iterators{};
+    std::vector<std::pair<period_iterator, period_iterator>> profile_iterators{};
+    ActivePeriods active_periods{};
     for (const auto& wrapped_profile : profiles) {
         auto& profile = wrapped_profile.get();
         if (!profile.empty()) {
-            profile_iterators.emplace_back(std::make_pair(profile.begin(), profile.end()));
+            profile_iterators.emplace_back(profile.begin(), profile.end());
+            active_periods.push_back(profile.front());
         }
     }
 
-    std::int32_t current_period = 0;
-    while (std::any_of(profile_iterators.begin(), profile_iterators.end(),
-                       [](const std::pair<period_iterator, period_iterator>& it) { return it.first != it.second; })) {
+    // Start of the next period and the index of its profile, earliest first
+    using period_boundary = std::pair<std::int32_t, std::size_t>;
+    std::priority_queue<period_boundary, std::vector<period_boundary>, std::greater<>> next_periods;
+    for (std::size_t i = 0; i < profile_iterators.size(); i++) {
+        const auto next = profile_iterators[i].first + 1;
+        if (next != profile_iterators[i].second) {
+            next_periods.emplace(next->startPeriod, i);
+        }
+    }
 
-        IntermediatePeriod period = combinator(profile_iterators);
+    std::int32_t current_period = 0;
+    while (!profile_iterators.empty()) {
+        IntermediatePeriod period = combinator(active_periods);
         period.startPeriod = current_period;
 
         if (combined.empty() || (period.current_limit != combined.back().current_limit) ||
@@ -532,26 +597,29 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
             combined.push_back(period);
         }
 
-        // Determine the next earliest period
-        std::int32_t next_lowest_period = std::numeric_limits<std::int32_t>::max();
-
-        for (const auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod > current_period && next->startPeriod < next_lowest_period) {
-                next_lowest_period = next->startPeriod;
-            }
+        // A profile whose next period does not start after the current one can not advance anymore
+        while (!next_periods.empty() && next_periods.top().first <= current_period) {
+            next_periods.pop();
         }
 
-        // If there is none, we are done
-        if (next_lowest_period == std::numeric_limits<std::int32_t>::max()) {
+        // If there is no next period, we are done
+        if (next_periods.empty()) {
             break;
         }
 
-        // Otherwise update to next earliest period
-        for (auto& [it, end] : profile_iterators) {
-            auto next = it + 1;
-            if (next != end && next->startPeriod == next_lowest_period) {
-                it++;
+        // Otherwise advance all profiles that have a period starting at the next earliest period
+        const std::int32_t next_lowest_period = next_periods.top().first;
+        while (!next_periods.empty() && next_periods.top().first == next_lowest_period) {
+            const std::size_t index = next_periods.top().second;
+            next_periods.pop();
+
+            auto& [it, end] = profile_iterators[index];
+            it++;
+            active_periods.set(index, *it);
+
+            const auto next = it + 1;
+            if (next != end) {
+                next_periods.emplace(next->startPeriod, index);
             }
         }
         current_period = next_lowest_period;
@@ -568,7 +636,7 @@ IntermediateProfile combine_list_of_profiles(const std::vector<IntermediateProfi
 
 IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateProfile& tx_profile,
                                                              const IntermediateProfile& tx_default_profile) {
-    auto combinator = [](const period_pair_vector& periods) {
+    auto combinator = [](const ActivePeriods& active_periods) {
         const IntermediatePeriod default_period = default_intermediate_period();
         IntermediatePeriod period{};
         period.current_limit = {NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED, NO_LIMIT_SPECIFIED};
@@ -580,7 +648,7 @@ IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateP
         period.current_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
         period.power_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
 
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : active_periods.periods) {
             if (it->current_limit != default_period.current_limit || it->power_limit != default_period.power_limit ||
                 it->current_discharge_limit != default_period.current_discharge_limit ||
                 it->power_discharge_limit != default_period.power_discharge_limit ||
@@ -608,7 +676,7 @@ IntermediateProfile merge_tx_profile_with_tx_default_profile(const IntermediateP
 
 IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<IntermediateProfile>& profiles,
                                                    const OcppProtocolVersion ocpp_version) {
-    auto combinator = [ocpp_version](const period_pair_vector& periods) {
+    auto combinator = [ocpp_version](const ActivePeriods& active_periods) {
         IntermediatePeriod period;
         period.current_limit = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
                                 std::numeric_limits<float>::max()};
@@ -625,7 +693,7 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
 
         bool three_phases_used = false;
         // Get number of phases for this period (the lowest of the number of phases).
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : active_periods.periods) {
             if (!period.numberPhases || (it->numberPhases && it->numberPhases.value() < period.numberPhases.value())) {
                 period.numberPhases = it->numberPhases;
             }
@@ -635,7 +703,7 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
             }
         }
 
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : active_periods.periods) {
             IntermediatePeriod new_period = *it;
             if (three_phases_used) {
                 set_setpoint_limit_phase_values(new_period.current_limit, new_period.power_limit, NO_LIMIT_SPECIFIED,
@@ -690,16 +758,34 @@ IntermediateProfile merge_profiles_by_lowest_limit(const std::vector<Intermediat
 IntermediateProfile merge_profiles_by_summing_limits(const std::vector<IntermediateProfile>& profiles,
                                                      float current_default, float power_default,
                                                      const OcppProtocolVersion ocpp_version) {
-    auto combinator = [current_default, power_default, ocpp_version](const period_pair_vector& periods) {
+    auto combinator = [current_default, power_default, ocpp_version](const ActivePeriods& active_periods) {
         IntermediatePeriod period{};
 
         // summing limits dont have a setpoint, so set to default values
         period.current_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
         period.power_setpoint = {NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED, NO_SETPOINT_SPECIFIED};
 
+        if (ocpp_version != OcppProtocolVersion::v21 || active_periods.three_phase_periods == 0) {
+            // Only the first phase is summed, which only needs the limit columns
+            for (const auto limit : active_periods.current_limit) {
+                period.current_limit.limit += limit >= 0.0F ? limit : current_default;
+            }
+            for (const auto limit : active_periods.power_limit) {
+                period.power_limit.limit += limit >= 0.0F ? limit : power_default;
+            }
+            period.current_limit.limit_L2 = NO_LIMIT_SPECIFIED;
+            period.current_limit.limit_L3 = NO_LIMIT_SPECIFIED;
+            period.power_limit.limit_L2 = NO_LIMIT_SPECIFIED;
+            period.power_limit.limit_L3 = NO_LIMIT_SPECIFIED;
+
+            // Highest number of phases
+            period.numberPhases = active_periods.get_max_number_phases();
+            return period;
+        }
+
         bool three_phases_used = false;
         // Get number of phases for this period (the lowest of the number of phases).
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : active_periods.periods) {
             // Copy number of phases if higher
             if (!period.numberPhases.has_value() ||
                 (it->numberPhases.has_value() && it->numberPhases.value() > period.numberPhases.value())) {
@@ -711,7 +797,7 @@ IntermediateProfile merge_profiles_by_summing_limits(const std::vector<Intermedi
             }
         }
 
-        for (const auto& [it, end] : periods) {
+        for (const auto* it : active_periods.periods) {
             IntermediatePeriod new_period = *it;
             if (three_phases_used) {
                 set_setpoint_limit_phase_values(new_period.current_limit, new_period.power_limit, NO_LIMIT_SPECIFIED,
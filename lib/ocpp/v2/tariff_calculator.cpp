@@ -0,0 +1,446 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/tariff_calculator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+
+#include <everest/logging.hpp>
+
+namespace ocpp::v2 {
+
+namespace {
+constexpr std::int32_t MINUTES_PER_DAY = 24 * 60;
+
+/// \brief Parses a time of day like "08:30" into the number of minutes since midnight
+std::optional<std::int32_t> parse_time_of_day(const std::optional<std::string>& time_of_day) {
+    if (!time_of_day.has_value()) {
+        return std::nullopt;
+    }
+    int hours = 0;
+    int minutes = 0;
+    if (std::sscanf(time_of_day->c_str(), "%d:%d", &hours, &minutes) != 2 or hours < 0 or hours > 24 or
+        minutes < 0 or minutes > 59) {
+        EVLOG_warning << "Ignoring invalid time of day in tariff condition: " << time_of_day.value();
+        return std::nullopt;
+    }
+    return std::min(hours * 60 + minutes, MINUTES_PER_DAY);
+}
+
+/// \brief Parses a date like "2025-01-31"
+std::optional<date::sys_days> parse_date(const std::optional<std::string>& date_string) {
+    if (!date_string.has_value()) {
+        return std::nullopt;
+    }
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (std::sscanf(date_string->c_str(), "%d-%u-%u", &year, &month, &day) != 3) {
+        EVLOG_warning << "Ignoring invalid date in tariff condition: " << date_string.value();
+        return std::nullopt;
+    }
+    const date::year_month_day ymd{date::year{year}, date::month{month}, date::day{day}};
+    if (!ymd.ok()) {
+        EVLOG_warning << "Ignoring invalid date in tariff condition: " << date_string.value();
+        return std::nullopt;
+    }
+    return date::sys_days{ymd};
+}
+
+std::uint8_t to_day_mask(const std::optional<std::vector<DayOfWeekEnum>>& days) {
+    std::uint8_t mask = 0;
+    if (days.has_value()) {
+        for (const auto day : days.value()) {
+            mask |= static_cast<std::uint8_t>(1U << static_cast<unsigned>(day));
+        }
+    }
+    return mask;
+}
+
+/// \brief Checks \p value against an inclusive minimum and an exclusive maximum. A limit that is not set always
+/// matches, a value that is not known only matches if there is no limit
+template <typename T, typename V>
+bool is_in_range(const std::optional<T>& min, const std::optional<T>& max, const std::optional<V>& value) {
+    if (!min.has_value() and !max.has_value()) {
+        return true;
+    }
+    if (!value.has_value()) {
+        return false;
+    }
+    if (min.has_value() and value.value() < static_cast<V>(min.value())) {
+        return false;
+    }
+    if (max.has_value() and value.value() >= static_cast<V>(max.value())) {
+        return false;
+    }
+    return true;
+}
+
+/// \returns the value of \p sampled_value in the base unit (Wh, W or A), taking the unit prefix and multiplier into
+/// account
+double to_base_unit(const SampledValue& sampled_value) {
+    double value = sampled_value.value;
+    if (sampled_value.unitOfMeasure.has_value()) {
+        const auto& unit_of_measure = sampled_value.unitOfMeasure.value();
+        if (unit_of_measure.multiplier.has_value()) {
+            value *= std::pow(10.0, unit_of_measure.multiplier.value());
+        }
+        if (unit_of_measure.unit.has_value() and
+            (unit_of_measure.unit.value() == "kWh" or unit_of_measure.unit.value() == "kW")) {
+            value *= 1000.0;
+        }
+    }
+    return value;
+}
+} // namespace
+
+TariffMeterSample create_tariff_meter_sample(const MeterValue& meter_value, bool charging) {
+    TariffMeterSample sample;
+    sample.timestamp = meter_value.timestamp;
+    sample.charging = charging;
+    for (const auto& sampled_value : meter_value.sampledValue) {
+        const auto measurand = sampled_value.measurand.value_or(MeasurandEnum::Energy_Active_Import_Register);
+        if (measurand == MeasurandEnum::Energy_Active_Import_Register and !sampled_value.phase.has_value()) {
+            sample.energy_wh = to_base_unit(sampled_value);
+        } else if (measurand == MeasurandEnum::Power_Active_Import and !sampled_value.phase.has_value()) {
+            sample.power_w = to_base_unit(sampled_value);
+        } else if (measurand == MeasurandEnum::Current_Import) {
+            const auto current = to_base_unit(sampled_value);
+            if (!sample.current_a.has_value() or sample.current_a.value() < current) {
+                sample.current_a = current;
+            }
+        }
+    }
+    return sample;
+}
+
+std::chrono::minutes parse_time_offset(const std::string& time_offset) {
+    char sign = '+';
+    int hours = 0;
+    int minutes = 0;
+    if (std::sscanf(time_offset.c_str(), "%c%d:%d", &sign, &hours, &minutes) != 3 or (sign != '+' and sign != '-')) {
+        return std::chrono::minutes(0);
+    }
+    const std::chrono::minutes offset(hours * 60 + minutes);
+    return sign == '-' ? -offset : offset;
+}
+
+bool is_tariff_supported(const Tariff& tariff) {
+    if (!tariff.fixedFee.has_value()) {
+        return true;
+    }
+    return std::none_of(tariff.fixedFee->prices.begin(), tariff.fixedFee->prices.end(),
+                        [](const TariffFixedPrice& price) {
+                            return price.conditions.has_value() and (price.conditions->paymentBrand.has_value() or
+                                                                     price.conditions->paymentRecognition.has_value());
+                        });
+}
+
+std::size_t get_number_of_tariff_elements(const Tariff& tariff) {
+    std::size_t number_of_elements = 0;
+    if (tariff.energy.has_value()) {
+        number_of_elements += tariff.energy->prices.size();
+    }
+    for (const auto* time : {&tariff.chargingTime, &tariff.idleTime, &tariff.reservationTime}) {
+        if (time->has_value()) {
+            number_of_elements += time->value().prices.size();
+        }
+    }
+    for (const auto* fixed : {&tariff.fixedFee, &tariff.reservationFixed}) {
+        if (fixed->has_value()) {
+            number_of_elements += fixed->value().prices.size();
+        }
+    }
+    return number_of_elements;
+}
+
+TariffCalculator::TariffCalculator(const Tariff& tariff, const TariffMeterSample& start,
+                                   std::chrono::minutes utc_offset, std::optional<EvseKindEnum> evse_kind) :
+    utc_offset(utc_offset),
+    evse_kind(evse_kind),
+    start(start),
+    last_sample(start),
+    charging_time_s(0.0),
+    idle_time_s(0.0) {
+    this->set_tariff(tariff);
+
+    // The fixed fee is charged once per transaction, with the conditions that apply when it starts
+    const auto* fixed_price = this->find_price(this->fixed_fee, this->get_condition_state(this->start));
+    if (fixed_price != nullptr) {
+        this->add_cost(this->fixed_cost, this->fixed_fee, fixed_price->price);
+    }
+}
+
+void TariffCalculator::set_tariff(const Tariff& tariff) {
+    this->tariff = tariff;
+    this->compile(tariff);
+}
+
+const Tariff& TariffCalculator::get_tariff() const {
+    return this->tariff;
+}
+
+void TariffCalculator::update(const TariffMeterSample& sample) {
+    const auto from = this->last_sample.timestamp.to_time_point();
+    const auto to = sample.timestamp.to_time_point();
+    if (to < from) {
+        return;
+    }
+
+    // The period is priced with the state at its beginning
+    const auto state = this->get_condition_state(this->last_sample);
+    const auto period_s = std::chrono::duration<double>(to - from).count();
+
+    if (sample.energy_wh.has_value() and this->last_sample.energy_wh.has_value()) {
+        const auto energy_wh = std::max(0.0, sample.energy_wh.value() - this->last_sample.energy_wh.value());
+        const auto* energy_price = this->find_price(this->energy, state);
+        if (energy_price != nullptr) {
+            this->add_cost(this->energy_cost, this->energy, energy_price->price * energy_wh / 1000.0);
+        }
+    }
+
+    const auto& time_component = this->last_sample.charging ? this->charging_time : this->idle_time;
+    const auto* time_price = this->find_price(time_component, state);
+    if (time_price != nullptr) {
+        this->add_cost(this->time_cost, time_component, time_price->price * period_s / 60.0);
+    }
+    if (this->last_sample.charging) {
+        this->charging_time_s += period_s;
+    } else {
+        this->idle_time_s += period_s;
+    }
+
+    const auto last_energy_wh = this->last_sample.energy_wh;
+    this->last_sample = sample;
+    // Meter values without an energy register continue from the last known register value
+    if (!this->last_sample.energy_wh.has_value()) {
+        this->last_sample.energy_wh = last_energy_wh;
+    }
+}
+
+TariffCost TariffCalculator::get_cost() const {
+    TariffCost cost;
+    cost.excl_tax = this->energy_cost.excl_tax + this->time_cost.excl_tax + this->fixed_cost.excl_tax;
+    cost.incl_tax = this->energy_cost.incl_tax + this->time_cost.incl_tax + this->fixed_cost.incl_tax;
+
+    if (this->tariff.minCost.has_value()) {
+        const auto& min_cost = this->tariff.minCost.value();
+        if (min_cost.exclTax.has_value()) {
+            cost.excl_tax = std::max(cost.excl_tax, static_cast<double>(min_cost.exclTax.value()));
+        }
+        if (min_cost.inclTax.has_value()) {
+            cost.incl_tax = std::max(cost.incl_tax, static_cast<double>(min_cost.inclTax.value()));
+        }
+    }
+    if (this->tariff.maxCost.has_value()) {
+        const auto& max_cost = this->tariff.maxCost.value();
+        if (max_cost.exclTax.has_value()) {
+            cost.excl_tax = std::min(cost.excl_tax, static_cast<double>(max_cost.exclTax.value()));
+        }
+        if (max_cost.inclTax.has_value()) {
+            cost.incl_tax = std::min(cost.incl_tax, static_cast<double>(max_cost.inclTax.value()));
+        }
+    }
+    return cost;
+}
+
+RunningCostChargingPrice TariffCalculator::get_current_charging_price() const {
+    const auto state = this->get_condition_state(this->last_sample);
+    RunningCostChargingPrice charging_price;
+    if (const auto* price = this->find_price(this->energy, state); price != nullptr) {
+        charging_price.kWh_price = price->price * this->energy.tax_factor;
+    }
+    if (const auto* price = this->find_price(this->charging_time, state); price != nullptr) {
+        charging_price.hour_price = price->price * 60.0 * this->charging_time.tax_factor;
+    }
+    if (this->fixed_cost.incl_tax > 0.0) {
+        charging_price.flat_fee = this->fixed_cost.incl_tax;
+    }
+    return charging_price;
+}
+
+RunningCostIdlePrice TariffCalculator::get_current_idle_price() const {
+    const auto state = this->get_condition_state(this->last_sample);
+    RunningCostIdlePrice idle_price;
+    if (const auto* price = this->find_price(this->idle_time, state); price != nullptr) {
+        idle_price.idle_hour_price = price->price * 60.0 * this->idle_time.tax_factor;
+    }
+    return idle_price;
+}
+
+const TariffMeterSample& TariffCalculator::get_last_sample() const {
+    return this->last_sample;
+}
+
+void TariffCalculator::compile(const Tariff& tariff) {
+    this->energy = PriceComponent();
+    this->charging_time = PriceComponent();
+    this->idle_time = PriceComponent();
+    this->fixed_fee = PriceComponent();
+
+    if (tariff.energy.has_value()) {
+        this->energy.tax_factor = get_tax_factor(tariff.energy->taxRates);
+        for (const auto& price : tariff.energy->prices) {
+            this->energy.elements.push_back({price.priceKwh, to_conditions(price.conditions)});
+        }
+    }
+
+    const auto compile_time = [](const std::optional<TariffTime>& time, PriceComponent& component) {
+        if (!time.has_value()) {
+            return;
+        }
+        component.tax_factor = get_tax_factor(time->taxRates);
+        for (const auto& price : time->prices) {
+            component.elements.push_back({price.priceMinute, to_conditions(price.conditions)});
+        }
+    };
+    compile_time(tariff.chargingTime, this->charging_time);
+    compile_time(tariff.idleTime, this->idle_time);
+
+    if (tariff.fixedFee.has_value()) {
+        this->fixed_fee.tax_factor = get_tax_factor(tariff.fixedFee->taxRates);
+        for (const auto& price : tariff.fixedFee->prices) {
+            this->fixed_fee.elements.push_back({price.priceFixed, to_conditions(price.conditions)});
+        }
+    }
+}
+
+TariffCalculator::ConditionState TariffCalculator::get_condition_state(const TariffMeterSample& sample) const {
+    ConditionState state;
+    const auto utc = date::utc_clock::to_sys(sample.timestamp.to_time_point());
+    state.local_time = std::chrono::floor<std::chrono::seconds>(utc) + this->utc_offset;
+    state.energy_wh = std::max(0.0, sample.energy_wh.value_or(0.0) - this->start.energy_wh.value_or(0.0));
+    state.power_w = sample.power_w;
+    state.current_a = sample.current_a;
+    state.duration_s =
+        std::chrono::duration<double>(sample.timestamp.to_time_point() - this->start.timestamp.to_time_point()).count();
+    state.charging_time_s = this->charging_time_s;
+    state.idle_time_s = this->idle_time_s;
+    return state;
+}
+
+bool TariffCalculator::matches(const Conditions& conditions, const ConditionState& state) const {
+    const auto day = std::chrono::floor<date::days>(state.local_time);
+
+    if (conditions.start_minute_of_day.has_value() or conditions.end_minute_of_day.has_value()) {
+        const auto minute_of_day =
+            static_cast<std::int32_t>(std::chrono::duration_cast<std::chrono::minutes>(state.local_time - day).count());
+        const auto start = conditions.start_minute_of_day.value_or(0);
+        const auto end = conditions.end_minute_of_day.value_or(MINUTES_PER_DAY);
+        // A period that ends before it starts, e.g. 22:00 to 06:00, continues after midnight
+        const bool in_period = start <= end ? (minute_of_day >= start and minute_of_day < end)
+                                            : (minute_of_day >= start or minute_of_day < end);
+        if (!in_period) {
+            return false;
+        }
+    }
+
+    if (conditions.days_of_week != 0) {
+        // c_encoding() is 0 for Sunday, DayOfWeekEnum starts with Monday
+        const auto day_of_week = (date::weekday(day).c_encoding() + 6) % 7;
+        if ((conditions.days_of_week & (1U << day_of_week)) == 0) {
+            return false;
+        }
+    }
+
+    if (conditions.valid_from_date.has_value() and day < conditions.valid_from_date.value()) {
+        return false;
+    }
+    if (conditions.valid_to_date.has_value() and day >= conditions.valid_to_date.value()) {
+        return false;
+    }
+
+    if (conditions.evse_kind.has_value() and this->evse_kind.has_value() and
+        conditions.evse_kind.value() != this->evse_kind.value()) {
+        return false;
+    }
+
+    return is_in_range(conditions.min_energy, conditions.max_energy, std::optional<double>(state.energy_wh)) and
+           is_in_range(conditions.min_current, conditions.max_current, state.current_a) and
+           is_in_range(conditions.min_power, conditions.max_power, state.power_w) and
+           is_in_range(conditions.min_time, conditions.max_time, std::optional<double>(state.duration_s)) and
+           is_in_range(conditions.min_charging_time, conditions.max_charging_time,
+                       std::optional<double>(state.charging_time_s)) and
+           is_in_range(conditions.min_idle_time, conditions.max_idle_time,
+                       std::optional<double>(state.idle_time_s));
+}
+
+const TariffCalculator::PriceElement* TariffCalculator::find_price(const PriceComponent& component,
+                                                                   const ConditionState& state) const {
+    for (const auto& element : component.elements) {
+        if (this->matches(element.conditions, state)) {
+            return &element;
+        }
+    }
+    return nullptr;
+}
+
+void TariffCalculator::add_cost(TariffCost& cost, const PriceComponent& component, double amount) {
+    cost.excl_tax += amount;
+    cost.incl_tax += amount * component.tax_factor;
+}
+
+TariffCalculator::Conditions
+TariffCalculator::to_conditions(const std::optional<TariffConditions>& optional_conditions) {
+    Conditions result;
+    if (!optional_conditions.has_value()) {
+        return result;
+    }
+    const auto& conditions = optional_conditions.value();
+    result.start_minute_of_day = parse_time_of_day(conditions.startTimeOfDay);
+    result.end_minute_of_day = parse_time_of_day(conditions.endTimeOfDay);
+    result.days_of_week = to_day_mask(conditions.dayOfWeek);
+    result.valid_from_date = parse_date(conditions.validFromDate);
+    result.valid_to_date = parse_date(conditions.validToDate);
+    result.evse_kind = conditions.evseKind;
+    result.min_energy = conditions.minEnergy;
+    result.max_energy = conditions.maxEnergy;
+    result.min_current = conditions.minCurrent;
+    result.max_current = conditions.maxCurrent;
+    result.min_power = conditions.minPower;
+    result.max_power = conditions.maxPower;
+    result.min_time = conditions.minTime;
+    result.max_time = conditions.maxTime;
+    result.min_charging_time = conditions.minChargingTime;
+    result.max_charging_time = conditions.maxChargingTime;
+    result.min_idle_time = conditions.minIdleTime;
+    result.max_idle_time = conditions.maxIdleTime;
+    return result;
+}
+
+TariffCalculator::Conditions
+TariffCalculator::to_conditions(const std::optional<TariffConditionsFixed>& optional_conditions) {
+    Conditions result;
+    if (!optional_conditions.has_value()) {
+        return result;
+    }
+    const auto& conditions = optional_conditions.value();
+    result.start_minute_of_day = parse_time_of_day(conditions.startTimeOfDay);
+    result.end_minute_of_day = parse_time_of_day(conditions.endTimeOfDay);
+    result.days_of_week = to_day_mask(conditions.dayOfWeek);
+    result.valid_from_date = parse_date(conditions.validFromDate);
+    result.valid_to_date = parse_date(conditions.validToDate);
+    result.evse_kind = conditions.evseKind;
+    return result;
+}
+
+double TariffCalculator::get_tax_factor(const std::optional<std::vector<TaxRate>>& tax_rates) {
+    if (!tax_rates.has_value()) {
+        return 1.0;
+    }
+    // Taxes on the same stack level are added, a higher stack level is applied on top of the lower ones
+    std::map<std::int32_t, double> stacks;
+    for (const auto& tax_rate : tax_rates.value()) {
+        stacks[tax_rate.stack.value_or(0)] += tax_rate.tax;
+    }
+    double factor = 1.0;
+    for (const auto& [stack, tax] : stacks) {
+        factor *= 1.0 + tax / 100.0;
+    }
+    return factor;
+}
+
+} // namespace ocpp::v2
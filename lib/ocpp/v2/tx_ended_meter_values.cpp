@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v2/tx_ended_meter_values.hpp>
+
+#include <algorithm>
+
+#include <everest/logging.hpp>
+
+namespace ocpp::v2 {
+
+namespace {
+constexpr std::chrono::seconds MIN_INTERVAL{1};
+
+bool is_sample(const MeterValue& meter_value) {
+    if (meter_value.sampledValue.empty() or !meter_value.sampledValue.at(0).context.has_value()) {
+        return false;
+    }
+    const auto context = meter_value.sampledValue.at(0).context.value();
+    return context == ReadingContextEnum::Sample_Periodic or context == ReadingContextEnum::Sample_Clock;
+}
+} // namespace
+
+TxEndedMeterValues::TxEndedMeterValues(std::size_t max_bytes, std::chrono::seconds initial_interval) :
+    max_bytes(max_bytes),
+    initial_interval(std::max(initial_interval, MIN_INTERVAL)),
+    interval(0),
+    total_bytes(0) {
+}
+
+void TxEndedMeterValues::add(MeterValue&& meter_value) {
+    const bool sample = is_sample(meter_value);
+    if (sample and this->interval.count() > 0) {
+        const auto interval_number = this->get_interval_number(meter_value);
+        if (this->last_sample_interval == interval_number) {
+            return;
+        }
+        this->last_sample_interval = interval_number;
+    }
+
+    // The meter value is added to the meterValue array, preceded by a separating comma
+    const auto size = json(meter_value).dump().size() + 1;
+    this->entries.push_back({std::move(meter_value), size, sample});
+    this->total_bytes += size;
+
+    while (this->max_bytes > 0 and this->total_bytes > this->max_bytes and
+           std::count_if(this->entries.begin(), this->entries.end(), [](const Entry& entry) {
+               return entry.is_sample;
+           }) > 1) {
+        this->downsample();
+    }
+}
+
+std::vector<MeterValue> TxEndedMeterValues::take() {
+    if (this->interval.count() > 0) {
+        EVLOG_info << "Downsampled the meter values of TransactionEvent(Ended) to an interval of "
+                   << this->interval.count() << "s to stay within " << this->max_bytes << " bytes";
+    }
+
+    std::vector<MeterValue> meter_values;
+    meter_values.reserve(this->entries.size());
+    for (auto& entry : this->entries) {
+        meter_values.push_back(std::move(entry.meter_value));
+    }
+
+    this->entries.clear();
+    this->total_bytes = 0;
+    this->interval = std::chrono::seconds(0);
+    this->last_sample_interval.reset();
+
+    return meter_values;
+}
+
+std::chrono::seconds TxEndedMeterValues::get_interval() const {
+    return this->interval;
+}
+
+std::int64_t TxEndedMeterValues::get_interval_number(const MeterValue& meter_value) const {
+    const auto seconds =
+        std::chrono::duration_cast<std::chrono::seconds>(meter_value.timestamp.to_time_point().time_since_epoch());
+    return seconds.count() / this->interval.count();
+}
+
+void TxEndedMeterValues::downsample() {
+    this->interval = this->interval.count() == 0 ? this->initial_interval : this->interval * 2;
+    this->last_sample_interval.reset();
+    this->total_bytes = 0;
+
+    auto keep = this->entries.begin();
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it) {
+        if (it->is_sample) {
+            const auto interval_number = this->get_interval_number(it->meter_value);
+            if (this->last_sample_interval == interval_number) {
+                continue;
+            }
+            this->last_sample_interval = interval_number;
+        }
+        this->total_bytes += it->size;
+        if (keep != it) {
+            *keep = std::move(*it);
+        }
+        ++keep;
+    }
+    this->entries.erase(keep, this->entries.end());
+}
+
+} // namespace ocpp::v2
@@ -57,45 +57,60 @@ MeterValue get_meter_value_with_measurands_applied(const MeterValue& _meter_valu
     return meter_value;
 }
 
-std::vector<MeterValue> get_meter_values_with_measurands_applied(
-    const std::vector<MeterValue>& meter_values, const std::vector<MeasurandEnum>& sampled_tx_ended_measurands,
-    const std::vector<MeasurandEnum>& aligned_tx_ended_measurands, ocpp::DateTime max_timestamp,
-    bool include_sampled_signed, bool include_aligned_signed) {
-    std::vector<MeterValue> meter_values_result;
+std::optional<MeterValue> get_tx_ended_meter_value(const MeterValue& meter_value,
+                                                   const std::vector<MeasurandEnum>& sampled_tx_ended_measurands,
+                                                   const std::vector<MeasurandEnum>& aligned_tx_ended_measurands,
+                                                   const ocpp::DateTime& max_timestamp, bool include_sampled_signed,
+                                                   bool include_aligned_signed) {
+    if (meter_value.sampledValue.empty() or meter_value.timestamp > max_timestamp) {
+        return std::nullopt;
+    }
 
-    for (const auto& meter_value : meter_values) {
-        if (meter_value.sampledValue.empty() or meter_value.timestamp > max_timestamp) {
-            continue;
+    auto context = meter_value.sampledValue.at(0).context;
+    if (!context.has_value()) {
+        return std::nullopt;
+    }
+
+    switch (context.value()) {
+    case ReadingContextEnum::Transaction_Begin:
+    case ReadingContextEnum::Interruption_Begin:
+    case ReadingContextEnum::Transaction_End:
+    case ReadingContextEnum::Interruption_End:
+    case ReadingContextEnum::Sample_Periodic:
+        if (meter_value_has_any_measurand(meter_value, sampled_tx_ended_measurands)) {
+            return get_meter_value_with_measurands_applied(meter_value, sampled_tx_ended_measurands,
+                                                           include_sampled_signed);
         }
+        break;
 
-        auto context = meter_value.sampledValue.at(0).context;
-        if (!context.has_value()) {
-            continue;
+    case ReadingContextEnum::Sample_Clock:
+        if (meter_value_has_any_measurand(meter_value, aligned_tx_ended_measurands)) {
+            return get_meter_value_with_measurands_applied(meter_value, aligned_tx_ended_measurands,
+                                                           include_aligned_signed);
         }
+        break;
 
-        switch (context.value()) {
-        case ReadingContextEnum::Transaction_Begin:
-        case ReadingContextEnum::Interruption_Begin:
-        case ReadingContextEnum::Transaction_End:
-        case ReadingContextEnum::Interruption_End:
-        case ReadingContextEnum::Sample_Periodic:
-            if (meter_value_has_any_measurand(meter_value, sampled_tx_ended_measurands)) {
-                meter_values_result.push_back(get_meter_value_with_measurands_applied(
-                    meter_value, sampled_tx_ended_measurands, include_sampled_signed));
-            }
-            break;
+    case ReadingContextEnum::Other:
+    case ReadingContextEnum::Trigger:
+        // Nothing to do for these
+        break;
+    }
 
-        case ReadingContextEnum::Sample_Clock:
-            if (meter_value_has_any_measurand(meter_value, aligned_tx_ended_measurands)) {
-                meter_values_result.push_back(get_meter_value_with_measurands_applied(
-                    meter_value, aligned_tx_ended_measurands, include_aligned_signed));
-            }
-            break;
+    return std::nullopt;
+}
+
+std::vector<MeterValue> get_meter_values_with_measurands_applied(
+    const std::vector<MeterValue>& meter_values, const std::vector<MeasurandEnum>& sampled_tx_ended_measurands,
+    const std::vector<MeasurandEnum>& aligned_tx_ended_measurands, ocpp::DateTime max_timestamp,
+    bool include_sampled_signed, bool include_aligned_signed) {
+    std::vector<MeterValue> meter_values_result;
 
-        case ReadingContextEnum::Other:
-        case ReadingContextEnum::Trigger:
-            // Nothing to do for these
-            break;
+    for (const auto& meter_value : meter_values) {
+        auto tx_ended_meter_value =
+            get_tx_ended_meter_value(meter_value, sampled_tx_ended_measurands, aligned_tx_ended_measurands,
+                                     max_timestamp, include_sampled_signed, include_aligned_signed);
+        if (tx_ended_meter_value.has_value()) {
+            meter_values_result.push_back(std::move(tx_ended_meter_value.value()));
         }
     }
 
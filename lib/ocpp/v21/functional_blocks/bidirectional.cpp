@@ -1,6 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright Pionix GmbH and Contributors to EVerest
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 #include <everest/logging.hpp>
 
 #include <ocpp/v21/functional_blocks/bidirectional.hpp>
@@ -12,23 +16,96 @@
 #include <ocpp/v2/database_handler.hpp>
 #include <ocpp/v2/device_model.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v2/profile.hpp>
 #include <ocpp/v2/utils.hpp>
 
+#include <ocpp/v21/messages/AFRRSignal.hpp>
 #include <ocpp/v21/messages/NotifyAllowedEnergyTransfer.hpp>
 
+namespace {
+/// \brief Time span for which the aFRR curves are calculated in advance
+constexpr std::chrono::hours AFRR_CURVE_HORIZON{24};
+
+/// \returns the precedence of a charging profile purpose for aFRR, lower values take precedence. Purposes that do not
+/// provide a setpoint return std::nullopt
+std::optional<int> get_afrr_purpose_rank(const ocpp::v2::ChargingProfilePurposeEnum purpose) {
+    switch (purpose) {
+    case ocpp::v2::ChargingProfilePurposeEnum::PriorityCharging:
+        return 0;
+    case ocpp::v2::ChargingProfilePurposeEnum::TxProfile:
+        return 1;
+    case ocpp::v2::ChargingProfilePurposeEnum::TxDefaultProfile:
+        return 2;
+    default:
+        return std::nullopt;
+    }
+}
+} // namespace
+
+float ocpp::v2::get_v2x_signal_power(const std::vector<V2XSignalWattPoint>& curve, const std::int32_t signal) {
+    if (curve.empty()) {
+        return 0.0F;
+    }
+    if (signal <= curve.front().signal) {
+        return curve.front().power;
+    }
+    if (signal >= curve.back().signal) {
+        return curve.back().power;
+    }
+
+    const auto is_below = [](const std::int32_t value, const V2XSignalWattPoint& point) {
+        return value < point.signal;
+    };
+    const auto upper = std::upper_bound(curve.begin(), curve.end(), signal, is_below);
+    const auto lower = std::prev(upper);
+    if (upper->signal == lower->signal) {
+        return lower->power;
+    }
+    const auto fraction =
+        static_cast<float>(signal - lower->signal) / static_cast<float>(upper->signal - lower->signal);
+    return lower->power + (fraction * (upper->power - lower->power));
+}
+
 ocpp::v2::Bidirectional::Bidirectional(
-    const FunctionalBlockContext& context,
-    std::optional<NotifyAllowedEnergyTransferCallback> notify_allowed_energy_transfer_callback) :
-    context(context), notify_allowed_energy_transfer_callback(notify_allowed_energy_transfer_callback) {
+    const FunctionalBlockContext& context, SmartChargingInterface* smart_charging,
+    std::optional<NotifyAllowedEnergyTransferCallback> notify_allowed_energy_transfer_callback,
+    std::optional<AfrrSignalCallback> afrr_signal_callback) :
+    context(context),
+    smart_charging(smart_charging),
+    notify_allowed_energy_transfer_callback(notify_allowed_energy_transfer_callback),
+    afrr_signal_callback(afrr_signal_callback),
+    afrr_signal_timer(&context.executor->get_io_context()) {
 }
 
-ocpp::v2::Bidirectional::~Bidirectional() = default;
+ocpp::v2::Bidirectional::~Bidirectional() {
+    try {
+        // Stopped on the executor, so the timer handler can not run while this object is destroyed
+        this->context.executor->run_and_wait([this]() { this->afrr_signal_timer.stop(); });
+    } catch (...) {
+        EVLOG_error << "Exception during dtor call of aFRR signal timer stop";
+    }
+}
+
+void ocpp::v2::Bidirectional::on_charging_profiles_changed() {
+    if (!this->afrr_signal_callback.has_value()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->afrr_mutex);
+    this->load_afrr_curves(DateTime());
+}
+
+std::optional<std::chrono::microseconds> ocpp::v2::Bidirectional::get_last_afrr_signal_latency() const {
+    std::lock_guard<std::mutex> lock(this->afrr_mutex);
+    return this->last_afrr_signal_latency;
+}
 
 void ocpp::v2::Bidirectional::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
-    const auto& json_message = message.message;
+    const auto& json_message = *message.message;
 
     if (message.messageType == MessageType::NotifyAllowedEnergyTransfer) {
         this->handle_notify_allowed_energy_transfer(json_message);
+    } else if (message.messageType == MessageType::AFRRSignal) {
+        this->handle_afrr_signal(json_message, message.received_at);
     } else {
         throw MessageTypeNotImplementedException(message.messageType);
     }
@@ -126,3 +203,241 @@ void ocpp::v2::Bidirectional::handle_notify_allowed_energy_transfer(
         response, notify_allowed_energy_transfer.uniqueId);
     this->context.message_dispatcher.dispatch_call_result(call_result);
 }
+
+void ocpp::v2::Bidirectional::handle_afrr_signal(Call<v21::AFRRSignalRequest> call,
+                                                  const std::chrono::steady_clock::time_point& received_at) {
+    if (this->context.ocpp_version != OcppProtocolVersion::v21 or !this->afrr_signal_callback.has_value()) {
+        throw MessageTypeNotImplementedException(MessageType::AFRRSignal);
+    }
+
+    const auto handling_start = std::chrono::steady_clock::now();
+    const auto& signal_time = call.msg.timestamp;
+    std::vector<std::pair<std::int32_t, float>> setpoints;
+    bool is_scheduled = false;
+    {
+        std::lock_guard<std::mutex> lock(this->afrr_mutex);
+        setpoints = this->get_afrr_setpoints(signal_time, call.msg.signal);
+        // Signals for a later time are applied when their time is reached, with the curve that is active then
+        if (!setpoints.empty() and signal_time > DateTime()) {
+            this->pending_afrr_signals.emplace(signal_time, call.msg.signal);
+            this->schedule_pending_afrr_signals();
+            is_scheduled = true;
+        }
+    }
+
+    // The callback is invoked without holding afrr_mutex, so it may take its time or call back into libocpp
+    if (!is_scheduled and !setpoints.empty()) {
+        for (const auto& [evse_id, setpoint] : setpoints) {
+            this->afrr_signal_callback.value()(evse_id, setpoint);
+        }
+
+        // Messages that were not received through the message queue carry no reception time
+        const auto start = received_at != std::chrono::steady_clock::time_point() ? received_at : handling_start;
+        const auto latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        {
+            std::lock_guard<std::mutex> lock(this->afrr_mutex);
+            this->last_afrr_signal_latency = latency;
+        }
+        EVLOG_debug << "Applied aFRR signal " << call.msg.signal << " to " << setpoints.size() << " EVSE(s) after "
+                    << latency.count() << "us";
+    }
+
+    v21::AFRRSignalResponse response;
+    response.status = GenericStatusEnum::Accepted;
+    if (setpoints.empty()) {
+        response.status = GenericStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "NoCurve";
+        response.statusInfo->additionalInfo = "No charging profile with a v2xSignalWattCurve is active";
+    }
+
+    const ocpp::CallResult<v21::AFRRSignalResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+std::vector<std::pair<std::int32_t, float>>
+ocpp::v2::Bidirectional::get_afrr_setpoints(const DateTime& signal_time, const std::int32_t signal) {
+    const DateTime now;
+    if (!this->afrr_curves_valid_until.has_value() or this->afrr_curves_valid_until.value() <= now) {
+        this->load_afrr_curves(now);
+    }
+
+    std::vector<std::pair<std::int32_t, float>> setpoints;
+    for (const auto& [evse_id, periods] : this->afrr_curves) {
+        const auto period = std::find_if(periods.begin(), periods.end(), [&signal_time](const auto& entry) {
+            return entry.start <= signal_time and signal_time < entry.end;
+        });
+        // A curve is only used if its period takes precedence, a higher ranked period without a curve disables aFRR
+        if (period != periods.end() and period->curve.has_value()) {
+            const auto setpoint = period->baseline + get_v2x_signal_power(period->curve.value(), signal);
+            setpoints.emplace_back(evse_id, this->clamp_afrr_setpoint(evse_id, signal_time, setpoint));
+        }
+    }
+    return setpoints;
+}
+
+float ocpp::v2::Bidirectional::clamp_afrr_setpoint(const std::int32_t evse_id, const DateTime& time,
+                                                    const float setpoint) const {
+    const auto it = this->afrr_limits.find(evse_id);
+    if (it == this->afrr_limits.end()) {
+        return setpoint;
+    }
+    const auto& periods = it->second;
+    const auto next = std::upper_bound(periods.begin(), periods.end(), time,
+                                       [](const DateTime& value, const auto& period) { return value < period.start; });
+    if (next == periods.begin()) {
+        return setpoint;
+    }
+    const auto& period = *std::prev(next);
+
+    auto clamped = std::min(setpoint, period.limit);
+    if (period.discharge_limit.has_value()) {
+        clamped = std::max(clamped, period.discharge_limit.value());
+    }
+    if (clamped != setpoint) {
+        EVLOG_debug << "Clamping aFRR setpoint " << setpoint << "W of EVSE " << evse_id << " to " << clamped << "W";
+    }
+    return clamped;
+}
+
+void ocpp::v2::Bidirectional::apply_pending_afrr_signals() {
+    std::vector<std::pair<std::int32_t, float>> setpoints;
+    {
+        std::lock_guard<std::mutex> lock(this->afrr_mutex);
+        const DateTime now;
+        const auto due_end = this->pending_afrr_signals.upper_bound(now);
+        if (due_end != this->pending_afrr_signals.begin()) {
+            // Only the latest signal that is due is applied, the earlier ones are outdated
+            const auto& [signal_time, signal] = *std::prev(due_end);
+            setpoints = this->get_afrr_setpoints(signal_time, signal);
+            this->pending_afrr_signals.erase(this->pending_afrr_signals.begin(), due_end);
+        }
+        this->schedule_pending_afrr_signals();
+    }
+
+    for (const auto& [evse_id, setpoint] : setpoints) {
+        this->afrr_signal_callback.value()(evse_id, setpoint);
+    }
+}
+
+void ocpp::v2::Bidirectional::schedule_pending_afrr_signals() {
+    if (this->pending_afrr_signals.empty()) {
+        this->afrr_signal_timer.stop();
+        return;
+    }
+    this->afrr_signal_timer.at([this]() { this->apply_pending_afrr_signals(); },
+                               this->pending_afrr_signals.begin()->first.to_time_point());
+}
+
+void ocpp::v2::Bidirectional::load_afrr_curves(const DateTime& now) {
+    struct RankedPeriod {
+        int purpose_rank;
+        bool station_wide;
+        std::int32_t stack_level;
+        AfrrCurvePeriod period;
+    };
+
+    const DateTime end(now.to_time_point() + AFRR_CURVE_HORIZON);
+    std::map<std::int32_t, std::vector<RankedPeriod>> ranked_periods;
+    std::map<std::int32_t, std::vector<ChargingProfile>> profiles;
+    try {
+        profiles = this->context.database_handler.get_all_charging_profiles_group_by_evse();
+    } catch (const everest::db::QueryExecutionException& e) {
+        EVLOG_error << "Could not load charging profiles for aFRR: " << e.what();
+    }
+
+    for (auto& evse : this->context.evse_manager) {
+        const auto evse_id = evse.get_id();
+        std::optional<DateTime> session_start;
+        if (evse.has_active_transaction()) {
+            session_start = evse.get_transaction()->start_time;
+        }
+
+        for (const std::int32_t profile_evse_id : {evse_id, 0}) {
+            const auto it = profiles.find(profile_evse_id);
+            if (it == profiles.end()) {
+                continue;
+            }
+            for (const auto& profile : it->second) {
+                const auto purpose_rank = get_afrr_purpose_rank(profile.chargingProfilePurpose);
+                if (!purpose_rank.has_value() or profile.chargingSchedule.empty()) {
+                    continue;
+                }
+                const auto& schedule = profile.chargingSchedule.front();
+                // All periods are ranked, so a period without a curve overrides the curves of lower ranked profiles
+                for (std::size_t i = 0; i < schedule.chargingSchedulePeriod.size(); i++) {
+                    const auto& schedule_period = schedule.chargingSchedulePeriod.at(i);
+                    std::optional<std::vector<V2XSignalWattPoint>> curve;
+                    if (schedule_period.operationMode == OperationModeEnum::CentralFrequency and
+                        schedule_period.v2xSignalWattCurve.has_value() and
+                        !schedule_period.v2xSignalWattCurve->empty()) {
+                        if (schedule.chargingRateUnit == ChargingRateUnitEnum::W) {
+                            curve = schedule_period.v2xSignalWattCurve.value();
+                            std::sort(curve->begin(), curve->end(),
+                                      [](const auto& lhs, const auto& rhs) { return lhs.signal < rhs.signal; });
+                        } else {
+                            EVLOG_warning << "Ignoring v2xSignalWattCurve of charging profile " << profile.id
+                                          << " because its chargingRateUnit is not W";
+                        }
+                    }
+                    const auto baseline = schedule_period.v2xBaseline.value_or(0.0F);
+                    for (const auto& entry : calculate_profile_entry(now, end, session_start, profile, i)) {
+                        ranked_periods[evse_id].push_back({purpose_rank.value(), profile_evse_id == 0,
+                                                           profile.stackLevel,
+                                                           AfrrCurvePeriod{entry.start, entry.end, baseline, curve}});
+                    }
+                }
+            }
+        }
+    }
+
+    this->afrr_curves.clear();
+    for (auto& [evse_id, periods] : ranked_periods) {
+        std::stable_sort(periods.begin(), periods.end(), [](const auto& lhs, const auto& rhs) {
+            if (lhs.purpose_rank != rhs.purpose_rank) {
+                return lhs.purpose_rank < rhs.purpose_rank;
+            }
+            if (lhs.station_wide != rhs.station_wide) {
+                return !lhs.station_wide;
+            }
+            return lhs.stack_level > rhs.stack_level;
+        });
+        auto& curves = this->afrr_curves[evse_id];
+        for (auto& ranked_period : periods) {
+            curves.push_back(std::move(ranked_period.period));
+        }
+    }
+    this->load_afrr_limits(now, end);
+    this->afrr_curves_valid_until = end;
+}
+
+void ocpp::v2::Bidirectional::load_afrr_limits(const DateTime& now, const DateTime& end) {
+    this->afrr_limits.clear();
+    if (this->smart_charging == nullptr) {
+        return;
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::seconds>(end.to_time_point() - now.to_time_point());
+    for (const auto& [evse_id, periods] : this->afrr_curves) {
+        if (std::none_of(periods.begin(), periods.end(),
+                         [](const auto& period) { return period.curve.has_value(); })) {
+            continue;
+        }
+        // Contains the ChargingStationMaxProfile, the external constraints and the maximum power of the EVSE
+        const auto composite_schedule =
+            this->smart_charging->get_composite_schedule(evse_id, duration, ChargingRateUnitEnum::W);
+        if (!composite_schedule.has_value()) {
+            EVLOG_warning << "Could not calculate the composite schedule of EVSE " << evse_id
+                          << ", its aFRR setpoints are not limited";
+            continue;
+        }
+
+        auto& limits = this->afrr_limits[evse_id];
+        const auto schedule_start = composite_schedule->scheduleStart.to_time_point();
+        for (const auto& period : composite_schedule->chargingSchedulePeriod) {
+            limits.push_back({DateTime(schedule_start + std::chrono::seconds(period.startPeriod)),
+                              period.limit.value_or(std::numeric_limits<float>::max()), period.dischargeLimit});
+        }
+    }
+}
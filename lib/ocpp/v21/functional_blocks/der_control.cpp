@@ -0,0 +1,764 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v21/functional_blocks/der_control.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <boost/asio/post.hpp>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/common/constants.hpp>
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/evse_manager.hpp>
+
+#include <ocpp/v21/messages/ReportDERControl.hpp>
+
+namespace ocpp::v2 {
+
+namespace {
+/// \brief Minimum, maximum and average of the sampled values of a measurand
+struct MeasuredRange {
+    float minimum = 0.0F;
+    float maximum = 0.0F;
+    float sum = 0.0F;
+    std::size_t count = 0;
+
+    void add(const float value) {
+        this->minimum = this->count == 0 ? value : std::min(this->minimum, value);
+        this->maximum = this->count == 0 ? value : std::max(this->maximum, value);
+        this->sum += value;
+        this->count++;
+    }
+};
+
+/// \returns the value of \p sampled_value in the base unit (V, Hz or W), taking the unit prefix and multiplier into
+/// account
+float to_base_unit(const SampledValue& sampled_value) {
+    float value = sampled_value.value;
+    if (sampled_value.unitOfMeasure.has_value()) {
+        const auto& unit_of_measure = sampled_value.unitOfMeasure.value();
+        if (unit_of_measure.multiplier.has_value()) {
+            value *= std::pow(10.0F, static_cast<float>(unit_of_measure.multiplier.value()));
+        }
+        if (unit_of_measure.unit.has_value() and
+            (unit_of_measure.unit.value() == "kW" or unit_of_measure.unit.value() == "kV")) {
+            value *= 1000.0F;
+        }
+    }
+    return value;
+}
+
+/// \returns true if \p control contains the settings that belong to its controlType
+bool has_settings(const v21::SetDERControlRequest& control) {
+    switch (control.controlType) {
+    case DERControlEnum::EnterService:
+        return control.enterService.has_value();
+    case DERControlEnum::FixedPFAbsorb:
+        return control.fixedPFAbsorb.has_value();
+    case DERControlEnum::FixedPFInject:
+        return control.fixedPFInject.has_value();
+    case DERControlEnum::FixedVar:
+        return control.fixedVar.has_value();
+    case DERControlEnum::FreqDroop:
+        return control.freqDroop.has_value();
+    case DERControlEnum::Gradients:
+        return control.gradient.has_value();
+    case DERControlEnum::LimitMaxDischarge:
+        return control.limitMaxDischarge.has_value();
+    default:
+        return control.curve.has_value() and !control.curve->curveData.empty();
+    }
+}
+
+/// \returns the priority of \p control, lower values take precedence
+std::int32_t get_priority(const v21::SetDERControlRequest& control) {
+    if (control.curve.has_value()) {
+        return control.curve->priority;
+    }
+    if (control.enterService.has_value()) {
+        return control.enterService->priority;
+    }
+    if (control.fixedPFAbsorb.has_value()) {
+        return control.fixedPFAbsorb->priority;
+    }
+    if (control.fixedPFInject.has_value()) {
+        return control.fixedPFInject->priority;
+    }
+    if (control.fixedVar.has_value()) {
+        return control.fixedVar->priority;
+    }
+    if (control.freqDroop.has_value()) {
+        return control.freqDroop->priority;
+    }
+    if (control.gradient.has_value()) {
+        return control.gradient->priority;
+    }
+    if (control.limitMaxDischarge.has_value()) {
+        return control.limitMaxDischarge->priority;
+    }
+    return 0;
+}
+
+/// \returns the time at which the time window of \p control ends, if it has one
+std::optional<DateTime> get_end_time(const v21::SetDERControlRequest& control) {
+    const auto end_time = [](const std::optional<DateTime>& start_time,
+                             const std::optional<float>& duration) -> std::optional<DateTime> {
+        if (!start_time.has_value() or !duration.has_value()) {
+            return std::nullopt;
+        }
+        return DateTime(start_time->to_time_point() +
+                        std::chrono::milliseconds(static_cast<std::int64_t>(duration.value() * 1000)));
+    };
+    if (control.curve.has_value()) {
+        return end_time(control.curve->startTime, control.curve->duration);
+    }
+    if (control.fixedPFAbsorb.has_value()) {
+        return end_time(control.fixedPFAbsorb->startTime, control.fixedPFAbsorb->duration);
+    }
+    if (control.fixedPFInject.has_value()) {
+        return end_time(control.fixedPFInject->startTime, control.fixedPFInject->duration);
+    }
+    if (control.fixedVar.has_value()) {
+        return end_time(control.fixedVar->startTime, control.fixedVar->duration);
+    }
+    if (control.freqDroop.has_value()) {
+        return end_time(control.freqDroop->startTime, control.freqDroop->duration);
+    }
+    if (control.limitMaxDischarge.has_value()) {
+        return end_time(control.limitMaxDischarge->startTime, control.limitMaxDischarge->duration);
+    }
+    return std::nullopt;
+}
+
+bool matches(const v21::SetDERControlRequest& control, const std::optional<bool>& is_default,
+             const std::optional<DERControlEnum>& control_type, const std::optional<CiString<36>>& control_id) {
+    return (!is_default.has_value() or control.isDefault == is_default.value()) and
+           (!control_type.has_value() or control.controlType == control_type.value()) and
+           (!control_id.has_value() or control.controlId.get() == control_id->get());
+}
+
+template <typename T> void append(std::optional<std::vector<T>>& list, const T& entry) {
+    if (!list.has_value()) {
+        list.emplace();
+    }
+    list->push_back(entry);
+}
+
+v21::NotifyDERAlarmRequest create_alarm(const DERControlEnum control_type,
+                                        const std::optional<GridEventFaultEnum>& grid_event_fault,
+                                        const std::int32_t evse_id, const DateTime& timestamp, const bool ended) {
+    v21::NotifyDERAlarmRequest alarm;
+    alarm.controlType = control_type;
+    alarm.timestamp = timestamp;
+    alarm.gridEventFault = grid_event_fault;
+    if (ended) {
+        alarm.alarmEnded = true;
+    }
+    alarm.extraInfo = "EVSE " + std::to_string(evse_id);
+    return alarm;
+}
+} // namespace
+
+DERControl::DERControl(const FunctionalBlockContext& context, boost::asio::io_context& io_context,
+                       std::optional<DERCurveOutputCallback> der_curve_output_callback) :
+    context(context),
+    io_context(io_context),
+    der_curve_output_callback(der_curve_output_callback),
+    nominal_voltage(LOW_VOLTAGE),
+    active_curves_dirty(true),
+    meter_value_processing(std::make_shared<MeterValueProcessing>()) {
+    const auto supply_voltage =
+        this->context.device_model.get_optional_value<int>(ControllerComponentVariables::SupplyVoltage);
+    if (supply_voltage.has_value() and supply_voltage.value() > 0) {
+        this->nominal_voltage = static_cast<float>(supply_voltage.value());
+    }
+
+    try {
+        this->controls = this->context.database_handler.get_der_controls();
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Could not load the DER controls from the database: " << e.what();
+    }
+    this->update_superseded(DateTime());
+
+    // EVSE 0 reports the meter values of the grid connection
+    this->published_meter_values.emplace(0, std::make_unique<PublishedMeterValue>());
+    for (auto& evse : this->context.evse_manager) {
+        this->published_meter_values.emplace(evse.get_id(), std::make_unique<PublishedMeterValue>());
+    }
+}
+
+DERControl::~DERControl() {
+    // Handlers that are still queued on the io_context must not access this object anymore
+    const std::lock_guard<std::mutex> lk(this->meter_value_processing->mutex);
+    this->meter_value_processing->stopped = true;
+}
+
+void DERControl::handle_message(const ocpp::EnhancedMessage<MessageType>& message) {
+    const auto& json_message = *message.message;
+    if (this->context.ocpp_version != OcppProtocolVersion::v21) {
+        // The DER control messages were introduced with OCPP 2.1
+        throw MessageTypeNotImplementedException(message.messageType);
+    }
+
+    if (message.messageType == MessageType::SetDERControl) {
+        this->handle_set_der_control_req(json_message);
+    } else if (message.messageType == MessageType::GetDERControl) {
+        this->handle_get_der_control_req(json_message);
+    } else if (message.messageType == MessageType::ClearDERControl) {
+        this->handle_clear_der_control_req(json_message);
+    } else {
+        throw MessageTypeNotImplementedException(message.messageType);
+    }
+}
+
+void DERControl::on_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) {
+    const auto published = this->published_meter_values.find(evse_id);
+    if (published == this->published_meter_values.end()) {
+        EVLOG_debug << "Ignoring meter value of unknown EVSE " << evse_id << " for the DER curves";
+        return;
+    }
+
+    // Only the latest meter value is handed over, the caller never waits for the evaluation
+    auto& published_meter_value = *published->second;
+    published_meter_value.meter_value.publish(meter_value);
+    if (published_meter_value.processing_scheduled.exchange(true)) {
+        return;
+    }
+
+    boost::asio::post(this->io_context, [this, evse_id, processing = this->meter_value_processing]() {
+        const std::lock_guard<std::mutex> lk(processing->mutex);
+        if (!processing->stopped) {
+            this->process_meter_value(evse_id);
+        }
+    });
+}
+
+void DERControl::process_meter_value(const std::int32_t evse_id) {
+    auto& published_meter_value = *this->published_meter_values.at(evse_id);
+    // Reset before consuming, so a meter value that is published meanwhile schedules a new evaluation
+    published_meter_value.processing_scheduled = false;
+    MeterValue meter_value;
+    if (published_meter_value.meter_value.consume(meter_value)) {
+        this->evaluate_meter_value(evse_id, meter_value);
+    }
+}
+
+void DERControl::evaluate_meter_value(const std::int32_t evse_id, const MeterValue& meter_value) {
+    MeasuredRange voltage;
+    MeasuredRange frequency;
+    std::optional<float> active_power;
+    for (const auto& sampled_value : meter_value.sampledValue) {
+        const auto measurand = sampled_value.measurand.value_or(MeasurandEnum::Energy_Active_Import_Register);
+        const auto phase = sampled_value.phase;
+        if (measurand == MeasurandEnum::Voltage) {
+            // Line to line voltages can not be compared to the nominal voltage
+            if (phase != PhaseEnum::L1_L2 and phase != PhaseEnum::L2_L3 and phase != PhaseEnum::L3_L1) {
+                voltage.add(to_base_unit(sampled_value));
+            }
+        } else if (measurand == MeasurandEnum::Frequency) {
+            frequency.add(to_base_unit(sampled_value));
+        } else if (measurand == MeasurandEnum::Power_Active_Import and !phase.has_value()) {
+            active_power = active_power.value_or(0.0F) + to_base_unit(sampled_value);
+        } else if (measurand == MeasurandEnum::Power_Active_Export and !phase.has_value()) {
+            active_power = active_power.value_or(0.0F) - to_base_unit(sampled_value);
+        }
+    }
+
+    std::vector<v21::NotifyDERAlarmRequest> alarms;
+    std::vector<DERCurveOutput> outputs;
+    {
+        const std::lock_guard<std::mutex> lock(this->der_mutex);
+        const auto& now = meter_value.timestamp;
+        if (this->active_curves_dirty or
+            (this->active_curves_valid_until.has_value() and now >= this->active_curves_valid_until.value())) {
+            alarms = this->load_active_curves(now);
+            this->active_curves_dirty = false;
+        }
+
+        // Trip curves use the most extreme value of the phases, the other curves use the average
+        const auto get_value = [&](const ActiveCurve& curve) -> std::optional<float> {
+            switch (curve.quantity) {
+            case DERQuantity::Voltage:
+                if (voltage.count == 0) {
+                    return std::nullopt;
+                }
+                if (!curve.is_trip_curve) {
+                    return 100.0F * voltage.sum / static_cast<float>(voltage.count) / this->nominal_voltage;
+                }
+                return 100.0F * (curve.is_upper_limit ? voltage.maximum : voltage.minimum) / this->nominal_voltage;
+            case DERQuantity::Frequency:
+                if (frequency.count == 0) {
+                    return std::nullopt;
+                }
+                if (!curve.is_trip_curve) {
+                    return frequency.sum / static_cast<float>(frequency.count);
+                }
+                return curve.is_upper_limit ? frequency.maximum : frequency.minimum;
+            case DERQuantity::ActivePower: {
+                const auto rated_power = this->get_rated_power(evse_id);
+                if (!active_power.has_value() or !rated_power.has_value()) {
+                    return std::nullopt;
+                }
+                return 100.0F * active_power.value() / rated_power.value();
+            }
+            }
+            return std::nullopt;
+        };
+
+        const auto number_of_curves = this->active_curves.size();
+        auto& states = this->trip_states[evse_id];
+        this->curve_inputs.resize(number_of_curves);
+        for (std::size_t i = 0; i < number_of_curves; i++) {
+            const auto& curve = this->active_curves[i];
+            const auto value = get_value(curve);
+            if (!curve.is_trip_curve) {
+                this->curve_inputs[i] = value.value_or(0.0F);
+                continue;
+            }
+
+            auto& state = states[curve.control_type];
+            if (state.control_id.get() != curve.control_id.get()) {
+                state = TripState{curve.control_id, curve.grid_event_fault, std::nullopt, false};
+            }
+            const bool is_excursion =
+                value.has_value() and (curve.is_upper_limit ? value.value() > curve.excursion_limit
+                                                            : value.value() < curve.excursion_limit);
+            if (is_excursion) {
+                if (!state.excursion_start.has_value()) {
+                    state.excursion_start = now;
+                }
+                this->curve_inputs[i] =
+                    std::chrono::duration<float>(now.to_time_point() - state.excursion_start->to_time_point())
+                        .count();
+            } else {
+                this->curve_inputs[i] = 0.0F;
+                state.excursion_start.reset();
+                if (state.alarm) {
+                    state.alarm = false;
+                    alarms.push_back(create_alarm(curve.control_type, curve.grid_event_fault, evse_id, now, true));
+                }
+            }
+        }
+
+        this->evaluator.evaluate(this->curve_inputs, this->curve_outputs);
+
+        for (std::size_t i = 0; i < number_of_curves; i++) {
+            const auto& curve = this->active_curves[i];
+            const auto value = get_value(curve);
+            if (!value.has_value()) {
+                continue;
+            }
+            const auto result = this->curve_outputs[i];
+            if (!curve.is_trip_curve) {
+                outputs.push_back({curve.control_type, curve.control_id, result, curve.unit});
+                continue;
+            }
+
+            auto& state = states[curve.control_type];
+            const bool is_tripped = curve.is_upper_limit ? value.value() > result : value.value() < result;
+            if (state.excursion_start.has_value() and !state.alarm and is_tripped) {
+                state.alarm = true;
+                alarms.push_back(create_alarm(curve.control_type, curve.grid_event_fault, evse_id, now, false));
+            }
+        }
+    }
+
+    for (const auto& alarm : alarms) {
+        const ocpp::Call<v21::NotifyDERAlarmRequest> call(alarm);
+        this->context.message_dispatcher.dispatch_call(call);
+    }
+    if (!outputs.empty() and this->der_curve_output_callback.has_value()) {
+        this->der_curve_output_callback.value()(evse_id, outputs);
+    }
+}
+
+void DERControl::handle_set_der_control_req(Call<v21::SetDERControlRequest> call) {
+    const auto& control = call.msg;
+    v21::SetDERControlResponse response;
+    response.status = DERControlStatusEnum::Accepted;
+
+    if (!has_settings(control)) {
+        response.status = DERControlStatusEnum::Rejected;
+        response.statusInfo = StatusInfo();
+        response.statusInfo->reasonCode = "MissingParam";
+        response.statusInfo->additionalInfo =
+            "No settings for controlType " + conversions::dercontrol_enum_to_string(control.controlType);
+    } else {
+        const std::lock_guard<std::mutex> lock(this->der_mutex);
+        try {
+            // The controls in memory are only changed after the database was changed, so they never differ from the
+            // stored controls. A default control replaces the default control of its type
+            for (auto it = this->controls.begin(); it != this->controls.end();) {
+                const auto& stored = it->control;
+                const bool is_replaced_default = control.isDefault and stored.isDefault and
+                                                 stored.controlType == control.controlType and
+                                                 stored.controlId.get() != control.controlId.get();
+                if (is_replaced_default) {
+                    this->context.database_handler.delete_der_controls(true, control.controlType,
+                                                                       stored.controlId.get());
+                    it = this->controls.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            this->context.database_handler.insert_or_update_der_control(control, false);
+            this->controls.erase(std::remove_if(this->controls.begin(), this->controls.end(),
+                                                [&control](const StoredDERControl& stored) {
+                                                    return stored.control.controlId.get() ==
+                                                               control.controlId.get() and
+                                                           stored.control.isDefault == control.isDefault;
+                                                }),
+                                 this->controls.end());
+            this->controls.push_back({control, false});
+            auto superseded_ids = this->update_superseded(DateTime());
+            superseded_ids.erase(std::remove_if(superseded_ids.begin(), superseded_ids.end(),
+                                                [&control](const CiString<36>& id) {
+                                                    return id.get() == control.controlId.get();
+                                                }),
+                                 superseded_ids.end());
+            if (!superseded_ids.empty()) {
+                response.supersededIds = superseded_ids;
+            }
+        } catch (const everest::db::QueryExecutionException& e) {
+            EVLOG_error << "Could not store DER control: " << e.what();
+            response.status = DERControlStatusEnum::Rejected;
+            response.statusInfo = StatusInfo();
+            response.statusInfo->reasonCode = "InternalError";
+        }
+        this->active_curves_dirty = true;
+    }
+
+    const ocpp::CallResult<v21::SetDERControlResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+void DERControl::handle_get_der_control_req(Call<v21::GetDERControlRequest> call) {
+    const auto& request = call.msg;
+    std::vector<StoredDERControl> matching_controls;
+    {
+        const std::lock_guard<std::mutex> lock(this->der_mutex);
+        std::copy_if(this->controls.begin(), this->controls.end(), std::back_inserter(matching_controls),
+                     [&request](const StoredDERControl& stored) {
+                         return matches(stored.control, request.isDefault, request.controlType, request.controlId);
+                     });
+    }
+
+    v21::GetDERControlResponse response;
+    response.status = matching_controls.empty() ? DERControlStatusEnum::NotFound : DERControlStatusEnum::Accepted;
+    const ocpp::CallResult<v21::GetDERControlResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+
+    if (!matching_controls.empty()) {
+        this->report_der_controls(request.requestId, matching_controls);
+    }
+}
+
+void DERControl::handle_clear_der_control_req(Call<v21::ClearDERControlRequest> call) {
+    const auto& request = call.msg;
+    v21::ClearDERControlResponse response;
+    response.status = DERControlStatusEnum::NotFound;
+    {
+        const std::lock_guard<std::mutex> lock(this->der_mutex);
+        try {
+            std::optional<std::string> control_id;
+            if (request.controlId.has_value()) {
+                control_id = request.controlId->get();
+            }
+            this->context.database_handler.delete_der_controls(request.isDefault, request.controlType, control_id);
+        } catch (const everest::db::QueryExecutionException& e) {
+            EVLOG_error << "Could not delete DER controls: " << e.what();
+        }
+
+        const auto it = std::remove_if(
+            this->controls.begin(), this->controls.end(), [&request](const StoredDERControl& stored) {
+                return matches(stored.control, request.isDefault, request.controlType, request.controlId);
+            });
+        if (it != this->controls.end()) {
+            response.status = DERControlStatusEnum::Accepted;
+            this->controls.erase(it, this->controls.end());
+            this->update_superseded(DateTime());
+            this->active_curves_dirty = true;
+        }
+    }
+
+    const ocpp::CallResult<v21::ClearDERControlResponse> call_result(response, call.uniqueId);
+    this->context.message_dispatcher.dispatch_call_result(call_result);
+}
+
+void DERControl::report_der_controls(const std::int32_t request_id, const std::vector<StoredDERControl>& controls) {
+    v21::ReportDERControlRequest report;
+    report.requestId = request_id;
+
+    for (const auto& [control, is_superseded] : controls) {
+        switch (control.controlType) {
+        case DERControlEnum::EnterService: {
+            EnterServiceGet entry;
+            entry.enterService = control.enterService.value();
+            entry.id = control.controlId;
+            append(report.enterService, entry);
+            break;
+        }
+        case DERControlEnum::FixedPFAbsorb:
+        case DERControlEnum::FixedPFInject: {
+            const bool is_absorb = control.controlType == DERControlEnum::FixedPFAbsorb;
+            FixedPFGet entry;
+            entry.fixedPF = is_absorb ? control.fixedPFAbsorb.value() : control.fixedPFInject.value();
+            entry.id = control.controlId;
+            entry.isDefault = control.isDefault;
+            entry.isSuperseded = is_superseded;
+            append(is_absorb ? report.fixedPFAbsorb : report.fixedPFInject, entry);
+            break;
+        }
+        case DERControlEnum::FixedVar: {
+            FixedVarGet entry;
+            entry.fixedVar = control.fixedVar.value();
+            entry.id = control.controlId;
+            entry.isDefault = control.isDefault;
+            entry.isSuperseded = is_superseded;
+            append(report.fixedVar, entry);
+            break;
+        }
+        case DERControlEnum::FreqDroop: {
+            FreqDroopGet entry;
+            entry.freqDroop = control.freqDroop.value();
+            entry.id = control.controlId;
+            entry.isDefault = control.isDefault;
+            entry.isSuperseded = is_superseded;
+            append(report.freqDroop, entry);
+            break;
+        }
+        case DERControlEnum::Gradients: {
+            GradientGet entry;
+            entry.gradient = control.gradient.value();
+            entry.id = control.controlId;
+            append(report.gradient, entry);
+            break;
+        }
+        case DERControlEnum::LimitMaxDischarge: {
+            LimitMaxDischargeGet entry;
+            entry.id = control.controlId;
+            entry.isDefault = control.isDefault;
+            entry.isSuperseded = is_superseded;
+            entry.limitMaxDischarge = control.limitMaxDischarge.value();
+            append(report.limitMaxDischarge, entry);
+            break;
+        }
+        default: {
+            DERCurveGet entry;
+            entry.curve = control.curve.value();
+            entry.id = control.controlId;
+            entry.curveType = control.controlType;
+            entry.isDefault = control.isDefault;
+            entry.isSuperseded = is_superseded;
+            append(report.curve, entry);
+            break;
+        }
+        }
+    }
+
+    const ocpp::Call<v21::ReportDERControlRequest> call(report);
+    this->context.message_dispatcher.dispatch_call(call);
+}
+
+std::vector<CiString<36>> DERControl::update_superseded(const DateTime& now) {
+    std::vector<CiString<36>> superseded_ids;
+    for (std::size_t i = 0; i < this->controls.size(); i++) {
+        auto& stored = this->controls[i];
+        bool is_superseded = false;
+        if (!stored.control.isDefault) {
+            const auto priority = get_priority(stored.control);
+            for (std::size_t j = 0; j < this->controls.size() and !is_superseded; j++) {
+                const auto& other = this->controls[j].control;
+                if (j == i or other.isDefault or other.controlType != stored.control.controlType) {
+                    continue;
+                }
+                const auto end_time = get_end_time(other);
+                if (end_time.has_value() and end_time.value() <= now) {
+                    continue;
+                }
+                const auto other_priority = get_priority(other);
+                is_superseded = other_priority < priority or (other_priority == priority and j > i);
+            }
+        }
+        if (is_superseded == stored.is_superseded) {
+            continue;
+        }
+
+        try {
+            this->context.database_handler.insert_or_update_der_control(stored.control, is_superseded);
+        } catch (const everest::db::QueryExecutionException& e) {
+            // The supersession is derived again on the next change of the controls
+            EVLOG_error << "Could not update DER control: " << e.what();
+            continue;
+        }
+        stored.is_superseded = is_superseded;
+        if (is_superseded) {
+            superseded_ids.push_back(stored.control.controlId);
+        }
+    }
+    return superseded_ids;
+}
+
+std::vector<v21::NotifyDERAlarmRequest> DERControl::load_active_curves(const DateTime& now) {
+    this->update_superseded(now);
+
+    // Per type the scheduled control with the highest priority, or the default control. A superseded control is
+    // still active while the control with the higher priority has not started yet
+    std::map<DERControlEnum, const v21::SetDERControlRequest*> scheduled;
+    std::map<DERControlEnum, const v21::SetDERControlRequest*> defaults;
+    this->active_curves_valid_until.reset();
+    const auto update_valid_until = [this](const DateTime& time) {
+        if (!this->active_curves_valid_until.has_value() or time < this->active_curves_valid_until.value()) {
+            this->active_curves_valid_until = time;
+        }
+    };
+
+    for (const auto& [control, is_superseded] : this->controls) {
+        if (!control.curve.has_value()) {
+            continue;
+        }
+        const auto& curve = control.curve.value();
+        if (curve.startTime.has_value() and curve.startTime.value() > now) {
+            update_valid_until(curve.startTime.value());
+            continue;
+        }
+        if (curve.startTime.has_value() and curve.duration.has_value()) {
+            const DateTime end(curve.startTime->to_time_point() +
+                               std::chrono::milliseconds(static_cast<std::int64_t>(curve.duration.value() * 1000)));
+            if (end <= now) {
+                continue;
+            }
+            update_valid_until(end);
+        }
+
+        auto& active = control.isDefault ? defaults[control.controlType] : scheduled[control.controlType];
+        if (active == nullptr or curve.priority < active->curve->priority) {
+            active = &control;
+        }
+    }
+    for (const auto& [control_type, control] : defaults) {
+        scheduled.emplace(control_type, control);
+    }
+
+    this->active_curves.clear();
+    std::vector<std::vector<DERCurvePoints>> curves;
+    for (const auto& [control_type, control] : scheduled) {
+        auto active_curve = create_active_curve(*control);
+        if (active_curve.has_value()) {
+            this->active_curves.push_back(active_curve.value());
+            curves.push_back(control->curve->curveData);
+        }
+    }
+    this->evaluator = DERCurveEvaluator(curves);
+
+    // Alarms of trip curves that are no longer active end
+    std::vector<v21::NotifyDERAlarmRequest> ended_alarms;
+    for (auto& [evse_id, states] : this->trip_states) {
+        for (auto it = states.begin(); it != states.end();) {
+            const auto& [control_type, state] = *it;
+            const bool is_active =
+                std::any_of(this->active_curves.begin(), this->active_curves.end(), [&](const ActiveCurve& curve) {
+                    return curve.control_type == control_type and curve.control_id.get() == state.control_id.get();
+                });
+            if (is_active) {
+                ++it;
+                continue;
+            }
+            if (state.alarm) {
+                ended_alarms.push_back(create_alarm(control_type, state.grid_event_fault, evse_id, now, true));
+            }
+            it = states.erase(it);
+        }
+    }
+    return ended_alarms;
+}
+
+std::optional<DERControl::ActiveCurve> DERControl::create_active_curve(const v21::SetDERControlRequest& control) {
+    if (!control.curve.has_value() or control.curve->curveData.empty()) {
+        return std::nullopt;
+    }
+
+    ActiveCurve curve;
+    curve.control_type = control.controlType;
+    curve.control_id = control.controlId;
+    curve.unit = control.curve->yUnit;
+    curve.is_trip_curve = true;
+    curve.is_upper_limit = true;
+    switch (control.controlType) {
+    case DERControlEnum::VoltVar:
+    case DERControlEnum::VoltWatt:
+        curve.quantity = DERQuantity::Voltage;
+        curve.is_trip_curve = false;
+        break;
+    case DERControlEnum::FreqWatt:
+        curve.quantity = DERQuantity::Frequency;
+        curve.is_trip_curve = false;
+        break;
+    case DERControlEnum::WattVar:
+    case DERControlEnum::WattPF:
+        curve.quantity = DERQuantity::ActivePower;
+        curve.is_trip_curve = false;
+        break;
+    case DERControlEnum::HVMustTrip:
+    case DERControlEnum::HVMayTrip:
+    case DERControlEnum::HVMomCess:
+        curve.quantity = DERQuantity::Voltage;
+        curve.grid_event_fault = GridEventFaultEnum::OverVoltage;
+        break;
+    case DERControlEnum::LVMustTrip:
+    case DERControlEnum::LVMayTrip:
+    case DERControlEnum::LVMomCess:
+        curve.quantity = DERQuantity::Voltage;
+        curve.is_upper_limit = false;
+        curve.grid_event_fault = GridEventFaultEnum::UnderVoltage;
+        break;
+    case DERControlEnum::HFMustTrip:
+    case DERControlEnum::HFMayTrip:
+        curve.quantity = DERQuantity::Frequency;
+        curve.grid_event_fault = GridEventFaultEnum::OverFrequency;
+        break;
+    case DERControlEnum::LFMustTrip:
+        curve.quantity = DERQuantity::Frequency;
+        curve.is_upper_limit = false;
+        curve.grid_event_fault = GridEventFaultEnum::UnderFrequency;
+        break;
+    case DERControlEnum::PowerMonitoringMustTrip:
+        curve.quantity = DERQuantity::ActivePower;
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    const auto& points = control.curve->curveData;
+    const auto compare_y = [](const DERCurvePoints& lhs, const DERCurvePoints& rhs) { return lhs.y < rhs.y; };
+    curve.excursion_limit = curve.is_upper_limit ? std::min_element(points.begin(), points.end(), compare_y)->y
+                                                 : std::max_element(points.begin(), points.end(), compare_y)->y;
+    return curve;
+}
+
+std::optional<float> DERControl::get_rated_power(const std::int32_t evse_id) {
+    const auto it = this->rated_power.find(evse_id);
+    if (it != this->rated_power.end()) {
+        return it->second;
+    }
+
+    std::optional<float> power;
+    if (evse_id > 0) {
+        const auto power_cv = EvseComponentVariables::get_component_variable(evse_id, EvseComponentVariables::Power);
+        const auto meta_data =
+            this->context.device_model.get_variable_meta_data(power_cv.component, power_cv.variable.value());
+        if (meta_data.has_value() and meta_data->characteristics.maxLimit.value_or(0.0F) > 0.0F) {
+            power = meta_data->characteristics.maxLimit.value();
+        }
+    }
+    this->rated_power[evse_id] = power;
+    return power;
+}
+
+} // namespace ocpp::v2
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "benchmark_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/resource.h>
+
+namespace ocpp::benchmark {
+
+namespace {
+std::size_t read_proc_status_value(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind(key + ":", 0) == 0) {
+            std::istringstream value(line.substr(key.size() + 1));
+            std::size_t number = 0;
+            value >> number;
+            return number;
+        }
+    }
+    return 0;
+}
+
+double to_milliseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // namespace
+
+void LatencyRecorder::add(std::chrono::nanoseconds latency) {
+    const std::lock_guard lock(this->mutex);
+    this->latencies.push_back(latency);
+}
+
+void LatencyRecorder::clear() {
+    const std::lock_guard lock(this->mutex);
+    this->latencies.clear();
+}
+
+std::size_t LatencyRecorder::size() const {
+    const std::lock_guard lock(this->mutex);
+    return this->latencies.size();
+}
+
+std::chrono::nanoseconds LatencyRecorder::get_percentile(double percent) const {
+    std::vector<std::chrono::nanoseconds> sorted;
+    {
+        const std::lock_guard lock(this->mutex);
+        sorted = this->latencies;
+    }
+    if (sorted.empty()) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    // Nearest rank method
+    const auto rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * static_cast<double>(sorted.size())));
+    const auto index = std::clamp<std::size_t>(rank, 1, sorted.size()) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+    return sorted.at(index);
+}
+
+ResourceUsage ResourceUsage::now() {
+    ResourceUsage usage;
+
+    rusage self{};
+    if (getrusage(RUSAGE_SELF, &self) == 0) {
+        usage.cpu_time = std::chrono::seconds(self.ru_utime.tv_sec + self.ru_stime.tv_sec) +
+                         std::chrono::microseconds(self.ru_utime.tv_usec + self.ru_stime.tv_usec);
+    }
+    // VmRSS is reported in kB
+    usage.rss_bytes = read_proc_status_value("VmRSS") * 1024;
+    usage.number_of_threads = read_proc_status_value("Threads");
+
+    return usage;
+}
+
+void print_header(std::ostream& os) {
+    os << std::left << std::setw(28) << "scenario" << std::right << std::setw(10) << "messages" << std::setw(12)
+       << "duration_s" << std::setw(12) << "msg_per_s" << std::setw(10) << "p50_ms" << std::setw(10) << "p99_ms"
+       << std::setw(10) << "cpu_s" << std::setw(10) << "rss_mib" << std::setw(9) << "threads" << "\n";
+}
+
+void print_result(std::ostream& os, const ScenarioResult& result) {
+    const auto seconds = result.duration.count();
+    const auto messages_per_second = seconds > 0 ? static_cast<double>(result.number_of_messages) / seconds : 0.0;
+    const auto cpu_seconds =
+        std::chrono::duration<double>(result.after.cpu_time - result.before.cpu_time).count();
+    const auto rss_mib = static_cast<double>(result.after.rss_bytes) / (1024.0 * 1024.0);
+
+    auto name = result.name;
+    if (!result.completed) {
+        name += " (timeout)";
+    }
+
+    os << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+       << result.number_of_messages << std::setw(12) << seconds << std::setw(12) << messages_per_second;
+    if (result.number_of_latencies > 0) {
+        os << std::setw(10) << to_milliseconds(result.latency_p50) << std::setw(10)
+           << to_milliseconds(result.latency_p99);
+    } else {
+        os << std::setw(10) << "-" << std::setw(10) << "-";
+    }
+    os << std::setw(10) << cpu_seconds << std::setw(10) << rss_mib << std::setw(9) << result.after.number_of_threads
+       << "\n";
+}
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ocpp::benchmark {
+
+/// \brief Thread safe recorder of latencies
+class LatencyRecorder {
+public:
+    void add(std::chrono::nanoseconds latency);
+    void clear();
+
+    std::size_t size() const;
+    /// \returns the latency below which \p percent of the recorded latencies are, 0 if nothing was recorded
+    std::chrono::nanoseconds get_percentile(double percent) const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::chrono::nanoseconds> latencies;
+};
+
+/// \brief CPU time and memory usage of the process
+struct ResourceUsage {
+    /// \brief User and system CPU time used by all threads of the process
+    std::chrono::microseconds cpu_time{0};
+    /// \brief Current resident set size in bytes
+    std::size_t rss_bytes = 0;
+    /// \brief Number of threads of the process
+    std::size_t number_of_threads = 0;
+
+    /// \returns the current resource usage of the process
+    static ResourceUsage now();
+};
+
+/// \brief Result of a benchmark scenario
+struct ScenarioResult {
+    std::string name;
+    bool completed = false;
+    /// \brief Number of messages that were exchanged in the measured part of the scenario
+    std::size_t number_of_messages = 0;
+    std::chrono::duration<double> duration{0};
+    std::chrono::nanoseconds latency_p50{0};
+    std::chrono::nanoseconds latency_p99{0};
+    std::size_t number_of_latencies = 0;
+    ResourceUsage before;
+    ResourceUsage after;
+};
+
+/// \brief Writes the header of the table that print_result() writes rows for
+void print_header(std::ostream& os);
+/// \brief Writes \p result as a row of the result table
+void print_result(std::ostream& os, const ScenarioResult& result);
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include "benchmark_report.hpp"
+
+namespace ocpp::benchmark {
+
+/// \brief Parameters of the benchmark scenarios
+struct BenchmarkOptions {
+    /// \brief Directory with the v16 and v2 configs, migrations and component configs of the repository
+    std::filesystem::path config_dir;
+    /// \brief Directory in which every scenario creates its databases and configs
+    std::filesystem::path work_dir;
+    /// \brief Number of EVSEs of the 2.0.1 charging station
+    std::size_t number_of_evses = 24;
+    /// \brief Duration of the scenarios that run for a fixed time
+    std::chrono::seconds duration{30};
+    /// \brief Number of transactions that are started and finished while the charging station is offline
+    std::size_t number_of_offline_transactions = 200;
+    /// \brief Number of calls of the CSMS in the burst scenario, per message type
+    std::size_t burst_size = 500;
+    /// \brief Number of entries of the local authorization list
+    std::size_t local_list_size = 10000;
+    /// \brief Number of times the local authorization list is sent
+    std::size_t local_list_repetitions = 10;
+    /// \brief Number of DER curves that are evaluated per update
+    std::size_t number_of_der_curves = 22;
+    /// \brief Number of meter value updates the DER curves are evaluated for
+    std::size_t number_of_der_updates = 1000000;
+    /// \brief Number of meter values of the transaction that is written to the database
+    std::size_t number_of_database_meter_values = 3600;
+    /// \brief Number of 2.0.1 stations that are started in one process
+    std::size_t number_of_stations = 20;
+    /// \brief Delay of the CSMS before it responds to a CALL of the charging station
+    std::chrono::milliseconds response_delay{0};
+    /// \brief Maximum time a scenario waits for the expected messages
+    std::chrono::seconds timeout{120};
+};
+
+using Scenario = std::function<ScenarioResult(const BenchmarkOptions& options)>;
+
+/// \brief 2.0.1 station with running transactions on all EVSEs that sends TransactionEvent(Updated) messages with
+/// meter values every second
+ScenarioResult run_v2_meter_values(const BenchmarkOptions& options);
+
+/// \brief 2.0.1 station that starts and finishes transactions while offline and then sends the queued
+/// TransactionEvent messages after it reconnected
+ScenarioResult run_v2_offline_queue_drain(const BenchmarkOptions& options);
+
+/// \brief CSMS that sends bursts of GetVariables and SetChargingProfile requests to a 2.0.1 station
+ScenarioResult run_v2_burst(const BenchmarkOptions& options);
+
+/// \brief Threads and memory per 2.0.1 station when many stations run in one process, once with an executor per
+/// station and once with one executor shared by all stations
+ScenarioResult run_v2_multiple_stations(const BenchmarkOptions& options);
+
+/// \brief CSMS that repeatedly sends a full local authorization list to a 1.6 station
+ScenarioResult run_v16_send_local_list(const BenchmarkOptions& options);
+
+/// \brief Evaluation of the active DER curves per meter value update, without a charging station or CSMS
+ScenarioResult run_der_curve_evaluation(const BenchmarkOptions& options);
+
+/// \brief Size of a 2.0.1 database with the meter values of a transaction and charging profiles, written with the
+/// regular and with the compact encoding
+ScenarioResult run_database_encoding(const BenchmarkOptions& options);
+
+} // namespace ocpp::benchmark
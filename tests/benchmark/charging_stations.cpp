@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "charging_stations.hpp"
+
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include <ocpp/common/evse_security_impl.hpp>
+
+namespace ocpp::benchmark {
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+json read_json(const fs::path& path) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Could not open " + path.string());
+    }
+    return json::parse(ifs);
+}
+
+void write_json(const fs::path& path, const json& content) {
+    std::ofstream ofs(path);
+    ofs << content.dump(2);
+}
+
+void create_empty_file(const fs::path& path) {
+    if (!fs::is_regular_file(path)) {
+        std::ofstream ofs(path);
+    }
+}
+
+void apply_override(const fs::path& component_config_dir, const VariableOverride& variable_override) {
+    for (const auto& sub_dir : {"standardized", "custom"}) {
+        const auto path = component_config_dir / sub_dir / (variable_override.component + ".json");
+        if (!fs::is_regular_file(path)) {
+            continue;
+        }
+
+        auto component = read_json(path);
+        for (auto& [name, variable] : component.at("properties").items()) {
+            if (variable.value("variable_name", name) != variable_override.variable) {
+                continue;
+            }
+            for (auto& attribute : variable.at("attributes")) {
+                if (attribute.at("type") == "Actual") {
+                    attribute["value"] = variable_override.value;
+                }
+            }
+            write_json(path, component);
+            return;
+        }
+    }
+    throw std::runtime_error("Variable " + variable_override.component + "." + variable_override.variable +
+                             " not found in the component config");
+}
+
+/// \brief Copies the component config of the repository to \p directory and generates the EVSEs and connectors from
+/// the config of EVSE 1 and its connector 1
+fs::path create_component_config(const fs::path& config_dir, const fs::path& directory, std::size_t number_of_evses,
+                                 const std::vector<VariableOverride>& overrides) {
+    const auto source_dir = config_dir / "v2" / "component_config";
+    const auto component_config_dir = directory / "component_config";
+    fs::remove_all(component_config_dir);
+    fs::create_directories(component_config_dir / "custom");
+    fs::copy(source_dir / "standardized", component_config_dir / "standardized", fs::copy_options::recursive);
+
+    auto evse = read_json(source_dir / "custom" / "EVSE_1.json");
+    auto connector = read_json(source_dir / "custom" / "Connector_1_1.json");
+    for (std::size_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+        const auto id = std::to_string(evse_id);
+        evse["evse_id"] = evse_id;
+        connector["evse_id"] = evse_id;
+        write_json(component_config_dir / "custom" / ("EVSE_" + id + ".json"), evse);
+        write_json(component_config_dir / "custom" / ("Connector_" + id + "_1.json"), connector);
+    }
+
+    for (const auto& variable_override : overrides) {
+        apply_override(component_config_dir, variable_override);
+    }
+    return component_config_dir;
+}
+
+/// \brief Creates empty certificate bundles in \p directory and returns a configuration that uses them
+SecurityConfiguration create_security_configuration(const fs::path& directory) {
+    const auto ca_dir = directory / "certs" / "ca";
+    const auto client_dir = directory / "certs" / "client";
+    fs::create_directories(ca_dir);
+    fs::create_directories(client_dir / "csms");
+    fs::create_directories(client_dir / "cso");
+    create_empty_file(ca_dir / "V2G_CA_BUNDLE.pem");
+    create_empty_file(ca_dir / "MO_CA_BUNDLE.pem");
+
+    SecurityConfiguration security_configuration;
+    security_configuration.csms_ca_bundle = ca_dir / "V2G_CA_BUNDLE.pem";
+    security_configuration.mf_ca_bundle = ca_dir / "V2G_CA_BUNDLE.pem";
+    security_configuration.v2g_ca_bundle = ca_dir / "V2G_CA_BUNDLE.pem";
+    security_configuration.mo_ca_bundle = ca_dir / "MO_CA_BUNDLE.pem";
+    security_configuration.csms_leaf_cert_directory = client_dir / "csms";
+    security_configuration.csms_leaf_key_directory = client_dir / "csms";
+    security_configuration.secc_leaf_cert_directory = client_dir / "cso";
+    security_configuration.secc_leaf_key_directory = client_dir / "cso";
+    return security_configuration;
+}
+} // namespace
+
+std::shared_ptr<EvseSecurity> create_evse_security(const fs::path& directory) {
+    return std::make_shared<EvseSecurityImpl>(create_security_configuration(directory));
+}
+
+v2::Callbacks create_v2_callbacks() {
+    v2::Callbacks callbacks;
+    callbacks.is_reset_allowed_callback = [](const std::optional<const std::int32_t>, const v2::ResetEnum&) {
+        return true;
+    };
+    callbacks.reset_callback = [](const std::optional<const std::int32_t>, const v2::ResetEnum&) {};
+    callbacks.stop_transaction_callback = [](const std::int32_t, const v2::ReasonEnum&) {
+        return v2::RequestStartStopStatusEnum::Accepted;
+    };
+    callbacks.pause_charging_callback = [](const std::int32_t) {};
+    callbacks.connector_effective_operative_status_changed_callback =
+        [](const std::int32_t, const std::int32_t, const v2::OperationalStatusEnum) {};
+    callbacks.get_log_request_callback = [](const v2::GetLogRequest&) {
+        v2::GetLogResponse response;
+        response.status = v2::LogStatusEnum::Rejected;
+        return response;
+    };
+    callbacks.unlock_connector_callback = [](const std::int32_t, const std::int32_t) {
+        v2::UnlockConnectorResponse response;
+        response.status = v2::UnlockStatusEnum::Unlocked;
+        return response;
+    };
+    callbacks.remote_start_transaction_callback = [](const v2::RequestStartTransactionRequest&, const bool) {
+        return v2::RequestStartStopStatusEnum::Accepted;
+    };
+    callbacks.is_reservation_for_token_callback = [](const std::int32_t, const CiString<255>,
+                                                     const std::optional<CiString<255>>) {
+        return ReservationCheckStatus::NotReserved;
+    };
+    callbacks.update_firmware_request_callback = [](const v2::UpdateFirmwareRequest&) {
+        v2::UpdateFirmwareResponse response;
+        response.status = v2::UpdateFirmwareStatusEnum::Rejected;
+        return response;
+    };
+    callbacks.security_event_callback = [](const CiString<50>&, const std::optional<CiString<255>>&) {};
+    callbacks.set_charging_profiles_callback = []() {};
+
+    // Required depending on the controllers that are available in the component config
+    callbacks.get_display_message_callback = [](const v2::GetDisplayMessagesRequest&) {
+        return std::vector<v2::DisplayMessage>{};
+    };
+    callbacks.set_display_message_callback = [](const std::vector<v2::DisplayMessage>&) {
+        v2::SetDisplayMessageResponse response;
+        response.status = v2::DisplayMessageStatusEnum::Accepted;
+        return response;
+    };
+    callbacks.clear_display_message_callback = [](const v2::ClearDisplayMessageRequest&) {
+        v2::ClearDisplayMessageResponse response;
+        response.status = v2::ClearMessageStatusEnum::Accepted;
+        return response;
+    };
+    callbacks.set_running_cost_callback = [](const RunningCost&, const std::uint32_t, std::optional<std::string>) {};
+    callbacks.reserve_now_callback = [](const v2::ReserveNowRequest&) { return v2::ReserveNowStatusEnum::Rejected; };
+    callbacks.cancel_reservation_callback = [](const std::int32_t) { return false; };
+    callbacks.update_allowed_energy_transfer_modes_callback =
+        [](const std::vector<v2::EnergyTransferModeEnum>, const CiString<36>) { return true; };
+
+    return callbacks;
+}
+
+std::unique_ptr<v2::ChargePoint> create_v2_charge_point(const BenchmarkOptions& options, const fs::path& directory,
+                                                        const std::string& csms_url, std::size_t number_of_evses,
+                                                        const v2::Callbacks& callbacks,
+                                                        const std::vector<VariableOverride>& overrides,
+                                                        std::shared_ptr<Executor> executor) {
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const json network_connection_profiles = json::array({{{"configurationSlot", 1},
+                                                           {"connectionData",
+                                                            {{"messageTimeout", 30},
+                                                             {"ocppCsmsUrl", csms_url},
+                                                             {"ocppInterface", "Wired0"},
+                                                             {"ocppTransport", "JSON"},
+                                                             {"ocppVersion", "OCPP20"},
+                                                             {"securityProfile", 1}}}}});
+    std::vector<VariableOverride> all_overrides = {
+        {"InternalCtrlr", "NetworkConnectionProfiles", network_connection_profiles.dump()},
+        {"InternalCtrlr", "SupportedOcppVersions", "ocpp2.0.1"},
+        // Message logging would dominate the measurements
+        {"InternalCtrlr", "LogMessagesFormat", ""},
+    };
+    all_overrides.insert(all_overrides.end(), overrides.begin(), overrides.end());
+
+    const auto component_config_dir =
+        create_component_config(options.config_dir, directory, number_of_evses, all_overrides);
+
+    std::map<std::int32_t, std::int32_t> evse_connector_structure;
+    for (std::size_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+        evse_connector_structure.emplace(static_cast<std::int32_t>(evse_id), 1);
+    }
+
+    const auto v2_config_dir = options.config_dir / "v2";
+    return std::make_unique<v2::ChargePoint>(
+        evse_connector_structure, (directory / "device_model_storage.db").string(),
+        (v2_config_dir / "device_model_migrations").string(), component_config_dir.string(), directory.string(),
+        directory.string(), (v2_config_dir / "core_migrations").string(), directory.string(),
+        create_evse_security(directory), callbacks, std::move(executor));
+}
+
+std::unique_ptr<v16::ChargePoint> create_v16_charge_point(const BenchmarkOptions& options, const fs::path& directory,
+                                                          std::uint16_t port, const json& config_patch) {
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const auto v16_config_dir = options.config_dir / "v16";
+    auto config = read_json(v16_config_dir / "config.json");
+    config.merge_patch({{"Internal", {{"CentralSystemURI", "127.0.0.1:" + std::to_string(port) + "/"}}},
+                        {"Security", {{"SecurityProfile", 0}}}});
+    config.merge_patch(config_patch);
+
+    const auto user_config_path = directory / "user_config.json";
+    write_json(user_config_path, json::object());
+
+    // The ChargePoint creates the EvseSecurity from the SecurityConfiguration if none is given
+    return std::make_unique<v16::ChargePoint>(config.dump(), v16_config_dir, user_config_path, directory,
+                                              v16_config_dir / "core_migrations", directory, nullptr,
+                                              create_security_configuration(directory));
+}
+
+} // namespace ocpp::benchmark
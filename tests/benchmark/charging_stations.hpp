@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <ocpp/common/evse_security.hpp>
+#include <ocpp/common/executor.hpp>
+#include <ocpp/v16/charge_point.hpp>
+#include <ocpp/v2/charge_point.hpp>
+#include <ocpp/v2/charge_point_callbacks.hpp>
+
+#include "benchmark_scenarios.hpp"
+
+namespace ocpp::benchmark {
+
+/// \brief Value of a variable of the 2.0.1 component config that is replaced for a scenario
+struct VariableOverride {
+    /// \brief Name of the component config file without extension, e.g. "OCPPCommCtrlr"
+    std::string component;
+    std::string variable;
+    /// \brief New value of the Actual attribute
+    nlohmann::json value;
+};
+
+/// \brief Creates an EvseSecurity with empty certificate bundles in \p directory
+std::shared_ptr<EvseSecurity> create_evse_security(const std::filesystem::path& directory);
+
+/// \returns callbacks for a 2.0.1 station that accept every request of the CSMS and do nothing else
+v2::Callbacks create_v2_callbacks();
+
+/// \brief Creates a 2.0.1 station with \p number_of_evses EVSEs that connects to \p csms_url. The component config
+/// of the repository is copied to \p directory, the EVSEs and connectors are generated and \p overrides are applied.
+/// The timers of the station run on \p executor if given, on an executor of the station otherwise
+std::unique_ptr<v2::ChargePoint> create_v2_charge_point(const BenchmarkOptions& options,
+                                                        const std::filesystem::path& directory,
+                                                        const std::string& csms_url, std::size_t number_of_evses,
+                                                        const v2::Callbacks& callbacks,
+                                                        const std::vector<VariableOverride>& overrides,
+                                                        std::shared_ptr<Executor> executor = nullptr);
+
+/// \brief Creates a 1.6 station that connects to the CSMS on localhost at \p port, using the config of the
+/// repository with \p config_patch merged into it
+std::unique_ptr<v16::ChargePoint> create_v16_charge_point(const BenchmarkOptions& options,
+                                                          const std::filesystem::path& directory, std::uint16_t port,
+                                                          const nlohmann::json& config_patch);
+
+} // namespace ocpp::benchmark
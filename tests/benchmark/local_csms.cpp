@@ -0,0 +1,409 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "local_csms.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/asio/steady_timer.hpp>
+#include <libwebsockets.h>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/common/call_types.hpp>
+#include <ocpp/common/types.hpp>
+
+namespace ocpp::benchmark {
+
+namespace {
+constexpr auto LOCALHOST = "127.0.0.1";
+constexpr std::size_t RX_BUFFER_SIZE = 64 * 1024;
+constexpr auto OCPP16 = "ocpp1.6";
+constexpr auto DEFAULT_HEARTBEAT_INTERVAL = 300;
+
+int callback_csms(struct lws* wsi, enum lws_callback_reasons reason, void* /*user*/, void* in, size_t len) {
+    auto* context = lws_get_context(wsi);
+    auto* csms = context != nullptr ? static_cast<LocalCsms*>(lws_context_user(context)) : nullptr;
+    if (csms == nullptr) {
+        return 0;
+    }
+
+    switch (reason) {
+    case LWS_CALLBACK_FILTER_PROTOCOL_CONNECTION:
+        // A non-zero return value rejects the connection
+        return csms->is_accepting_connections() ? 0 : -1;
+    case LWS_CALLBACK_ESTABLISHED:
+        csms->on_established(wsi, lws_get_protocol(wsi)->name);
+        break;
+    case LWS_CALLBACK_CLOSED:
+        csms->on_closed(wsi);
+        break;
+    case LWS_CALLBACK_RECEIVE:
+        csms->on_receive(wsi, static_cast<const char*>(in), len,
+                         lws_is_final_fragment(wsi) != 0 and lws_remaining_packet_payload(wsi) == 0);
+        break;
+    case LWS_CALLBACK_SERVER_WRITEABLE:
+        csms->on_writeable(wsi);
+        break;
+    case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+        csms->on_wait_cancelled();
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+// The charging station selects the subprotocol, all of them are handled by the same callback
+const std::array<struct lws_protocols, 4> protocols = {{{"ocpp2.0.1", callback_csms, 0, RX_BUFFER_SIZE, 0, nullptr, 0},
+                                                        {"ocpp2.1", callback_csms, 0, RX_BUFFER_SIZE, 0, nullptr, 0},
+                                                        {OCPP16, callback_csms, 0, RX_BUFFER_SIZE, 0, nullptr, 0},
+                                                        LWS_PROTOCOL_LIST_TERM}};
+} // namespace
+
+LocalCsms::LocalCsms(std::uint16_t port) :
+    port(port),
+    running(false),
+    accept_connections(true),
+    context(nullptr),
+    executor(std::make_shared<Executor>(1)),
+    connection(nullptr),
+    default_response_delay(0),
+    number_of_messages(0),
+    message_id(0),
+    transaction_id(0) {
+}
+
+LocalCsms::~LocalCsms() {
+    this->stop();
+    // Drops the delayed responses that did not fire yet
+    this->executor->stop();
+}
+
+void LocalCsms::start() {
+    if (this->running) {
+        return;
+    }
+
+    lws_set_log_level(LLL_ERR, nullptr);
+
+    lws_context_creation_info info{};
+    info.port = this->port;
+    info.iface = LOCALHOST;
+    info.protocols = protocols.data();
+    info.user = this;
+    info.gid = -1;
+    info.uid = -1;
+
+    this->context = lws_create_context(&info);
+    if (this->context == nullptr) {
+        throw std::runtime_error("Could not create the libwebsockets server context");
+    }
+
+    auto* vhost = lws_get_vhost_by_name(this->context, "default");
+    if (vhost != nullptr) {
+        this->port = static_cast<std::uint16_t>(lws_get_vhost_listen_port(vhost));
+    }
+
+    this->running = true;
+    this->service_thread = std::thread([this]() {
+        while (this->running) {
+            lws_service(this->context, 0);
+        }
+    });
+    EVLOG_info << "Local CSMS listening on " << this->get_url();
+}
+
+void LocalCsms::stop() {
+    if (!this->running) {
+        return;
+    }
+
+    {
+        const std::lock_guard lock(this->mutex);
+        this->connection = nullptr;
+        this->outgoing_messages.clear();
+        for (auto& [unique_id, pending_call] : this->pending_calls) {
+            pending_call.promise.set_exception(std::make_exception_ptr(std::runtime_error("CSMS stopped")));
+        }
+        this->pending_calls.clear();
+    }
+
+    this->running = false;
+    lws_cancel_service(this->context);
+    this->service_thread.join();
+
+    lws_context* context_to_destroy = nullptr;
+    {
+        // send() wakes up the service thread while holding the lock, so the context must not be destroyed before it
+        // is reset under the lock
+        const std::lock_guard lock(this->mutex);
+        std::swap(context_to_destroy, this->context);
+    }
+    lws_context_destroy(context_to_destroy);
+}
+
+std::uint16_t LocalCsms::get_port() const {
+    return this->port;
+}
+
+std::string LocalCsms::get_url() const {
+    return std::string("ws://") + LOCALHOST + ":" + std::to_string(this->port);
+}
+
+void LocalCsms::set_handler(const std::string& action, CsmsRequestHandler handler) {
+    const std::lock_guard lock(this->mutex);
+    this->handlers[action] = std::move(handler);
+}
+
+void LocalCsms::set_default_response_delay(std::chrono::milliseconds delay) {
+    const std::lock_guard lock(this->mutex);
+    this->default_response_delay = delay;
+}
+
+void LocalCsms::set_accept_connections(bool accept) {
+    this->accept_connections = accept;
+}
+
+bool LocalCsms::wait_for_connection(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(this->mutex);
+    return this->cv.wait_for(lock, timeout, [this]() { return this->connection != nullptr; });
+}
+
+bool LocalCsms::wait_for_calls(const std::string& action, std::size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock lock(this->mutex);
+    return this->cv.wait_for(lock, timeout, [this, &action, count]() {
+        const auto it = this->number_of_calls.find(action);
+        return it != this->number_of_calls.end() and it->second >= count;
+    });
+}
+
+std::size_t LocalCsms::get_number_of_calls(const std::string& action) const {
+    const std::lock_guard lock(this->mutex);
+    const auto it = this->number_of_calls.find(action);
+    return it != this->number_of_calls.end() ? it->second : 0;
+}
+
+std::size_t LocalCsms::get_number_of_messages() const {
+    const std::lock_guard lock(this->mutex);
+    return this->number_of_messages;
+}
+
+std::future<json> LocalCsms::call(const std::string& action, const json& payload) {
+    std::string unique_id;
+    {
+        const std::lock_guard lock(this->mutex);
+        unique_id = "csms-" + std::to_string(++this->message_id);
+    }
+    auto message = json::array({static_cast<int>(MessageTypeId::CALL), unique_id, action, payload}).dump();
+
+    std::future<json> future;
+    {
+        const std::lock_guard lock(this->mutex);
+        auto& pending_call = this->pending_calls[unique_id];
+        pending_call.sent = std::chrono::steady_clock::now();
+        future = pending_call.promise.get_future();
+    }
+
+    if (!this->send(std::move(message))) {
+        const std::lock_guard lock(this->mutex);
+        auto it = this->pending_calls.find(unique_id);
+        if (it != this->pending_calls.end()) {
+            it->second.promise.set_exception(std::make_exception_ptr(std::runtime_error("Not connected")));
+            this->pending_calls.erase(it);
+        }
+    }
+    return future;
+}
+
+LatencyRecorder& LocalCsms::get_latencies() {
+    return this->latencies;
+}
+
+void LocalCsms::reset_statistics() {
+    {
+        const std::lock_guard lock(this->mutex);
+        this->number_of_calls.clear();
+        this->number_of_messages = 0;
+    }
+    this->latencies.clear();
+}
+
+bool LocalCsms::is_accepting_connections() const {
+    return this->accept_connections;
+}
+
+void LocalCsms::on_established(lws* wsi, const char* protocol) {
+    {
+        const std::lock_guard lock(this->mutex);
+        this->connection = wsi;
+        this->ocpp_version = protocol != nullptr ? protocol : "";
+        this->receive_buffer.clear();
+    }
+    EVLOG_info << "Charging station connected to the local CSMS using " << protocol;
+    this->cv.notify_all();
+}
+
+void LocalCsms::on_closed(lws* wsi) {
+    const std::lock_guard lock(this->mutex);
+    if (wsi != this->connection) {
+        return;
+    }
+
+    this->connection = nullptr;
+    this->outgoing_messages.clear();
+    for (auto& [unique_id, pending_call] : this->pending_calls) {
+        pending_call.promise.set_exception(std::make_exception_ptr(std::runtime_error("Connection closed")));
+    }
+    this->pending_calls.clear();
+}
+
+void LocalCsms::on_receive(lws* wsi, const char* data, std::size_t len, bool is_final) {
+    std::string message;
+    {
+        const std::lock_guard lock(this->mutex);
+        if (wsi != this->connection) {
+            return;
+        }
+        this->receive_buffer.append(data, len);
+        if (!is_final) {
+            return;
+        }
+        message.swap(this->receive_buffer);
+    }
+    this->handle_message(message);
+}
+
+void LocalCsms::on_writeable(lws* wsi) {
+    bool more_messages = false;
+    {
+        const std::lock_guard lock(this->mutex);
+        if (wsi != this->connection or this->outgoing_messages.empty()) {
+            return;
+        }
+        const auto& message = this->outgoing_messages.front();
+        this->write_buffer.resize(LWS_PRE + message.size());
+        std::memcpy(this->write_buffer.data() + LWS_PRE, message.data(), message.size());
+        this->outgoing_messages.pop_front();
+        more_messages = !this->outgoing_messages.empty();
+    }
+
+    const auto size = this->write_buffer.size() - LWS_PRE;
+    if (lws_write(wsi, this->write_buffer.data() + LWS_PRE, size, LWS_WRITE_TEXT) < static_cast<int>(size)) {
+        EVLOG_warning << "Local CSMS could not write a message of " << size << " bytes";
+    }
+
+    if (more_messages) {
+        lws_callback_on_writable(wsi);
+    }
+}
+
+void LocalCsms::on_wait_cancelled() {
+    const std::lock_guard lock(this->mutex);
+    if (this->connection != nullptr and !this->outgoing_messages.empty()) {
+        lws_callback_on_writable(this->connection);
+    }
+}
+
+void LocalCsms::handle_message(const std::string& message) {
+    json parsed;
+    try {
+        parsed = json::parse(message);
+        const auto message_type_id = static_cast<MessageTypeId>(parsed.at(0).get<int>());
+        const auto unique_id = parsed.at(1).get<std::string>();
+
+        if (message_type_id == MessageTypeId::CALL) {
+            const auto action = parsed.at(2).get<std::string>();
+            {
+                const std::lock_guard lock(this->mutex);
+                ++this->number_of_messages;
+                ++this->number_of_calls[action];
+            }
+            this->cv.notify_all();
+            this->handle_call(unique_id, action, parsed.at(3));
+            return;
+        }
+
+        std::unique_lock lock(this->mutex);
+        ++this->number_of_messages;
+        auto it = this->pending_calls.find(unique_id);
+        if (it == this->pending_calls.end()) {
+            EVLOG_warning << "Local CSMS received a response to an unknown call: " << unique_id;
+            return;
+        }
+        auto pending_call = std::move(it->second);
+        this->pending_calls.erase(it);
+        lock.unlock();
+
+        this->latencies.add(std::chrono::steady_clock::now() - pending_call.sent);
+        if (message_type_id == MessageTypeId::CALLRESULT) {
+            pending_call.promise.set_value(parsed.at(2));
+        } else {
+            pending_call.promise.set_exception(std::make_exception_ptr(
+                std::runtime_error(parsed.at(2).get<std::string>() + ": " + parsed.at(3).get<std::string>())));
+        }
+    } catch (const json::exception& e) {
+        EVLOG_warning << "Local CSMS received an invalid message: " << e.what();
+    }
+}
+
+void LocalCsms::handle_call(const std::string& unique_id, const std::string& action, const json& payload) {
+    CsmsRequestHandler handler;
+    {
+        const std::lock_guard lock(this->mutex);
+        const auto it = this->handlers.find(action);
+        if (it != this->handlers.end()) {
+            handler = it->second;
+        }
+    }
+
+    const auto response = handler ? handler(payload) : this->get_default_response(action);
+    auto message = json::array({static_cast<int>(MessageTypeId::CALLRESULT), unique_id, response.payload}).dump();
+
+    if (response.delay.count() <= 0) {
+        this->send(std::move(message));
+        return;
+    }
+
+    auto timer = std::make_shared<boost::asio::steady_timer>(this->executor->get_io_context(), response.delay);
+    timer->async_wait([this, timer, message = std::move(message)](const boost::system::error_code& error) mutable {
+        if (!error) {
+            this->send(std::move(message));
+        }
+    });
+}
+
+CsmsResponse LocalCsms::get_default_response(const std::string& action) {
+    const std::lock_guard lock(this->mutex);
+    const bool is_ocpp16 = this->ocpp_version == OCPP16;
+
+    CsmsResponse response{json::object(), this->default_response_delay};
+    if (action == "BootNotification") {
+        response.payload = {
+            {"currentTime", DateTime().to_rfc3339()}, {"interval", DEFAULT_HEARTBEAT_INTERVAL}, {"status", "Accepted"}};
+    } else if (action == "Heartbeat") {
+        response.payload = {{"currentTime", DateTime().to_rfc3339()}};
+    } else if (action == "Authorize") {
+        const json info = {{"status", "Accepted"}};
+        response.payload = is_ocpp16 ? json{{"idTagInfo", info}} : json{{"idTokenInfo", info}};
+    } else if (action == "StartTransaction") {
+        response.payload = {{"idTagInfo", {{"status", "Accepted"}}}, {"transactionId", ++this->transaction_id}};
+    } else if (action == "DataTransfer") {
+        response.payload = {{"status", "Accepted"}};
+    }
+    return response;
+}
+
+bool LocalCsms::send(std::string message) {
+    const std::lock_guard lock(this->mutex);
+    if (this->connection == nullptr or this->context == nullptr) {
+        return false;
+    }
+    this->outgoing_messages.push_back(std::move(message));
+    lws_cancel_service(this->context);
+    return true;
+}
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <ocpp/common/executor.hpp>
+
+#include "benchmark_report.hpp"
+
+struct lws;
+struct lws_context;
+
+namespace ocpp::benchmark {
+
+using json = nlohmann::json;
+
+/// \brief Response of the LocalCsms to a CALL of the charging station
+struct CsmsResponse {
+    json payload;
+    /// \brief Delay after which the CALLRESULT is sent
+    std::chrono::milliseconds delay{0};
+};
+
+/// \brief Creates the response to the payload of a CALL of the charging station
+using CsmsRequestHandler = std::function<CsmsResponse(const json& payload)>;
+
+/// \brief Lightweight CSMS stand-in for benchmarks, based on the libwebsockets server. It listens on localhost only,
+/// serves a single charging station at a time and answers its CALLs with scripted responses. Actions without a
+/// handler are answered with a minimal valid response for OCPP 1.6 and 2.0.1. Calls to the charging station can be
+/// sent with call(); their round trip time is recorded
+class LocalCsms {
+public:
+    /// \brief Creates a CSMS that listens on \p port, a free port is chosen if it is 0
+    explicit LocalCsms(std::uint16_t port = 0);
+    ~LocalCsms();
+
+    LocalCsms(const LocalCsms&) = delete;
+    LocalCsms& operator=(const LocalCsms&) = delete;
+
+    /// \brief Starts listening and the service thread
+    /// \throws std::runtime_error if the server could not be created
+    void start();
+    /// \brief Closes the connection and stops the service thread
+    void stop();
+
+    /// \returns the port the CSMS listens on, valid after start()
+    std::uint16_t get_port() const;
+    /// \returns the URL the charging station connects to, without the identity
+    std::string get_url() const;
+
+    /// \brief Sets the \p handler for the CALLs with \p action. Must be called before the charging station connects
+    void set_handler(const std::string& action, CsmsRequestHandler handler);
+    /// \brief Sets the delay for all responses that are created without a handler
+    void set_default_response_delay(std::chrono::milliseconds delay);
+    /// \brief Rejects new connections if \p accept is false, to simulate a CSMS that is not reachable
+    void set_accept_connections(bool accept);
+
+    /// \returns true if a charging station connected within \p timeout
+    bool wait_for_connection(std::chrono::milliseconds timeout);
+    /// \returns true if at least \p count CALLs with \p action were received within \p timeout
+    bool wait_for_calls(const std::string& action, std::size_t count, std::chrono::milliseconds timeout);
+
+    /// \returns the number of CALLs with \p action received from the charging station
+    std::size_t get_number_of_calls(const std::string& action) const;
+    /// \returns the number of all messages received from the charging station
+    std::size_t get_number_of_messages() const;
+
+    /// \brief Sends a CALL with \p action and \p payload to the charging station
+    /// \returns a future for the payload of the CALLRESULT. A CALLERROR or a closed connection sets an exception
+    std::future<json> call(const std::string& action, const json& payload);
+
+    /// \returns the round trip times of the calls sent with call()
+    LatencyRecorder& get_latencies();
+
+    /// \brief Resets the received message counters and the recorded latencies
+    void reset_statistics();
+
+    /// \name Called from the libwebsockets callback on the service thread
+    /// @{
+    bool is_accepting_connections() const;
+    void on_established(lws* wsi, const char* protocol);
+    void on_closed(lws* wsi);
+    void on_receive(lws* wsi, const char* data, std::size_t len, bool is_final);
+    void on_writeable(lws* wsi);
+    void on_wait_cancelled();
+    /// @}
+
+private:
+    struct PendingCall {
+        std::chrono::steady_clock::time_point sent;
+        std::promise<json> promise;
+    };
+
+    std::uint16_t port;
+    std::atomic_bool running;
+    std::atomic_bool accept_connections;
+    lws_context* context;
+    std::thread service_thread;
+    /// \brief Runs the timers of the delayed responses
+    std::shared_ptr<Executor> executor;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    lws* connection;
+    std::string ocpp_version;
+    std::string receive_buffer;
+    std::deque<std::string> outgoing_messages;
+    /// \brief Buffer for the message that is written, including the LWS_PRE bytes libwebsockets needs in front
+    std::vector<unsigned char> write_buffer;
+    std::map<std::string, PendingCall> pending_calls;
+    std::map<std::string, CsmsRequestHandler> handlers;
+    std::chrono::milliseconds default_response_delay;
+    std::map<std::string, std::size_t> number_of_calls;
+    std::size_t number_of_messages;
+    std::uint64_t message_id;
+    std::int32_t transaction_id;
+
+    LatencyRecorder latencies;
+
+    void handle_message(const std::string& message);
+    void handle_call(const std::string& unique_id, const std::string& action, const json& payload);
+    CsmsResponse get_default_response(const std::string& action);
+    /// \brief Queues \p message and wakes up the service thread to send it
+    /// \returns false if no charging station is connected
+    bool send(std::string message);
+};
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <everest/logging.hpp>
+
+#include "benchmark_report.hpp"
+#include "benchmark_scenarios.hpp"
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+using ocpp::benchmark::BenchmarkOptions;
+using ocpp::benchmark::Scenario;
+
+int main(int argc, char* argv[]) {
+    const std::map<std::string, Scenario> scenarios = {
+        {"v2_meter_values", ocpp::benchmark::run_v2_meter_values},
+        {"v2_offline_queue_drain", ocpp::benchmark::run_v2_offline_queue_drain},
+        {"v2_burst", ocpp::benchmark::run_v2_burst},
+        {"v2_multiple_stations", ocpp::benchmark::run_v2_multiple_stations},
+        {"v16_send_local_list", ocpp::benchmark::run_v16_send_local_list},
+        {"der_curve_evaluation", ocpp::benchmark::run_der_curve_evaluation},
+        {"database_encoding", ocpp::benchmark::run_database_encoding},
+    };
+
+    BenchmarkOptions options;
+    po::options_description desc("libocpp end to end benchmark against a local CSMS");
+
+    desc.add_options()("help,h", "produce help message");
+    desc.add_options()("scenario", po::value<std::vector<std::string>>(),
+                       "scenario to run, can be given multiple times. Runs all scenarios if not given");
+    desc.add_options()("configdir", po::value<std::string>()->default_value(LIBOCPP_BENCHMARK_CONFIG_DIR),
+                       "directory with the v16 and v2 configs of libocpp");
+    desc.add_options()("workdir", po::value<std::string>()->default_value("/tmp/libocpp_benchmark"),
+                       "directory in which the databases and configs of the charging stations are created");
+    desc.add_options()("logconf", po::value<std::string>(), "the path to a custom logging.ini");
+    desc.add_options()("evses", po::value<std::size_t>(&options.number_of_evses)->default_value(24),
+                       "number of EVSEs of the 2.0.1 charging station");
+    desc.add_options()("duration", po::value<int>()->default_value(30), "duration of v2_meter_values in seconds");
+    desc.add_options()("offline-transactions",
+                       po::value<std::size_t>(&options.number_of_offline_transactions)->default_value(200),
+                       "number of transactions of v2_offline_queue_drain");
+    desc.add_options()("burst-size", po::value<std::size_t>(&options.burst_size)->default_value(500),
+                       "number of GetVariables and SetChargingProfile calls of v2_burst");
+    desc.add_options()("stations", po::value<std::size_t>(&options.number_of_stations)->default_value(20),
+                       "number of charging stations of v2_multiple_stations");
+    desc.add_options()("local-list-size", po::value<std::size_t>(&options.local_list_size)->default_value(10000),
+                       "number of entries of the local authorization list of v16_send_local_list");
+    desc.add_options()("local-list-repetitions",
+                       po::value<std::size_t>(&options.local_list_repetitions)->default_value(10),
+                       "number of times v16_send_local_list sends the list");
+    desc.add_options()("der-curves", po::value<std::size_t>(&options.number_of_der_curves)->default_value(22),
+                       "number of DER curves of der_curve_evaluation");
+    desc.add_options()("der-updates", po::value<std::size_t>(&options.number_of_der_updates)->default_value(1000000),
+                       "number of meter value updates of der_curve_evaluation");
+    desc.add_options()("database-meter-values",
+                       po::value<std::size_t>(&options.number_of_database_meter_values)->default_value(3600),
+                       "number of meter values of database_encoding");
+    desc.add_options()("response-delay-ms", po::value<int>()->default_value(0),
+                       "delay of the CSMS before it responds to a call of the charging station");
+    desc.add_options()("timeout", po::value<int>()->default_value(120),
+                       "maximum time in seconds a scenario waits for the expected messages");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help") != 0) {
+        std::cout << desc << "\n";
+        std::cout << "Scenarios:\n";
+        for (const auto& [name, scenario] : scenarios) {
+            std::cout << "  " << name << "\n";
+        }
+        return 1;
+    }
+
+    options.config_dir = vm["configdir"].as<std::string>();
+    options.work_dir = vm["workdir"].as<std::string>();
+    options.duration = std::chrono::seconds(vm["duration"].as<int>());
+    options.response_delay = std::chrono::milliseconds(vm["response-delay-ms"].as<int>());
+    options.timeout = std::chrono::seconds(vm["timeout"].as<int>());
+
+    auto logging_config = options.config_dir / "logging.ini";
+    if (vm.count("logconf") != 0) {
+        logging_config = fs::path(vm["logconf"].as<std::string>());
+    }
+    Everest::Logging::init(logging_config.string(), "ocpp_benchmark");
+
+    std::vector<std::string> selected;
+    if (vm.count("scenario") != 0) {
+        selected = vm["scenario"].as<std::vector<std::string>>();
+    } else {
+        for (const auto& [name, scenario] : scenarios) {
+            selected.push_back(name);
+        }
+    }
+
+    std::vector<ocpp::benchmark::ScenarioResult> results;
+    for (const auto& name : selected) {
+        const auto it = scenarios.find(name);
+        if (it == scenarios.end()) {
+            std::cerr << "Unknown scenario: " << name << "\n";
+            return 1;
+        }
+        EVLOG_info << "Running scenario " << name;
+        results.push_back(it->second(options));
+    }
+
+    ocpp::benchmark::print_header(std::cout);
+    bool all_completed = true;
+    for (const auto& result : results) {
+        ocpp::benchmark::print_result(std::cout, result);
+        all_completed = all_completed and result.completed;
+    }
+
+    return all_completed ? 0 : 2;
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <everest/database/sqlite/connection.hpp>
+#include <everest/logging.hpp>
+
+#include <ocpp/v2/database_handler.hpp>
+
+#include "benchmark_scenarios.hpp"
+
+namespace ocpp::benchmark {
+
+namespace fs = std::filesystem;
+
+namespace {
+const std::string TRANSACTION_ID = "benchmark-transaction";
+constexpr std::int32_t NUMBER_OF_CHARGING_PROFILES = 100;
+constexpr std::int32_t PERIODS_PER_CHARGING_PROFILE = 24;
+
+struct EncodingResult {
+    std::uintmax_t database_size = 0;
+    std::chrono::duration<double> write_duration{0};
+    std::chrono::duration<double> read_duration{0};
+};
+
+v2::SampledValue create_sampled_value(const float value, const v2::MeasurandEnum measurand,
+                                      const std::optional<v2::PhaseEnum>& phase) {
+    v2::SampledValue sampled_value;
+    sampled_value.value = value;
+    sampled_value.measurand = measurand;
+    sampled_value.phase = phase;
+    sampled_value.context = v2::ReadingContextEnum::Sample_Periodic;
+    sampled_value.location = v2::LocationEnum::Outlet;
+    return sampled_value;
+}
+
+/// \brief Meter value as sampled once per second by an AC EVSE: energy, power and current and voltage per phase
+v2::MeterValue create_meter_value(const DateTime& timestamp, const std::size_t index) {
+    v2::MeterValue meter_value;
+    meter_value.timestamp = timestamp;
+    const auto energy = 1000.0F + (static_cast<float>(index) * 3.1F);
+    meter_value.sampledValue.push_back(
+        create_sampled_value(energy, v2::MeasurandEnum::Energy_Active_Import_Register, std::nullopt));
+    meter_value.sampledValue.push_back(
+        create_sampled_value(11040.0F, v2::MeasurandEnum::Power_Active_Import, std::nullopt));
+    const auto current = 16.0F - (static_cast<float>(index % 3) * 0.1F);
+    for (const auto phase : {v2::PhaseEnum::L1, v2::PhaseEnum::L2, v2::PhaseEnum::L3}) {
+        meter_value.sampledValue.push_back(create_sampled_value(current, v2::MeasurandEnum::Current_Import, phase));
+        meter_value.sampledValue.push_back(create_sampled_value(230.0F, v2::MeasurandEnum::Voltage, phase));
+    }
+    return meter_value;
+}
+
+v2::ChargingProfile create_charging_profile(const std::int32_t id) {
+    v2::ChargingSchedule schedule;
+    schedule.id = id;
+    schedule.chargingRateUnit = v2::ChargingRateUnitEnum::A;
+    for (std::int32_t period = 0; period < PERIODS_PER_CHARGING_PROFILE; period++) {
+        v2::ChargingSchedulePeriod charging_schedule_period;
+        charging_schedule_period.startPeriod = period * 3600;
+        charging_schedule_period.limit = 6.0F + static_cast<float>(period % 11);
+        charging_schedule_period.numberPhases = 3;
+        schedule.chargingSchedulePeriod.push_back(charging_schedule_period);
+    }
+
+    v2::ChargingProfile profile;
+    profile.id = id;
+    profile.stackLevel = id % 10;
+    profile.chargingProfilePurpose = v2::ChargingProfilePurposeEnum::TxDefaultProfile;
+    profile.chargingProfileKind = v2::ChargingProfileKindEnum::Recurring;
+    profile.recurrencyKind = v2::RecurrencyKindEnum::Daily;
+    profile.chargingSchedule = {schedule};
+    return profile;
+}
+
+/// \brief Writes the meter values of one transaction and the charging profiles into a new database and reads the
+/// meter values back
+EncodingResult run_encoding(const BenchmarkOptions& options, const fs::path& directory, const bool compact) {
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    const auto database_path = directory / "cp.db";
+
+    EncodingResult result;
+    {
+        v2::DatabaseHandler database_handler(std::make_unique<everest::db::sqlite::Connection>(database_path),
+                                             options.config_dir / "v2" / "core_migrations");
+        database_handler.open_connection();
+        database_handler.set_compact_encoding(compact);
+
+        const auto write_start = std::chrono::steady_clock::now();
+        const DateTime start;
+        for (std::size_t i = 0; i < options.number_of_database_meter_values; i++) {
+            database_handler.transaction_metervalues_insert(
+                TRANSACTION_ID,
+                create_meter_value(DateTime(start.to_time_point() + std::chrono::seconds(i)), i));
+        }
+        database_handler.transaction_metervalues_flush();
+        for (std::int32_t id = 1; id <= NUMBER_OF_CHARGING_PROFILES; id++) {
+            database_handler.insert_or_update_charging_profile(1, create_charging_profile(id));
+        }
+        result.write_duration = std::chrono::steady_clock::now() - write_start;
+
+        const auto read_start = std::chrono::steady_clock::now();
+        std::size_t number_of_read_values = 0;
+        database_handler.transaction_metervalues_for_each(
+            TRANSACTION_ID, [&number_of_read_values](v2::MeterValue&&) { number_of_read_values++; });
+        database_handler.get_all_charging_profiles_group_by_evse();
+        result.read_duration = std::chrono::steady_clock::now() - read_start;
+
+        if (number_of_read_values != options.number_of_database_meter_values) {
+            EVLOG_error << "Read " << number_of_read_values << " of " << options.number_of_database_meter_values
+                        << " meter values";
+        }
+        database_handler.close_connection();
+    }
+
+    result.database_size = fs::file_size(database_path);
+    return result;
+}
+} // namespace
+
+ScenarioResult run_database_encoding(const BenchmarkOptions& options) {
+    ScenarioResult result;
+    result.name = "database_encoding";
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto regular = run_encoding(options, options.work_dir / "database_encoding" / "regular", false);
+    const auto compact = run_encoding(options, options.work_dir / "database_encoding" / "compact", true);
+
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.after = ResourceUsage::now();
+    result.before = before;
+    result.number_of_messages = 2 * options.number_of_database_meter_values;
+    result.completed = true;
+
+    const auto to_kib = [](const std::uintmax_t bytes) { return static_cast<double>(bytes) / 1024.0; };
+    EVLOG_info << "Database with " << options.number_of_database_meter_values << " meter values and "
+               << NUMBER_OF_CHARGING_PROFILES << " charging profiles: regular encoding "
+               << to_kib(regular.database_size) << " KiB (write " << regular.write_duration.count() << " s, read "
+               << regular.read_duration.count() << " s), compact encoding " << to_kib(compact.database_size)
+               << " KiB (write " << compact.write_duration.count() << " s, read " << compact.read_duration.count()
+               << " s)";
+    return result;
+}
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <chrono>
+#include <vector>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/v2/der_curve_evaluator.hpp>
+
+#include "benchmark_scenarios.hpp"
+
+namespace ocpp::benchmark {
+
+ScenarioResult run_der_curve_evaluation(const BenchmarkOptions& options) {
+    // Volt-var like curves with 10 points, the maximum number of points of a DERCurve
+    std::vector<std::vector<v2::DERCurvePoints>> curves;
+    for (std::size_t i = 0; i < options.number_of_der_curves; i++) {
+        std::vector<v2::DERCurvePoints> points;
+        for (int point = 0; point < 10; point++) {
+            const auto x = 90.0F + (2.0F * static_cast<float>(point));
+            points.push_back({x, static_cast<float>((point * point) % 7) - static_cast<float>(i % 3)});
+        }
+        curves.push_back(points);
+    }
+    const v2::DERCurveEvaluator evaluator(curves);
+
+    std::vector<float> inputs(curves.size(), 100.0F);
+    std::vector<float> outputs;
+    float checksum = 0.0F;
+
+    ScenarioResult result;
+    result.name = "der_curve_evaluation";
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+
+    // Every update changes the measured value, as a new meter value would
+    for (std::size_t update = 0; update < options.number_of_der_updates; update++) {
+        const auto value = 88.0F + static_cast<float>(update % 240) * 0.1F;
+        for (auto& input : inputs) {
+            input = value;
+        }
+        evaluator.evaluate(inputs, outputs);
+        checksum += outputs.empty() ? 0.0F : outputs.back();
+    }
+
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.after = ResourceUsage::now();
+    result.before = before;
+    result.number_of_messages = options.number_of_der_updates;
+    result.completed = true;
+
+    if (options.number_of_der_updates > 0) {
+        const auto per_update = std::chrono::duration<double, std::nano>(result.duration).count() /
+                                static_cast<double>(options.number_of_der_updates);
+        EVLOG_info << "Evaluated " << curves.size() << " DER curves in " << per_update << " ns per update (checksum "
+                   << checksum << ")";
+    }
+    return result;
+}
+
+} // namespace ocpp::benchmark
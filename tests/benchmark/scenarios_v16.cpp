@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/v16/charge_point.hpp>
+
+#include "benchmark_scenarios.hpp"
+#include "charging_stations.hpp"
+#include "local_csms.hpp"
+
+namespace ocpp::benchmark {
+
+namespace {
+constexpr auto BOOT_TIMEOUT = std::chrono::seconds(30);
+
+json create_local_authorization_list(std::size_t size) {
+    auto list = json::array();
+    char id_tag[21];
+    for (std::size_t i = 0; i < size; i++) {
+        std::snprintf(id_tag, sizeof(id_tag), "TAG%08zu", i);
+        list.push_back({{"idTag", id_tag}, {"idTagInfo", {{"status", "Accepted"}}}});
+    }
+    return list;
+}
+} // namespace
+
+ScenarioResult run_v16_send_local_list(const BenchmarkOptions& options) {
+    LocalCsms csms;
+    csms.start();
+
+    const json config_patch = {{"LocalAuthListManagement",
+                                {{"LocalAuthListEnabled", true},
+                                 {"LocalAuthListMaxLength", options.local_list_size},
+                                 {"SendLocalListMaxLength", options.local_list_size}}}};
+    auto charge_point =
+        create_v16_charge_point(options, options.work_dir / "v16_send_local_list", csms.get_port(), config_patch);
+
+    ScenarioResult result;
+    result.name = "v16_send_local_list";
+    charge_point->start();
+    if (!csms.wait_for_calls("BootNotification", 1, BOOT_TIMEOUT)) {
+        EVLOG_error << "Charging station did not send a BootNotification";
+        return result;
+    }
+    // Gives the charging station the time to send its StatusNotifications, so they are not measured
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    json send_local_list = {{"updateType", "Full"},
+                            {"localAuthorizationList", create_local_authorization_list(options.local_list_size)}};
+
+    csms.reset_statistics();
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+
+    // The lists are sent one after another, so the round trip time is the time the charging station needs to store
+    // the list
+    result.completed = true;
+    for (std::size_t i = 1; i <= options.local_list_repetitions; i++) {
+        send_local_list["listVersion"] = i;
+        auto response = csms.call("SendLocalList", send_local_list);
+        if (response.wait_until(start + options.timeout) != std::future_status::ready) {
+            result.completed = false;
+            break;
+        }
+        try {
+            const auto status = response.get().at("status").get<std::string>();
+            if (status != "Accepted") {
+                EVLOG_warning << "SendLocalList was answered with " << status;
+            }
+        } catch (const std::exception& e) {
+            EVLOG_warning << "SendLocalList failed: " << e.what();
+        }
+    }
+
+    result.number_of_messages = csms.get_number_of_messages();
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.latency_p50 = csms.get_latencies().get_percentile(50);
+    result.latency_p99 = csms.get_latencies().get_percentile(99);
+    result.number_of_latencies = csms.get_latencies().size();
+    result.before = before;
+    result.after = ResourceUsage::now();
+
+    charge_point->stop();
+    csms.stop();
+    return result;
+}
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,379 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <everest/logging.hpp>
+
+#include <ocpp/v2/charge_point.hpp>
+
+#include "benchmark_scenarios.hpp"
+#include "charging_stations.hpp"
+#include "local_csms.hpp"
+
+namespace ocpp::benchmark {
+
+namespace {
+constexpr auto BOOT_TIMEOUT = std::chrono::seconds(30);
+constexpr auto TRANSACTION_EVENT = "TransactionEvent";
+constexpr auto ID_TOKEN = "BENCHMARK";
+
+/// \brief Measures the time from sending a TransactionEvent until its response was handled by the charging station
+class TransactionEventLatencies {
+public:
+    void on_sent(const v2::TransactionEventRequest& request) {
+        const std::lock_guard lock(this->mutex);
+        this->sent[get_key(request)] = std::chrono::steady_clock::now();
+    }
+
+    void on_response(const v2::TransactionEventRequest& request) {
+        std::chrono::steady_clock::time_point sent_at;
+        {
+            const std::lock_guard lock(this->mutex);
+            const auto it = this->sent.find(get_key(request));
+            // The callback for a sent message is called after it was queued, so the response can be first
+            if (it == this->sent.end()) {
+                return;
+            }
+            sent_at = it->second;
+            this->sent.erase(it);
+        }
+        this->latencies.add(std::chrono::steady_clock::now() - sent_at);
+    }
+
+    LatencyRecorder& get_latencies() {
+        return this->latencies;
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::chrono::steady_clock::time_point> sent;
+    LatencyRecorder latencies;
+
+    static std::string get_key(const v2::TransactionEventRequest& request) {
+        return request.transactionInfo.transactionId.get() + "/" + std::to_string(request.seqNo);
+    }
+};
+
+v2::MeterValue create_meter_value(float energy_wh, float power_w) {
+    v2::SampledValue energy;
+    energy.value = energy_wh;
+    energy.measurand = v2::MeasurandEnum::Energy_Active_Import_Register;
+
+    v2::SampledValue power;
+    power.value = power_w;
+    power.measurand = v2::MeasurandEnum::Power_Active_Import;
+
+    v2::MeterValue meter_value;
+    meter_value.sampledValue = {energy, power};
+    meter_value.timestamp = DateTime();
+    return meter_value;
+}
+
+v2::IdToken create_id_token() {
+    v2::IdToken id_token;
+    id_token.idToken = ID_TOKEN;
+    id_token.type = "Local";
+    return id_token;
+}
+
+void start_transaction(v2::ChargePoint& charge_point, std::int32_t evse_id, const std::string& session_id) {
+    charge_point.on_session_started(evse_id, 1);
+    charge_point.on_transaction_started(evse_id, 1, session_id, DateTime(), v2::TriggerReasonEnum::Authorized,
+                                        create_meter_value(0, 0), create_id_token(), std::nullopt, std::nullopt,
+                                        std::nullopt, v2::ChargingStateEnum::Charging);
+}
+
+void finish_transaction(v2::ChargePoint& charge_point, std::int32_t evse_id, float energy_wh) {
+    charge_point.on_transaction_finished(evse_id, DateTime(), create_meter_value(energy_wh, 0), v2::ReasonEnum::Local,
+                                         v2::TriggerReasonEnum::StopAuthorized, create_id_token(), std::nullopt,
+                                         v2::ChargingStateEnum::Idle);
+    charge_point.on_session_finished(evse_id, 1);
+}
+
+/// \brief Starts the charging station and waits until its BootNotification was accepted
+bool boot(v2::ChargePoint& charge_point, LocalCsms& csms) {
+    charge_point.start();
+    if (!csms.wait_for_calls("BootNotification", 1, BOOT_TIMEOUT)) {
+        EVLOG_error << "Charging station did not send a BootNotification";
+        return false;
+    }
+    // Gives the charging station the time to send its StatusNotifications, so they are not measured
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return true;
+}
+
+/// \brief Resource usage of the process before the stations were created and after they were booted
+struct StationsUsage {
+    ResourceUsage before;
+    ResourceUsage after;
+    bool booted = false;
+};
+
+/// \brief Creates and boots \p number_of_stations stations with one EVSE, each connected to its own CSMS. The
+/// stations share one executor if \p share_executor is true. The threads of the CSMSs are not part of the usage
+StationsUsage run_stations(const BenchmarkOptions& options, const std::filesystem::path& directory,
+                           std::size_t number_of_stations, bool share_executor) {
+    std::vector<std::unique_ptr<LocalCsms>> csms_list;
+    for (std::size_t i = 0; i < number_of_stations; i++) {
+        csms_list.push_back(std::make_unique<LocalCsms>());
+        csms_list.back()->start();
+    }
+
+    StationsUsage usage;
+    usage.before = ResourceUsage::now();
+
+    std::shared_ptr<Executor> executor;
+    if (share_executor) {
+        executor = std::make_shared<Executor>();
+    }
+    std::vector<std::unique_ptr<v2::ChargePoint>> charge_points;
+    for (std::size_t i = 0; i < number_of_stations; i++) {
+        charge_points.push_back(create_v2_charge_point(options, directory / ("station_" + std::to_string(i)),
+                                                       csms_list[i]->get_url(), 1, create_v2_callbacks(), {},
+                                                       executor));
+        charge_points.back()->start();
+    }
+
+    usage.booted = std::all_of(csms_list.begin(), csms_list.end(), [](const auto& csms) {
+        return csms->wait_for_calls("BootNotification", 1, BOOT_TIMEOUT);
+    });
+    // Gives the stations the time to send their StatusNotifications and start their websocket threads
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    usage.after = ResourceUsage::now();
+
+    for (auto& charge_point : charge_points) {
+        charge_point->stop();
+    }
+    charge_points.clear();
+    for (auto& csms : csms_list) {
+        csms->stop();
+    }
+    return usage;
+}
+
+void set_latencies(ScenarioResult& result, const LatencyRecorder& latencies) {
+    result.latency_p50 = latencies.get_percentile(50);
+    result.latency_p99 = latencies.get_percentile(99);
+    result.number_of_latencies = latencies.size();
+}
+} // namespace
+
+ScenarioResult run_v2_meter_values(const BenchmarkOptions& options) {
+    LocalCsms csms;
+    csms.set_default_response_delay(options.response_delay);
+    csms.start();
+
+    TransactionEventLatencies latencies;
+    auto callbacks = create_v2_callbacks();
+    callbacks.transaction_event_callback = [&latencies](const v2::TransactionEventRequest& request) {
+        latencies.on_sent(request);
+    };
+    callbacks.transaction_event_response_callback = [&latencies](const v2::TransactionEventRequest& request,
+                                                                 const v2::TransactionEventResponse&) {
+        latencies.on_response(request);
+    };
+
+    // Every running transaction sends a TransactionEvent(Updated) with the sampled meter values every second
+    auto charge_point = create_v2_charge_point(options, options.work_dir / "v2_meter_values", csms.get_url(),
+                                               options.number_of_evses, callbacks,
+                                               {{"SampledDataCtrlr", "TxUpdatedInterval", 1}});
+    ScenarioResult result;
+    result.name = "v2_meter_values";
+    if (!boot(*charge_point, csms)) {
+        return result;
+    }
+
+    const auto number_of_evses = static_cast<std::int32_t>(options.number_of_evses);
+    for (std::int32_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+        start_transaction(*charge_point, evse_id, "meter-values-" + std::to_string(evse_id));
+    }
+    csms.wait_for_calls(TRANSACTION_EVENT, options.number_of_evses, options.timeout);
+
+    csms.reset_statistics();
+    latencies.get_latencies().clear();
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+
+    auto next_sample = start;
+    float energy_wh = 0;
+    while (std::chrono::steady_clock::now() - start < options.duration) {
+        energy_wh += 3;
+        for (std::int32_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+            charge_point->on_meter_value(evse_id, create_meter_value(energy_wh, 11000));
+        }
+        next_sample += std::chrono::seconds(1);
+        std::this_thread::sleep_until(next_sample);
+    }
+
+    set_latencies(result, latencies.get_latencies());
+    result.completed = true;
+    result.number_of_messages = csms.get_number_of_calls(TRANSACTION_EVENT);
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.before = before;
+    result.after = ResourceUsage::now();
+
+    for (std::int32_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+        finish_transaction(*charge_point, evse_id, energy_wh);
+    }
+    charge_point->stop();
+    csms.stop();
+    return result;
+}
+
+ScenarioResult run_v2_offline_queue_drain(const BenchmarkOptions& options) {
+    LocalCsms csms;
+    csms.set_default_response_delay(options.response_delay);
+    csms.start();
+
+    auto charge_point = create_v2_charge_point(options, options.work_dir / "v2_offline_queue_drain", csms.get_url(),
+                                               options.number_of_evses, create_v2_callbacks(),
+                                               {{"OCPPCommCtrlr", "RetryBackOffRandomRange", 0}});
+    ScenarioResult result;
+    result.name = "v2_offline_queue_drain";
+    if (!boot(*charge_point, csms)) {
+        return result;
+    }
+
+    csms.set_accept_connections(false);
+    charge_point->disconnect_websocket();
+
+    // Every transaction queues a TransactionEvent(Started) and a TransactionEvent(Ended)
+    std::size_t number_of_transactions = 0;
+    while (number_of_transactions < options.number_of_offline_transactions) {
+        const auto remaining = options.number_of_offline_transactions - number_of_transactions;
+        const auto number_of_evses = static_cast<std::int32_t>(std::min(options.number_of_evses, remaining));
+        for (std::int32_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+            start_transaction(*charge_point, evse_id, "offline-" + std::to_string(number_of_transactions++));
+        }
+        for (std::int32_t evse_id = 1; evse_id <= number_of_evses; evse_id++) {
+            finish_transaction(*charge_point, evse_id, 1000);
+        }
+    }
+    const auto expected_messages = 2 * number_of_transactions;
+
+    csms.reset_statistics();
+    csms.set_accept_connections(true);
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+    charge_point->connect_websocket();
+
+    result.completed = csms.wait_for_calls(TRANSACTION_EVENT, expected_messages, options.timeout);
+    result.number_of_messages = csms.get_number_of_calls(TRANSACTION_EVENT);
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.before = before;
+    result.after = ResourceUsage::now();
+
+    charge_point->stop();
+    csms.stop();
+    return result;
+}
+
+ScenarioResult run_v2_burst(const BenchmarkOptions& options) {
+    LocalCsms csms;
+    csms.start();
+
+    auto charge_point = create_v2_charge_point(options, options.work_dir / "v2_burst", csms.get_url(),
+                                               options.number_of_evses, create_v2_callbacks(), {});
+    ScenarioResult result;
+    result.name = "v2_burst";
+    if (!boot(*charge_point, csms)) {
+        return result;
+    }
+
+    const json get_variables = {
+        {"getVariableData",
+         {{{"component", {{"name", "OCPPCommCtrlr"}}}, {"variable", {{"name", "HeartbeatInterval"}}}},
+          {{"component", {{"name", "SampledDataCtrlr"}}}, {"variable", {{"name", "TxUpdatedInterval"}}}},
+          {{"component", {{"name", "SmartChargingCtrlr"}}}, {"variable", {{"name", "Enabled"}}}},
+          {{"component", {{"name", "SecurityCtrlr"}}}, {"variable", {{"name", "SecurityProfile"}}}}}}};
+    const json set_charging_profile = {
+        {"evseId", 0},
+        {"chargingProfile",
+         {{"id", 1},
+          {"stackLevel", 0},
+          {"chargingProfilePurpose", "TxDefaultProfile"},
+          {"chargingProfileKind", "Absolute"},
+          {"chargingSchedule",
+           {{{"id", 1},
+             {"startSchedule", DateTime().to_rfc3339()},
+             {"chargingRateUnit", "A"},
+             {"chargingSchedulePeriod", {{{"startPeriod", 0}, {"limit", 16.0}}}}}}}}}};
+
+    csms.reset_statistics();
+    const auto before = ResourceUsage::now();
+    const auto start = std::chrono::steady_clock::now();
+
+    // All calls are queued at once, the charging station handles them in the order they are received
+    std::vector<std::future<json>> responses;
+    responses.reserve(2 * options.burst_size);
+    for (std::size_t i = 0; i < options.burst_size; i++) {
+        responses.push_back(csms.call("GetVariables", get_variables));
+        responses.push_back(csms.call("SetChargingProfile", set_charging_profile));
+    }
+
+    result.completed = true;
+    const auto deadline = start + options.timeout;
+    for (auto& response : responses) {
+        if (response.wait_until(deadline) != std::future_status::ready) {
+            result.completed = false;
+            break;
+        }
+        try {
+            response.get();
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Call in burst failed: " << e.what();
+        }
+    }
+
+    set_latencies(result, csms.get_latencies());
+    result.number_of_messages = csms.get_number_of_messages();
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.before = before;
+    result.after = ResourceUsage::now();
+
+    charge_point->stop();
+    csms.stop();
+    return result;
+}
+
+ScenarioResult run_v2_multiple_stations(const BenchmarkOptions& options) {
+    ScenarioResult result;
+    result.name = "v2_multiple_stations";
+    const auto number_of_stations = options.number_of_stations;
+    const auto directory = options.work_dir / "v2_multiple_stations";
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto own = run_stations(options, directory / "own_executors", number_of_stations, false);
+    const auto shared = run_stations(options, directory / "shared_executor", number_of_stations, true);
+
+    result.duration = std::chrono::steady_clock::now() - start;
+    result.completed = own.booted and shared.booted;
+    result.number_of_messages = 2 * number_of_stations;
+    result.before = shared.before;
+    result.after = shared.after;
+
+    const auto per_station = [number_of_stations](const StationsUsage& usage) {
+        const auto threads = static_cast<double>(usage.after.number_of_threads) -
+                             static_cast<double>(usage.before.number_of_threads);
+        const auto rss_kib =
+            (static_cast<double>(usage.after.rss_bytes) - static_cast<double>(usage.before.rss_bytes)) / 1024.0;
+        const auto stations = static_cast<double>(number_of_stations);
+        return std::to_string(threads / stations) + " threads and " + std::to_string(rss_kib / stations) +
+               " KiB RSS";
+    };
+    EVLOG_info << number_of_stations << " connected stations, per station: own executors " << per_station(own)
+               << ", shared executor " << per_station(shared);
+    return result;
+}
+
+} // namespace ocpp::benchmark
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <ocpp/common/call_types.hpp>
+
+using namespace ocpp;
+
+TEST(MessageIdTest, CreateMessageIdIsVersion4Uuid) {
+    for (int i = 0; i < 100; ++i) {
+        const auto message_id = create_message_id().get();
+        EXPECT_THAT(message_id,
+                    testing::MatchesRegex("^[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$"));
+    }
+}
+
+TEST(MessageIdTest, CreateMessageIdIsUniqueAcrossThreads) {
+    constexpr int thread_count = 8;
+    constexpr int ids_per_thread = 10000;
+
+    std::mutex ids_mutex;
+    std::set<std::string> ids;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            std::vector<std::string> local_ids;
+            local_ids.reserve(ids_per_thread);
+            for (int i = 0; i < ids_per_thread; ++i) {
+                local_ids.push_back(create_message_id().get());
+            }
+            const std::lock_guard<std::mutex> lock(ids_mutex);
+            ids.insert(local_ids.begin(), local_ids.end());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(ids.size(), thread_count * ids_per_thread);
+}
+
+TEST(MessageIdTest, FromTrusted) {
+    const auto message_id = MessageId::from_trusted("1234");
+    EXPECT_EQ(message_id.get(), "1234");
+    EXPECT_EQ(message_id, MessageId("1234"));
+}
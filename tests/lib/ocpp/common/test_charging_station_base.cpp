@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <everest/timer.hpp>
+
+#include <ocpp/common/charging_station_base.hpp>
+
+#include "evse_security_mock.hpp"
+
+using namespace ocpp;
+
+namespace {
+/// \brief Charging station with a timer whose handler accesses members that are destroyed with the charging station
+class TimerChargingStation : public ChargingStationBase {
+public:
+    TimerChargingStation(const std::shared_ptr<EvseSecurity>& evse_security, std::shared_ptr<Executor> executor,
+                         std::atomic<int>& fired) :
+        ChargingStationBase(evse_security, std::nullopt, std::move(executor)),
+        fired(fired),
+        timer(&this->io_context, [this]() { this->on_timer(); }) {
+        this->timer.interval(std::chrono::milliseconds(1));
+    }
+
+    ~TimerChargingStation() override {
+        this->stop_timers_on_executor([this]() { this->timer.stop(); });
+    }
+
+private:
+    void on_timer() {
+        this->samples.push_back(this->fired.fetch_add(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    std::atomic<int>& fired;
+    std::vector<int> samples;
+    Everest::SteadyTimer timer;
+};
+
+void wait_for_timer(const std::atomic<int>& fired) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (fired < 3 and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_GE(fired, 3);
+}
+} // namespace
+
+TEST(ChargingStationBaseTest, DestructionWhileTimerIsPendingOnSharedExecutor) {
+    const auto executor = std::make_shared<Executor>();
+    const auto evse_security = std::make_shared<::testing::NiceMock<EvseSecurityMock>>();
+    std::atomic<int> fired{0};
+
+    auto charging_station = std::make_unique<TimerChargingStation>(evse_security, executor, fired);
+    wait_for_timer(fired);
+    charging_station.reset();
+    const int fired_at_destruction = fired;
+
+    // The shared executor keeps running the handlers of other components
+    std::promise<void> done;
+    executor->post([&done]() { done.set_value(); });
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(fired, fired_at_destruction);
+}
+
+TEST(ChargingStationBaseTest, DestructionWhileTimerIsPendingOnOwnExecutor) {
+    const auto evse_security = std::make_shared<::testing::NiceMock<EvseSecurityMock>>();
+    std::atomic<int> fired{0};
+
+    auto charging_station = std::make_unique<TimerChargingStation>(evse_security, nullptr, fired);
+    wait_for_timer(fired);
+    charging_station.reset();
+    const int fired_at_destruction = fired;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(fired, fired_at_destruction);
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <ocpp/common/compact_encoding.hpp>
+
+using namespace ocpp;
+using namespace ocpp::compact_encoding;
+
+namespace {
+json create_profile(const json& periods) {
+    return json{{"chargingProfileId", 1},
+                {"stackLevel", 0},
+                {"chargingProfilePurpose", "TxDefaultProfile"},
+                {"chargingProfileKind", "Absolute"},
+                {"chargingSchedule", {{"chargingRateUnit", "A"}, {"chargingSchedulePeriod", periods}}}};
+}
+} // namespace
+
+TEST(CompactEncodingTest, NumbersRoundTrip) {
+    const std::vector<float> floats = {0.0F,
+                                       -0.0F,
+                                       16.0F,
+                                       -32.0F,
+                                       0.1F,
+                                       230.45F,
+                                       1e20F,
+                                       std::numeric_limits<float>::min(),
+                                       std::numeric_limits<float>::infinity()};
+
+    std::string encoded;
+    append_int(encoded, -1234567890123);
+    for (const auto value : floats) {
+        encoded += ',';
+        append_float(encoded, value);
+    }
+    encoded += ',';
+    append_float(encoded, std::numeric_limits<float>::quiet_NaN());
+    encoded += ',';
+
+    Reader reader(encoded);
+    EXPECT_EQ(reader.read_int(), -1234567890123);
+    for (const auto value : floats) {
+        reader.expect(',');
+        const auto decoded = reader.read_float();
+        EXPECT_EQ(decoded, value);
+        EXPECT_EQ(std::signbit(decoded), std::signbit(value));
+    }
+    reader.expect(',');
+    EXPECT_TRUE(std::isnan(reader.read_float()));
+    reader.expect(',');
+    EXPECT_FALSE(reader.read_optional_int().has_value());
+    EXPECT_TRUE(reader.at_end());
+}
+
+TEST(CompactEncodingTest, IntegralFloatsAreWrittenInDecimal) {
+    std::string encoded;
+    append_float(encoded, 16.0F);
+    EXPECT_EQ(encoded, "16");
+}
+
+TEST(CompactEncodingTest, MalformedInputThrows) {
+    Reader invalid_number("12a");
+    EXPECT_THROW(invalid_number.read_int(), DecodeException);
+
+    Reader missing_value(",");
+    EXPECT_THROW(missing_value.read_int(), DecodeException);
+
+    Reader missing_separator("1");
+    missing_separator.read_int();
+    EXPECT_THROW(missing_separator.expect(','), DecodeException);
+}
+
+TEST(CompactEncodingTest, ChargingProfileRoundTrip) {
+    const json periods = json::array({{{"startPeriod", 0}, {"limit", 16.0}, {"numberPhases", 3}},
+                                      {{"startPeriod", 1800}, {"limit", 10.5}},
+                                      {{"startPeriod", 3600}, {"limit", 32.0}, {"phaseToUse", 2}}});
+    const auto profile = create_profile(periods);
+
+    const auto encoded = encode_charging_profile(profile);
+    EXPECT_EQ(encoded.front(), CHARGING_PROFILE_ENCODING_V1);
+    EXPECT_LT(encoded.size(), profile.dump().size());
+
+    const auto decoded = decode_charging_profile(encoded);
+    ASSERT_EQ(decoded.schedule_periods.size(), 1);
+    ASSERT_TRUE(decoded.schedule_periods.at(0).has_value());
+    EXPECT_TRUE(decoded.profile.at("chargingSchedule").at("chargingSchedulePeriod").empty());
+
+    const auto& decoded_periods = decoded.schedule_periods.at(0).value();
+    ASSERT_EQ(decoded_periods.size(), 3);
+    EXPECT_EQ(decoded_periods.at(0).start_period, 0);
+    EXPECT_EQ(decoded_periods.at(0).limit, 16.0F);
+    EXPECT_EQ(decoded_periods.at(0).number_phases, 3);
+    EXPECT_FALSE(decoded_periods.at(0).phase_to_use.has_value());
+    EXPECT_EQ(decoded_periods.at(1).start_period, 1800);
+    EXPECT_EQ(decoded_periods.at(1).limit, 10.5F);
+    EXPECT_FALSE(decoded_periods.at(1).number_phases.has_value());
+    EXPECT_EQ(decoded_periods.at(2).phase_to_use, 2);
+
+    auto expected_head = profile;
+    expected_head["chargingSchedule"]["chargingSchedulePeriod"] = json::array();
+    EXPECT_EQ(decoded.profile, expected_head);
+}
+
+TEST(CompactEncodingTest, ChargingProfileWithOtherPeriodFieldsKeepsJson) {
+    const json periods = json::array({{{"startPeriod", 0}, {"limit", 16.0}, {"setpoint", 11000.0}}});
+    const auto profile = create_profile(periods);
+
+    const auto decoded = decode_charging_profile(encode_charging_profile(profile));
+    EXPECT_TRUE(decoded.schedule_periods.empty());
+    EXPECT_EQ(decoded.profile, profile);
+}
+
+TEST(CompactEncodingTest, PlainJsonChargingProfileIsDecoded) {
+    const auto profile = create_profile(json::array({{{"startPeriod", 0}, {"limit", 16.0}}}));
+
+    const auto decoded = decode_charging_profile(profile.dump());
+    EXPECT_TRUE(decoded.schedule_periods.empty());
+    EXPECT_EQ(decoded.profile, profile);
+}
+
+TEST(CompactEncodingTest, UnknownChargingProfileEncodingThrows) {
+    EXPECT_THROW(decode_charging_profile("9{}"), DecodeException);
+    EXPECT_THROW(decode_charging_profile(""), DecodeException);
+}
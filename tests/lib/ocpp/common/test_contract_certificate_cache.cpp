@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <ocpp/common/contract_certificate_cache.hpp>
+
+#include "evse_security_mock.hpp"
+
+using namespace ocpp;
+using ::testing::_;
+using ::testing::Return;
+
+namespace {
+// Self signed, valid from 2020-01-01 until 2126
+const std::string CONTRACT_A =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIBGTCBv6ADAgECAgEBMAoGCCqGSM49BAMCMBUxEzARBgNVBAMMCkNPTlRSQUNU\n"
+    "X0EwIBcNMjAwMTAxMDAwMDAwWhgPMjEyNjA5MjQxMzExMjNaMBUxEzARBgNVBAMM\n"
+    "CkNPTlRSQUNUX0EwWTATBgcqhkjOPQIBBggqhkjOPQMBBwNCAATLQuEVxaujJDhC\n"
+    "7M5DWOpI3cEbQuevatxAsxbv2FDQSvFPHxHJwGaupfZJGNuP2KNnSCQyFmjZjQfi\n"
+    "wgYFmemAMAoGCCqGSM49BAMCA0kAMEYCIQCvKZ0OUeepcqWhnUUSToBzbtHDN5ps\n"
+    "aeozpiPY3ZC4UgIhAISthy/VAF/kbhoScbHP7eEw7MRytU6kW/v0CDrBCuBb\n"
+    "-----END CERTIFICATE-----\n";
+
+// Self signed, valid from 2020-01-01 until 2126
+const std::string CONTRACT_B =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIBGDCBv6ADAgECAgEBMAoGCCqGSM49BAMCMBUxEzARBgNVBAMMCkNPTlRSQUNU\n"
+    "X0IwIBcNMjAwMTAxMDAwMDAwWhgPMjEyNjA5MjQxMzExMjNaMBUxEzARBgNVBAMM\n"
+    "CkNPTlRSQUNUX0IwWTATBgcqhkjOPQIBBggqhkjOPQMBBwNCAAQFHO8mDA5iaAyD\n"
+    "+JgM5Lk2RBrPfHtGJlgVJUoYgSgwZAX7V+Tt6Wg/nMFs1kF454/9T1mJ9oDgdTvR\n"
+    "5gzQZJLyMAoGCCqGSM49BAMCA0gAMEUCIQDxNkuILINqGpTElvYGdUI//bPdrI7q\n"
+    "+ex4EtOI/FHU/gIgN1RDR6E0dAe7LePx2Jfz4er3oGeo5NNmgpuXHyI+NAs=\n"
+    "-----END CERTIFICATE-----\n";
+
+// Self signed, expired on 2021-01-01
+const std::string CONTRACT_EXPIRED =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIBIzCByaADAgECAgEBMAoGCCqGSM49BAMCMBsxGTAXBgNVBAMMEENPTlRSQUNU\n"
+    "X0VYUElSRUQwHhcNMjAwMTAxMDAwMDAwWhcNMjEwMTAxMDAwMDAwWjAbMRkwFwYD\n"
+    "VQQDDBBDT05UUkFDVF9FWFBJUkVEMFkwEwYHKoZIzj0CAQYIKoZIzj0DAQcDQgAE\n"
+    "p9Rr9Y80SWfxE3uuPZn6QRVFF2iSQswnnjl6jcAkgadEXLN2xj+jskkhURItjVTM\n"
+    "atEfAGjkHJk0azyvcoYbyTAKBggqhkjOPQQDAgNJADBGAiEAmYp+isbaVL7RnhYE\n"
+    "50ei+n7GH24IZH/cuHHL+CgVAeYCIQDKsF7guwmTvJo3SgeJN/RW/nnbqsUtkZxt\n"
+    "BJYFny87lQ==\n"
+    "-----END CERTIFICATE-----\n";
+
+const std::vector<LeafCertificateType> CONTRACT_TYPES{LeafCertificateType::MO, LeafCertificateType::V2G};
+
+OCSPRequestData create_ocsp_request_data(const std::string& serial_number) {
+    OCSPRequestData ocsp_request_data;
+    ocsp_request_data.hashAlgorithm = HashAlgorithmEnumType::SHA256;
+    ocsp_request_data.issuerNameHash = "name_hash";
+    ocsp_request_data.issuerKeyHash = "key_hash";
+    ocsp_request_data.serialNumber = serial_number;
+    ocsp_request_data.responderUrl = "http://ocsp.example.com";
+    return ocsp_request_data;
+}
+} // namespace
+
+TEST(ContractCertificateCacheTest, VerificationResultIsCachedPerChainAndTypes) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security);
+
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, CONTRACT_TYPES))
+        .WillOnce(Return(CertificateValidationResult::Valid));
+    const std::vector<LeafCertificateType> mo_type{LeafCertificateType::MO};
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, mo_type))
+        .WillOnce(Return(CertificateValidationResult::IssuerNotFound));
+
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, mo_type), CertificateValidationResult::IssuerNotFound);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, mo_type), CertificateValidationResult::IssuerNotFound);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(ContractCertificateCacheTest, FailedVerificationIsOnlyCachedForTheNegativeTtl) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security, DEFAULT_CONTRACT_CERTIFICATE_CACHE_SIZE, std::chrono::seconds(0));
+
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, CONTRACT_TYPES))
+        .WillOnce(Return(CertificateValidationResult::Valid));
+    const std::vector<LeafCertificateType> mo_type{LeafCertificateType::MO};
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, mo_type))
+        .WillOnce(Return(CertificateValidationResult::IssuerNotFound))
+        .WillOnce(Return(CertificateValidationResult::Valid));
+
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, mo_type), CertificateValidationResult::IssuerNotFound);
+    // The failed verification has expired, the successful one is still cached
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, mo_type), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, mo_type), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+}
+
+TEST(ContractCertificateCacheTest, OcspRequestDataIsCached) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security);
+
+    const std::vector<OCSPRequestData> ocsp_request_data{create_ocsp_request_data("01")};
+    EXPECT_CALL(evse_security, get_mo_ocsp_request_data(CONTRACT_A)).WillOnce(Return(ocsp_request_data));
+    // Empty OCSP request data is not cached
+    EXPECT_CALL(evse_security, get_mo_ocsp_request_data(CONTRACT_B))
+        .Times(2)
+        .WillRepeatedly(Return(std::vector<OCSPRequestData>{}));
+
+    for (int i = 0; i < 2; i++) {
+        const auto result = cache.get_mo_ocsp_request_data(CONTRACT_A);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result.at(0).serialNumber, "01");
+        EXPECT_TRUE(cache.get_mo_ocsp_request_data(CONTRACT_B).empty());
+    }
+}
+
+TEST(ContractCertificateCacheTest, ChainsWithoutValidityAreNotCached) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security);
+
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_EXPIRED, CONTRACT_TYPES))
+        .Times(2)
+        .WillRepeatedly(Return(CertificateValidationResult::Expired));
+    EXPECT_CALL(evse_security, verify_certificate("not a certificate", CONTRACT_TYPES))
+        .Times(2)
+        .WillRepeatedly(Return(CertificateValidationResult::InvalidChain));
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, CONTRACT_TYPES))
+        .Times(2)
+        .WillRepeatedly(Return(CertificateValidationResult::Unknown));
+
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(cache.verify_certificate(CONTRACT_EXPIRED, CONTRACT_TYPES), CertificateValidationResult::Expired);
+        EXPECT_EQ(cache.verify_certificate("not a certificate", CONTRACT_TYPES),
+                  CertificateValidationResult::InvalidChain);
+        // Unknown results are not cached either, they might be caused by a temporary error
+        EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Unknown);
+    }
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(ContractCertificateCacheTest, ClearRemovesAllEntries) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security);
+
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, CONTRACT_TYPES))
+        .WillOnce(Return(CertificateValidationResult::IssuerNotFound))
+        .WillOnce(Return(CertificateValidationResult::Valid));
+
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::IssuerNotFound);
+    // E.g. the contract root was installed
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+    EXPECT_EQ(cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES), CertificateValidationResult::Valid);
+}
+
+TEST(ContractCertificateCacheTest, LeastRecentlyUsedChainIsEvicted) {
+    ::testing::StrictMock<EvseSecurityMock> evse_security;
+    ContractCertificateCache cache(evse_security, 1);
+
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_A, CONTRACT_TYPES))
+        .Times(2)
+        .WillRepeatedly(Return(CertificateValidationResult::Valid));
+    EXPECT_CALL(evse_security, verify_certificate(CONTRACT_B, CONTRACT_TYPES))
+        .WillOnce(Return(CertificateValidationResult::Valid));
+
+    cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES);
+    cache.verify_certificate(CONTRACT_B, CONTRACT_TYPES);
+    cache.verify_certificate(CONTRACT_B, CONTRACT_TYPES);
+    EXPECT_EQ(cache.size(), 1);
+    cache.verify_certificate(CONTRACT_A, CONTRACT_TYPES);
+}
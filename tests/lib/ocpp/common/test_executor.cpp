@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <everest/timer.hpp>
+
+#include <ocpp/common/executor.hpp>
+
+using namespace ocpp;
+
+TEST(ExecutorTest, PostedHandlersAreRun) {
+    Executor executor{1};
+    EXPECT_EQ(executor.get_number_of_threads(), 1);
+
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    executor.post([&promise]() { promise.set_value(); });
+
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+TEST(ExecutorTest, ThrowingHandlerDoesNotStopExecutor) {
+    Executor executor{1};
+
+    executor.post([]() { throw std::runtime_error("handler failed"); });
+
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    executor.post([&promise]() { promise.set_value(); });
+
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+TEST(ExecutorTest, TimersShareExecutor) {
+    auto executor = std::make_shared<Executor>(1);
+
+    std::promise<void> first;
+    std::promise<void> second;
+    Everest::SteadyTimer first_timer{&executor->get_io_context(), [&first]() { first.set_value(); }};
+    Everest::SteadyTimer second_timer{&executor->get_io_context(), [&second]() { second.set_value(); }};
+
+    first_timer.timeout(std::chrono::milliseconds(10));
+    second_timer.timeout(std::chrono::milliseconds(20));
+
+    EXPECT_EQ(first.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(second.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+TEST(ExecutorTest, DefaultExecutorIsShared) {
+    EXPECT_EQ(Executor::get_default(), Executor::get_default());
+    EXPECT_EQ(Executor::get_default()->get_number_of_threads(), Executor::DEFAULT_NUMBER_OF_THREADS);
+}
+
+TEST(ExecutorTest, DefaultExecutorRunsHandlersOneAfterAnother) {
+    Executor executor;
+
+    std::atomic<int> running{0};
+    std::atomic<bool> overlapped{false};
+    std::promise<void> done;
+    const auto handler = [&running, &overlapped]() {
+        if (running.fetch_add(1) != 0) {
+            overlapped = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        running.fetch_sub(1);
+    };
+
+    executor.post(handler);
+    executor.post(handler);
+    executor.post([&done]() { done.set_value(); });
+
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_FALSE(overlapped);
+}
+
+TEST(ExecutorTest, RunAndWaitRunsAfterTheRunningHandler) {
+    Executor executor;
+
+    std::atomic<bool> first_done{false};
+    std::promise<void> first_started;
+    executor.post([&first_done, &first_started]() {
+        first_started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        first_done = true;
+    });
+    first_started.get_future().wait();
+
+    bool ran_after_first = false;
+    executor.run_and_wait([&first_done, &ran_after_first]() { ran_after_first = first_done; });
+    EXPECT_TRUE(ran_after_first);
+}
+
+TEST(ExecutorTest, RunAndWaitRunsDirectlyOnStoppedExecutor) {
+    Executor executor;
+    executor.stop();
+
+    bool ran = false;
+    executor.run_and_wait([&ran]() { ran = true; });
+    EXPECT_TRUE(ran);
+}
+
+TEST(ExecutorTest, RunAndWaitRethrowsExceptions) {
+    Executor executor;
+    EXPECT_THROW(executor.run_and_wait([]() { throw std::runtime_error("handler failed"); }), std::runtime_error);
+}
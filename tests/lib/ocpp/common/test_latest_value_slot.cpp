@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <ocpp/common/latest_value_slot.hpp>
+
+using namespace ocpp;
+
+TEST(LatestValueSlotTest, OnlyLatestValueIsConsumed) {
+    LatestValueSlot<std::vector<int>> slot;
+    std::vector<int> value;
+
+    EXPECT_FALSE(slot.has_value());
+    EXPECT_FALSE(slot.consume(value));
+
+    EXPECT_FALSE(slot.publish({1}));
+    EXPECT_TRUE(slot.publish({2}));
+    EXPECT_TRUE(slot.has_value());
+
+    ASSERT_TRUE(slot.consume(value));
+    EXPECT_EQ(value, std::vector<int>{2});
+    EXPECT_FALSE(slot.has_value());
+    EXPECT_FALSE(slot.consume(value));
+
+    EXPECT_FALSE(slot.publish({3}));
+    ASSERT_TRUE(slot.consume(value));
+    EXPECT_EQ(value, std::vector<int>{3});
+}
+
+TEST(LatestValueSlotTest, ConcurrentProducerAndConsumer) {
+    constexpr int COUNT = 100000;
+    LatestValueSlot<std::vector<int>> slot;
+
+    std::thread producer([&slot]() {
+        for (int i = 1; i <= COUNT; ++i) {
+            slot.publish(std::vector<int>(4, i));
+        }
+    });
+
+    // Every consumed value must be complete and newer than the previous one
+    int last = 0;
+    std::vector<int> value;
+    while (last < COUNT) {
+        if (slot.consume(value)) {
+            ASSERT_EQ(value.size(), 4);
+            ASSERT_EQ(value.front(), value.back());
+            ASSERT_GT(value.front(), last);
+            last = value.front();
+        }
+    }
+
+    producer.join();
+    EXPECT_FALSE(slot.consume(value));
+}
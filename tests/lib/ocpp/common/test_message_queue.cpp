@@ -5,6 +5,45 @@
 #include <nlohmann/json.hpp>
 #include <ocpp/common/message_queue.hpp>
 
+#include <cstdlib>
+#include <new>
+
+/************************************************************************************************
+ * Allocation counting
+ */
+
+namespace {
+thread_local bool count_allocations = false;
+thread_local std::size_t allocation_count = 0;
+
+/// \returns the number of allocations \p function makes on the calling thread
+template <typename F> std::size_t count_allocations_of(F&& function) {
+    allocation_count = 0;
+    count_allocations = true;
+    function();
+    count_allocations = false;
+    return allocation_count;
+}
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (count_allocations) {
+        allocation_count++;
+    }
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+    std::free(pointer);
+}
+
 namespace ocpp {
 
 using json = nlohmann::json;
@@ -480,4 +519,48 @@ TEST_F(MessageQueueTest, test_clean_up_transactional_queue) {
     wait_for_calls(expected_sent_messages);
 }
 
+// \brief Test that a received CALL is parsed once and shared instead of copied on its way to the handler
+TEST_F(MessageQueueTest, test_received_call_is_not_copied) {
+    json payload{{"data", "a string that does not fit into the small string buffer"}};
+    for (int i = 0; i < 100; i++) {
+        payload["padding"].push_back({{"index", i}, {"value", "padding that is never read by the handler"}});
+    }
+    const auto message = json{2, "0", "non_transactional", payload}.dump();
+
+    const auto parse_allocations = count_allocations_of([&message]() { const auto parsed = json::parse(message); });
+
+    EnhancedMessage<TestMessageType> enhanced_message;
+    const auto receive_allocations = count_allocations_of(
+        [this, &message, &enhanced_message]() { enhanced_message = this->message_queue->receive(message); });
+    // besides the parsed json only the shared pointer to it and the message type string are allocated
+    EXPECT_LE(receive_allocations, parse_allocations + 4);
+    EXPECT_EQ(enhanced_message.messageType, TestMessageType::NON_TRANSACTIONAL);
+
+    const auto copy_allocations = count_allocations_of([&enhanced_message]() { const auto copy = enhanced_message; });
+    EXPECT_EQ(copy_allocations, 0);
+
+    Call<TestRequest> call;
+    const auto materialize_allocations =
+        count_allocations_of([&enhanced_message, &call]() { call = *enhanced_message.message; });
+    // only the data of the typed request is allocated, the json is not copied
+    EXPECT_LE(materialize_allocations, 2);
+    EXPECT_EQ(call.msg.data, "a string that does not fit into the small string buffer");
+}
+
+// \brief Test that the response of an async call carries the original call
+TEST_F(MessageQueueTest, test_call_result_contains_call_message) {
+    EXPECT_CALL(send_callback_mock, Call(testing::_)).WillOnce(MarkAndReturn(true, true));
+
+    Call<TestRequest> call;
+    call.msg.type = TestMessageType::NON_TRANSACTIONAL;
+    call.msg.data = "test_data";
+    call.uniqueId = "0";
+    auto future = message_queue->push_call_async(call);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(3)), std::future_status::ready);
+    const auto enhanced_message = future.get();
+    EXPECT_EQ(enhanced_message.messageType, TestMessageType::NON_TRANSACTIONAL_RESPONSE);
+    EXPECT_EQ(*enhanced_message.call_message, json(call));
+}
+
 } // namespace ocpp
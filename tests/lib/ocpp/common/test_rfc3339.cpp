@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include <ocpp/common/rfc3339.hpp>
+#include <ocpp/common/types.hpp>
+
+using namespace ocpp;
+
+namespace {
+// Characters that are likely to produce almost valid timestamps when mutating one
+const std::string MUTATION_CHARACTERS = "0123456789-+:.TZz t";
+
+void expect_same_parse_result(const std::string& timepoint_str) {
+    const auto fast = rfc3339::parse_fast(timepoint_str);
+    if (!fast.has_value()) {
+        // Everything not handled by the fast path falls back to the reference
+        return;
+    }
+    const auto reference = rfc3339::parse_reference(timepoint_str);
+    ASSERT_TRUE(reference.has_value()) << timepoint_str;
+    EXPECT_EQ(fast.value(), reference.value()) << timepoint_str;
+}
+
+void expect_same_format_result(const rfc3339::utc_time_point& timepoint) {
+    char formatted[rfc3339::FORMATTED_SIZE];
+    if (rfc3339::format_fast(timepoint, formatted)) {
+        EXPECT_EQ(std::string(formatted, rfc3339::FORMATTED_SIZE), rfc3339::format_reference(timepoint));
+    }
+}
+} // namespace
+
+TEST(RFC3339Test, ParseCanonicalForms) {
+    for (const std::string timepoint_str :
+         {"2023-11-29T10:21:04Z", "2019-04-12T23:20:50.5Z", "2019-04-12T23:20:50.52Z", "2019-04-12T23:20:50.523Z",
+          "2019-04-12T23:20:50.123456789Z", "2019-12-19T16:39:57+01:00", "2019-12-19T16:39:57-01:30",
+          "2019-12-19T16:39:57.250+05:45", "2019-12-19T16:39:57", "2024-02-29T00:00:00Z", "1970-01-01T00:00:00Z"}) {
+        ASSERT_TRUE(rfc3339::parse_fast(timepoint_str).has_value()) << timepoint_str;
+        expect_same_parse_result(timepoint_str);
+    }
+}
+
+TEST(RFC3339Test, NonCanonicalFormsFallBack) {
+    for (const std::string timepoint_str :
+         {"", "abc", "2023-11-29", "2023-11-29T10:21", "2023-1-29T10:21:04Z", "2023-11-29T10:21:04.Z",
+          "2023-11-29T10:21:04.1234567890Z", "2023-11-29T10:21:04+0100", "2023-11-29T10:21:04Zgarbage",
+          "2023-11-29t10:21:04Z", "2023-02-30T10:21:04Z", "2023-11-29T24:00:00Z", "2016-12-31T23:59:60Z"}) {
+        EXPECT_FALSE(rfc3339::parse_fast(timepoint_str).has_value()) << timepoint_str;
+    }
+}
+
+TEST(RFC3339Test, InvalidStringThrows) {
+    EXPECT_THROW(DateTime("abc"), TimePointParseException);
+    EXPECT_THROW(DateTime("2023-02-30T10:21:04Z"), TimePointParseException);
+}
+
+TEST(RFC3339Test, LeapSecondUsesReference) {
+    const DateTime leap_second("2016-12-31T23:59:60.500Z");
+    EXPECT_EQ(leap_second.to_rfc3339(), "2016-12-31T23:59:60.500Z");
+
+    char formatted[rfc3339::FORMATTED_SIZE];
+    EXPECT_FALSE(rfc3339::format_fast(leap_second.to_time_point(), formatted));
+}
+
+TEST(RFC3339Test, RoundTrip) {
+    const DateTime now;
+    EXPECT_EQ(DateTime(now.to_rfc3339()).to_rfc3339(), now.to_rfc3339());
+}
+
+TEST(RFC3339Test, DifferentialFuzzParse) {
+    std::mt19937 generator(3339);
+    std::uniform_int_distribution<int> year(0, 9999);
+    std::uniform_int_distribution<int> month(1, 12);
+    std::uniform_int_distribution<int> day(1, 31);
+    std::uniform_int_distribution<int> hours(0, 23);
+    std::uniform_int_distribution<int> minutes(0, 59);
+    std::uniform_int_distribution<int> fraction_digits(0, 9);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> zone(0, 3);
+    std::uniform_int_distribution<std::size_t> mutation_character(0, MUTATION_CHARACTERS.size() - 1);
+
+    for (int i = 0; i < 20000; ++i) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d", year(generator), month(generator),
+                      day(generator), hours(generator), minutes(generator), minutes(generator));
+        std::string timepoint_str(buffer);
+
+        const auto digits = fraction_digits(generator);
+        if (digits > 0) {
+            timepoint_str += '.';
+            for (int d = 0; d < digits; ++d) {
+                timepoint_str += static_cast<char>('0' + digit(generator));
+            }
+        }
+
+        switch (zone(generator)) {
+        case 0:
+            timepoint_str += 'Z';
+            break;
+        case 1:
+        case 2:
+            std::snprintf(buffer, sizeof(buffer), "%c%02d:%02d", zone(generator) < 2 ? '+' : '-', hours(generator),
+                          minutes(generator));
+            timepoint_str += buffer;
+            break;
+        default:
+            break;
+        }
+
+        expect_same_parse_result(timepoint_str);
+
+        // Mutate a single character to exercise the rejection paths
+        std::uniform_int_distribution<std::size_t> position(0, timepoint_str.size() - 1);
+        timepoint_str[position(generator)] = MUTATION_CHARACTERS[mutation_character(generator)];
+        expect_same_parse_result(timepoint_str);
+    }
+}
+
+TEST(RFC3339Test, DifferentialFuzzFormat) {
+    std::mt19937_64 generator(3339);
+    // From 1900 until 2200, in nanoseconds since 1970
+    std::uniform_int_distribution<std::int64_t> offset(-2208988800LL * 1000000000LL, 7258118400LL * 1000000000LL);
+
+    for (int i = 0; i < 20000; ++i) {
+        const auto sys_time = date::sys_time<std::chrono::nanoseconds>(std::chrono::nanoseconds(offset(generator)));
+        const auto timepoint = std::chrono::time_point_cast<rfc3339::utc_time_point::duration>(
+            date::utc_clock::from_sys(sys_time));
+        expect_same_format_result(timepoint);
+    }
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libwebsockets.h>
+
+#include <ocpp/common/websocket/websocket_libwebsockets.hpp>
+
+#include "evse_security_mock.hpp"
+
+using namespace ocpp;
+
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+namespace {
+constexpr std::size_t DEFLATE_THRESHOLD_BYTES = 256;
+constexpr std::size_t RX_BUFFER_SIZE = 64 * 1024;
+
+/// \brief libwebsockets server on localhost that accepts permessage-deflate and collects the received text messages
+class DeflateServer {
+public:
+    DeflateServer();
+    ~DeflateServer();
+
+    std::uint16_t get_port() const {
+        return this->port;
+    }
+
+    void on_receive(const char* in, std::size_t len, bool is_final) {
+        {
+            const std::lock_guard<std::mutex> lock(this->mutex);
+            this->fragments.append(in, len);
+            if (!is_final) {
+                return;
+            }
+            this->messages.push_back(std::move(this->fragments));
+            this->fragments.clear();
+        }
+        this->cv.notify_all();
+    }
+
+    /// \returns the messages once \p count were received, or the messages received within \p timeout
+    std::vector<std::string> wait_for_messages(std::size_t count, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->cv.wait_for(lock, timeout, [this, count]() { return this->messages.size() >= count; });
+        return this->messages;
+    }
+
+private:
+    std::uint16_t port = 0;
+    lws_context* context = nullptr;
+    std::atomic_bool running{false};
+    std::thread service_thread;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::string fragments;
+    std::vector<std::string> messages;
+};
+
+int callback_server(struct lws* wsi, enum lws_callback_reasons reason, void* /*user*/, void* in, size_t len) {
+    auto* context = lws_get_context(wsi);
+    auto* server = context != nullptr ? static_cast<DeflateServer*>(lws_context_user(context)) : nullptr;
+    if (server != nullptr and reason == LWS_CALLBACK_RECEIVE) {
+        server->on_receive(static_cast<const char*>(in), len,
+                           lws_is_final_fragment(wsi) != 0 and lws_remaining_packet_payload(wsi) == 0);
+    }
+    return 0;
+}
+
+const std::array<struct lws_protocols, 2> protocols = {
+    {{"ocpp1.6", callback_server, 0, RX_BUFFER_SIZE, 0, nullptr, 0}, LWS_PROTOCOL_LIST_TERM}};
+
+const std::array<struct lws_extension, 2> extensions = {
+    {{"permessage-deflate", lws_extension_callback_pm_deflate, "permessage-deflate; client_max_window_bits"},
+     {nullptr, nullptr, nullptr}}};
+
+DeflateServer::DeflateServer() {
+    lws_set_log_level(LLL_ERR, nullptr);
+
+    lws_context_creation_info info{};
+    info.port = 0;
+    info.iface = "127.0.0.1";
+    info.protocols = protocols.data();
+    info.extensions = extensions.data();
+    info.user = this;
+    info.gid = -1;
+    info.uid = -1;
+
+    this->context = lws_create_context(&info);
+    if (this->context == nullptr) {
+        throw std::runtime_error("Could not create the libwebsockets server context");
+    }
+    auto* vhost = lws_get_vhost_by_name(this->context, "default");
+    if (vhost != nullptr) {
+        this->port = static_cast<std::uint16_t>(lws_get_vhost_listen_port(vhost));
+    }
+
+    this->running = true;
+    this->service_thread = std::thread([this]() {
+        while (this->running) {
+            lws_service(this->context, 0);
+        }
+    });
+}
+
+DeflateServer::~DeflateServer() {
+    this->running = false;
+    lws_cancel_service(this->context);
+    this->service_thread.join();
+    lws_context_destroy(this->context);
+}
+
+WebsocketConnectionOptions create_connection_options(std::uint16_t port) {
+    WebsocketConnectionOptions options{};
+    options.ocpp_versions = {OcppProtocolVersion::v16};
+    options.csms_uri = Uri::parse_and_validate("ws://127.0.0.1:" + std::to_string(port), "cp001", 0);
+    options.security_profile = 0;
+    options.retry_backoff_random_range_s = 1;
+    options.retry_backoff_repeat_times = 1;
+    options.retry_backoff_wait_minimum_s = 1;
+    options.max_connection_attempts = -1;
+    options.ping_interval_s = 60;
+    options.pong_timeout_s = 30;
+    options.use_ssl_default_verify_paths = false;
+    options.verify_csms_common_name = false;
+    options.use_tpm_tls = false;
+    options.verify_csms_allow_wildcards = false;
+    options.enable_permessage_deflate = true;
+    options.permessage_deflate_threshold_bytes = DEFLATE_THRESHOLD_BYTES;
+    return options;
+}
+} // namespace
+
+TEST(WebsocketDeflateTest, MessagesBelowThresholdArriveIntactAtDeflatePeer) {
+    DeflateServer server;
+    WebsocketLibwebsockets websocket(create_connection_options(server.get_port()),
+                                     std::make_shared<::testing::NiceMock<EvseSecurityMock>>());
+
+    std::promise<void> connected;
+    std::atomic_bool is_connected{false};
+    websocket.register_connected_callback([&](OcppProtocolVersion /*protocol*/) {
+        if (!is_connected.exchange(true)) {
+            connected.set_value();
+        }
+    });
+    ASSERT_TRUE(websocket.start_connecting());
+    ASSERT_EQ(connected.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    // Uncompressed and compressed messages alternate on the same connection, the compression context of the
+    // compressed messages must not be affected by the uncompressed ones in between
+    const std::string small = R"([2,"1","Heartbeat",{}])";
+    const std::string data(4 * DEFLATE_THRESHOLD_BYTES, 'a');
+    const std::string large = R"([2,"2","DataTransfer",{"vendorId":"test","data":")" + data + R"("}])";
+    ASSERT_LT(small.size(), DEFLATE_THRESHOLD_BYTES);
+    const std::vector<std::string> sent{small, large, small, large, small};
+    for (const auto& message : sent) {
+        ASSERT_TRUE(websocket.send(message));
+    }
+
+    EXPECT_EQ(server.wait_for_messages(sent.size(), std::chrono::seconds(5)), sent);
+
+    // Only the large messages went through the extension
+    const auto counters = websocket.get_traffic_counters();
+    EXPECT_EQ(counters.deflate_input_bytes_sent, 2 * large.size());
+    EXPECT_GT(counters.deflate_output_bytes_sent, 0);
+    EXPECT_LT(counters.deflate_output_bytes_sent, 2 * large.size());
+
+    websocket.close(WebsocketCloseReason::Normal, "test finished");
+}
+#endif
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+#include <openssl/ssl.h>
+
+#include <ocpp/common/websocket/websocket_libwebsockets.hpp>
+
+#include "evse_security_mock.hpp"
+
+using namespace ocpp;
+
+namespace {
+WebsocketConnectionOptions create_connection_options() {
+    WebsocketConnectionOptions options{};
+    options.ocpp_versions = {OcppProtocolVersion::v201};
+    options.csms_uri = Uri::parse_and_validate("wss://127.0.0.1:8443", "cp001", 2);
+    options.security_profile = 2;
+    options.retry_backoff_random_range_s = 1;
+    options.retry_backoff_repeat_times = 1;
+    options.retry_backoff_wait_minimum_s = 1;
+    options.max_connection_attempts = -1;
+    options.supported_ciphers_12 = "ECDHE-ECDSA-AES128-GCM-SHA256";
+    options.supported_ciphers_13 = "TLS_AES_256_GCM_SHA384";
+    options.ping_interval_s = 60;
+    options.pong_timeout_s = 30;
+    options.use_ssl_default_verify_paths = false;
+    options.verify_csms_common_name = false;
+    options.use_tpm_tls = false;
+    options.verify_csms_allow_wildcards = false;
+    return options;
+}
+
+/// \brief Creates a session that OpenSSL considers resumable
+SSL_SESSION* create_resumable_session() {
+    SSL_SESSION* session = SSL_SESSION_new();
+    const std::array<unsigned char, 4> session_id{1, 2, 3, 4};
+    SSL_SESSION_set1_id(session, session_id.data(), session_id.size());
+    return session;
+}
+
+/// \returns true if \p websocket would resume \p session on its next handshake
+bool resumes_session(WebsocketLibwebsockets& websocket, SSL_SESSION* session) {
+    const std::unique_ptr<SSL_CTX, decltype(&SSL_CTX_free)> ctx(SSL_CTX_new(TLS_client_method()), SSL_CTX_free);
+    const std::unique_ptr<SSL, decltype(&SSL_free)> ssl(SSL_new(ctx.get()), SSL_free);
+    websocket.on_tls_handshake_start(ssl.get());
+    return SSL_get_session(ssl.get()) == session;
+}
+} // namespace
+
+TEST(WebsocketTlsSessionTest, SettingIdenticalOptionsKeepsTheSession) {
+    const auto options = create_connection_options();
+    WebsocketLibwebsockets websocket(options, std::make_shared<::testing::NiceMock<EvseSecurityMock>>());
+
+    SSL_SESSION* session = create_resumable_session();
+    ASSERT_TRUE(websocket.on_tls_session_created(session));
+    ASSERT_TRUE(resumes_session(websocket, session));
+
+    // Like after every successful connection
+    websocket.set_connection_options(options);
+    websocket.set_connection_options(options);
+    EXPECT_TRUE(resumes_session(websocket, session));
+
+    // Options that do not affect TLS keep the session as well
+    auto changed_options = options;
+    changed_options.ping_interval_s = 30;
+    websocket.set_connection_options(changed_options);
+    EXPECT_TRUE(resumes_session(websocket, session));
+}
+
+TEST(WebsocketTlsSessionTest, ChangedTlsOptionsDropTheSession) {
+    const auto options = create_connection_options();
+    WebsocketLibwebsockets websocket(options, std::make_shared<::testing::NiceMock<EvseSecurityMock>>());
+
+    SSL_SESSION* session = create_resumable_session();
+    ASSERT_TRUE(websocket.on_tls_session_created(session));
+
+    auto changed_options = options;
+    changed_options.supported_ciphers_13 = "TLS_AES_128_GCM_SHA256";
+    websocket.set_connection_options(changed_options);
+    EXPECT_FALSE(resumes_session(websocket, session));
+
+    // A session for another CSMS must not be resumed
+    session = create_resumable_session();
+    ASSERT_TRUE(websocket.on_tls_session_created(session));
+    changed_options.csms_uri = Uri::parse_and_validate("wss://127.0.0.2:8443", "cp001", 2);
+    websocket.set_connection_options(changed_options);
+    EXPECT_FALSE(resumes_session(websocket, session));
+}
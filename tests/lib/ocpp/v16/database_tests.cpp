@@ -347,6 +347,34 @@ TEST_F(DatabaseTest, test_insert_and_get_profiles) {
     }
 }
 
+TEST_F(DatabaseTest, test_insert_and_get_compact_profiles) {
+    this->db_handler->set_compact_encoding(true);
+
+    auto profile1 = get_sample_charging_profile();
+    profile1.chargingSchedule.chargingSchedulePeriod.at(1).limit = 13.7F;
+    this->db_handler->insert_or_update_charging_profile(1, profile1);
+
+    auto profiles = this->db_handler->get_charging_profiles();
+    ASSERT_EQ(profiles.size(), 1);
+    const auto& periods = profiles.at(0).chargingSchedule.chargingSchedulePeriod;
+    ASSERT_EQ(periods.size(), 2);
+    EXPECT_EQ(periods.at(0).startPeriod, 0);
+    EXPECT_EQ(periods.at(0).limit, 10);
+    EXPECT_EQ(periods.at(0).numberPhases, 3);
+    EXPECT_EQ(periods.at(1).startPeriod, 30);
+    EXPECT_EQ(periods.at(1).limit, 13.7F);
+    EXPECT_EQ(profiles.at(0).chargingSchedule.minChargingRate, profile1.chargingSchedule.minChargingRate);
+
+    // Profiles with the same stack level and purpose are still replaced
+    auto profile2 = get_sample_charging_profile();
+    profile2.chargingProfileId = 2;
+    this->db_handler->insert_or_update_charging_profile(1, profile2);
+
+    profiles = this->db_handler->get_charging_profiles();
+    ASSERT_EQ(profiles.size(), 1);
+    EXPECT_EQ(profiles.at(0).chargingProfileId, 2);
+}
+
 TEST_F(DatabaseTest, test_update_profile_same_profile_id) {
     const auto profile1 = get_sample_charging_profile();
     const auto profile2 = get_sample_charging_profile();
@@ -928,5 +928,69 @@ TEST_F(CompositeScheduleTestFixture, TxDefaultConnector0) {
                                      PeriodEquals(350, 10000.0F)));
 }
 
+TEST_F(CompositeScheduleTestFixture, LimitsChangedOnlyCalledWhenCurrentLimitChanged) {
+    std::unique_ptr<SmartChargingHandler> handler(create_smart_charging_handler(2, false));
+
+    std::vector<std::map<std::int32_t, EnhancedChargingSchedule>> notifications;
+    handler->subscribe_limits_changed(
+        3600, ChargingRateUnit::A, nullptr,
+        [&notifications](const std::map<std::int32_t, EnhancedChargingSchedule>& schedules) {
+            notifications.push_back(schedules);
+        });
+
+    // All connectors including 0 are reported directly after subscribing
+    ASSERT_EQ(notifications.size(), 1);
+    EXPECT_EQ(notifications.at(0).size(), 3);
+
+    // Nothing changed
+    handler->notify_limits_changed();
+    EXPECT_EQ(notifications.size(), 1);
+
+    const auto now = ocpp::DateTime();
+    ChargingProfile profile;
+    profile.chargingProfileId = 1;
+    profile.stackLevel = 1;
+    profile.chargingProfilePurpose = ChargingProfilePurposeType::ChargePointMaxProfile;
+    profile.chargingProfileKind = ChargingProfileKindType::Absolute;
+    profile.chargingSchedule.chargingRateUnit = ChargingRateUnit::A;
+    profile.chargingSchedule.startSchedule = ocpp::DateTime(now.to_time_point() - std::chrono::minutes(1));
+    profile.chargingSchedule.chargingSchedulePeriod = {ChargingSchedulePeriod{0, 10.0F, std::nullopt}};
+    handler->add_charge_point_max_profile(profile);
+    handler->notify_limits_changed();
+
+    // The ChargePointMaxProfile lowers the limit of every connector
+    ASSERT_EQ(notifications.size(), 2);
+    ASSERT_EQ(notifications.at(1).size(), 3);
+    for (const auto& [connector_id, schedule] : notifications.at(1)) {
+        ASSERT_FALSE(schedule.chargingSchedulePeriod.empty());
+        EXPECT_EQ(schedule.chargingSchedulePeriod.front().limit, 10.0F);
+    }
+
+    handler->notify_limits_changed();
+    EXPECT_EQ(notifications.size(), 2);
+
+    handler->unsubscribe_limits_changed();
+    handler->clear_all_profiles();
+    handler->notify_limits_changed();
+    EXPECT_EQ(notifications.size(), 2);
+}
+
+TEST_F(CompositeScheduleTestFixture, LimitsChangedNonPositiveDurationIsClamped) {
+    std::unique_ptr<SmartChargingHandler> handler(create_smart_charging_handler(2, false));
+
+    std::vector<std::map<std::int32_t, EnhancedChargingSchedule>> notifications;
+    handler->subscribe_limits_changed(
+        0, ChargingRateUnit::A, nullptr,
+        [&notifications](const std::map<std::int32_t, EnhancedChargingSchedule>& schedules) {
+            notifications.push_back(schedules);
+        });
+
+    ASSERT_EQ(notifications.size(), 1);
+    for (const auto& [connector_id, schedule] : notifications.at(0)) {
+        EXPECT_THAT(schedule.duration, testing::Optional(1));
+    }
+    handler->unsubscribe_limits_changed();
+}
+
 } // namespace v16
 } // namespace ocpp
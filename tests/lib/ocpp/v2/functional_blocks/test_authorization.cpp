@@ -229,7 +229,7 @@ protected: // Functions
         ocpp::CallResult<AuthorizeResponse> call_result(response, "uniqueId");
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::AuthorizeResponse;
-        enhanced_message.message = call_result;
+        enhanced_message.message = std::make_shared<const json>(call_result);
         return enhanced_message;
     }
 
@@ -238,7 +238,7 @@ protected: // Functions
         ocpp::Call<ClearCacheRequest> call(request, "uniqueId");
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::ClearCache;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -247,7 +247,7 @@ protected: // Functions
         ocpp::Call<GetLocalListVersionRequest> call(request, "uniqueId");
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::GetLocalListVersion;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -261,7 +261,7 @@ protected: // Functions
         ocpp::Call<SendLocalListRequest> call(request, "uniqueId");
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::SendLocalList;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -87,7 +87,7 @@ protected: // Functions
         ocpp::Call<ChangeAvailabilityRequest> call(request);
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::ChangeAvailability;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -97,7 +97,7 @@ protected: // Functions
         ocpp::CallResult<HeartbeatResponse> call_result(response, "uniqueId");
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::HeartbeatResponse;
-        enhanced_message.message = call_result;
+        enhanced_message.message = std::make_shared<const json>(call_result);
         return enhanced_message;
     }
 };
@@ -66,7 +66,7 @@ TEST_F(DataTransferTest, HandleDataTransferReq_NotImplemented) {
     ocpp::Call<DataTransferRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::Authorize; // this cant be handled by DataTransfer functional block
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_THROW(data_transfer.handle_message(enhanced_message), MessageTypeNotImplementedException);
 }
@@ -78,7 +78,7 @@ TEST_F(DataTransferTest, HandleDataTransferReq_NoCallback) {
     ocpp::Call<DataTransferRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::DataTransfer;
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
         auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<DataTransferResponse>();
@@ -101,7 +101,7 @@ TEST_F(DataTransferTest, HandleDataTransferReq_WithCallback) {
     ocpp::Call<DataTransferRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::DataTransfer;
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
         auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<DataTransferResponse>();
@@ -156,7 +156,7 @@ TEST_F(DataTransferTest, DataTransferReq_Accepted) {
 
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::DataTransferResponse;
-    enhanced_message.message = call_result;
+    enhanced_message.message = std::make_shared<const json>(call_result);
 
     EXPECT_CALL(mock_dispatcher, dispatch_call_async(_, _))
         .WillOnce(Return(std::async(std::launch::deferred, [enhanced_message]() { return enhanced_message; })));
@@ -176,8 +176,9 @@ TEST_F(DataTransferTest, DataTransferReq_EnumConversionException) {
     enhanced_message.offline = false;
     enhanced_message.messageType = MessageType::DataTransferResponse;
     enhanced_message.uniqueId = "unique-id-123";
+    // will cause a throw of EnumConversionException
     enhanced_message.message =
-        json::parse("[3, \"unique-id-123\", {\"status\": \"Wrong\"}]"); // will cause a throw of EnumConversionException
+        std::make_shared<const json>(json::parse("[3, \"unique-id-123\", {\"status\": \"Wrong\"}]"));
 
     EXPECT_CALL(mock_dispatcher, dispatch_call_async(_, _))
         .WillOnce(Return(std::async(std::launch::deferred, [enhanced_message]() -> ocpp::EnhancedMessage<MessageType> {
@@ -202,7 +203,7 @@ TEST_F(DataTransferTest, DataTransferReq_JsonException) {
     enhanced_message.offline = false;
     enhanced_message.messageType = MessageType::DataTransferResponse;
     enhanced_message.uniqueId = "unique-id-123";
-    enhanced_message.message = "{NoValidJson"; // will cause a throw of json exception
+    enhanced_message.message = std::make_shared<const json>("{NoValidJson"); // will cause a throw of json exception
 
     EXPECT_CALL(mock_dispatcher, dispatch_call_async(_, _))
         .WillOnce(Return(std::async(std::launch::deferred, [enhanced_message]() -> ocpp::EnhancedMessage<MessageType> {
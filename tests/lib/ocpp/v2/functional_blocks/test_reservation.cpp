@@ -147,7 +147,7 @@ protected: // Functions
         ocpp::Call<ReserveNowRequest> call(request);
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::ReserveNow;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -162,7 +162,7 @@ protected: // Functions
         ocpp::Call<CancelReservationRequest> call(request);
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::CancelReservation;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -531,7 +531,7 @@ TEST_F(ReservationTest, handle_message_wrong_type) {
     ocpp::Call<ResetRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::Reset;
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_THROW(reservation->handle_message(enhanced_message), MessageTypeNotImplementedException);
 }
@@ -571,7 +571,7 @@ TEST_F(ReservationTest, on_reservation_status) {
     ocpp::Call<ReservationStatusUpdateRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::CancelReservation;
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_CALL(mock_dispatcher, dispatch_call(_, _)).WillOnce(Invoke([](const json& call, bool triggered) {
         auto response = call[ocpp::CALL_PAYLOAD].get<ReservationStatusUpdateRequest>();
@@ -77,7 +77,7 @@ protected: // Functions
         ocpp::Call<CertificateSignedRequest> call(request);
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::CertificateSigned;
-        enhanced_message.message = call;
+        enhanced_message.message = std::make_shared<const json>(call);
         return enhanced_message;
     }
 
@@ -89,7 +89,7 @@ protected: // Functions
         call_result.msg = response;
         ocpp::EnhancedMessage<MessageType> enhanced_message;
         enhanced_message.messageType = MessageType::SignCertificateResponse;
-        enhanced_message.message = call_result;
+        enhanced_message.message = std::make_shared<const json>(call_result);
         return enhanced_message;
     }
 
@@ -116,7 +116,7 @@ TEST_F(SecurityTest, handle_message_not_implemented) {
     ocpp::Call<ResetRequest> call(request);
     ocpp::EnhancedMessage<MessageType> enhanced_message;
     enhanced_message.messageType = MessageType::Reset;
-    enhanced_message.message = call;
+    enhanced_message.message = std::make_shared<const json>(call);
 
     EXPECT_THROW(security.handle_message(enhanced_message), MessageTypeNotImplementedException);
 }
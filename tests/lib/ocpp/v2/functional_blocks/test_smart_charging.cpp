@@ -75,7 +75,9 @@ protected:
         enhanced_message.messageType = M;
         enhanced_message.messageTypeId = ocpp::MessageTypeId::CALL;
 
-        call_to_json(enhanced_message.message, call);
+        json message;
+        call_to_json(message, call);
+        enhanced_message.message = std::make_shared<const json>(std::move(message));
 
         return enhanced_message;
     }
@@ -1814,4 +1816,90 @@ TEST_F(SmartChargingTest, K01_ValidateTxProfile_EmptyChargingSchedule) {
     ASSERT_THAT(sut, testing::Eq(ProfileValidationResultEnum::ChargingProfileEmptyChargingSchedules));
 }
 
+TEST_F(SmartChargingTest, LimitsChanged_OnlyCalledWhenCurrentLimitChanged) {
+    std::vector<std::vector<CompositeSchedule>> notifications;
+    smart_charging.subscribe_limits_changed(
+        3600, ChargingRateUnitEnum::A,
+        [&notifications](const std::vector<CompositeSchedule>& schedules) { notifications.push_back(schedules); });
+
+    // All evses including 0 are reported directly after subscribing
+    ASSERT_THAT(notifications.size(), testing::Eq(1));
+    EXPECT_THAT(notifications.at(0).size(), testing::Eq(NR_OF_TWO_EVSES + 1));
+
+    const DateTime now;
+    auto profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::ChargingStationMaxProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 10.0F),
+                               DateTime(now.to_time_point() - std::chrono::minutes(1))),
+        {}, ChargingProfileKindEnum::Absolute, DEFAULT_STACK_LEVEL,
+        DateTime(now.to_time_point() - std::chrono::hours(1)), DateTime(now.to_time_point() + std::chrono::hours(24)));
+    smart_charging.add_profile(profile, STATION_WIDE_ID);
+
+    // The station wide limit lowers the limit of every evse
+    ASSERT_THAT(notifications.size(), testing::Eq(2));
+    ASSERT_THAT(notifications.at(1).size(), testing::Eq(NR_OF_TWO_EVSES + 1));
+    for (const auto& schedule : notifications.at(1)) {
+        ASSERT_FALSE(schedule.chargingSchedulePeriod.empty());
+        EXPECT_THAT(schedule.chargingSchedulePeriod.front().limit, testing::Optional(10.0F));
+    }
+
+    // Adding the same profile again does not change any limit
+    smart_charging.add_profile(profile, STATION_WIDE_ID);
+    EXPECT_THAT(notifications.size(), testing::Eq(2));
+
+    smart_charging.unsubscribe_limits_changed();
+    ClearChargingProfileRequest clear_request;
+    clear_request.chargingProfileId = DEFAULT_PROFILE_ID;
+    smart_charging.clear_profiles(clear_request);
+    EXPECT_THAT(notifications.size(), testing::Eq(2));
+}
+
+TEST_F(SmartChargingTest, LimitsChanged_NonPositiveDurationIsClamped) {
+    std::vector<std::vector<CompositeSchedule>> notifications;
+    smart_charging.subscribe_limits_changed(
+        0, ChargingRateUnitEnum::A,
+        [&notifications](const std::vector<CompositeSchedule>& schedules) { notifications.push_back(schedules); });
+
+    ASSERT_THAT(notifications.size(), testing::Eq(1));
+    for (const auto& schedule : notifications.at(0)) {
+        EXPECT_THAT(schedule.duration, testing::Eq(1));
+    }
+    smart_charging.unsubscribe_limits_changed();
+}
+
+TEST_F(SmartChargingTest, LimitsChanged_ReevaluatedWhenTransactionStarts) {
+    // Relative profile: 10A for the first half hour of the session, 6A afterwards
+    auto periods = create_charging_schedule_periods({0, 1800});
+    periods.at(0).limit = 10.0F;
+    periods.at(1).limit = 6.0F;
+    auto profile = create_charging_profile(DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxDefaultProfile,
+                                           create_charge_schedule(ChargingRateUnitEnum::A, periods), {},
+                                           ChargingProfileKindEnum::Relative, DEFAULT_STACK_LEVEL);
+    smart_charging.add_profile(profile, DEFAULT_EVSE_ID);
+
+    std::vector<std::vector<CompositeSchedule>> notifications;
+    smart_charging.subscribe_limits_changed(
+        3600, ChargingRateUnitEnum::A,
+        [&notifications](const std::vector<CompositeSchedule>& schedules) { notifications.push_back(schedules); });
+    ASSERT_THAT(notifications.size(), testing::Eq(1));
+
+    // Without a transaction the profile starts now, with a transaction it starts at the start of the transaction
+    const DateTime now;
+    this->evse_manager->open_transaction(DEFAULT_EVSE_ID, DEFAULT_TX_ID,
+                                         DateTime(now.to_time_point() - std::chrono::hours(1)));
+    smart_charging.on_transaction_changed(DEFAULT_EVSE_ID);
+
+    ASSERT_THAT(notifications.size(), testing::Eq(2));
+    ASSERT_THAT(notifications.at(1).size(), testing::Eq(1));
+    EXPECT_THAT(notifications.at(1).front().evseId, testing::Eq(DEFAULT_EVSE_ID));
+    ASSERT_FALSE(notifications.at(1).front().chargingSchedulePeriod.empty());
+    EXPECT_THAT(notifications.at(1).front().chargingSchedulePeriod.front().limit, testing::Optional(6.0F));
+
+    // Nothing changed for the evse
+    smart_charging.on_transaction_changed(DEFAULT_EVSE_ID);
+    EXPECT_THAT(notifications.size(), testing::Eq(2));
+    smart_charging.unsubscribe_limits_changed();
+}
+
 } // namespace ocpp::v2
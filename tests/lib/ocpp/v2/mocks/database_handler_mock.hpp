@@ -45,6 +45,8 @@ public:
                 (const std::string& transaction_id, const MeterValue& meter_value));
     MOCK_METHOD(std::vector<MeterValue>, transaction_metervalues_get_all, (const std::string& transaction_id),
                 (override));
+    MOCK_METHOD(void, transaction_metervalues_for_each,
+                (const std::string& transaction_id, const std::function<void(MeterValue&& meter_value)>& callback));
     MOCK_METHOD(void, transaction_metervalues_clear, (const std::string& transaction_id));
     MOCK_METHOD(void, transaction_insert, (const EnhancedTransaction& transaction, std::int32_t evse_id));
     MOCK_METHOD(std::unique_ptr<EnhancedTransaction>, transaction_get, (const std::int32_t evse_id));
@@ -70,6 +72,16 @@ public:
     typedef std::map<std::int32_t, std::vector<ChargingProfile>> charging_profiles_grouped_by_evse;
     MOCK_METHOD(charging_profiles_grouped_by_evse, get_all_charging_profiles_group_by_evse, ());
     MOCK_METHOD(CiString<20>, get_charging_limit_source_for_profile, (const int profile_id));
+    MOCK_METHOD(void, insert_or_update_default_tariff, (const std::int32_t evse_id, const Tariff& tariff));
+    typedef std::vector<std::pair<std::int32_t, Tariff>> default_tariffs;
+    MOCK_METHOD(default_tariffs, get_default_tariffs, ());
+    MOCK_METHOD(bool, delete_default_tariff, (const std::int32_t evse_id, const std::string& tariff_id));
+    MOCK_METHOD(void, insert_or_update_der_control,
+                (const v21::SetDERControlRequest& control, const bool is_superseded));
+    MOCK_METHOD(std::vector<StoredDERControl>, get_der_controls, ());
+    MOCK_METHOD(bool, delete_der_controls,
+                (const bool is_default, const std::optional<DERControlEnum>& control_type,
+                 const std::optional<std::string>& control_id));
     MOCK_METHOD(std::unique_ptr<everest::db::sqlite::StatementInterface>, new_statement, (const std::string& sql));
 };
 } // namespace ocpp::v2
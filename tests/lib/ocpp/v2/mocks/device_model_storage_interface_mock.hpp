@@ -17,6 +17,10 @@ public:
                 (const Component&, const Variable&, const std::optional<AttributeEnum>&));
     MOCK_METHOD(SetVariableStatusEnum, set_variable_attribute_value,
                 (const Component&, const Variable&, const AttributeEnum&, const std::string&, const std::string&));
+    MOCK_METHOD(std::vector<std::optional<VariableAttribute>>, get_variable_attributes_batch,
+                (const std::vector<VariableAttributeKey>&));
+    MOCK_METHOD(std::vector<SetVariableStatusEnum>, set_variable_attribute_values_batch,
+                (const std::vector<VariableAttributeValueUpdate>&));
     MOCK_METHOD(std::optional<VariableMonitoringMeta>, set_monitoring_data,
                 (const SetMonitoringData&, const VariableMonitorType));
     MOCK_METHOD(std::vector<VariableMonitoringMeta>, get_monitoring_data,
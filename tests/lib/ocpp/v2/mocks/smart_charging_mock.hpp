@@ -14,11 +14,21 @@ public:
     MOCK_METHOD(void, handle_message, (const ocpp::EnhancedMessage<MessageType>& message));
     MOCK_METHOD(std::vector<CompositeSchedule>, get_all_composite_schedules,
                 (const std::int32_t duration, const ChargingRateUnitEnum& unit));
+    MOCK_METHOD(void, subscribe_limits_changed,
+                (const std::int32_t duration, const ChargingRateUnitEnum& unit,
+                 const LimitsChangedCallback& callback));
+    MOCK_METHOD(void, unsubscribe_limits_changed, ());
     MOCK_METHOD(void, delete_transaction_tx_profiles, (const std::string& transaction_id));
+    MOCK_METHOD(void, on_transaction_changed, (const std::int32_t evse_id));
+    MOCK_METHOD(void, clear_invalid_profiles, ());
     MOCK_METHOD(SetChargingProfileResponse, conform_validate_and_add_profile,
                 (ChargingProfile & profile, std::int32_t evse_id, CiString<20> charging_limit_source,
                  AddChargingProfileSource source_of_request));
     MOCK_METHOD(ProfileValidationResultEnum, conform_and_validate_profile,
                 (ChargingProfile & profile, std::int32_t evse_id, AddChargingProfileSource source_of_request));
+    MOCK_METHOD(GetCompositeScheduleResponse, get_composite_schedule, (const GetCompositeScheduleRequest& request));
+    MOCK_METHOD(std::optional<CompositeSchedule>, get_composite_schedule,
+                (std::int32_t evse_id, std::chrono::seconds duration, ChargingRateUnitEnum unit));
+    MOCK_METHOD(void, notify_ev_charging_needs_req, (const NotifyEVChargingNeedsRequest& req));
 };
 } // namespace ocpp::v2
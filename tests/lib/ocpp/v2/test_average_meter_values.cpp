@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/average_meter_values.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+namespace {
+SampledValue create_sampled_value(const MeasurandEnum measurand, const float value,
+                                  const std::optional<PhaseEnum> phase = std::nullopt,
+                                  const std::optional<LocationEnum> location = std::nullopt) {
+    SampledValue sampled_value;
+    sampled_value.value = value;
+    sampled_value.measurand = measurand;
+    sampled_value.phase = phase;
+    sampled_value.location = location;
+    return sampled_value;
+}
+
+MeterValue create_meter_value(const float voltage_l1, const float voltage_l2, const float energy) {
+    MeterValue meter_value;
+    meter_value.sampledValue.push_back(create_sampled_value(MeasurandEnum::Voltage, voltage_l1, PhaseEnum::L1_N));
+    meter_value.sampledValue.push_back(create_sampled_value(MeasurandEnum::Voltage, voltage_l2, PhaseEnum::L2_N));
+    meter_value.sampledValue.push_back(
+        create_sampled_value(MeasurandEnum::Power_Active_Import, energy, std::nullopt, LocationEnum::Outlet));
+    meter_value.sampledValue.push_back(create_sampled_value(MeasurandEnum::Energy_Active_Import_Register, energy));
+    return meter_value;
+}
+} // namespace
+
+TEST(AverageMeterValuesTest, AveragesPerMeasurandPhaseAndLocation) {
+    AverageMeterValues average;
+    average.set_values(create_meter_value(230.0F, 220.0F, 100.0F));
+    average.set_values(create_meter_value(232.0F, 224.0F, 300.0F));
+
+    const auto result = average.retrieve_processed_values();
+    ASSERT_EQ(result.sampledValue.size(), 4);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(0).value, 231.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(1).value, 222.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(2).value, 200.0F);
+    // Registers are not averaged, the latest value is used
+    EXPECT_FLOAT_EQ(result.sampledValue.at(3).value, 300.0F);
+
+    // Retrieving again does not change the result
+    EXPECT_FLOAT_EQ(average.retrieve_processed_values().sampledValue.at(0).value, 231.0F);
+}
+
+TEST(AverageMeterValuesTest, ClearStartsNewAverage) {
+    AverageMeterValues average;
+    average.set_values(create_meter_value(230.0F, 220.0F, 100.0F));
+    average.clear_values();
+    EXPECT_TRUE(average.retrieve_processed_values().sampledValue.empty());
+
+    average.set_values(create_meter_value(240.0F, 228.0F, 50.0F));
+    const auto result = average.retrieve_processed_values();
+    ASSERT_EQ(result.sampledValue.size(), 4);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(0).value, 240.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(1).value, 228.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(2).value, 50.0F);
+}
+
+TEST(AverageMeterValuesTest, LatestLayoutIsUsedWhenSamplesChange) {
+    AverageMeterValues average;
+    average.set_values(create_meter_value(230.0F, 220.0F, 100.0F));
+
+    auto meter_value = create_meter_value(232.0F, 224.0F, 300.0F);
+    meter_value.sampledValue.push_back(create_sampled_value(MeasurandEnum::Frequency, 50.0F));
+    average.set_values(meter_value);
+
+    const auto result = average.retrieve_processed_values();
+    ASSERT_EQ(result.sampledValue.size(), 5);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(0).value, 231.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(3).value, 300.0F);
+    EXPECT_FLOAT_EQ(result.sampledValue.at(4).value, 50.0F);
+}
+
+TEST(AverageMeterValuesTest, ContextAndUnitOfTheLatestSamplesAreUsed) {
+    const auto create_with = [](const ReadingContextEnum context, const std::string& power_unit) {
+        auto meter_value = create_meter_value(230.0F, 220.0F, 100.0F);
+        for (auto& sampled_value : meter_value.sampledValue) {
+            sampled_value.context = context;
+        }
+        UnitOfMeasure unit_of_measure;
+        unit_of_measure.unit = CiString<20>(power_unit);
+        meter_value.sampledValue.at(2).unitOfMeasure = unit_of_measure;
+        return meter_value;
+    };
+
+    AverageMeterValues average;
+    average.set_values(create_with(ReadingContextEnum::Sample_Periodic, "W"));
+    average.set_values(create_with(ReadingContextEnum::Sample_Clock, "W"));
+    auto result = average.retrieve_processed_values();
+    ASSERT_EQ(result.sampledValue.size(), 4);
+    EXPECT_EQ(result.sampledValue.at(0).context, ReadingContextEnum::Sample_Clock);
+    EXPECT_EQ(result.sampledValue.at(3).context, ReadingContextEnum::Sample_Clock);
+
+    average.set_values(create_with(ReadingContextEnum::Sample_Clock, "kW"));
+    result = average.retrieve_processed_values();
+    ASSERT_EQ(result.sampledValue.size(), 4);
+    ASSERT_TRUE(result.sampledValue.at(2).unitOfMeasure.has_value());
+    EXPECT_EQ(result.sampledValue.at(2).unitOfMeasure->unit.value().get(), "kW");
+}
+
+} // namespace v2
+} // namespace ocpp
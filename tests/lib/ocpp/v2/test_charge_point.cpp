@@ -690,7 +690,9 @@ public:
         enhanced_message.messageType = M;
         enhanced_message.messageTypeId = MessageTypeId::CALL;
 
-        call_to_json(enhanced_message.message, call);
+        json message;
+        call_to_json(message, call);
+        enhanced_message.message = std::make_shared<const json>(std::move(message));
 
         return enhanced_message;
     }
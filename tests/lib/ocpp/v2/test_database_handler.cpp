@@ -14,7 +14,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <ocpp/v2/database_handler.hpp>
+#include <algorithm>
+#include <future>
 #include <optional>
+#include <thread>
 
 using namespace ocpp;
 using namespace ocpp::v2;
@@ -167,6 +170,273 @@ TEST_F(DatabaseHandlerTest, TransactionDeleteNotFound) {
     EXPECT_NO_THROW(this->database_handler.transaction_delete("txIdNotFound"));
 }
 
+namespace {
+MeterValue create_meter_value(const ReadingContextEnum context, const float value,
+                              const std::string& timestamp = "2024-07-15T08:01:02Z") {
+    SampledValue sampled_value;
+    sampled_value.value = value;
+    sampled_value.context = context;
+    sampled_value.measurand = MeasurandEnum::Energy_Active_Import_Register;
+    MeterValue meter_value;
+    meter_value.timestamp = DateTime{timestamp};
+    meter_value.sampledValue.push_back(sampled_value);
+    return meter_value;
+}
+
+int count_stored_meter_values(DatabaseHandler& database_handler) {
+    auto stmt = database_handler.new_statement("SELECT COUNT(*) FROM METER_VALUES");
+    EXPECT_EQ(stmt->step(), SQLITE_ROW);
+    return stmt->column_int(0);
+}
+} // namespace
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesBufferedUntilMaxSize) {
+    this->database_handler.set_meter_value_buffer_limits(3, std::chrono::hours(1));
+
+    this->database_handler.transaction_metervalues_insert(
+        "txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 1, "2024-07-15T08:01:02Z"));
+    this->database_handler.transaction_metervalues_insert(
+        "txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 2, "2024-07-15T08:01:03Z"));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 0);
+
+    this->database_handler.transaction_metervalues_insert(
+        "txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 3, "2024-07-15T08:01:04Z"));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 3);
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesBufferedUntilMaxAgeWithoutFurtherInserts) {
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::milliseconds(50));
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Sample_Periodic, 1));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 0);
+
+    // The buffer timer runs on the default executor
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (count_stored_meter_values(this->database_handler) == 0 and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 1);
+}
+
+TEST_F(DatabaseHandlerTest, DestructionWhileBufferTimerIsPendingOnSharedExecutor) {
+    const auto executor = std::make_shared<Executor>();
+    auto handler = std::make_unique<DatabaseHandler>(
+        std::make_unique<everest::db::sqlite::Connection>("file::memory:"),
+        std::filesystem::path(MIGRATION_FILES_LOCATION_V2), executor);
+    handler->open_connection();
+    handler->set_meter_value_buffer_limits(10, std::chrono::milliseconds(1));
+    handler->transaction_metervalues_insert("txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 1));
+    handler.reset();
+
+    // The shared executor keeps running the handlers of other components
+    std::promise<void> done;
+    executor->post([&done]() { done.set_value(); });
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesFailedBatchIsKeptAndWrittenOneByOne) {
+    DatabaseHandler handler(std::make_unique<everest::db::sqlite::Connection>("file::memory:"),
+                            std::filesystem::path(MIGRATION_FILES_LOCATION_V2));
+    handler.open_connection();
+    handler.set_meter_value_buffer_limits(3, std::chrono::hours(1));
+    auto trigger = handler.new_statement("CREATE TRIGGER FAIL_METER_VALUE_ITEM BEFORE INSERT ON METER_VALUE_ITEMS "
+                                         "WHEN NEW.VALUE = 2 BEGIN SELECT RAISE(ABORT, 'Insert fails'); END;");
+    ASSERT_EQ(trigger->step(), SQLITE_DONE);
+
+    handler.transaction_metervalues_insert("txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 1));
+    handler.transaction_metervalues_insert("txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 2));
+    EXPECT_THROW(
+        handler.transaction_metervalues_insert("txId", create_meter_value(ReadingContextEnum::Sample_Periodic, 3)),
+        everest::db::QueryExecutionException);
+
+    // The failed batch stays in the buffer and is written again on the next flush
+    EXPECT_EQ(count_stored_meter_values(handler), 0);
+    EXPECT_EQ(handler.transaction_metervalues_get_all("txId").size(), 3);
+    EXPECT_THROW(handler.transaction_metervalues_flush(), everest::db::QueryExecutionException);
+    EXPECT_EQ(handler.transaction_metervalues_get_all("txId").size(), 3);
+
+    // After the last attempt only the metervalue that can not be written is dropped
+    EXPECT_THROW(handler.transaction_metervalues_flush(), everest::db::QueryExecutionException);
+    EXPECT_EQ(count_stored_meter_values(handler), 2);
+    EXPECT_NO_THROW(handler.transaction_metervalues_flush());
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesBeginAndEndWrittenImmediately) {
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::hours(1));
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Transaction_Begin, 1));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 1);
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Sample_Periodic, 2));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 1);
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Transaction_End, 3));
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 3);
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesGetAllIncludesBufferedValues) {
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::hours(1));
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Transaction_Begin, 1));
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Sample_Periodic, 2));
+    this->database_handler.transaction_metervalues_insert("otherTxId",
+                                                          create_meter_value(ReadingContextEnum::Sample_Periodic, 3));
+
+    const auto meter_values = this->database_handler.transaction_metervalues_get_all("txId");
+    ASSERT_EQ(meter_values.size(), 2);
+    EXPECT_EQ(meter_values.at(0).sampledValue.at(0).value, 1);
+    EXPECT_EQ(meter_values.at(0).sampledValue.at(0).context, ReadingContextEnum::Transaction_Begin);
+    EXPECT_EQ(meter_values.at(1).sampledValue.at(0).value, 2);
+    EXPECT_EQ(meter_values.at(1).sampledValue.at(0).measurand, MeasurandEnum::Energy_Active_Import_Register);
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesClearDropsBufferedValues) {
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::hours(1));
+
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Transaction_Begin, 1));
+    this->database_handler.transaction_metervalues_insert("txId",
+                                                          create_meter_value(ReadingContextEnum::Sample_Periodic, 2));
+
+    this->database_handler.transaction_metervalues_clear("txId");
+
+    EXPECT_TRUE(this->database_handler.transaction_metervalues_get_all("txId").empty());
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 0);
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesCompactEncodingRoundTrip) {
+    this->database_handler.set_compact_encoding(true);
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::hours(1));
+
+    auto begin = create_meter_value(ReadingContextEnum::Transaction_Begin, 0.1F);
+    begin.sampledValue.at(0).unitOfMeasure = UnitOfMeasure{"kWh", 3, std::nullopt};
+
+    auto periodic = create_meter_value(ReadingContextEnum::Sample_Periodic, 230.5F);
+    periodic.timestamp = DateTime{"2024-07-15T08:01:03.250Z"};
+    periodic.sampledValue.at(0).measurand = MeasurandEnum::Voltage;
+    periodic.sampledValue.at(0).phase = PhaseEnum::L2;
+    periodic.sampledValue.at(0).location = LocationEnum::Outlet;
+
+    // Signed values can not be encoded compactly and are stored in the regular tables
+    auto end = create_meter_value(ReadingContextEnum::Transaction_End, 42);
+    end.timestamp = DateTime{"2024-07-15T08:01:04Z"};
+    end.sampledValue.at(0).signedMeterValue = SignedMeterValue{"data", "encoding", "method", "key"};
+
+    this->database_handler.transaction_metervalues_insert("txId", begin);
+    this->database_handler.transaction_metervalues_insert("txId", periodic);
+    this->database_handler.transaction_metervalues_insert("txId", end);
+
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 1);
+
+    const auto meter_values = this->database_handler.transaction_metervalues_get_all("txId");
+    ASSERT_EQ(meter_values.size(), 3);
+
+    const auto& begin_value = meter_values.at(0);
+    EXPECT_EQ(begin_value.timestamp, begin.timestamp);
+    ASSERT_EQ(begin_value.sampledValue.size(), 1);
+    EXPECT_EQ(begin_value.sampledValue.at(0).value, 0.1F);
+    EXPECT_EQ(begin_value.sampledValue.at(0).context, ReadingContextEnum::Transaction_Begin);
+    ASSERT_TRUE(begin_value.sampledValue.at(0).unitOfMeasure.has_value());
+    EXPECT_EQ(begin_value.sampledValue.at(0).unitOfMeasure->unit.value().get(), "kWh");
+    EXPECT_EQ(begin_value.sampledValue.at(0).unitOfMeasure->multiplier, 3);
+
+    const auto& periodic_value = meter_values.at(1);
+    EXPECT_EQ(periodic_value.timestamp, periodic.timestamp);
+    EXPECT_EQ(periodic_value.sampledValue.at(0).value, 230.5F);
+    EXPECT_EQ(periodic_value.sampledValue.at(0).measurand, MeasurandEnum::Voltage);
+    EXPECT_EQ(periodic_value.sampledValue.at(0).phase, PhaseEnum::L2);
+    EXPECT_EQ(periodic_value.sampledValue.at(0).location, LocationEnum::Outlet);
+    EXPECT_FALSE(periodic_value.sampledValue.at(0).unitOfMeasure.has_value());
+
+    const auto& end_value = meter_values.at(2);
+    EXPECT_EQ(end_value.sampledValue.at(0).context, ReadingContextEnum::Transaction_End);
+    EXPECT_TRUE(end_value.sampledValue.at(0).signedMeterValue.has_value());
+
+    this->database_handler.transaction_metervalues_clear("txId");
+    EXPECT_TRUE(this->database_handler.transaction_metervalues_get_all("txId").empty());
+}
+
+TEST_F(DatabaseHandlerTest, TransactionMeterValuesForEachMergesRowsAndBlocksByTimestamp) {
+    this->database_handler.set_meter_value_buffer_limits(10, std::chrono::hours(1));
+
+    auto insert = [this](const float value, const std::string& timestamp, const bool is_signed = false) {
+        auto meter_value = create_meter_value(ReadingContextEnum::Sample_Periodic, value, timestamp);
+        if (is_signed) {
+            meter_value.sampledValue.at(0).signedMeterValue = SignedMeterValue{"data", "encoding", "method", "key"};
+        }
+        this->database_handler.transaction_metervalues_insert("txId", meter_value);
+    };
+
+    // First block with a signed value in between that is stored as row
+    this->database_handler.set_compact_encoding(true);
+    insert(1, "2024-07-15T08:00:00Z");
+    insert(2, "2024-07-15T08:00:01Z", true);
+    insert(3, "2024-07-15T08:00:02Z");
+    this->database_handler.transaction_metervalues_flush();
+
+    // Encoding switched off and on again during the transaction
+    this->database_handler.set_compact_encoding(false);
+    insert(4, "2024-07-15T08:00:03Z");
+    insert(6, "2024-07-15T08:00:05Z");
+    this->database_handler.transaction_metervalues_flush();
+
+    // The last value is a row, so it is read after all blocks
+    this->database_handler.set_compact_encoding(true);
+    insert(5, "2024-07-15T08:00:04Z");
+    insert(7, "2024-07-15T08:00:06Z");
+    insert(8, "2024-07-15T08:00:07Z", true);
+    this->database_handler.transaction_metervalues_flush();
+
+    EXPECT_EQ(count_stored_meter_values(this->database_handler), 4);
+
+    std::vector<float> values;
+    std::vector<DateTime> timestamps;
+    this->database_handler.transaction_metervalues_for_each("txId", [&](MeterValue&& meter_value) {
+        values.push_back(meter_value.sampledValue.at(0).value);
+        timestamps.push_back(meter_value.timestamp);
+    });
+
+    EXPECT_EQ(values, (std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_TRUE(std::is_sorted(timestamps.begin(), timestamps.end()));
+}
+
+TEST_F(DatabaseHandlerTest, ChargingProfileCompactEncodingRoundTrip) {
+    this->database_handler.set_compact_encoding(true);
+
+    ChargingSchedule schedule;
+    schedule.id = 1;
+    schedule.chargingRateUnit = ChargingRateUnitEnum::A;
+    for (std::int32_t i = 0; i < 96; ++i) {
+        ChargingSchedulePeriod period;
+        period.startPeriod = i * 900;
+        period.limit = 6.0F + static_cast<float>(i) / 4.0F;
+        period.numberPhases = 3;
+        schedule.chargingSchedulePeriod.push_back(period);
+    }
+
+    ChargingProfile profile;
+    profile.id = 1;
+    profile.stackLevel = 1;
+    profile.chargingProfilePurpose = ChargingProfilePurposeEnum::TxDefaultProfile;
+    profile.chargingProfileKind = ChargingProfileKindEnum::Absolute;
+    profile.chargingSchedule.push_back(schedule);
+    this->database_handler.insert_or_update_charging_profile(DEFAULT_EVSE_ID, profile);
+
+    auto stmt = this->database_handler.new_statement("SELECT PROFILE FROM CHARGING_PROFILES");
+    ASSERT_EQ(stmt->step(), SQLITE_ROW);
+    EXPECT_LT(stmt->column_text(0).size(), json(profile).dump().size() / 2);
+
+    const auto profiles = this->database_handler.get_charging_profiles_for_evse(DEFAULT_EVSE_ID);
+    ASSERT_EQ(profiles.size(), 1);
+    EXPECT_EQ(json(profiles.at(0)), json(profile));
+}
+
 TEST_F(DatabaseHandlerTest, KO1_FR27_DatabaseWithNoData_InsertProfile) {
     ChargingProfile profile;
     profile.id = 1;
@@ -1293,3 +1563,75 @@ TEST_F(DatabaseHandlerTest, GetChargingProfilesMatchingCriteria_OnlyEVSEIDSet_Re
     EXPECT_THAT(
         sut, testing::Contains(testing::FieldsAre(profile1, DEFAULT_EVSE_ID, ChargingLimitSourceEnumStringType::CSO)));
 }
+
+TEST_F(DatabaseHandlerTest, DefaultTariffs_InsertGetAndDelete) {
+    Tariff tariff;
+    tariff.tariffId = "tariff-1";
+    tariff.currency = "EUR";
+    TariffEnergyPrice energy_price;
+    energy_price.priceKwh = 0.35F;
+    tariff.energy = TariffEnergy{{energy_price}};
+
+    this->database_handler.insert_or_update_default_tariff(STATION_WIDE_ID, tariff);
+    this->database_handler.insert_or_update_default_tariff(DEFAULT_EVSE_ID, tariff);
+
+    // Inserting the same tariff on the same EVSE replaces it
+    tariff.currency = "USD";
+    this->database_handler.insert_or_update_default_tariff(DEFAULT_EVSE_ID, tariff);
+
+    auto tariffs = this->database_handler.get_default_tariffs();
+    ASSERT_EQ(tariffs.size(), 2);
+    for (const auto& [evse_id, stored_tariff] : tariffs) {
+        EXPECT_EQ(stored_tariff.tariffId.get(), "tariff-1");
+        EXPECT_EQ(stored_tariff.currency.get(), evse_id == DEFAULT_EVSE_ID ? "USD" : "EUR");
+    }
+
+    EXPECT_TRUE(this->database_handler.delete_default_tariff(STATION_WIDE_ID, "tariff-1"));
+    EXPECT_FALSE(this->database_handler.delete_default_tariff(STATION_WIDE_ID, "tariff-1"));
+
+    tariffs = this->database_handler.get_default_tariffs();
+    ASSERT_EQ(tariffs.size(), 1);
+    EXPECT_EQ(tariffs.at(0).first, DEFAULT_EVSE_ID);
+}
+
+TEST_F(DatabaseHandlerTest, DERControls_InsertGetAndDelete) {
+    v21::SetDERControlRequest volt_var;
+    volt_var.isDefault = true;
+    volt_var.controlId = "volt-var";
+    volt_var.controlType = DERControlEnum::VoltVar;
+    DERCurve curve;
+    curve.curveData = {{95.0F, 40.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {105.0F, -40.0F}};
+    curve.priority = 0;
+    curve.yUnit = DERUnitEnum::PctMaxVar;
+    volt_var.curve = curve;
+
+    v21::SetDERControlRequest freq_watt = volt_var;
+    freq_watt.isDefault = false;
+    freq_watt.controlId = "freq-watt";
+    freq_watt.controlType = DERControlEnum::FreqWatt;
+
+    this->database_handler.insert_or_update_der_control(volt_var, false);
+    this->database_handler.insert_or_update_der_control(freq_watt, false);
+
+    // Inserting a control with the same id replaces it
+    this->database_handler.insert_or_update_der_control(freq_watt, true);
+
+    auto controls = this->database_handler.get_der_controls();
+    ASSERT_EQ(controls.size(), 2);
+    for (const auto& [control, is_superseded] : controls) {
+        EXPECT_EQ(is_superseded, control.controlId.get() == "freq-watt");
+        ASSERT_TRUE(control.curve.has_value());
+        EXPECT_EQ(control.curve->curveData.size(), 4);
+    }
+
+    // Only controls with the given isDefault are deleted
+    EXPECT_FALSE(this->database_handler.delete_der_controls(true, DERControlEnum::FreqWatt, std::nullopt));
+    EXPECT_TRUE(this->database_handler.delete_der_controls(false, DERControlEnum::FreqWatt, std::nullopt));
+
+    controls = this->database_handler.get_der_controls();
+    ASSERT_EQ(controls.size(), 1);
+    EXPECT_EQ(controls.at(0).control.controlId.get(), "volt-var");
+
+    EXPECT_TRUE(this->database_handler.delete_der_controls(true, std::nullopt, std::nullopt));
+    EXPECT_TRUE(this->database_handler.get_der_controls().empty());
+}
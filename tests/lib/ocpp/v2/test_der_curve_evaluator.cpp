@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/der_curve_evaluator.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+namespace {
+constexpr float EPSILON = 0.001F;
+
+// Volt-var curve in percent of the nominal voltage and percent of the maximum reactive power
+const std::vector<DERCurvePoints> VOLT_VAR{{92.0F, 44.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {108.0F, -44.0F}};
+} // namespace
+
+TEST(DERCurveEvaluatorTest, InterpolatesBetweenPointsAndClampsOutsideOfTheCurve) {
+    const DERCurveEvaluator evaluator({VOLT_VAR});
+    std::vector<float> outputs;
+
+    evaluator.evaluate({80.0F}, outputs);
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_NEAR(outputs.at(0), 44.0F, EPSILON);
+
+    evaluator.evaluate({95.0F}, outputs);
+    EXPECT_NEAR(outputs.at(0), 22.0F, EPSILON);
+
+    evaluator.evaluate({100.0F}, outputs);
+    EXPECT_NEAR(outputs.at(0), 0.0F, EPSILON);
+
+    evaluator.evaluate({106.5F}, outputs);
+    EXPECT_NEAR(outputs.at(0), -33.0F, EPSILON);
+
+    evaluator.evaluate({120.0F}, outputs);
+    EXPECT_NEAR(outputs.at(0), -44.0F, EPSILON);
+}
+
+TEST(DERCurveEvaluatorTest, EvaluatesCurvesWithDifferentNumbersOfPointsInOneBatch) {
+    // Unsorted points and a duplicate x
+    const std::vector<DERCurvePoints> freq_watt{{50.2F, 100.0F}, {51.5F, 0.0F}, {50.2F, 50.0F}};
+    const std::vector<DERCurvePoints> constant{{10.0F, 7.0F}};
+    const DERCurveEvaluator evaluator({VOLT_VAR, freq_watt, constant, {}});
+    ASSERT_EQ(evaluator.size(), 4);
+
+    std::vector<float> outputs;
+    evaluator.evaluate({104.0F, 50.85F, 0.0F, 3.0F}, outputs);
+    ASSERT_EQ(outputs.size(), 4);
+    EXPECT_NEAR(outputs.at(0), -14.6667F, EPSILON);
+    EXPECT_NEAR(outputs.at(1), 50.0F, EPSILON);
+    EXPECT_NEAR(outputs.at(2), 7.0F, EPSILON);
+    EXPECT_NEAR(outputs.at(3), 0.0F, EPSILON);
+}
+
+TEST(DERCurveEvaluatorTest, EmptyEvaluator) {
+    const DERCurveEvaluator evaluator;
+    std::vector<float> outputs{1.0F};
+    evaluator.evaluate({}, outputs);
+    EXPECT_EQ(evaluator.size(), 0);
+    EXPECT_TRUE(outputs.empty());
+}
+
+TEST(DERCurveEvaluatorTest, ThrowsIfInputsAreMissing) {
+    const DERCurveEvaluator evaluator({VOLT_VAR, VOLT_VAR});
+    std::vector<float> outputs;
+
+    EXPECT_THROW(evaluator.evaluate({100.0F}, outputs), std::invalid_argument);
+    EXPECT_TRUE(outputs.empty());
+
+    evaluator.evaluate({95.0F, 106.5F}, outputs);
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_NEAR(outputs.at(0), 22.0F, EPSILON);
+    EXPECT_NEAR(outputs.at(1), -33.0F, EPSILON);
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 
+#include <device_model_storage_interface_mock.hpp>
 #include <device_model_test_helper.hpp>
 
 #include <ocpp/v2/ctrlr_component_variables.hpp>
@@ -73,6 +74,201 @@ TEST_F(DeviceModelTest, test_min_limit_and_allow_zero) {
     ASSERT_EQ(r, 0);
 }
 
+TEST_F(DeviceModelTest, test_set_values_and_request_values) {
+    Component unknown_component;
+    unknown_component.name = "UnknownCtrlr";
+
+    std::vector<SetVariableData> set_variable_data(3);
+    set_variable_data[0].component = cv.component;
+    set_variable_data[0].variable = cv.variable.value();
+    set_variable_data[0].attributeValue = "60";
+    // not a valid integer
+    set_variable_data[1].component = cv.component;
+    set_variable_data[1].variable = cv.variable.value();
+    set_variable_data[1].attributeValue = "abc";
+    set_variable_data[2].component = unknown_component;
+    set_variable_data[2].variable = cv.variable.value();
+    set_variable_data[2].attributeValue = "60";
+
+    const auto set_results = dm->set_values(set_variable_data, "test");
+    ASSERT_EQ(set_results.size(), 3);
+    EXPECT_EQ(set_results[0], SetVariableStatusEnum::Accepted);
+    EXPECT_EQ(set_results[1], SetVariableStatusEnum::Rejected);
+    EXPECT_EQ(set_results[2], SetVariableStatusEnum::UnknownComponent);
+
+    std::vector<GetVariableData> get_variable_data(3);
+    get_variable_data[0].component = cv.component;
+    get_variable_data[0].variable = cv.variable.value();
+    get_variable_data[1].component = cv.component;
+    get_variable_data[1].variable = cv.variable.value();
+    get_variable_data[1].attributeType = AttributeEnum::Target;
+    get_variable_data[2].component = unknown_component;
+    get_variable_data[2].variable = cv.variable.value();
+
+    const auto get_results = dm->request_values(get_variable_data);
+    ASSERT_EQ(get_results.size(), 3);
+    EXPECT_EQ(get_results[0].attributeStatus, GetVariableStatusEnum::Accepted);
+    ASSERT_TRUE(get_results[0].attributeValue.has_value());
+    EXPECT_EQ(get_results[0].attributeValue.value().get(), "60");
+    EXPECT_EQ(get_results[1].attributeStatus, GetVariableStatusEnum::NotSupportedAttributeType);
+    EXPECT_EQ(get_results[2].attributeStatus, GetVariableStatusEnum::UnknownComponent);
+
+    EXPECT_EQ(dm->get_value<int>(cv), 60);
+}
+
+TEST_F(DeviceModelTest, test_set_values_notifies_listener_once_after_batch) {
+    const RequiredComponentVariable tx_ended_cv = ControllerComponentVariables::AlignedDataTxEndedInterval;
+    std::vector<SetMonitoringData> monitors(2);
+    for (auto& monitor : monitors) {
+        monitor.value = 3600;
+        monitor.type = MonitorEnum::Periodic;
+        monitor.severity = 5;
+    }
+    monitors[0].component = cv.component;
+    monitors[0].variable = cv.variable.value();
+    monitors[1].component = tx_ended_cv.component;
+    monitors[1].variable = tx_ended_cv.variable.value();
+    for (const auto& result : dm->set_monitors(monitors)) {
+        ASSERT_EQ(result.status, SetMonitoringStatusEnum::Accepted);
+    }
+
+    int variable_listener_calls = 0;
+    dm->register_variable_listener([&variable_listener_calls](auto&&...) { variable_listener_calls++; });
+
+    std::vector<std::vector<std::string>> notified_changes;
+    dm->register_variables_listener(
+        [this, &notified_changes, &tx_ended_cv](const std::vector<VariableChange>& changes) {
+            std::vector<std::string> values;
+            for (const auto& change : changes) {
+                values.push_back(change.value_previous + "->" + change.value_current);
+            }
+            notified_changes.push_back(values);
+            // The whole batch has been committed when the listener is called
+            EXPECT_EQ(dm->get_value<int>(cv), 60);
+            EXPECT_EQ(dm->get_value<int>(tx_ended_cv), 120);
+        });
+
+    const auto old_interval = dm->get_value<std::string>(cv);
+    const auto old_tx_ended_interval = dm->get_value<std::string>(tx_ended_cv);
+
+    std::vector<SetVariableData> set_variable_data(2);
+    set_variable_data[0].component = cv.component;
+    set_variable_data[0].variable = cv.variable.value();
+    set_variable_data[0].attributeValue = "60";
+    set_variable_data[1].component = tx_ended_cv.component;
+    set_variable_data[1].variable = tx_ended_cv.variable.value();
+    set_variable_data[1].attributeValue = "120";
+
+    const auto set_results = dm->set_values(set_variable_data, "test");
+    ASSERT_EQ(set_results.size(), 2);
+    EXPECT_EQ(set_results[0], SetVariableStatusEnum::Accepted);
+    EXPECT_EQ(set_results[1], SetVariableStatusEnum::Accepted);
+
+    ASSERT_EQ(notified_changes.size(), 1);
+    EXPECT_EQ(notified_changes[0], (std::vector<std::string>{old_interval + "->60", old_tx_ended_interval + "->120"}));
+    EXPECT_EQ(variable_listener_calls, 0);
+
+    // Unchanged values are not notified
+    dm->set_values(set_variable_data, "test");
+    EXPECT_EQ(notified_changes.size(), 1);
+}
+
+TEST_F(DeviceModelTest, test_set_values_applies_repeated_variable_in_order) {
+    SetMonitoringData monitor;
+    monitor.value = 3600;
+    monitor.type = MonitorEnum::Periodic;
+    monitor.severity = 5;
+    monitor.component = cv.component;
+    monitor.variable = cv.variable.value();
+    ASSERT_EQ(dm->set_monitors({monitor}).at(0).status, SetMonitoringStatusEnum::Accepted);
+
+    std::vector<std::string> notified_changes;
+    dm->register_variables_listener([&notified_changes](const std::vector<VariableChange>& changes) {
+        for (const auto& change : changes) {
+            notified_changes.push_back(change.value_previous + "->" + change.value_current);
+        }
+    });
+
+    const auto old_interval = dm->get_value<std::string>(cv);
+
+    std::vector<SetVariableData> set_variable_data(2);
+    for (auto& data : set_variable_data) {
+        data.component = cv.component;
+        data.variable = cv.variable.value();
+    }
+    set_variable_data[0].attributeValue = "60";
+    set_variable_data[1].attributeValue = "120";
+
+    const auto set_results = dm->set_values(set_variable_data, "test");
+    ASSERT_EQ(set_results.size(), 2);
+    EXPECT_EQ(set_results[0], SetVariableStatusEnum::Accepted);
+    EXPECT_EQ(set_results[1], SetVariableStatusEnum::Accepted);
+
+    // The second value is applied on top of the first one
+    EXPECT_EQ(notified_changes, (std::vector<std::string>{old_interval + "->60", "60->120"}));
+    EXPECT_EQ(dm->get_value<int>(cv), 120);
+}
+
+TEST(DeviceModelStorageInterfaceTest, test_batch_access_defaults_to_single_item_access) {
+    auto storage = std::make_unique<::testing::NiceMock<DeviceModelStorageMock>>();
+    auto& storage_mock = *storage;
+    const RequiredComponentVariable& cv = ControllerComponentVariables::AlignedDataInterval;
+
+    VariableMetaData meta_data;
+    meta_data.characteristics.dataType = DataEnum::integer;
+    meta_data.characteristics.supportsMonitoring = true;
+    DeviceModelMap device_model_map;
+    device_model_map[cv.component][cv.variable.value()] = meta_data;
+    EXPECT_CALL(storage_mock, get_device_model()).WillOnce(::testing::Return(device_model_map));
+
+    // A storage that only implements the single item access uses the default batch implementations
+    ON_CALL(storage_mock, get_variable_attributes_batch)
+        .WillByDefault([&storage_mock](const std::vector<VariableAttributeKey>& keys) {
+            return storage_mock.DeviceModelStorageInterface::get_variable_attributes_batch(keys);
+        });
+    ON_CALL(storage_mock, set_variable_attribute_values_batch)
+        .WillByDefault([&storage_mock](const std::vector<VariableAttributeValueUpdate>& updates) {
+            return storage_mock.DeviceModelStorageInterface::set_variable_attribute_values_batch(updates);
+        });
+
+    VariableAttribute attribute;
+    attribute.type = AttributeEnum::Actual;
+    attribute.mutability = MutabilityEnum::ReadWrite;
+    attribute.value = "900";
+    EXPECT_CALL(storage_mock, get_variable_attributes(cv.component, cv.variable.value(),
+                                                      std::optional<AttributeEnum>(AttributeEnum::Actual)))
+        .WillRepeatedly(::testing::Return(std::vector<VariableAttribute>{attribute}));
+    EXPECT_CALL(storage_mock, get_variable_attributes(cv.component, cv.variable.value(),
+                                                      std::optional<AttributeEnum>(AttributeEnum::Target)))
+        .WillRepeatedly(::testing::Return(std::vector<VariableAttribute>{}));
+    EXPECT_CALL(storage_mock,
+                set_variable_attribute_value(cv.component, cv.variable.value(), AttributeEnum::Actual, "60", "test"))
+        .WillOnce(::testing::Return(SetVariableStatusEnum::Accepted));
+
+    DeviceModel device_model(std::move(storage));
+
+    std::vector<GetVariableData> get_variable_data(2);
+    get_variable_data[0].component = cv.component;
+    get_variable_data[0].variable = cv.variable.value();
+    get_variable_data[1].component = cv.component;
+    get_variable_data[1].variable = cv.variable.value();
+    get_variable_data[1].attributeType = AttributeEnum::Target;
+
+    const auto get_results = device_model.request_values(get_variable_data);
+    ASSERT_EQ(get_results.size(), 2);
+    EXPECT_EQ(get_results[0].attributeStatus, GetVariableStatusEnum::Accepted);
+    ASSERT_TRUE(get_results[0].attributeValue.has_value());
+    EXPECT_EQ(get_results[0].attributeValue.value().get(), "900");
+    EXPECT_EQ(get_results[1].attributeStatus, GetVariableStatusEnum::NotSupportedAttributeType);
+
+    SetVariableData set_variable_data;
+    set_variable_data.component = cv.component;
+    set_variable_data.variable = cv.variable.value();
+    set_variable_data.attributeValue = "60";
+    EXPECT_EQ(device_model.set_values({set_variable_data}, "test"),
+              std::vector<SetVariableStatusEnum>{SetVariableStatusEnum::Accepted});
+}
+
 TEST_F(DeviceModelTest, test_component_as_key_in_map) {
     std::map<Component, std::int32_t> components_to_ints;
 
@@ -411,6 +411,43 @@ TEST_F(InitDeviceModelDbTest, init_db) {
     EXPECT_FALSE(component_exists("UnitTestCtrlr", std::nullopt, 1, 5));
 }
 
+TEST_F(InitDeviceModelDbTest, component_config_fingerprint) {
+    const auto fingerprint = get_component_config_fingerprint(CONFIGS_PATH);
+    EXPECT_EQ(fingerprint.size(), 64);
+    EXPECT_EQ(fingerprint, get_component_config_fingerprint(CONFIGS_PATH));
+    EXPECT_NE(fingerprint, get_component_config_fingerprint(CONFIGS_PATH_CHANGED));
+}
+
+TEST_F(InitDeviceModelDbTest, unchanged_component_config_is_skipped) {
+    InitDeviceModelDb db(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db.database_exists = false;
+    EXPECT_TRUE(db.initialize_database(std::filesystem::path(CONFIGS_PATH), true));
+    EXPECT_TRUE(variable_exists("EVSE", std::nullopt, 1, std::nullopt, "ISO15118EvseId", std::nullopt));
+
+    // Same config files: nothing to do
+    InitDeviceModelDb db2(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db2.database_exists = true;
+    EXPECT_FALSE(db2.initialize_database(std::filesystem::path(CONFIGS_PATH), false));
+
+    // Changed config files are applied
+    InitDeviceModelDb db3(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db3.database_exists = true;
+    EXPECT_TRUE(db3.initialize_database(std::filesystem::path(CONFIGS_PATH_CHANGED), false));
+    EXPECT_FALSE(variable_exists("EVSE", std::nullopt, 1, std::nullopt, "ISO15118EvseId", std::nullopt));
+    EXPECT_TRUE(variable_exists("Connector", std::nullopt, 1, 1, "Enabled", std::nullopt));
+
+    // Initializing from a component config map removes the stored fingerprint, so the config files are applied again
+    InitDeviceModelDb db4(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db4.database_exists = true;
+    ASSERT_NO_THROW(db4.initialize_database(get_all_component_configs(CONFIGS_PATH), false));
+    EXPECT_TRUE(variable_exists("EVSE", std::nullopt, 1, std::nullopt, "ISO15118EvseId", std::nullopt));
+
+    InitDeviceModelDb db5(DATABASE_PATH, MIGRATION_FILES_PATH);
+    db5.database_exists = true;
+    EXPECT_TRUE(db5.initialize_database(std::filesystem::path(CONFIGS_PATH_CHANGED), false));
+    EXPECT_FALSE(variable_exists("EVSE", std::nullopt, 1, std::nullopt, "ISO15118EvseId", std::nullopt));
+}
+
 TEST_F(InitDeviceModelDbTest, wrong_migration_file_path) {
     InitDeviceModelDb db(DATABASE_PATH, "/tmp/thisdoesnotexisthopefully");
     // The migration script is not correct (there is none in the given folder), this should throw an exception.
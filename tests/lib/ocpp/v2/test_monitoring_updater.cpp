@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <device_model_test_helper.hpp>
+
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/monitoring_updater.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+class MonitoringUpdaterTest : public ::testing::Test {
+protected:
+    /// \brief Event as received by the CSMS callback, with the time it was received
+    struct ReceivedEvent {
+        std::chrono::steady_clock::time_point received_at;
+        EventData event;
+    };
+
+    DeviceModelTestHelper device_model_test_helper;
+    DeviceModel* dm;
+    const RequiredComponentVariable interval_cv = ControllerComponentVariables::AlignedDataInterval;
+    const RequiredComponentVariable tx_ended_interval_cv = ControllerComponentVariables::AlignedDataTxEndedInterval;
+    const RequiredComponentVariable limit_change_significance_cv = ControllerComponentVariables::LimitChangeSignificance;
+
+    std::mutex events_mutex;
+    std::condition_variable events_cv;
+    std::vector<ReceivedEvent> events;
+    std::unique_ptr<MonitoringUpdater> monitoring_updater;
+
+    MonitoringUpdaterTest() : device_model_test_helper(), dm(device_model_test_helper.get_device_model()) {
+        const auto& enabled = ControllerComponentVariables::MonitoringCtrlrEnabled;
+        dm->set_value(enabled.component, enabled.variable.value(), AttributeEnum::Actual, "true", "test", true);
+
+        this->monitoring_updater = std::make_unique<MonitoringUpdater>(
+            *dm,
+            [this](const std::vector<EventData>& notify_events) {
+                const auto now = std::chrono::steady_clock::now();
+                {
+                    const std::lock_guard<std::mutex> lock(this->events_mutex);
+                    for (const auto& event : notify_events) {
+                        this->events.push_back({now, event});
+                    }
+                }
+                this->events_cv.notify_all();
+            },
+            []() { return false; });
+    }
+
+    ~MonitoringUpdaterTest() override {
+        this->monitoring_updater.reset();
+    }
+
+    std::int32_t set_monitor(const RequiredComponentVariable& cv, const MonitorEnum type, const float value) {
+        SetMonitoringData request;
+        request.value = value;
+        request.type = type;
+        request.severity = 5;
+        request.component = cv.component;
+        request.variable = cv.variable.value();
+
+        const auto results = dm->set_monitors({request});
+        EXPECT_EQ(results.size(), 1);
+        EXPECT_EQ(results.at(0).status, SetMonitoringStatusEnum::Accepted);
+        return results.at(0).id.value_or(-1);
+    }
+
+    /// \brief Waits until an event of \p monitor_id was received or \p timeout passed
+    /// \returns the time at which the first event of \p monitor_id was received
+    std::optional<std::chrono::steady_clock::time_point> wait_for_event(const std::int32_t monitor_id,
+                                                                         const std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(this->events_mutex);
+        std::optional<std::chrono::steady_clock::time_point> received_at;
+        this->events_cv.wait_for(lock, timeout, [&]() {
+            for (const auto& received : this->events) {
+                if (received.event.variableMonitoringId == monitor_id) {
+                    received_at = received.received_at;
+                    return true;
+                }
+            }
+            return false;
+        });
+        return received_at;
+    }
+
+    std::size_t count_events(const std::int32_t monitor_id) {
+        const std::lock_guard<std::mutex> lock(this->events_mutex);
+        return std::count_if(this->events.begin(), this->events.end(), [monitor_id](const ReceivedEvent& received) {
+            return received.event.variableMonitoringId == monitor_id;
+        });
+    }
+};
+
+TEST_F(MonitoringUpdaterTest, PeriodicMonitorIsProcessedWhenDueAndNotDelayedByLongerInterval) {
+    const auto due_monitor = set_monitor(interval_cv, MonitorEnum::Periodic, 1.0F);
+    const auto long_monitor = set_monitor(tx_ended_interval_cv, MonitorEnum::Periodic, 3600.0F);
+
+    const auto start = std::chrono::steady_clock::now();
+    monitoring_updater->start_monitoring();
+
+    const auto received_at = wait_for_event(due_monitor, std::chrono::seconds(5));
+    ASSERT_TRUE(received_at.has_value());
+    const auto elapsed = received_at.value() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(900));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2500));
+    EXPECT_EQ(count_events(long_monitor), 0);
+}
+
+TEST_F(MonitoringUpdaterTest, TriggeredMonitorIsProcessedAfterProcessingIntervalBeforeNextPeriodicMonitor) {
+    set_monitor(tx_ended_interval_cv, MonitorEnum::Periodic, 3600.0F);
+    const auto threshold_monitor = set_monitor(limit_change_significance_cv, MonitorEnum::UpperThreshold, 50.0F);
+    monitoring_updater->start_monitoring();
+
+    // The trigger is only cached while the value is changed, the timer picks it up after the processing interval
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(dm->set_value(limit_change_significance_cv.component, limit_change_significance_cv.variable.value(),
+                            AttributeEnum::Actual, "60", "test"),
+              SetVariableStatusEnum::Accepted);
+
+    const auto received_at = wait_for_event(threshold_monitor, std::chrono::seconds(5));
+    ASSERT_TRUE(received_at.has_value());
+    EXPECT_LT(received_at.value() - start, std::chrono::milliseconds(2500));
+}
+
+TEST_F(MonitoringUpdaterTest, ScheduleIsUpdatedWhenMonitorsAreAddedAndRemoved) {
+    set_monitor(tx_ended_interval_cv, MonitorEnum::Periodic, 3600.0F);
+    monitoring_updater->start_monitoring();
+
+    // A monitor with a shorter interval than the one the timer waits for is processed in time
+    const auto added_monitor = set_monitor(interval_cv, MonitorEnum::Periodic, 1.0F);
+    const auto added_at = std::chrono::steady_clock::now();
+    monitoring_updater->update_periodic_monitors();
+
+    const auto received_at = wait_for_event(added_monitor, std::chrono::seconds(5));
+    ASSERT_TRUE(received_at.has_value());
+    EXPECT_LT(received_at.value() - added_at, std::chrono::milliseconds(2500));
+
+    // A removed monitor is no longer processed, although it is still in the schedule
+    dm->clear_monitors({added_monitor}, true);
+    monitoring_updater->update_periodic_monitors();
+    const auto events_after_removal = count_events(added_monitor);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+    EXPECT_EQ(count_events(added_monitor), events_after_removal);
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/common/call_types.hpp>
+#include <ocpp/v2/notify_event_batcher.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+class NotifyEventBatcherTest : public ::testing::Test {
+protected:
+    static std::vector<EventData> create_events(const std::int32_t count, const std::int32_t first_id = 0) {
+        std::vector<EventData> events;
+        for (std::int32_t i = 0; i < count; ++i) {
+            EventData event;
+            event.eventId = first_id + i;
+            event.timestamp = DateTime();
+            event.trigger = EventTriggerEnum::Alerting;
+            event.actualValue = "230.0";
+            event.eventNotificationType = EventNotificationEnum::CustomMonitor;
+            event.component.name = "EVSE";
+            event.variable.name = "Voltage";
+            event.variableMonitoringId = first_id + i;
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    static std::size_t get_call_size(const NotifyEventRequest& req) {
+        const Call<NotifyEventRequest> call(req);
+        return json(call).dump().size();
+    }
+
+    // Verify that the requests form a valid sequence that contains all events in order
+    static void check_sequence(const std::vector<NotifyEventRequest>& requests, const std::int32_t event_count) {
+        std::int32_t expected_event_id = 0;
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            EXPECT_EQ(requests[i].seqNo, i);
+            ASSERT_TRUE(requests[i].tbc.has_value());
+            EXPECT_EQ(requests[i].tbc.value(), i + 1 < requests.size());
+            EXPECT_EQ(requests[i].generatedAt.to_rfc3339(), requests[0].generatedAt.to_rfc3339());
+            for (const auto& event : requests[i].eventData) {
+                EXPECT_EQ(event.eventId, expected_event_id++);
+            }
+        }
+        EXPECT_EQ(expected_event_id, event_count);
+    }
+};
+
+TEST_F(NotifyEventBatcherTest, test_no_pending_events) {
+    NotifyEventBatcher batcher{10, 0};
+
+    EXPECT_TRUE(batcher.empty());
+    EXPECT_TRUE(batcher.take_requests().empty());
+}
+
+TEST_F(NotifyEventBatcherTest, test_burst_combined_into_single_request) {
+    NotifyEventBatcher batcher{0, 0};
+
+    EXPECT_FALSE(batcher.add(create_events(5)));
+    EXPECT_FALSE(batcher.add(create_events(5, 5)));
+    EXPECT_FALSE(batcher.empty());
+
+    const auto requests = batcher.take_requests();
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(requests[0].eventData.size(), 10);
+    check_sequence(requests, 10);
+    EXPECT_TRUE(batcher.empty());
+}
+
+TEST_F(NotifyEventBatcherTest, test_split_by_items_per_message) {
+    NotifyEventBatcher batcher{4, 0};
+
+    EXPECT_TRUE(batcher.add(create_events(10)));
+
+    const auto requests = batcher.take_requests();
+    ASSERT_EQ(requests.size(), 3);
+    EXPECT_EQ(requests[0].eventData.size(), 4);
+    EXPECT_EQ(requests[1].eventData.size(), 4);
+    EXPECT_EQ(requests[2].eventData.size(), 2);
+    check_sequence(requests, 10);
+}
+
+TEST_F(NotifyEventBatcherTest, test_split_by_bytes_per_message) {
+    const auto events = create_events(20);
+
+    // Determine the size of a message holding three events to use as the limit
+    NotifyEventBatcher reference_batcher{3, 0};
+    reference_batcher.add(events);
+    const auto max_bytes = get_call_size(reference_batcher.take_requests().at(0));
+
+    NotifyEventBatcher batcher{0, max_bytes};
+    EXPECT_TRUE(batcher.add(events));
+
+    const auto requests = batcher.take_requests();
+    ASSERT_GT(requests.size(), 1);
+    for (const auto& request : requests) {
+        EXPECT_LE(get_call_size(request), max_bytes);
+        EXPECT_GE(request.eventData.size(), 1);
+    }
+    check_sequence(requests, 20);
+}
+
+TEST_F(NotifyEventBatcherTest, test_event_larger_than_bytes_per_message) {
+    NotifyEventBatcher batcher{0, 10};
+
+    EXPECT_TRUE(batcher.add(create_events(2)));
+
+    // Events are never dropped, oversized events are sent in a request of their own
+    const auto requests = batcher.take_requests();
+    ASSERT_EQ(requests.size(), 2);
+    check_sequence(requests, 2);
+}
+
+} // namespace v2
+} // namespace ocpp
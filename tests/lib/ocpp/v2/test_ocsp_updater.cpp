@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2020 - 2023 Pionix GmbH and Contributors to EVerest
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -106,6 +108,24 @@ protected:
     void TearDown() override {
     }
 
+    // Expects the status request of example cert index, followed by the cache update with response
+    void expect_status_update(testing::Sequence& seq, const std::size_t index,
+                              const v2::GetCertificateStatusResponse& response, const bool signal_complete = false) {
+        EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[index]))
+            .Times(1)
+            .InSequence(seq)
+            .WillOnce(testing::Return(response));
+        auto& update = EXPECT_CALL(*this->evse_security,
+                                   update_ocsp_cache(this->example_hash_data[index], response.ocspResult.value()))
+                           .Times(1)
+                           .InSequence(seq);
+        if (signal_complete) {
+            update.WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
+        } else {
+            update.WillOnce(testing::Return());
+        }
+    }
+
     v2::cert_status_func status_update;
     std::shared_ptr<EvseSecurityMock> evse_security;
     std::shared_ptr<ChargePointMock> charge_point;
@@ -130,38 +150,17 @@ TEST_F(OcspUpdaterTest, test_success_boot_many) {
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[0]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[1]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[2]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[0], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[1], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[2], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
+    // Every status is written to the cache as soon as it is received
+    this->expect_status_update(seq, 0, response_success);
+    this->expect_status_update(seq, 1, response_success);
+    this->expect_status_update(seq, 2, response_success, true);
 
     ocsp_updater->start();
     this->calls_complete.timed_wait(boost::posix_time::second_clock::universal_time() + boost::posix_time::seconds(5));
     ocsp_updater->stop();
 }
 
-/// \brief Tests retry logic on CSMS failure to update, multiple certs
+/// \brief Tests retry logic on CSMS failure to update, multiple certs. Only the failed certs are retried
 TEST_F(OcspUpdaterTest, test_retry_boot_many) {
     auto ocsp_updater = std::make_unique<v2::OcspUpdater>(this->evse_security, this->status_update,
                                                           std::chrono::hours(167), std::chrono::seconds(0));
@@ -183,16 +182,9 @@ TEST_F(OcspUpdaterTest, test_retry_boot_many) {
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(response_fail_status));
-
-    EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[0]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[1]))
+    // A failure does not stop the update of the other certs
+    this->expect_status_update(seq, 1, response_success);
+    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[2]))
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(response_fail_empty));
@@ -201,31 +193,8 @@ TEST_F(OcspUpdaterTest, test_retry_boot_many) {
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[0]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[1]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[2]))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return(response_success));
-
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[0], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[1], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(this->example_hash_data[2], "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
+    this->expect_status_update(seq, 0, response_success);
+    this->expect_status_update(seq, 2, response_success, true);
 
     ocsp_updater->start();
     this->calls_complete.timed_wait(boost::posix_time::second_clock::universal_time() + boost::posix_time::seconds(5));
@@ -246,45 +215,88 @@ TEST_F(OcspUpdaterTest, test_reverify_logic) {
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(testing::_))
-        .Times(3)
-        .InSequence(seq)
-        .WillRepeatedly(testing::Return(response_success));
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
-        .Times(3)
-        .InSequence(seq)
-        .WillRepeatedly(testing::Return());
+    this->expect_status_update(seq, 0, response_success);
+    this->expect_status_update(seq, 1, response_success);
+    this->expect_status_update(seq, 2, response_success);
 
     EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(testing::_))
-        .Times(3)
-        .InSequence(seq)
-        .WillRepeatedly(testing::Return(response_success));
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
-        .Times(2)
+    this->expect_status_update(seq, 0, response_success);
+    this->expect_status_update(seq, 1, response_success);
+    this->expect_status_update(seq, 2, response_success, true);
+
+    EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
         .InSequence(seq)
-        .WillRepeatedly(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
+        .WillRepeatedly(testing::Return(std::vector<OCSPRequestData>()));
+
+    ocsp_updater->start();
+    this->calls_complete.timed_wait(boost::posix_time::second_clock::universal_time() + boost::posix_time::seconds(5));
+    ocsp_updater->stop();
+}
+
+/// \brief Tests a cert is re-verified before the update interval if its OCSP response is outdated
+TEST_F(OcspUpdaterTest, test_reverify_outdated_response) {
+    auto ocsp_updater = std::make_unique<v2::OcspUpdater>(this->evse_security, this->status_update,
+                                                          std::chrono::hours(167), std::chrono::seconds(0));
+
+    testing::Sequence seq;
+    // Base64 encoded OCSP response with a nextUpdate of 2020-01-08
+    const std::string outdated_ocsp_result =
+        "MIIBIwoBAKCCARwwggEYBgkrBgEFBQcwAQEEggEJMIIBBTCBrKEWMBQxEjAQBgNVBAMMCU9DU1BfVEVTVBgPMjAyNjEwMTgxMzE0"
+        "NDZaMIGAMH4wVjANBglghkgBZQMEAgEFAAQg8a5nhE6C4r0jiJSHmx8oTQx3vgTScTx4Z7YG7O9Ex5gEIGpKcY4D/vSxP4rnmgK3"
+        "ATPSJSdDekadP7NNuFaWwDy0AgEBgAAYDzIwMjAwMTAxMDAwMDAwWqARGA8yMDIwMDEwODAwMDAwMFowCgYIKoZIzj0EAwIDSAAw"
+        "RQIgDc8odm7nP3FxR1ymgJuM9otkgkK8JEssgJyG+1m56GoCIQCKfAG9AFxZxwpFHd8XoEwqoL5DOYQYBKRhJjN4dPIkRQ==";
+    v2::GetCertificateStatusResponse response_outdated;
+    response_outdated.ocspResult = outdated_ocsp_result;
+    response_outdated.status = v2::GetCertificateStatusEnum::Accepted;
+    v2::GetCertificateStatusResponse response_success;
+    response_success.ocspResult = "EXAMPLE OCSP RESULT";
+    response_success.status = v2::GetCertificateStatusEnum::Accepted;
+
+    const std::vector<OCSPRequestData> ocsp_data{this->example_ocsp_data[0]};
+    EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
         .Times(1)
         .InSequence(seq)
-        .WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
+        .WillOnce(testing::Return(ocsp_data));
+    this->expect_status_update(seq, 0, response_outdated);
 
     EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
+        .Times(1)
         .InSequence(seq)
-        .WillRepeatedly(testing::Return(std::vector<OCSPRequestData>()));
+        .WillOnce(testing::Return(ocsp_data));
+    this->expect_status_update(seq, 0, response_success, true);
 
     ocsp_updater->start();
     this->calls_complete.timed_wait(boost::posix_time::second_clock::universal_time() + boost::posix_time::seconds(5));
     ocsp_updater->stop();
 }
 
-/// \brief Tests triggering an update before the deadline
-TEST_F(OcspUpdaterTest, test_trigger) {
+/// \brief Tests a cert whose cached OCSP response is still valid is not updated on boot
+TEST_F(OcspUpdaterTest, test_cached_response_not_updated_on_boot) {
     auto ocsp_updater = std::make_unique<v2::OcspUpdater>(this->evse_security, this->status_update);
 
+    // Base64 encoded OCSP response with a thisUpdate of 2099-12-01 and a nextUpdate of 2099-12-31
+    const std::string valid_ocsp_result =
+        "MIIBIwoBAKCCARwwggEYBgkrBgEFBQcwAQEEggEJMIIBBTCBrKEWMBQxEjAQBgNVBAMMCU9DU1BfVEVTVBgPMjAyNjEwMTgxMzE0"
+        "NDZaMIGAMH4wVjANBglghkgBZQMEAgEFAAQg8a5nhE6C4r0jiJSHmx8oTQx3vgTScTx4Z7YG7O9Ex5gEIGpKcY4D/vSxP4rnmgK3"
+        "ATPSJSdDekadP7NNuFaWwDy0AgEBgAAYDzIwOTkxMjAxMDAwMDAwWqARGA8yMDk5MTIzMTAwMDAwMFowCgYIKoZIzj0EAwIDSAAw"
+        "RQIgDc8odm7nP3FxR1ymgJuM9otkgkK8JEssgJyG+1m56GoCIQCKfAG9AFxZxwpFHd8XoEwqoL5DOYQYBKRhJjN4dPIkRQ==";
+    const auto ocsp_path = std::filesystem::temp_directory_path() / "libocpp_test_cached_response.ocsp.der";
+    std::ofstream(ocsp_path) << valid_ocsp_result;
+
+    CertificateInfo certificate_info;
+    certificate_info.certificate_count = 1;
+    certificate_info.ocsp.push_back({this->example_hash_data[0], ocsp_path});
+    // The second cert has no cached response
+    certificate_info.ocsp.push_back({this->example_hash_data[1], std::nullopt});
+    GetCertificateInfoResult certificate_info_result;
+    certificate_info_result.status = GetCertificateInfoStatus::Accepted;
+    certificate_info_result.info = certificate_info;
+    EXPECT_CALL(*this->evse_security, get_leaf_certificate_info(CertificateSigningUseEnum::V2GCertificate, true))
+        .WillOnce(testing::Return(certificate_info_result));
+
     testing::Sequence seq;
     v2::GetCertificateStatusResponse response_success;
     response_success.ocspResult = "EXAMPLE OCSP RESULT";
@@ -294,32 +306,51 @@ TEST_F(OcspUpdaterTest, test_trigger) {
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(testing::_))
-        .Times(3)
-        .InSequence(seq)
-        .WillRepeatedly(testing::Return(response_success));
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
-        .Times(2)
-        .InSequence(seq)
-        .WillRepeatedly(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
-        .Times(1)
-        .InSequence(seq)
-        .WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
+    EXPECT_CALL(*this->charge_point, get_certificate_status(this->example_status_requests[0])).Times(0);
+    this->expect_status_update(seq, 1, response_success);
+    this->expect_status_update(seq, 2, response_success, true);
+
+    ocsp_updater->start();
+    this->calls_complete.timed_wait(boost::posix_time::second_clock::universal_time() + boost::posix_time::seconds(5));
+    ocsp_updater->stop();
+    std::filesystem::remove(ocsp_path);
+}
+
+/// \brief Tests triggering an update before the deadline. Only the newly installed cert is updated
+TEST_F(OcspUpdaterTest, test_trigger) {
+    auto ocsp_updater = std::make_unique<v2::OcspUpdater>(this->evse_security, this->status_update);
+
+    testing::Sequence seq;
+    v2::GetCertificateStatusResponse response_success;
+    response_success.ocspResult = "EXAMPLE OCSP RESULT";
+    response_success.status = v2::GetCertificateStatusEnum::Accepted;
 
     EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
         .Times(1)
         .InSequence(seq)
         .WillOnce(testing::Return(this->example_ocsp_data));
-    EXPECT_CALL(*this->charge_point, get_certificate_status(testing::_))
-        .Times(3)
+    this->expect_status_update(seq, 0, response_success);
+    this->expect_status_update(seq, 1, response_success);
+    this->expect_status_update(seq, 2, response_success, true);
+
+    OCSPRequestData ocsp4 = this->example_ocsp_data[0];
+    ocsp4.serialNumber = "serial4";
+    auto ocsp_data = this->example_ocsp_data;
+    ocsp_data.push_back(ocsp4);
+    v2::GetCertificateStatusRequest example_get_cert_status_request_4 = this->example_status_requests[0];
+    example_get_cert_status_request_4.ocspRequestData.serialNumber = "serial4";
+    CertificateHashDataType certificate_hash_data4 = this->example_hash_data[0];
+    certificate_hash_data4.serialNumber = "serial4";
+
+    EXPECT_CALL(*this->evse_security, get_v2g_ocsp_request_data())
+        .Times(1)
         .InSequence(seq)
-        .WillRepeatedly(testing::Return(response_success));
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
-        .Times(2)
+        .WillOnce(testing::Return(ocsp_data));
+    EXPECT_CALL(*this->charge_point, get_certificate_status(example_get_cert_status_request_4))
+        .Times(1)
         .InSequence(seq)
-        .WillRepeatedly(testing::Return());
-    EXPECT_CALL(*this->evse_security, update_ocsp_cache(testing::_, "EXAMPLE OCSP RESULT"))
+        .WillOnce(testing::Return(response_success));
+    EXPECT_CALL(*this->evse_security, update_ocsp_cache(certificate_hash_data4, "EXAMPLE OCSP RESULT"))
         .Times(1)
         .InSequence(seq)
         .WillOnce(SignalCallsCompleteVoid(&this->calls_complete));
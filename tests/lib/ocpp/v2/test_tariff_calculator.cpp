@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/tariff_calculator.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+namespace {
+constexpr double EPSILON = 0.0001;
+// Monday
+const DateTime START{"2025-01-06T10:00:00Z"};
+
+DateTime at(const std::chrono::minutes offset) {
+    return DateTime(START.to_time_point() + offset);
+}
+
+TariffMeterSample create_sample(const DateTime& timestamp, const double energy_wh, const bool charging = true) {
+    TariffMeterSample sample;
+    sample.timestamp = timestamp;
+    sample.energy_wh = energy_wh;
+    sample.charging = charging;
+    return sample;
+}
+
+TariffEnergyPrice create_energy_price(const float price_kwh,
+                                      const std::optional<TariffConditions>& conditions = std::nullopt) {
+    TariffEnergyPrice price;
+    price.priceKwh = price_kwh;
+    price.conditions = conditions;
+    return price;
+}
+
+TariffTimePrice create_time_price(const float price_minute) {
+    TariffTimePrice price;
+    price.priceMinute = price_minute;
+    return price;
+}
+
+Tariff create_tariff(const std::vector<TariffEnergyPrice>& energy_prices) {
+    Tariff tariff;
+    tariff.tariffId = "tariff";
+    tariff.currency = "EUR";
+    if (!energy_prices.empty()) {
+        tariff.energy = TariffEnergy{energy_prices};
+    }
+    return tariff;
+}
+
+Price create_price(const float excl_tax) {
+    Price price;
+    price.exclTax = excl_tax;
+    return price;
+}
+} // namespace
+
+TEST(TariffCalculatorTest, EnergyIsPricedPerKwh) {
+    TariffCalculator calculator(create_tariff({create_energy_price(0.30F)}), create_sample(START, 1000));
+
+    calculator.update(create_sample(at(std::chrono::minutes(30)), 6000));
+    calculator.update(create_sample(at(std::chrono::minutes(60)), 11000));
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 3.0, EPSILON);
+    EXPECT_NEAR(calculator.get_cost().incl_tax, 3.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, ChargingAndIdleTimeArePricedPerMinute) {
+    auto tariff = create_tariff({});
+    tariff.chargingTime = TariffTime{{create_time_price(0.06F)}};
+    tariff.idleTime = TariffTime{{create_time_price(0.50F)}};
+    TariffCalculator calculator(tariff, create_sample(START, 0));
+
+    // The EV stops charging after 30 minutes and stays idle for 10 minutes
+    calculator.update(create_sample(at(std::chrono::minutes(30)), 5000, false));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 1.8, EPSILON);
+
+    calculator.update(create_sample(at(std::chrono::minutes(40)), 5000, false));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 6.8, EPSILON);
+}
+
+TEST(TariffCalculatorTest, TimeBetweenSamplesIsNotTruncatedToSeconds) {
+    auto tariff = create_tariff({});
+    tariff.chargingTime = TariffTime{{create_time_price(0.60F)}};
+    TariffCalculator calculator(tariff, create_sample(START, 0));
+
+    // 0.5 and 1.5 seconds apart, one minute in total
+    auto timestamp = START.to_time_point();
+    for (int i = 0; i < 60; i++) {
+        timestamp += std::chrono::milliseconds(i % 2 == 0 ? 500 : 1500);
+        calculator.update(create_sample(DateTime(timestamp), 0));
+    }
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 0.6, EPSILON);
+}
+
+TEST(TariffCalculatorTest, FixedFeeIsChargedOnceAndTotalIsLimitedByMinAndMaxCost) {
+    auto tariff = create_tariff({create_energy_price(0.50F)});
+    tariff.fixedFee = TariffFixed{{TariffFixedPrice{1.0F}}};
+    tariff.minCost = create_price(2.0F);
+    tariff.maxCost = create_price(5.0F);
+    TariffCalculator calculator(tariff, create_sample(START, 0));
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 2.0, EPSILON);
+
+    calculator.update(create_sample(at(std::chrono::minutes(10)), 4000));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 3.0, EPSILON);
+
+    calculator.update(create_sample(at(std::chrono::minutes(60)), 20000));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 5.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, TaxRatesOnTheSameStackAreAddedAndHigherStacksAreApplied) {
+    auto tariff = create_tariff({create_energy_price(1.0F)});
+    tariff.energy->taxRates =
+        std::vector<TaxRate>{{"VAT", 19.0F, 0}, {"Levy", 1.0F, std::nullopt}, {"Other", 10.0F, 1}};
+    TariffCalculator calculator(tariff, create_sample(START, 0));
+
+    calculator.update(create_sample(at(std::chrono::minutes(60)), 10000));
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 10.0, EPSILON);
+    EXPECT_NEAR(calculator.get_cost().incl_tax, 13.2, EPSILON);
+}
+
+TEST(TariffCalculatorTest, TimeOfDayConditionUsesLocalTimeAndWrapsAroundMidnight) {
+    TariffConditions night;
+    night.startTimeOfDay = "22:00";
+    night.endTimeOfDay = "06:00";
+    const auto tariff = create_tariff({create_energy_price(0.20F, night), create_energy_price(0.40F)});
+
+    // 21:30 UTC is 22:30 local time
+    const DateTime evening{"2025-01-06T21:30:00Z"};
+    TariffCalculator calculator(tariff, create_sample(evening, 0), std::chrono::minutes(60));
+    calculator.update(create_sample(DateTime{"2025-01-07T05:30:00Z"}, 10000));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 2.0, EPSILON);
+
+    // 05:30 UTC is 06:30 local time, which is outside of the night period
+    calculator.update(create_sample(DateTime{"2025-01-07T06:30:00Z"}, 20000));
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 6.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, DayOfWeekCondition) {
+    TariffConditions weekend;
+    weekend.dayOfWeek = std::vector<DayOfWeekEnum>{DayOfWeekEnum::Saturday, DayOfWeekEnum::Sunday};
+    const auto tariff = create_tariff({create_energy_price(0.10F, weekend), create_energy_price(0.40F)});
+
+    TariffCalculator monday(tariff, create_sample(START, 0));
+    monday.update(create_sample(at(std::chrono::minutes(60)), 10000));
+    EXPECT_NEAR(monday.get_cost().excl_tax, 4.0, EPSILON);
+
+    TariffCalculator sunday(tariff, create_sample(DateTime{"2025-01-05T10:00:00Z"}, 0));
+    sunday.update(create_sample(DateTime{"2025-01-05T11:00:00Z"}, 10000));
+    EXPECT_NEAR(sunday.get_cost().excl_tax, 1.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, EnergyConditionIsEvaluatedOnTheEnergyOfTheTransaction) {
+    TariffConditions first_10_kwh;
+    first_10_kwh.maxEnergy = 10000.0F;
+    const auto tariff = create_tariff({create_energy_price(0.50F, first_10_kwh), create_energy_price(0.30F)});
+
+    TariffCalculator calculator(tariff, create_sample(START, 50000));
+    calculator.update(create_sample(at(std::chrono::minutes(30)), 60000));
+    calculator.update(create_sample(at(std::chrono::minutes(60)), 70000));
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 8.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, SetTariffKeepsTheAccumulatedCost) {
+    TariffCalculator calculator(create_tariff({create_energy_price(0.30F)}), create_sample(START, 0));
+    calculator.update(create_sample(at(std::chrono::minutes(30)), 10000));
+
+    auto driver_tariff = create_tariff({create_energy_price(0.10F)});
+    driver_tariff.tariffId = "driver";
+    calculator.set_tariff(driver_tariff);
+    calculator.update(create_sample(at(std::chrono::minutes(60)), 20000));
+
+    EXPECT_EQ(calculator.get_tariff().tariffId.get(), "driver");
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 4.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, OutdatedSamplesAreIgnored) {
+    TariffCalculator calculator(create_tariff({create_energy_price(1.0F)}), create_sample(START, 0));
+    calculator.update(create_sample(at(std::chrono::minutes(30)), 1000));
+    calculator.update(create_sample(at(std::chrono::minutes(20)), 5000));
+
+    EXPECT_NEAR(calculator.get_cost().excl_tax, 1.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, CreateSampleConvertsUnits) {
+    SampledValue energy;
+    energy.value = 1.5F;
+    energy.unitOfMeasure = UnitOfMeasure{"kWh", 1};
+    SampledValue power;
+    power.value = 11.0F;
+    power.measurand = MeasurandEnum::Power_Active_Import;
+    power.unitOfMeasure = UnitOfMeasure{"kW"};
+    SampledValue current_l1;
+    current_l1.value = 16.0F;
+    current_l1.measurand = MeasurandEnum::Current_Import;
+    current_l1.phase = PhaseEnum::L1;
+    SampledValue current_l2 = current_l1;
+    current_l2.value = 15.0F;
+    current_l2.phase = PhaseEnum::L2;
+
+    MeterValue meter_value;
+    meter_value.timestamp = START;
+    meter_value.sampledValue = {energy, power, current_l1, current_l2};
+
+    const auto sample = create_tariff_meter_sample(meter_value, true);
+    ASSERT_TRUE(sample.energy_wh.has_value());
+    EXPECT_NEAR(sample.energy_wh.value(), 15000.0, EPSILON);
+    ASSERT_TRUE(sample.power_w.has_value());
+    EXPECT_NEAR(sample.power_w.value(), 11000.0, EPSILON);
+    ASSERT_TRUE(sample.current_a.has_value());
+    EXPECT_NEAR(sample.current_a.value(), 16.0, EPSILON);
+}
+
+TEST(TariffCalculatorTest, ParseTimeOffset) {
+    EXPECT_EQ(parse_time_offset("+01:00"), std::chrono::minutes(60));
+    EXPECT_EQ(parse_time_offset("-05:30"), std::chrono::minutes(-330));
+    EXPECT_EQ(parse_time_offset("invalid"), std::chrono::minutes(0));
+}
+
+TEST(TariffCalculatorTest, PaymentConditionsAreNotSupported) {
+    auto tariff = create_tariff({create_energy_price(0.30F)});
+    EXPECT_TRUE(is_tariff_supported(tariff));
+
+    TariffConditionsFixed conditions;
+    conditions.paymentBrand = "Visa";
+    tariff.fixedFee = TariffFixed{{TariffFixedPrice{0.5F, conditions}}};
+    EXPECT_FALSE(is_tariff_supported(tariff));
+    EXPECT_EQ(get_number_of_tariff_elements(tariff), 2);
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <ocpp/v2/tx_ended_meter_values.hpp>
+
+namespace ocpp {
+namespace v2 {
+
+class TxEndedMeterValuesTest : public ::testing::Test {
+protected:
+    // 2024-01-01T00:00:00Z, which is a multiple of every interval used in the tests
+    static constexpr std::int64_t START = 1704067200;
+
+    static MeterValue create_meter_value(const std::int64_t seconds, const ReadingContextEnum context) {
+        SampledValue sampled_value;
+        sampled_value.value = static_cast<float>(seconds);
+        sampled_value.context = context;
+        sampled_value.measurand = MeasurandEnum::Energy_Active_Import_Register;
+
+        MeterValue meter_value;
+        meter_value.timestamp = DateTime(date::utc_clock::time_point(std::chrono::seconds(START + seconds)));
+        meter_value.sampledValue.push_back(sampled_value);
+        return meter_value;
+    }
+
+    static std::size_t get_size(const MeterValue& meter_value) {
+        return json(meter_value).dump().size() + 1;
+    }
+};
+
+TEST_F(TxEndedMeterValuesTest, test_all_meter_values_kept_within_limit) {
+    TxEndedMeterValues collector{0, std::chrono::seconds(60)};
+
+    collector.add(create_meter_value(0, ReadingContextEnum::Transaction_Begin));
+    for (std::int64_t i = 1; i < 100; ++i) {
+        collector.add(create_meter_value(i, ReadingContextEnum::Sample_Periodic));
+    }
+    collector.add(create_meter_value(100, ReadingContextEnum::Transaction_End));
+
+    EXPECT_EQ(collector.get_interval().count(), 0);
+    EXPECT_EQ(collector.take().size(), 101);
+}
+
+TEST_F(TxEndedMeterValuesTest, test_samples_downsampled_to_limit) {
+    const auto size = get_size(create_meter_value(0, ReadingContextEnum::Sample_Periodic));
+    TxEndedMeterValues collector{size * 20, std::chrono::seconds(10)};
+
+    collector.add(create_meter_value(0, ReadingContextEnum::Transaction_Begin));
+    for (std::int64_t i = 1; i < 1000; ++i) {
+        collector.add(create_meter_value(i, ReadingContextEnum::Sample_Periodic));
+    }
+    collector.add(create_meter_value(1000, ReadingContextEnum::Transaction_End));
+
+    // An interval of 40s leaves 25 samples, 80s leaves 13 samples
+    EXPECT_EQ(collector.get_interval().count(), 80);
+
+    const auto meter_values = collector.take();
+    ASSERT_EQ(meter_values.size(), 15);
+    EXPECT_EQ(meter_values.front().sampledValue.at(0).context, ReadingContextEnum::Transaction_Begin);
+    EXPECT_EQ(meter_values.back().sampledValue.at(0).context, ReadingContextEnum::Transaction_End);
+
+    // The first sample of every interval is kept
+    EXPECT_EQ(meter_values.at(1).sampledValue.at(0).value, 1.0F);
+    for (std::size_t i = 2; i < meter_values.size() - 1; ++i) {
+        EXPECT_EQ(static_cast<std::int64_t>(meter_values.at(i).sampledValue.at(0).value) % 80, 0);
+    }
+
+    std::size_t total_size = 0;
+    for (const auto& meter_value : meter_values) {
+        total_size += get_size(meter_value);
+    }
+    EXPECT_LE(total_size, size * 20);
+
+    EXPECT_EQ(collector.get_interval().count(), 0);
+    EXPECT_TRUE(collector.take().empty());
+}
+
+TEST_F(TxEndedMeterValuesTest, test_begin_end_and_interruption_always_kept) {
+    const auto size = get_size(create_meter_value(0, ReadingContextEnum::Sample_Clock));
+    TxEndedMeterValues collector{size, std::chrono::seconds(60)};
+
+    collector.add(create_meter_value(0, ReadingContextEnum::Transaction_Begin));
+    collector.add(create_meter_value(1, ReadingContextEnum::Sample_Clock));
+    collector.add(create_meter_value(2, ReadingContextEnum::Interruption_Begin));
+    collector.add(create_meter_value(3, ReadingContextEnum::Sample_Clock));
+    collector.add(create_meter_value(4, ReadingContextEnum::Interruption_End));
+    collector.add(create_meter_value(5, ReadingContextEnum::Transaction_End));
+
+    const auto meter_values = collector.take();
+    ASSERT_EQ(meter_values.size(), 5);
+    EXPECT_EQ(meter_values.at(0).sampledValue.at(0).context, ReadingContextEnum::Transaction_Begin);
+    EXPECT_EQ(meter_values.at(1).sampledValue.at(0).context, ReadingContextEnum::Sample_Clock);
+    EXPECT_EQ(meter_values.at(2).sampledValue.at(0).context, ReadingContextEnum::Interruption_Begin);
+    EXPECT_EQ(meter_values.at(3).sampledValue.at(0).context, ReadingContextEnum::Interruption_End);
+    EXPECT_EQ(meter_values.at(4).sampledValue.at(0).context, ReadingContextEnum::Transaction_End);
+}
+
+} // namespace v2
+} // namespace ocpp
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "component_state_manager_mock.hpp"
+#include "connectivity_manager_mock.hpp"
+#include "evse_manager_fake.hpp"
+#include "evse_security_mock.hpp"
+#include "message_dispatcher_mock.hpp"
+#include "mocks/database_handler_mock.hpp"
+#include "mocks/smart_charging_mock.hpp"
+#include <ocpp/common/constants.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v21/functional_blocks/bidirectional.hpp>
+#include <ocpp/v21/messages/AFRRSignal.hpp>
+
+using namespace ocpp::v2;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace {
+ChargingProfile create_afrr_profile(const ocpp::DateTime& start_schedule) {
+    ChargingSchedulePeriod period;
+    period.startPeriod = 0;
+    period.operationMode = OperationModeEnum::CentralFrequency;
+    period.v2xBaseline = 1000.0F;
+    period.v2xSignalWattCurve = std::vector<V2XSignalWattPoint>{{100, 5000.0F}, {-100, -5000.0F}};
+
+    ChargingSchedule schedule;
+    schedule.id = 1;
+    schedule.chargingRateUnit = ChargingRateUnitEnum::W;
+    schedule.startSchedule = start_schedule;
+    schedule.chargingSchedulePeriod = {period};
+
+    ChargingProfile profile;
+    profile.id = 1;
+    profile.stackLevel = 0;
+    profile.chargingProfilePurpose = ChargingProfilePurposeEnum::TxDefaultProfile;
+    profile.chargingProfileKind = ChargingProfileKindEnum::Absolute;
+    profile.chargingSchedule = {schedule};
+    return profile;
+}
+
+CompositeSchedule create_composite_schedule(const std::int32_t evse_id, const float limit,
+                                            const std::optional<float> discharge_limit) {
+    ChargingSchedulePeriod period;
+    period.startPeriod = 0;
+    period.limit = limit;
+    period.dischargeLimit = discharge_limit;
+
+    CompositeSchedule schedule;
+    schedule.evseId = evse_id;
+    schedule.duration = 86400;
+    schedule.scheduleStart = ocpp::DateTime();
+    schedule.chargingRateUnit = ChargingRateUnitEnum::W;
+    schedule.chargingSchedulePeriod = {period};
+    return schedule;
+}
+
+ocpp::EnhancedMessage<MessageType> create_afrr_signal(const ocpp::DateTime& timestamp, const std::int32_t signal) {
+    ocpp::v21::AFRRSignalRequest request;
+    request.timestamp = timestamp;
+    request.signal = signal;
+    ocpp::Call<ocpp::v21::AFRRSignalRequest> call(request);
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = MessageType::AFRRSignal;
+    enhanced_message.message = std::make_shared<const json>(call);
+    return enhanced_message;
+}
+} // namespace
+
+class BidirectionalTest : public ::testing::Test {
+protected: // Members
+    MockMessageDispatcher mock_dispatcher;
+    DeviceModel* device_model;
+    ::testing::NiceMock<ConnectivityManagerMock> connectivity_manager;
+    ::testing::NiceMock<DatabaseHandlerMock> database_handler_mock;
+    ocpp::EvseSecurityMock evse_security;
+    EvseManagerFake evse_manager;
+    ComponentStateManagerMock component_state_manager;
+    std::atomic<ocpp::OcppProtocolVersion> ocpp_version;
+    FunctionalBlockContext functional_block_context;
+    ::testing::NiceMock<SmartChargingMock> smart_charging;
+    /// \brief Protects setpoints, the callback of signals with a future timestamp runs on the executor
+    std::mutex setpoints_mutex;
+    std::condition_variable setpoints_cv;
+    std::vector<std::pair<std::int32_t, float>> setpoints;
+    Bidirectional bidirectional;
+
+    BidirectionalTest() :
+        mock_dispatcher(),
+        device_model(nullptr),
+        connectivity_manager(),
+        database_handler_mock(),
+        evse_security(),
+        evse_manager(2),
+        component_state_manager(),
+        ocpp_version(ocpp::OcppProtocolVersion::v21),
+        functional_block_context{
+            this->mock_dispatcher,       *this->device_model, this->connectivity_manager,    this->evse_manager,
+            this->database_handler_mock, this->evse_security, this->component_state_manager, this->ocpp_version},
+        smart_charging(),
+        bidirectional(functional_block_context, &smart_charging, std::nullopt,
+                      [this](const std::int32_t evse_id, const float setpoint) {
+                          {
+                              const std::lock_guard<std::mutex> lock(this->setpoints_mutex);
+                              this->setpoints.emplace_back(evse_id, setpoint);
+                          }
+                          this->setpoints_cv.notify_all();
+                      }) {
+    }
+};
+
+TEST(GetV2xSignalPowerTest, InterpolatesBetweenPointsAndClampsOutsideOfTheCurve) {
+    const std::vector<V2XSignalWattPoint> curve{{-100, -5000.0F}, {0, 0.0F}, {100, 4000.0F}};
+
+    EXPECT_FLOAT_EQ(get_v2x_signal_power(curve, -50), -2500.0F);
+    EXPECT_FLOAT_EQ(get_v2x_signal_power(curve, 25), 1000.0F);
+    EXPECT_FLOAT_EQ(get_v2x_signal_power(curve, 100), 4000.0F);
+    EXPECT_FLOAT_EQ(get_v2x_signal_power(curve, -200), -5000.0F);
+    EXPECT_FLOAT_EQ(get_v2x_signal_power(curve, 200), 4000.0F);
+    EXPECT_FLOAT_EQ(get_v2x_signal_power({}, 50), 0.0F);
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_AppliesCurveOfActiveProfile) {
+    const ocpp::DateTime now;
+    const auto profile = create_afrr_profile(ocpp::DateTime(now.to_time_point() - std::chrono::hours(1)));
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{1, {profile}}}));
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<ocpp::v21::AFRRSignalResponse>();
+        EXPECT_EQ(response.status, GenericStatusEnum::Accepted);
+    }));
+
+    bidirectional.handle_message(create_afrr_signal(now, 50));
+
+    ASSERT_EQ(setpoints.size(), 1);
+    EXPECT_EQ(setpoints.at(0).first, 1);
+    EXPECT_FLOAT_EQ(setpoints.at(0).second, 3500.0F);
+    EXPECT_TRUE(bidirectional.get_last_afrr_signal_latency().has_value());
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_CurvesAreOnlyReloadedWhenProfilesChange) {
+    const ocpp::DateTime now;
+    const auto profile = create_afrr_profile(ocpp::DateTime(now.to_time_point() - std::chrono::hours(1)));
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{0, {profile}}}))
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{}));
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).Times(3);
+
+    // A station wide profile applies to all EVSEs
+    bidirectional.handle_message(create_afrr_signal(now, -100));
+    bidirectional.handle_message(create_afrr_signal(now, 100));
+    ASSERT_EQ(setpoints.size(), 4);
+    EXPECT_FLOAT_EQ(setpoints.at(0).second, -4000.0F);
+    EXPECT_FLOAT_EQ(setpoints.at(3).second, 6000.0F);
+
+    bidirectional.on_charging_profiles_changed();
+    bidirectional.handle_message(create_afrr_signal(now, 100));
+    EXPECT_EQ(setpoints.size(), 4);
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_FutureTimestamp_AppliedAtTimestamp) {
+    const ocpp::DateTime now;
+    const auto profile = create_afrr_profile(ocpp::DateTime(now.to_time_point() - std::chrono::hours(1)));
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{1, {profile}}}));
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<ocpp::v21::AFRRSignalResponse>();
+        EXPECT_EQ(response.status, GenericStatusEnum::Accepted);
+    }));
+
+    const auto start = std::chrono::steady_clock::now();
+    const ocpp::DateTime signal_time(now.to_time_point() + std::chrono::milliseconds(300));
+    bidirectional.handle_message(create_afrr_signal(signal_time, -50));
+    {
+        const std::lock_guard<std::mutex> lock(this->setpoints_mutex);
+        EXPECT_TRUE(setpoints.empty());
+    }
+
+    std::unique_lock<std::mutex> lock(this->setpoints_mutex);
+    ASSERT_TRUE(setpoints_cv.wait_for(lock, std::chrono::seconds(5), [this]() { return !setpoints.empty(); }));
+    // The system clock and the clock of the timer may differ by some microseconds
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250));
+    ASSERT_EQ(setpoints.size(), 1);
+    EXPECT_EQ(setpoints.at(0).first, 1);
+    EXPECT_FLOAT_EQ(setpoints.at(0).second, -1500.0F);
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_NoActiveCurve_Rejected) {
+    const ocpp::DateTime now;
+    const auto profile = create_afrr_profile(ocpp::DateTime(now.to_time_point() + std::chrono::hours(1)));
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{1, {profile}}}));
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<ocpp::v21::AFRRSignalResponse>();
+        EXPECT_EQ(response.status, GenericStatusEnum::Rejected);
+    }));
+
+    bidirectional.handle_message(create_afrr_signal(now, 50));
+    EXPECT_TRUE(setpoints.empty());
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_NotImplementedBeforeOcpp21) {
+    ocpp_version = ocpp::OcppProtocolVersion::v201;
+    EXPECT_THROW(bidirectional.handle_message(create_afrr_signal(ocpp::DateTime(), 50)),
+                 MessageTypeNotImplementedException);
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_SetpointIsClampedToCompositeLimits) {
+    const ocpp::DateTime now;
+    const auto profile = create_afrr_profile(ocpp::DateTime(now.to_time_point() - std::chrono::hours(1)));
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{0, {profile}}}));
+    EXPECT_CALL(smart_charging, get_composite_schedule(1, _, ChargingRateUnitEnum::W))
+        .WillRepeatedly(Return(create_composite_schedule(1, 4000.0F, -2000.0F)));
+    EXPECT_CALL(smart_charging, get_composite_schedule(2, _, ChargingRateUnitEnum::W))
+        .WillRepeatedly(Return(create_composite_schedule(2, 3000.0F, std::nullopt)));
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).Times(2);
+
+    bidirectional.handle_message(create_afrr_signal(now, 100));
+    bidirectional.handle_message(create_afrr_signal(now, -100));
+
+    ASSERT_EQ(setpoints.size(), 4);
+    EXPECT_EQ(setpoints.at(0).first, 1);
+    EXPECT_FLOAT_EQ(setpoints.at(0).second, 4000.0F);
+    EXPECT_EQ(setpoints.at(1).first, 2);
+    EXPECT_FLOAT_EQ(setpoints.at(1).second, 3000.0F);
+    EXPECT_FLOAT_EQ(setpoints.at(2).second, -2000.0F);
+    EXPECT_FLOAT_EQ(setpoints.at(3).second, -4000.0F);
+}
+
+TEST_F(BidirectionalTest, AFRRSignal_CurveOfLowerRankedProfileIsNotUsed) {
+    const ocpp::DateTime now;
+    const auto start_schedule = ocpp::DateTime(now.to_time_point() - std::chrono::hours(1));
+    const auto afrr_profile = create_afrr_profile(start_schedule);
+
+    // An active TxProfile without a curve takes precedence over the TxDefaultProfile with a curve
+    auto tx_profile = create_afrr_profile(start_schedule);
+    tx_profile.id = 2;
+    tx_profile.chargingProfilePurpose = ChargingProfilePurposeEnum::TxProfile;
+    auto& tx_period = tx_profile.chargingSchedule.front().chargingSchedulePeriod.front();
+    tx_period.operationMode = OperationModeEnum::ChargingOnly;
+    tx_period.limit = 7000.0F;
+    tx_period.v2xBaseline.reset();
+    tx_period.v2xSignalWattCurve.reset();
+
+    EXPECT_CALL(database_handler_mock, get_all_charging_profiles_group_by_evse())
+        .WillOnce(Return(std::map<std::int32_t, std::vector<ChargingProfile>>{{1, {afrr_profile, tx_profile}}}));
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<ocpp::v21::AFRRSignalResponse>();
+        EXPECT_EQ(response.status, GenericStatusEnum::Rejected);
+    }));
+
+    bidirectional.handle_message(create_afrr_signal(now, 50));
+    EXPECT_TRUE(setpoints.empty());
+}
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ocpp/v21/functional_blocks/der_control.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <ocpp/common/call_types.hpp>
+#include <ocpp/v2/ctrlr_component_variables.hpp>
+#include <ocpp/v2/device_model.hpp>
+#include <ocpp/v2/functional_blocks/functional_block_context.hpp>
+#include <ocpp/v21/messages/ReportDERControl.hpp>
+
+#include "component_state_manager_mock.hpp"
+#include "connectivity_manager_mock.hpp"
+#include "device_model_test_helper.hpp"
+#include "evse_manager_fake.hpp"
+#include "evse_security_mock.hpp"
+#include "message_dispatcher_mock.hpp"
+#include "mocks/database_handler_mock.hpp"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::Throw;
+
+namespace ocpp::v2 {
+
+namespace {
+const DateTime START{"2025-01-06T10:00:00Z"};
+
+DateTime at(const std::chrono::seconds offset) {
+    return DateTime(START.to_time_point() + offset);
+}
+
+v21::SetDERControlRequest create_curve_control(const std::string& id, const DERControlEnum control_type,
+                                               const std::vector<DERCurvePoints>& points,
+                                               const std::int32_t priority = 0, const bool is_default = false) {
+    DERCurve curve;
+    curve.curveData = points;
+    curve.priority = priority;
+    curve.yUnit = DERUnitEnum::PctEffectiveV;
+
+    v21::SetDERControlRequest control;
+    control.isDefault = is_default;
+    control.controlId = id;
+    control.controlType = control_type;
+    control.curve = curve;
+    return control;
+}
+
+template <typename T>
+ocpp::EnhancedMessage<MessageType> create_message(const MessageType message_type, const T& request) {
+    ocpp::Call<T> call(request);
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = message_type;
+    enhanced_message.message = std::make_shared<const json>(call);
+    return enhanced_message;
+}
+
+MeterValue create_voltage_meter_value(const DateTime& timestamp, const float voltage) {
+    SampledValue sampled_value;
+    sampled_value.value = voltage;
+    sampled_value.measurand = MeasurandEnum::Voltage;
+    sampled_value.phase = PhaseEnum::L1_N;
+
+    MeterValue meter_value;
+    meter_value.timestamp = timestamp;
+    meter_value.sampledValue = {sampled_value};
+    return meter_value;
+}
+} // namespace
+
+class DERControlTest : public ::testing::Test {
+protected:
+    DeviceModelTestHelper device_model_test_helper;
+    MockMessageDispatcher mock_dispatcher;
+    DeviceModel* device_model = device_model_test_helper.get_device_model();
+    ::testing::NiceMock<ConnectivityManagerMock> connectivity_manager;
+    ::testing::NiceMock<DatabaseHandlerMock> database_handler_mock;
+    ocpp::EvseSecurityMock evse_security;
+    EvseManagerFake evse_manager{2};
+    ComponentStateManagerMock component_state_manager;
+    std::atomic<OcppProtocolVersion> ocpp_version{OcppProtocolVersion::v21};
+    FunctionalBlockContext functional_block_context{
+        this->mock_dispatcher,       *this->device_model, this->connectivity_manager,    this->evse_manager,
+        this->database_handler_mock, this->evse_security, this->component_state_manager, this->ocpp_version};
+    boost::asio::io_context io_context;
+    std::vector<DERCurveOutput> outputs;
+
+    std::unique_ptr<DERControl> create_der_control(const std::vector<StoredDERControl>& stored_controls) {
+        const auto& supply_voltage = ControllerComponentVariables::SupplyVoltage;
+        this->device_model->set_value(supply_voltage.component, supply_voltage.variable.value(),
+                                      AttributeEnum::Actual, "230", "test", true);
+        EXPECT_CALL(database_handler_mock, get_der_controls()).WillOnce(Return(stored_controls));
+        return std::make_unique<DERControl>(this->functional_block_context, this->io_context,
+                                            [this](const std::int32_t /*evse_id*/,
+                                                   const std::vector<DERCurveOutput>& curve_outputs) {
+                                                this->outputs = curve_outputs;
+                                            });
+    }
+
+    /// \brief Publishes \p meter_value and runs the evaluation that is posted to the io_context
+    void process_meter_value(DERControl& der_control, const std::int32_t evse_id, const MeterValue& meter_value) {
+        der_control.on_meter_value(evse_id, meter_value);
+        this->io_context.restart();
+        this->io_context.run();
+    }
+};
+
+TEST_F(DERControlTest, SetDERControl_SupersedesControlsWithLowerPriority) {
+    auto der_control = create_der_control({});
+    EXPECT_CALL(database_handler_mock, insert_or_update_der_control(_, false)).Times(2);
+    EXPECT_CALL(database_handler_mock, insert_or_update_der_control(_, true)).Times(1);
+
+    std::vector<v21::SetDERControlResponse> responses;
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillRepeatedly(Invoke([&](const json& call_result) {
+        responses.push_back(call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::SetDERControlResponse>());
+    }));
+
+    const std::vector<DERCurvePoints> points{{95.0F, 40.0F}, {105.0F, -40.0F}};
+    der_control->handle_message(create_message(
+        MessageType::SetDERControl, create_curve_control("low", DERControlEnum::VoltVar, points, 5)));
+    der_control->handle_message(create_message(
+        MessageType::SetDERControl, create_curve_control("high", DERControlEnum::VoltVar, points, 1)));
+
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(responses.at(0).status, DERControlStatusEnum::Accepted);
+    EXPECT_FALSE(responses.at(0).supersededIds.has_value());
+    EXPECT_EQ(responses.at(1).status, DERControlStatusEnum::Accepted);
+    ASSERT_TRUE(responses.at(1).supersededIds.has_value());
+    ASSERT_EQ(responses.at(1).supersededIds->size(), 1);
+    EXPECT_EQ(responses.at(1).supersededIds->at(0).get(), "low");
+
+    // A control without the settings of its type is rejected
+    auto missing_curve = create_curve_control("missing", DERControlEnum::VoltWatt, points);
+    missing_curve.curve.reset();
+    der_control->handle_message(create_message(MessageType::SetDERControl, missing_curve));
+    ASSERT_EQ(responses.size(), 3);
+    EXPECT_EQ(responses.at(2).status, DERControlStatusEnum::Rejected);
+}
+
+TEST_F(DERControlTest, GetDERControl_ReportsMatchingControls) {
+    const std::vector<DERCurvePoints> points{{95.0F, 40.0F}, {105.0F, -40.0F}};
+    auto der_control =
+        create_der_control({{create_curve_control("volt-var", DERControlEnum::VoltVar, points, 5), true},
+                            {create_curve_control("volt-var-high", DERControlEnum::VoltVar, points, 1), false},
+                            {create_curve_control("hv", DERControlEnum::HVMustTrip, points), false}});
+
+    v21::GetDERControlRequest request;
+    request.requestId = 7;
+    request.controlType = DERControlEnum::VoltVar;
+    request.controlId = "volt-var";
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::GetDERControlResponse>();
+        EXPECT_EQ(response.status, DERControlStatusEnum::Accepted);
+    }));
+    EXPECT_CALL(mock_dispatcher, dispatch_call(_, _)).WillOnce(Invoke([](const json& call, bool /*triggered*/) {
+        const auto report = call[ocpp::CALL_PAYLOAD].get<v21::ReportDERControlRequest>();
+        EXPECT_EQ(report.requestId, 7);
+        ASSERT_TRUE(report.curve.has_value());
+        ASSERT_EQ(report.curve->size(), 1);
+        EXPECT_EQ(report.curve->at(0).id.get(), "volt-var");
+        EXPECT_TRUE(report.curve->at(0).isSuperseded);
+    }));
+
+    der_control->handle_message(create_message(MessageType::GetDERControl, request));
+}
+
+TEST_F(DERControlTest, OnMeterValue_EvaluatesVoltVarCurve) {
+    const std::vector<DERCurvePoints> volt_var{{92.0F, 44.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {108.0F, -44.0F}};
+    auto der_control =
+        create_der_control({{create_curve_control("volt-var", DERControlEnum::VoltVar, volt_var), false}});
+
+    // 241.5 V is 105 % of the nominal voltage
+    process_meter_value(*der_control, 1, create_voltage_meter_value(START, 241.5F));
+
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs.at(0).control_type, DERControlEnum::VoltVar);
+    EXPECT_NEAR(outputs.at(0).value, -22.0F, 0.01F);
+}
+
+TEST_F(DERControlTest, ClearDERControl_LowerPriorityCurveIsEvaluatedAgain) {
+    const std::vector<DERCurvePoints> low_curve{{92.0F, 44.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {108.0F, -44.0F}};
+    const std::vector<DERCurvePoints> high_curve{{95.0F, 10.0F}, {105.0F, -10.0F}};
+    auto der_control = create_der_control({});
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillRepeatedly(Return());
+
+    std::vector<std::pair<std::string, bool>> persisted;
+    EXPECT_CALL(database_handler_mock, insert_or_update_der_control(_, _))
+        .WillRepeatedly(Invoke([&persisted](const v21::SetDERControlRequest& control, const bool is_superseded) {
+            persisted.emplace_back(control.controlId.get(), is_superseded);
+        }));
+
+    der_control->handle_message(create_message(
+        MessageType::SetDERControl, create_curve_control("low", DERControlEnum::VoltVar, low_curve, 5)));
+    der_control->handle_message(create_message(
+        MessageType::SetDERControl, create_curve_control("high", DERControlEnum::VoltVar, high_curve, 1)));
+
+    // 241.5 V is 105 % of the nominal voltage
+    process_meter_value(*der_control, 1, create_voltage_meter_value(START, 241.5F));
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs.at(0).control_id.get(), "high");
+    EXPECT_NEAR(outputs.at(0).value, -10.0F, 0.01F);
+
+    v21::ClearDERControlRequest request;
+    request.isDefault = false;
+    request.controlId = "high";
+    persisted.clear();
+    der_control->handle_message(create_message(MessageType::ClearDERControl, request));
+
+    // The low priority control is no longer superseded, in memory and in the database
+    ASSERT_EQ(persisted.size(), 1);
+    EXPECT_EQ(persisted.at(0), std::make_pair(std::string("low"), false));
+
+    process_meter_value(*der_control, 1, create_voltage_meter_value(at(std::chrono::seconds(1)), 241.5F));
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs.at(0).control_id.get(), "low");
+    EXPECT_NEAR(outputs.at(0).value, -22.0F, 0.01F);
+}
+
+TEST_F(DERControlTest, OnMeterValue_RaisesAndEndsAlarmWhenTripCurveIsCrossed) {
+    // The voltage may be above 110 % for 10 seconds and above 120 % for 0.2 seconds
+    const std::vector<DERCurvePoints> must_trip{{0.2F, 120.0F}, {10.0F, 110.0F}};
+    auto der_control =
+        create_der_control({{create_curve_control("hv", DERControlEnum::HVMustTrip, must_trip), false}});
+
+    std::vector<v21::NotifyDERAlarmRequest> alarms;
+    EXPECT_CALL(mock_dispatcher, dispatch_call(_, _)).WillRepeatedly(Invoke([&](const json& call, bool) {
+        alarms.push_back(call[ocpp::CALL_PAYLOAD].get<v21::NotifyDERAlarmRequest>());
+    }));
+
+    // 257.6 V is 112 % of the nominal voltage
+    process_meter_value(*der_control, 1, create_voltage_meter_value(START, 257.6F));
+    process_meter_value(*der_control, 1, create_voltage_meter_value(at(std::chrono::seconds(5)), 257.6F));
+    EXPECT_TRUE(alarms.empty());
+
+    process_meter_value(*der_control, 1, create_voltage_meter_value(at(std::chrono::seconds(11)), 257.6F));
+    ASSERT_EQ(alarms.size(), 1);
+    EXPECT_EQ(alarms.at(0).controlType, DERControlEnum::HVMustTrip);
+    EXPECT_EQ(alarms.at(0).gridEventFault, GridEventFaultEnum::OverVoltage);
+    EXPECT_FALSE(alarms.at(0).alarmEnded.has_value());
+
+    // The alarm is only raised once per excursion
+    process_meter_value(*der_control, 1, create_voltage_meter_value(at(std::chrono::seconds(12)), 257.6F));
+    EXPECT_EQ(alarms.size(), 1);
+
+    process_meter_value(*der_control, 1, create_voltage_meter_value(at(std::chrono::seconds(13)), 230.0F));
+    ASSERT_EQ(alarms.size(), 2);
+    EXPECT_EQ(alarms.at(1).alarmEnded, true);
+}
+
+TEST_F(DERControlTest, OnMeterValue_OnlyTheLatestMeterValueIsEvaluatedOnTheIoContext) {
+    const std::vector<DERCurvePoints> volt_var{{92.0F, 44.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {108.0F, -44.0F}};
+    auto der_control =
+        create_der_control({{create_curve_control("volt-var", DERControlEnum::VoltVar, volt_var), false}});
+
+    // 241.5 V is 105 % and 253.0 V is 110 % of the nominal voltage
+    der_control->on_meter_value(1, create_voltage_meter_value(START, 241.5F));
+    der_control->on_meter_value(1, create_voltage_meter_value(at(std::chrono::seconds(1)), 253.0F));
+    EXPECT_TRUE(outputs.empty());
+
+    io_context.run();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_NEAR(outputs.at(0).value, -44.0F, 0.01F);
+}
+
+TEST_F(DERControlTest, SetDERControl_KeepsTheStoredControlWhenItCanNotBeReplaced) {
+    const std::vector<DERCurvePoints> stored_curve{{92.0F, 44.0F}, {98.0F, 0.0F}, {102.0F, 0.0F}, {108.0F, -44.0F}};
+    const std::vector<DERCurvePoints> new_curve{{95.0F, 10.0F}, {105.0F, -10.0F}};
+    auto der_control =
+        create_der_control({{create_curve_control("volt-var", DERControlEnum::VoltVar, stored_curve), false}});
+
+    EXPECT_CALL(database_handler_mock, insert_or_update_der_control(_, _))
+        .WillOnce(Throw(everest::db::QueryExecutionException("Insert fails")));
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::SetDERControlResponse>();
+        EXPECT_EQ(response.status, DERControlStatusEnum::Rejected);
+    }));
+    der_control->handle_message(create_message(
+        MessageType::SetDERControl, create_curve_control("volt-var", DERControlEnum::VoltVar, new_curve)));
+
+    // 241.5 V is 105 % of the nominal voltage
+    process_meter_value(*der_control, 1, create_voltage_meter_value(START, 241.5F));
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs.at(0).control_id.get(), "volt-var");
+    EXPECT_NEAR(outputs.at(0).value, -22.0F, 0.01F);
+}
+
+TEST_F(DERControlTest, DERControlMessagesAreNotImplementedBeforeOcpp21) {
+    auto der_control = create_der_control({});
+    this->ocpp_version = OcppProtocolVersion::v201;
+
+    v21::ClearDERControlRequest request;
+    request.isDefault = false;
+    EXPECT_THROW(der_control->handle_message(create_message(MessageType::ClearDERControl, request)),
+                 MessageTypeNotImplementedException);
+}
+
+} // namespace ocpp::v2
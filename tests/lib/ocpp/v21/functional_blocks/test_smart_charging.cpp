@@ -22,7 +22,9 @@
 #include <ocpp/v2/evse.hpp>
 #include <ocpp/v2/functional_blocks/functional_block_context.hpp>
 #include <ocpp/v2/ocpp_enums.hpp>
+#include <ocpp/v2/messages/GetChargingProfiles.hpp>
 #include <ocpp/v2/ocpp_types.hpp>
+#include <ocpp/v21/messages/UpdateDynamicSchedule.hpp>
 
 #include "component_state_manager_mock.hpp"
 #include "connectivity_manager_mock.hpp"
@@ -763,4 +765,156 @@ TEST_F(SmartChargingTestV21, AllSetpointsSameSign) {
 
     EXPECT_EQ(sut, ProfileValidationResultEnum::Valid);
 }
+
+TEST_F(SmartChargingTestV21, UpdateDynamicSchedule_IsAppliedInMemoryAndPublishedForTheEvse) {
+    const ComponentVariable supports_dynamic_profiles = ControllerComponentVariables::SupportsDynamicProfiles;
+    device_model->set_value(supports_dynamic_profiles.component, supports_dynamic_profiles.variable.value(),
+                            AttributeEnum::Actual, "true", "test", true);
+    const DateTime now;
+    const DateTime valid_from(now.to_time_point() - std::chrono::hours(1));
+    const DateTime valid_to(now.to_time_point() + std::chrono::hours(24));
+    auto profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxDefaultProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+        {}, ChargingProfileKindEnum::Dynamic, DEFAULT_STACK_LEVEL, valid_from, valid_to);
+    smart_charging.add_profile(profile, DEFAULT_EVSE_ID);
+
+    std::vector<std::vector<CompositeSchedule>> notifications;
+    smart_charging.subscribe_limits_changed(
+        3600, ChargingRateUnitEnum::A,
+        [&notifications](const std::vector<CompositeSchedule>& schedules) { notifications.push_back(schedules); });
+    ASSERT_THAT(notifications.size(), testing::Eq(1));
+
+    v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 10.0F;
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = MessageType::UpdateDynamicSchedule;
+    enhanced_message.message = std::make_shared<const json>(ocpp::Call<v21::UpdateDynamicScheduleRequest>(request));
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::UpdateDynamicScheduleResponse>();
+        EXPECT_EQ(response.status, ChargingProfileStatusEnum::Accepted);
+    }));
+    smart_charging.handle_message(enhanced_message);
+
+    // Only the composite schedule of the evse of the profile is published
+    ASSERT_THAT(notifications.size(), testing::Eq(2));
+    ASSERT_THAT(notifications.at(1).size(), testing::Eq(1));
+    EXPECT_THAT(notifications.at(1).front().evseId, testing::Eq(DEFAULT_EVSE_ID));
+    ASSERT_FALSE(notifications.at(1).front().chargingSchedulePeriod.empty());
+    EXPECT_THAT(notifications.at(1).front().chargingSchedulePeriod.front().limit, testing::Optional(10.0F));
+
+    // The update is not written to the database right away
+    auto stored = database_handler->get_charging_profiles_for_evse(DEFAULT_EVSE_ID);
+    ASSERT_THAT(stored.size(), testing::Eq(1));
+    EXPECT_THAT(stored.front().chargingSchedule.front().chargingSchedulePeriod.front().limit, testing::Optional(16.0F));
+
+    // Reporting the profiles writes the pending updates first
+    GetChargingProfilesRequest get_request;
+    get_request.requestId = 1;
+    get_request.chargingProfile.chargingProfileId = std::vector<std::int32_t>{DEFAULT_PROFILE_ID};
+    smart_charging.get_reported_profiles(get_request);
+    stored = database_handler->get_charging_profiles_for_evse(DEFAULT_EVSE_ID);
+    ASSERT_THAT(stored.size(), testing::Eq(1));
+    EXPECT_THAT(stored.front().chargingSchedule.front().chargingSchedulePeriod.front().limit, testing::Optional(10.0F));
+    EXPECT_TRUE(stored.front().dynUpdateTime.has_value());
+}
+
+TEST_F(SmartChargingTestV21, UpdateDynamicSchedule_UnknownProfileIsRejected) {
+    v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 10.0F;
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = MessageType::UpdateDynamicSchedule;
+    enhanced_message.message = std::make_shared<const json>(ocpp::Call<v21::UpdateDynamicScheduleRequest>(request));
+
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).WillOnce(Invoke([](const json& call_result) {
+        const auto response = call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::UpdateDynamicScheduleResponse>();
+        EXPECT_EQ(response.status, ChargingProfileStatusEnum::Rejected);
+        ASSERT_TRUE(response.statusInfo.has_value());
+        EXPECT_EQ(response.statusInfo->reasonCode.get(), "UnknownProfile");
+    }));
+    smart_charging.handle_message(enhanced_message);
+}
+
+TEST_F(SmartChargingTestV21, ClearInvalidProfiles_DeletedDynamicProfileIsNotWrittenBack) {
+    const ComponentVariable supports_dynamic_profiles = ControllerComponentVariables::SupportsDynamicProfiles;
+    device_model->set_value(supports_dynamic_profiles.component, supports_dynamic_profiles.variable.value(),
+                            AttributeEnum::Actual, "true", "test", true);
+    const DateTime now;
+    auto profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxDefaultProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+        {}, ChargingProfileKindEnum::Dynamic, DEFAULT_STACK_LEVEL, DateTime(now.to_time_point() - std::chrono::hours(1)),
+        DateTime(now.to_time_point() + std::chrono::hours(24)));
+    smart_charging.add_profile(profile, DEFAULT_EVSE_ID);
+
+    v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 10.0F;
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = MessageType::UpdateDynamicSchedule;
+    enhanced_message.message = std::make_shared<const json>(ocpp::Call<v21::UpdateDynamicScheduleRequest>(request));
+    std::vector<ChargingProfileStatusEnum> statuses;
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_))
+        .Times(2)
+        .WillRepeatedly(Invoke([&statuses](const json& call_result) {
+            statuses.push_back(
+                call_result[ocpp::CALLRESULT_PAYLOAD].get<v21::UpdateDynamicScheduleResponse>().status);
+        }));
+    smart_charging.handle_message(enhanced_message);
+
+    // The pending update must not bring back the profile once it is invalid and deleted
+    device_model->set_value(supports_dynamic_profiles.component, supports_dynamic_profiles.variable.value(),
+                            AttributeEnum::Actual, "false", "test", true);
+    smart_charging.clear_invalid_profiles();
+    EXPECT_TRUE(database_handler->get_charging_profiles_for_evse(DEFAULT_EVSE_ID).empty());
+
+    GetChargingProfilesRequest get_request;
+    get_request.requestId = 1;
+    get_request.chargingProfile.chargingProfileId = std::vector<std::int32_t>{DEFAULT_PROFILE_ID};
+    smart_charging.get_reported_profiles(get_request);
+    EXPECT_TRUE(database_handler->get_charging_profiles_for_evse(DEFAULT_EVSE_ID).empty());
+
+    smart_charging.handle_message(enhanced_message);
+    EXPECT_THAT(statuses,
+                testing::ElementsAre(ChargingProfileStatusEnum::Accepted, ChargingProfileStatusEnum::Rejected));
+}
+
+TEST_F(SmartChargingTestV21, ClearChargingProfile_ClearedDynamicProfileIsNotWrittenBack) {
+    const ComponentVariable supports_dynamic_profiles = ControllerComponentVariables::SupportsDynamicProfiles;
+    device_model->set_value(supports_dynamic_profiles.component, supports_dynamic_profiles.variable.value(),
+                            AttributeEnum::Actual, "true", "test", true);
+    const DateTime now;
+    auto profile = create_charging_profile(
+        DEFAULT_PROFILE_ID, ChargingProfilePurposeEnum::TxDefaultProfile,
+        create_charge_schedule(ChargingRateUnitEnum::A,
+                               create_charging_schedule_periods(0, std::nullopt, std::nullopt, 16.0F)),
+        {}, ChargingProfileKindEnum::Dynamic, DEFAULT_STACK_LEVEL, DateTime(now.to_time_point() - std::chrono::hours(1)),
+        DateTime(now.to_time_point() + std::chrono::hours(24)));
+    smart_charging.add_profile(profile, DEFAULT_EVSE_ID);
+
+    v21::UpdateDynamicScheduleRequest request;
+    request.chargingProfileId = DEFAULT_PROFILE_ID;
+    request.scheduleUpdate.limit = 10.0F;
+    ocpp::EnhancedMessage<MessageType> enhanced_message;
+    enhanced_message.messageType = MessageType::UpdateDynamicSchedule;
+    enhanced_message.message = std::make_shared<const json>(ocpp::Call<v21::UpdateDynamicScheduleRequest>(request));
+    EXPECT_CALL(mock_dispatcher, dispatch_call_result(_)).Times(1);
+    smart_charging.handle_message(enhanced_message);
+
+    ClearChargingProfileRequest clear_request;
+    clear_request.chargingProfileId = DEFAULT_PROFILE_ID;
+    EXPECT_THAT(smart_charging.clear_profiles(clear_request).status,
+                testing::Eq(ClearChargingProfileStatusEnum::Accepted));
+
+    GetChargingProfilesRequest get_request;
+    get_request.requestId = 1;
+    get_request.chargingProfile.chargingProfileId = std::vector<std::int32_t>{DEFAULT_PROFILE_ID};
+    smart_charging.get_reported_profiles(get_request);
+    EXPECT_TRUE(database_handler->get_charging_profiles_for_evse(DEFAULT_EVSE_ID).empty());
+}
 } // namespace ocpp::v2
@@ -51,14 +51,19 @@ set(LIBOCPP_TEST_DEFAULT_LINK_LIBRARIES
         everest::log
         everest::evse_security
         everest::sqlite
+        OpenSSL::Crypto
 )
 
 # If the test is not linked against the ocpp library, those default sources can be linked against, they will often
 # be needed to link against.
 set(LIBOCPP_TEST_INCLUDE_COMMON_SOURCES ${LIBOCPP_LIB_PATH}/ocpp/common/types.cpp
                                         ${LIBOCPP_LIB_PATH}/ocpp/common/ocpp_logging.cpp
+                                        ${LIBOCPP_LIB_PATH}/ocpp/common/rfc3339.cpp
                                         ${LIBOCPP_LIB_PATH}/ocpp/common/utils.cpp
                                         ${LIBOCPP_LIB_PATH}/ocpp/common/call_types.cpp
+                                        ${LIBOCPP_LIB_PATH}/ocpp/common/compact_encoding.cpp
+                                        ${LIBOCPP_LIB_PATH}/ocpp/common/contract_certificate_cache.cpp
+                                        ${LIBOCPP_LIB_PATH}/ocpp/common/executor.cpp
                                         ${LIBOCPP_LIB_PATH}/ocpp/common/evse_security.cpp
                                         ${LIBOCPP_LIB_PATH}/ocpp/common/database/database_handler_common.cpp
 )